@@ -0,0 +1,255 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bench.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "clock.h"
+
+#define BENCH_SAMPLES       10
+#define BENCH_T95           2.262   // Student's t, 9 degrees of freedom
+#define BENCH_MAX_RESULTS   256
+#define BENCH_MAX_SUITES    32
+#define BENCH_NAME_SIZE     48
+
+typedef struct _BENCHRESULT {
+    CHAR        szSuite[BENCH_NAME_SIZE];
+    CHAR        szName[BENCH_NAME_SIZE];
+    DOUBLE      fOps;
+    BENCHSTATS  stats;
+} BENCHRESULT;
+
+typedef struct _BENCHSUITERESULT {
+    CHAR        szName[BENCH_NAME_SIZE];
+    BOOL        bPassed;
+} BENCHSUITERESULT;
+
+static volatile BYTE        s_bSink;
+static BENCHRESULT          s_results[BENCH_MAX_RESULTS];
+static UINT                 s_cResults;
+static UINT                 s_cDropped;
+static BENCHSUITERESULT     s_suites[BENCH_MAX_SUITES];
+static UINT                 s_cSuites;
+
+static LONGLONG TimeCalls(
+    CONST Clock*    pClock,
+    BENCHPROC       pfnProc,
+    LPVOID          pContext,
+    ULONG           cCalls)
+{
+    LONGLONG    llStart;
+    ULONG       i;
+
+    llStart = pClock->GetTicks();
+
+    for (i = 0; i < cCalls; i++) {
+        pfnProc(pContext);
+    }
+
+    return pClock->GetTicks() - llStart;
+}
+
+static VOID CopyName(LPSTR pszTo, LPCSTR pszFrom)
+{
+    strncpy(pszTo, pszFrom, BENCH_NAME_SIZE - 1);
+    pszTo[BENCH_NAME_SIZE - 1] = '\0';
+}
+
+DOUBLE BenchRun(BENCHPROC pfnProc, LPVOID pContext, DOUBLE fMinSeconds)
+{
+    SystemClock clock;
+    LONGLONG    llStart, llElapsed, llMin;
+    ULONG       cCalls = 0;
+
+    pfnProc(pContext);
+
+    llMin   = (LONGLONG) (fMinSeconds * clock.GetFrequency());
+    llStart = clock.GetTicks();
+
+    do {
+        pfnProc(pContext);
+        cCalls++;
+        llElapsed = clock.GetTicks() - llStart;
+    } while (llElapsed < llMin);
+
+    return (DOUBLE) llElapsed / clock.GetFrequency() / cCalls;
+}
+
+DOUBLE BenchMeasure(
+    LPCSTR      pszSuite,
+    LPCSTR      pszName,
+    BENCHPROC   pfnProc,
+    LPVOID      pContext,
+    DOUBLE      fOps,
+    DOUBLE      fMinSeconds,
+    BENCHSTATS* pStats)
+{
+    SystemClock     clock;
+    BENCHSTATS      stats;
+    BENCHRESULT*    pResult;
+    DOUBLE          samples[BENCH_SAMPLES];
+    DOUBLE          fScale, fSum = 0.0, fSquares = 0.0, fDeviation;
+    LONGLONG        llTarget, llElapsed;
+    ULONG           cCalls = 1;
+    UINT            i;
+
+    pfnProc(pContext);
+
+    // As many calls as fill a sample, found by doubling until a run is
+    // long enough to scale from
+    llTarget = (LONGLONG) (fMinSeconds * clock.GetFrequency() /
+                           BENCH_SAMPLES);
+
+    for (;;) {
+        llElapsed = TimeCalls(&clock, pfnProc, pContext, cCalls);
+
+        if (llElapsed >= llTarget / 4 || cCalls >= 0x40000000) {
+            break;
+        }
+
+        cCalls *= 2;
+    }
+
+    if (llElapsed > 0 && llElapsed < llTarget) {
+        cCalls = (ULONG) ((DOUBLE) cCalls * llTarget / llElapsed);
+    }
+
+    fScale = 1e9 / clock.GetFrequency() / (cCalls * fOps);
+
+    stats.fMinNanoseconds = 0.0;
+
+    for (i = 0; i < BENCH_SAMPLES; i++) {
+        samples[i] = TimeCalls(&clock, pfnProc, pContext, cCalls) * fScale;
+        fSum += samples[i];
+
+        if (i == 0 || samples[i] < stats.fMinNanoseconds) {
+            stats.fMinNanoseconds = samples[i];
+        }
+    }
+
+    stats.fNanoseconds = fSum / BENCH_SAMPLES;
+
+    for (i = 0; i < BENCH_SAMPLES; i++) {
+        fDeviation = samples[i] - stats.fNanoseconds;
+        fSquares += fDeviation * fDeviation;
+    }
+
+    stats.fConfidence = BENCH_T95 *
+                        sqrt(fSquares / (BENCH_SAMPLES - 1)) /
+                        sqrt((DOUBLE) BENCH_SAMPLES);
+    stats.cCalls = cCalls;
+
+    if (s_cResults < BENCH_MAX_RESULTS) {
+        pResult = &s_results[s_cResults++];
+
+        CopyName(pResult->szSuite, pszSuite);
+        CopyName(pResult->szName, pszName);
+        pResult->fOps = fOps;
+        pResult->stats = stats;
+    } else {
+        s_cDropped++;
+    }
+
+    if (pStats != NULL) {
+        *pStats = stats;
+    }
+
+    return stats.fNanoseconds * fOps / 1e9;
+}
+
+VOID BenchRecordSuite(LPCSTR pszSuite, BOOL bPassed)
+{
+    if (s_cSuites < BENCH_MAX_SUITES) {
+        CopyName(s_suites[s_cSuites].szName, pszSuite);
+        s_suites[s_cSuites].bPassed = bPassed;
+        s_cSuites++;
+    }
+}
+
+BOOL BenchWriteJson(LPCSTR pszPath)
+{
+    CONST BENCHRESULT*  pResult;
+    FILE*               pFile;
+    UINT                i;
+    BOOL                bWritten;
+
+    pFile = fopen(pszPath, "w");
+
+    if (pFile == NULL) {
+        return FALSE;
+    }
+
+    fprintf(pFile, "{\n  \"suites\": [");
+
+    for (i = 0; i < s_cSuites; i++) {
+        fprintf(pFile, "%s\n    {\"name\": \"%s\", \"passed\": %s}",
+                (i == 0) ? "" : ",",
+                s_suites[i].szName,
+                (s_suites[i].bPassed == TRUE) ? "true" : "false");
+    }
+
+    fprintf(pFile, "\n  ],\n  \"results\": [");
+
+    for (i = 0; i < s_cResults; i++) {
+        pResult = &s_results[i];
+
+        fprintf(pFile,
+                "%s\n    {\"suite\": \"%s\", \"name\": \"%s\", "
+                "\"ns_per_op\": %.4f, \"ci95_ns\": %.4f, "
+                "\"min_ns\": %.4f, \"samples\": %u, "
+                "\"calls_per_sample\": %lu, \"ops_per_call\": %.0f}",
+                (i == 0) ? "" : ",",
+                pResult->szSuite,
+                pResult->szName,
+                pResult->stats.fNanoseconds,
+                pResult->stats.fConfidence,
+                pResult->stats.fMinNanoseconds,
+                (UINT) BENCH_SAMPLES,
+                (unsigned long) pResult->stats.cCalls,
+                pResult->fOps);
+    }
+
+    fprintf(pFile, "\n  ]\n}\n");
+
+    bWritten = (ferror(pFile) == 0);
+
+    if (fclose(pFile) != 0) {
+        bWritten = FALSE;
+    }
+
+    return bWritten;
+}
+
+UINT BenchGetDropped()
+{
+    return s_cDropped;
+}
+
+VOID BenchConsume(CONST VOID* pData, SIZE_T cbData)
+{
+    CONST BYTE* pb = (CONST BYTE*) pData;
+    BYTE        bHash = 0;
+    SIZE_T      i;
+
+    for (i = 0; i < cbData; i += 64) {
+        bHash ^= pb[i];
+    }
+
+    s_bSink = bHash;
+}
@@ -0,0 +1,76 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BENCH_H
+#define __BENCH_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Minimal benchmark harness for fp_bench
+////////////////////////////////////////////////////////////////////////////
+
+typedef VOID (*BENCHPROC)(LPVOID pContext);
+
+// Calls pfnProc until at least fMinSeconds have passed (after one warm-up
+// call) and returns the average seconds per call
+DOUBLE BenchRun(BENCHPROC pfnProc, LPVOID pContext, DOUBLE fMinSeconds);
+
+typedef struct _BENCHSTATS {
+    DOUBLE  fNanoseconds;           // Per operation, mean of the samples
+    DOUBLE  fConfidence;            // Half the 95% interval around it
+    DOUBLE  fMinNanoseconds;        // Per operation, fastest sample
+    ULONG   cCalls;                 // Per sample
+} BENCHSTATS;
+
+// Like BenchRun, but times BENCH_SAMPLES samples of the same number of
+// calls, each call doing fOps operations. The statistics go to pStats
+// (may be NULL) and are kept as pszSuite/pszName for BenchWriteJson().
+DOUBLE BenchMeasure(
+    LPCSTR      pszSuite,
+    LPCSTR      pszName,
+    BENCHPROC   pfnProc,
+    LPVOID      pContext,
+    DOUBLE      fOps,
+    DOUBLE      fMinSeconds,
+    BENCHSTATS* pStats);
+
+// Whether a suite passed, for BenchWriteJson()
+VOID BenchRecordSuite(LPCSTR pszSuite, BOOL bPassed);
+
+// Every suite and measurement so far, as JSON
+BOOL BenchWriteJson(LPCSTR pszPath);
+
+// Measurements BenchMeasure() could not keep for BenchWriteJson()
+UINT BenchGetDropped();
+
+// Keeps the optimizer from discarding a result
+VOID BenchConsume(CONST VOID* pData, SIZE_T cbData);
+
+////////////////////////////////////////////////////////////////////////////
+// Suites, each returns 0 on success
+
+INT BenchBlit();
+INT BenchEasing();
+INT BenchPointer();
+INT BenchQueue();
+INT BenchRender();
+INT BenchResample();
+INT BenchSimulation();
+INT BenchStream();
+INT BenchTween();
+
+#endif // __BENCH_H
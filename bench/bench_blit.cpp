@@ -0,0 +1,181 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+
+#include "bench.h"
+#include "blit.h"
+#include "softwarerendersink.h"
+
+#define SOURCE_SIZE     256
+#define TARGET_SIZE     1024
+
+#define MIN_SECONDS     0.25
+
+typedef struct _BLITCASE {
+    LPCSTR              pszName;
+    Geometry::Matrix    transform;
+} BLITCASE;
+
+typedef struct _BLITCONTEXT {
+    SoftwareRenderSink* pSink;
+    RenderBitmap*       pBitmap;
+    Geometry::Matrix    transform;
+} BLITCONTEXT;
+
+// A premultiplied gradient with holes, so every alpha path is taken
+static VOID FillSource(BYTE* pbPixels)
+{
+    UINT x, y, a;
+    BYTE* pb;
+
+    for (y = 0; y < SOURCE_SIZE; y++) {
+        for (x = 0; x < SOURCE_SIZE; x++) {
+            pb = pbPixels + (y * SOURCE_SIZE + x) * 4;
+            a  = ((x / 16 + y / 16) % 5 == 0) ? 0 : (x ^ y) & 0xFF;
+
+            pb[0] = (BYTE) (x * a / 255);
+            pb[1] = (BYTE) (y * a / 255);
+            pb[2] = (BYTE) ((255 - x) * a / 255);
+            pb[3] = (BYTE) a;
+        }
+    }
+}
+
+static HRESULT CreateTarget(
+    CONST BYTE*             pbSource,
+    SoftwareRenderSink**    ppSink,
+    RenderBitmap**          ppBitmap)
+{
+    HRESULT hResult;
+
+    hResult = SoftwareRenderSink::CreateSoftwareRenderSink(
+        TARGET_SIZE, TARGET_SIZE, ppSink);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    hResult = (*ppSink)->CreateBitmap(
+        SOURCE_SIZE, SOURCE_SIZE, SOURCE_SIZE * 4, pbSource, ppBitmap);
+
+    if (FAILED(hResult)) {
+        delete *ppSink;
+    }
+
+    return hResult;
+}
+
+static VOID DrawOnce(LPVOID pContext)
+{
+    BLITCONTEXT* pBlit = (BLITCONTEXT*) pContext;
+
+    pBlit->pSink->BeginDraw();
+    pBlit->pSink->DrawBitmap(pBlit->pBitmap, pBlit->transform, 0.8f);
+    pBlit->pSink->EndDraw();
+}
+
+static DOUBLE CountPixels(CONST Geometry::Matrix& transform)
+{
+    Geometry::Rect bounds;
+
+    bounds = Geometry::TransformBounds(transform, Geometry::MakeRect(
+        -0.5f, -0.5f, SOURCE_SIZE + 0.5f, SOURCE_SIZE + 0.5f));
+
+    bounds = Geometry::Intersect(Geometry::RoundOut(bounds),
+        Geometry::MakeRect(0.0f, 0.0f, TARGET_SIZE, TARGET_SIZE));
+
+    return Geometry::Area(bounds);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+INT BenchBlit()
+{
+    static CONST BLITLEVEL levels[] = {
+        BLIT_LEVEL_SCALAR,
+        BLIT_LEVEL_SSE2,
+        BLIT_LEVEL_AVX2
+    };
+
+    Geometry::Point     center = Geometry::MakePoint(
+        SOURCE_SIZE / 2.0f, SOURCE_SIZE / 2.0f);
+    BLITCASE            cases[3];
+    BLITCONTEXT         context;
+    CONST BLITKERNELS*  pKernels;
+    BYTE                source[SOURCE_SIZE * SOURCE_SIZE * 4];
+    BENCHSTATS          stats;
+    CHAR                szName[64];
+    UINT                i, j;
+
+    FillSource(source);
+
+    cases[0].pszName   = "translate";
+    cases[0].transform = Geometry::Translation(300.0f, 200.0f);
+
+    cases[1].pszName   = "scale";
+    cases[1].transform = Geometry::Multiply(
+        Geometry::Scale(Geometry::MakeSize(1.75f, 1.75f), center),
+        Geometry::Translation(300.25f, 200.5f));
+
+    cases[2].pszName   = "affine";
+    cases[2].transform = Geometry::Multiply(
+        Geometry::Multiply(
+            Geometry::Scale(Geometry::MakeSize(1.3f, 1.3f), center),
+            Geometry::Rotation(30.0f, center)),
+        Geometry::Translation(300.0f, 200.0f));
+
+    for (i = 0; i < ARRAYSIZE(levels); i++) {
+        pKernels = GetBlitKernelsForLevel(levels[i]);
+
+        if (pKernels == NULL) {
+            continue;
+        }
+
+        if (FAILED(CreateTarget(source, &context.pSink, &context.pBitmap))) {
+            return 1;
+        }
+
+        context.pSink->SetBlitKernels(pKernels);
+
+        for (j = 0; j < ARRAYSIZE(cases); j++) {
+            context.transform = cases[j].transform;
+
+            snprintf(szName, sizeof(szName), "%s/%s",
+                     cases[j].pszName, pKernels->pszName);
+
+            BenchMeasure(
+                "blit", szName, DrawOnce, &context,
+                CountPixels(cases[j].transform), MIN_SECONDS, &stats);
+
+            printf("blit %-10s %-7s %9.1f Mpix/s, %.3f ns/pixel +- %.3f\n",
+                   cases[j].pszName,
+                   pKernels->pszName,
+                   1e3 / stats.fNanoseconds,
+                   stats.fNanoseconds,
+                   stats.fConfidence);
+        }
+
+        BenchConsume(context.pSink->GetPixels(),
+                     (SIZE_T) context.pSink->GetStride() * TARGET_SIZE);
+
+        delete context.pBitmap;
+        delete context.pSink;
+    }
+
+    // fp_test checks that every level draws the same pixels
+    return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+
+#include "bench.h"
+#include "easing.h"
+
+#define BATCH_VALUES    4096
+
+#define MIN_SECONDS     0.1
+
+typedef struct _EASINGCONTEXT {
+    EASING      easing;
+    PFNEASING   pfnEase;
+    EASINGPROC  pfnBatch;
+    FLOAT       x[BATCH_VALUES];
+    FLOAT       y[BATCH_VALUES];
+} EASINGCONTEXT;
+
+typedef struct _EASINGBENCH {
+    EASING      easing;
+    BENCHPROC   pfnInline;
+    BENCHPROC   pfnTable;
+} EASINGBENCH;
+
+static VOID EasePointer(LPVOID pContext)
+{
+    EASINGCONTEXT*      pEasing = (EASINGCONTEXT*) pContext;
+    PFNEASING volatile  pfnEase = pEasing->pfnEase;
+    UINT                i;
+
+    for (i = 0; i < BATCH_VALUES; i++) {
+        pEasing->y[i] = pfnEase(pEasing->x[i]);
+    }
+}
+
+template<class Ease>
+static VOID EaseInline(LPVOID pContext)
+{
+    EASINGCONTEXT*  pEasing = (EASINGCONTEXT*) pContext;
+    UINT            i;
+
+    for (i = 0; i < BATCH_VALUES; i++) {
+        pEasing->y[i] = Ease()(pEasing->x[i]);
+    }
+}
+
+template<class Ease>
+static VOID EaseTable(LPVOID pContext)
+{
+    static CONST Easing::EasingTable<Ease, EASING_TABLE_SEGMENTS> table;
+    EASINGCONTEXT*  pEasing = (EASINGCONTEXT*) pContext;
+    UINT            i;
+
+    for (i = 0; i < BATCH_VALUES; i++) {
+        pEasing->y[i] = table(pEasing->x[i]);
+    }
+}
+
+static VOID EaseBatch(LPVOID pContext)
+{
+    EASINGCONTEXT* pEasing = (EASINGCONTEXT*) pContext;
+
+    pEasing->pfnBatch(pEasing->x, pEasing->y, BATCH_VALUES);
+}
+
+static VOID MeasureTime(
+    CONST EASINGINFO*   pInfo,
+    LPCSTR              pszWay,
+    BENCHPROC           pfnProc,
+    EASINGCONTEXT*      pContext)
+{
+    BENCHSTATS  stats;
+    CHAR        szName[64];
+
+    snprintf(szName, sizeof(szName), "%s/%s", pInfo->pszName, pszWay);
+
+    BenchMeasure(
+        "easing", szName, pfnProc, pContext, BATCH_VALUES, MIN_SECONDS,
+        &stats);
+
+    printf("easing %-12s %-7s %7.2f ns/value +- %.2f\n",
+           pInfo->pszName, pszWay, stats.fNanoseconds, stats.fConfidence);
+}
+
+INT BenchEasing()
+{
+    // One of each kind: a square root, polynomial pieces, a sine and a
+    // sine times a power of 2
+    static CONST EASINGBENCH BENCHES[] = {
+        { EASING_OUT_CIRC,
+          EaseInline<Easing::OutCirc>,  EaseTable<Easing::OutCirc> },
+        { EASING_OUT_BOUNCE,
+          EaseInline<Easing::OutBounce>, EaseTable<Easing::OutBounce> },
+        { EASING_IN_OUT_SINE,
+          EaseInline<Easing::InOutSine>, EaseTable<Easing::InOutSine> },
+        { EASING_OUT_ELASTIC,
+          EaseInline<Easing::OutElastic>, EaseTable<Easing::OutElastic> }
+    };
+
+    static EASINGCONTEXT    context;
+    CONST EASINGINFO*       pInfo;
+    CONST EASINGKERNELS*    pKernels;
+    UINT                    i, uLevel;
+
+    for (i = 0; i < BATCH_VALUES; i++) {
+        context.x[i] = (FLOAT) i / (FLOAT) (BATCH_VALUES - 1);
+    }
+
+    // Every curve through a pointer, the way a Tweener calls it
+    for (i = 0; i < EASING_COUNT; i++) {
+        pInfo = GetEasingInfo((EASING) i);
+
+        context.easing = (EASING) i;
+        context.pfnEase = pInfo->pfnEase;
+
+        MeasureTime(pInfo, "pointer", EasePointer, &context);
+    }
+
+    // The other ways, for one of each kind
+    for (i = 0; i < ARRAYSIZE(BENCHES); i++) {
+        pInfo = GetEasingInfo(BENCHES[i].easing);
+
+        context.easing = BENCHES[i].easing;
+        context.pfnEase = pInfo->pfnEase;
+
+        MeasureTime(pInfo, "inline", BENCHES[i].pfnInline, &context);
+        MeasureTime(pInfo, "table", BENCHES[i].pfnTable, &context);
+
+        for (uLevel = EASING_LEVEL_SCALAR;
+             uLevel <= EASING_LEVEL_SSE2;
+             uLevel++)
+        {
+            pKernels = GetEasingKernelsForLevel((EASINGLEVEL) uLevel);
+
+            if (pKernels == NULL) {
+                continue;
+            }
+
+            context.pfnBatch = pKernels->pfnBatch[BENCHES[i].easing];
+
+            MeasureTime(pInfo, pKernels->pszName, EaseBatch, &context);
+        }
+
+        BenchConsume(context.y, sizeof(context.y));
+    }
+
+    // fp_test checks the errors and the batch bits
+    return 0;
+}
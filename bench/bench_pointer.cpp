@@ -0,0 +1,219 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "clock.h"
+#include "engine.h"
+#include "nullplatform.h"
+#include "pointer.h"
+
+#define SPRITE_SIZE     128
+#define VIEWPORT_WIDTH  1920.0f
+#define VIEWPORT_HEIGHT 1080.0f
+
+#define POSE_COUNT      1024
+#define MOVE_COUNT      1024
+
+// A 1000 Hz mouse on a 1 MHz clock
+#define MOVE_TICKS      1000
+
+// Moves this long push the pointer into the clamps now and then
+#define MOVE_RANGE      400.0f
+
+#define MIN_SECONDS     0.2
+
+typedef struct _POSECONTEXT {
+    Sprite*             pSprite;
+    Geometry::Matrix    level;
+    POINTERFRAME        frames[POSE_COUNT];
+    Geometry::Matrix    transforms[POSE_COUNT];
+} POSECONTEXT;
+
+typedef struct _MOVECONTEXT {
+    Engine*         pEngine;
+    ManualClock*    pClock;
+    INPUTEVENT      events[MOVE_COUNT];
+} MOVECONTEXT;
+
+static UINT NextRandom(UINT* puState)
+{
+    *puState = *puState * 1664525u + 1013904223u;
+    return *puState >> 8;
+}
+
+// -1 to 1
+static FLOAT NextSigned(UINT* puState)
+{
+    return (FLOAT) NextRandom(puState) / (FLOAT) (1u << 23) - 1.0f;
+}
+
+static HRESULT CreateSprite(RenderSink* pSink, Sprite** ppSprite)
+{
+    static BYTE pixels[SPRITE_SIZE * SPRITE_SIZE * 4];
+
+    return Sprite::CreateSpriteFromPixels(
+        pSink,
+        SPRITE_SIZE,
+        SPRITE_SIZE,
+        SPRITE_SIZE * 4,
+        pixels,
+        ppSprite);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+// What Renderer and Sprite::Draw do per frame without the frame cache:
+// pose the sprite, then put the mip level's transform in front of it
+static VOID PoseFrames(LPVOID pContext)
+{
+    POSECONTEXT*    pPose = (POSECONTEXT*) pContext;
+    UINT            i;
+
+    for (i = 0; i < POSE_COUNT; i++) {
+        Pointer::PoseSprite(pPose->pSprite, pPose->frames[i]);
+
+        pPose->transforms[i] = Geometry::Multiply(
+            pPose->level,
+            pPose->pSprite->GetTransform());
+    }
+}
+
+// The mouse handler: move, clamp to the screen and feed the predictor
+static VOID MovePointer(LPVOID pContext)
+{
+    MOVECONTEXT*    pMove = (MOVECONTEXT*) pContext;
+    UINT            i;
+
+    for (i = 0; i < MOVE_COUNT; i++) {
+        pMove->pClock->Advance(MOVE_TICKS);
+        pMove->events[i].llTime = pMove->pClock->GetTicks();
+        pMove->pEngine->HandleInput(pMove->events[i]);
+    }
+}
+
+static BOOL RunPose(NullRenderSink* pSink)
+{
+    static POSECONTEXT  context;
+    BENCHSTATS          stats;
+    UINT                uState = 1, i;
+
+    if (FAILED(CreateSprite(pSink, &context.pSprite))) {
+        return FALSE;
+    }
+
+    context.level = Geometry::Scale(
+        Geometry::MakeSize(2.0f, 2.0f),
+        Geometry::MakePoint(0.0f, 0.0f));
+
+    for (i = 0; i < POSE_COUNT; i++) {
+        memset(&context.frames[i], 0, sizeof(context.frames[i]));
+
+        context.frames[i].spritePosition = Geometry::MakePoint(
+            (NextSigned(&uState) + 1.0f) * VIEWPORT_WIDTH / 2.0f,
+            (NextSigned(&uState) + 1.0f) * VIEWPORT_HEIGHT / 2.0f);
+        context.frames[i].rotationCenter = Geometry::MakePoint(
+            SPRITE_SIZE / 2.0f, SPRITE_SIZE / 2.0f);
+        context.frames[i].fRotation = NextSigned(&uState) * 30.0f;
+        context.frames[i].fSpriteScale = 0.5f + NextSigned(&uState) * 0.25f;
+        context.frames[i].fDisplayScale = 1.0f;
+    }
+
+    BenchMeasure(
+        "pointer", "pose", PoseFrames, &context, POSE_COUNT, MIN_SECONDS,
+        &stats);
+
+    printf("pointer %-9s %7.2f ns/frame +- %.2f\n",
+           "pose", stats.fNanoseconds, stats.fConfidence);
+
+    BenchConsume(context.transforms, sizeof(context.transforms));
+
+    delete context.pSprite;
+    context.pSprite = NULL;
+
+    return TRUE;
+}
+
+static BOOL RunMove(NullRenderSink* pSink)
+{
+    static MOVECONTEXT  context;
+    ManualClock         clock;
+    Engine              engine(&clock);
+    Sprite*             pSprite = NULL;
+    BENCHSTATS          stats;
+    UINT                uState = 7, i;
+
+    if (FAILED(CreateSprite(pSink, &pSprite))) {
+        return FALSE;
+    }
+
+    if (FAILED(engine.Initialize(
+            pSink,
+            pSprite,
+            new NullSound(),
+            new NullSound())))
+    {
+        delete pSprite;
+        return FALSE;
+    }
+
+    engine.SetViewport(VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    engine.CenterPointer();
+
+    context.pEngine = &engine;
+    context.pClock = &clock;
+
+    for (i = 0; i < MOVE_COUNT; i++) {
+        memset(&context.events[i], 0, sizeof(context.events[i]));
+
+        context.events[i].type = IE_MOVE;
+        context.events[i].fDeltaX = NextSigned(&uState) * MOVE_RANGE;
+        context.events[i].fDeltaY = NextSigned(&uState) * MOVE_RANGE;
+    }
+
+    BenchMeasure(
+        "pointer", "move", MovePointer, &context, MOVE_COUNT, MIN_SECONDS,
+        &stats);
+
+    // fp_test checks where the clamps stop the pointer
+    printf("pointer %-9s %7.2f ns/event +- %.2f\n",
+           "move", stats.fNanoseconds, stats.fConfidence);
+
+    return TRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+INT BenchPointer()
+{
+    NullRenderSink  sink(VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    INT             iResult = 0;
+
+    if (RunPose(&sink) == FALSE) {
+        printf("pointer %-9s cannot pose the sprite\n", "pose");
+        iResult = 1;
+    }
+
+    if (RunMove(&sink) == FALSE) {
+        printf("pointer %-9s cannot create the engine\n", "move");
+        iResult = 1;
+    }
+
+    return iResult;
+}
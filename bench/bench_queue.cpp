@@ -0,0 +1,230 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "atomic.h"
+#include "clock.h"
+#include "mixer.h"
+#include "spscqueue.h"
+#include "thread.h"
+
+#define QUEUE_ITEMS         (4 * 1024 * 1024)
+#define QUEUE_SIZE          1024
+
+#define MIXER_ROUNDS        (1024 * 1024)
+#define MIXER_BLOCK         64
+#define MIXER_RATE          48000
+
+// Same size as a mixer command
+typedef struct _QUEUEITEM {
+    UINT    uSequence;
+    UINT    uCheck;
+    UINT    uPadding[4];
+} QUEUEITEM;
+
+typedef SpscQueue<QUEUEITEM, QUEUE_SIZE> BENCHQUEUE;
+
+typedef struct _RENDERCONTEXT {
+    Mixer*          pMixer;
+    volatile LONG   lStop;
+    ULONG           cBlocks;
+} RENDERCONTEXT;
+
+static VOID Produce(LPVOID pContext)
+{
+    BENCHQUEUE* pQueue = (BENCHQUEUE*) pContext;
+    QUEUEITEM   item;
+    UINT        i;
+
+    memset(&item, 0, sizeof(item));
+
+    for (i = 0; i < QUEUE_ITEMS; i++) {
+        item.uSequence = i;
+
+        while (pQueue->Push(item) == FALSE) {
+            Thread::YieldThread();
+        }
+    }
+}
+
+// Items through the queue between two threads; fp_test checks that they
+// all arrive in order
+static BOOL RunQueue()
+{
+    static BENCHQUEUE   queue;
+    SystemClock         clock;
+    Thread*             pProducer = NULL;
+    QUEUEITEM           item;
+    LONGLONG            llStart;
+    DOUBLE              fSeconds;
+    UINT                cItems = 0;
+
+    llStart = clock.GetTicks();
+
+    if (FAILED(Thread::CreateThread(Produce, &queue, &pProducer))) {
+        return FALSE;
+    }
+
+    while (cItems < QUEUE_ITEMS) {
+        if (queue.Pop(&item) == FALSE) {
+            Thread::YieldThread();
+            continue;
+        }
+
+        cItems++;
+    }
+
+    delete pProducer;
+
+    fSeconds = (DOUBLE) (clock.GetTicks() - llStart) / clock.GetFrequency();
+
+    printf("queue %-10s %9.1f Mitems/s, %u items\n",
+           "spsc", QUEUE_ITEMS / fSeconds / 1e6, QUEUE_ITEMS);
+
+    return TRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+static VOID RenderLoop(LPVOID pContext)
+{
+    RENDERCONTEXT*  pRender = (RENDERCONTEXT*) pContext;
+    FLOAT           output[MIXER_BLOCK * MIXER_CHANNELS];
+
+    while (AtomicLoadAcquire(&pRender->lStop) == 0) {
+        pRender->pMixer->Render(output, MIXER_BLOCK);
+        pRender->cBlocks++;
+
+        Thread::YieldThread();
+    }
+
+    BenchConsume(output, sizeof(output));
+}
+
+// A short 16-bit stereo WAV at the mixer rate, so the clip is borrowed
+static VOID MakeWav(BYTE* pbFile, UINT cFrames)
+{
+    UINT cbData = cFrames * 4;
+    UINT i;
+
+    static CONST BYTE HEADER[36] = {
+        'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E',
+        'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 2, 0,
+        0x80, 0xBB, 0, 0, 0x00, 0xEE, 0x02, 0, 4, 0, 16, 0
+    };
+
+    memcpy(pbFile, HEADER, sizeof(HEADER));
+    memcpy(pbFile + 36, "data", 4);
+
+    for (i = 0; i < 4; i++) {
+        pbFile[4 + i] = (BYTE) ((36 + cbData) >> (i * 8));
+        pbFile[40 + i] = (BYTE) (cbData >> (i * 8));
+    }
+
+    for (i = 0; i < cbData; i++) {
+        pbFile[44 + i] = (BYTE) (i * 7);
+    }
+}
+
+// The UI side hammers a sound while another thread renders; fp_test
+// checks that the last commands win
+static BOOL RunMixer()
+{
+    static BYTE     file[44 + 256 * 4];
+    RENDERCONTEXT   render;
+    SystemClock     clock;
+    Mixer*          pMixer = NULL;
+    AudioClip*      pClip = NULL;
+    MixerSound*     pSound = NULL;
+    Thread*         pRenderer = NULL;
+    LONGLONG        llStart;
+    DOUBLE          fSeconds;
+    BOOL            bResult = FALSE;
+    UINT            i;
+
+    MakeWav(file, 256);
+
+    if (FAILED(Mixer::CreateMixer(MIXER_RATE, &pMixer))) {
+        return FALSE;
+    }
+
+    if (FAILED(AudioClip::CreateAudioClipFromWav(
+            file, sizeof(file), MIXER_RATE, pMixer->GetSamplePool(), &pClip)))
+    {
+        goto cleanup;
+    }
+
+    if (FAILED(pMixer->CreateSound(pClip, 1, VOICE_STEAL_OLDEST, &pSound))) {
+        delete pClip;
+        goto cleanup;
+    }
+
+    render.pMixer = pMixer;
+    render.lStop = 0;
+    render.cBlocks = 0;
+
+    if (FAILED(Thread::CreateThread(RenderLoop, &render, &pRenderer))) {
+        goto cleanup;
+    }
+
+    llStart = clock.GetTicks();
+
+    for (i = 0; i < MIXER_ROUNDS; i++) {
+        pSound->SetGain((i & 1) ? 0.5f : 0.25f);
+        pSound->SetLoop((i & 2) ? TRUE : FALSE);
+        pSound->Play();
+        pSound->Stop();
+    }
+
+    fSeconds = (DOUBLE) (clock.GetTicks() - llStart) / clock.GetFrequency();
+
+    bResult = TRUE;
+
+    AtomicStoreRelease(&render.lStop, 1);
+    delete pRenderer;
+
+    printf("queue %-10s %9.1f Mcalls/s, %lu blocks rendered\n",
+           "mixer", MIXER_ROUNDS * 4 / fSeconds / 1e6,
+           (unsigned long) render.cBlocks);
+
+cleanup:
+    delete pMixer;
+    delete pSound;
+
+    return bResult;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+INT BenchQueue()
+{
+    INT iResult = 0;
+
+    if (RunQueue() == FALSE) {
+        printf("queue %-10s cannot start the producer\n", "spsc");
+        iResult = 1;
+    }
+
+    if (RunMixer() == FALSE) {
+        printf("queue %-10s cannot start the mixer\n", "mixer");
+        iResult = 1;
+    }
+
+    return iResult;
+}
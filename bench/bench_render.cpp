@@ -0,0 +1,413 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "atomic.h"
+#include "clock.h"
+#include "engine.h"
+#include "latencymonitor.h"
+#include "nullplatform.h"
+#include "thread.h"
+#include "triplebuffer.h"
+
+#define TRIPLE_ITEMS        (2 * 1024 * 1024)
+
+// Recording a sample, past reading the clock, is allowed this much
+#define RECORD_BUDGET_NS    50.0
+#define RECORD_BATCH        1024
+
+#define SPRITE_SIZE         64
+#define SURFACE_WIDTH       1920.0f
+#define SURFACE_HEIGHT      1080.0f
+
+// The display: EndDraw() returns at the next vertical blank. Where the
+// blanks fall against the frame scheduler's deadlines decides most of
+// the inline latency, so the run is repeated at LATENCY_PHASES offsets
+#define REFRESH_RATE        60.0
+#define INPUT_RATE          1000.0      // Mouse packets per second
+#define LATENCY_SECONDS     0.25        // Per phase
+#define LATENCY_PHASES      4
+
+// As big as the one fp_test checks for torn copies
+typedef struct _TRIPLEITEM {
+    UINT    uSequence;
+    UINT    uPadding[15];
+} TRIPLEITEM;
+
+typedef TripleBuffer<TRIPLEITEM> BENCHTRIPLE;
+
+// Presents like a vsynced swap chain: EndDraw() blocks until the next
+// refresh of a display whose blanks fall fPhase periods after the clock
+// started
+class VsyncRenderSink : public NullRenderSink {
+public:
+    VsyncRenderSink(Clock* pClock, DOUBLE fPhase)
+        : NullRenderSink(SURFACE_WIDTH, SURFACE_HEIGHT),
+          _pClock(pClock),
+          _llPeriod((LONGLONG) (pClock->GetFrequency() / REFRESH_RATE))
+    {
+        _llStart = pClock->GetTicks() + (LONGLONG) (fPhase * _llPeriod);
+    }
+
+    HRESULT EndDraw()
+    {
+        LONGLONG llNow = _pClock->GetTicks() - _llStart + _llPeriod;
+        LONGLONG llBlank = (llNow / _llPeriod + 1) * _llPeriod;
+
+        while (_pClock->GetTicks() - _llStart + _llPeriod < llBlank) {
+            Thread::YieldThread();
+        }
+
+        return NullRenderSink::EndDraw();
+    }
+
+private:
+    Clock*      _pClock;
+    LONGLONG    _llPeriod;
+    LONGLONG    _llStart;
+};
+
+typedef struct _RENDERTHREAD {
+    Renderer*       pRenderer;
+    ThreadEvent*    pFrameEvent;
+    volatile LONG   lStop;
+} RENDERTHREAD;
+
+static VOID PublishItems(LPVOID pContext)
+{
+    BENCHTRIPLE*    pBuffer = (BENCHTRIPLE*) pContext;
+    TRIPLEITEM      item;
+    UINT            i;
+
+    memset(&item, 0, sizeof(item));
+
+    for (i = 1; i <= TRIPLE_ITEMS; i++) {
+        item.uSequence = i;
+        pBuffer->Publish(item);
+    }
+}
+
+// Publishes as fast as one thread can while another takes what it gets;
+// fp_test checks that nothing is torn or reordered
+static BOOL RunTripleBuffer()
+{
+    static BENCHTRIPLE  buffer;
+    SystemClock         clock;
+    Thread*             pWriter = NULL;
+    LONGLONG            llStart;
+    DOUBLE              fSeconds;
+    UINT                uLast = 0, cAcquired = 0;
+
+    llStart = clock.GetTicks();
+
+    if (FAILED(Thread::CreateThread(PublishItems, &buffer, &pWriter))) {
+        return FALSE;
+    }
+
+    while (uLast < TRIPLE_ITEMS) {
+        if (buffer.Acquire() == FALSE) {
+            Thread::YieldThread();
+            continue;
+        }
+
+        uLast = buffer.GetFront().uSequence;
+        cAcquired++;
+    }
+
+    delete pWriter;
+
+    fSeconds = (DOUBLE) (clock.GetTicks() - llStart) / clock.GetFrequency();
+
+    printf("render %-9s %9.1f Mpublishes/s, %u of %u read\n",
+           "triple", TRIPLE_ITEMS / fSeconds / 1e6, cAcquired,
+           TRIPLE_ITEMS);
+
+    return TRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+static VOID StampSamples(LPVOID pContext)
+{
+    LatencyMonitor* pMonitor = (LatencyMonitor*) pContext;
+    LONGLONG        llStamp = 0;
+    UINT            i;
+
+    for (i = 0; i < RECORD_BATCH; i++) {
+        llStamp ^= pMonitor->Stamp();
+    }
+
+    BenchConsume(&llStamp, sizeof(llStamp));
+}
+
+static VOID RecordSamples(LPVOID pContext)
+{
+    LatencyMonitor* pMonitor = (LatencyMonitor*) pContext;
+    LONGLONG        llStart, llEnd;
+    UINT            i;
+
+    llStart = pMonitor->Stamp();
+
+    for (i = 0; i < RECORD_BATCH; i++) {
+        llEnd = pMonitor->Stamp();
+        pMonitor->Record(LATENCY_DRAW, llStart, llEnd);
+        llStart = llEnd;
+    }
+}
+
+// What one stage costs to measure. Stages run back to back, so each one
+// ends on the stamp the next starts from: a stamp and a record apiece.
+// The stamp is whatever the platform clock costs, so only the record is
+// held to the budget.
+static BOOL RunRecord()
+{
+    static SystemClock      clock;
+    static LatencyMonitor   monitor(&clock);
+    DOUBLE                  fStamp, fSample;
+
+    monitor.Reset();
+
+    fStamp = BenchRun(StampSamples, &monitor, 0.1) / RECORD_BATCH * 1e9;
+    fSample = BenchRun(RecordSamples, &monitor, 0.2) / RECORD_BATCH * 1e9;
+
+    printf("render %-9s %9.1f ns per sample, %.1f ns of it the clock "
+           "(budget %.0f ns)\n",
+           "record", fSample, fStamp, RECORD_BUDGET_NS);
+
+    return fSample - fStamp < RECORD_BUDGET_NS &&
+           monitor.GetHistogram(LATENCY_DRAW)->GetCount() != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+static VOID RenderFrames(LPVOID pContext)
+{
+    RENDERTHREAD*   pThread = (RENDERTHREAD*) pContext;
+    Renderer*       pRenderer = pThread->pRenderer;
+
+    DWORD           dwTimeout;
+
+    // What Application's render thread does
+    while (AtomicLoadAcquire(&pThread->lStop) == 0) {
+        dwTimeout = pRenderer->GetLatchTimeout();
+
+        if (dwTimeout > 0) {
+            Thread::SleepThread(dwTimeout);
+            continue;
+        }
+
+        if (pRenderer->Acquire() == FALSE) {
+            pThread->pFrameEvent->Wait(INFINITE);
+            continue;
+        }
+
+        pRenderer->Render(pRenderer->GetFrame());
+    }
+}
+
+// A mouse moving at the device rate for a while, fed to the engine the
+// way the message loop does; each packet is stamped when the device sent
+// it, so time spent waiting for the loop counts against the frame. The
+// input-to-present times are added to pTotal, the frames to pcFrames.
+static BOOL RunLatency(
+    BOOL        bThreaded,
+    DOUBLE      fPhase,
+    Histogram*  pTotal,
+    ULONGLONG*  pcFrames)
+{
+    static BYTE     pixels[SPRITE_SIZE * SPRITE_SIZE * 4];
+    SystemClock     clock;
+    VsyncRenderSink sink(&clock, fPhase);
+    Engine          engine(&clock);
+    Sprite*         pSprite = NULL;
+    Thread*         pRenderThread = NULL;
+    RENDERTHREAD    renderThread;
+    RENDERSTATS     stats;
+    CONST Histogram* pLatency;
+    INPUTEVENT      event;
+    LONGLONG        llPacket, llStart, llEnd, llNow, llWait;
+    LONGLONG        llFrequency;
+    DWORD           dwTimeout;
+    ULONG           cPackets = 0;
+
+    llFrequency = clock.GetFrequency();
+
+    if (FAILED(Sprite::CreateSpriteFromPixels(
+            &sink,
+            SPRITE_SIZE,
+            SPRITE_SIZE,
+            SPRITE_SIZE * 4,
+            pixels,
+            &pSprite)))
+    {
+        return FALSE;
+    }
+
+    if (FAILED(engine.Initialize(
+            &sink,
+            pSprite,
+            new NullSound(),
+            new NullSound())))
+    {
+        delete pSprite;
+        return FALSE;
+    }
+
+    engine.CenterPointer();
+    engine.GetScheduler()->SetTargetRate((FLOAT) REFRESH_RATE);
+    engine.SetThreadedRendering(bThreaded);
+    engine.GetRenderer()->SetRefreshRate((FLOAT) REFRESH_RATE);
+
+    renderThread.pRenderer = engine.GetRenderer();
+    renderThread.pFrameEvent = NULL;
+    renderThread.lStop = 0;
+
+    if (bThreaded == TRUE) {
+        if (FAILED(ThreadEvent::CreateThreadEvent(
+                &renderThread.pFrameEvent)))
+        {
+            return FALSE;
+        }
+
+        engine.GetRenderer()->SetFrameEvent(renderThread.pFrameEvent);
+
+        if (FAILED(Thread::CreateThread(
+                RenderFrames,
+                &renderThread,
+                &pRenderThread)))
+        {
+            delete renderThread.pFrameEvent;
+            return FALSE;
+        }
+    }
+
+    memset(&event, 0, sizeof(event));
+    event.type = IE_MOVE;
+
+    llStart = clock.GetTicks();
+    llEnd = llStart + (LONGLONG) (LATENCY_SECONDS * llFrequency);
+    llPacket = llStart;
+
+    while ((llNow = clock.GetTicks()) < llEnd) {
+        // Whatever the device sent while the loop was busy
+        while (llPacket <= llNow) {
+            event.llTime = llPacket;
+            event.fDeltaX = ((cPackets / 500) % 2 == 0) ? 1.0f : -1.0f;
+            event.fDeltaY = 0.0f;
+
+            engine.HandleInput(event);
+
+            llPacket += (LONGLONG) (llFrequency / INPUT_RATE);
+            cPackets++;
+        }
+
+        engine.Tick();
+
+        // Sleep until the next packet or frame, as MsgWait does
+        dwTimeout = engine.GetTimeout();
+        llWait = (llPacket - clock.GetTicks()) * 1000 / llFrequency;
+
+        if (llWait < (LONGLONG) dwTimeout) {
+            dwTimeout = (llWait > 0) ? (DWORD) llWait : 0;
+        }
+
+        if (dwTimeout > 0) {
+            Thread::SleepThread(dwTimeout);
+        } else {
+            Thread::YieldThread();
+        }
+    }
+
+    if (pRenderThread != NULL) {
+        AtomicStoreRelease(&renderThread.lStop, 1);
+        renderThread.pFrameEvent->Set();
+        delete pRenderThread;
+
+        engine.GetRenderer()->SetFrameEvent(NULL);
+        delete renderThread.pFrameEvent;
+    }
+
+    pLatency = engine.GetLatencyMonitor()->GetHistogram(
+        LATENCY_INPUT_TO_PRESENT);
+
+    engine.GetRenderer()->GetStats(&stats);
+
+    pTotal->Add(*pLatency);
+    *pcFrames += stats.ullFrames;
+
+    return pLatency->GetCount() != 0;
+}
+
+static BOOL RunLatencySweep(BOOL bThreaded)
+{
+    static Histogram    total;
+    ULONGLONG           cFrames = 0;
+    UINT                i;
+
+    total.Reset();
+
+    for (i = 0; i < LATENCY_PHASES; i++) {
+        if (RunLatency(
+                bThreaded,
+                (DOUBLE) i / LATENCY_PHASES,
+                &total,
+                &cFrames) == FALSE)
+        {
+            return FALSE;
+        }
+    }
+
+    printf("render %-9s %7.2f ms p50, %6.2f ms p99 input to present, "
+           "%lu frames\n",
+           (bThreaded == TRUE) ? "thread" : "inline",
+           total.GetPercentile(50.0) / 1000.0,
+           total.GetPercentile(99.0) / 1000.0,
+           (unsigned long) cFrames);
+
+    return TRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+INT BenchRender()
+{
+    INT iResult = 0;
+
+    if (RunTripleBuffer() == FALSE) {
+        printf("render %-9s cannot start the publisher\n", "triple");
+        iResult = 1;
+    }
+
+    if (RunRecord() == FALSE) {
+        printf("render %-9s recording a sample is over budget\n", "record");
+        iResult = 1;
+    }
+
+    if (RunLatencySweep(FALSE) == FALSE) {
+        printf("render %-9s nothing was presented\n", "inline");
+        iResult = 1;
+    }
+
+    if (RunLatencySweep(TRUE) == FALSE) {
+        printf("render %-9s nothing was presented\n", "thread");
+        iResult = 1;
+    }
+
+    return iResult;
+}
@@ -0,0 +1,138 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "resample.h"
+
+#define CLIP_FRAMES     4096
+#define BLOCK_FRAMES    48      // 1 ms at 48 kHz
+
+#define BENCH_RATE      1.3f
+
+#define MIN_SECONDS     0.25
+
+typedef struct _RESAMPLECONTEXT {
+    CONST RESAMPLEKERNELS*  pKernels;
+    CONST SHORT*            psSamples;
+    UINT                    cChannels;
+    ULONGLONG               ullPosition;
+    ULONGLONG               ullStep;
+    FLOAT                   output[BLOCK_FRAMES * 2];
+} RESAMPLECONTEXT;
+
+static UINT NextRandom(UINT* puState)
+{
+    *puState = *puState * 1664525 + 1013904223;
+    return *puState >> 8;
+}
+
+// Full scale noise, so clipping and rounding paths are taken
+static VOID FillClip(SHORT* psSamples, UINT cSamples)
+{
+    UINT uState = 1;
+    UINT i;
+
+    for (i = 0; i < cSamples; i++) {
+        psSamples[i] = (SHORT) (NextRandom(&uState) & 0xFFFF);
+    }
+}
+
+static ULONGLONG RateToStep(FLOAT fRate)
+{
+    return (ULONGLONG) ((DOUBLE) fRate * (DOUBLE) RESAMPLE_ONE);
+}
+
+static VOID ResampleOnce(LPVOID pContext)
+{
+    RESAMPLECONTEXT* pResample = (RESAMPLECONTEXT*) pContext;
+
+    ResampleClip(
+        pResample->pKernels,
+        pResample->output,
+        pResample->psSamples,
+        pResample->cChannels,
+        CLIP_FRAMES,
+        TRUE,
+        &pResample->ullPosition,
+        pResample->ullStep,
+        BLOCK_FRAMES,
+        1.0f,
+        0.0f);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+INT BenchResample()
+{
+    static CONST RESAMPLELEVEL levels[] = {
+        RESAMPLE_LEVEL_SCALAR,
+        RESAMPLE_LEVEL_SSE2
+    };
+
+    static CONST LPCSTR CHANNEL_NAMES[] = { "mono", "stereo" };
+
+    static SHORT            samples[CLIP_FRAMES * 2];
+    static RESAMPLECONTEXT  context;
+    CONST RESAMPLEKERNELS*  pKernels;
+    BENCHSTATS              stats;
+    CHAR                    szName[64];
+    DOUBLE                  fSeconds;
+    UINT                    i, cChannels;
+
+    FillClip(samples, ARRAYSIZE(samples));
+
+    for (i = 0; i < ARRAYSIZE(levels); i++) {
+        pKernels = GetResampleKernelsForLevel(levels[i]);
+
+        if (pKernels == NULL) {
+            continue;
+        }
+
+        for (cChannels = 1; cChannels <= 2; cChannels++) {
+            memset(&context, 0, sizeof(context));
+
+            context.pKernels  = pKernels;
+            context.psSamples = samples;
+            context.cChannels = cChannels;
+            context.ullStep   = RateToStep(BENCH_RATE);
+
+            snprintf(szName, sizeof(szName), "%s/%s",
+                     CHANNEL_NAMES[cChannels - 1], pKernels->pszName);
+
+            fSeconds = BenchMeasure(
+                "resample", szName, ResampleOnce, &context, BLOCK_FRAMES,
+                MIN_SECONDS, &stats);
+
+            // Voices that fit in one block's worth of real time
+            printf("resample %-7s %-7s %9.1f Mframes/s, %6.0f voices, "
+                   "%.3f ns/frame +- %.3f\n",
+                   CHANNEL_NAMES[cChannels - 1],
+                   pKernels->pszName,
+                   BLOCK_FRAMES / fSeconds / 1e6,
+                   (BLOCK_FRAMES / 48000.0) / fSeconds,
+                   stats.fNanoseconds,
+                   stats.fConfidence);
+
+            BenchConsume(context.output, sizeof(context.output));
+        }
+    }
+
+    // fp_test checks that every level renders the same samples
+    return 0;
+}
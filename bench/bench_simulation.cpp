@@ -0,0 +1,141 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+
+#include "bench.h"
+#include "clock.h"
+#include "nullplatform.h"
+#include "pointer.h"
+#include "simulation.h"
+
+#define CLOCK_FREQUENCY     10000000
+
+#define SPRITE_SIZE         64
+
+// Simulated for the faster-than-real-time figure
+#define LONG_SESSION        3600.0      // Seconds
+#define LONG_SESSION_RATE   144.0       // Frames per second
+
+typedef struct _SIMCONTEXT {
+    ManualClock*    pClock;
+    Simulation*     pSimulation;
+    Pointer*        pPointer;
+} SIMCONTEXT;
+
+static BOOL CreatePointer(RenderSink* pSink, Pointer* pPointer)
+{
+    static BYTE pixels[SPRITE_SIZE * SPRITE_SIZE * 4];
+    Sprite*     pSprite = NULL;
+
+    if (FAILED(Sprite::CreateSpriteFromPixels(
+            pSink,
+            SPRITE_SIZE,
+            SPRITE_SIZE,
+            SPRITE_SIZE * 4,
+            pixels,
+            &pSprite)))
+    {
+        return FALSE;
+    }
+
+    if (FAILED(pPointer->Initialize(
+            pSprite,
+            new NullSound(),
+            new NullSound())))
+    {
+        delete pSprite;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+// What Engine::Tick does with the simulation
+static VOID Frame(SIMCONTEXT* pContext)
+{
+    UINT cSteps, i;
+
+    cSteps = pContext->pSimulation->Advance();
+
+    for (i = 0; i < cSteps; i++) {
+        pContext->pPointer->Step(pContext->pSimulation->GetStepTime());
+    }
+
+    pContext->pPointer->Update(
+        cSteps * pContext->pSimulation->GetStepTime(),
+        pContext->pSimulation->GetAlpha());
+}
+
+static BOOL RunLongSession(DOUBLE* pfSeconds)
+{
+    SystemClock     wallClock;
+    ManualClock     clock(CLOCK_FREQUENCY);
+    NullRenderSink  sink(256.0f, 256.0f);
+    Simulation      simulation(&clock);
+    Pointer         pointer;
+    SIMCONTEXT      context = { &clock, &simulation, &pointer };
+    LONGLONG        llPeriod, llStart;
+    ULONG           cFrames, i;
+
+    if (CreatePointer(&sink, &pointer) == FALSE) {
+        return FALSE;
+    }
+
+    llPeriod = (LONGLONG) (CLOCK_FREQUENCY / LONG_SESSION_RATE);
+    cFrames = (ULONG) (LONG_SESSION * LONG_SESSION_RATE);
+
+    llStart = wallClock.GetTicks();
+
+    for (i = 0; i < cFrames; i++) {
+        clock.Advance(llPeriod);
+
+        if (i % 72 == 0) {
+            pointer.OnPress();
+        } else if (i % 72 == 36) {
+            pointer.OnRelease();
+        }
+
+        Frame(&context);
+    }
+
+    *pfSeconds = (DOUBLE) (wallClock.GetTicks() - llStart) /
+                 wallClock.GetFrequency();
+
+    BenchConsume(&i, sizeof(i));
+
+    return TRUE;
+}
+
+INT BenchSimulation()
+{
+    DOUBLE fSeconds;
+
+    // fp_test checks that cadences agree, that no step is lost and that
+    // the springs settle
+    if (RunLongSession(&fSeconds) == FALSE) {
+        printf("simulation cannot create the pointer\n");
+        return 1;
+    }
+
+    printf("simulation %.0f s at %.0f Hz in %.2f s, %.0fx real time\n",
+           LONG_SESSION,
+           LONG_SESSION_RATE,
+           fSeconds,
+           LONG_SESSION / fSeconds);
+
+    return 0;
+}
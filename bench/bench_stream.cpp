@@ -0,0 +1,172 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "audiostream.h"
+#include "flacfile.h"
+#include "mixer.h"
+#include "testflac.h"
+#include "thread.h"
+
+#define STREAM_RATE         48000
+#define STREAM_FRAMES       48000   // One second
+
+#define RENDER_BLOCK        256
+#define RENDER_PAUSE        2       // Milliseconds between blocks
+#define RENDER_TAIL         5000    // Frames rendered past the end
+
+#define MIN_SECONDS         0.25
+
+typedef struct _DECODECONTEXT {
+    CONST BYTE*     pbFile;
+    SIZE_T          cbFile;
+    FLACINFO        info;
+    INT*            piScratch;
+    SHORT*          psBlock;
+} DECODECONTEXT;
+
+// Plays the stream through a mixer at about twice real time; returns
+// the blocks the decoder did not have ready (fp_test checks the output)
+static ULONG PlayStream(AudioStream* pStream, UINT cFrames, BOOL bLoop)
+{
+    static FLOAT        output[RENDER_BLOCK * MIXER_CHANNELS];
+    Mixer*              pMixer = NULL;
+    MixerSound*         pSound = NULL;
+    AUDIOSTREAMSTATS    stats;
+    UINT                uFrame;
+
+    stats.cUnderruns = 0;
+
+    if (FAILED(Mixer::CreateMixer(STREAM_RATE, &pMixer))) {
+        delete pStream;
+        return 0;
+    }
+
+    if (FAILED(pMixer->CreateStreamSound(pStream, VOICE_STEAL_OLDEST,
+                                         &pSound)))
+    {
+        delete pStream;
+        delete pMixer;
+        return 0;
+    }
+
+    pSound->SetLoop(bLoop);
+    pSound->Play();
+
+    // Gives the decoder a moment to fill the buffers after the prime
+    Thread::SleepThread(RENDER_PAUSE * 4);
+
+    for (uFrame = 0; uFrame < cFrames + RENDER_TAIL; uFrame += RENDER_BLOCK) {
+        pMixer->Render(output, RENDER_BLOCK);
+        Thread::SleepThread(RENDER_PAUSE);
+    }
+
+    pStream->GetStats(&stats);
+
+    delete pSound;
+    delete pMixer;
+
+    return stats.cUnderruns;
+}
+
+static VOID DecodeOnce(LPVOID pContext)
+{
+    DECODECONTEXT*  pDecode = (DECODECONTEXT*) pContext;
+    SIZE_T          cbOffset = pDecode->info.cbFirstFrame;
+    UINT            cBlock;
+
+    while (DecodeFlacFrame(pDecode->pbFile, pDecode->cbFile, pDecode->info,
+                           &cbOffset, pDecode->piScratch, pDecode->psBlock,
+                           &cBlock) == S_OK)
+    {
+    }
+
+    BenchConsume(pDecode->psBlock, sizeof(SHORT) * TEST_FLAC_BLOCK);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+INT BenchStream()
+{
+    static CONST LPCSTR CHANNEL_NAMES[] = { "mono", "stereo" };
+
+    static SHORT        samples[STREAM_FRAMES * 2];
+    static BYTE         file[STREAM_FRAMES * 2 * 4];
+    static INT          scratch[TEST_FLAC_BLOCK * 2];
+    static SHORT        block[TEST_FLAC_BLOCK * 2];
+    DECODECONTEXT       decode;
+    AudioStream*        pStream = NULL;
+    AUDIOSTREAMSTATS    stats;
+    SIZE_T              cbFile;
+    DOUBLE              fSeconds;
+    ULONG               cUnderruns = 0;
+    UINT                cChannels;
+    BOOL                bLoop;
+    INT                 iResult = 0;
+
+    for (cChannels = 1; cChannels <= 2; cChannels++) {
+        TestFillSignal(samples, cChannels, STREAM_FRAMES);
+
+        cbFile = TestEncodeFlac(samples, cChannels, STREAM_FRAMES,
+                                STREAM_RATE, file, sizeof(file));
+
+        memset(&decode, 0, sizeof(decode));
+        decode.pbFile = file;
+        decode.cbFile = cbFile;
+        decode.piScratch = scratch;
+        decode.psBlock = block;
+
+        if (FAILED(ParseFlac(file, cbFile, &decode.info))) {
+            iResult = 1;
+            continue;
+        }
+
+        fSeconds = BenchRun(DecodeOnce, &decode, MIN_SECONDS);
+
+        printf("stream %-7s %-9s %7.2f ms CPU per s of audio, "
+               "%6.0fx realtime\n",
+               "decode",
+               CHANNEL_NAMES[cChannels - 1],
+               fSeconds * 1e3 * STREAM_RATE / STREAM_FRAMES,
+               STREAM_FRAMES / (DOUBLE) STREAM_RATE / fSeconds);
+
+        for (bLoop = FALSE; bLoop <= TRUE; bLoop++) {
+            if (FAILED(AudioStream::CreateAudioStream(file, cbFile, 1,
+                                                      &pStream)))
+            {
+                iResult = 1;
+                continue;
+            }
+
+            pStream->GetStats(&stats);
+
+            cUnderruns = PlayStream(pStream, STREAM_FRAMES, bLoop);
+
+            printf("stream %-7s %-9s %7u KB held, %u KB as a clip, "
+                   "%lu underruns\n",
+                   bLoop ? "loop" : "play",
+                   CHANNEL_NAMES[cChannels - 1],
+                   (UINT) (stats.cbDecoded / 1024),
+                   (UINT) (STREAM_FRAMES * cChannels * sizeof(SHORT) / 1024),
+                   (unsigned long) cUnderruns);
+        }
+    }
+
+    return iResult;
+}
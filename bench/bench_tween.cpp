@@ -0,0 +1,165 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+#include "easing.h"
+#include "tweener.h"
+#include "tweensystem.h"
+
+// Long enough that no tween of a timed run finishes before it is over,
+// since the two sides would not be doing the same work any more
+#define BENCH_DELTA     1e-6f
+#define BENCH_DURATION  100.0f
+
+#define MIN_SECONDS     0.25
+
+static CONST UINT COUNTS[] = { 10, 1000, 100000 };
+
+typedef struct _TWEENERCONTEXT {
+    Tweener**   ppTweeners;
+    UINT        cTweeners;
+} TWEENERCONTEXT;
+
+static TWEENDESC MakeDesc(UINT i, FLOAT fDuration)
+{
+    TWEENDESC desc;
+
+    memset(&desc, 0, sizeof(desc));
+
+    desc.fStart = (FLOAT) (i % 97) - 45.0f;
+    desc.fTarget = (FLOAT) (i % 13) * 7.5f;
+    desc.fDuration = fDuration;
+    desc.easing = (i % 2 == 0) ? TWEEN_EASING_LINEAR : TWEEN_EASING_OUT_CIRC;
+
+    return desc;
+}
+
+// The same curves the system runs; fp_test checks that the values match
+static Tweener* CreateTweener(CONST TWEENDESC& desc)
+{
+    return new Tweener(
+        desc.fDuration,
+        desc.fStart,
+        desc.fTarget,
+        (desc.easing == TWEEN_EASING_LINEAR)
+            ? Easing::Linear
+            : Easing::FastFunction<Easing::OutCirc>);
+}
+
+static VOID UpdateTweeners(LPVOID pContext)
+{
+    TWEENERCONTEXT* pTweeners = (TWEENERCONTEXT*) pContext;
+    UINT            i;
+
+    for (i = 0; i < pTweeners->cTweeners; i++) {
+        pTweeners->ppTweeners[i]->Update(BENCH_DELTA);
+    }
+}
+
+static VOID UpdateSystem(LPVOID pContext)
+{
+    ((TweenSystem*) pContext)->Update(BENCH_DELTA);
+}
+
+static VOID PrintStats(UINT cTweens, LPCSTR pszWay, CONST BENCHSTATS& stats)
+{
+    printf("tween %-7u %-7s %9.1f us/update, %6.2f ns/tween +- %.2f\n",
+           cTweens, pszWay,
+           stats.fNanoseconds * cTweens / 1e3,
+           stats.fNanoseconds, stats.fConfidence);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+INT BenchTween()
+{
+    static CONST TWEENLEVEL levels[] = {
+        TWEEN_LEVEL_SCALAR,
+        TWEEN_LEVEL_SSE2
+    };
+
+    CONST TWEENKERNELS* pKernels;
+    TWEENERCONTEXT      context;
+    TweenSystem*        pSystem;
+    BENCHSTATS          stats;
+    CHAR                szName[64];
+    INT                 iResult = 0;
+    UINT                i, j, k;
+
+    for (j = 0; j < ARRAYSIZE(COUNTS); j++) {
+        // Each on its own, the way objects that own a Tweener have them
+        context.cTweeners = COUNTS[j];
+        context.ppTweeners = new Tweener*[COUNTS[j]];
+
+        for (k = 0; k < COUNTS[j]; k++) {
+            context.ppTweeners[k] = CreateTweener(
+                MakeDesc(k, BENCH_DURATION + (FLOAT) (k % 100)));
+        }
+
+        snprintf(szName, sizeof(szName), "tweener/%u", COUNTS[j]);
+
+        BenchMeasure(
+            "tween", szName, UpdateTweeners, &context, COUNTS[j],
+            MIN_SECONDS, &stats);
+
+        PrintStats(COUNTS[j], "tweener", stats);
+
+        for (k = 0; k < COUNTS[j]; k++) {
+            delete context.ppTweeners[k];
+        }
+
+        delete[] context.ppTweeners;
+
+        for (i = 0; i < ARRAYSIZE(levels); i++) {
+            pKernels = GetTweenKernelsForLevel(levels[i]);
+
+            if (pKernels == NULL) {
+                continue;
+            }
+
+            if (FAILED(TweenSystem::CreateTweenSystem(COUNTS[j], &pSystem))) {
+                return 1;
+            }
+
+            pSystem->SetKernels(pKernels);
+
+            for (k = 0; k < COUNTS[j]; k++) {
+                pSystem->Start(
+                    MakeDesc(k, BENCH_DURATION + (FLOAT) (k % 100)));
+            }
+
+            snprintf(
+                szName, sizeof(szName), "%s/%u", pKernels->pszName, COUNTS[j]);
+
+            BenchMeasure(
+                "tween", szName, UpdateSystem, pSystem, COUNTS[j],
+                MIN_SECONDS, &stats);
+
+            PrintStats(COUNTS[j], pKernels->pszName, stats);
+
+            if (pSystem->GetCount() != COUNTS[j]) {
+                iResult = 1;
+            }
+
+            delete pSystem;
+        }
+    }
+
+    return iResult;
+}
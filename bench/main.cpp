@@ -0,0 +1,132 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+
+typedef struct _BENCHSUITE {
+    LPCSTR  pszName;
+    INT     (*pfnRun)();
+} BENCHSUITE;
+
+static CONST BENCHSUITE SUITES[] = {
+    { "blit",       BenchBlit },
+    { "easing",     BenchEasing },
+    { "pointer",    BenchPointer },
+    { "queue",      BenchQueue },
+    { "render",     BenchRender },
+    { "resample",   BenchResample },
+    { "simulation", BenchSimulation },
+    { "stream",     BenchStream },
+    { "tween",      BenchTween }
+};
+
+static INT Usage()
+{
+    UINT i;
+
+    fprintf(stderr, "usage: fp_bench [-j results.json] [suite...]\n"
+                    "suites:");
+
+    for (i = 0; i < ARRAYSIZE(SUITES); i++) {
+        fprintf(stderr, " %s", SUITES[i].pszName);
+    }
+
+    fprintf(stderr, "\n");
+    return 1;
+}
+
+// Usage: fp_bench [-j results.json] [suite...]
+//
+//   -j  also writes every suite's outcome and every measurement, with
+//       its confidence interval, as JSON
+int main(int argc, char** argv)
+{
+    LPCSTR  pszJson = NULL;
+    INT     iResult = 0;
+    UINT    i, cDropped;
+    int     j, cSuites = 0;
+    BOOL    bSelected, bPassed, bFound;
+
+    for (j = 1; j < argc; j++) {
+        if (strcmp(argv[j], "-j") == 0) {
+            if (j + 1 == argc) {
+                fprintf(stderr, "fp_bench: -j needs a file name\n");
+                return Usage();
+            }
+
+            pszJson = argv[++j];
+            continue;
+        }
+
+        bFound = FALSE;
+
+        for (i = 0; i < ARRAYSIZE(SUITES); i++) {
+            if (strcmp(argv[j], SUITES[i].pszName) == 0) {
+                bFound = TRUE;
+            }
+        }
+
+        if (bFound == FALSE) {
+            fprintf(stderr, "fp_bench: no suite %s\n", argv[j]);
+            return Usage();
+        }
+
+        cSuites++;
+    }
+
+    for (i = 0; i < ARRAYSIZE(SUITES); i++) {
+        bSelected = (cSuites == 0);
+
+        for (j = 1; j < argc; j++) {
+            if (strcmp(argv[j], "-j") == 0) {
+                j++;
+            } else if (strcmp(argv[j], SUITES[i].pszName) == 0) {
+                bSelected = TRUE;
+            }
+        }
+
+        if (bSelected == FALSE) {
+            continue;
+        }
+
+        bPassed = (SUITES[i].pfnRun() == 0);
+        BenchRecordSuite(SUITES[i].pszName, bPassed);
+
+        if (bPassed == FALSE) {
+            fprintf(stderr, "%s: FAILED\n", SUITES[i].pszName);
+            iResult = 1;
+        }
+    }
+
+    // A run that lost measurements would pass with a partial JSON
+    cDropped = BenchGetDropped();
+
+    if (cDropped != 0) {
+        fprintf(stderr, "fp_bench: %u measurements over the limit "
+                        "were not kept\n", cDropped);
+        iResult = 1;
+    }
+
+    if (pszJson != NULL && BenchWriteJson(pszJson) == FALSE) {
+        fprintf(stderr, "fp_bench: cannot write %s\n", pszJson);
+        iResult = 1;
+    }
+
+    return iResult;
+}
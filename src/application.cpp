@@ -18,8 +18,11 @@
 
 #include <windowsx.h>
 #include <dwmapi.h>
+#include <stdarg.h>
 
+#include "atomic.h"
 #include "safemem.h"
+#include "trace.h"
 
 #include "resource.h"
 
@@ -31,6 +34,37 @@
 #define HK_TOGGLE_VISIBILITY        1   // ALT + H
 #define HK_TOGGLE_MARKER            2   // ALT + M
 
+#ifndef WM_DPICHANGED
+#define WM_DPICHANGED               0x02E0
+#endif
+
+#define DEFAULT_DPI                 96.0f
+
+#define DEFAULT_SAMPLE_RATE         48000
+
+// Generic desktop page, mouse usage
+#define RAW_INPUT_USAGE_PAGE        0x01
+#define RAW_INPUT_USAGE_MOUSE       0x02
+
+// Absolute raw positions span 0..RAW_INPUT_ABSOLUTE_MAX
+#define RAW_INPUT_ABSOLUTE_MAX      65535.0f
+
+// Clicks that may ring at once before the oldest is cut off
+#define EFFECT_VOICES               6
+
+// Written to the temporary directory by the tray menu
+#define LATENCY_REPORT_FILE         TEXT("FingerPointer latency.txt")
+#define LATENCY_REPORT_SIZE         1024
+
+#ifdef FP_TRACE
+#define TIMELINE_FILE               TEXT("FingerPointer timeline.json")
+#endif
+
+// FLAC files here, next to the executable, replace the built-in sounds
+#define SOUND_PACK_DIR              TEXT("sounds")
+#define SOUND_PACK_EFFECT           TEXT("effect.flac")
+#define SOUND_PACK_EFFECT_MOVE      TEXT("effect_move.flac")
+
 ////////////////////////////////////////////////////////////////////////////
 // Helper
 ////////////////////////////////////////////////////////////////////////////
@@ -44,24 +78,129 @@ static VOID OpenUrl(LPCTSTR lpszUrl)
     ShellExecute(NULL, TEXT("open"), lpszUrl, NULL, NULL, SW_SHOWNORMAL);
 }
 
-static VOID CenterCursor(HWND hRelWnd)
+static FLOAT GetDisplayRefreshRate()
 {
-    RECT  rcClient;
-    POINT ptCenter;
+    DEVMODE devMode = {0};
 
-    if (hRelWnd != NULL) {
-        GetClientRect(hRelWnd, &rcClient);
+    devMode.dmSize = sizeof(DEVMODE);
 
-        ptCenter.x = (rcClient.right - rcClient.left) / 2;
-        ptCenter.y = (rcClient.bottom - rcClient.top) / 2;
+    if (EnumDisplaySettings(NULL, ENUM_CURRENT_SETTINGS, &devMode) == FALSE) {
+        return FRAME_RATE_DEFAULT;
+    }
 
-        ClientToScreen(hRelWnd, &ptCenter);
-    } else {
-        ptCenter.x = GetSystemMetrics(SM_CXSCREEN) / 2;
-        ptCenter.y = GetSystemMetrics(SM_CYSCREEN) / 2;
+    // 0 and 1 mean "hardware default"
+    if (devMode.dmDisplayFrequency <= 1) {
+        return FRAME_RATE_DEFAULT;
+    }
+
+    return (FLOAT) devMode.dmDisplayFrequency;
+}
+
+// Per-monitor awareness where the system has it, so the overlay is drawn
+// in physical pixels and scaled by the engine instead of stretched by DWM
+static VOID EnableDpiAwareness()
+{
+    typedef BOOL (WINAPI *SETPROCESSDPIAWARENESSCONTEXTPROC)(HANDLE);
+
+    SETPROCESSDPIAWARENESSCONTEXTPROC   pfnSetContext;
+    HMODULE                             hUser32;
+
+    hUser32 = GetModuleHandle(TEXT("user32.dll"));
+
+    pfnSetContext = (SETPROCESSDPIAWARENESSCONTEXTPROC) GetProcAddress(
+        hUser32, "SetProcessDpiAwarenessContext");
+
+    // DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2
+    if (pfnSetContext != NULL && pfnSetContext((HANDLE) -4) != FALSE) {
+        return;
     }
 
-    SetCursorPos(ptCenter.x, ptCenter.y);
+    SetProcessDPIAware();
+}
+
+static FLOAT GetWindowDpiScale(HWND hWnd)
+{
+    typedef UINT (WINAPI *GETDPIFORWINDOWPROC)(HWND);
+
+    GETDPIFORWINDOWPROC pfnGetDpiForWindow;
+    HDC                 hdc;
+    UINT                uDpi = 0;
+
+    pfnGetDpiForWindow = (GETDPIFORWINDOWPROC) GetProcAddress(
+        GetModuleHandle(TEXT("user32.dll")), "GetDpiForWindow");
+
+    if (pfnGetDpiForWindow != NULL) {
+        uDpi = pfnGetDpiForWindow(hWnd);
+    }
+
+    if (uDpi == 0) {
+        hdc = GetDC(hWnd);
+        uDpi = GetDeviceCaps(hdc, LOGPIXELSX);
+        ReleaseDC(hWnd, hdc);
+    }
+
+    return (uDpi != 0) ? uDpi / DEFAULT_DPI : 1.0f;
+}
+
+static VOID DebugPrint(LPCTSTR lpszFormat, ...)
+{
+    TCHAR   szBuffer[512];
+    va_list args;
+
+    va_start(args, lpszFormat);
+    wvsprintf(szBuffer, lpszFormat, args);
+    va_end(args);
+
+    OutputDebugString(szBuffer);
+}
+
+// The sound pack's file when there is one that plays, the WAVE
+// resource otherwise
+static HRESULT CreateEffectSound(
+    Mixer*          pMixer,
+    HINSTANCE       hInstance,
+    LPCTSTR         lpszPackFile,
+    INT             iResource,
+    UINT            cVoices,
+    MixerSound**    ppSound)
+{
+    TCHAR   szPath[MAX_PATH];
+    DWORD   cchPath;
+    HRESULT hResult;
+
+    cchPath = GetModuleFileName(NULL, szPath, MAX_PATH);
+
+    if (cchPath != 0 && cchPath < MAX_PATH &&
+        PathRemoveFileSpec(szPath) != FALSE &&
+        PathAppend(szPath, SOUND_PACK_DIR) != FALSE &&
+        PathAppend(szPath, lpszPackFile) != FALSE &&
+        PathFileExists(szPath) != FALSE)
+    {
+        hResult = CreateSoundFromFile(
+            pMixer,
+            szPath,
+            cVoices,
+            VOICE_STEAL_OLDEST,
+            ppSound);
+
+        if (SUCCEEDED(hResult)) {
+            return hResult;
+        }
+
+        DebugPrint(
+            TEXT("FingerPointer: %s not played (0x%08lX)\n"),
+            szPath,
+            (ULONG) hResult);
+    }
+
+    return CreateSoundFromResource(
+        pMixer,
+        hInstance,
+        MAKEINTRESOURCE(iResource),
+        TEXT("WAVE"),
+        cVoices,
+        VOICE_STEAL_OLDEST,
+        ppSound);
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -73,17 +212,38 @@ Application::Application()
       _hInstance(NULL),
       _pRenderTarget(NULL),
       _pFactory(NULL),
+      _pSink(NULL),
+      _pMixer(NULL),
+      _pAudioOutput(NULL),
+      _engine(&_clock),
+      _input(&_clock, &_engine),
+      _pRenderThread(NULL),
+      _pFrameEvent(NULL),
+      _lRendering(0),
+      _absolute(Geometry::MakePoint(0.0f, 0.0f)),
+      _bAbsoluteValid(FALSE),
+      _bRawInput(FALSE),
       _bShow(FALSE)
 {
+    _ptCenter.x = 0;
+    _ptCenter.y = 0;
+    _ptScreenCenter = _ptCenter;
+    _szTracePath[0] = TEXT('\0');
 }
 
-HRESULT Application::Initialize(HINSTANCE hInstance)
+HRESULT Application::Initialize(HINSTANCE hInstance, LPCTSTR lpszTracePath)
 {
     WNDCLASSEX  wcex = {0};
     MARGINS     margins = {-1};
     HICON       hIcon = NULL;
     TCHAR       szTitle[512];
 
+    if (lpszTracePath != NULL) {
+        lstrcpyn(_szTracePath, lpszTracePath, MAX_PATH);
+    }
+
+    EnableDpiAwareness();
+
     hIcon = LoadIcon(hInstance, MAKEINTRESOURCE(IDI_ICON));
 
     wcex.cbSize        = sizeof(WNDCLASSEX);
@@ -126,23 +286,59 @@ HRESULT Application::Initialize(HINSTANCE hInstance)
 
 VOID Application::RunMessageLoop()
 {
-    FLOAT   fDelta = 0.0f;
     MSG     msg = {0};
+    BOOL    bBlocking = FALSE;
+
+    FP_TRACE_THREAD("main");
 
     while (msg.message != WM_QUIT) {
-        if (_bShow == TRUE) {
-            if (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
+        // Sound changes that found the audio queue full
+        if (_pMixer != NULL) {
+            _pMixer->Flush();
+        }
+
+        if (_bShow == TRUE && _engine.IsIdle() == FALSE) {
+            bBlocking = FALSE;
+
+            // Sleep until input arrives or the next frame is due
+            MsgWaitForMultipleObjectsEx(
+                0,
+                NULL,
+                _engine.GetTimeout(),
+                QS_ALLINPUT,
+                MWMO_INPUTAVAILABLE);
+
+            while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) {
+                if (msg.message == WM_QUIT) {
+                    break;
+                }
+
+                TranslateMessage(&msg);
                 DispatchMessage(&msg);
-            } else {
-                _timer.Tick();
-    
-                OnUpdate(_timer.GetDeltaTime());
-                OnRender();
             }
+
+            // However many packets came in, one move per frame
+            _input.Flush();
+
+            if (msg.message == WM_QUIT || _bShow == FALSE) {
+                continue;
+            }
+
+            _input.Tick();
         } else {
+            // Hidden, or nothing on screen will change until the next
+            // message: block without burning CPU. The engine stays
+            // suspended until it ticks again, so only the first block
+            // after running needs to say so.
+            if (bBlocking == FALSE) {
+                _input.Suspend();
+                bBlocking = TRUE;
+            }
+
             if (GetMessage(&msg, NULL, 0, 0) > 0) {
                 TranslateMessage(&msg);
                 DispatchMessage(&msg);
+                _input.Flush();
             }
         }
     }
@@ -150,28 +346,392 @@ VOID Application::RunMessageLoop()
 
 VOID Application::ToggleWindowVisibility()
 {
+    FrameScheduler*     pScheduler = _engine.GetScheduler();
+    MIXERSTATS          mixerStats;
+    CONST Histogram*    pLatency;
+    HRESULT             hResult;
+
     _bShow = !_bShow;
 
-    CenterCursor(_hWnd);
+    if (_bShow == TRUE) {
+        // 1ms wait granularity for the frame scheduler
+        timeBeginPeriod(1);
+
+        _input.OnShow(GetDisplayRefreshRate());
+
+        // Without the thread the message loop draws, as it always did
+        hResult = StartRenderThread();
+
+        if (FAILED(hResult)) {
+            DebugPrint(
+                TEXT("FingerPointer: no render thread (0x%08lX)\n"),
+                (ULONG) hResult);
+        }
+    } else {
+        StopRenderThread();
+
+        _input.OnHide();
+
+        timeEndPeriod(1);
+
+        pLatency = _engine.GetLatencyMonitor()->GetHistogram(
+            LATENCY_INPUT_TO_PRESENT);
+
+        if (pLatency->GetCount() != 0) {
+            DebugPrint(
+                TEXT("FingerPointer: input to present %lu us p50, ")
+                TEXT("%lu us p99\n"),
+                (DWORD) pLatency->GetPercentile(50.0),
+                (DWORD) pLatency->GetPercentile(99.0));
+        }
+
+        DebugPrint(
+            TEXT("FingerPointer: %lu frames (%lu rendered, %lu skipped), ")
+            TEXT("%lu late\n"),
+            (DWORD) pScheduler->GetFrameCount(),
+            (DWORD) pScheduler->GetRenderedFrameCount(),
+            (DWORD) pScheduler->GetSkippedFrameCount(),
+            (DWORD) pScheduler->GetLateFrameCount());
+
+        _pMixer->GetStats(&mixerStats);
+
+        DebugPrint(
+            TEXT("FingerPointer: %u of %u voices in use, %lu stolen\n"),
+            mixerStats.cVoicesInUse,
+            mixerStats.cVoicesReserved,
+            (ULONG) mixerStats.cVoicesStolen);
+    }
+
+    _bAbsoluteValid = FALSE;
+
+    if (_bShow == TRUE) {
+        LockCursor();
+    } else {
+        ClipCursor(NULL);
+        SetCursorPos(_ptScreenCenter.x, _ptScreenCenter.y);
+    }
+
     ShowWindow(_hWnd, (_bShow == TRUE) ? SW_SHOW : SW_HIDE);
     UpdateWindow(_hWnd);
 }
 
-////////////////////////////////////////////////////////////////////////////
-// Render
-////////////////////////////////////////////////////////////////////////////
+HRESULT Application::StartRenderThread()
+{
+    HRESULT hResult;
+
+    if (_pRenderThread != NULL) {
+        return S_OK;
+    }
+
+    hResult = ThreadEvent::CreateThreadEvent(&_pFrameEvent);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    // The sink and the sprite are only ever used by one thread at a
+    // time, so the single threaded factory is enough: the render thread
+    // has them from here until StopRenderThread() joins it
+    _engine.GetRenderer()->SetRefreshRate(
+        _engine.GetScheduler()->GetTargetRate());
+    _engine.GetRenderer()->SetFrameEvent(_pFrameEvent);
+    _engine.SetThreadedRendering(TRUE);
+    AtomicStoreRelease(&_lRendering, 1);
+
+    hResult = Thread::CreateThread(RenderThreadProc, this, &_pRenderThread);
+
+    if (FAILED(hResult)) {
+        AtomicStoreRelease(&_lRendering, 0);
+        _engine.SetThreadedRendering(FALSE);
+        _engine.GetRenderer()->SetFrameEvent(NULL);
+        SafeDelete(&_pFrameEvent);
+    }
+
+    return hResult;
+}
+
+VOID Application::StopRenderThread()
+{
+    if (_pRenderThread == NULL) {
+        return;
+    }
+
+    // It may be waiting for a frame that is not coming
+    AtomicStoreRelease(&_lRendering, 0);
+    _pFrameEvent->Set();
+    SafeDelete(&_pRenderThread);
+
+    _engine.SetThreadedRendering(FALSE);
+    _engine.GetRenderer()->SetFrameEvent(NULL);
+    SafeDelete(&_pFrameEvent);
+}
+
+VOID Application::RenderThreadProc(LPVOID pContext)
+{
+    Application*        pThis = (Application*) pContext;
+    Renderer*           pRenderer = pThis->_engine.GetRenderer();
+    CONST FRAMESTATE*   pFrame;
+    D2D1_SIZE_U         size;
+    DWORD               dwTimeout;
+
+    FP_TRACE_THREAD("render");
+
+    while (AtomicLoadAcquire(&pThis->_lRendering) != 0) {
+        dwTimeout = pRenderer->GetLatchTimeout();
+
+        if (dwTimeout > 0) {
+            Thread::SleepThread(dwTimeout);
+            continue;
+        }
+
+        // A frame published since Acquire() looked left the event set
+        if (pRenderer->Acquire() == FALSE) {
+            pThis->_pFrameEvent->Wait(INFINITE);
+            continue;
+        }
+
+        pFrame = &pRenderer->GetFrame();
+
+        // The target follows the display here, where it is drawn
+        size = pThis->_pRenderTarget->GetPixelSize();
+
+        if (size.width != (UINT32) pFrame->viewport.width ||
+            size.height != (UINT32) pFrame->viewport.height)
+        {
+            pThis->_pRenderTarget->Resize(D2D1::SizeU(
+                (UINT32) pFrame->viewport.width,
+                (UINT32) pFrame->viewport.height));
+        }
+
+        // EndDraw() waits for the vertical blank; only this thread does
+        pRenderer->Render(*pFrame);
+    }
+}
+
+VOID Application::UpdateWindowMetrics()
+{
+    RECT rcClient;
+
+    GetClientRect(_hWnd, &rcClient);
+
+    _ptCenter.x = (rcClient.right - rcClient.left) / 2;
+    _ptCenter.y = (rcClient.bottom - rcClient.top) / 2;
+
+    _ptScreenCenter = _ptCenter;
+    ClientToScreen(_hWnd, &_ptScreenCenter);
+}
+
+VOID Application::LockCursor()
+{
+    RECT rcLock;
+
+    SetCursorPos(_ptScreenCenter.x, _ptScreenCenter.y);
+
+    // Motion comes through WM_INPUT, so the cursor can stay put: it
+    // never reaches a screen edge and clicks always land on the window
+    if (_bRawInput == TRUE) {
+        rcLock.left = _ptScreenCenter.x;
+        rcLock.top = _ptScreenCenter.y;
+        rcLock.right = _ptScreenCenter.x + 1;
+        rcLock.bottom = _ptScreenCenter.y + 1;
+
+        ClipCursor(&rcLock);
+    }
+}
+
+VOID Application::StartTrace()
+{
+    InputTraceWriter*   pTrace = NULL;
+    INPUTTRACEINFO      info;
+    Geometry::Size      size;
+    HRESULT             hResult;
+
+    if (_szTracePath[0] == TEXT('\0')) {
+        return;
+    }
+
+    size = _engine.GetPointer()->GetSprite()->GetBitmapSize();
+
+    info.llFrequency = _clock.GetFrequency();
+    info.llStart = _clock.GetTicks();
+    info.uSpriteWidth = (UINT) size.width;
+    info.uSpriteHeight = (UINT) size.height;
+
+    hResult = InputTraceWriter::CreateInputTraceWriter(
+        _szTracePath,
+        info,
+        &pTrace);
+
+    if (FAILED(hResult)) {
+        DebugPrint(
+            TEXT("FingerPointer: cannot record to %s (0x%08lX)\n"),
+            _szTracePath,
+            (ULONG) hResult);
+        return;
+    }
+
+    _input.SetTrace(pTrace);
+}
+
+VOID Application::SaveLatencyReport()
+{
+    CHAR    szReport[LATENCY_REPORT_SIZE];
+    TCHAR   szPath[MAX_PATH];
+    HANDLE  hFile;
+    SIZE_T  cchReport;
+    DWORD   cchPath, cbWritten;
+    BOOL    bWritten;
+
+    // Lock free, the render thread may go on recording meanwhile
+    cchReport = _engine.GetLatencyMonitor()->FormatReport(
+        szReport,
+        ARRAYSIZE(szReport));
+
+    if (cchReport == 0) {
+        return;
+    }
+
+    cchPath = GetTempPath(MAX_PATH, szPath);
+
+    if (cchPath == 0 || cchPath >= MAX_PATH ||
+        PathAppend(szPath, LATENCY_REPORT_FILE) == FALSE)
+    {
+        return;
+    }
 
-VOID Application::OnRender()
+    hFile = CreateFile(
+        szPath,
+        GENERIC_WRITE,
+        0,
+        NULL,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+
+    if (hFile == INVALID_HANDLE_VALUE) {
+        DebugPrint(
+            TEXT("FingerPointer: cannot write %s (%lu)\n"),
+            szPath,
+            GetLastError());
+        return;
+    }
+
+    bWritten = WriteFile(hFile, szReport, (DWORD) cchReport, &cbWritten, NULL);
+    CloseHandle(hFile);
+
+    if (bWritten != FALSE) {
+        OpenUrl(szPath);
+    }
+}
+
+#ifdef FP_TRACE
+VOID Application::SaveTimeline()
 {
-    _pRenderTarget->BeginDraw();
-    _pRenderTarget->Clear();
-    _pointer.Draw(_pRenderTarget);
-    _pRenderTarget->EndDraw();
+    TCHAR   szPath[MAX_PATH];
+    DWORD   cchPath;
+    HRESULT hResult;
+
+    cchPath = GetTempPath(MAX_PATH, szPath);
+
+    if (cchPath == 0 || cchPath >= MAX_PATH ||
+        PathAppend(szPath, TIMELINE_FILE) == FALSE)
+    {
+        return;
+    }
+
+    hResult = Trace::WriteJson(szPath);
+
+    DebugPrint(
+        TEXT("FingerPointer: frame timeline to %s (0x%08lX)\n"),
+        szPath,
+        (ULONG) hResult);
 }
+#endif // FP_TRACE
 
-VOID Application::OnUpdate(FLOAT fDelta)
+HRESULT Application::CreateAudio()
 {
-    _pointer.Update(fDelta);
+    HRESULT hResult;
+
+    hResult = AudioOutput::CreateAudioOutput(&_pAudioOutput);
+
+    // No audio device is not fatal, the pointer just stays silent
+    if (FAILED(hResult)) {
+        DebugPrint(
+            TEXT("FingerPointer: no audio output (0x%08lX)\n"),
+            (ULONG) hResult);
+
+        return Mixer::CreateMixer(DEFAULT_SAMPLE_RATE, &_pMixer);
+    }
+
+    hResult = Mixer::CreateMixer(_pAudioOutput->GetSampleRate(), &_pMixer);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    hResult = _pAudioOutput->Start(_pMixer);
+
+    if (FAILED(hResult)) {
+        SafeDelete(&_pAudioOutput);
+    }
+
+    return S_OK;
+}
+
+HRESULT Application::CreateEngineResources()
+{
+    Sprite*     pSprite = NULL;
+    MixerSound* pEffect = NULL;
+    MixerSound* pEffectMove = NULL;
+    HRESULT     hResult;
+
+    FP_TRACE_SCOPE("Application::CreateEngineResources");
+
+    hResult = Sprite::CreateSpriteFromResource(
+        _pSink,
+        _hInstance,
+        MAKEINTRESOURCE(IDR_POINTER_PNG),
+        RT_RCDATA,
+        &pSprite);
+
+    if (FAILED(hResult)) {
+        goto failed;
+    }
+
+    hResult = CreateEffectSound(
+        _pMixer,
+        _hInstance,
+        SOUND_PACK_EFFECT,
+        IDR_EFFECT_WAV,
+        EFFECT_VOICES,
+        &pEffect);
+
+    if (FAILED(hResult)) {
+        goto failed;
+    }
+
+    hResult = CreateEffectSound(
+        _pMixer,
+        _hInstance,
+        SOUND_PACK_EFFECT_MOVE,
+        IDR_EFFECT_MOVE_WAV,
+        1,
+        &pEffectMove);
+
+    if (FAILED(hResult)) {
+        goto failed;
+    }
+
+    hResult = _engine.Initialize(_pSink, pSprite, pEffect, pEffectMove);
+
+failed:
+    if (FAILED(hResult)) {
+        SafeDelete(&pSprite);
+        SafeDelete(&pEffect);
+        SafeDelete(&pEffectMove);
+    }
+
+    return hResult;
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -183,7 +743,8 @@ LRESULT Application::OnCreate(WPARAM wParam, LPARAM lParam)
     D2D1_RENDER_TARGET_PROPERTIES       renderTargetProps;
     D2D1_HWND_RENDER_TARGET_PROPERTIES  hwndRenderTargetProps;
     D2D1_PIXEL_FORMAT                   pixelFormat;
-    D2D1_SIZE_F                         pointerSize;
+    RAWINPUTDEVICE                      rawInputDevice;
+    Geometry::Size                      size;
     RECT                                rc;
     TCHAR                               szInfo[1024];
     TCHAR                               szTitle[512];
@@ -202,13 +763,19 @@ LRESULT Application::OnCreate(WPARAM wParam, LPARAM lParam)
     pixelFormat.alphaMode = D2D1_ALPHA_MODE_PREMULTIPLIED;
     pixelFormat.format    = DXGI_FORMAT_B8G8R8A8_UNORM;
     
+    // One DIP per pixel: the engine works in pixels and applies the
+    // DPI scale itself
     renderTargetProps = D2D1::RenderTargetProperties(
         D2D1_RENDER_TARGET_TYPE_DEFAULT,
-        pixelFormat);
+        pixelFormat,
+        DEFAULT_DPI,
+        DEFAULT_DPI);
 
+    // Partial redraws rely on the previous frame surviving the present
     hwndRenderTargetProps = D2D1::HwndRenderTargetProperties(
         _hWnd,
-        D2D1::SizeU(rc.right - rc.left, rc.bottom - rc.top));
+        D2D1::SizeU(rc.right - rc.left, rc.bottom - rc.top),
+        D2D1_PRESENT_OPTIONS_RETAIN_CONTENTS);
 
     hResult = _pFactory->CreateHwndRenderTarget(
         renderTargetProps,
@@ -219,18 +786,40 @@ LRESULT Application::OnCreate(WPARAM wParam, LPARAM lParam)
         goto destroy;
     }
 
-    hResult = _pointer.InitializeResources(_pRenderTarget, _hInstance);
+    hResult = D2DRenderSink::CreateD2DRenderSink(_pRenderTarget, &_pSink);
 
     if (FAILED(hResult)) {
         goto destroy;
     }
 
-    pointerSize = _pointer.GetSize();
+    hResult = CreateAudio();
+
+    if (FAILED(hResult)) {
+        goto destroy;
+    }
 
-    _pointer.SetPosition(D2D1::Point2F(
-        (((FLOAT)(rc.right - rc.left)) - pointerSize.width)  / 2.0f,
-        (((FLOAT)(rc.bottom - rc.top)) - pointerSize.height) / 2.0f
-    ));
+    hResult = CreateEngineResources();
+
+    if (FAILED(hResult)) {
+        goto destroy;
+    }
+
+    StartTrace();
+
+    // The viewport is already the target's size; recorded for replays
+    size = _engine.GetViewport();
+
+    _input.OnDisplay(size.width, size.height);
+    _input.OnDpiScale(GetWindowDpiScale(_hWnd));
+    _input.OnCenter();
+
+    DebugPrint(
+        TEXT("FingerPointer: sprite mip chain uses %lu KiB\n"),
+        (ULONG) (_engine.GetPointer()->GetSprite()->GetMipMemoryUsage() / 1024));
+
+    DebugPrint(
+        TEXT("FingerPointer: converted sound samples use %lu KiB\n"),
+        (ULONG) (_pMixer->GetSamplePool()->GetMemoryUsage() / 1024));
 
     RegisterHotKey(
         _hWnd,
@@ -244,6 +833,20 @@ LRESULT Application::OnCreate(WPARAM wParam, LPARAM lParam)
         MOD_ALT | MOD_NOREPEAT,
         0x4D /* M */);
 
+    // Mouse counts at the full device rate, even while another window
+    // has the focus; without it the cursor is re-centered on every move
+    rawInputDevice.usUsagePage = RAW_INPUT_USAGE_PAGE;
+    rawInputDevice.usUsage = RAW_INPUT_USAGE_MOUSE;
+    rawInputDevice.dwFlags = RIDEV_INPUTSINK;
+    rawInputDevice.hwndTarget = _hWnd;
+
+    _bRawInput = RegisterRawInputDevices(
+        &rawInputDevice,
+        1,
+        sizeof(rawInputDevice));
+
+    UpdateWindowMetrics();
+
     if (_trayIcon.Add(_hWnd, UM_TRAYICON, ID_TRAYICON) == FALSE) {
         goto destroy;
     }
@@ -259,6 +862,14 @@ destroy:
     return S_FALSE;
 }
 
+LRESULT Application::OnPaint(WPARAM wParam, LPARAM lParam)
+{
+    // The frame is drawn by the message loop, just make sure it happens
+    _engine.Invalidate();
+    ValidateRect(_hWnd, NULL);
+    return 0;
+}
+
 LRESULT Application::OnTrayIcon(WPARAM wParam, LPARAM lParam)
 {
     HMENU hMenu = NULL;
@@ -295,64 +906,95 @@ LRESULT Application::OnTrayIcon(WPARAM wParam, LPARAM lParam)
 
 LRESULT Application::OnMouseWheel(WPARAM wParam, LPARAM lParam)
 {
-    SHORT zDelta = GET_WHEEL_DELTA_WPARAM(wParam);
-    FLOAT fScale = _pointer.GetScale();
-
-    _pointer.SetScale(fScale + ((zDelta > 0) ? -0.05f : 0.05f));
+    _input.OnWheel(GET_WHEEL_DELTA_WPARAM(wParam));
     return 0;
 }
 
 LRESULT Application::OnMouseMove(WPARAM wParam, LPARAM lParam)
 {
-    D2D1_POINT_2F   position;
-    INT             iClientWidth, iClientHeight;
-    INT             iDeltaX, iDeltaY;
-    INT             iMinX, iMinY, iMaxX, iMaxY;
-    RECT            rcClient;
+    INT x = GET_X_LPARAM(lParam);
+    INT y = GET_Y_LPARAM(lParam);
 
-    ////////////////////////////////////////////////////////////////
-    // Shifting the pointer position
+    SetCursor(NULL);
 
-    GetClientRect(_hWnd, &rcClient);
+    // Our own SetCursorPos()
+    if (x == _ptCenter.x && y == _ptCenter.y) {
+        return 0;
+    }
 
-    iClientWidth  = rcClient.right - rcClient.left;
-    iClientHeight = rcClient.bottom - rcClient.top;
+    // With raw input this only happens when the clip was lost, e.g. to
+    // another window taking the focus; the motion itself was counted
+    if (_bRawInput == FALSE) {
+        _input.OnPixels(
+            (FLOAT) (x - _ptCenter.x),
+            (FLOAT) (y - _ptCenter.y));
+    }
 
-    iDeltaX = GET_X_LPARAM(lParam) - (iClientWidth  / 2);
-    iDeltaY = GET_Y_LPARAM(lParam) - (iClientHeight / 2);
+    LockCursor();
+    return 0;
+}
 
-    position.x = _pointer.GetPosition().x + (FLOAT) iDeltaX;
-    position.y = _pointer.GetPosition().y + (FLOAT) iDeltaY;
+VOID Application::OnInput(WPARAM wParam, LPARAM lParam)
+{
+    RAWINPUT        input;
+    RAWMOUSE*       pMouse = &input.data.mouse;
+    UINT            cbInput = sizeof(input);
+    Geometry::Point position;
+    FLOAT           fWidth, fHeight;
 
-    iMinX = -_pointer.GetSize().width;
-    iMinY = -_pointer.GetSize().height;
-    iMaxX = iClientWidth  + (-iMinX);
-    iMaxY = iClientHeight + (-iMinY);
+    if (_bShow == FALSE) {
+        return;
+    }
 
-    position.x = fmaxf(iMinX, fminf(position.x, iMaxX));
-    position.y = fmaxf(iMinY, fminf(position.y, iMaxY));
+    if (GetRawInputData(
+            (HRAWINPUT) lParam,
+            RID_INPUT,
+            &input,
+            &cbInput,
+            sizeof(RAWINPUTHEADER)) == (UINT) -1 ||
+        input.header.dwType != RIM_TYPEMOUSE)
+    {
+        return;
+    }
 
-    _pointer.SetPosition(position);
+    if ((pMouse->usFlags & MOUSE_MOVE_ABSOLUTE) == 0) {
+        _input.OnCounts(pMouse->lLastX, pMouse->lLastY);
+        return;
+    }
 
-    ////////////////////////////////////////////////////////////////
-    // Lock and hide cursor
+    // Pens and remote desktops report where the pointer is, not how far
+    // it went; the difference is already in pixels
+    if (pMouse->usFlags & MOUSE_VIRTUAL_DESKTOP) {
+        fWidth = (FLOAT) GetSystemMetrics(SM_CXVIRTUALSCREEN);
+        fHeight = (FLOAT) GetSystemMetrics(SM_CYVIRTUALSCREEN);
+    } else {
+        fWidth = (FLOAT) GetSystemMetrics(SM_CXSCREEN);
+        fHeight = (FLOAT) GetSystemMetrics(SM_CYSCREEN);
+    }
 
-    CenterCursor(_hWnd);
-    SetCursor(NULL);
+    position = Geometry::MakePoint(
+        pMouse->lLastX * fWidth / RAW_INPUT_ABSOLUTE_MAX,
+        pMouse->lLastY * fHeight / RAW_INPUT_ABSOLUTE_MAX);
 
-    ////////////////////////////////////////////////////////////////
-    return 0;
+    if (_bAbsoluteValid == TRUE) {
+        _input.OnPixels(
+            position.x - _absolute.x,
+            position.y - _absolute.y);
+    }
+
+    _absolute = position;
+    _bAbsoluteValid = TRUE;
 }
 
 LRESULT Application::OnLeftButtonDown(WPARAM wParam, LPARAM lParam)
 {
-    _pointer.OnPress();
+    _input.OnPress();
     return 0;
 }
 
 LRESULT Application::OnLeftButtonUp(WPARAM wParam, LPARAM lParam)
 {
-    _pointer.OnRelease();
+    _input.OnRelease();
     return 0;
 }
 
@@ -363,7 +1005,7 @@ LRESULT Application::OnHotkey(WPARAM wParam, LPARAM lParam)
             ToggleWindowVisibility();
             break;
         case HK_TOGGLE_MARKER:
-            _pointer.ToggleMarker();
+            _input.OnToggleMarker();
             break;
     }
     return 0;
@@ -377,6 +1019,14 @@ LRESULT Application::OnCommand(WPARAM wParam, LPARAM lParam)
         case IDM_ITEM_SHOW:
             ToggleWindowVisibility();
             break;
+        case IDM_ITEM_LATENCY:
+            SaveLatencyReport();
+            break;
+#ifdef FP_TRACE
+        case IDM_ITEM_TIMELINE:
+            SaveTimeline();
+            break;
+#endif
         case IDM_ITEM_SOURCE_CODE:
             LoadString(_hInstance, IDS_GITHUB_URL, szUrl, MAX_PATH);
             OpenUrl(szUrl);
@@ -397,11 +1047,68 @@ LRESULT Application::OnCommand(WPARAM wParam, LPARAM lParam)
     return 0;
 }
 
+LRESULT Application::OnDpiChanged(WPARAM wParam, LPARAM lParam)
+{
+    // The window keeps covering the screen, only the pointer is resized
+    _input.OnDpiScale(LOWORD(wParam) / DEFAULT_DPI);
+    return 0;
+}
+
+LRESULT Application::OnDisplayChange(WPARAM wParam, LPARAM lParam)
+{
+    UINT uWidth = LOWORD(lParam);
+    UINT uHeight = HIWORD(lParam);
+
+    // The window covers the screen, so it follows the new resolution
+    SetWindowPos(
+        _hWnd,
+        NULL,
+        0,
+        0,
+        uWidth,
+        uHeight,
+        SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
+
+    // The render thread, if it runs, owns the target; it resizes it
+    // before it draws the first frame at the new size
+    if (_pRenderTarget != NULL) {
+        if (_pRenderThread == NULL) {
+            _pRenderTarget->Resize(D2D1::SizeU(uWidth, uHeight));
+        }
+
+        _input.OnDisplay((FLOAT) uWidth, (FLOAT) uHeight);
+    }
+
+    UpdateWindowMetrics();
+
+    if (_bShow == TRUE) {
+        LockCursor();
+    }
+
+    return 0;
+}
+
 LRESULT Application::OnDestroy(WPARAM wParam, LPARAM lParam)
 {
+    StopRenderThread();
+
+#ifdef FP_TRACE
+    SaveTimeline();
+#endif
+
+    if (_bShow == TRUE) {
+        timeEndPeriod(1);
+        ClipCursor(NULL);
+    }
+
+    SafeDelete(&_pSink);
     SafeRelease(&_pRenderTarget);
     SafeRelease(&_pFactory);
 
+    // The engine's sounds outlive the mixer and go silent with it
+    SafeDelete(&_pAudioOutput);
+    SafeDelete(&_pMixer);
+
     PostQuitMessage(0);
     return 0;
 }
@@ -433,12 +1140,18 @@ LRESULT CALLBACK Application::WndProc(
     switch (uMsg) {
         case WM_CREATE:
             return pThis->OnCreate(wParam, lParam);
+        case WM_PAINT:
+            return pThis->OnPaint(wParam, lParam);
         case UM_TRAYICON:
             return pThis->OnTrayIcon(wParam, lParam);
         case WM_MOUSEWHEEL:
             return pThis->OnMouseWheel(wParam, lParam);
         case WM_MOUSEMOVE:
             return pThis->OnMouseMove(wParam, lParam);
+        case WM_INPUT:
+            // DefWindowProc() still has to see it
+            pThis->OnInput(wParam, lParam);
+            break;
         case WM_LBUTTONDOWN:
             return pThis->OnLeftButtonDown(wParam, lParam);
         case WM_LBUTTONUP:
@@ -447,6 +1160,10 @@ LRESULT CALLBACK Application::WndProc(
             return pThis->OnHotkey(wParam, lParam);
         case WM_COMMAND:
             return pThis->OnCommand(wParam, lParam);
+        case WM_DPICHANGED:
+            return pThis->OnDpiChanged(wParam, lParam);
+        case WM_DISPLAYCHANGE:
+            return pThis->OnDisplayChange(wParam, lParam);
         case WM_DESTROY:
             return pThis->OnDestroy(wParam, lParam);
     }
@@ -20,18 +20,20 @@
 #include <Windows.h>
 #include <d2d1.h>
 
-#include "sprite.h"
 #include "audio.h"
-#include "tweener.h"
-#include "timer.h"
-#include "pointer.h"
+#include "clock.h"
+#include "engine.h"
+#include "d2drendersink.h"
+#include "inputsession.h"
+#include "thread.h"
 #include "trayicon.h"
 
 class Application {
 public:
     Application();
 
-    HRESULT Initialize(HINSTANCE hInstance);
+    // Records the input into lpszTracePath when it is not NULL
+    HRESULT Initialize(HINSTANCE hInstance, LPCTSTR lpszTracePath);
 
     VOID RunMessageLoop();
 
@@ -44,22 +46,51 @@ private:
 
     VOID ToggleWindowVisibility();
 
-    ///////////////////////////////////////////////////////////////
+    // Draws the frames the engine publishes while the window is shown,
+    // so neither a slow present nor a burst of input holds up the other
+    HRESULT StartRenderThread();
+    VOID StopRenderThread();
+
+    static VOID RenderThreadProc(LPVOID pContext);
+
+    // Client center, in client and screen coordinates; only changes
+    // with the display
+    VOID UpdateWindowMetrics();
+
+    // Parks the hidden cursor on the center of the window
+    VOID LockCursor();
+
+    // Starts the input trace, once the sprite size is known
+    VOID StartTrace();
+
+    // Writes p50/p95/p99 of every latency histogram to a file in the
+    // temporary directory and opens it
+    VOID SaveLatencyReport();
 
-    VOID OnRender();
+#ifdef FP_TRACE
+    // Writes the trace buffers as trace_event JSON to the temporary
+    // directory, for Perfetto
+    VOID SaveTimeline();
+#endif
 
-    VOID OnUpdate(FLOAT fDelta);
+    HRESULT CreateAudio();
+
+    HRESULT CreateEngineResources();
 
     ///////////////////////////////////////////////////////////////
 
     LRESULT OnCreate(WPARAM wParam, LPARAM lParam);
 
+    LRESULT OnPaint(WPARAM wParam, LPARAM lParam);
+
     LRESULT OnTrayIcon(WPARAM wParam, LPARAM lParam);
 
     LRESULT OnMouseWheel(WPARAM wParam, LPARAM lParam);
 
     LRESULT OnMouseMove(WPARAM wParam, LPARAM lParam);
 
+    VOID OnInput(WPARAM wParam, LPARAM lParam);
+
     LRESULT OnLeftButtonDown(WPARAM wParam, LPARAM lParam);
 
     LRESULT OnLeftButtonUp(WPARAM wParam, LPARAM lParam);
@@ -68,6 +99,10 @@ private:
 
     LRESULT OnCommand(WPARAM wParam, LPARAM lParam);
 
+    LRESULT OnDpiChanged(WPARAM wParam, LPARAM lParam);
+
+    LRESULT OnDisplayChange(WPARAM wParam, LPARAM lParam);
+
     LRESULT OnDestroy(WPARAM wParam, LPARAM lParam);
 
     ///////////////////////////////////////////////////////////////
@@ -76,10 +111,23 @@ private:
     HINSTANCE               _hInstance;
     ID2D1HwndRenderTarget*  _pRenderTarget;
     ID2D1Factory*           _pFactory;    
-    Timer                   _timer;
-    Pointer                 _pointer;
+    D2DRenderSink*          _pSink;
+    Mixer*                  _pMixer;
+    AudioOutput*            _pAudioOutput;
+    SystemClock             _clock;
+    Engine                  _engine;
+    InputSession            _input;
     TrayIcon                _trayIcon;
+    Thread*                 _pRenderThread;
+    ThreadEvent*            _pFrameEvent;   // Wakes the render thread
+    volatile LONG           _lRendering;
+    POINT                   _ptCenter;
+    POINT                   _ptScreenCenter;
+    Geometry::Point         _absolute;      // Last absolute raw position
+    BOOL                    _bAbsoluteValid;
+    BOOL                    _bRawInput;
     BOOL                    _bShow;
+    TCHAR                   _szTracePath[MAX_PATH];
 };
 
 #endif // __APPLICATION_H
\ No newline at end of file
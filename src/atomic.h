@@ -0,0 +1,112 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ATOMIC_H
+#define __ATOMIC_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// The memory orderings the lock-free code needs. A value stored with
+// AtomicStoreRelease makes every write before it visible to the thread
+// that reads it with AtomicLoadAcquire. AtomicExchange does both at once:
+// it publishes what this thread wrote and picks up what the other one
+// did before it stored the old value. AtomicCompareExchange is the same,
+// but only stores when the old value is the expected one; it returns the
+// old value either way. AtomicIncrement only counts; it orders nothing
+// around it. AtomicFence keeps every read and write on its side, for
+// readers that have to check nothing moved under them.
+////////////////////////////////////////////////////////////////////////////
+
+#if defined(_MSC_VER)
+
+#include <intrin.h>
+
+inline LONG AtomicLoadAcquire(CONST volatile LONG* plValue)
+{
+    return InterlockedCompareExchange((volatile LONG*) plValue, 0, 0);
+}
+
+inline VOID AtomicStoreRelease(volatile LONG* plValue, LONG lValue)
+{
+    InterlockedExchange(plValue, lValue);
+}
+
+inline LONG AtomicExchange(volatile LONG* plValue, LONG lValue)
+{
+    return InterlockedExchange(plValue, lValue);
+}
+
+inline LONG AtomicCompareExchange(
+    volatile LONG*  plValue,
+    LONG            lExpected,
+    LONG            lValue)
+{
+    return InterlockedCompareExchange(plValue, lValue, lExpected);
+}
+
+inline LONG AtomicIncrement(volatile LONG* plValue)
+{
+    return InterlockedIncrement(plValue);
+}
+
+inline VOID AtomicFence()
+{
+    MemoryBarrier();
+}
+
+#else // _MSC_VER
+
+inline LONG AtomicLoadAcquire(CONST volatile LONG* plValue)
+{
+    return __atomic_load_n(plValue, __ATOMIC_ACQUIRE);
+}
+
+inline VOID AtomicStoreRelease(volatile LONG* plValue, LONG lValue)
+{
+    __atomic_store_n(plValue, lValue, __ATOMIC_RELEASE);
+}
+
+inline LONG AtomicExchange(volatile LONG* plValue, LONG lValue)
+{
+    return __atomic_exchange_n(plValue, lValue, __ATOMIC_ACQ_REL);
+}
+
+inline LONG AtomicCompareExchange(
+    volatile LONG*  plValue,
+    LONG            lExpected,
+    LONG            lValue)
+{
+    __atomic_compare_exchange_n(
+        plValue, &lExpected, lValue, false,
+        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+
+    return lExpected;
+}
+
+inline LONG AtomicIncrement(volatile LONG* plValue)
+{
+    return __atomic_add_fetch(plValue, 1, __ATOMIC_RELAXED);
+}
+
+inline VOID AtomicFence()
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+#endif // _MSC_VER
+
+#endif // __ATOMIC_H
@@ -16,286 +16,429 @@
 
 #include "audio.h"
 
-#include <Shlwapi.h>
+#include <mmreg.h>
+#include <avrt.h>
 
 #include "safemem.h"
+#include "trace.h"
 #include "resource.h"
 
-#if __MINGW32__
+// Data1 of KSDATAFORMAT_SUBTYPE_PCM and KSDATAFORMAT_SUBTYPE_IEEE_FLOAT,
+// the rest of the GUIDs is the same
+#define SUBTYPE_PCM_DATA1           0x00000001
+#define SUBTYPE_IEEE_FLOAT_DATA1    0x00000003
 
 ////////////////////////////////////////////////////////////////////////////
-// MFCreateMFByteStreamOnStream
-//
-// HACK: For reasons unknown to me, the mfidl.h header in MinGW lacks
-// a definition for the MFCreateMFByteStreamOnStream function.
+// AudioOutput
 ////////////////////////////////////////////////////////////////////////////
 
-typedef HRESULT (*MFCreateMFByteStreamOnStream_t)(IStream*, IMFByteStream**);
+AudioOutput::AudioOutput()
+    : _pDevice(NULL),
+      _pClient(NULL),
+      _pRenderClient(NULL),
+      _pFormat(NULL),
+      _bFloat(FALSE),
+      _cBufferFrames(0),
+      _pfMix(NULL),
+      _pMixer(NULL),
+      _hEvent(NULL),
+      _hStopEvent(NULL),
+      _hThread(NULL)
+{
+}
 
-static HRESULT
-MFCreateMFByteStreamOnStream(IStream* pStream, IMFByteStream** ppByteStream)
+AudioOutput::~AudioOutput()
 {
-    HMODULE hModule = LoadLibraryA("mfplat.dll");
-    FARPROC fpProc;
+    Stop();
 
-    if (hModule == NULL) {
-        return E_FAIL;
-    }
-    
-    fpProc = GetProcAddress(hModule, "MFCreateMFByteStreamOnStream");
+    SafeRelease(&_pRenderClient);
+    SafeRelease(&_pClient);
+    SafeRelease(&_pDevice);
 
-    if (fpProc == NULL) {
-        return E_FAIL;
+    if (_pFormat != NULL) {
+        CoTaskMemFree(_pFormat);
     }
 
-    return ((MFCreateMFByteStreamOnStream_t) fpProc)(pStream, ppByteStream);
-}
+    if (_hEvent != NULL) {
+        CloseHandle(_hEvent);
+    }
 
-#endif // __MINGW32__
+    if (_hStopEvent != NULL) {
+        CloseHandle(_hStopEvent);
+    }
 
-////////////////////////////////////////////////////////////////////////////
-// AudioCallback
-////////////////////////////////////////////////////////////////////////////
+    delete[] _pfMix;
+}
 
-AudioCallback::AudioCallback(Audio* pAudio)
-    : _pAudio(pAudio),
-      _lRefCount(1)
+UINT AudioOutput::GetSampleRate() CONST
 {
+    return _pFormat->nSamplesPerSec;
 }
 
-STDMETHODIMP AudioCallback::QueryInterface(REFIID riid, VOID** ppV)
+HRESULT AudioOutput::Start(Mixer* pMixer)
 {
-    static CONST QITAB qit[] = {
-        QITABENT(AudioCallback, IMFPMediaPlayerCallback),
-        { 0 },
-    };
+    HRESULT hResult;
 
-    return QISearch(this, qit, riid, ppV);
-}
+    if (pMixer == NULL || pMixer->GetSampleRate() != GetSampleRate()) {
+        return E_INVALIDARG;
+    }
 
-STDMETHODIMP_(ULONG) AudioCallback::AddRef()
-{
-    return InterlockedIncrement(&_lRefCount);
-}
+    if (_hThread != NULL) {
+        return E_UNEXPECTED;
+    }
 
-STDMETHODIMP_(ULONG) AudioCallback::Release()
-{
-    ULONG ulCount = InterlockedDecrement(&_lRefCount);
+    _pMixer = pMixer;
 
-    if (ulCount == 0) {
-        delete this;
-        return 0;
+    // Fill the whole buffer up front, otherwise the first period
+    // plays whatever the device had in it
+    hResult = FillBuffer();
+
+    if (FAILED(hResult)) {
+        return hResult;
     }
 
-    return ulCount;
+    ResetEvent(_hStopEvent);
+
+    _hThread = CreateThread(NULL, 0, ThreadProc, this, 0, NULL);
+
+    if (_hThread == NULL) {
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    hResult = _pClient->Start();
+
+    if (FAILED(hResult)) {
+        Stop();
+    }
+
+    return hResult;
 }
 
-STDMETHODIMP_(VOID)
-AudioCallback::OnMediaPlayerEvent(MFP_EVENT_HEADER* pEventHeader)
+VOID AudioOutput::Stop()
 {
-    if (pEventHeader == NULL) {
+    if (_hThread == NULL) {
         return;
     }
-    
-    switch (pEventHeader->eEventType) {
-        case MFP_EVENT_TYPE_PLAYBACK_ENDED: {
-            if (_pAudio->_bLoop == TRUE) {
-                _pAudio->Play();
-            }
-            break;
-        }
 
-        case MFP_EVENT_TYPE_STOP: {
-            _pAudio->_bPlaying = FALSE;
+    SetEvent(_hStopEvent);
+    WaitForSingleObject(_hThread, INFINITE);
+
+    CloseHandle(_hThread);
+    _hThread = NULL;
+
+    _pClient->Stop();
+    _pClient->Reset();
+}
+
+DWORD WINAPI AudioOutput::ThreadProc(LPVOID lpParameter)
+{
+    ((AudioOutput*) lpParameter)->RenderLoop();
+    return 0;
+}
+
+VOID AudioOutput::RenderLoop()
+{
+    HANDLE  handles[2] = { _hStopEvent, _hEvent };
+    HANDLE  hTask = NULL;
+    DWORD   dwTaskIndex = 0;
+    DWORD   dwWait;
+
+    FP_TRACE_THREAD("audio");
+
+    // Lets MMCSS schedule the thread ahead of ordinary work
+    hTask = AvSetMmThreadCharacteristics(TEXT("Pro Audio"), &dwTaskIndex);
+
+    for (;;) {
+        dwWait = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+
+        if (dwWait != WAIT_OBJECT_0 + 1) {
             break;
         }
 
-        case MFP_EVENT_TYPE_PLAY: {
-            _pAudio->_bPlaying = TRUE;
+        // The device went away; stay silent instead of spinning
+        if (FAILED(FillBuffer())) {
             break;
         }
     }
-}
 
-////////////////////////////////////////////////////////////////////////////
-// Audio
-////////////////////////////////////////////////////////////////////////////
+    if (hTask != NULL) {
+        AvRevertMmThreadCharacteristics(hTask);
+    }
 
-Audio::Audio()
-    : _pPlayer(NULL),
-      _bLoop(FALSE),
-      _bPlaying(FALSE)
-{
+    FP_TRACE_END_THREAD();
 }
 
-Audio::~Audio()
+HRESULT AudioOutput::FillBuffer()
 {
-    if (_pPlayer == NULL) {
-        return;
+    UINT32  cPadding = 0, cFrames, uFrame;
+    WORD    cChannels = _pFormat->nChannels;
+    WORD    uChannel;
+    BYTE*   pbBuffer = NULL;
+    FLOAT   fSample;
+    HRESULT hResult;
+
+    hResult = _pClient->GetCurrentPadding(&cPadding);
+
+    if (FAILED(hResult)) {
+        return hResult;
     }
 
-    _pPlayer->Shutdown();
-    SafeRelease(&_pPlayer);
-}
+    cFrames = _cBufferFrames - cPadding;
 
-VOID Audio::Play()
-{
-    if (_pPlayer == NULL) {
-        return;
+    if (cFrames == 0) {
+        return S_OK;
     }
 
-    _pPlayer->Play();
-}
+    hResult = _pRenderClient->GetBuffer(cFrames, &pbBuffer);
 
-VOID Audio::Stop()
-{
-    if (_pPlayer == NULL) {
-        return;
+    if (FAILED(hResult)) {
+        return hResult;
     }
 
-    _pPlayer->Stop();
-}
+    _pMixer->Render(_pfMix, cFrames);
+
+    // Stereo goes to the first two speakers, the rest stay silent
+    for (uFrame = 0; uFrame < cFrames; uFrame++) {
+        for (uChannel = 0; uChannel < cChannels; uChannel++) {
+            if (cChannels == 1) {
+                fSample = (_pfMix[uFrame * 2] + _pfMix[uFrame * 2 + 1]) * 0.5f;
+            } else if (uChannel < MIXER_CHANNELS) {
+                fSample = _pfMix[uFrame * 2 + uChannel];
+            } else {
+                fSample = 0.0f;
+            }
 
-VOID Audio::SetLoop(BOOL bLoop)
-{
-    _bLoop = bLoop;
-}
+            if (fSample > 1.0f) {
+                fSample = 1.0f;
+            } else if (fSample < -1.0f) {
+                fSample = -1.0f;
+            }
 
-BOOL Audio::GetLoop() CONST
-{
-    return _bLoop;
-}
+            if (_bFloat == TRUE) {
+                ((FLOAT*) pbBuffer)[uFrame * cChannels + uChannel] = fSample;
+            } else {
+                ((SHORT*) pbBuffer)[uFrame * cChannels + uChannel] =
+                    (SHORT) (fSample * 32767.0f);
+            }
+        }
+    }
 
-BOOL Audio::IsPlaying() CONST
-{
-    return _bPlaying;
+    return _pRenderClient->ReleaseBuffer(cFrames, 0);
 }
 
-HRESULT Audio::InitializePlayer()
+////////////////////////////////////////////////////////////////////////////
+
+HRESULT AudioOutput::CreateAudioOutput(AudioOutput** ppOutput)
 {
-    AudioCallback*  pCallback = new AudioCallback(this);
-    HRESULT         hResult = S_OK;
+    AudioOutput*            pOutput = NULL;
+    IMMDeviceEnumerator*    pEnumerator = NULL;
+    WAVEFORMATEXTENSIBLE*   pExtensible = NULL;
+    DWORD                   dwSubtype;
+    HRESULT                 hResult = S_OK;
+
+    if (ppOutput == NULL) {
+        return E_INVALIDARG;
+    }
 
-    if (pCallback == NULL) {
+    pOutput = new AudioOutput();
+
+    if (pOutput == NULL) {
         return E_OUTOFMEMORY;
     }
 
-    hResult = MFPCreateMediaPlayer(
+    hResult = CoCreateInstance(
+        __uuidof(MMDeviceEnumerator),
         NULL,
-        FALSE,
-        0,
-        pCallback,
+        CLSCTX_ALL,
+        __uuidof(IMMDeviceEnumerator),
+        (VOID**) &pEnumerator);
+
+    if (FAILED(hResult)) {
+        goto cleanup;
+    }
+
+    hResult = pEnumerator->GetDefaultAudioEndpoint(
+        eRender,
+        eConsole,
+        &(pOutput->_pDevice));
+
+    if (FAILED(hResult)) {
+        goto cleanup;
+    }
+
+    hResult = pOutput->_pDevice->Activate(
+        __uuidof(IAudioClient),
+        CLSCTX_ALL,
         NULL,
-        &_pPlayer);
+        (VOID**) &(pOutput->_pClient));
 
     if (FAILED(hResult)) {
-        SafeRelease(&pCallback);
+        goto cleanup;
     }
 
-    return hResult;
-}
+    hResult = pOutput->_pClient->GetMixFormat(&(pOutput->_pFormat));
 
-////////////////////////////////////////////////////////////////////////////
+    if (FAILED(hResult)) {
+        goto cleanup;
+    }
 
-HRESULT Audio::CreateAudioFromSourceObject(
-    IUnknown*   pSourceUnk,
-    Audio**     ppAudio)
-{
-    Audio*          pAudio = NULL;
-    IMFPMediaItem*  pMediaItem = NULL;
-    HRESULT         hResult = S_OK;
+    // Shared mode is almost always 32-bit float; accept 16-bit PCM too
+    switch (pOutput->_pFormat->wFormatTag) {
+        case WAVE_FORMAT_EXTENSIBLE:
+            pExtensible = (WAVEFORMATEXTENSIBLE*) pOutput->_pFormat;
+            dwSubtype = pExtensible->SubFormat.Data1;
+            break;
+        case WAVE_FORMAT_IEEE_FLOAT:
+            dwSubtype = SUBTYPE_IEEE_FLOAT_DATA1;
+            break;
+        default:
+            dwSubtype = pOutput->_pFormat->wFormatTag;
+            break;
+    }
 
-    if (pSourceUnk == NULL || ppAudio == NULL) {
-        return E_INVALIDARG;
+    if (dwSubtype == SUBTYPE_IEEE_FLOAT_DATA1 &&
+        pOutput->_pFormat->wBitsPerSample == 32)
+    {
+        pOutput->_bFloat = TRUE;
+    } else if (dwSubtype != SUBTYPE_PCM_DATA1 ||
+               pOutput->_pFormat->wBitsPerSample != 16)
+    {
+        hResult = E_NOTIMPL;
+        goto cleanup;
     }
 
-    pAudio = new Audio();
+    // Zero buffer duration asks for the smallest buffer event driven
+    // shared mode allows, about two device periods
+    hResult = pOutput->_pClient->Initialize(
+        AUDCLNT_SHAREMODE_SHARED,
+        AUDCLNT_STREAMFLAGS_EVENTCALLBACK,
+        0,
+        0,
+        pOutput->_pFormat,
+        NULL);
 
-    if (pAudio == NULL) {
-        return E_OUTOFMEMORY;
+    if (FAILED(hResult)) {
+        goto cleanup;
     }
 
-    hResult = pAudio->InitializePlayer();
+    hResult = pOutput->_pClient->GetBufferSize(&(pOutput->_cBufferFrames));
 
     if (FAILED(hResult)) {
         goto cleanup;
     }
 
-    hResult = pAudio->_pPlayer->CreateMediaItemFromObject(
-        pSourceUnk,
-        TRUE,
-        0,
-        &pMediaItem);
-    
+    pOutput->_pfMix = new FLOAT[pOutput->_cBufferFrames * MIXER_CHANNELS];
+    pOutput->_hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    pOutput->_hStopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+    if (pOutput->_pfMix == NULL ||
+        pOutput->_hEvent == NULL ||
+        pOutput->_hStopEvent == NULL)
+    {
+        hResult = E_OUTOFMEMORY;
+        goto cleanup;
+    }
+
+    hResult = pOutput->_pClient->SetEventHandle(pOutput->_hEvent);
+
     if (FAILED(hResult)) {
         goto cleanup;
     }
-    
-    hResult = pAudio->_pPlayer->SetMediaItem(pMediaItem);
+
+    hResult = pOutput->_pClient->GetService(
+        __uuidof(IAudioRenderClient),
+        (VOID**) &(pOutput->_pRenderClient));
 
 cleanup:
-    SafeRelease(&pMediaItem);
+    SafeRelease(&pEnumerator);
 
     if (SUCCEEDED(hResult)) {
-        *ppAudio = pAudio;
-    } else if (pAudio != NULL) {
-        delete pAudio;
+        *ppOutput = pOutput;
+    } else {
+        delete pOutput;
     }
 
     return hResult;
 }
 
-HRESULT Audio::CreateAudioFromResource(
-    HINSTANCE   hInstance,
-    LPCTSTR     lpszName,
-    LPCTSTR     lpszType,
-    Audio**     ppAudio)
+////////////////////////////////////////////////////////////////////////////
+
+HRESULT CreateSoundFromResource(
+    Mixer*          pMixer,
+    HINSTANCE       hInstance,
+    LPCTSTR         lpszName,
+    LPCTSTR         lpszType,
+    UINT            cVoices,
+    VOICESTEAL      steal,
+    MixerSound**    ppSound)
 {
-    IStream*            pIStream = NULL;
-    IMFSourceResolver*  pResolver = NULL;
-    IMFByteStream*      pByteStream = NULL;
-    IUnknown*           pSourceUnk = NULL;
-    MF_OBJECT_TYPE      objectType = MF_OBJECT_INVALID;
-    HRESULT             hResult = S_OK;
-
-    pIStream = CreateIStreamFromResource(hInstance, lpszName, lpszType);
-    
-    if (pIStream == NULL) {
+    AudioClip*  pClip = NULL;
+    BYTE*       pbResourceData = NULL;
+    DWORD       dwResourceSize = 0;
+    HRESULT     hResult;
+
+    if (pMixer == NULL || ppSound == NULL) {
+        return E_INVALIDARG;
+    }
+
+    pbResourceData = (BYTE*) LoadResourceToMemory(
+        hInstance,
+        lpszName,
+        lpszType,
+        &dwResourceSize);
+
+    if (pbResourceData == NULL) {
         return E_INVALIDARG;
     }
 
-    hResult = MFCreateMFByteStreamOnStream(pIStream, &pByteStream);
+    hResult = AudioClip::CreateAudioClipFromWav(
+        pbResourceData,
+        dwResourceSize,
+        pMixer->GetSampleRate(),
+        pMixer->GetSamplePool(),
+        &pClip);
 
     if (FAILED(hResult)) {
-        goto cleanup;
+        return hResult;
     }
 
-    hResult = MFCreateSourceResolver(&pResolver);
+    hResult = pMixer->CreateSound(pClip, cVoices, steal, ppSound);
 
     if (FAILED(hResult)) {
-        goto cleanup;
+        delete pClip;
     }
 
-    hResult = pResolver->CreateObjectFromByteStream(
-        pByteStream,
-        NULL,
-        MF_RESOLUTION_MEDIASOURCE |
-        MF_RESOLUTION_CONTENT_DOES_NOT_HAVE_TO_MATCH_EXTENSION_OR_MIME_TYPE,
-        NULL,
-        &objectType,
-        &pSourceUnk);
-    
+    return hResult;
+}
+
+HRESULT CreateSoundFromFile(
+    Mixer*          pMixer,
+    LPCTSTR         lpszPath,
+    UINT            cVoices,
+    VOICESTEAL      steal,
+    MixerSound**    ppSound)
+{
+    AudioStream*    pStream = NULL;
+    HRESULT         hResult;
+
+    if (pMixer == NULL || lpszPath == NULL || ppSound == NULL) {
+        return E_INVALIDARG;
+    }
+
+    hResult = AudioStream::CreateAudioStreamFromFile(
+        lpszPath,
+        cVoices,
+        &pStream);
+
     if (FAILED(hResult)) {
-        goto cleanup;
+        return hResult;
     }
 
-    hResult = CreateAudioFromSourceObject(pSourceUnk, ppAudio);
+    hResult = pMixer->CreateStreamSound(pStream, steal, ppSound);
 
-cleanup:
-    SafeRelease(&pResolver);
-    SafeRelease(&pSourceUnk);
-    SafeRelease(&pByteStream);
-    SafeRelease(&pIStream);
+    if (FAILED(hResult)) {
+        delete pStream;
+    }
 
     return hResult;
-}
\ No newline at end of file
+}
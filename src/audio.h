@@ -18,63 +18,72 @@
 #define __AUDIO_H
 
 #include <Windows.h>
-#include <mfplay.h>
+#include <mmdeviceapi.h>
+#include <audioclient.h>
 
-class Audio;
+#include "mixer.h"
 
-class AudioCallback : public IMFPMediaPlayerCallback
-{
-public:
-    AudioCallback(Audio* pAudio);
-
-    STDMETHODIMP QueryInterface(REFIID riid, VOID** ppV);
-
-    STDMETHODIMP_(ULONG) AddRef();
-
-    STDMETHODIMP_(ULONG) Release();
-
-    STDMETHODIMP_(VOID)
-    OnMediaPlayerEvent(MFP_EVENT_HEADER* pEventHeader);
-
-private:
-    LONG            _lRefCount;
-    Audio*          _pAudio; 
-};
-
-class Audio
-{
-    friend class AudioCallback;
+////////////////////////////////////////////////////////////////////////////
+// AudioOutput
+//
+// Shared mode, event driven WASAPI stream on the default render device.
+// A thread of its own wakes up once per device period and fills the
+// buffer from the Mixer, converting to whatever the device mixes in.
+////////////////////////////////////////////////////////////////////////////
 
+class AudioOutput {
 public:
-    static HRESULT CreateAudioFromSourceObject(
-        IUnknown*   pSourceUnk,
-        Audio**     ppAudio);
+    static HRESULT CreateAudioOutput(AudioOutput** ppOutput);
 
-    static HRESULT CreateAudioFromResource(
-        HINSTANCE   hInstance,
-        LPCTSTR     lpszName,
-        LPCTSTR     lpszType,
-        Audio**     ppAudio);
-        
-    ~Audio();
+    ~AudioOutput();
 
-    VOID Play();
+    // Rate of the device mix format; create the Mixer with it
+    UINT GetSampleRate() CONST;
 
+    // The mixer has to outlive Stop()
+    HRESULT Start(Mixer* pMixer);
     VOID Stop();
 
-    VOID SetLoop(BOOL bLoop);
-    BOOL GetLoop() CONST;
-
-    BOOL IsPlaying() CONST;
-
 private:
-    Audio();
-
-    HRESULT InitializePlayer();
-
-    IMFPMediaPlayer*    _pPlayer;
-    BOOL                _bLoop;
-    BOOL                _bPlaying;
+    AudioOutput();
+
+    static DWORD WINAPI ThreadProc(LPVOID lpParameter);
+
+    VOID RenderLoop();
+    HRESULT FillBuffer();
+
+    IMMDevice*          _pDevice;
+    IAudioClient*       _pClient;
+    IAudioRenderClient* _pRenderClient;
+    WAVEFORMATEX*       _pFormat;
+    BOOL                _bFloat;
+    UINT32              _cBufferFrames;
+    FLOAT*              _pfMix;
+    Mixer*              _pMixer;
+    HANDLE              _hEvent;
+    HANDLE              _hStopEvent;
+    HANDLE              _hThread;
 };
 
-#endif // __AUDIO_H
\ No newline at end of file
+// Plays the WAVE resource in place when it already matches the mixer,
+// otherwise converts it once into the mixer's SamplePool. See
+// Mixer::CreateSound() for cVoices and steal.
+HRESULT CreateSoundFromResource(
+    Mixer*          pMixer,
+    HINSTANCE       hInstance,
+    LPCTSTR         lpszName,
+    LPCTSTR         lpszType,
+    UINT            cVoices,
+    VOICESTEAL      steal,
+    MixerSound**    ppSound);
+
+// Streams a FLAC file, mapped rather than read; see AudioStream and
+// Mixer::CreateStreamSound()
+HRESULT CreateSoundFromFile(
+    Mixer*          pMixer,
+    LPCTSTR         lpszPath,
+    UINT            cVoices,
+    VOICESTEAL      steal,
+    MixerSound**    ppSound);
+
+#endif // __AUDIO_H
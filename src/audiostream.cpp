@@ -0,0 +1,732 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "audiostream.h"
+
+#include <string.h>
+
+#include "atomic.h"
+#include "safemem.h"
+#include "trace.h"
+
+#define STREAM_END      (~0ULL)
+
+AudioStream::AudioStream()
+    : _pbData(NULL),
+      _cbData(0),
+      _pFile(NULL),
+      _pVoices(NULL),
+      _cVoices(0),
+      _piScratch(NULL),
+      _cbDecoded(0),
+      _bResident(FALSE),
+      _bLoop(FALSE),
+      _pThread(NULL),
+      _pWake(NULL),
+      _lStop(0),
+      _lLoop(0),
+      _lFramesDecoded(0),
+      _lDecodeMicroseconds(0),
+      _lUnderruns(0),
+      _llDecodeTicks(0),
+      _cFramesDecoded(0),
+      _cUnderruns(0)
+{
+    memset(&_info, 0, sizeof(_info));
+    memset(&_prime, 0, sizeof(_prime));
+    memset(&_afterPrime, 0, sizeof(_afterPrime));
+}
+
+AudioStream::~AudioStream()
+{
+    UINT i;
+
+    AtomicStoreRelease(&_lStop, 1);
+
+    if (_pWake != NULL) {
+        _pWake->Set();
+    }
+
+    SafeDelete(&_pThread);
+    SafeDelete(&_pWake);
+
+    if (_pVoices != NULL) {
+        for (i = 0; i < _cVoices; i++) {
+            delete[] _pVoices[i].psBlock;
+            delete[] _pVoices[i].buffers[0].psSamples;
+            delete[] _pVoices[i].buffers[1].psSamples;
+        }
+
+        delete[] _pVoices;
+    }
+
+    delete[] _prime.psSamples;
+    delete[] _piScratch;
+
+    SafeDelete(&_pFile);
+}
+
+UINT AudioStream::GetSampleRate() CONST
+{
+    return _info.uSampleRate;
+}
+
+UINT AudioStream::GetChannels() CONST
+{
+    return _info.cChannels;
+}
+
+UINT AudioStream::GetVoiceCount() CONST
+{
+    return _cVoices;
+}
+
+BOOL AudioStream::IsResident() CONST
+{
+    return _bResident;
+}
+
+VOID AudioStream::GetStats(AUDIOSTREAMSTATS* pStats) CONST
+{
+    if (pStats == NULL) {
+        return;
+    }
+
+    pStats->cFramesDecoded = (ULONG) AtomicLoadAcquire(&_lFramesDecoded);
+    pStats->ulDecodeMicroseconds =
+        (ULONG) AtomicLoadAcquire(&_lDecodeMicroseconds);
+    pStats->cUnderruns = (ULONG) AtomicLoadAcquire(&_lUnderruns);
+    pStats->cbDecoded = _cbDecoded;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Decoder thread
+//
+// Prime() runs the same code on the creating thread, before the decoder
+// thread exists.
+////////////////////////////////////////////////////////////////////////////
+
+// A damaged frame ends the stream like the real end does
+BOOL AudioStream::DecodeBlock(STREAMVOICE* pVoice)
+{
+    HRESULT hResult;
+
+    FP_TRACE_SCOPE("AudioStream::DecodeBlock");
+
+    pVoice->cbBlock = pVoice->cbOffset;
+    pVoice->uBlockFrame = 0;
+
+    hResult = DecodeFlacFrame(
+        _pbData,
+        _cbData,
+        _info,
+        &pVoice->cbOffset,
+        _piScratch,
+        pVoice->psBlock,
+        &pVoice->cBlockFrames);
+
+    if (hResult != S_OK) {
+        pVoice->cbOffset = _cbData;
+        pVoice->cBlockFrames = 0;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+// Returns fewer than cFrames only at the end of a stream that does not
+// loop
+UINT AudioStream::PullFrames(
+    STREAMVOICE*    pVoice,
+    SHORT*          psOutput,
+    UINT            cFrames)
+{
+    UINT    cChannels = _info.cChannels;
+    UINT    cPulled = 0, cRun;
+    BOOL    bWrapped = FALSE;
+
+    while (cPulled < cFrames) {
+        if (pVoice->uBlockFrame >= pVoice->cBlockFrames) {
+            if (DecodeBlock(pVoice) == FALSE) {
+                // Wrapping twice in a row means nothing decodes at all
+                if (AtomicLoadAcquire(&_lLoop) == 0 || bWrapped == TRUE) {
+                    break;
+                }
+
+                pVoice->cbOffset = _info.cbFirstFrame;
+                bWrapped = TRUE;
+                continue;
+            }
+
+            bWrapped = FALSE;
+        }
+
+        cRun = pVoice->cBlockFrames - pVoice->uBlockFrame;
+
+        if (cRun > cFrames - cPulled) {
+            cRun = cFrames - cPulled;
+        }
+
+        memcpy(psOutput + (SIZE_T) cPulled * cChannels,
+               pVoice->psBlock + (SIZE_T) pVoice->uBlockFrame * cChannels,
+               (SIZE_T) cRun * cChannels * sizeof(SHORT));
+
+        pVoice->uBlockFrame += cRun;
+        cPulled += cRun;
+    }
+
+    return cPulled;
+}
+
+// Back to right after the prime, which the audio thread plays first
+VOID AudioStream::Rewind(STREAMVOICE* pVoice)
+{
+    UINT cChannels = _info.cChannels;
+
+    pVoice->cbOffset = _afterPrime.cbBlock;
+
+    DecodeBlock(pVoice);
+    pVoice->uBlockFrame = _afterPrime.uBlockFrame;
+
+    memcpy(pVoice->carry,
+           _prime.psSamples + (SIZE_T) STREAM_PRIME_FRAMES * cChannels,
+           3 * cChannels * sizeof(SHORT));
+
+    pVoice->ullBufferStart = STREAM_PRIME_FRAMES;
+    pVoice->ullEnd = STREAM_END;
+    pVoice->bDone = FALSE;
+}
+
+// Returns FALSE when there was nothing to do
+BOOL AudioStream::FillBuffer(STREAMVOICE* pVoice)
+{
+    STREAMBUFFER*   pBuffer;
+    UINT            cChannels = _info.cChannels;
+    UINT            uGeneration, cPulled = 0, cFrames;
+    LONGLONG        llStart;
+    SHORT*          psRows;
+
+    uGeneration = (UINT) AtomicLoadAcquire(&pVoice->lGeneration);
+
+    if (uGeneration != pVoice->uDecodeGeneration) {
+        Rewind(pVoice);
+        pVoice->uDecodeGeneration = uGeneration;
+    }
+
+    if (pVoice->bDone == TRUE || pVoice->free.Pop(&pBuffer) == FALSE) {
+        return FALSE;
+    }
+
+    llStart = _clock.GetTicks();
+    psRows = pBuffer->psSamples;
+
+    // Rows: the frame before, STREAM_BUFFER_FRAMES, two after. The
+    // first three rows are the last three of the buffer before.
+    memcpy(psRows, pVoice->carry, 3 * cChannels * sizeof(SHORT));
+
+    if (pVoice->ullEnd == STREAM_END) {
+        cPulled = PullFrames(
+            pVoice,
+            psRows + 3 * cChannels,
+            STREAM_BUFFER_FRAMES);
+
+        if (cPulled < STREAM_BUFFER_FRAMES) {
+            pVoice->ullEnd = pVoice->ullBufferStart + 2 + cPulled;
+        }
+    }
+
+    memset(psRows + (SIZE_T) (3 + cPulled) * cChannels, 0,
+           (SIZE_T) (STREAM_BUFFER_FRAMES - cPulled) * cChannels *
+           sizeof(SHORT));
+
+    cFrames = STREAM_BUFFER_FRAMES;
+    pBuffer->bEnd = FALSE;
+
+    if (pVoice->ullEnd != STREAM_END &&
+        pVoice->ullEnd - pVoice->ullBufferStart <= STREAM_BUFFER_FRAMES)
+    {
+        cFrames = (UINT) (pVoice->ullEnd - pVoice->ullBufferStart);
+        pBuffer->bEnd = TRUE;
+        pVoice->bDone = TRUE;
+    }
+
+    pBuffer->cFrames = cFrames;
+    pBuffer->uGeneration = uGeneration;
+
+    memcpy(pVoice->carry,
+           psRows + (SIZE_T) STREAM_BUFFER_FRAMES * cChannels,
+           3 * cChannels * sizeof(SHORT));
+
+    pVoice->ullBufferStart += STREAM_BUFFER_FRAMES;
+
+    // Never full, there are only two buffers
+    pVoice->filled.Push(pBuffer);
+
+    _cFramesDecoded += cPulled;
+    _llDecodeTicks += _clock.GetTicks() - llStart;
+
+    AtomicStoreRelease(&_lFramesDecoded, (LONG) _cFramesDecoded);
+    AtomicStoreRelease(
+        &_lDecodeMicroseconds,
+        (LONG) (ULONG) (_llDecodeTicks * 1000000 / _clock.GetFrequency()));
+
+    return TRUE;
+}
+
+VOID AudioStream::DecodeThreadProc(LPVOID pContext)
+{
+    AudioStream*    pStream = (AudioStream*) pContext;
+    BOOL            bBusy;
+    UINT            i;
+
+    FP_TRACE_THREAD("decode");
+
+    while (AtomicLoadAcquire(&pStream->_lStop) == 0) {
+        bBusy = FALSE;
+
+        for (i = 0; i < pStream->_cVoices; i++) {
+            if (pStream->FillBuffer(&pStream->_pVoices[i]) == TRUE) {
+                bBusy = TRUE;
+            }
+        }
+
+        // A buffer handed back since the loop looked still left the
+        // event set, so this cannot miss it
+        if (bBusy == FALSE) {
+            pStream->_pWake->Wait(INFINITE);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Audio thread
+////////////////////////////////////////////////////////////////////////////
+
+VOID AudioStream::ReleaseBuffer(STREAMVOICE* pVoice, STREAMBUFFER* pBuffer)
+{
+    if (pBuffer != &_prime) {
+        pVoice->free.Push(pBuffer);
+        _pWake->Set();
+    }
+}
+
+// Buffers decoded for an earlier start go straight back
+BOOL AudioStream::AcquireBuffer(
+    STREAMVOICE*    pVoice,
+    STREAMBUFFER**  ppBuffer)
+{
+    STREAMBUFFER* pBuffer;
+
+    while (pVoice->filled.Pop(&pBuffer) == TRUE) {
+        if (pBuffer->uGeneration == pVoice->uGeneration) {
+            *ppBuffer = pBuffer;
+            return TRUE;
+        }
+
+        pVoice->free.Push(pBuffer);
+        _pWake->Set();
+    }
+
+    return FALSE;
+}
+
+VOID AudioStream::StartVoice(UINT uVoice)
+{
+    STREAMVOICE*    pVoice = &_pVoices[uVoice];
+    STREAMBUFFER*   pBuffer;
+
+    if (pVoice->main.pBuffer != NULL) {
+        ReleaseBuffer(pVoice, pVoice->main.pBuffer);
+    }
+
+    pVoice->main.pBuffer = &_prime;
+    pVoice->main.ullPosition = _bResident ? 0 : RESAMPLE_ONE;
+
+    // Unless the voice only ever played the prime since the decoder
+    // last started over, it has to start over again
+    if (_bResident == TRUE || pVoice->bRewound == TRUE) {
+        return;
+    }
+
+    pVoice->uGeneration++;
+    pVoice->bRewound = TRUE;
+
+    AtomicStoreRelease(&pVoice->lGeneration, (LONG) pVoice->uGeneration);
+
+    while (pVoice->filled.Pop(&pBuffer) == TRUE) {
+        pVoice->free.Push(pBuffer);
+    }
+
+    _pWake->Set();
+}
+
+// The fade playhead finishes whatever buffer the voice was on
+VOID AudioStream::FadeVoice(UINT uVoice)
+{
+    STREAMVOICE* pVoice = &_pVoices[uVoice];
+
+    EndFade(uVoice);
+
+    pVoice->fade = pVoice->main;
+    pVoice->main.pBuffer = NULL;
+    pVoice->main.ullPosition = 0;
+}
+
+VOID AudioStream::EndFade(UINT uVoice)
+{
+    STREAMVOICE* pVoice = &_pVoices[uVoice];
+
+    if (pVoice->fade.pBuffer != NULL) {
+        ReleaseBuffer(pVoice, pVoice->fade.pBuffer);
+        pVoice->fade.pBuffer = NULL;
+    }
+}
+
+VOID AudioStream::SetLoop(BOOL bLoop)
+{
+    _bLoop = bLoop;
+    AtomicStoreRelease(&_lLoop, (LONG) bLoop);
+}
+
+UINT AudioStream::MixVoice(
+    UINT                    uVoice,
+    BOOL                    bFade,
+    CONST RESAMPLEKERNELS*  pKernels,
+    FLOAT*                  pfOutput,
+    UINT                    cFrames,
+    ULONGLONG               ullStep,
+    FLOAT                   fGain,
+    FLOAT                   fGainStep)
+{
+    STREAMVOICE*    pVoice = &_pVoices[uVoice];
+    STREAMPLAYHEAD* pHead = bFade ? &pVoice->fade : &pVoice->main;
+    STREAMBUFFER*   pBuffer;
+    RESAMPLEPROC    pfnResample;
+    ULONGLONG       ullLimit, ullRun;
+    UINT            cChannels = _info.cChannels;
+    UINT            uFrame = 0;
+    BOOL            bEnd;
+
+    if (pHead->pBuffer == NULL && bFade == TRUE) {
+        return 0;
+    }
+
+    if (_bResident == TRUE) {
+        uFrame = ResampleClip(
+            pKernels,
+            pfOutput,
+            _prime.psSamples + cChannels,
+            cChannels,
+            _prime.cFrames,
+            _bLoop,
+            &pHead->ullPosition,
+            ullStep,
+            cFrames,
+            fGain,
+            fGainStep);
+
+        if (uFrame < cFrames) {
+            pHead->pBuffer = NULL;
+        }
+
+        return uFrame;
+    }
+
+    pfnResample = (cChannels == 2) ? pKernels->pfnStereo : pKernels->pfnMono;
+
+    while (uFrame < cFrames) {
+        if (pHead->pBuffer == NULL) {
+            if (bFade == TRUE) {
+                return uFrame;
+            }
+
+            // Ran dry: the rest of the block is silent and the position
+            // waits for the decoder
+            if (AcquireBuffer(pVoice, &pHead->pBuffer) == FALSE) {
+                _cUnderruns++;
+                AtomicStoreRelease(&_lUnderruns, (LONG) _cUnderruns);
+
+                return cFrames;
+            }
+
+            pVoice->bRewound = FALSE;
+        }
+
+        pBuffer = pHead->pBuffer;
+        ullLimit = (ULONGLONG) (pBuffer->cFrames + 1) << 32;
+
+        if (pHead->ullPosition >= ullLimit) {
+            bEnd = pBuffer->bEnd;
+
+            pHead->ullPosition -= (ULONGLONG) pBuffer->cFrames << 32;
+            pHead->pBuffer = NULL;
+            ReleaseBuffer(pVoice, pBuffer);
+
+            if (bEnd == TRUE) {
+                return uFrame;
+            }
+
+            continue;
+        }
+
+        ullRun = (ullLimit - pHead->ullPosition + ullStep - 1) / ullStep;
+
+        if (ullRun > cFrames - uFrame) {
+            ullRun = cFrames - uFrame;
+        }
+
+        pfnResample(
+            pfOutput + (SIZE_T) uFrame * 2,
+            pBuffer->psSamples,
+            (UINT) ullRun,
+            pHead->ullPosition,
+            ullStep,
+            fGain + (FLOAT) (INT) uFrame * fGainStep,
+            fGainStep);
+
+        pHead->ullPosition += ullRun * ullStep;
+        uFrame += (UINT) ullRun;
+    }
+
+    return uFrame;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+// Decodes the first STREAM_PRIME_FRAMES (plus the two after them) with
+// voice 0's decoder state
+HRESULT AudioStream::Prime()
+{
+    STREAMVOICE*    pVoice = &_pVoices[0];
+    UINT            cChannels = _info.cChannels;
+    UINT            cPulled;
+
+    pVoice->cbOffset = _info.cbFirstFrame;
+
+    cPulled = PullFrames(
+        pVoice,
+        _prime.psSamples + cChannels,
+        STREAM_PRIME_FRAMES + 2);
+
+    if (cPulled == 0) {
+        return E_INVALIDARG;
+    }
+
+    // A one-shot holds its first frame before the start
+    memcpy(_prime.psSamples, _prime.psSamples + cChannels,
+           cChannels * sizeof(SHORT));
+
+    if (cPulled < STREAM_PRIME_FRAMES + 2) {
+        _prime.cFrames = cPulled;
+        _bResident = TRUE;
+
+        return S_OK;
+    }
+
+    _prime.cFrames = STREAM_PRIME_FRAMES;
+
+    _afterPrime.cbBlock = pVoice->cbBlock;
+    _afterPrime.uBlockFrame = pVoice->uBlockFrame;
+
+    return S_OK;
+}
+
+HRESULT AudioStream::Initialize(
+    CONST BYTE* pbData,
+    SIZE_T      cbData,
+    UINT        cVoices)
+{
+    STREAMVOICE*    pVoice;
+    SIZE_T          cBlockSamples, cBufferSamples;
+    UINT            i, j;
+    HRESULT         hResult;
+
+    hResult = ParseFlac(pbData, cbData, &_info);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    _pbData = pbData;
+    _cbData = cbData;
+
+    cBlockSamples = (SIZE_T) _info.cMaxBlockFrames * _info.cChannels;
+    cBufferSamples = (SIZE_T) (STREAM_BUFFER_FRAMES + 3) * _info.cChannels;
+
+    _pVoices = new STREAMVOICE[cVoices];
+    _piScratch = new INT[cBlockSamples];
+    _prime.psSamples = new SHORT[
+        (SIZE_T) (STREAM_PRIME_FRAMES + 3) * _info.cChannels];
+
+    if (_pVoices == NULL || _piScratch == NULL || _prime.psSamples == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    _cVoices = cVoices;
+
+    for (i = 0; i < cVoices; i++) {
+        pVoice = &_pVoices[i];
+
+        pVoice->cbOffset = 0;
+        pVoice->cbBlock = 0;
+        pVoice->psBlock = NULL;
+        pVoice->cBlockFrames = 0;
+        pVoice->uBlockFrame = 0;
+        pVoice->ullBufferStart = 0;
+        pVoice->ullEnd = STREAM_END;
+        pVoice->bDone = FALSE;
+        pVoice->main.pBuffer = NULL;
+        pVoice->main.ullPosition = 0;
+        pVoice->fade = pVoice->main;
+        pVoice->lGeneration = 0;
+        pVoice->bRewound = TRUE;
+
+        // The decoder starts out one generation behind, so it rewinds
+        // and fills the buffers before the first Play()
+        pVoice->uGeneration = 0;
+        pVoice->uDecodeGeneration = ~0U;
+
+        for (j = 0; j < 2; j++) {
+            pVoice->buffers[j].psSamples = NULL;
+        }
+    }
+
+    _pVoices[0].psBlock = new SHORT[cBlockSamples];
+
+    if (_pVoices[0].psBlock == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    hResult = Prime();
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    _cbDecoded = (SIZE_T) (STREAM_PRIME_FRAMES + 3) * _info.cChannels *
+                 sizeof(SHORT);
+
+    // Everything is in the prime, there is nothing to stream
+    if (_bResident == TRUE) {
+        delete[] _piScratch;
+        delete[] _pVoices[0].psBlock;
+
+        _piScratch = NULL;
+        _pVoices[0].psBlock = NULL;
+
+        return S_OK;
+    }
+
+    for (i = 0; i < cVoices; i++) {
+        pVoice = &_pVoices[i];
+
+        if (pVoice->psBlock == NULL) {
+            pVoice->psBlock = new SHORT[cBlockSamples];
+        }
+
+        for (j = 0; j < 2; j++) {
+            pVoice->buffers[j].psSamples = new SHORT[cBufferSamples];
+
+            if (pVoice->buffers[j].psSamples == NULL) {
+                return E_OUTOFMEMORY;
+            }
+
+            pVoice->free.Push(&pVoice->buffers[j]);
+        }
+
+        if (pVoice->psBlock == NULL) {
+            return E_OUTOFMEMORY;
+        }
+
+        _cbDecoded += (cBlockSamples + 2 * cBufferSamples) * sizeof(SHORT);
+    }
+
+    hResult = ThreadEvent::CreateThreadEvent(&_pWake);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    return Thread::CreateThread(DecodeThreadProc, this, &_pThread);
+}
+
+HRESULT AudioStream::CreateAudioStream(
+    CONST BYTE*     pbData,
+    SIZE_T          cbData,
+    UINT            cVoices,
+    AudioStream**   ppStream)
+{
+    AudioStream*    pStream = NULL;
+    HRESULT         hResult;
+
+    if (pbData == NULL || ppStream == NULL ||
+        cVoices == 0 || cVoices > STREAM_MAX_VOICES)
+    {
+        return E_INVALIDARG;
+    }
+
+    pStream = new AudioStream();
+
+    if (pStream == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    hResult = pStream->Initialize(pbData, cbData, cVoices);
+
+    if (FAILED(hResult)) {
+        delete pStream;
+        return hResult;
+    }
+
+    *ppStream = pStream;
+    return S_OK;
+}
+
+HRESULT AudioStream::CreateAudioStreamFromFile(
+    LPCTSTR         lpszPath,
+    UINT            cVoices,
+    AudioStream**   ppStream)
+{
+    MappedFile* pFile = NULL;
+    HRESULT     hResult;
+
+    FP_TRACE_SCOPE("AudioStream::CreateAudioStreamFromFile");
+
+    if (lpszPath == NULL || ppStream == NULL) {
+        return E_INVALIDARG;
+    }
+
+    hResult = MappedFile::CreateMappedFile(lpszPath, &pFile);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    hResult = CreateAudioStream(
+        pFile->GetData(),
+        pFile->GetSize(),
+        cVoices,
+        ppStream);
+
+    if (FAILED(hResult)) {
+        delete pFile;
+        return hResult;
+    }
+
+    (*ppStream)->_pFile = pFile;
+
+    return S_OK;
+}
@@ -0,0 +1,196 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __AUDIOSTREAM_H
+#define __AUDIOSTREAM_H
+
+#include "wintypes.h"
+#include "clock.h"
+#include "flacfile.h"
+#include "mappedfile.h"
+#include "resample.h"
+#include "spscqueue.h"
+#include "thread.h"
+
+////////////////////////////////////////////////////////////////////////////
+// AudioStream
+//
+// A FLAC file played straight from its (mapped) bytes. Each voice owns
+// one decoded FLAC block and two small buffers; a background thread
+// keeps the buffers filled and the audio thread plays them in turn, so
+// what a voice holds does not depend on how long the file is.
+//
+// The first STREAM_PRIME_FRAMES stay decoded for good and are shared by
+// all voices: a voice starts on them at once while the decoder seeks to
+// where they end. A stream that fits in them entirely is held that way
+// and plays like a clip, without the thread.
+//
+// Buffers carry one frame before and two after their own frames, so the
+// resampler always has its four taps across buffer boundaries. Only the
+// mixer plays streams, see Mixer::CreateStreamSound().
+//
+// The thread sleeps until the audio thread hands a buffer back or starts
+// a voice over; it never polls.
+////////////////////////////////////////////////////////////////////////////
+
+#define STREAM_BUFFER_FRAMES    2048
+#define STREAM_PRIME_FRAMES     2048
+
+#define STREAM_MAX_VOICES       16
+
+typedef struct _AUDIOSTREAMSTATS {
+    ULONG   cFramesDecoded;         // By the background thread
+    ULONG   ulDecodeMicroseconds;   // Spent decoding them
+    ULONG   cUnderruns;             // Blocks a voice ran dry in
+    SIZE_T  cbDecoded;              // PCM held, prime and all voices
+} AUDIOSTREAMSTATS;
+
+class AudioStream {
+    friend class Mixer;
+
+public:
+    // pbData must outlive the stream. cVoices is how many may play at
+    // once, up to STREAM_MAX_VOICES.
+    static HRESULT CreateAudioStream(
+        CONST BYTE*     pbData,
+        SIZE_T          cbData,
+        UINT            cVoices,
+        AudioStream**   ppStream);
+
+    static HRESULT CreateAudioStreamFromFile(
+        LPCTSTR         lpszPath,
+        UINT            cVoices,
+        AudioStream**   ppStream);
+
+    ~AudioStream();
+
+    UINT GetSampleRate() CONST;
+    UINT GetChannels() CONST;
+    UINT GetVoiceCount() CONST;
+
+    // TRUE when the whole stream fits in the prime
+    BOOL IsResident() CONST;
+
+    VOID GetStats(AUDIOSTREAMSTATS* pStats) CONST;
+
+private:
+    typedef struct _STREAMBUFFER {
+        SHORT*      psSamples;      // cFrames + 3 frames, interleaved
+        UINT        cFrames;
+        UINT        uGeneration;
+        BOOL        bEnd;           // Nothing follows
+    } STREAMBUFFER;
+
+    typedef struct _STREAMPLAYHEAD {
+        STREAMBUFFER*   pBuffer;    // NULL while waiting for one
+        ULONGLONG       ullPosition;    // 32.32, buffer frame + 1
+    } STREAMPLAYHEAD;
+
+    // Where a voice's decoder continues after the prime
+    typedef struct _STREAMCURSOR {
+        SIZE_T      cbBlock;        // Offset of the FLAC frame
+        UINT        uBlockFrame;    // Next frame inside it
+    } STREAMCURSOR;
+
+    typedef struct _STREAMVOICE {
+        // Decoder thread
+        SIZE_T          cbOffset;       // Next FLAC frame
+        SIZE_T          cbBlock;        // Offset of the decoded one
+        SHORT*          psBlock;
+        UINT            cBlockFrames;
+        UINT            uBlockFrame;
+        ULONGLONG       ullBufferStart; // Stream frame of the next buffer
+        ULONGLONG       ullEnd;         // Where it ends, ~0 if not known
+        UINT            uDecodeGeneration;
+        SHORT           carry[3 * FLAC_MAX_CHANNELS];
+        BOOL            bDone;
+
+        // Audio thread
+        STREAMPLAYHEAD  main;
+        STREAMPLAYHEAD  fade;
+        UINT            uGeneration;
+        BOOL            bRewound;       // Queue still follows the prime
+
+        // Both; buffers go back and forth through the queues
+        STREAMBUFFER                buffers[2];
+        SpscQueue<STREAMBUFFER*, 2> filled;
+        SpscQueue<STREAMBUFFER*, 2> free;
+        volatile LONG               lGeneration;
+    } STREAMVOICE;
+
+    AudioStream();
+
+    HRESULT Initialize(CONST BYTE* pbData, SIZE_T cbData, UINT cVoices);
+    HRESULT Prime();
+
+    static VOID DecodeThreadProc(LPVOID pContext);
+
+    // Decoder thread
+    BOOL DecodeBlock(STREAMVOICE* pVoice);
+    UINT PullFrames(STREAMVOICE* pVoice, SHORT* psOutput, UINT cFrames);
+    VOID Rewind(STREAMVOICE* pVoice);
+    BOOL FillBuffer(STREAMVOICE* pVoice);
+
+    // Audio thread, through the mixer
+    VOID StartVoice(UINT uVoice);
+    VOID FadeVoice(UINT uVoice);
+    VOID EndFade(UINT uVoice);
+    VOID SetLoop(BOOL bLoop);
+
+    // Returns the frames rendered; fewer than cFrames means the stream
+    // ended. A voice waiting for the decoder renders silence.
+    UINT MixVoice(
+        UINT                    uVoice,
+        BOOL                    bFade,
+        CONST RESAMPLEKERNELS*  pKernels,
+        FLOAT*                  pfOutput,
+        UINT                    cFrames,
+        ULONGLONG               ullStep,
+        FLOAT                   fGain,
+        FLOAT                   fGainStep);
+
+    VOID ReleaseBuffer(STREAMVOICE* pVoice, STREAMBUFFER* pBuffer);
+    BOOL AcquireBuffer(STREAMVOICE* pVoice, STREAMBUFFER** ppBuffer);
+
+    CONST BYTE*     _pbData;
+    SIZE_T          _cbData;
+    MappedFile*     _pFile;
+    FLACINFO        _info;
+
+    STREAMVOICE*    _pVoices;
+    UINT            _cVoices;
+    INT*            _piScratch;     // Decoder thread
+    SIZE_T          _cbDecoded;
+
+    STREAMBUFFER    _prime;
+    STREAMCURSOR    _afterPrime;
+    BOOL            _bResident;
+    BOOL            _bLoop;         // Audio thread
+
+    Thread*         _pThread;
+    ThreadEvent*    _pWake;         // Work for the decoder thread
+    SystemClock     _clock;
+    volatile LONG   _lStop;
+    volatile LONG   _lLoop;
+    volatile LONG   _lFramesDecoded;
+    volatile LONG   _lDecodeMicroseconds;
+    volatile LONG   _lUnderruns;
+    LONGLONG        _llDecodeTicks;     // Decoder thread
+    ULONG           _cFramesDecoded;    // Decoder thread
+    ULONG           _cUnderruns;        // Audio thread
+};
+
+#endif // __AUDIOSTREAM_H
@@ -0,0 +1,416 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "blit.h"
+#include "cpu.h"
+
+#define FIXED_SHIFT     16
+#define FIXED_ONE       (1 << FIXED_SHIFT)
+#define FIXED_MASK      (FIXED_ONE - 1)
+
+// Kernels keep positions in 32 bits; steps past this much (more than 256
+// texels per pixel) only ever go through the bounded path
+#define BLIT_MAX_STEP   ((LONGLONG) 1 << 24)
+
+////////////////////////////////////////////////////////////////////////////
+// Pixel math
+//
+// Everything stays below 2^16 so the SIMD variants can do the same in
+// 16-bit lanes:
+//
+//   lerp      (a * (256 - f) + b * f + 128) >> 8
+//   opacity   (c * alpha + 128) >> 8
+//   blend     s + div255(d * (255 - sa))
+////////////////////////////////////////////////////////////////////////////
+
+static inline UINT Lerp(UINT a, UINT b, UINT f)
+{
+    return (a * (256 - f) + b * f + 128) >> 8;
+}
+
+static inline UINT Div255(UINT x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+static inline VOID BlendPixel(BYTE* pbDst, CONST UINT* puSrc, UINT uAlpha)
+{
+    UINT src[4], uInvAlpha, c;
+
+    for (c = 0; c < 4; c++) {
+        src[c] = (puSrc[c] * uAlpha + 128) >> 8;
+    }
+
+    uInvAlpha = 255 - src[3];
+
+    for (c = 0; c < 4; c++) {
+        pbDst[c] = (BYTE) (src[c] + Div255(pbDst[c] * uInvAlpha));
+    }
+}
+
+static inline VOID BlendBilinear(
+    BYTE*       pbDst,
+    CONST BYTE* p00,
+    CONST BYTE* p01,
+    CONST BYTE* p10,
+    CONST BYTE* p11,
+    UINT        fx,
+    UINT        fy,
+    UINT        uAlpha)
+{
+    UINT color[4], c;
+
+    for (c = 0; c < 4; c++) {
+        color[c] = Lerp(Lerp(p00[c], p01[c], fx), Lerp(p10[c], p11[c], fx), fy);
+    }
+
+    BlendPixel(pbDst, color, uAlpha);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Scalar kernels
+////////////////////////////////////////////////////////////////////////////
+
+static VOID BlitTranslateScalar(
+    BYTE*       pbDst,
+    CONST BYTE* pbSrc,
+    UINT        cPixels,
+    UINT        uAlpha)
+{
+    UINT color[4];
+    UINT i;
+
+    for (i = 0; i < cPixels; i++, pbDst += 4, pbSrc += 4) {
+        color[0] = pbSrc[0];
+        color[1] = pbSrc[1];
+        color[2] = pbSrc[2];
+        color[3] = pbSrc[3];
+
+        BlendPixel(pbDst, color, uAlpha);
+    }
+}
+
+static VOID BlitScaleScalar(
+    BYTE*       pbDst,
+    CONST BYTE* pbRow0,
+    CONST BYTE* pbRow1,
+    UINT        cPixels,
+    LONG        u,
+    LONG        du,
+    UINT        fy,
+    UINT        uAlpha)
+{
+    CONST BYTE* p0;
+    CONST BYTE* p1;
+    UINT        i;
+
+    for (i = 0; i < cPixels; i++, pbDst += 4, u += du) {
+        p0 = pbRow0 + (u >> FIXED_SHIFT) * 4;
+        p1 = pbRow1 + (u >> FIXED_SHIFT) * 4;
+
+        BlendBilinear(pbDst, p0, p0 + 4, p1, p1 + 4,
+                      (u >> 8) & 0xFF, fy, uAlpha);
+    }
+}
+
+static VOID BlitAffineScalar(
+    BYTE*               pbDst,
+    CONST BLITSOURCE*   pSource,
+    UINT                cPixels,
+    LONG                u,
+    LONG                v,
+    LONG                du,
+    LONG                dv,
+    UINT                uAlpha)
+{
+    CONST BYTE* p0;
+    CONST BYTE* p1;
+    UINT        i;
+
+    for (i = 0; i < cPixels; i++, pbDst += 4, u += du, v += dv) {
+        p0 = pSource->pbPixels +
+             (v >> FIXED_SHIFT) * pSource->uStride +
+             (u >> FIXED_SHIFT) * 4;
+        p1 = p0 + pSource->uStride;
+
+        BlendBilinear(pbDst, p0, p0 + 4, p1, p1 + 4,
+                      (u >> 8) & 0xFF, (v >> 8) & 0xFF, uAlpha);
+    }
+}
+
+static CONST BLITKERNELS SCALAR_BLIT_KERNELS = {
+    BLIT_LEVEL_SCALAR,
+    "scalar",
+    BlitTranslateScalar,
+    BlitScaleScalar,
+    BlitAffineScalar
+};
+
+////////////////////////////////////////////////////////////////////////////
+// Edges
+////////////////////////////////////////////////////////////////////////////
+
+static inline CONST BYTE* FetchTexel(
+    CONST BLITSOURCE*   pSource,
+    LONGLONG            x,
+    LONGLONG            y)
+{
+    static CONST BYTE transparent[4] = { 0, 0, 0, 0 };
+
+    // Outside texels are transparent, which gives the bitmap the same
+    // one pixel soft edge Direct2D draws
+    if (x < 0 || y < 0 ||
+        x >= (LONGLONG) pSource->uWidth ||
+        y >= (LONGLONG) pSource->uHeight)
+    {
+        return transparent;
+    }
+
+    return pSource->pbPixels + (SIZE_T) y * pSource->uStride + (SIZE_T) x * 4;
+}
+
+static VOID BlitAffineBounded(
+    BYTE*               pbDst,
+    CONST BLITSOURCE*   pSource,
+    UINT                cPixels,
+    LONGLONG            u,
+    LONGLONG            v,
+    LONGLONG            du,
+    LONGLONG            dv,
+    UINT                uAlpha)
+{
+    LONGLONG    x, y;
+    UINT        i;
+
+    for (i = 0; i < cPixels; i++, pbDst += 4, u += du, v += dv) {
+        x = u >> FIXED_SHIFT;
+        y = v >> FIXED_SHIFT;
+
+        BlendBilinear(
+            pbDst,
+            FetchTexel(pSource, x,     y),
+            FetchTexel(pSource, x + 1, y),
+            FetchTexel(pSource, x,     y + 1),
+            FetchTexel(pSource, x + 1, y + 1),
+            (UINT) (u >> 8) & 0xFF,
+            (UINT) (v >> 8) & 0xFF,
+            uAlpha);
+    }
+}
+
+static LONGLONG FloorDiv(LONGLONG a, LONGLONG b)
+{
+    LONGLONG q = a / b;
+
+    if ((a % b) != 0 && a < 0) {
+        q--;
+    }
+
+    return q;
+}
+
+// Narrows [*piFirst, *piLast) to the pixels i with 0 <= u + i * du < uMax
+static VOID ClipSpan(
+    LONGLONG    u,
+    LONGLONG    du,
+    LONGLONG    uMax,
+    LONGLONG*   piFirst,
+    LONGLONG*   piLast)
+{
+    LONGLONG iFirst, iLast;
+
+    if (du == 0) {
+        if (u < 0 || u >= uMax) {
+            *piLast = *piFirst;
+        }
+
+        return;
+    }
+
+    if (du > 0) {
+        iFirst = -FloorDiv(u, du);
+        iLast  = -FloorDiv(u - uMax, du);
+    } else {
+        iFirst = FloorDiv(u - uMax, -du) + 1;
+        iLast  = FloorDiv(u, -du) + 1;
+    }
+
+    if (iFirst > *piFirst) *piFirst = iFirst;
+    if (iLast  < *piLast)  *piLast  = iLast;
+
+    if (*piLast < *piFirst) {
+        *piLast = *piFirst;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+CONST BLITKERNELS* GetBlitKernelsForLevel(BLITLEVEL level)
+{
+    switch (level) {
+        case BLIT_LEVEL_SCALAR:
+            return &SCALAR_BLIT_KERNELS;
+#ifdef FP_ARCH_X86
+        case BLIT_LEVEL_SSE2:
+            if (GetCpuFeatures() & CPU_FEATURE_SSE2) {
+                return &SSE2_BLIT_KERNELS;
+            }
+            break;
+        case BLIT_LEVEL_AVX2:
+            if (GetCpuFeatures() & CPU_FEATURE_AVX2) {
+                return &AVX2_BLIT_KERNELS;
+            }
+            break;
+#endif // FP_ARCH_X86
+        default:
+            break;
+    }
+
+    return NULL;
+}
+
+CONST BLITKERNELS* GetBlitKernels()
+{
+    static CONST BLITLEVEL levels[] = {
+        BLIT_LEVEL_AVX2,
+        BLIT_LEVEL_SSE2,
+        BLIT_LEVEL_SCALAR
+    };
+
+    CONST BLITKERNELS*  pKernels = NULL;
+    UINT                i;
+
+    for (i = 0; i < ARRAYSIZE(levels) && pKernels == NULL; i++) {
+        pKernels = GetBlitKernelsForLevel(levels[i]);
+    }
+
+    return pKernels;
+}
+
+BLITCLASS ClassifyBlit(
+    LONGLONG    u,
+    LONGLONG    v,
+    LONGLONG    dux,
+    LONGLONG    dvx,
+    LONGLONG    duy,
+    LONGLONG    dvy)
+{
+    // Whole pixel offsets make every bilinear weight zero
+    if (dux == FIXED_ONE && dvx == 0 && duy == 0 && dvy == FIXED_ONE &&
+        (u & FIXED_MASK) == 0 && (v & FIXED_MASK) == 0)
+    {
+        return BLIT_TRANSLATE;
+    }
+
+    // A destination row stays on one source row pair
+    if (dvx == 0) {
+        return BLIT_SCALE;
+    }
+
+    return BLIT_AFFINE;
+}
+
+VOID BlitRow(
+    CONST BLITKERNELS*  pKernels,
+    BLITCLASS           blitClass,
+    BYTE*               pbDst,
+    CONST BLITSOURCE*   pSource,
+    UINT                cPixels,
+    LONGLONG            u,
+    LONGLONG            v,
+    LONGLONG            du,
+    LONGLONG            dv,
+    UINT                uAlpha)
+{
+    LONGLONG    iFirst = 0, iLast = cPixels;
+    LONGLONG    uMax, vMax;
+    CONST BYTE* pbRow;
+
+    // The kernels read the texel to the right and below without checks,
+    // except for translations where those have zero weight
+    if (blitClass == BLIT_TRANSLATE) {
+        uMax = (LONGLONG) pSource->uWidth  << FIXED_SHIFT;
+        vMax = (LONGLONG) pSource->uHeight << FIXED_SHIFT;
+    } else {
+        uMax = (LONGLONG) ((LONG) pSource->uWidth  - 1) << FIXED_SHIFT;
+        vMax = (LONGLONG) ((LONG) pSource->uHeight - 1) << FIXED_SHIFT;
+    }
+
+    if (du <= -BLIT_MAX_STEP || du >= BLIT_MAX_STEP ||
+        dv <= -BLIT_MAX_STEP || dv >= BLIT_MAX_STEP)
+    {
+        iLast = 0;
+    }
+
+    ClipSpan(u, du, uMax, &iFirst, &iLast);
+    ClipSpan(v, dv, vMax, &iFirst, &iLast);
+
+    if (iFirst == iLast) {
+        BlitAffineBounded(pbDst, pSource, cPixels, u, v, du, dv, uAlpha);
+        return;
+    }
+
+    BlitAffineBounded(pbDst, pSource, (UINT) iFirst, u, v, du, dv, uAlpha);
+
+    BlitAffineBounded(
+        pbDst + iLast * 4,
+        pSource,
+        cPixels - (UINT) iLast,
+        u + du * iLast,
+        v + dv * iLast,
+        du,
+        dv,
+        uAlpha);
+
+    pbDst += iFirst * 4;
+    u     += du * iFirst;
+    v     += dv * iFirst;
+
+    pbRow = pSource->pbPixels + (SIZE_T) (v >> FIXED_SHIFT) * pSource->uStride;
+
+    switch (blitClass) {
+        case BLIT_TRANSLATE:
+            pKernels->pfnTranslate(
+                pbDst,
+                pbRow + (SIZE_T) (u >> FIXED_SHIFT) * 4,
+                (UINT) (iLast - iFirst),
+                uAlpha);
+            break;
+        case BLIT_SCALE:
+            pKernels->pfnScale(
+                pbDst,
+                pbRow,
+                pbRow + pSource->uStride,
+                (UINT) (iLast - iFirst),
+                (LONG) u,
+                (LONG) du,
+                (UINT) (v >> 8) & 0xFF,
+                uAlpha);
+            break;
+        case BLIT_AFFINE:
+            pKernels->pfnAffine(
+                pbDst,
+                pSource,
+                (UINT) (iLast - iFirst),
+                (LONG) u,
+                (LONG) v,
+                (LONG) du,
+                (LONG) dv,
+                uAlpha);
+            break;
+    }
+}
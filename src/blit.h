@@ -0,0 +1,128 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BLIT_H
+#define __BLIT_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Blit kernels
+//
+// Source-over compositing of premultiplied BGRA, in three classes:
+//
+//   translate  1:1 copy at a whole pixel offset
+//   scale      axis-aligned, bilinear along the row with a fixed row pair
+//   affine     anything else, full bilinear
+//
+// Every class has a scalar, an SSE2 and an AVX2 variant. They all run the
+// same 16-bit integer math and produce identical bytes, so picking one at
+// runtime never changes a frame. Kernels only see the interior of the
+// source; BlitRow() splits a row and handles the edges itself.
+//
+// Positions are 16.16 fixed point, already moved back by half a texel.
+// Opacity is 0..256.
+////////////////////////////////////////////////////////////////////////////
+
+typedef struct _BLITSOURCE {
+    CONST BYTE*     pbPixels;
+    UINT            uWidth;
+    UINT            uHeight;
+    UINT            uStride;
+} BLITSOURCE;
+
+typedef enum _BLITCLASS {
+    BLIT_TRANSLATE,
+    BLIT_SCALE,
+    BLIT_AFFINE
+} BLITCLASS;
+
+typedef enum _BLITLEVEL {
+    BLIT_LEVEL_SCALAR,
+    BLIT_LEVEL_SSE2,
+    BLIT_LEVEL_AVX2
+} BLITLEVEL;
+
+typedef VOID (*BLITTRANSLATEPROC)(
+    BYTE*               pbDst,
+    CONST BYTE*         pbSrc,
+    UINT                cPixels,
+    UINT                uAlpha);
+
+// Row pair and fy are fixed; u steps by du
+typedef VOID (*BLITSCALEPROC)(
+    BYTE*               pbDst,
+    CONST BYTE*         pbRow0,
+    CONST BYTE*         pbRow1,
+    UINT                cPixels,
+    LONG                u,
+    LONG                du,
+    UINT                fy,
+    UINT                uAlpha);
+
+typedef VOID (*BLITAFFINEPROC)(
+    BYTE*               pbDst,
+    CONST BLITSOURCE*   pSource,
+    UINT                cPixels,
+    LONG                u,
+    LONG                v,
+    LONG                du,
+    LONG                dv,
+    UINT                uAlpha);
+
+typedef struct _BLITKERNELS {
+    BLITLEVEL           level;
+    LPCSTR              pszName;
+    BLITTRANSLATEPROC   pfnTranslate;
+    BLITSCALEPROC       pfnScale;
+    BLITAFFINEPROC      pfnAffine;
+} BLITKERNELS;
+
+// Best kernels for this CPU
+CONST BLITKERNELS* GetBlitKernels();
+
+// NULL when the level is not built in or not supported by the CPU
+CONST BLITKERNELS* GetBlitKernelsForLevel(BLITLEVEL level);
+
+// Picks the class for an inverse transform (destination to source)
+BLITCLASS ClassifyBlit(
+    LONGLONG            u,
+    LONGLONG            v,
+    LONGLONG            dux,
+    LONGLONG            dvx,
+    LONGLONG            duy,
+    LONGLONG            dvy);
+
+// Composites one destination row starting at source position (u, v)
+VOID BlitRow(
+    CONST BLITKERNELS*  pKernels,
+    BLITCLASS           blitClass,
+    BYTE*               pbDst,
+    CONST BLITSOURCE*   pSource,
+    UINT                cPixels,
+    LONGLONG            u,
+    LONGLONG            v,
+    LONGLONG            du,
+    LONGLONG            dv,
+    UINT                uAlpha);
+
+////////////////////////////////////////////////////////////////////////////
+// Per level tables, defined in blit_sse2.cpp and blit_avx2.cpp
+
+extern CONST BLITKERNELS SSE2_BLIT_KERNELS;
+extern CONST BLITKERNELS AVX2_BLIT_KERNELS;
+
+#endif // __BLIT_H
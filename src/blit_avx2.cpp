@@ -0,0 +1,236 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "blit.h"
+#include "cpu.h"
+
+#ifdef FP_ARCH_X86
+
+#include <immintrin.h>
+
+#define FIXED_SHIFT 16
+
+////////////////////////////////////////////////////////////////////////////
+// AVX2 kernels
+//
+// Four pixels per 256-bit register, texels fetched with gathers. The
+// tails go to the SSE2 kernels, which compute the same bytes.
+////////////////////////////////////////////////////////////////////////////
+
+static inline __m256i Lerp(__m256i a, __m256i b, __m256i f)
+{
+    __m256i inv = _mm256_sub_epi16(_mm256_set1_epi16(256), f);
+    __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(a, inv),
+                                   _mm256_mullo_epi16(b, f));
+
+    return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(128)), 8);
+}
+
+static inline __m256i Opacity(__m256i color, __m256i alpha)
+{
+    __m256i scaled = _mm256_mullo_epi16(color, alpha);
+
+    return _mm256_srli_epi16(_mm256_add_epi16(scaled, _mm256_set1_epi16(128)), 8);
+}
+
+// src + div255(dst * (255 - src.a))
+static inline __m256i Blend(__m256i src, __m256i dst)
+{
+    __m256i alpha, t;
+
+    alpha = _mm256_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3));
+    alpha = _mm256_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+
+    t = _mm256_mullo_epi16(dst, _mm256_sub_epi16(_mm256_set1_epi16(255), alpha));
+    t = _mm256_add_epi16(t, _mm256_set1_epi16(128));
+    t = _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+
+    return _mm256_add_epi16(src, t);
+}
+
+// Opacity and blend of four widened pixels (0, 1 | 2, 3) into 16 bytes
+// of destination
+static inline VOID Store4(BYTE* pbDst, __m256i color, __m256i alpha)
+{
+    __m256i dst = _mm256_cvtepu8_epi16(_mm_loadu_si128((CONST __m128i*) pbDst));
+
+    color = Blend(Opacity(color, alpha), dst);
+    color = _mm256_packus_epi16(color, color);
+    color = _mm256_permute4x64_epi64(color, _MM_SHUFFLE(3, 1, 2, 0));
+
+    _mm_storeu_si128((__m128i*) pbDst, _mm256_castsi256_si128(color));
+}
+
+// Horizontal lerp of four gathered texel pairs, result is (0, 1 | 2, 3)
+static inline __m256i LerpPairs(__m256i pairs, CONST UINT* pfx)
+{
+    __m256i zero = _mm256_setzero_si256();
+    __m256i even, odd, weights;
+
+    even = _mm256_unpacklo_epi8(pairs, zero);   // 0 | 2
+    odd  = _mm256_unpackhi_epi8(pairs, zero);   // 1 | 3
+
+    weights = _mm256_set_epi16(
+        (SHORT) pfx[2], (SHORT) pfx[2], (SHORT) pfx[2], (SHORT) pfx[2],
+        (SHORT) (256 - pfx[2]), (SHORT) (256 - pfx[2]),
+        (SHORT) (256 - pfx[2]), (SHORT) (256 - pfx[2]),
+        (SHORT) pfx[0], (SHORT) pfx[0], (SHORT) pfx[0], (SHORT) pfx[0],
+        (SHORT) (256 - pfx[0]), (SHORT) (256 - pfx[0]),
+        (SHORT) (256 - pfx[0]), (SHORT) (256 - pfx[0]));
+
+    even = _mm256_mullo_epi16(even, weights);
+    even = _mm256_add_epi16(even, _mm256_srli_si256(even, 8));
+
+    weights = _mm256_set_epi16(
+        (SHORT) pfx[3], (SHORT) pfx[3], (SHORT) pfx[3], (SHORT) pfx[3],
+        (SHORT) (256 - pfx[3]), (SHORT) (256 - pfx[3]),
+        (SHORT) (256 - pfx[3]), (SHORT) (256 - pfx[3]),
+        (SHORT) pfx[1], (SHORT) pfx[1], (SHORT) pfx[1], (SHORT) pfx[1],
+        (SHORT) (256 - pfx[1]), (SHORT) (256 - pfx[1]),
+        (SHORT) (256 - pfx[1]), (SHORT) (256 - pfx[1]));
+
+    odd = _mm256_mullo_epi16(odd, weights);
+    odd = _mm256_add_epi16(odd, _mm256_srli_si256(odd, 8));
+
+    return _mm256_srli_epi16(
+        _mm256_add_epi16(_mm256_unpacklo_epi64(even, odd),
+                         _mm256_set1_epi16(128)),
+        8);
+}
+
+static inline __m256i Gather4(CONST BYTE* pbBase, __m128i offsets)
+{
+    return _mm256_i32gather_epi64((CONST long long*) pbBase, offsets, 1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+static VOID BlitTranslateAvx2(
+    BYTE*       pbDst,
+    CONST BYTE* pbSrc,
+    UINT        cPixels,
+    UINT        uAlpha)
+{
+    __m256i zero  = _mm256_setzero_si256();
+    __m256i alpha = _mm256_set1_epi16((SHORT) uAlpha);
+    __m256i src, dst, lo, hi;
+    UINT    i;
+
+    for (i = 0; i + 8 <= cPixels; i += 8, pbDst += 32, pbSrc += 32) {
+        src = _mm256_loadu_si256((CONST __m256i*) pbSrc);
+        dst = _mm256_loadu_si256((CONST __m256i*) pbDst);
+
+        lo = Blend(Opacity(_mm256_unpacklo_epi8(src, zero), alpha),
+                   _mm256_unpacklo_epi8(dst, zero));
+        hi = Blend(Opacity(_mm256_unpackhi_epi8(src, zero), alpha),
+                   _mm256_unpackhi_epi8(dst, zero));
+
+        _mm256_storeu_si256((__m256i*) pbDst, _mm256_packus_epi16(lo, hi));
+    }
+
+    SSE2_BLIT_KERNELS.pfnTranslate(pbDst, pbSrc, cPixels - i, uAlpha);
+}
+
+static VOID BlitScaleAvx2(
+    BYTE*       pbDst,
+    CONST BYTE* pbRow0,
+    CONST BYTE* pbRow1,
+    UINT        cPixels,
+    LONG        u,
+    LONG        du,
+    UINT        fy,
+    UINT        uAlpha)
+{
+    __m256i alpha   = _mm256_set1_epi16((SHORT) uAlpha);
+    __m256i weights = _mm256_set1_epi16((SHORT) fy);
+    __m256i top, bottom;
+    __m128i offsets;
+    INT     x[4];
+    UINT    fx[4];
+    UINT    i, j;
+
+    for (i = 0; i + 4 <= cPixels; i += 4, pbDst += 16) {
+        for (j = 0; j < 4; j++, u += du) {
+            x[j]  = (INT) (u >> FIXED_SHIFT) * 4;
+            fx[j] = (UINT) (u >> 8) & 0xFF;
+        }
+
+        offsets = _mm_set_epi32(x[3], x[2], x[1], x[0]);
+
+        top    = LerpPairs(Gather4(pbRow0, offsets), fx);
+        bottom = LerpPairs(Gather4(pbRow1, offsets), fx);
+
+        Store4(pbDst, Lerp(top, bottom, weights), alpha);
+    }
+
+    SSE2_BLIT_KERNELS.pfnScale(
+        pbDst, pbRow0, pbRow1, cPixels - i, u, du, fy, uAlpha);
+}
+
+static VOID BlitAffineAvx2(
+    BYTE*               pbDst,
+    CONST BLITSOURCE*   pSource,
+    UINT                cPixels,
+    LONG                u,
+    LONG                v,
+    LONG                du,
+    LONG                dv,
+    UINT                uAlpha)
+{
+    __m256i     alpha   = _mm256_set1_epi16((SHORT) uAlpha);
+    CONST BYTE* pbRow0  = pSource->pbPixels;
+    CONST BYTE* pbRow1  = pSource->pbPixels + pSource->uStride;
+    __m256i     top, bottom, weights;
+    __m128i     offsets;
+    INT         offset[4];
+    UINT        fx[4], fy[4];
+    UINT        i, j;
+
+    for (i = 0; i + 4 <= cPixels; i += 4, pbDst += 16) {
+        for (j = 0; j < 4; j++, u += du, v += dv) {
+            offset[j] = (INT) (v >> FIXED_SHIFT) * (INT) pSource->uStride +
+                        (INT) (u >> FIXED_SHIFT) * 4;
+            fx[j] = (UINT) (u >> 8) & 0xFF;
+            fy[j] = (UINT) (v >> 8) & 0xFF;
+        }
+
+        offsets = _mm_set_epi32(offset[3], offset[2], offset[1], offset[0]);
+
+        top    = LerpPairs(Gather4(pbRow0, offsets), fx);
+        bottom = LerpPairs(Gather4(pbRow1, offsets), fx);
+
+        weights = _mm256_set_epi16(
+            (SHORT) fy[3], (SHORT) fy[3], (SHORT) fy[3], (SHORT) fy[3],
+            (SHORT) fy[2], (SHORT) fy[2], (SHORT) fy[2], (SHORT) fy[2],
+            (SHORT) fy[1], (SHORT) fy[1], (SHORT) fy[1], (SHORT) fy[1],
+            (SHORT) fy[0], (SHORT) fy[0], (SHORT) fy[0], (SHORT) fy[0]);
+
+        Store4(pbDst, Lerp(top, bottom, weights), alpha);
+    }
+
+    SSE2_BLIT_KERNELS.pfnAffine(
+        pbDst, pSource, cPixels - i, u, v, du, dv, uAlpha);
+}
+
+CONST BLITKERNELS AVX2_BLIT_KERNELS = {
+    BLIT_LEVEL_AVX2,
+    "avx2",
+    BlitTranslateAvx2,
+    BlitScaleAvx2,
+    BlitAffineAvx2
+};
+
+#endif // FP_ARCH_X86
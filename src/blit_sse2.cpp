@@ -0,0 +1,263 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "blit.h"
+#include "cpu.h"
+
+#ifdef FP_ARCH_X86
+
+#include <emmintrin.h>
+#include <string.h>
+
+#define FIXED_SHIFT 16
+
+////////////////////////////////////////////////////////////////////////////
+// SSE2 kernels
+//
+// Pixels are widened to 16-bit lanes, two per register. The math is the
+// same as the scalar kernels in blit.cpp, lane for lane.
+////////////////////////////////////////////////////////////////////////////
+
+static inline __m128i Lerp(__m128i a, __m128i b, __m128i f)
+{
+    __m128i inv = _mm_sub_epi16(_mm_set1_epi16(256), f);
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(a, inv), _mm_mullo_epi16(b, f));
+
+    return _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(128)), 8);
+}
+
+static inline __m128i Opacity(__m128i color, __m128i alpha)
+{
+    __m128i scaled = _mm_mullo_epi16(color, alpha);
+
+    return _mm_srli_epi16(_mm_add_epi16(scaled, _mm_set1_epi16(128)), 8);
+}
+
+// src + div255(dst * (255 - src.a))
+static inline __m128i Blend(__m128i src, __m128i dst)
+{
+    __m128i alpha, t;
+
+    alpha = _mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3));
+    alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+
+    t = _mm_mullo_epi16(dst, _mm_sub_epi16(_mm_set1_epi16(255), alpha));
+    t = _mm_add_epi16(t, _mm_set1_epi16(128));
+    t = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+
+    return _mm_add_epi16(src, t);
+}
+
+static inline __m128i LoadPixel(CONST BYTE* pb)
+{
+    INT iPixel;
+
+    memcpy(&iPixel, pb, 4);
+
+    return _mm_cvtsi32_si128(iPixel);
+}
+
+static inline VOID StorePixel(BYTE* pb, __m128i pixel)
+{
+    INT iPixel = _mm_cvtsi128_si32(pixel);
+
+    memcpy(pb, &iPixel, 4);
+}
+
+// Opacity and blend of two widened pixels into 8 bytes of destination
+static inline VOID Store2(BYTE* pbDst, __m128i color, __m128i alpha)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i dst  = _mm_unpacklo_epi8(
+        _mm_loadl_epi64((CONST __m128i*) pbDst), zero);
+
+    color = Blend(Opacity(color, alpha), dst);
+
+    _mm_storel_epi64((__m128i*) pbDst, _mm_packus_epi16(color, color));
+}
+
+static inline VOID Store1(BYTE* pbDst, __m128i color, __m128i alpha)
+{
+    __m128i zero = _mm_setzero_si128();
+    __m128i dst  = _mm_unpacklo_epi8(LoadPixel(pbDst), zero);
+
+    color = Blend(Opacity(color, alpha), dst);
+
+    StorePixel(pbDst, _mm_packus_epi16(color, color));
+}
+
+// Horizontal lerp of the texel at pb and its right neighbour
+static inline __m128i LerpPair(CONST BYTE* pb, UINT fx)
+{
+    __m128i pair, weights;
+
+    pair = _mm_unpacklo_epi8(
+        _mm_loadl_epi64((CONST __m128i*) pb), _mm_setzero_si128());
+
+    weights = _mm_set_epi16(
+        (SHORT) fx,         (SHORT) fx,         (SHORT) fx,         (SHORT) fx,
+        (SHORT) (256 - fx), (SHORT) (256 - fx), (SHORT) (256 - fx), (SHORT) (256 - fx));
+
+    pair = _mm_mullo_epi16(pair, weights);
+    pair = _mm_add_epi16(pair, _mm_srli_si128(pair, 8));
+
+    return _mm_srli_epi16(_mm_add_epi16(pair, _mm_set1_epi16(128)), 8);
+}
+
+static inline __m128i Weights2(UINT f0, UINT f1)
+{
+    return _mm_set_epi16(
+        (SHORT) f1, (SHORT) f1, (SHORT) f1, (SHORT) f1,
+        (SHORT) f0, (SHORT) f0, (SHORT) f0, (SHORT) f0);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+static VOID BlitTranslateSse2(
+    BYTE*       pbDst,
+    CONST BYTE* pbSrc,
+    UINT        cPixels,
+    UINT        uAlpha)
+{
+    __m128i zero  = _mm_setzero_si128();
+    __m128i alpha = _mm_set1_epi16((SHORT) uAlpha);
+    __m128i src, dst, lo, hi;
+    UINT    i;
+
+    for (i = 0; i + 4 <= cPixels; i += 4, pbDst += 16, pbSrc += 16) {
+        src = _mm_loadu_si128((CONST __m128i*) pbSrc);
+        dst = _mm_loadu_si128((CONST __m128i*) pbDst);
+
+        lo = Blend(Opacity(_mm_unpacklo_epi8(src, zero), alpha),
+                   _mm_unpacklo_epi8(dst, zero));
+        hi = Blend(Opacity(_mm_unpackhi_epi8(src, zero), alpha),
+                   _mm_unpackhi_epi8(dst, zero));
+
+        _mm_storeu_si128((__m128i*) pbDst, _mm_packus_epi16(lo, hi));
+    }
+
+    for (; i < cPixels; i++, pbDst += 4, pbSrc += 4) {
+        Store1(pbDst, _mm_unpacklo_epi8(LoadPixel(pbSrc), zero), alpha);
+    }
+}
+
+static VOID BlitScaleSse2(
+    BYTE*       pbDst,
+    CONST BYTE* pbRow0,
+    CONST BYTE* pbRow1,
+    UINT        cPixels,
+    LONG        u,
+    LONG        du,
+    UINT        fy,
+    UINT        uAlpha)
+{
+    __m128i alpha   = _mm_set1_epi16((SHORT) uAlpha);
+    __m128i weights = _mm_set1_epi16((SHORT) fy);
+    __m128i top, bottom;
+    UINT    x0, x1, fx0, fx1;
+    UINT    i;
+
+    for (i = 0; i + 2 <= cPixels; i += 2, pbDst += 8) {
+        x0  = (UINT) (u >> FIXED_SHIFT) * 4;
+        fx0 = (UINT) (u >> 8) & 0xFF;
+        u  += du;
+        x1  = (UINT) (u >> FIXED_SHIFT) * 4;
+        fx1 = (UINT) (u >> 8) & 0xFF;
+        u  += du;
+
+        top    = _mm_unpacklo_epi64(LerpPair(pbRow0 + x0, fx0),
+                                    LerpPair(pbRow0 + x1, fx1));
+        bottom = _mm_unpacklo_epi64(LerpPair(pbRow1 + x0, fx0),
+                                    LerpPair(pbRow1 + x1, fx1));
+
+        Store2(pbDst, Lerp(top, bottom, weights), alpha);
+    }
+
+    if (i < cPixels) {
+        x0  = (UINT) (u >> FIXED_SHIFT) * 4;
+        fx0 = (UINT) (u >> 8) & 0xFF;
+
+        Store1(pbDst,
+               Lerp(LerpPair(pbRow0 + x0, fx0),
+                    LerpPair(pbRow1 + x0, fx0),
+                    weights),
+               alpha);
+    }
+}
+
+static VOID BlitAffineSse2(
+    BYTE*               pbDst,
+    CONST BLITSOURCE*   pSource,
+    UINT                cPixels,
+    LONG                u,
+    LONG                v,
+    LONG                du,
+    LONG                dv,
+    UINT                uAlpha)
+{
+    __m128i     alpha   = _mm_set1_epi16((SHORT) uAlpha);
+    UINT        uStride = pSource->uStride;
+    CONST BYTE  *p0, *p1;
+    __m128i     top, bottom;
+    UINT        fx0, fx1, fy0, fy1;
+    UINT        i;
+
+    for (i = 0; i + 2 <= cPixels; i += 2, pbDst += 8) {
+        p0  = pSource->pbPixels + (v >> FIXED_SHIFT) * uStride +
+              (u >> FIXED_SHIFT) * 4;
+        fx0 = (UINT) (u >> 8) & 0xFF;
+        fy0 = (UINT) (v >> 8) & 0xFF;
+        u  += du;
+        v  += dv;
+
+        p1  = pSource->pbPixels + (v >> FIXED_SHIFT) * uStride +
+              (u >> FIXED_SHIFT) * 4;
+        fx1 = (UINT) (u >> 8) & 0xFF;
+        fy1 = (UINT) (v >> 8) & 0xFF;
+        u  += du;
+        v  += dv;
+
+        top    = _mm_unpacklo_epi64(LerpPair(p0, fx0),
+                                    LerpPair(p1, fx1));
+        bottom = _mm_unpacklo_epi64(LerpPair(p0 + uStride, fx0),
+                                    LerpPair(p1 + uStride, fx1));
+
+        Store2(pbDst, Lerp(top, bottom, Weights2(fy0, fy1)), alpha);
+    }
+
+    if (i < cPixels) {
+        p0  = pSource->pbPixels + (v >> FIXED_SHIFT) * uStride +
+              (u >> FIXED_SHIFT) * 4;
+        fx0 = (UINT) (u >> 8) & 0xFF;
+        fy0 = (UINT) (v >> 8) & 0xFF;
+
+        Store1(pbDst,
+               Lerp(LerpPair(p0, fx0),
+                    LerpPair(p0 + uStride, fx0),
+                    _mm_set1_epi16((SHORT) fy0)),
+               alpha);
+    }
+}
+
+CONST BLITKERNELS SSE2_BLIT_KERNELS = {
+    BLIT_LEVEL_SSE2,
+    "sse2",
+    BlitTranslateSse2,
+    BlitScaleSse2,
+    BlitAffineSse2
+};
+
+#endif // FP_ARCH_X86
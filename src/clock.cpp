@@ -0,0 +1,87 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "clock.h"
+
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+// SystemClock
+////////////////////////////////////////////////////////////////////////////
+
+SystemClock::SystemClock()
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency;
+
+    QueryPerformanceFrequency(&frequency);
+    _llFrequency = frequency.QuadPart;
+#else
+    _llFrequency = 1000000000;
+#endif
+}
+
+LONGLONG SystemClock::GetTicks() CONST
+{
+#ifdef _WIN32
+    LARGE_INTEGER counter;
+
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (LONGLONG) ts.tv_sec * 1000000000 + (LONGLONG) ts.tv_nsec;
+#endif
+}
+
+LONGLONG SystemClock::GetFrequency() CONST
+{
+    return _llFrequency;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// ManualClock
+////////////////////////////////////////////////////////////////////////////
+
+ManualClock::ManualClock(LONGLONG llFrequency)
+    : _llFrequency((llFrequency > 0) ? llFrequency : 1),
+      _llTicks(0)
+{
+}
+
+LONGLONG ManualClock::GetTicks() CONST
+{
+    return _llTicks;
+}
+
+LONGLONG ManualClock::GetFrequency() CONST
+{
+    return _llFrequency;
+}
+
+VOID ManualClock::SetTicks(LONGLONG llTicks)
+{
+    _llTicks = llTicks;
+}
+
+VOID ManualClock::Advance(LONGLONG llTicks)
+{
+    _llTicks += llTicks;
+}
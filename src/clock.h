@@ -0,0 +1,77 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CLOCK_H
+#define __CLOCK_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Clock
+//
+// Monotonic tick source. Everything that makes decisions based on time
+// takes a Clock, so it can be driven by a ManualClock instead of the
+// real one.
+////////////////////////////////////////////////////////////////////////////
+
+class Clock {
+public:
+    virtual ~Clock() {}
+
+    virtual LONGLONG GetTicks() CONST = 0;
+
+    virtual LONGLONG GetFrequency() CONST = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////
+// SystemClock - QueryPerformanceCounter on Windows, CLOCK_MONOTONIC
+// everywhere else.
+////////////////////////////////////////////////////////////////////////////
+
+class SystemClock : public Clock {
+public:
+    SystemClock();
+
+    LONGLONG GetTicks() CONST;
+
+    LONGLONG GetFrequency() CONST;
+
+private:
+    LONGLONG    _llFrequency;
+};
+
+////////////////////////////////////////////////////////////////////////////
+// ManualClock - only moves when told to.
+////////////////////////////////////////////////////////////////////////////
+
+class ManualClock : public Clock {
+public:
+    ManualClock(LONGLONG llFrequency = 1000000);
+
+    LONGLONG GetTicks() CONST;
+
+    LONGLONG GetFrequency() CONST;
+
+    VOID SetTicks(LONGLONG llTicks);
+
+    VOID Advance(LONGLONG llTicks);
+
+private:
+    LONGLONG    _llFrequency;
+    LONGLONG    _llTicks;
+};
+
+#endif // __CLOCK_H
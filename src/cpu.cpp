@@ -0,0 +1,107 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpu.h"
+
+#ifdef FP_ARCH_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif // FP_ARCH_X86
+
+#ifdef FP_ARCH_X86
+
+static VOID CpuId(UINT uLeaf, UINT uSubLeaf, UINT* puRegs)
+{
+#ifdef _MSC_VER
+    int regs[4];
+
+    __cpuidex(regs, (int) uLeaf, (int) uSubLeaf);
+
+    puRegs[0] = (UINT) regs[0];
+    puRegs[1] = (UINT) regs[1];
+    puRegs[2] = (UINT) regs[2];
+    puRegs[3] = (UINT) regs[3];
+#else
+    __cpuid_count(uLeaf, uSubLeaf, puRegs[0], puRegs[1], puRegs[2], puRegs[3]);
+#endif
+}
+
+// XCR0, the register state the OS saves on context switches
+static ULONGLONG GetXcr0()
+{
+#ifdef _MSC_VER
+    return (ULONGLONG) _xgetbv(0);
+#else
+    UINT uLow, uHigh;
+
+    __asm__ __volatile__ ("xgetbv" : "=a" (uLow), "=d" (uHigh) : "c" (0));
+
+    return ((ULONGLONG) uHigh << 32) | uLow;
+#endif
+}
+
+static DWORD DetectCpuFeatures()
+{
+    UINT    regs[4];
+    UINT    uMaxLeaf;
+    DWORD   dwFeatures = 0;
+
+    CpuId(0, 0, regs);
+    uMaxLeaf = regs[0];
+
+    if (uMaxLeaf < 1) {
+        return 0;
+    }
+
+    CpuId(1, 0, regs);
+
+    if (regs[3] & (1 << 26)) {
+        dwFeatures |= CPU_FEATURE_SSE2;
+    }
+
+    // AVX2 needs the CPU bit and an OS that saves the YMM registers
+    if ((regs[2] & (1 << 27)) == 0 ||   // OSXSAVE
+        (regs[2] & (1 << 28)) == 0 ||   // AVX
+        (GetXcr0() & 0x6) != 0x6 ||
+        uMaxLeaf < 7)
+    {
+        return dwFeatures;
+    }
+
+    CpuId(7, 0, regs);
+
+    if (regs[1] & (1 << 5)) {
+        dwFeatures |= CPU_FEATURE_AVX2;
+    }
+
+    return dwFeatures;
+}
+
+#endif // FP_ARCH_X86
+
+DWORD GetCpuFeatures()
+{
+#ifdef FP_ARCH_X86
+    static DWORD dwFeatures = DetectCpuFeatures();
+
+    return dwFeatures;
+#else
+    return 0;
+#endif
+}
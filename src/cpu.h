@@ -0,0 +1,38 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CPU_H
+#define __CPU_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Runtime CPU feature detection, used to pick SIMD kernels. Code that
+// needs an instruction set lives in its own translation unit built with
+// the matching compiler flags and is only called when the bit is set.
+////////////////////////////////////////////////////////////////////////////
+
+#if defined(_M_IX86) || defined(_M_X64) || \
+    defined(__i386__) || defined(__x86_64__)
+#define FP_ARCH_X86
+#endif
+
+#define CPU_FEATURE_SSE2    0x00000001
+#define CPU_FEATURE_AVX2    0x00000002
+
+DWORD GetCpuFeatures();
+
+#endif // __CPU_H
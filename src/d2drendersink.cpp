@@ -0,0 +1,225 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "d2drendersink.h"
+
+#include <d2d1helper.h>
+
+#include "safemem.h"
+
+static D2D1_MATRIX_3X2_F ToD2DMatrix(CONST Geometry::Matrix& matrix)
+{
+    D2D1_MATRIX_3X2_F d2dMatrix;
+
+    d2dMatrix._11 = matrix._11; d2dMatrix._12 = matrix._12;
+    d2dMatrix._21 = matrix._21; d2dMatrix._22 = matrix._22;
+    d2dMatrix._31 = matrix._31; d2dMatrix._32 = matrix._32;
+
+    return d2dMatrix;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// D2DRenderBitmap
+////////////////////////////////////////////////////////////////////////////
+
+D2DRenderBitmap::D2DRenderBitmap(ID2D1Bitmap* pBitmap)
+    : _pBitmap(pBitmap)
+{
+}
+
+D2DRenderBitmap::~D2DRenderBitmap()
+{
+    SafeRelease(&_pBitmap);
+}
+
+UINT D2DRenderBitmap::GetWidth() CONST
+{
+    return _pBitmap->GetPixelSize().width;
+}
+
+UINT D2DRenderBitmap::GetHeight() CONST
+{
+    return _pBitmap->GetPixelSize().height;
+}
+
+ID2D1Bitmap* D2DRenderBitmap::GetBitmap()
+{
+    return _pBitmap;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// D2DRenderSink
+////////////////////////////////////////////////////////////////////////////
+
+D2DRenderSink::D2DRenderSink()
+    : _pRenderTarget(NULL),
+      _pBrush(NULL)
+{
+}
+
+D2DRenderSink::~D2DRenderSink()
+{
+    SafeRelease(&_pBrush);
+    SafeRelease(&_pRenderTarget);
+}
+
+HRESULT D2DRenderSink::CreateBitmap(
+    UINT            uWidth,
+    UINT            uHeight,
+    UINT            uStride,
+    CONST BYTE*     pbPixels,
+    RenderBitmap**  ppBitmap)
+{
+    D2D1_BITMAP_PROPERTIES  bitmapProps;
+    ID2D1Bitmap*            pBitmap = NULL;
+    HRESULT                 hResult = S_OK;
+
+    if (ppBitmap == NULL || pbPixels == NULL) {
+        return E_INVALIDARG;
+    }
+
+    bitmapProps = D2D1::BitmapProperties(D2D1::PixelFormat(
+        DXGI_FORMAT_B8G8R8A8_UNORM,
+        D2D1_ALPHA_MODE_PREMULTIPLIED));
+
+    hResult = _pRenderTarget->CreateBitmap(
+        D2D1::SizeU(uWidth, uHeight),
+        pbPixels,
+        uStride,
+        bitmapProps,
+        &pBitmap);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    *ppBitmap = new D2DRenderBitmap(pBitmap);
+
+    if (*ppBitmap == NULL) {
+        SafeRelease(&pBitmap);
+        return E_OUTOFMEMORY;
+    }
+
+    return S_OK;
+}
+
+Geometry::Size D2DRenderSink::GetSize() CONST
+{
+    D2D1_SIZE_F size = _pRenderTarget->GetSize();
+
+    return Geometry::MakeSize(size.width, size.height);
+}
+
+VOID D2DRenderSink::BeginDraw()
+{
+    _pRenderTarget->BeginDraw();
+}
+
+HRESULT D2DRenderSink::EndDraw()
+{
+    return _pRenderTarget->EndDraw();
+}
+
+VOID D2DRenderSink::PushClip(CONST Geometry::Rect& rect)
+{
+    _pRenderTarget->PushAxisAlignedClip(
+        D2D1::RectF(rect.left, rect.top, rect.right, rect.bottom),
+        D2D1_ANTIALIAS_MODE_ALIASED);
+}
+
+VOID D2DRenderSink::PopClip()
+{
+    _pRenderTarget->PopAxisAlignedClip();
+}
+
+VOID D2DRenderSink::Clear()
+{
+    _pRenderTarget->Clear();
+}
+
+VOID D2DRenderSink::DrawBitmap(
+    RenderBitmap*           pBitmap,
+    CONST Geometry::Matrix& transform,
+    FLOAT                   fOpacity)
+{
+    D2D1_MATRIX_3X2_F oldTransform, newTransform;
+
+    if (pBitmap == NULL) {
+        return;
+    }
+
+    _pRenderTarget->GetTransform(&oldTransform);
+
+    newTransform = ToD2DMatrix(transform);
+    _pRenderTarget->SetTransform(&newTransform);
+
+    _pRenderTarget->DrawBitmap(
+        ((D2DRenderBitmap*) pBitmap)->GetBitmap(),
+        NULL,
+        fOpacity,
+        D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
+        NULL);
+
+    _pRenderTarget->SetTransform(&oldTransform);
+}
+
+VOID D2DRenderSink::FillEllipse(
+    CONST Geometry::Point&  center,
+    FLOAT                   fRadiusX,
+    FLOAT                   fRadiusY,
+    CONST RENDERCOLOR&      color)
+{
+    _pBrush->SetColor(D2D1::ColorF(color.r, color.g, color.b, color.a));
+
+    _pRenderTarget->FillEllipse(
+        D2D1::Ellipse(D2D1::Point2F(center.x, center.y), fRadiusX, fRadiusY),
+        _pBrush);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+HRESULT D2DRenderSink::CreateD2DRenderSink(
+    ID2D1RenderTarget*  pRenderTarget,
+    D2DRenderSink**     ppSink)
+{
+    D2DRenderSink*  pSink = NULL;
+    HRESULT         hResult = S_OK;
+
+    if (pRenderTarget == NULL || ppSink == NULL) {
+        return E_INVALIDARG;
+    }
+
+    pSink = new D2DRenderSink();
+
+    if (pSink == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    pSink->_pRenderTarget = pRenderTarget;
+    pSink->_pRenderTarget->AddRef();
+
+    hResult = pRenderTarget->CreateSolidColorBrush(
+        D2D1::ColorF(D2D1::ColorF::Black),
+        &(pSink->_pBrush));
+
+    if (SUCCEEDED(hResult)) {
+        *ppSink = pSink;
+    } else {
+        delete pSink;
+    }
+
+    return hResult;
+}
@@ -0,0 +1,82 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __D2DRENDERSINK_H
+#define __D2DRENDERSINK_H
+
+#include <Windows.h>
+#include <d2d1.h>
+
+#include "platform.h"
+
+class D2DRenderBitmap : public RenderBitmap {
+public:
+    D2DRenderBitmap(ID2D1Bitmap* pBitmap);
+    ~D2DRenderBitmap();
+
+    UINT GetWidth() CONST;
+    UINT GetHeight() CONST;
+
+    ID2D1Bitmap* GetBitmap();
+
+private:
+    ID2D1Bitmap*    _pBitmap;
+};
+
+class D2DRenderSink : public RenderSink {
+public:
+    static HRESULT CreateD2DRenderSink(
+        ID2D1RenderTarget*  pRenderTarget,
+        D2DRenderSink**     ppSink);
+
+    ~D2DRenderSink();
+
+    HRESULT CreateBitmap(
+        UINT            uWidth,
+        UINT            uHeight,
+        UINT            uStride,
+        CONST BYTE*     pbPixels,
+        RenderBitmap**  ppBitmap);
+
+    Geometry::Size GetSize() CONST;
+
+    VOID BeginDraw();
+    HRESULT EndDraw();
+
+    VOID PushClip(CONST Geometry::Rect& rect);
+    VOID PopClip();
+
+    VOID Clear();
+
+    VOID DrawBitmap(
+        RenderBitmap*           pBitmap,
+        CONST Geometry::Matrix& transform,
+        FLOAT                   fOpacity);
+
+    VOID FillEllipse(
+        CONST Geometry::Point&  center,
+        FLOAT                   fRadiusX,
+        FLOAT                   fRadiusY,
+        CONST RENDERCOLOR&      color);
+
+private:
+    D2DRenderSink();
+
+    ID2D1RenderTarget*      _pRenderTarget;
+    ID2D1SolidColorBrush*   _pBrush;
+};
+
+#endif // __D2DRENDERSINK_H
@@ -0,0 +1,144 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "damage.h"
+
+DamageTracker::DamageTracker()
+    : _cRects(0),
+      _bFullFrame(TRUE)
+{
+    UINT i;
+
+    _surface = Geometry::MakeRect(0.0f, 0.0f, 0.0f, 0.0f);
+
+    for (i = 0; i < DAMAGE_MAX_SLOTS; i++) {
+        _slots[i] = Geometry::MakeRect(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+}
+
+VOID DamageTracker::SetSurfaceSize(FLOAT fWidth, FLOAT fHeight)
+{
+    _surface = Geometry::MakeRect(0.0f, 0.0f, fWidth, fHeight);
+    InvalidateAll();
+}
+
+VOID DamageTracker::Track(UINT uSlot, CONST Geometry::Rect& bounds)
+{
+    if (uSlot >= DAMAGE_MAX_SLOTS) {
+        InvalidateAll();
+        return;
+    }
+
+    if (bounds.left   == _slots[uSlot].left  &&
+        bounds.top    == _slots[uSlot].top   &&
+        bounds.right  == _slots[uSlot].right &&
+        bounds.bottom == _slots[uSlot].bottom) {
+        return;
+    }
+
+    AddRect(_slots[uSlot]);
+    AddRect(bounds);
+
+    _slots[uSlot] = bounds;
+}
+
+VOID DamageTracker::InvalidateAll()
+{
+    _bFullFrame = TRUE;
+}
+
+UINT DamageTracker::GetRectCount() CONST
+{
+    return (_bFullFrame == TRUE) ? 1 : _cRects;
+}
+
+CONST Geometry::Rect* DamageTracker::GetRects() CONST
+{
+    return (_bFullFrame == TRUE) ? &_surface : _rects;
+}
+
+Geometry::Rect DamageTracker::GetBounds() CONST
+{
+    Geometry::Rect  bounds = Geometry::MakeRect(0.0f, 0.0f, 0.0f, 0.0f);
+    UINT            i;
+
+    if (_bFullFrame == TRUE) {
+        return _surface;
+    }
+
+    for (i = 0; i < _cRects; i++) {
+        bounds = Geometry::Union(bounds, _rects[i]);
+    }
+
+    return bounds;
+}
+
+VOID DamageTracker::Reset()
+{
+    _cRects = 0;
+    _bFullFrame = FALSE;
+}
+
+VOID DamageTracker::AddRect(CONST Geometry::Rect& rect)
+{
+    Geometry::Rect  damage;
+    Geometry::Rect  merged;
+    FLOAT           fCost, fBestCost;
+    UINT            i, uBest;
+
+    if (_bFullFrame == TRUE) {
+        return;
+    }
+
+    // One pixel of slack for bilinear filtering and antialiased edges
+    damage = Geometry::RoundOut(Geometry::Inflate(rect, 1.0f));
+    damage = Geometry::Intersect(damage, _surface);
+
+    if (Geometry::IsEmpty(damage)) {
+        return;
+    }
+
+    // Swallow every rectangle the new one touches, restarting because
+    // the grown rectangle may now reach ones that were checked already
+    for (i = 0; i < _cRects; i++) {
+        if (Geometry::Intersects(damage, _rects[i])) {
+            damage = Geometry::Union(damage, _rects[i]);
+            _rects[i] = _rects[--_cRects];
+            i = (UINT) -1;
+        }
+    }
+
+    if (_cRects < DAMAGE_MAX_RECTS) {
+        _rects[_cRects++] = damage;
+        return;
+    }
+
+    // Out of rectangles: merge with whichever one grows the least
+    uBest = 0;
+    fBestCost = 0.0f;
+
+    for (i = 0; i < _cRects; i++) {
+        merged = Geometry::Union(damage, _rects[i]);
+        fCost = Geometry::Area(merged) - Geometry::Area(_rects[i]);
+
+        if (i == 0 || fCost < fBestCost) {
+            uBest = i;
+            fBestCost = fCost;
+        }
+    }
+
+    _rects[uBest] = Geometry::Union(damage, _rects[uBest]);
+}
@@ -0,0 +1,62 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __DAMAGE_H
+#define __DAMAGE_H
+
+#include "wintypes.h"
+#include "geometry.h"
+
+#define DAMAGE_MAX_SLOTS    8
+#define DAMAGE_MAX_RECTS    4
+
+////////////////////////////////////////////////////////////////////////////
+// DamageTracker
+//
+// Every drawable owns a slot and reports its screen-space bounds once per
+// frame. The damaged region is the union of each slot's previous and new
+// bounds, kept as at most DAMAGE_MAX_RECTS pixel-aligned rectangles
+// clipped to the surface.
+////////////////////////////////////////////////////////////////////////////
+
+class DamageTracker {
+public:
+    DamageTracker();
+
+    VOID SetSurfaceSize(FLOAT fWidth, FLOAT fHeight);
+
+    VOID Track(UINT uSlot, CONST Geometry::Rect& bounds);
+
+    VOID InvalidateAll();
+
+    UINT GetRectCount() CONST;
+    CONST Geometry::Rect* GetRects() CONST;
+
+    Geometry::Rect GetBounds() CONST;
+
+    VOID Reset();
+
+private:
+    VOID AddRect(CONST Geometry::Rect& rect);
+
+    Geometry::Rect  _surface;
+    Geometry::Rect  _slots[DAMAGE_MAX_SLOTS];
+    Geometry::Rect  _rects[DAMAGE_MAX_RECTS];
+    UINT            _cRects;
+    BOOL            _bFullFrame;
+};
+
+#endif // __DAMAGE_H
@@ -0,0 +1,161 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "deltaaccumulator.h"
+
+#include <math.h>
+
+#include "portablemath.h"
+
+// Close to Windows with "Enhance pointer precision" off at the default
+// speed, plus a gentle boost for fast flicks
+#define DEFAULT_SENSITIVITY     1.0f
+#define DEFAULT_SLOW_SPEED      400.0f
+#define DEFAULT_FAST_SPEED      4000.0f
+#define DEFAULT_MAX_GAIN        2.0f
+
+// Packets closer than this or further apart than that count as this
+// close or that far; the first after a pause is a slow one
+#define MIN_PACKET_INTERVAL     (1.0f / 8000.0f)    // Seconds
+#define MAX_PACKET_INTERVAL     (1.0f / 30.0f)
+
+#define SPEED_SMOOTHING         0.008f              // Seconds
+
+DeltaAccumulator::DeltaAccumulator(Clock* pClock)
+    : _pClock(pClock),
+      _fDeltaX(0.0),
+      _fDeltaY(0.0),
+      _fSpeed(0.0f),
+      _llLastTime(0),
+      _bMoved(FALSE)
+{
+    _acceleration.fSensitivity = DEFAULT_SENSITIVITY;
+    _acceleration.fSlowSpeed = DEFAULT_SLOW_SPEED;
+    _acceleration.fFastSpeed = DEFAULT_FAST_SPEED;
+    _acceleration.fMaxGain = DEFAULT_MAX_GAIN;
+}
+
+VOID DeltaAccumulator::SetAcceleration(
+    CONST POINTERACCELERATION& acceleration)
+{
+    _acceleration = acceleration;
+
+    if (_acceleration.fMaxGain < 1.0f) {
+        _acceleration.fMaxGain = 1.0f;
+    }
+
+    if (_acceleration.fFastSpeed <= _acceleration.fSlowSpeed) {
+        _acceleration.fFastSpeed = _acceleration.fSlowSpeed + 1.0f;
+    }
+}
+
+VOID DeltaAccumulator::GetAcceleration(
+    POINTERACCELERATION* pAcceleration) CONST
+{
+    if (pAcceleration != NULL) {
+        *pAcceleration = _acceleration;
+    }
+}
+
+VOID DeltaAccumulator::AddCounts(LONG lCountsX, LONG lCountsY)
+{
+    LONGLONG    llTime = _pClock->GetTicks();
+    FLOAT       fInterval = MAX_PACKET_INTERVAL;
+    FLOAT       fDistance, fScale;
+
+    if (lCountsX == 0 && lCountsY == 0) {
+        return;
+    }
+
+    if (_llLastTime != 0) {
+        fInterval = (FLOAT) (llTime - _llLastTime) /
+                    (FLOAT) _pClock->GetFrequency();
+        fInterval = fmaxf(MIN_PACKET_INTERVAL,
+                          fminf(fInterval, MAX_PACKET_INTERVAL));
+    }
+
+    // Speed from single packets jumps by whole counts, so it is
+    // smoothed over a few of them, independent of the polling rate
+    fDistance = sqrtf((FLOAT) lCountsX * lCountsX +
+                      (FLOAT) lCountsY * lCountsY);
+
+    _fSpeed += (fDistance / fInterval - _fSpeed) *
+               (1.0f - PortableExpf(-fInterval / SPEED_SMOOTHING));
+
+    fScale = _acceleration.fSensitivity * GetGain();
+
+    _fDeltaX += (DOUBLE) lCountsX * fScale;
+    _fDeltaY += (DOUBLE) lCountsY * fScale;
+    _llLastTime = llTime;
+    _bMoved = TRUE;
+}
+
+VOID DeltaAccumulator::AddPixels(FLOAT fDeltaX, FLOAT fDeltaY)
+{
+    if (fDeltaX == 0.0f && fDeltaY == 0.0f) {
+        return;
+    }
+
+    _fDeltaX += fDeltaX;
+    _fDeltaY += fDeltaY;
+    _llLastTime = _pClock->GetTicks();
+    _bMoved = TRUE;
+}
+
+BOOL DeltaAccumulator::TakeDelta(FLOAT* pfDeltaX, FLOAT* pfDeltaY)
+{
+    if (_bMoved == FALSE) {
+        return FALSE;
+    }
+
+    *pfDeltaX = (FLOAT) _fDeltaX;
+    *pfDeltaY = (FLOAT) _fDeltaY;
+
+    // Keep what the FLOATs rounded away
+    _fDeltaX -= *pfDeltaX;
+    _fDeltaY -= *pfDeltaY;
+    _bMoved = FALSE;
+
+    return TRUE;
+}
+
+LONGLONG DeltaAccumulator::GetLastTime() CONST
+{
+    return _llLastTime;
+}
+
+VOID DeltaAccumulator::Reset()
+{
+    _fDeltaX = 0.0;
+    _fDeltaY = 0.0;
+    _fSpeed = 0.0f;
+    _llLastTime = 0;
+    _bMoved = FALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+// Smoothstep from 1 at fSlowSpeed to fMaxGain at fFastSpeed
+FLOAT DeltaAccumulator::GetGain() CONST
+{
+    FLOAT t;
+
+    t = (_fSpeed - _acceleration.fSlowSpeed) /
+        (_acceleration.fFastSpeed - _acceleration.fSlowSpeed);
+    t = fmaxf(0.0f, fminf(t, 1.0f));
+
+    return 1.0f + (_acceleration.fMaxGain - 1.0f) * t * t * (3.0f - 2.0f * t);
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __DELTAACCUMULATOR_H
+#define __DELTAACCUMULATOR_H
+
+#include "wintypes.h"
+#include "clock.h"
+
+////////////////////////////////////////////////////////////////////////////
+// DeltaAccumulator
+//
+// Collects relative mouse motion as fast as the device reports it and
+// hands it out once per frame. Raw counts go through the acceleration
+// curve one packet at a time, so the curve sees the real device rate no
+// matter how often frames are drawn. Motion adds up in doubles and
+// whatever a FLOAT cannot carry stays for the next frame, so nothing is
+// lost to rounding however slowly the mouse moves.
+////////////////////////////////////////////////////////////////////////////
+
+typedef struct _POINTERACCELERATION {
+    FLOAT   fSensitivity;   // Pixels per count
+    FLOAT   fSlowSpeed;     // Counts per second where the gain rises
+    FLOAT   fFastSpeed;     // Counts per second where it is fMaxGain
+    FLOAT   fMaxGain;       // 1 turns acceleration off
+} POINTERACCELERATION;
+
+class DeltaAccumulator {
+public:
+    DeltaAccumulator(Clock* pClock);
+
+    VOID SetAcceleration(CONST POINTERACCELERATION& acceleration);
+    VOID GetAcceleration(POINTERACCELERATION* pAcceleration) CONST;
+
+    // One device packet of raw counts, stamped with the clock
+    VOID AddCounts(LONG lCountsX, LONG lCountsY);
+
+    // Motion already in pixels, with the system's acceleration applied
+    VOID AddPixels(FLOAT fDeltaX, FLOAT fDeltaY);
+
+    // Everything since the last call; FALSE when nothing moved
+    BOOL TakeDelta(FLOAT* pfDeltaX, FLOAT* pfDeltaY);
+
+    // Clock ticks of the last packet
+    LONGLONG GetLastTime() CONST;
+
+    // Drops pending motion and the speed estimate
+    VOID Reset();
+
+private:
+    FLOAT GetGain() CONST;
+
+    Clock*              _pClock;
+    POINTERACCELERATION _acceleration;
+    DOUBLE              _fDeltaX;
+    DOUBLE              _fDeltaY;
+    FLOAT               _fSpeed;        // Smoothed, counts per second
+    LONGLONG            _llLastTime;
+    BOOL                _bMoved;
+};
+
+#endif // __DELTAACCUMULATOR_H
@@ -0,0 +1,141 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "easing.h"
+#include "cpu.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Easing table
+//
+// The error bounds are what fp_test "easing" measures over a fine grid,
+// rounded up; it fails when an easing goes past them. Fast() only
+// differs from operator() where that calls libm, and then by about 1e-6.
+// The tables are worst where the curve bends hardest: the square roots
+// of the circ easings are vertical at one end and miss by up to 0.03.
+////////////////////////////////////////////////////////////////////////////
+
+#define EASING_INFO(Name, fFastError, fTableError)  \
+    {                                               \
+        #Name,                                      \
+        Easing::Function<Easing::Name>,             \
+        Easing::FastFunction<Easing::Name>,         \
+        fFastError,                                 \
+        fTableError                                 \
+    }
+
+static CONST EASINGINFO EASINGS[EASING_COUNT] = {
+    EASING_INFO(InSine,        1e-6f,  1e-5f),
+    EASING_INFO(OutSine,       1e-6f,  1e-5f),
+    EASING_INFO(InOutSine,     1e-6f,  2e-5f),
+    EASING_INFO(InQuad,        0.0f,   1e-5f),
+    EASING_INFO(OutQuad,       0.0f,   1e-5f),
+    EASING_INFO(InOutQuad,     0.0f,   1e-5f),
+    EASING_INFO(InCubic,       0.0f,   2e-5f),
+    EASING_INFO(OutCubic,      0.0f,   2e-5f),
+    EASING_INFO(InOutCubic,    0.0f,   3e-5f),
+    EASING_INFO(InQuart,       0.0f,   3e-5f),
+    EASING_INFO(OutQuart,      0.0f,   3e-5f),
+    EASING_INFO(InOutQuart,    0.0f,   6e-5f),
+    EASING_INFO(InQuint,       0.0f,   5e-5f),
+    EASING_INFO(OutQuint,      0.0f,   5e-5f),
+    EASING_INFO(InOutQuint,    0.0f,   1e-4f),
+    EASING_INFO(InExpo,        3e-7f,  2e-3f),
+    EASING_INFO(OutExpo,       3e-7f,  2e-3f),
+    EASING_INFO(InOutExpo,     3e-7f,  1e-3f),
+    EASING_INFO(InCirc,        0.0f,   3e-2f),
+    EASING_INFO(OutCirc,       0.0f,   3e-2f),
+    EASING_INFO(InOutCirc,     0.0f,   2e-2f),
+    EASING_INFO(InBack,        0.0f,   3e-5f),
+    EASING_INFO(OutBack,       0.0f,   3e-5f),
+    EASING_INFO(InOutBack,     0.0f,   1e-4f),
+    EASING_INFO(InElastic,     2e-6f,  1e-3f),
+    EASING_INFO(OutElastic,    2e-6f,  1e-3f),
+    EASING_INFO(InOutElastic,  2e-6f,  1e-3f),
+    EASING_INFO(InBounce,      0.0f,   4e-3f),
+    EASING_INFO(OutBounce,     0.0f,   4e-3f),
+    EASING_INFO(InOutBounce,   0.0f,   1e-2f),
+};
+
+#undef EASING_INFO
+
+CONST EASINGINFO* GetEasingInfo(EASING easing)
+{
+    if ((UINT) easing >= EASING_COUNT) {
+        return NULL;
+    }
+
+    return &EASINGS[easing];
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Scalar kernels
+////////////////////////////////////////////////////////////////////////////
+
+template<class Ease>
+static VOID EaseBatchScalar(CONST FLOAT* pfX, FLOAT* pfY, UINT cValues)
+{
+    UINT i;
+
+    for (i = 0; i < cValues; i++) {
+        pfY[i] = Ease::Fast(pfX[i]);
+    }
+}
+
+#define EASING_BATCH_ENTRY(Id, Name)    EaseBatchScalar<Easing::Name>,
+
+static CONST EASINGKERNELS SCALAR_EASING_KERNELS = {
+    EASING_LEVEL_SCALAR,
+    "scalar",
+    {
+        EASING_LIST(EASING_BATCH_ENTRY)
+    }
+};
+
+#undef EASING_BATCH_ENTRY
+
+////////////////////////////////////////////////////////////////////////////
+
+CONST EASINGKERNELS* GetEasingKernelsForLevel(EASINGLEVEL level)
+{
+    switch (level) {
+        case EASING_LEVEL_SCALAR:
+            return &SCALAR_EASING_KERNELS;
+#ifdef FP_ARCH_X86
+        case EASING_LEVEL_SSE2:
+            if (GetCpuFeatures() & CPU_FEATURE_SSE2) {
+                return &SSE2_EASING_KERNELS;
+            }
+            break;
+#endif // FP_ARCH_X86
+        default:
+            break;
+    }
+
+    return NULL;
+}
+
+CONST EASINGKERNELS* GetEasingKernels()
+{
+    CONST EASINGKERNELS* pKernels;
+
+    pKernels = GetEasingKernelsForLevel(EASING_LEVEL_SSE2);
+
+    if (pKernels == NULL) {
+        pKernels = GetEasingKernelsForLevel(EASING_LEVEL_SCALAR);
+    }
+
+    return pKernels;
+}
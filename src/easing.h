@@ -17,8 +17,9 @@
 #ifndef __EASING_H
 #define __EASING_H
 
-#include <Windows.h>
+#include "wintypes.h"
 #include <math.h>
+#include <string.h>
 
 typedef FLOAT (*PFNEASING)(FLOAT x);
 
@@ -32,9 +33,475 @@ static inline FLOAT Linear(FLOAT x)
 // https://easings.net/#easeOutCirc
 static inline FLOAT EaseOutCirc(FLOAT x)
 {
-    return sqrtf(1.0f - powf(x - 1.0f, 2.0f));
+    // sqrtf is exact everywhere, powf is not
+    return sqrtf(1.0f - (x - 1.0f) * (x - 1.0f));
 }
 
+////////////////////////////////////////////////////////////////////////////
+// The easings.net family
+//
+// Each easing is a functor, so templates that take one as a type inline
+// it; Function<Ease> is the same easing as a PFNEASING. operator() is
+// the formula from easings.net, with libm for sin, cos and powers of 2.
+//
+// Fast() is the same curve made of basic float operations only, with
+// both sides of every branch computed and one picked by Select(). It
+// runs on a FLOAT or, in easing_sse2.cpp, on four lanes at once, giving
+// the same bits either way. The sine, expo and elastic easings use the
+// minimax polynomials below and stay within GetEasingInfo()'s
+// fFastError of operator(); the rest are polynomials or square roots
+// already and Fast() is what operator() calls.
+//
+// EasingTable is the third way: linear interpolation in a table of
+// samples, within fTableError for the default 256 segments.
+////////////////////////////////////////////////////////////////////////////
+
+#define EASING_PI               3.14159265f
+
+#define EASING_BACK_C1          1.70158f
+#define EASING_BACK_C2          (EASING_BACK_C1 * 1.525f)
+#define EASING_BACK_C3          (EASING_BACK_C1 + 1.0f)
+
+#define EASING_BOUNCE_N1        7.5625f
+#define EASING_BOUNCE_D1        2.75f
+
+// Lane primitives for a single FLOAT; easing_sse2.cpp has the same set
+// for four
+
+static inline BOOL Less(FLOAT a, FLOAT b)
+{
+    return a < b;
+}
+
+static inline BOOL Equal(FLOAT a, FLOAT b)
+{
+    return a == b;
+}
+
+static inline FLOAT Select(BOOL bCondition, FLOAT a, FLOAT b)
+{
+    return bCondition ? a : b;
+}
+
+static inline FLOAT Sqrt(FLOAT x)
+{
+    return sqrtf(x);
+}
+
+static inline FLOAT Floor(FLOAT x)
+{
+    return floorf(x);
+}
+
+// p * 2^k for a whole k in -126..127, 2^k built from its exponent bits
+static inline FLOAT ScaleByPow2(FLOAT p, FLOAT k)
+{
+    UINT    uBits = (UINT) ((int) k + 127) << 23;
+    FLOAT   fScale;
+
+    memcpy(&fScale, &uBits, sizeof(fScale));
+
+    return p * fScale;
+}
+
+// sin(u * pi / 2) for u in -1..1, odd minimax polynomial of degree 7;
+// within 6e-7
+template<class T>
+static inline T FastSinHalfPi(T u)
+{
+    T u2 = u * u;
+
+    return u * (T(1.57079101f) + u2 * (T(-0.645892859f) +
+           u2 * (T(0.0794343427f) + u2 * T(-0.00433309516f))));
+}
+
+// sin(2 pi t) for any t that fits an int
+template<class T>
+static inline T FastSinTurns(T t)
+{
+    T q;
+
+    // Quarter turns in -2..2, folded onto -1..1 by sin(pi - a) = sin(a)
+    q = (t - Floor(t + T(0.5f))) * T(4.0f);
+    q = Select(Less(T(1.0f), q), T(2.0f) - q, q);
+    q = Select(Less(q, T(-1.0f)), T(-2.0f) - q, q);
+
+    return FastSinHalfPi(q);
+}
+
+// 2^y for y in -126..127, minimax polynomial of degree 5 on the
+// fraction; within 1.1e-7 relative
+template<class T>
+static inline T FastExp2(T y)
+{
+    T k = Floor(y);
+    T f = y - k;
+    T p;
+
+    p = T(0.999999881f) + f * (T(0.693154752f) + f * (T(0.240139708f) +
+        f * (T(0.0558662452f) + f * (T(0.00894282945f) +
+        f * T(0.00189646112f)))));
+
+    return ScaleByPow2(p, k);
+}
+
+// Shared by the three bounce easings
+template<class T>
+static inline T FastOutBounce(T x)
+{
+    T a = T(EASING_BOUNCE_N1) * x * x;
+    T b, c, d;
+
+    b = x - T(1.5f / EASING_BOUNCE_D1);
+    b = T(EASING_BOUNCE_N1) * b * b + T(0.75f);
+
+    c = x - T(2.25f / EASING_BOUNCE_D1);
+    c = T(EASING_BOUNCE_N1) * c * c + T(0.9375f);
+
+    d = x - T(2.625f / EASING_BOUNCE_D1);
+    d = T(EASING_BOUNCE_N1) * d * d + T(0.984375f);
+
+    return Select(Less(x, T(1.0f / EASING_BOUNCE_D1)), a,
+           Select(Less(x, T(2.0f / EASING_BOUNCE_D1)), b,
+           Select(Less(x, T(2.5f / EASING_BOUNCE_D1)), c, d)));
+}
+
+// Defines an easing whose Fast() is all operator() needs
+#define DEFINE_POLYNOMIAL_EASING(Name, Formula)                     \
+    struct Name {                                                   \
+        template<class T>                                           \
+        static inline T Fast(T x)                                   \
+        {                                                           \
+            return Formula;                                         \
+        }                                                           \
+                                                                    \
+        FLOAT operator()(FLOAT x) CONST                             \
+        {                                                           \
+            return Fast(x);                                         \
+        }                                                           \
+    }
+
+// Defines an easing with a libm formula and a Fast() approximation
+#define DEFINE_TRANSCENDENTAL_EASING(Name, Formula, FastFormula)    \
+    struct Name {                                                   \
+        template<class T>                                           \
+        static inline T Fast(T x)                                   \
+        {                                                           \
+            return FastFormula;                                     \
+        }                                                           \
+                                                                    \
+        FLOAT operator()(FLOAT x) CONST                             \
+        {                                                           \
+            return Formula;                                         \
+        }                                                           \
+    }
+
+// https://easings.net/#easeInSine and on, in the site's order
+
+DEFINE_TRANSCENDENTAL_EASING(InSine,
+    1.0f - cosf(x * EASING_PI / 2.0f),
+    T(1.0f) - FastSinHalfPi(T(1.0f) - x));
+
+DEFINE_TRANSCENDENTAL_EASING(OutSine,
+    sinf(x * EASING_PI / 2.0f),
+    FastSinHalfPi(x));
+
+DEFINE_TRANSCENDENTAL_EASING(InOutSine,
+    -(cosf(EASING_PI * x) - 1.0f) / 2.0f,
+    (T(1.0f) - FastSinHalfPi(T(1.0f) - x * T(2.0f))) * T(0.5f));
+
+DEFINE_POLYNOMIAL_EASING(InQuad,
+    x * x);
+
+DEFINE_POLYNOMIAL_EASING(OutQuad,
+    T(1.0f) - (T(1.0f) - x) * (T(1.0f) - x));
+
+DEFINE_POLYNOMIAL_EASING(InOutQuad,
+    Select(Less(x, T(0.5f)),
+           T(2.0f) * x * x,
+           T(1.0f) - (T(2.0f) - T(2.0f) * x) * (T(2.0f) - T(2.0f) * x) *
+                     T(0.5f)));
+
+DEFINE_POLYNOMIAL_EASING(InCubic,
+    x * x * x);
+
+DEFINE_POLYNOMIAL_EASING(OutCubic,
+    T(1.0f) - (T(1.0f) - x) * (T(1.0f) - x) * (T(1.0f) - x));
+
+DEFINE_POLYNOMIAL_EASING(InOutCubic,
+    Select(Less(x, T(0.5f)),
+           T(4.0f) * x * x * x,
+           T(1.0f) - (T(2.0f) - T(2.0f) * x) * (T(2.0f) - T(2.0f) * x) *
+                     (T(2.0f) - T(2.0f) * x) * T(0.5f)));
+
+DEFINE_POLYNOMIAL_EASING(InQuart,
+    x * x * x * x);
+
+DEFINE_POLYNOMIAL_EASING(OutQuart,
+    T(1.0f) - (T(1.0f) - x) * (T(1.0f) - x) *
+              (T(1.0f) - x) * (T(1.0f) - x));
+
+DEFINE_POLYNOMIAL_EASING(InOutQuart,
+    Select(Less(x, T(0.5f)),
+           T(8.0f) * x * x * x * x,
+           T(1.0f) - (T(2.0f) - T(2.0f) * x) * (T(2.0f) - T(2.0f) * x) *
+                     (T(2.0f) - T(2.0f) * x) * (T(2.0f) - T(2.0f) * x) *
+                     T(0.5f)));
+
+DEFINE_POLYNOMIAL_EASING(InQuint,
+    x * x * x * x * x);
+
+DEFINE_POLYNOMIAL_EASING(OutQuint,
+    T(1.0f) - (T(1.0f) - x) * (T(1.0f) - x) * (T(1.0f) - x) *
+              (T(1.0f) - x) * (T(1.0f) - x));
+
+DEFINE_POLYNOMIAL_EASING(InOutQuint,
+    Select(Less(x, T(0.5f)),
+           T(16.0f) * x * x * x * x * x,
+           T(1.0f) - (T(2.0f) - T(2.0f) * x) * (T(2.0f) - T(2.0f) * x) *
+                     (T(2.0f) - T(2.0f) * x) * (T(2.0f) - T(2.0f) * x) *
+                     (T(2.0f) - T(2.0f) * x) * T(0.5f)));
+
+DEFINE_TRANSCENDENTAL_EASING(InExpo,
+    (x == 0.0f) ? 0.0f : powf(2.0f, 10.0f * x - 10.0f),
+    Select(Equal(x, T(0.0f)), T(0.0f),
+           FastExp2(T(10.0f) * x - T(10.0f))));
+
+DEFINE_TRANSCENDENTAL_EASING(OutExpo,
+    (x == 1.0f) ? 1.0f : 1.0f - powf(2.0f, -10.0f * x),
+    Select(Equal(x, T(1.0f)), T(1.0f),
+           T(1.0f) - FastExp2(T(-10.0f) * x)));
+
+DEFINE_TRANSCENDENTAL_EASING(InOutExpo,
+    (x == 0.0f) ? 0.0f :
+    (x == 1.0f) ? 1.0f :
+    (x < 0.5f)  ? powf(2.0f, 20.0f * x - 10.0f) / 2.0f
+                : (2.0f - powf(2.0f, -20.0f * x + 10.0f)) / 2.0f,
+    Select(Equal(x, T(0.0f)), T(0.0f),
+    Select(Equal(x, T(1.0f)), T(1.0f),
+    Select(Less(x, T(0.5f)),
+           FastExp2(T(20.0f) * x - T(10.0f)) * T(0.5f),
+           (T(2.0f) - FastExp2(T(10.0f) - T(20.0f) * x)) * T(0.5f)))));
+
+DEFINE_POLYNOMIAL_EASING(InCirc,
+    T(1.0f) - Sqrt(T(1.0f) - x * x));
+
+DEFINE_POLYNOMIAL_EASING(OutCirc,
+    Sqrt(T(1.0f) - (x - T(1.0f)) * (x - T(1.0f))));
+
+DEFINE_POLYNOMIAL_EASING(InOutCirc,
+    Select(Less(x, T(0.5f)),
+           (T(1.0f) - Sqrt(T(1.0f) - T(4.0f) * x * x)) * T(0.5f),
+           (Sqrt(T(1.0f) - (T(2.0f) - T(2.0f) * x) *
+                           (T(2.0f) - T(2.0f) * x)) + T(1.0f)) *
+           T(0.5f)));
+
+DEFINE_POLYNOMIAL_EASING(InBack,
+    T(EASING_BACK_C3) * x * x * x - T(EASING_BACK_C1) * x * x);
+
+DEFINE_POLYNOMIAL_EASING(OutBack,
+    T(1.0f) + T(EASING_BACK_C3) * (x - T(1.0f)) * (x - T(1.0f)) *
+                                  (x - T(1.0f)) +
+              T(EASING_BACK_C1) * (x - T(1.0f)) * (x - T(1.0f)));
+
+DEFINE_POLYNOMIAL_EASING(InOutBack,
+    Select(Less(x, T(0.5f)),
+           (T(2.0f) * x) * (T(2.0f) * x) *
+           (T(EASING_BACK_C2 + 1.0f) * T(2.0f) * x -
+            T(EASING_BACK_C2)) * T(0.5f),
+           ((T(2.0f) * x - T(2.0f)) * (T(2.0f) * x - T(2.0f)) *
+            (T(EASING_BACK_C2 + 1.0f) * (T(2.0f) * x - T(2.0f)) +
+             T(EASING_BACK_C2)) + T(2.0f)) * T(0.5f)));
+
+// sin((10x - 10.75) * 2pi / 3) is sin(2pi * (10x - 10.75) / 3)
+DEFINE_TRANSCENDENTAL_EASING(InElastic,
+    (x == 0.0f) ? 0.0f :
+    (x == 1.0f) ? 1.0f
+                : -powf(2.0f, 10.0f * x - 10.0f) *
+                  sinf((x * 10.0f - 10.75f) * (2.0f * EASING_PI / 3.0f)),
+    Select(Equal(x, T(0.0f)), T(0.0f),
+    Select(Equal(x, T(1.0f)), T(1.0f),
+           T(0.0f) - FastExp2(T(10.0f) * x - T(10.0f)) *
+           FastSinTurns((x * T(10.0f) - T(10.75f)) * T(1.0f / 3.0f)))));
+
+DEFINE_TRANSCENDENTAL_EASING(OutElastic,
+    (x == 0.0f) ? 0.0f :
+    (x == 1.0f) ? 1.0f
+                : powf(2.0f, -10.0f * x) *
+                  sinf((x * 10.0f - 0.75f) * (2.0f * EASING_PI / 3.0f)) +
+                  1.0f,
+    Select(Equal(x, T(0.0f)), T(0.0f),
+    Select(Equal(x, T(1.0f)), T(1.0f),
+           FastExp2(T(-10.0f) * x) *
+           FastSinTurns((x * T(10.0f) - T(0.75f)) * T(1.0f / 3.0f)) +
+           T(1.0f))));
+
+// sin((20x - 11.125) * 2pi / 4.5) is sin(2pi * (20x - 11.125) / 4.5)
+DEFINE_TRANSCENDENTAL_EASING(InOutElastic,
+    (x == 0.0f) ? 0.0f :
+    (x == 1.0f) ? 1.0f :
+    (x < 0.5f)  ? -(powf(2.0f, 20.0f * x - 10.0f) *
+                    sinf((20.0f * x - 11.125f) *
+                         (2.0f * EASING_PI / 4.5f))) / 2.0f
+                : (powf(2.0f, -20.0f * x + 10.0f) *
+                   sinf((20.0f * x - 11.125f) *
+                        (2.0f * EASING_PI / 4.5f))) / 2.0f + 1.0f,
+    Select(Equal(x, T(0.0f)), T(0.0f),
+    Select(Equal(x, T(1.0f)), T(1.0f),
+    Select(Less(x, T(0.5f)),
+           T(0.0f) - FastExp2(T(20.0f) * x - T(10.0f)) *
+           FastSinTurns((T(20.0f) * x - T(11.125f)) * T(1.0f / 4.5f)) *
+           T(0.5f),
+           FastExp2(T(10.0f) - T(20.0f) * x) *
+           FastSinTurns((T(20.0f) * x - T(11.125f)) * T(1.0f / 4.5f)) *
+           T(0.5f) + T(1.0f)))));
+
+DEFINE_POLYNOMIAL_EASING(InBounce,
+    T(1.0f) - FastOutBounce(T(1.0f) - x));
+
+DEFINE_POLYNOMIAL_EASING(OutBounce,
+    FastOutBounce(x));
+
+DEFINE_POLYNOMIAL_EASING(InOutBounce,
+    Select(Less(x, T(0.5f)),
+           (T(1.0f) - FastOutBounce(T(1.0f) - T(2.0f) * x)) * T(0.5f),
+           (T(1.0f) + FastOutBounce(T(2.0f) * x - T(1.0f))) * T(0.5f)));
+
+#undef DEFINE_POLYNOMIAL_EASING
+#undef DEFINE_TRANSCENDENTAL_EASING
+
+// An easing functor as a PFNEASING, e.g. Function<OutBounce>
+template<class Ease>
+static inline FLOAT Function(FLOAT x)
+{
+    return Ease()(x);
+}
+
+// Its Fast() as one
+template<class Ease>
+static inline FLOAT FastFunction(FLOAT x)
+{
+    return Ease::Fast(x);
+}
+
+// The easing sampled at cSegments + 1 evenly spaced points, linearly
+// interpolated; x is clamped to 0..1
+template<class Ease, UINT cSegments = 256>
+class EasingTable {
+public:
+    EasingTable()
+    {
+        UINT i;
+
+        for (i = 0; i <= cSegments; i++) {
+            _values[i] = Ease()((FLOAT) i / (FLOAT) cSegments);
+        }
+
+        // x = 1 interpolates towards this with a weight of 0
+        _values[cSegments + 1] = _values[cSegments];
+    }
+
+    FLOAT operator()(FLOAT x) CONST
+    {
+        FLOAT   f = x * (FLOAT) cSegments;
+        UINT    i;
+
+        f = (f > 0.0f) ? f : 0.0f;
+        f = (f < (FLOAT) cSegments) ? f : (FLOAT) cSegments;
+
+        i = (UINT) f;
+
+        return _values[i] + (_values[i + 1] - _values[i]) * (f - (FLOAT) i);
+    }
+
+private:
+    FLOAT _values[cSegments + 2];
+};
+
 } // namespace Easing
 
-#endif // __EASING_H
\ No newline at end of file
+////////////////////////////////////////////////////////////////////////////
+// Easings by number, for lists, settings and batches
+////////////////////////////////////////////////////////////////////////////
+
+#define EASING_TABLE_SEGMENTS   256
+
+// X(EASING_ name, functor) for each of them, in the order of EASING
+#define EASING_LIST(X)                      \
+    X(IN_SINE,          InSine)             \
+    X(OUT_SINE,         OutSine)            \
+    X(IN_OUT_SINE,      InOutSine)          \
+    X(IN_QUAD,          InQuad)             \
+    X(OUT_QUAD,         OutQuad)            \
+    X(IN_OUT_QUAD,      InOutQuad)          \
+    X(IN_CUBIC,         InCubic)            \
+    X(OUT_CUBIC,        OutCubic)           \
+    X(IN_OUT_CUBIC,     InOutCubic)         \
+    X(IN_QUART,         InQuart)            \
+    X(OUT_QUART,        OutQuart)           \
+    X(IN_OUT_QUART,     InOutQuart)         \
+    X(IN_QUINT,         InQuint)            \
+    X(OUT_QUINT,        OutQuint)           \
+    X(IN_OUT_QUINT,     InOutQuint)         \
+    X(IN_EXPO,          InExpo)             \
+    X(OUT_EXPO,         OutExpo)            \
+    X(IN_OUT_EXPO,      InOutExpo)          \
+    X(IN_CIRC,          InCirc)             \
+    X(OUT_CIRC,         OutCirc)            \
+    X(IN_OUT_CIRC,      InOutCirc)          \
+    X(IN_BACK,          InBack)             \
+    X(OUT_BACK,         OutBack)            \
+    X(IN_OUT_BACK,      InOutBack)          \
+    X(IN_ELASTIC,       InElastic)          \
+    X(OUT_ELASTIC,      OutElastic)         \
+    X(IN_OUT_ELASTIC,   InOutElastic)       \
+    X(IN_BOUNCE,        InBounce)           \
+    X(OUT_BOUNCE,       OutBounce)          \
+    X(IN_OUT_BOUNCE,    InOutBounce)
+
+#define EASING_ENUM_ENTRY(Id, Name)     EASING_##Id,
+
+typedef enum _EASING {
+    EASING_LIST(EASING_ENUM_ENTRY)
+    EASING_COUNT
+} EASING;
+
+#undef EASING_ENUM_ENTRY
+
+typedef struct _EASINGINFO {
+    LPCSTR      pszName;        // The functor, e.g. "OutCirc"
+    PFNEASING   pfnEase;
+    PFNEASING   pfnFast;
+    FLOAT       fFastError;     // Largest |Fast() - operator()| on 0..1
+    FLOAT       fTableError;    // The same for EASING_TABLE_SEGMENTS
+} EASINGINFO;
+
+// NULL past EASING_COUNT
+CONST EASINGINFO* GetEasingInfo(EASING easing);
+
+typedef enum _EASINGLEVEL {
+    EASING_LEVEL_SCALAR,
+    EASING_LEVEL_SSE2
+} EASINGLEVEL;
+
+// pfY[i] = Fast(pfX[i]); every level gives the same bits
+typedef VOID (*EASINGPROC)(CONST FLOAT* pfX, FLOAT* pfY, UINT cValues);
+
+typedef struct _EASINGKERNELS {
+    EASINGLEVEL level;
+    LPCSTR      pszName;
+    EASINGPROC  pfnBatch[EASING_COUNT];
+} EASINGKERNELS;
+
+// Best kernels for this CPU
+CONST EASINGKERNELS* GetEasingKernels();
+
+// NULL when the level is not built in or not supported by the CPU
+CONST EASINGKERNELS* GetEasingKernelsForLevel(EASINGLEVEL level);
+
+////////////////////////////////////////////////////////////////////////////
+// Per level tables, defined in easing_sse2.cpp
+
+extern CONST EASINGKERNELS SSE2_EASING_KERNELS;
+
+#endif // __EASING_H
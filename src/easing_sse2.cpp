@@ -0,0 +1,132 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "easing.h"
+#include "cpu.h"
+
+#ifdef FP_ARCH_X86
+
+#include <emmintrin.h>
+
+////////////////////////////////////////////////////////////////////////////
+// SSE2 kernels
+//
+// Float4 gives the Fast() templates in easing.h four lanes to work on.
+// It has the same primitives as a FLOAT, each one IEEE exact or a
+// bitwise select, so every lane comes out as the scalar kernel's would.
+////////////////////////////////////////////////////////////////////////////
+
+struct Float4 {
+    __m128 v;
+
+    Float4() {}
+    Float4(__m128 value) : v(value) {}
+    Float4(FLOAT f) : v(_mm_set1_ps(f)) {}
+};
+
+static inline Float4 operator+(Float4 a, Float4 b)
+{
+    return _mm_add_ps(a.v, b.v);
+}
+
+static inline Float4 operator-(Float4 a, Float4 b)
+{
+    return _mm_sub_ps(a.v, b.v);
+}
+
+static inline Float4 operator*(Float4 a, Float4 b)
+{
+    return _mm_mul_ps(a.v, b.v);
+}
+
+// Masks, all ones where true
+static inline Float4 Less(Float4 a, Float4 b)
+{
+    return _mm_cmplt_ps(a.v, b.v);
+}
+
+static inline Float4 Equal(Float4 a, Float4 b)
+{
+    return _mm_cmpeq_ps(a.v, b.v);
+}
+
+static inline Float4 Select(Float4 mask, Float4 a, Float4 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+}
+
+static inline Float4 Sqrt(Float4 x)
+{
+    return _mm_sqrt_ps(x.v);
+}
+
+// Truncation, one less where that went up; any x that fits an int
+static inline Float4 Floor(Float4 x)
+{
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x.v));
+
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x.v),
+                                    _mm_set1_ps(1.0f)));
+}
+
+// 2^k built from its exponent bits
+static inline Float4 ScaleByPow2(Float4 p, Float4 k)
+{
+    __m128i e = _mm_slli_epi32(
+        _mm_add_epi32(_mm_cvtps_epi32(k.v), _mm_set1_epi32(127)), 23);
+
+    return _mm_mul_ps(p.v, _mm_castsi128_ps(e));
+}
+
+template<class Ease>
+static VOID EaseBatchSse2(CONST FLOAT* pfX, FLOAT* pfY, UINT cValues)
+{
+    FLOAT   x[4], y[4];
+    UINT    i, k;
+
+    for (i = 0; i + 4 <= cValues; i += 4) {
+        _mm_storeu_ps(pfY + i,
+                      Ease::Fast(Float4(_mm_loadu_ps(pfX + i))).v);
+    }
+
+    if (i == cValues) {
+        return;
+    }
+
+    for (k = 0; k < 4; k++) {
+        x[k] = (i + k < cValues) ? pfX[i + k] : 0.0f;
+    }
+
+    _mm_storeu_ps(y, Ease::Fast(Float4(_mm_loadu_ps(x))).v);
+
+    for (k = 0; i + k < cValues; k++) {
+        pfY[i + k] = y[k];
+    }
+}
+
+#define EASING_BATCH_ENTRY(Id, Name)    EaseBatchSse2<Easing::Name>,
+
+CONST EASINGKERNELS SSE2_EASING_KERNELS = {
+    EASING_LEVEL_SSE2,
+    "sse2",
+    {
+        EASING_LIST(EASING_BATCH_ENTRY)
+    }
+};
+
+#undef EASING_BATCH_ENTRY
+
+#endif // FP_ARCH_X86
@@ -0,0 +1,311 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "engine.h"
+
+#include <math.h>
+
+#include "trace.h"
+
+#define SCALE_STEP          0.05f
+
+#define FRAME_CACHE_BUDGET  (32 * 1024 * 1024)
+
+Engine::Engine(Clock* pClock)
+    : _pClock(pClock),
+      _pSink(NULL),
+      _scheduler(pClock),
+      _simulation(pClock),
+      _predictor(pClock),
+      _latency(pClock),
+      _renderer(pClock, &_latency),
+      _viewport(Geometry::MakeSize(0.0f, 0.0f)),
+      _ulInvalidation(0),
+      _llInputTime(0),
+      _bPredict(TRUE),
+      _bSuspended(TRUE),
+      _bThreaded(FALSE)
+{
+}
+
+HRESULT Engine::Initialize(
+    RenderSink* pSink,
+    Sprite*     pSprite,
+    Sound*      pEffect,
+    Sound*      pEffectMove)
+{
+    Geometry::Size  size;
+    HRESULT         hResult;
+
+    if (pSink == NULL) {
+        return E_INVALIDARG;
+    }
+
+    hResult = _pointer.Initialize(pSprite, pEffect, pEffectMove);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    _pSink = pSink;
+
+    // Optional, the pointer draws without it
+    _pointer.EnableFrameCache(_pSink, FRAME_CACHE_BUDGET);
+
+    _renderer.Initialize(_pSink, _pointer.GetSprite());
+
+    size = _pSink->GetSize();
+    SetViewport(size.width, size.height);
+
+    return S_OK;
+}
+
+VOID Engine::SetViewport(FLOAT fWidth, FLOAT fHeight)
+{
+    // The renderer redraws everything when it sees the new size
+    _viewport = Geometry::MakeSize(fWidth, fHeight);
+    _pointer.Invalidate();
+}
+
+Geometry::Size Engine::GetViewport() CONST
+{
+    return _viewport;
+}
+
+VOID Engine::CenterPointer()
+{
+    Geometry::Size size = _pointer.GetSize();
+
+    _pointer.SetPosition(Geometry::MakePoint(
+        (_viewport.width  - size.width)  / 2.0f,
+        (_viewport.height - size.height) / 2.0f));
+
+    // A jump, not motion to extrapolate or follow
+    _predictor.Reset();
+    _pointer.SetDrawOffset(Geometry::MakePoint(0.0f, 0.0f));
+    _pointer.SnapToPosition();
+}
+
+VOID Engine::SetDpiScale(FLOAT fDpiScale)
+{
+    _pointer.SetDpiScale(fDpiScale);
+}
+
+VOID Engine::SetPrediction(BOOL bPredict)
+{
+    _bPredict = bPredict;
+
+    if (_bPredict == FALSE) {
+        _pointer.SetDrawOffset(Geometry::MakePoint(0.0f, 0.0f));
+    }
+}
+
+PointerPredictor* Engine::GetPredictor()
+{
+    return &_predictor;
+}
+
+VOID Engine::HandleInput(CONST INPUTEVENT& event)
+{
+    Geometry::Point position;
+    Geometry::Size  size;
+
+    if (event.llTime > _llInputTime) {
+        _llInputTime = event.llTime;
+    }
+
+    switch (event.type) {
+        case IE_MOVE:
+            size = _pointer.GetSize();
+            position = _pointer.GetPosition();
+
+            position.x += event.fDeltaX;
+            position.y += event.fDeltaY;
+
+            // The pointer may leave the screen, but not further than
+            // its own size
+            position.x = fmaxf(
+                -size.width,
+                fminf(position.x, _viewport.width + size.width));
+
+            position.y = fmaxf(
+                -size.height,
+                fminf(position.y, _viewport.height + size.height));
+
+            _pointer.SetPosition(position);
+            _predictor.AddSample(event.llTime, position);
+            break;
+        case IE_PRESS:
+            _pointer.OnPress();
+            break;
+        case IE_RELEASE:
+            _pointer.OnRelease();
+            break;
+        case IE_WHEEL:
+            _pointer.SetScale(
+                _pointer.GetScale() +
+                ((event.iWheelDelta > 0) ? -SCALE_STEP : SCALE_STEP));
+            break;
+        case IE_TOGGLE_MARKER:
+            _pointer.ToggleMarker();
+            break;
+    }
+
+    // Publishing is cheap, and the render thread takes whatever is
+    // newest when it starts to draw
+    if (_bThreaded == TRUE && _pSink != NULL) {
+        Render();
+    }
+}
+
+VOID Engine::PumpInput(InputSource* pSource)
+{
+    INPUTEVENT event;
+
+    if (pSource == NULL) {
+        return;
+    }
+
+    while (pSource->PollInput(&event)) {
+        HandleInput(event);
+    }
+}
+
+BOOL Engine::IsIdle() CONST
+{
+    Geometry::Point offset = _pointer.GetDrawOffset();
+
+    // A predicted position still on screen has to be taken back
+    return _pointer.IsIdle() && offset.x == 0.0f && offset.y == 0.0f;
+}
+
+VOID Engine::Invalidate()
+{
+    _ulInvalidation++;
+    _pointer.Invalidate();
+}
+
+VOID Engine::Suspend()
+{
+    _bSuspended = TRUE;
+}
+
+DWORD Engine::GetTimeout() CONST
+{
+    return (_bSuspended == TRUE) ? 0 : _scheduler.GetTimeout();
+}
+
+BOOL Engine::Tick()
+{
+    LONGLONG    llStart;
+    BOOL        bRendered;
+    UINT        i, cSteps;
+
+    FP_TRACE_SCOPE("Engine::Tick");
+
+    if (_pSink == NULL) {
+        return FALSE;
+    }
+
+    if (_bSuspended == TRUE) {
+        _bSuspended = FALSE;
+        _scheduler.Reset();
+        _simulation.Reset();
+    }
+
+    if (_scheduler.BeginFrame() == FALSE) {
+        return FALSE;
+    }
+
+    llStart = _latency.Stamp();
+
+    cSteps = _simulation.Advance();
+
+    for (i = 0; i < cSteps; i++) {
+        _pointer.Step(_simulation.GetStepTime());
+    }
+
+    // What is drawn now goes up at the next deadline
+    if (_bPredict == TRUE) {
+        _pointer.SetDrawOffset(
+            _predictor.Predict(_scheduler.GetNextDeadline()));
+    }
+
+    bRendered = _pointer.Update(
+        cSteps * _simulation.GetStepTime(),
+        _simulation.GetAlpha());
+
+    if (bRendered == TRUE) {
+        _latency.Record(LATENCY_UPDATE, llStart, _latency.Stamp());
+        Render();
+    }
+
+    _scheduler.EndFrame(bRendered);
+
+    return bRendered;
+}
+
+VOID Engine::SetThreadedRendering(BOOL bThreaded)
+{
+    _bThreaded = bThreaded;
+}
+
+BOOL Engine::IsThreadedRendering() CONST
+{
+    return _bThreaded;
+}
+
+Pointer* Engine::GetPointer()
+{
+    return &_pointer;
+}
+
+FrameScheduler* Engine::GetScheduler()
+{
+    return &_scheduler;
+}
+
+Simulation* Engine::GetSimulation()
+{
+    return &_simulation;
+}
+
+Renderer* Engine::GetRenderer()
+{
+    return &_renderer;
+}
+
+LatencyMonitor* Engine::GetLatencyMonitor()
+{
+    return &_latency;
+}
+
+VOID Engine::Render()
+{
+    FRAMESTATE frame;
+
+    _pointer.GetFrame(&frame.pointer);
+
+    frame.viewport = _viewport;
+    frame.ulInvalidation = _ulInvalidation;
+    frame.llInputTime = _llInputTime;
+
+    if (_bThreaded == TRUE) {
+        _renderer.Publish(frame);
+    } else {
+        _renderer.Render(frame);
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ENGINE_H
+#define __ENGINE_H
+
+#include "wintypes.h"
+#include "platform.h"
+#include "framescheduler.h"
+#include "simulation.h"
+#include "pointer.h"
+#include "pointerpredictor.h"
+#include "renderer.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Engine
+//
+// Everything between "an input event happened" and "a frame was drawn",
+// independent of the windowing system. The host feeds it INPUTEVENTs,
+// sleeps for GetTimeout() while it is not idle and calls Tick().
+//
+// Tick() draws the frame itself by default. With threaded rendering on
+// it only publishes the frame, and so does every input event; the
+// host's render thread draws the newest one with GetRenderer() (see
+// Renderer).
+////////////////////////////////////////////////////////////////////////////
+
+class Engine {
+public:
+    Engine(Clock* pClock);
+
+    // Takes ownership of the sprite and both sounds on success
+    HRESULT Initialize(
+        RenderSink* pSink,
+        Sprite*     pSprite,
+        Sound*      pEffect,
+        Sound*      pEffectMove);
+
+    VOID SetViewport(FLOAT fWidth, FLOAT fHeight);
+    Geometry::Size GetViewport() CONST;
+
+    VOID CenterPointer();
+
+    // Monitor DPI / 96
+    VOID SetDpiScale(FLOAT fDpiScale);
+
+    // Draws the pointer where it is expected to be when the frame is
+    // presented instead of where the last input left it; on by default
+    VOID SetPrediction(BOOL bPredict);
+    PointerPredictor* GetPredictor();
+
+    VOID HandleInput(CONST INPUTEVENT& event);
+    VOID PumpInput(InputSource* pSource);
+
+    BOOL IsIdle() CONST;
+    VOID Invalidate();
+
+    // Called by the host before it blocks; the next Tick() restarts
+    // the frame cadence and the simulation instead of treating the
+    // pause as frame time
+    VOID Suspend();
+
+    DWORD GetTimeout() CONST;
+
+    BOOL Tick();
+
+    // Off by default; switch it while no render thread runs
+    VOID SetThreadedRendering(BOOL bThreaded);
+    BOOL IsThreadedRendering() CONST;
+
+    Pointer* GetPointer();
+    FrameScheduler* GetScheduler();
+    Simulation* GetSimulation();
+    Renderer* GetRenderer();
+
+    // Stamps come from the engine's clock, so input events have to be
+    // stamped with it too
+    LatencyMonitor* GetLatencyMonitor();
+
+private:
+    VOID Render();
+
+    Clock*           _pClock;
+    RenderSink*      _pSink;
+    FrameScheduler   _scheduler;
+    Simulation       _simulation;
+    Pointer          _pointer;
+    PointerPredictor _predictor;
+    LatencyMonitor   _latency;
+    Renderer         _renderer;
+    Geometry::Size   _viewport;
+    ULONG            _ulInvalidation;
+    LONGLONG         _llInputTime;      // Newest input handled
+    BOOL             _bPredict;
+    BOOL             _bSuspended;
+    BOOL             _bThreaded;
+};
+
+#endif // __ENGINE_H
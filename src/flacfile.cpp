@@ -0,0 +1,721 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flacfile.h"
+
+#include <string.h>
+
+#include "atomic.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#define FLAC_MAX_BITS       24
+#define FLAC_MAX_LPC_ORDER  32
+
+////////////////////////////////////////////////////////////////////////////
+// Bit reader
+//
+// MSB first with a 64-bit cache. Reading past the end yields zeros and is
+// only checked once a frame is done, which keeps the hot loops branch
+// free; the frame CRC catches anything that slips through.
+////////////////////////////////////////////////////////////////////////////
+
+typedef struct _BITREADER {
+    CONST BYTE* pb;
+    SIZE_T      cb;
+    SIZE_T      cbLoaded;   // Bytes moved into the cache, may pass cb
+    ULONGLONG   ullCache;   // Left aligned, zeros below cBits
+    UINT        cBits;
+} BITREADER;
+
+static inline UINT CountLeadingZeros(ULONGLONG ullValue)
+{
+#ifdef _MSC_VER
+    unsigned long ulIndex;
+
+    if (_BitScanReverse(&ulIndex, (unsigned long) (ullValue >> 32))) {
+        return 31 - (UINT) ulIndex;
+    }
+
+    _BitScanReverse(&ulIndex, (unsigned long) ullValue);
+    return 63 - (UINT) ulIndex;
+#else
+    return (UINT) __builtin_clzll(ullValue);
+#endif
+}
+
+static VOID InitBitReader(BITREADER* pReader, CONST BYTE* pb, SIZE_T cb)
+{
+    pReader->pb = pb;
+    pReader->cb = cb;
+    pReader->cbLoaded = 0;
+    pReader->ullCache = 0;
+    pReader->cBits = 0;
+}
+
+static inline VOID Refill(BITREADER* pReader)
+{
+    ULONGLONG ullByte;
+
+    while (pReader->cBits <= 56) {
+        ullByte = (pReader->cbLoaded < pReader->cb)
+            ? pReader->pb[pReader->cbLoaded]
+            : 0;
+
+        pReader->ullCache |= ullByte << (56 - pReader->cBits);
+        pReader->cbLoaded++;
+        pReader->cBits += 8;
+    }
+}
+
+// cBits <= 32
+static inline UINT ReadBits(BITREADER* pReader, UINT cBits)
+{
+    UINT uValue;
+
+    if (cBits == 0) {
+        return 0;
+    }
+
+    if (pReader->cBits < cBits) {
+        Refill(pReader);
+    }
+
+    uValue = (UINT) (pReader->ullCache >> (64 - cBits));
+
+    pReader->ullCache <<= cBits;
+    pReader->cBits -= cBits;
+
+    return uValue;
+}
+
+static inline INT ReadSigned(BITREADER* pReader, UINT cBits)
+{
+    if (cBits == 0) {
+        return 0;
+    }
+
+    return (INT) (ReadBits(pReader, cBits) << (32 - cBits)) >> (32 - cBits);
+}
+
+// Zeros before the next one bit
+static inline UINT ReadUnary(BITREADER* pReader)
+{
+    UINT cZeros = 0;
+    UINT cLeading;
+
+    while (pReader->ullCache == 0) {
+        cZeros += pReader->cBits;
+        pReader->cBits = 0;
+
+        // Only zeros left past the end, give up there
+        if (pReader->cbLoaded > pReader->cb) {
+            return cZeros;
+        }
+
+        Refill(pReader);
+    }
+
+    cLeading = CountLeadingZeros(pReader->ullCache);
+
+    pReader->ullCache <<= cLeading;
+    pReader->ullCache <<= 1;
+    pReader->cBits -= cLeading + 1;
+
+    return cZeros + cLeading;
+}
+
+static inline VOID AlignToByte(BITREADER* pReader)
+{
+    ReadBits(pReader, pReader->cBits & 7);
+}
+
+// Bytes consumed so far
+static inline SIZE_T GetBytePosition(CONST BITREADER* pReader)
+{
+    return pReader->cbLoaded - pReader->cBits / 8;
+}
+
+static inline BOOL IsOverrun(CONST BITREADER* pReader)
+{
+    return GetBytePosition(pReader) > pReader->cb;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// CRCs
+////////////////////////////////////////////////////////////////////////////
+
+static BYTE Crc8(CONST BYTE* pb, SIZE_T cb)
+{
+    UINT uCrc = 0;
+    SIZE_T i;
+    UINT j;
+
+    for (i = 0; i < cb; i++) {
+        uCrc ^= pb[i];
+
+        for (j = 0; j < 8; j++) {
+            uCrc = (uCrc & 0x80) ? ((uCrc << 1) ^ 0x07) : (uCrc << 1);
+        }
+    }
+
+    return (BYTE) uCrc;
+}
+
+static WORD CRC16_TABLE[256];
+static volatile LONG g_lCrc16Ready = 0;
+
+// Concurrent first calls fill the table with the same values
+static VOID InitCrc16Table()
+{
+    UINT uCrc, i, j;
+
+    if (AtomicLoadAcquire(&g_lCrc16Ready) != 0) {
+        return;
+    }
+
+    for (i = 0; i < 256; i++) {
+        uCrc = i << 8;
+
+        for (j = 0; j < 8; j++) {
+            uCrc = (uCrc & 0x8000) ? ((uCrc << 1) ^ 0x8005) : (uCrc << 1);
+        }
+
+        CRC16_TABLE[i] = (WORD) uCrc;
+    }
+
+    AtomicStoreRelease(&g_lCrc16Ready, 1);
+}
+
+static UINT Crc16(CONST BYTE* pb, SIZE_T cb)
+{
+    UINT uCrc = 0;
+    SIZE_T i;
+
+    for (i = 0; i < cb; i++) {
+        uCrc = ((uCrc << 8) ^ CRC16_TABLE[((uCrc >> 8) ^ pb[i]) & 0xFF]) &
+               0xFFFF;
+    }
+
+    return uCrc;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Subframes
+////////////////////////////////////////////////////////////////////////////
+
+// Fills piResidual[uOrder..cFrames)
+static BOOL DecodeResidual(
+    BITREADER*  pReader,
+    INT*        piResidual,
+    UINT        cFrames,
+    UINT        uOrder)
+{
+    UINT    uMethod, cParamBits, uEscape;
+    UINT    uPartitionOrder, cPartitions, cPartitionFrames;
+    UINT    uPartition, uParam, cRawBits, uValue;
+    UINT    i = uOrder, uEnd;
+
+    uMethod = ReadBits(pReader, 2);
+
+    if (uMethod > 1) {
+        return FALSE;
+    }
+
+    cParamBits = (uMethod == 0) ? 4 : 5;
+    uEscape = (uMethod == 0) ? 15 : 31;
+
+    uPartitionOrder = ReadBits(pReader, 4);
+    cPartitions = 1U << uPartitionOrder;
+    cPartitionFrames = cFrames >> uPartitionOrder;
+
+    if (cPartitionFrames << uPartitionOrder != cFrames ||
+        cPartitionFrames < uOrder)
+    {
+        return FALSE;
+    }
+
+    for (uPartition = 0; uPartition < cPartitions; uPartition++) {
+        uEnd = (uPartition + 1) * cPartitionFrames;
+        uParam = ReadBits(pReader, cParamBits);
+
+        if (uParam == uEscape) {
+            cRawBits = ReadBits(pReader, 5);
+
+            for (; i < uEnd; i++) {
+                piResidual[i] = ReadSigned(pReader, cRawBits);
+            }
+
+            continue;
+        }
+
+        for (; i < uEnd; i++) {
+            uValue = (ReadUnary(pReader) << uParam) |
+                     ReadBits(pReader, uParam);
+
+            piResidual[i] = (INT) (uValue >> 1) ^ -(INT) (uValue & 1);
+        }
+    }
+
+    return TRUE;
+}
+
+// Predictions and residuals are added up in 64 bits, so a corrupt
+// frame cannot overflow them; FALSE for a sample that does not fit in
+// cBits
+static BOOL RestoreFixed(
+    INT*        piSamples,
+    UINT        cFrames,
+    UINT        uOrder,
+    UINT        cBits)
+{
+    LONGLONG    llLimit = (LONGLONG) 1 << (cBits - 1);
+    LONGLONG    llSample;
+    CONST INT*  p;
+    UINT        i;
+
+    for (i = uOrder; i < cFrames; i++) {
+        p = piSamples + i;
+
+        switch (uOrder) {
+            case 1:
+                llSample = (LONGLONG) p[-1];
+                break;
+
+            case 2:
+                llSample = 2 * (LONGLONG) p[-1] - p[-2];
+                break;
+
+            case 3:
+                llSample = 3 * ((LONGLONG) p[-1] - p[-2]) + p[-3];
+                break;
+
+            case 4:
+                llSample = 4 * ((LONGLONG) p[-1] + p[-3]) -
+                           6 * (LONGLONG) p[-2] - p[-4];
+                break;
+
+            default:
+                llSample = 0;
+                break;
+        }
+
+        llSample += piSamples[i];
+
+        if (llSample < -llLimit || llSample >= llLimit) {
+            return FALSE;
+        }
+
+        piSamples[i] = (INT) llSample;
+    }
+
+    return TRUE;
+}
+
+static BOOL RestoreLpc(
+    INT*        piSamples,
+    UINT        cFrames,
+    CONST INT*  piCoefficients,
+    UINT        uOrder,
+    UINT        uShift,
+    UINT        cBits)
+{
+    LONGLONG    llLimit = (LONGLONG) 1 << (cBits - 1);
+    LONGLONG    llSum;
+    UINT        i, j;
+
+    for (i = uOrder; i < cFrames; i++) {
+        llSum = 0;
+
+        for (j = 0; j < uOrder; j++) {
+            llSum += (LONGLONG) piCoefficients[j] * piSamples[i - 1 - j];
+        }
+
+        llSum = (llSum >> uShift) + piSamples[i];
+
+        if (llSum < -llLimit || llSum >= llLimit) {
+            return FALSE;
+        }
+
+        piSamples[i] = (INT) llSum;
+    }
+
+    return TRUE;
+}
+
+static BOOL DecodeSubframe(
+    BITREADER*  pReader,
+    INT*        piSamples,
+    UINT        cFrames,
+    UINT        cBits)
+{
+    INT     coefficients[FLAC_MAX_LPC_ORDER];
+    UINT    uType, uOrder, cWasted = 0, cPrecision;
+    INT     iShift, iValue;
+    UINT    i;
+
+    if (ReadBits(pReader, 1) != 0) {
+        return FALSE;
+    }
+
+    uType = ReadBits(pReader, 6);
+
+    if (ReadBits(pReader, 1) != 0) {
+        cWasted = ReadUnary(pReader) + 1;
+
+        if (cWasted >= cBits) {
+            return FALSE;
+        }
+
+        cBits -= cWasted;
+    }
+
+    if (uType == 0) {
+        iValue = ReadSigned(pReader, cBits);
+
+        for (i = 0; i < cFrames; i++) {
+            piSamples[i] = iValue;
+        }
+    } else if (uType == 1) {
+        for (i = 0; i < cFrames; i++) {
+            piSamples[i] = ReadSigned(pReader, cBits);
+        }
+    } else if (uType >= 8 && uType <= 12) {
+        uOrder = uType - 8;
+
+        if (uOrder > cFrames) {
+            return FALSE;
+        }
+
+        for (i = 0; i < uOrder; i++) {
+            piSamples[i] = ReadSigned(pReader, cBits);
+        }
+
+        if (DecodeResidual(pReader, piSamples, cFrames, uOrder) == FALSE) {
+            return FALSE;
+        }
+
+        if (RestoreFixed(piSamples, cFrames, uOrder, cBits) == FALSE) {
+            return FALSE;
+        }
+    } else if (uType >= 32) {
+        uOrder = (uType & 31) + 1;
+
+        if (uOrder > cFrames) {
+            return FALSE;
+        }
+
+        for (i = 0; i < uOrder; i++) {
+            piSamples[i] = ReadSigned(pReader, cBits);
+        }
+
+        cPrecision = ReadBits(pReader, 4) + 1;
+        iShift = ReadSigned(pReader, 5);
+
+        if (cPrecision == 16 || iShift < 0) {
+            return FALSE;
+        }
+
+        for (i = 0; i < uOrder; i++) {
+            coefficients[i] = ReadSigned(pReader, cPrecision);
+        }
+
+        if (DecodeResidual(pReader, piSamples, cFrames, uOrder) == FALSE) {
+            return FALSE;
+        }
+
+        if (RestoreLpc(piSamples, cFrames, coefficients, uOrder,
+                       (UINT) iShift, cBits) == FALSE)
+        {
+            return FALSE;
+        }
+    } else {
+        return FALSE;
+    }
+
+    if (cWasted != 0) {
+        for (i = 0; i < cFrames; i++) {
+            piSamples[i] = (INT) ((UINT) piSamples[i] << cWasted);
+        }
+    }
+
+    return TRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+HRESULT ParseFlac(CONST BYTE* pbFile, SIZE_T cbFile, FLACINFO* pInfo)
+{
+    BITREADER   reader;
+    SIZE_T      cbOffset = 4;
+    SIZE_T      cbBlock;
+    UINT        uType;
+    BOOL        bLast = FALSE;
+    BOOL        bStreamInfo = FALSE;
+
+    if (pbFile == NULL || pInfo == NULL) {
+        return E_INVALIDARG;
+    }
+
+    if (cbFile < 4 || memcmp(pbFile, "fLaC", 4) != 0) {
+        return E_INVALIDARG;
+    }
+
+    memset(pInfo, 0, sizeof(FLACINFO));
+
+    while (bLast == FALSE) {
+        if (cbFile - cbOffset < 4) {
+            return E_INVALIDARG;
+        }
+
+        bLast = (pbFile[cbOffset] & 0x80) != 0;
+        uType = pbFile[cbOffset] & 0x7F;
+        cbBlock = ((SIZE_T) pbFile[cbOffset + 1] << 16) |
+                  ((SIZE_T) pbFile[cbOffset + 2] << 8) |
+                  (SIZE_T) pbFile[cbOffset + 3];
+
+        cbOffset += 4;
+
+        if (cbBlock > cbFile - cbOffset) {
+            return E_INVALIDARG;
+        }
+
+        if (uType == 0) {
+            if (cbBlock < 34) {
+                return E_INVALIDARG;
+            }
+
+            InitBitReader(&reader, pbFile + cbOffset, cbBlock);
+
+            ReadBits(&reader, 16);      // Minimum block size
+            pInfo->cMaxBlockFrames = ReadBits(&reader, 16);
+            ReadBits(&reader, 24);      // Minimum frame size
+            ReadBits(&reader, 24);      // Maximum frame size
+            pInfo->uSampleRate = ReadBits(&reader, 20);
+            pInfo->cChannels = ReadBits(&reader, 3) + 1;
+            pInfo->cBitsPerSample = ReadBits(&reader, 5) + 1;
+            pInfo->ullFrames = (ULONGLONG) ReadBits(&reader, 4) << 32;
+            pInfo->ullFrames |= ReadBits(&reader, 32);
+
+            bStreamInfo = TRUE;
+        }
+
+        cbOffset += cbBlock;
+    }
+
+    if (bStreamInfo == FALSE ||
+        pInfo->uSampleRate == 0 ||
+        pInfo->cMaxBlockFrames < 16)
+    {
+        return E_INVALIDARG;
+    }
+
+    if (pInfo->cChannels > FLAC_MAX_CHANNELS ||
+        pInfo->cBitsPerSample > FLAC_MAX_BITS)
+    {
+        return E_NOTIMPL;
+    }
+
+    pInfo->cbFirstFrame = cbOffset;
+
+    return S_OK;
+}
+
+HRESULT DecodeFlacFrame(
+    CONST BYTE*         pbFile,
+    SIZE_T              cbFile,
+    CONST FLACINFO&     info,
+    SIZE_T*             pcbOffset,
+    INT*                piScratch,
+    SHORT*              psOutput,
+    UINT*               pcFrames)
+{
+    static CONST UINT SAMPLE_SIZES[8] = { 0, 8, 12, 0, 16, 20, 24, 0 };
+
+    BITREADER   reader;
+    CONST BYTE* pbFrame;
+    SIZE_T      cbHeader, cbFrame;
+    UINT        uBlockCode, uRateCode, uAssignment, uSizeCode;
+    UINT        cFrames, cBits, cChannels, cExtra;
+    UINT        uChannel, i;
+    INT*        piLeft;
+    INT*        piRight;
+    INT         iMid, iSide;
+    INT         iShift;
+    BOOL        bSide;
+
+    if (pbFile == NULL || pcbOffset == NULL || piScratch == NULL ||
+        psOutput == NULL || pcFrames == NULL)
+    {
+        return E_INVALIDARG;
+    }
+
+    if (*pcbOffset >= cbFile) {
+        return S_FALSE;
+    }
+
+    InitCrc16Table();
+
+    pbFrame = pbFile + *pcbOffset;
+    InitBitReader(&reader, pbFrame, cbFile - *pcbOffset);
+
+    // Header
+    if (ReadBits(&reader, 15) != (0x3FFE << 1)) {
+        return E_FAIL;
+    }
+
+    ReadBits(&reader, 1);           // Fixed or variable block size
+
+    uBlockCode = ReadBits(&reader, 4);
+    uRateCode = ReadBits(&reader, 4);
+    uAssignment = ReadBits(&reader, 4);
+    uSizeCode = ReadBits(&reader, 3);
+
+    if (ReadBits(&reader, 1) != 0 || uBlockCode == 0 || uRateCode == 15) {
+        return E_FAIL;
+    }
+
+    // Frame or sample number, UTF-8 style
+    cExtra = 0;
+
+    for (i = ReadBits(&reader, 8); (i & 0x80) != 0; i <<= 1) {
+        cExtra++;
+    }
+
+    if (cExtra == 1 || cExtra > 7) {
+        return E_FAIL;
+    }
+
+    for (i = 1; i < cExtra; i++) {
+        if (ReadBits(&reader, 8) >> 6 != 2) {
+            return E_FAIL;
+        }
+    }
+
+    if (uBlockCode == 1) {
+        cFrames = 192;
+    } else if (uBlockCode <= 5) {
+        cFrames = 576U << (uBlockCode - 2);
+    } else if (uBlockCode == 6) {
+        cFrames = ReadBits(&reader, 8) + 1;
+    } else if (uBlockCode == 7) {
+        cFrames = ReadBits(&reader, 16) + 1;
+    } else {
+        cFrames = 256U << (uBlockCode - 8);
+    }
+
+    // Only the STREAMINFO rate matters, skip the frame's own
+    if (uRateCode == 12) {
+        ReadBits(&reader, 8);
+    } else if (uRateCode == 13 || uRateCode == 14) {
+        ReadBits(&reader, 16);
+    }
+
+    cbHeader = GetBytePosition(&reader);
+
+    if (IsOverrun(&reader) ||
+        ReadBits(&reader, 8) != Crc8(pbFrame, cbHeader))
+    {
+        return E_FAIL;
+    }
+
+    cBits = (uSizeCode == 0) ? info.cBitsPerSample : SAMPLE_SIZES[uSizeCode];
+    cChannels = (uAssignment < 8) ? uAssignment + 1 : 2;
+
+    if (cBits == 0 || cBits > FLAC_MAX_BITS ||
+        cChannels != info.cChannels || uAssignment > 10 ||
+        cFrames > info.cMaxBlockFrames)
+    {
+        return E_FAIL;
+    }
+
+    // Subframes, planar in the scratch buffer; a side channel has one
+    // bit more than the others
+    for (uChannel = 0; uChannel < cChannels; uChannel++) {
+        bSide = (uAssignment == 8 && uChannel == 1) ||
+                (uAssignment == 9 && uChannel == 0) ||
+                (uAssignment == 10 && uChannel == 1);
+
+        if (DecodeSubframe(
+                &reader,
+                piScratch + uChannel * info.cMaxBlockFrames,
+                cFrames,
+                cBits + (bSide ? 1 : 0)) == FALSE)
+        {
+            return E_FAIL;
+        }
+    }
+
+    AlignToByte(&reader);
+    cbFrame = GetBytePosition(&reader);
+
+    if (IsOverrun(&reader) ||
+        ReadBits(&reader, 16) != Crc16(pbFrame, cbFrame) ||
+        IsOverrun(&reader))
+    {
+        return E_FAIL;
+    }
+
+    piLeft = piScratch;
+    piRight = piScratch + info.cMaxBlockFrames;
+
+    switch (uAssignment) {
+        case 8:     // Left, side
+            for (i = 0; i < cFrames; i++) {
+                piRight[i] = piLeft[i] - piRight[i];
+            }
+            break;
+
+        case 9:     // Side, right
+            for (i = 0; i < cFrames; i++) {
+                piLeft[i] += piRight[i];
+            }
+            break;
+
+        case 10:    // Mid, side
+            for (i = 0; i < cFrames; i++) {
+                iSide = piRight[i];
+                iMid = (INT) ((UINT) piLeft[i] << 1) | (iSide & 1);
+
+                piLeft[i] = (iMid + iSide) >> 1;
+                piRight[i] = (iMid - iSide) >> 1;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    // To 16 bits: drop the low bits of deeper samples, pad shallower ones
+    iShift = (INT) cBits - 16;
+
+    for (uChannel = 0; uChannel < cChannels; uChannel++) {
+        piLeft = piScratch + uChannel * info.cMaxBlockFrames;
+
+        for (i = 0; i < cFrames; i++) {
+            psOutput[i * cChannels + uChannel] = (SHORT) ((iShift >= 0)
+                ? (piLeft[i] >> iShift)
+                : (INT) ((UINT) piLeft[i] << -iShift));
+        }
+    }
+
+    *pcbOffset += cbFrame + 2;
+    *pcFrames = cFrames;
+
+    return S_OK;
+}
@@ -0,0 +1,58 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FLACFILE_H
+#define __FLACFILE_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Native FLAC decoding
+//
+// ParseFlac() reads STREAMINFO and finds the first audio frame;
+// DecodeFlacFrame() then decodes one frame at a time from the caller's
+// buffer, so a file can be played through a memory map without ever
+// holding more than one block of it as PCM. Up to two channels and 24
+// bits per sample; the output is 16-bit like every other mixer source.
+////////////////////////////////////////////////////////////////////////////
+
+#define FLAC_MAX_CHANNELS   2
+
+typedef struct _FLACINFO {
+    UINT        uSampleRate;
+    UINT        cChannels;
+    UINT        cBitsPerSample;
+    UINT        cMaxBlockFrames;
+    ULONGLONG   ullFrames;      // 0 when the encoder did not know
+    SIZE_T      cbFirstFrame;   // Offset of the first audio frame
+} FLACINFO;
+
+HRESULT ParseFlac(CONST BYTE* pbFile, SIZE_T cbFile, FLACINFO* pInfo);
+
+// Decodes the frame at *pcbOffset into psOutput (interleaved,
+// cMaxBlockFrames * cChannels samples) and moves *pcbOffset past it.
+// piScratch holds cMaxBlockFrames * cChannels INTs. S_FALSE at the end
+// of the stream, E_FAIL for a damaged frame.
+HRESULT DecodeFlacFrame(
+    CONST BYTE*         pbFile,
+    SIZE_T              cbFile,
+    CONST FLACINFO&     info,
+    SIZE_T*             pcbOffset,
+    INT*                piScratch,
+    SHORT*              psOutput,
+    UINT*               pcFrames);
+
+#endif // __FLACFILE_H
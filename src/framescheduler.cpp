@@ -0,0 +1,136 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "framescheduler.h"
+
+#include <math.h>
+
+FrameScheduler::FrameScheduler(Clock* pClock, FLOAT fTargetRate)
+    : _pClock(pClock),
+      _fTargetRate(0.0f),
+      _llPeriod(1),
+      _llDeadline(0),
+      _ullFrames(0),
+      _ullLateFrames(0),
+      _ullRenderedFrames(0),
+      _ullSkippedFrames(0)
+{
+    SetTargetRate(fTargetRate);
+    Reset();
+}
+
+VOID FrameScheduler::SetTargetRate(FLOAT fTargetRate)
+{
+    _fTargetRate = fmaxf(FRAME_RATE_MIN, fminf(fTargetRate, FRAME_RATE_MAX));
+
+    _llPeriod = (LONGLONG) ((DOUBLE) _pClock->GetFrequency() / _fTargetRate);
+
+    if (_llPeriod <= 0) {
+        _llPeriod = 1;
+    }
+}
+
+FLOAT FrameScheduler::GetTargetRate() CONST
+{
+    return _fTargetRate;
+}
+
+LONGLONG FrameScheduler::GetPeriod() CONST
+{
+    return _llPeriod;
+}
+
+LONGLONG FrameScheduler::GetNextDeadline() CONST
+{
+    return _llDeadline;
+}
+
+DWORD FrameScheduler::GetTimeout() CONST
+{
+    LONGLONG llFrequency = _pClock->GetFrequency();
+    LONGLONG llRemaining;
+
+    llRemaining = _llDeadline - GetSlack() - _pClock->GetTicks();
+
+    if (llRemaining <= 0) {
+        return 0;
+    }
+
+    // Round up: waking a little late costs less than spinning on a
+    // deadline that is a fraction of a millisecond away
+    return (DWORD) ((llRemaining * 1000 + llFrequency - 1) / llFrequency);
+}
+
+BOOL FrameScheduler::BeginFrame()
+{
+    LONGLONG llNow = _pClock->GetTicks();
+
+    if (llNow < _llDeadline - GetSlack()) {
+        return FALSE;
+    }
+
+    if (llNow - _llDeadline > _llPeriod) {
+        _ullLateFrames++;
+        _llDeadline = llNow + _llPeriod;
+    } else {
+        _llDeadline += _llPeriod;
+    }
+
+    _ullFrames++;
+    return TRUE;
+}
+
+VOID FrameScheduler::EndFrame(BOOL bRendered)
+{
+    if (bRendered == TRUE) {
+        _ullRenderedFrames++;
+    } else {
+        _ullSkippedFrames++;
+    }
+}
+
+ULONGLONG FrameScheduler::GetFrameCount() CONST
+{
+    return _ullFrames;
+}
+
+ULONGLONG FrameScheduler::GetLateFrameCount() CONST
+{
+    return _ullLateFrames;
+}
+
+ULONGLONG FrameScheduler::GetRenderedFrameCount() CONST
+{
+    return _ullRenderedFrames;
+}
+
+ULONGLONG FrameScheduler::GetSkippedFrameCount() CONST
+{
+    return _ullSkippedFrames;
+}
+
+VOID FrameScheduler::Reset()
+{
+    _llDeadline = _pClock->GetTicks();
+}
+
+LONGLONG FrameScheduler::GetSlack() CONST
+{
+    LONGLONG llSlack = _pClock->GetFrequency() / 1000;
+
+    // Never accept a frame earlier than a quarter of the period
+    return (llSlack < _llPeriod / 4) ? llSlack : _llPeriod / 4;
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FRAMESCHEDULER_H
+#define __FRAMESCHEDULER_H
+
+#include "wintypes.h"
+#include "clock.h"
+
+#define FRAME_RATE_DEFAULT  60.0f
+#define FRAME_RATE_MIN      1.0f
+#define FRAME_RATE_MAX      1000.0f
+
+////////////////////////////////////////////////////////////////////////////
+// FrameScheduler
+//
+// Decides when the next frame is due. The message loop asks GetTimeout()
+// how long it may sleep waiting for input, then calls BeginFrame() once
+// it wakes up. A frame that starts more than one period after its
+// deadline is counted as late and the cadence is restarted from "now"
+// instead of trying to catch up.
+//
+// EndFrame() records whether the frame was actually drawn, so idle
+// skipping can be verified from the counters.
+////////////////////////////////////////////////////////////////////////////
+
+class FrameScheduler {
+public:
+    FrameScheduler(Clock* pClock, FLOAT fTargetRate = FRAME_RATE_DEFAULT);
+
+    VOID SetTargetRate(FLOAT fTargetRate);
+    FLOAT GetTargetRate() CONST;
+
+    LONGLONG GetPeriod() CONST;
+    LONGLONG GetNextDeadline() CONST;
+
+    DWORD GetTimeout() CONST;
+
+    BOOL BeginFrame();
+    VOID EndFrame(BOOL bRendered);
+
+    ULONGLONG GetFrameCount() CONST;
+    ULONGLONG GetLateFrameCount() CONST;
+    ULONGLONG GetRenderedFrameCount() CONST;
+    ULONGLONG GetSkippedFrameCount() CONST;
+
+    VOID Reset();
+
+private:
+    LONGLONG GetSlack() CONST;
+
+    Clock*      _pClock;
+    FLOAT       _fTargetRate;
+    LONGLONG    _llPeriod;
+    LONGLONG    _llDeadline;
+    ULONGLONG   _ullFrames;
+    ULONGLONG   _ullLateFrames;
+    ULONGLONG   _ullRenderedFrames;
+    ULONGLONG   _ullSkippedFrames;
+};
+
+#endif // __FRAMESCHEDULER_H
@@ -0,0 +1,258 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "geometry.h"
+
+#include <math.h>
+
+#define DEG_TO_RAD  0.017453292519943295
+
+namespace Geometry {
+
+Point MakePoint(FLOAT x, FLOAT y)
+{
+    Point point;
+
+    point.x = x;
+    point.y = y;
+
+    return point;
+}
+
+Size MakeSize(FLOAT width, FLOAT height)
+{
+    Size size;
+
+    size.width  = width;
+    size.height = height;
+
+    return size;
+}
+
+Rect MakeRect(FLOAT left, FLOAT top, FLOAT right, FLOAT bottom)
+{
+    Rect rect;
+
+    rect.left   = left;
+    rect.top    = top;
+    rect.right  = right;
+    rect.bottom = bottom;
+
+    return rect;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Matrix
+////////////////////////////////////////////////////////////////////////////
+
+Matrix Identity()
+{
+    return Translation(0.0f, 0.0f);
+}
+
+Matrix Translation(FLOAT x, FLOAT y)
+{
+    Matrix matrix;
+
+    matrix._11 = 1.0f; matrix._12 = 0.0f;
+    matrix._21 = 0.0f; matrix._22 = 1.0f;
+    matrix._31 = x;    matrix._32 = y;
+
+    return matrix;
+}
+
+Matrix Scale(CONST Size& scale, CONST Point& center)
+{
+    Matrix matrix;
+
+    matrix._11 = scale.width; matrix._12 = 0.0f;
+    matrix._21 = 0.0f;        matrix._22 = scale.height;
+    matrix._31 = center.x - scale.width  * center.x;
+    matrix._32 = center.y - scale.height * center.y;
+
+    return matrix;
+}
+
+Matrix Rotation(FLOAT fAngle, CONST Point& center)
+{
+    Matrix  matrix;
+    FLOAT   fSin, fCos;
+
+    if (fAngle == 0.0f) {
+        return Identity();
+    }
+
+    fSin = (FLOAT) sin(fAngle * DEG_TO_RAD);
+    fCos = (FLOAT) cos(fAngle * DEG_TO_RAD);
+
+    matrix._11 = fCos;  matrix._12 = fSin;
+    matrix._21 = -fSin; matrix._22 = fCos;
+    matrix._31 = center.x - center.x * fCos + center.y * fSin;
+    matrix._32 = center.y - center.x * fSin - center.y * fCos;
+
+    return matrix;
+}
+
+Matrix Multiply(CONST Matrix& a, CONST Matrix& b)
+{
+    Matrix matrix;
+
+    matrix._11 = a._11 * b._11 + a._12 * b._21;
+    matrix._12 = a._11 * b._12 + a._12 * b._22;
+    matrix._21 = a._21 * b._11 + a._22 * b._21;
+    matrix._22 = a._21 * b._12 + a._22 * b._22;
+    matrix._31 = a._31 * b._11 + a._32 * b._21 + b._31;
+    matrix._32 = a._31 * b._12 + a._32 * b._22 + b._32;
+
+    return matrix;
+}
+
+BOOL Invert(CONST Matrix& matrix, Matrix* pInverse)
+{
+    DOUBLE det, invDet;
+
+    det = (DOUBLE) matrix._11 * matrix._22 - (DOUBLE) matrix._12 * matrix._21;
+
+    if (det == 0.0 || pInverse == NULL) {
+        return FALSE;
+    }
+
+    invDet = 1.0 / det;
+
+    pInverse->_11 = (FLOAT) ( matrix._22 * invDet);
+    pInverse->_12 = (FLOAT) (-matrix._12 * invDet);
+    pInverse->_21 = (FLOAT) (-matrix._21 * invDet);
+    pInverse->_22 = (FLOAT) ( matrix._11 * invDet);
+    pInverse->_31 = (FLOAT) (((DOUBLE) matrix._21 * matrix._32 -
+                              (DOUBLE) matrix._22 * matrix._31) * invDet);
+    pInverse->_32 = (FLOAT) (((DOUBLE) matrix._12 * matrix._31 -
+                              (DOUBLE) matrix._11 * matrix._32) * invDet);
+
+    return TRUE;
+}
+
+Point TransformPoint(CONST Matrix& matrix, CONST Point& point)
+{
+    return MakePoint(
+        point.x * matrix._11 + point.y * matrix._21 + matrix._31,
+        point.x * matrix._12 + point.y * matrix._22 + matrix._32);
+}
+
+Rect TransformBounds(CONST Matrix& matrix, CONST Rect& rect)
+{
+    Point   corners[4];
+    Rect    bounds;
+    INT     i;
+
+    corners[0] = TransformPoint(matrix, MakePoint(rect.left,  rect.top));
+    corners[1] = TransformPoint(matrix, MakePoint(rect.right, rect.top));
+    corners[2] = TransformPoint(matrix, MakePoint(rect.left,  rect.bottom));
+    corners[3] = TransformPoint(matrix, MakePoint(rect.right, rect.bottom));
+
+    bounds = MakeRect(corners[0].x, corners[0].y, corners[0].x, corners[0].y);
+
+    for (i = 1; i < 4; i++) {
+        bounds.left   = fminf(bounds.left,   corners[i].x);
+        bounds.top    = fminf(bounds.top,    corners[i].y);
+        bounds.right  = fmaxf(bounds.right,  corners[i].x);
+        bounds.bottom = fmaxf(bounds.bottom, corners[i].y);
+    }
+
+    return bounds;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Rect
+////////////////////////////////////////////////////////////////////////////
+
+BOOL IsEmpty(CONST Rect& rect)
+{
+    return !(rect.left < rect.right && rect.top < rect.bottom);
+}
+
+FLOAT Area(CONST Rect& rect)
+{
+    if (IsEmpty(rect)) {
+        return 0.0f;
+    }
+
+    return (rect.right - rect.left) * (rect.bottom - rect.top);
+}
+
+Rect Union(CONST Rect& a, CONST Rect& b)
+{
+    if (IsEmpty(a)) {
+        return b;
+    }
+
+    if (IsEmpty(b)) {
+        return a;
+    }
+
+    return MakeRect(
+        fminf(a.left,   b.left),
+        fminf(a.top,    b.top),
+        fmaxf(a.right,  b.right),
+        fmaxf(a.bottom, b.bottom));
+}
+
+Rect Intersect(CONST Rect& a, CONST Rect& b)
+{
+    Rect rect = MakeRect(
+        fmaxf(a.left,   b.left),
+        fmaxf(a.top,    b.top),
+        fminf(a.right,  b.right),
+        fminf(a.bottom, b.bottom));
+
+    if (IsEmpty(rect)) {
+        return MakeRect(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    return rect;
+}
+
+BOOL Intersects(CONST Rect& a, CONST Rect& b)
+{
+    return !IsEmpty(Intersect(a, b));
+}
+
+Rect Inflate(CONST Rect& rect, FLOAT fAmount)
+{
+    if (IsEmpty(rect)) {
+        return rect;
+    }
+
+    return MakeRect(
+        rect.left   - fAmount,
+        rect.top    - fAmount,
+        rect.right  + fAmount,
+        rect.bottom + fAmount);
+}
+
+Rect RoundOut(CONST Rect& rect)
+{
+    if (IsEmpty(rect)) {
+        return rect;
+    }
+
+    return MakeRect(
+        floorf(rect.left),
+        floorf(rect.top),
+        ceilf(rect.right),
+        ceilf(rect.bottom));
+}
+
+} // namespace Geometry
@@ -0,0 +1,93 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __GEOMETRY_H
+#define __GEOMETRY_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Geometry
+//
+// 2D math shared by drawing and damage tracking. Matrix follows the
+// D2D1_MATRIX_3X2_F layout and conventions (row vectors, angles in
+// degrees, clockwise on a y-down surface), so it can be handed to
+// Direct2D field by field.
+////////////////////////////////////////////////////////////////////////////
+
+namespace Geometry {
+
+struct Point {
+    FLOAT x;
+    FLOAT y;
+};
+
+struct Size {
+    FLOAT width;
+    FLOAT height;
+};
+
+struct Rect {
+    FLOAT left;
+    FLOAT top;
+    FLOAT right;
+    FLOAT bottom;
+};
+
+struct Matrix {
+    FLOAT _11, _12;
+    FLOAT _21, _22;
+    FLOAT _31, _32;
+};
+
+Point MakePoint(FLOAT x, FLOAT y);
+Size MakeSize(FLOAT width, FLOAT height);
+Rect MakeRect(FLOAT left, FLOAT top, FLOAT right, FLOAT bottom);
+
+////////////////////////////////////////////////////////////////////////////
+
+Matrix Identity();
+Matrix Translation(FLOAT x, FLOAT y);
+Matrix Scale(CONST Size& scale, CONST Point& center);
+Matrix Rotation(FLOAT fAngle, CONST Point& center);
+
+// a * b: apply a first, then b
+Matrix Multiply(CONST Matrix& a, CONST Matrix& b);
+
+BOOL Invert(CONST Matrix& matrix, Matrix* pInverse);
+
+Point TransformPoint(CONST Matrix& matrix, CONST Point& point);
+
+// Axis-aligned bounds of a transformed rectangle
+Rect TransformBounds(CONST Matrix& matrix, CONST Rect& rect);
+
+////////////////////////////////////////////////////////////////////////////
+
+BOOL IsEmpty(CONST Rect& rect);
+FLOAT Area(CONST Rect& rect);
+
+Rect Union(CONST Rect& a, CONST Rect& b);
+Rect Intersect(CONST Rect& a, CONST Rect& b);
+BOOL Intersects(CONST Rect& a, CONST Rect& b);
+
+Rect Inflate(CONST Rect& rect, FLOAT fAmount);
+
+// Snap outwards to whole pixels
+Rect RoundOut(CONST Rect& rect);
+
+} // namespace Geometry
+
+#endif // __GEOMETRY_H
@@ -0,0 +1,164 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "histogram.h"
+
+#include <string.h>
+
+#include "atomic.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Position of the highest bit set, ulValue != 0
+static inline UINT HighestBit(ULONG ulValue)
+{
+#if defined(_MSC_VER)
+    unsigned long ulIndex;
+
+    _BitScanReverse(&ulIndex, ulValue);
+    return (UINT) ulIndex;
+#else
+    return 31 - (UINT) __builtin_clz((unsigned int) ulValue);
+#endif
+}
+
+Histogram::Histogram()
+{
+    Reset();
+}
+
+VOID Histogram::Record(ULONG ulValue)
+{
+    AtomicIncrement(&_lCounts[GetBucket(ulValue)]);
+}
+
+ULONGLONG Histogram::GetCount() CONST
+{
+    ULONGLONG   ullCount = 0;
+    UINT        i;
+
+    for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        ullCount += (ULONG) AtomicLoadAcquire(&_lCounts[i]);
+    }
+
+    return ullCount;
+}
+
+ULONG Histogram::GetPercentile(DOUBLE fPercentile) CONST
+{
+    ULONG       counts[HISTOGRAM_BUCKETS];
+    ULONGLONG   ullCount = 0, ullRank, ullSeen = 0;
+    UINT        i;
+
+    // One pass over the counts, so the total and the walk agree
+    for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        counts[i] = (ULONG) AtomicLoadAcquire(&_lCounts[i]);
+        ullCount += counts[i];
+    }
+
+    if (ullCount == 0) {
+        return 0;
+    }
+
+    if (fPercentile < 0.0) {
+        fPercentile = 0.0;
+    } else if (fPercentile > 100.0) {
+        fPercentile = 100.0;
+    }
+
+    // The sample at the percentile, counting from 1
+    ullRank = (ULONGLONG) (fPercentile / 100.0 * ullCount + 0.5);
+
+    if (ullRank == 0) {
+        ullRank = 1;
+    }
+
+    for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        ullSeen += counts[i];
+
+        if (ullSeen >= ullRank) {
+            return GetBucketLimit(i);
+        }
+    }
+
+    return GetBucketLimit(HISTOGRAM_BUCKETS - 1);
+}
+
+ULONG Histogram::GetMax() CONST
+{
+    UINT i = HISTOGRAM_BUCKETS;
+
+    while (i > 0) {
+        i--;
+
+        if (AtomicLoadAcquire(&_lCounts[i]) != 0) {
+            return GetBucketLimit(i);
+        }
+    }
+
+    return 0;
+}
+
+VOID Histogram::Add(CONST Histogram& other)
+{
+    UINT i;
+
+    for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        _lCounts[i] += AtomicLoadAcquire(&other._lCounts[i]);
+    }
+}
+
+VOID Histogram::Reset()
+{
+    memset((VOID*) _lCounts, 0, sizeof(_lCounts));
+}
+
+UINT Histogram::GetBucket(ULONG ulValue)
+{
+    UINT uBit;
+
+    if (ulValue < HISTOGRAM_EXACT) {
+        return (UINT) ulValue;
+    }
+
+    // The top bit picks the power of two, the next three the eighth of it
+    uBit = HighestBit(ulValue);
+
+    return HISTOGRAM_EXACT +
+           ((uBit - 4) << HISTOGRAM_SUB_BITS) +
+           ((ulValue >> (uBit - HISTOGRAM_SUB_BITS)) &
+            ((1 << HISTOGRAM_SUB_BITS) - 1));
+}
+
+ULONG Histogram::GetBucketLimit(UINT uBucket)
+{
+    UINT    uBit, uSub;
+    ULONG   ulLow;
+
+    if (uBucket < HISTOGRAM_EXACT) {
+        return (ULONG) uBucket;
+    }
+
+    uBit = ((uBucket - HISTOGRAM_EXACT) >> HISTOGRAM_SUB_BITS) + 4;
+    uSub = (uBucket - HISTOGRAM_EXACT) & ((1 << HISTOGRAM_SUB_BITS) - 1);
+
+    ulLow = (ULONG) ((1 << HISTOGRAM_SUB_BITS) + uSub) <<
+            (uBit - HISTOGRAM_SUB_BITS);
+
+    return ulLow + ((ULONG) 1 << (uBit - HISTOGRAM_SUB_BITS)) - 1;
+}
@@ -0,0 +1,67 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __HISTOGRAM_H
+#define __HISTOGRAM_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Histogram
+//
+// Counts values in log-linear buckets: 0 to 15 exactly, then eight
+// buckets per power of two, so a percentile is never more than 1/8 off
+// whatever the magnitude. Record() is one atomic increment and may be
+// called from any number of threads at once; the queries read the counts
+// as they are, so a percentile taken while samples come in may be one
+// or two samples behind.
+////////////////////////////////////////////////////////////////////////////
+
+#define HISTOGRAM_EXACT         16      // Values below get their own bucket
+#define HISTOGRAM_SUB_BITS      3       // 8 buckets per power of two
+#define HISTOGRAM_BUCKETS       \
+    (HISTOGRAM_EXACT + (32 - 4) * (1 << HISTOGRAM_SUB_BITS))
+
+class Histogram {
+public:
+    Histogram();
+
+    VOID Record(ULONG ulValue);
+
+    ULONGLONG GetCount() CONST;
+
+    // The largest value of the bucket the percentile (0 to 100) falls
+    // in; 0 while nothing was recorded
+    ULONG GetPercentile(DOUBLE fPercentile) CONST;
+
+    // The largest value of the highest bucket in use
+    ULONG GetMax() CONST;
+
+    // Adds the other's counts to these; the other may go on recording,
+    // but not this one
+    VOID Add(CONST Histogram& other);
+
+    // Not while another thread records
+    VOID Reset();
+
+    static UINT GetBucket(ULONG ulValue);
+    static ULONG GetBucketLimit(UINT uBucket);
+
+private:
+    volatile LONG   _lCounts[HISTOGRAM_BUCKETS];
+};
+
+#endif // __HISTOGRAM_H
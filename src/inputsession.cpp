@@ -0,0 +1,246 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "inputsession.h"
+
+#include <string.h>
+
+#include "safemem.h"
+
+InputSession::InputSession(Clock* pClock, Engine* pEngine)
+    : _pClock(pClock),
+      _pEngine(pEngine),
+      _motion(pClock),
+      _pTrace(NULL)
+{
+}
+
+InputSession::~InputSession()
+{
+    SafeDelete(&_pTrace);
+}
+
+VOID InputSession::SetTrace(InputTraceWriter* pTrace)
+{
+    if (pTrace != _pTrace) {
+        SafeDelete(&_pTrace);
+        _pTrace = pTrace;
+    }
+}
+
+InputTraceWriter* InputSession::GetTrace()
+{
+    return _pTrace;
+}
+
+DeltaAccumulator* InputSession::GetMotion()
+{
+    return &_motion;
+}
+
+VOID InputSession::OnDisplay(FLOAT fWidth, FLOAT fHeight)
+{
+    Record(IR_DISPLAY, 0, 0, fWidth, fHeight);
+    _pEngine->SetViewport(fWidth, fHeight);
+}
+
+VOID InputSession::OnDpiScale(FLOAT fDpiScale)
+{
+    Record(IR_DPI_SCALE, 0, 0, fDpiScale, 0.0f);
+    _pEngine->SetDpiScale(fDpiScale);
+}
+
+VOID InputSession::OnCenter()
+{
+    Record(IR_CENTER, 0, 0, 0.0f, 0.0f);
+    _pEngine->CenterPointer();
+}
+
+VOID InputSession::OnShow(FLOAT fRefreshRate)
+{
+    Record(IR_SHOW, 0, 0, fRefreshRate, 0.0f);
+
+    _pEngine->GetScheduler()->SetTargetRate(fRefreshRate);
+    _pEngine->Invalidate();
+    _motion.Reset();
+}
+
+VOID InputSession::OnHide()
+{
+    Record(IR_HIDE, 0, 0, 0.0f, 0.0f);
+    _motion.Reset();
+
+    // Nothing is on screen to stutter, so write the trace out now
+    if (_pTrace != NULL) {
+        _pTrace->Flush();
+    }
+}
+
+VOID InputSession::OnCounts(LONG lCountsX, LONG lCountsY)
+{
+    Record(IR_COUNTS, lCountsX, lCountsY, 0.0f, 0.0f);
+    _motion.AddCounts(lCountsX, lCountsY);
+}
+
+VOID InputSession::OnPixels(FLOAT fDeltaX, FLOAT fDeltaY)
+{
+    Record(IR_PIXELS, 0, 0, fDeltaX, fDeltaY);
+    _motion.AddPixels(fDeltaX, fDeltaY);
+}
+
+VOID InputSession::Flush()
+{
+    INPUTEVENT event;
+
+    memset(&event, 0, sizeof(event));
+
+    event.type = IE_MOVE;
+
+    if (_motion.TakeDelta(&event.fDeltaX, &event.fDeltaY) == FALSE) {
+        return;
+    }
+
+    // Only flushes that moved something are worth the bytes
+    Record(IR_FLUSH, 0, 0, 0.0f, 0.0f);
+
+    event.llTime = _motion.GetLastTime();
+
+    _pEngine->HandleInput(event);
+}
+
+VOID InputSession::OnPress()
+{
+    Record(IR_PRESS, 0, 0, 0.0f, 0.0f);
+    HandleInput(IE_PRESS, 0);
+}
+
+VOID InputSession::OnRelease()
+{
+    Record(IR_RELEASE, 0, 0, 0.0f, 0.0f);
+    HandleInput(IE_RELEASE, 0);
+}
+
+VOID InputSession::OnWheel(INT iWheelDelta)
+{
+    Record(IR_WHEEL, iWheelDelta, 0, 0.0f, 0.0f);
+    HandleInput(IE_WHEEL, iWheelDelta);
+}
+
+VOID InputSession::OnToggleMarker()
+{
+    Record(IR_TOGGLE_MARKER, 0, 0, 0.0f, 0.0f);
+    HandleInput(IE_TOGGLE_MARKER, 0);
+}
+
+BOOL InputSession::Tick()
+{
+    Record(IR_TICK, 0, 0, 0.0f, 0.0f);
+    return _pEngine->Tick();
+}
+
+VOID InputSession::Suspend()
+{
+    Record(IR_SUSPEND, 0, 0, 0.0f, 0.0f);
+    _pEngine->Suspend();
+}
+
+VOID InputSession::Apply(CONST INPUTRECORD& record)
+{
+    switch (record.type) {
+        case IR_DISPLAY:
+            OnDisplay(record.fX, record.fY);
+            break;
+        case IR_DPI_SCALE:
+            OnDpiScale(record.fX);
+            break;
+        case IR_CENTER:
+            OnCenter();
+            break;
+        case IR_SHOW:
+            OnShow(record.fX);
+            break;
+        case IR_HIDE:
+            OnHide();
+            break;
+        case IR_COUNTS:
+            OnCounts(record.lX, record.lY);
+            break;
+        case IR_PIXELS:
+            OnPixels(record.fX, record.fY);
+            break;
+        case IR_FLUSH:
+            Flush();
+            break;
+        case IR_PRESS:
+            OnPress();
+            break;
+        case IR_RELEASE:
+            OnRelease();
+            break;
+        case IR_WHEEL:
+            OnWheel(record.lX);
+            break;
+        case IR_TOGGLE_MARKER:
+            OnToggleMarker();
+            break;
+        case IR_TICK:
+            Tick();
+            break;
+        case IR_SUSPEND:
+            Suspend();
+            break;
+        default:
+            break;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID InputSession::Record(
+    INPUTRECORDTYPE type,
+    LONG            lX,
+    LONG            lY,
+    FLOAT           fX,
+    FLOAT           fY)
+{
+    INPUTRECORD record;
+
+    if (_pTrace == NULL) {
+        return;
+    }
+
+    record.type = type;
+    record.llTime = _pClock->GetTicks();
+    record.lX = lX;
+    record.lY = lY;
+    record.fX = fX;
+    record.fY = fY;
+
+    _pTrace->Write(record);
+}
+
+VOID InputSession::HandleInput(INPUTEVENTTYPE type, INT iWheelDelta)
+{
+    INPUTEVENT event;
+
+    memset(&event, 0, sizeof(event));
+
+    event.type = type;
+    event.llTime = _pClock->GetTicks();
+    event.iWheelDelta = iWheelDelta;
+
+    _pEngine->HandleInput(event);
+}
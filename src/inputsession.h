@@ -0,0 +1,82 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __INPUTSESSION_H
+#define __INPUTSESSION_H
+
+#include "wintypes.h"
+#include "clock.h"
+#include "deltaaccumulator.h"
+#include "engine.h"
+#include "inputtrace.h"
+
+////////////////////////////////////////////////////////////////////////////
+// InputSession
+//
+// The portable half of Application's message handlers. The window
+// procedure decodes a message and calls one of these; each one can be
+// recorded into an input trace, and Apply() plays a recorded one back
+// through the very same code. With a ManualClock set to each record's
+// time, a replay leaves the Pointer in exactly the state the recording
+// did, on any machine.
+////////////////////////////////////////////////////////////////////////////
+
+class InputSession {
+public:
+    InputSession(Clock* pClock, Engine* pEngine);
+    ~InputSession();
+
+    // Records every call from now on; takes ownership, NULL stops
+    VOID SetTrace(InputTraceWriter* pTrace);
+    InputTraceWriter* GetTrace();
+
+    DeltaAccumulator* GetMotion();
+
+    VOID OnDisplay(FLOAT fWidth, FLOAT fHeight);
+    VOID OnDpiScale(FLOAT fDpiScale);
+    VOID OnCenter();
+
+    VOID OnShow(FLOAT fRefreshRate);
+    VOID OnHide();
+
+    VOID OnCounts(LONG lCountsX, LONG lCountsY);
+    VOID OnPixels(FLOAT fDeltaX, FLOAT fDeltaY);
+
+    // Hands the motion gathered since the last call to the engine
+    VOID Flush();
+
+    VOID OnPress();
+    VOID OnRelease();
+    VOID OnWheel(INT iWheelDelta);
+    VOID OnToggleMarker();
+
+    BOOL Tick();
+    VOID Suspend();
+
+    // Does what the call that recorded it did, at the clock's time
+    VOID Apply(CONST INPUTRECORD& record);
+
+private:
+    VOID Record(INPUTRECORDTYPE type, LONG lX, LONG lY, FLOAT fX, FLOAT fY);
+    VOID HandleInput(INPUTEVENTTYPE type, INT iWheelDelta);
+
+    Clock*              _pClock;
+    Engine*             _pEngine;
+    DeltaAccumulator    _motion;
+    InputTraceWriter*   _pTrace;
+};
+
+#endif // __INPUTSESSION_H
@@ -0,0 +1,467 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "inputtrace.h"
+
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define TRACE_MAGIC         0x54495046      // "FPIT"
+#define TRACE_HEADER_SIZE   32
+
+static SIZE_T PutDword(BYTE* pb, DWORD dwValue)
+{
+    pb[0] = (BYTE) dwValue;
+    pb[1] = (BYTE) (dwValue >> 8);
+    pb[2] = (BYTE) (dwValue >> 16);
+    pb[3] = (BYTE) (dwValue >> 24);
+    return 4;
+}
+
+static SIZE_T PutQword(BYTE* pb, ULONGLONG ullValue)
+{
+    PutDword(pb, (DWORD) ullValue);
+    PutDword(pb + 4, (DWORD) (ullValue >> 32));
+    return 8;
+}
+
+static SIZE_T PutVarint(BYTE* pb, ULONGLONG ullValue)
+{
+    SIZE_T cb = 0;
+
+    while (ullValue >= 0x80) {
+        pb[cb++] = (BYTE) (ullValue | 0x80);
+        ullValue >>= 7;
+    }
+
+    pb[cb++] = (BYTE) ullValue;
+    return cb;
+}
+
+// Small magnitudes of either sign stay short
+static SIZE_T PutSigned(BYTE* pb, LONG lValue)
+{
+    DWORD dwValue = (DWORD) lValue;
+
+    return PutVarint(pb, (dwValue << 1) ^ (DWORD) -(LONG) (dwValue >> 31));
+}
+
+static SIZE_T PutFloat(BYTE* pb, FLOAT fValue)
+{
+    DWORD dwBits;
+
+    memcpy(&dwBits, &fValue, sizeof(dwBits));
+    return PutDword(pb, dwBits);
+}
+
+static DWORD GetDword(CONST BYTE* pb)
+{
+    return (DWORD) pb[0] |
+           ((DWORD) pb[1] << 8) |
+           ((DWORD) pb[2] << 16) |
+           ((DWORD) pb[3] << 24);
+}
+
+static ULONGLONG GetQword(CONST BYTE* pb)
+{
+    return (ULONGLONG) GetDword(pb) | ((ULONGLONG) GetDword(pb + 4) << 32);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// InputTraceWriter
+////////////////////////////////////////////////////////////////////////////
+
+InputTraceWriter::InputTraceWriter()
+    : _cbBuffered(0),
+      _ullSize(0),
+      _llLastTime(0),
+      _hResult(S_OK)
+{
+#ifdef _WIN32
+    _hFile = INVALID_HANDLE_VALUE;
+#else
+    _fd = -1;
+#endif
+}
+
+InputTraceWriter::~InputTraceWriter()
+{
+    Flush();
+
+#ifdef _WIN32
+    if (_hFile != INVALID_HANDLE_VALUE) {
+        CloseHandle(_hFile);
+    }
+#else
+    if (_fd >= 0) {
+        close(_fd);
+    }
+#endif
+}
+
+HRESULT InputTraceWriter::CreateInputTraceWriter(
+    LPCTSTR                 lpszPath,
+    CONST INPUTTRACEINFO&   info,
+    InputTraceWriter**      ppWriter)
+{
+    InputTraceWriter*   pWriter = NULL;
+    BYTE*               pb;
+    HRESULT             hResult = S_OK;
+
+    if (lpszPath == NULL || ppWriter == NULL || info.llFrequency <= 0) {
+        return E_INVALIDARG;
+    }
+
+    pWriter = new InputTraceWriter();
+
+    if (pWriter == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+#ifdef _WIN32
+    pWriter->_hFile = CreateFile(
+        lpszPath,
+        GENERIC_WRITE,
+        FILE_SHARE_READ,
+        NULL,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+
+    if (pWriter->_hFile == INVALID_HANDLE_VALUE) {
+        hResult = HRESULT_FROM_WIN32(GetLastError());
+        goto failed;
+    }
+#else // _WIN32
+    pWriter->_fd = open(lpszPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (pWriter->_fd < 0) {
+        hResult = E_FAIL;
+        goto failed;
+    }
+#endif // _WIN32
+
+    pb = pWriter->_buffer;
+
+    pb += PutDword(pb, TRACE_MAGIC);
+    pb += PutDword(pb, INPUT_TRACE_VERSION);
+    pb += PutQword(pb, (ULONGLONG) info.llFrequency);
+    pb += PutQword(pb, (ULONGLONG) info.llStart);
+    pb += PutDword(pb, info.uSpriteWidth);
+    pb += PutDword(pb, info.uSpriteHeight);
+
+    pWriter->_cbBuffered = TRACE_HEADER_SIZE;
+    pWriter->_llLastTime = info.llStart;
+
+    *ppWriter = pWriter;
+    return S_OK;
+
+failed:
+    delete pWriter;
+    return hResult;
+}
+
+VOID InputTraceWriter::Write(CONST INPUTRECORD& record)
+{
+    BYTE*       pb;
+    LONGLONG    llDelta;
+
+    if (FAILED(_hResult) || (UINT) record.type >= IR_TYPE_COUNT) {
+        return;
+    }
+
+    if (_cbBuffered + MAX_RECORD_SIZE > BUFFER_SIZE && FAILED(Flush())) {
+        return;
+    }
+
+    llDelta = record.llTime - _llLastTime;
+
+    if (llDelta < 0) {
+        llDelta = 0;
+    }
+
+    pb = _buffer + _cbBuffered;
+
+    *pb++ = (BYTE) record.type;
+    pb += PutVarint(pb, (ULONGLONG) llDelta);
+
+    switch (record.type) {
+        case IR_DISPLAY:
+        case IR_PIXELS:
+            pb += PutFloat(pb, record.fX);
+            pb += PutFloat(pb, record.fY);
+            break;
+        case IR_DPI_SCALE:
+        case IR_SHOW:
+            pb += PutFloat(pb, record.fX);
+            break;
+        case IR_COUNTS:
+            pb += PutSigned(pb, record.lX);
+            pb += PutSigned(pb, record.lY);
+            break;
+        case IR_WHEEL:
+            pb += PutSigned(pb, record.lX);
+            break;
+        default:
+            break;
+    }
+
+    _cbBuffered = (SIZE_T) (pb - _buffer);
+    _llLastTime += llDelta;
+}
+
+HRESULT InputTraceWriter::Flush()
+{
+    if (SUCCEEDED(_hResult) && _cbBuffered > 0) {
+        _hResult = WriteData(_buffer, _cbBuffered);
+
+        if (SUCCEEDED(_hResult)) {
+            _ullSize += _cbBuffered;
+        }
+    }
+
+    _cbBuffered = 0;
+    return _hResult;
+}
+
+ULONGLONG InputTraceWriter::GetSize() CONST
+{
+    return _ullSize + _cbBuffered;
+}
+
+HRESULT InputTraceWriter::WriteData(CONST BYTE* pbData, SIZE_T cbData)
+{
+#ifdef _WIN32
+    DWORD   cbWritten;
+
+    while (cbData > 0) {
+        if (::WriteFile(
+                _hFile,
+                pbData,
+                (DWORD) cbData,
+                &cbWritten,
+                NULL) == FALSE)
+        {
+            return HRESULT_FROM_WIN32(GetLastError());
+        }
+
+        pbData += cbWritten;
+        cbData -= cbWritten;
+    }
+#else // _WIN32
+    ssize_t cbWritten;
+
+    while (cbData > 0) {
+        cbWritten = write(_fd, pbData, cbData);
+
+        if (cbWritten <= 0) {
+            return E_FAIL;
+        }
+
+        pbData += cbWritten;
+        cbData -= (SIZE_T) cbWritten;
+    }
+#endif // _WIN32
+
+    return S_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// InputTraceReader
+////////////////////////////////////////////////////////////////////////////
+
+InputTraceReader::InputTraceReader()
+    : _pbData(NULL),
+      _cbData(0),
+      _cbOffset(0),
+      _cbRecords(0),
+      _llTime(0),
+      _bTruncated(FALSE)
+{
+    memset(&_info, 0, sizeof(_info));
+}
+
+HRESULT InputTraceReader::CreateInputTraceReader(
+    CONST BYTE*         pbData,
+    SIZE_T              cbData,
+    InputTraceReader**  ppReader)
+{
+    InputTraceReader* pReader = NULL;
+
+    if (pbData == NULL || ppReader == NULL) {
+        return E_INVALIDARG;
+    }
+
+    if (cbData < TRACE_HEADER_SIZE ||
+        GetDword(pbData) != TRACE_MAGIC ||
+        GetDword(pbData + 4) != INPUT_TRACE_VERSION ||
+        (LONGLONG) GetQword(pbData + 8) <= 0)
+    {
+        return E_INVALIDARG;
+    }
+
+    pReader = new InputTraceReader();
+
+    if (pReader == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    pReader->_pbData = pbData;
+    pReader->_cbData = cbData;
+    pReader->_cbRecords = TRACE_HEADER_SIZE;
+
+    pReader->_info.llFrequency = (LONGLONG) GetQword(pbData + 8);
+    pReader->_info.llStart = (LONGLONG) GetQword(pbData + 16);
+    pReader->_info.uSpriteWidth = GetDword(pbData + 24);
+    pReader->_info.uSpriteHeight = GetDword(pbData + 28);
+
+    pReader->Rewind();
+
+    *ppReader = pReader;
+    return S_OK;
+}
+
+VOID InputTraceReader::GetInfo(INPUTTRACEINFO* pInfo) CONST
+{
+    if (pInfo != NULL) {
+        *pInfo = _info;
+    }
+}
+
+BOOL InputTraceReader::Read(INPUTRECORD* pRecord)
+{
+    SIZE_T      cbStart = _cbOffset;
+    ULONGLONG   ullDelta;
+    BYTE        bType;
+    BOOL        bRead = TRUE;
+
+    if (_cbOffset >= _cbData || _bTruncated == TRUE) {
+        return FALSE;
+    }
+
+    memset(pRecord, 0, sizeof(*pRecord));
+
+    bType = _pbData[_cbOffset++];
+
+    if (bType >= IR_TYPE_COUNT || ReadVarint(&ullDelta) == FALSE ||
+        ullDelta > (ULONGLONG) 0x7FFFFFFFFFFFFFFFLL - (ULONGLONG) _llTime)
+    {
+        goto truncated;
+    }
+
+    pRecord->type = (INPUTRECORDTYPE) bType;
+    pRecord->llTime = _llTime + (LONGLONG) ullDelta;
+
+    switch (pRecord->type) {
+        case IR_DISPLAY:
+        case IR_PIXELS:
+            bRead = ReadFloat(&pRecord->fX) && ReadFloat(&pRecord->fY);
+            break;
+        case IR_DPI_SCALE:
+        case IR_SHOW:
+            bRead = ReadFloat(&pRecord->fX);
+            break;
+        case IR_COUNTS:
+            bRead = ReadSigned(&pRecord->lX) && ReadSigned(&pRecord->lY);
+            break;
+        case IR_WHEEL:
+            bRead = ReadSigned(&pRecord->lX);
+            break;
+        default:
+            break;
+    }
+
+    if (bRead == FALSE) {
+        goto truncated;
+    }
+
+    _llTime = pRecord->llTime;
+    return TRUE;
+
+truncated:
+    _cbOffset = cbStart;
+    _bTruncated = TRUE;
+    return FALSE;
+}
+
+BOOL InputTraceReader::IsTruncated() CONST
+{
+    return _bTruncated;
+}
+
+VOID InputTraceReader::Rewind()
+{
+    _cbOffset = _cbRecords;
+    _llTime = _info.llStart;
+    _bTruncated = FALSE;
+}
+
+BOOL InputTraceReader::ReadVarint(ULONGLONG* pullValue)
+{
+    ULONGLONG   ullValue = 0;
+    UINT        uShift;
+    BYTE        b;
+
+    for (uShift = 0; uShift < 64; uShift += 7) {
+        if (_cbOffset >= _cbData) {
+            return FALSE;
+        }
+
+        b = _pbData[_cbOffset++];
+        ullValue |= (ULONGLONG) (b & 0x7F) << uShift;
+
+        if ((b & 0x80) == 0) {
+            *pullValue = ullValue;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+BOOL InputTraceReader::ReadSigned(LONG* plValue)
+{
+    ULONGLONG   ullValue;
+    DWORD       dwValue;
+
+    if (ReadVarint(&ullValue) == FALSE || ullValue > 0xFFFFFFFFULL) {
+        return FALSE;
+    }
+
+    dwValue = (DWORD) ullValue;
+
+    *plValue = (LONG) ((dwValue >> 1) ^ (DWORD) -(LONG) (dwValue & 1));
+    return TRUE;
+}
+
+BOOL InputTraceReader::ReadFloat(FLOAT* pfValue)
+{
+    DWORD dwBits;
+
+    if (_cbData - _cbOffset < 4) {
+        return FALSE;
+    }
+
+    dwBits = GetDword(_pbData + _cbOffset);
+    _cbOffset += 4;
+
+    memcpy(pfValue, &dwBits, sizeof(dwBits));
+    return TRUE;
+}
@@ -0,0 +1,153 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __INPUTTRACE_H
+#define __INPUTTRACE_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Input traces
+//
+// Everything InputSession is told, in order, so it can be told again.
+// A trace is a header followed by records:
+//
+//   header  "FPIT", version, clock frequency, first tick and the sprite
+//           size, little-endian
+//   record  type byte, ticks since the previous record (unsigned LEB128)
+//           and the type's payload: integers as zigzag LEB128, floats
+//           as their 4 IEEE bytes so they come back bit for bit
+//
+// A mouse packet takes about five bytes. A trace cut short, say by a
+// crash, reads up to its last whole record.
+////////////////////////////////////////////////////////////////////////////
+
+#define INPUT_TRACE_VERSION     1
+
+typedef enum _INPUTRECORDTYPE {
+    IR_DISPLAY,         // fX, fY: viewport size
+    IR_DPI_SCALE,       // fX
+    IR_CENTER,
+    IR_SHOW,            // fX: refresh rate
+    IR_HIDE,
+    IR_COUNTS,          // lX, lY: raw mouse counts
+    IR_PIXELS,          // fX, fY: motion in pixels
+    IR_FLUSH,
+    IR_PRESS,
+    IR_RELEASE,
+    IR_WHEEL,           // lX: WHEEL_DELTA units
+    IR_TOGGLE_MARKER,
+    IR_TICK,
+    IR_SUSPEND,
+    IR_TYPE_COUNT
+} INPUTRECORDTYPE;
+
+typedef struct _INPUTRECORD {
+    INPUTRECORDTYPE type;
+    LONGLONG        llTime;     // Clock ticks
+    LONG            lX;
+    LONG            lY;
+    FLOAT           fX;
+    FLOAT           fY;
+} INPUTRECORD;
+
+typedef struct _INPUTTRACEINFO {
+    LONGLONG    llFrequency;
+    LONGLONG    llStart;        // Clock ticks when recording started
+    UINT        uSpriteWidth;
+    UINT        uSpriteHeight;
+} INPUTTRACEINFO;
+
+////////////////////////////////////////////////////////////////////////////
+// InputTraceWriter - buffers records and writes them out in blocks.
+// After a write error it quietly drops everything else.
+////////////////////////////////////////////////////////////////////////////
+
+class InputTraceWriter {
+public:
+    static HRESULT CreateInputTraceWriter(
+        LPCTSTR                 lpszPath,
+        CONST INPUTTRACEINFO&   info,
+        InputTraceWriter**      ppWriter);
+
+    ~InputTraceWriter();
+
+    // Times must not go backwards
+    VOID Write(CONST INPUTRECORD& record);
+
+    HRESULT Flush();
+
+    ULONGLONG GetSize() CONST;
+
+private:
+    enum { BUFFER_SIZE = 64 * 1024, MAX_RECORD_SIZE = 32 };
+
+    InputTraceWriter();
+
+    HRESULT WriteData(CONST BYTE* pbData, SIZE_T cbData);
+
+    BYTE        _buffer[BUFFER_SIZE];
+    SIZE_T      _cbBuffered;
+    ULONGLONG   _ullSize;
+    LONGLONG    _llLastTime;
+    HRESULT     _hResult;
+
+#ifdef _WIN32
+    HANDLE      _hFile;
+#else
+    int         _fd;
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////
+// InputTraceReader - walks a trace in memory, usually a MappedFile. The
+// data has to outlive the reader.
+////////////////////////////////////////////////////////////////////////////
+
+class InputTraceReader {
+public:
+    static HRESULT CreateInputTraceReader(
+        CONST BYTE*         pbData,
+        SIZE_T              cbData,
+        InputTraceReader**  ppReader);
+
+    VOID GetInfo(INPUTTRACEINFO* pInfo) CONST;
+
+    // FALSE at the end, or at the first record that does not make sense
+    BOOL Read(INPUTRECORD* pRecord);
+
+    // TRUE once Read() has stopped anywhere but the clean end
+    BOOL IsTruncated() CONST;
+
+    VOID Rewind();
+
+private:
+    InputTraceReader();
+
+    BOOL ReadVarint(ULONGLONG* pullValue);
+    BOOL ReadSigned(LONG* plValue);
+    BOOL ReadFloat(FLOAT* pfValue);
+
+    CONST BYTE*     _pbData;
+    SIZE_T          _cbData;
+    SIZE_T          _cbOffset;
+    SIZE_T          _cbRecords;     // Where the first record starts
+    INPUTTRACEINFO  _info;
+    LONGLONG        _llTime;
+    BOOL            _bTruncated;
+};
+
+#endif // __INPUTTRACE_H
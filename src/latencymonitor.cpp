@@ -0,0 +1,132 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "latencymonitor.h"
+
+#include <stdio.h>
+
+// Longer than any frame should ever take, microseconds
+#define LATENCY_MAX_SAMPLE  0xFFFFFFFFu
+
+static CONST LPCSTR METRIC_NAMES[LATENCY_METRIC_COUNT] = {
+    "input-to-present",
+    "update",
+    "draw",
+    "present"
+};
+
+LatencyMonitor::LatencyMonitor(Clock* pClock)
+    : _pClock(pClock),
+      _fMicrosecondsPerTick(1000000.0 / pClock->GetFrequency())
+{
+}
+
+LONGLONG LatencyMonitor::Stamp() CONST
+{
+    return _pClock->GetTicks();
+}
+
+VOID LatencyMonitor::Record(
+    LATENCYMETRIC   metric,
+    LONGLONG        llStart,
+    LONGLONG        llEnd)
+{
+    DOUBLE fMicroseconds;
+
+    if ((UINT) metric >= LATENCY_METRIC_COUNT) {
+        return;
+    }
+
+    fMicroseconds = (llEnd > llStart)
+                  ? (DOUBLE) (llEnd - llStart) * _fMicrosecondsPerTick
+                  : 0.0;
+
+    if (fMicroseconds > (DOUBLE) LATENCY_MAX_SAMPLE) {
+        fMicroseconds = (DOUBLE) LATENCY_MAX_SAMPLE;
+    }
+
+    _histograms[metric].Record((ULONG) fMicroseconds);
+}
+
+CONST Histogram* LatencyMonitor::GetHistogram(LATENCYMETRIC metric) CONST
+{
+    if ((UINT) metric >= LATENCY_METRIC_COUNT) {
+        return NULL;
+    }
+
+    return &_histograms[metric];
+}
+
+LPCSTR LatencyMonitor::GetMetricName(LATENCYMETRIC metric)
+{
+    if ((UINT) metric >= LATENCY_METRIC_COUNT) {
+        return "";
+    }
+
+    return METRIC_NAMES[metric];
+}
+
+SIZE_T LatencyMonitor::FormatReport(LPSTR pszBuffer, SIZE_T cchBuffer) CONST
+{
+    CONST Histogram*    pHistogram;
+    SIZE_T              cchWritten = 0;
+    INT                 cch;
+    UINT                i;
+
+    cch = snprintf(
+        pszBuffer,
+        cchBuffer,
+        "%-18s %10s %10s %10s %10s %10s\n",
+        "metric (us)", "samples", "p50", "p95", "p99", "max");
+
+    if (cch < 0 || (SIZE_T) cch >= cchBuffer) {
+        return 0;
+    }
+
+    cchWritten = (SIZE_T) cch;
+
+    for (i = 0; i < LATENCY_METRIC_COUNT; i++) {
+        pHistogram = &_histograms[i];
+
+        cch = snprintf(
+            pszBuffer + cchWritten,
+            cchBuffer - cchWritten,
+            "%-18s %10llu %10lu %10lu %10lu %10lu\n",
+            METRIC_NAMES[i],
+            (unsigned long long) pHistogram->GetCount(),
+            (unsigned long) pHistogram->GetPercentile(50.0),
+            (unsigned long) pHistogram->GetPercentile(95.0),
+            (unsigned long) pHistogram->GetPercentile(99.0),
+            (unsigned long) pHistogram->GetMax());
+
+        if (cch < 0 || (SIZE_T) cch >= cchBuffer - cchWritten) {
+            return 0;
+        }
+
+        cchWritten += (SIZE_T) cch;
+    }
+
+    return cchWritten;
+}
+
+VOID LatencyMonitor::Reset()
+{
+    UINT i;
+
+    for (i = 0; i < LATENCY_METRIC_COUNT; i++) {
+        _histograms[i].Reset();
+    }
+}
@@ -0,0 +1,74 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LATENCYMONITOR_H
+#define __LATENCYMONITOR_H
+
+#include "wintypes.h"
+#include "clock.h"
+#include "histogram.h"
+
+////////////////////////////////////////////////////////////////////////////
+// LatencyMonitor
+//
+// Where the time between an input event and the frame that shows it
+// goes. Each stage is stamped with the clock and the duration lands in
+// a Histogram, in microseconds, from whichever thread ran the stage:
+//
+//   input to present   from the newest input a frame shows to the end of
+//                      its EndDraw
+//   update             Engine::Tick() up to handing the frame over
+//   draw               BeginDraw() up to EndDraw()
+//   present            EndDraw() itself, usually the wait for the
+//                      vertical blank
+////////////////////////////////////////////////////////////////////////////
+
+typedef enum _LATENCYMETRIC {
+    LATENCY_INPUT_TO_PRESENT,
+    LATENCY_UPDATE,
+    LATENCY_DRAW,
+    LATENCY_PRESENT,
+    LATENCY_METRIC_COUNT
+} LATENCYMETRIC;
+
+class LatencyMonitor {
+public:
+    LatencyMonitor(Clock* pClock);
+
+    LONGLONG Stamp() CONST;
+
+    // Both stamps from Stamp(); lock free, any thread
+    VOID Record(LATENCYMETRIC metric, LONGLONG llStart, LONGLONG llEnd);
+
+    CONST Histogram* GetHistogram(LATENCYMETRIC metric) CONST;
+
+    static LPCSTR GetMetricName(LATENCYMETRIC metric);
+
+    // One line per metric with its sample count, p50, p95, p99 and max
+    // in microseconds; the characters written, without the terminating
+    // zero, or 0 when the buffer is too small
+    SIZE_T FormatReport(LPSTR pszBuffer, SIZE_T cchBuffer) CONST;
+
+    // Not while another thread records
+    VOID Reset();
+
+private:
+    Clock*      _pClock;
+    DOUBLE      _fMicrosecondsPerTick;
+    Histogram   _histograms[LATENCY_METRIC_COUNT];
+};
+
+#endif // __LATENCYMONITOR_H
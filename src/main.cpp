@@ -16,7 +16,6 @@
 
 #include <windows.h>
 #include <tchar.h>
-#include <mfapi.h>
 
 #include "application.h"
 
@@ -27,6 +26,7 @@ INT APIENTRY _tWinMain(
     INT         nCmdShow)
 {
     HANDLE      hMutex = NULL;
+    LPCTSTR     lpszTracePath = NULL;
     Application application;
 
     hMutex = CreateMutex(NULL, TRUE, TEXT("FingerPointer_Instance"));
@@ -40,14 +40,12 @@ INT APIENTRY _tWinMain(
         return -1;
     }
 
-    if (FAILED(MFStartup(MF_VERSION, MFSTARTUP_LITE))) {
-        CoUninitialize();
-        ReleaseMutex(hMutex);
-        return -1;
+    // FingerPointer.exe /record <file> writes an input trace for fp_replay
+    if (_tcsncmp(lpCmdLine, TEXT("/record "), 8) == 0) {
+        lpszTracePath = lpCmdLine + 8;
     }
 
-    if (FAILED(application.Initialize(hInstance))) {
-        MFShutdown();
+    if (FAILED(application.Initialize(hInstance, lpszTracePath))) {
         CoUninitialize();
         ReleaseMutex(hMutex);
         return -1;
@@ -55,7 +53,6 @@ INT APIENTRY _tWinMain(
 
     application.RunMessageLoop();
 
-    MFShutdown();
     CoUninitialize();
     ReleaseMutex(hMutex);
     return 0;
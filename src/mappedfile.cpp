@@ -0,0 +1,177 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mappedfile.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : _pbData(NULL),
+      _cbData(0)
+{
+#ifdef _WIN32
+    _hFile = INVALID_HANDLE_VALUE;
+    _hMapping = NULL;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (_pbData != NULL) {
+        UnmapViewOfFile(_pbData);
+    }
+
+    if (_hMapping != NULL) {
+        CloseHandle(_hMapping);
+    }
+
+    if (_hFile != INVALID_HANDLE_VALUE) {
+        CloseHandle(_hFile);
+    }
+#else
+    if (_pbData != NULL) {
+        munmap((VOID*) _pbData, _cbData);
+    }
+#endif
+}
+
+CONST BYTE* MappedFile::GetData() CONST
+{
+    return _pbData;
+}
+
+SIZE_T MappedFile::GetSize() CONST
+{
+    return _cbData;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+HRESULT MappedFile::CreateMappedFile(LPCTSTR lpszPath, MappedFile** ppFile)
+{
+    MappedFile*     pFile = NULL;
+    HRESULT         hResult = S_OK;
+#ifdef _WIN32
+    LARGE_INTEGER   size;
+#else
+    struct stat     st;
+    VOID*           pvData;
+    int             fd;
+#endif
+
+    if (lpszPath == NULL || ppFile == NULL) {
+        return E_INVALIDARG;
+    }
+
+    pFile = new MappedFile();
+
+    if (pFile == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+#ifdef _WIN32
+    pFile->_hFile = CreateFile(
+        lpszPath,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+
+    if (pFile->_hFile == INVALID_HANDLE_VALUE) {
+        hResult = HRESULT_FROM_WIN32(GetLastError());
+        goto failed;
+    }
+
+    if (GetFileSizeEx(pFile->_hFile, &size) == FALSE) {
+        hResult = HRESULT_FROM_WIN32(GetLastError());
+        goto failed;
+    }
+
+    // An empty file cannot be mapped, and nothing plays from it anyway
+    if (size.QuadPart == 0 || (ULONGLONG) size.QuadPart > (SIZE_T) -1) {
+        hResult = E_INVALIDARG;
+        goto failed;
+    }
+
+    pFile->_hMapping = CreateFileMapping(
+        pFile->_hFile,
+        NULL,
+        PAGE_READONLY,
+        0,
+        0,
+        NULL);
+
+    if (pFile->_hMapping == NULL) {
+        hResult = HRESULT_FROM_WIN32(GetLastError());
+        goto failed;
+    }
+
+    pFile->_pbData = (CONST BYTE*) MapViewOfFile(
+        pFile->_hMapping,
+        FILE_MAP_READ,
+        0,
+        0,
+        0);
+
+    if (pFile->_pbData == NULL) {
+        hResult = HRESULT_FROM_WIN32(GetLastError());
+        goto failed;
+    }
+
+    pFile->_cbData = (SIZE_T) size.QuadPart;
+#else // _WIN32
+    fd = open(lpszPath, O_RDONLY);
+
+    if (fd < 0) {
+        hResult = E_FAIL;
+        goto failed;
+    }
+
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        hResult = E_INVALIDARG;
+        goto failed;
+    }
+
+    pvData = mmap(NULL, (SIZE_T) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps its own reference to the file
+    close(fd);
+
+    if (pvData == MAP_FAILED) {
+        hResult = E_FAIL;
+        goto failed;
+    }
+
+    pFile->_pbData = (CONST BYTE*) pvData;
+    pFile->_cbData = (SIZE_T) st.st_size;
+#endif // _WIN32
+
+    *ppFile = pFile;
+    return S_OK;
+
+failed:
+    delete pFile;
+    return hResult;
+}
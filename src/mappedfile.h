@@ -0,0 +1,48 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __MAPPEDFILE_H
+#define __MAPPEDFILE_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// MappedFile - a whole file mapped read-only. Pages come in as they are
+// touched, so a long stream costs address space, not memory.
+////////////////////////////////////////////////////////////////////////////
+
+class MappedFile {
+public:
+    static HRESULT CreateMappedFile(LPCTSTR lpszPath, MappedFile** ppFile);
+
+    ~MappedFile();
+
+    CONST BYTE* GetData() CONST;
+    SIZE_T GetSize() CONST;
+
+private:
+    MappedFile();
+
+    CONST BYTE* _pbData;
+    SIZE_T      _cbData;
+
+#ifdef _WIN32
+    HANDLE      _hFile;
+    HANDLE      _hMapping;
+#endif
+};
+
+#endif // __MAPPEDFILE_H
@@ -0,0 +1,212 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mipchain.h"
+
+#include <stdlib.h>
+
+#include "safemem.h"
+
+// Halves a premultiplied BGRA image with a 2x2 box filter. An odd last
+// row or column is dropped, like the usual floor-halving mip chains.
+static VOID DownsampleBox(
+    CONST BYTE* pbSrc,
+    UINT        uSrcStride,
+    BYTE*       pbDst,
+    UINT        uWidth,
+    UINT        uHeight,
+    UINT        uSrcWidth,
+    UINT        uSrcHeight)
+{
+    CONST BYTE  *p0, *p1;
+    UINT        x, y, c, dx, dy;
+
+    // A 1 texel wide source gets averaged along one axis only
+    dx = (uSrcWidth  > 1) ? 4 : 0;
+    dy = (uSrcHeight > 1) ? uSrcStride : 0;
+
+    for (y = 0; y < uHeight; y++) {
+        p0 = pbSrc + (SIZE_T) y * 2 * uSrcStride;
+        p1 = p0 + dy;
+
+        for (x = 0; x < uWidth; x++, pbDst += 4, p0 += 8, p1 += 8) {
+            for (c = 0; c < 4; c++) {
+                pbDst[c] = (BYTE) ((p0[c] + p0[c + dx] +
+                                    p1[c] + p1[c + dx] + 2) >> 2);
+            }
+        }
+    }
+}
+
+MipChain::MipChain()
+    : _cLevels(0)
+{
+    UINT i;
+
+    for (i = 0; i < MIP_MAX_LEVELS; i++) {
+        _levels[i] = NULL;
+    }
+}
+
+MipChain::~MipChain()
+{
+    UINT i;
+
+    for (i = 0; i < _cLevels; i++) {
+        SafeDelete(&_levels[i]);
+    }
+}
+
+UINT MipChain::GetLevelCount() CONST
+{
+    return _cLevels;
+}
+
+SoftwareRenderBitmap* MipChain::GetLevel(UINT uLevel) CONST
+{
+    return (uLevel < _cLevels) ? _levels[uLevel] : NULL;
+}
+
+UINT MipChain::SelectLevel(FLOAT fScale) CONST
+{
+    FLOAT   fWidth  = _levels[0]->GetWidth()  * fScale;
+    FLOAT   fHeight = _levels[0]->GetHeight() * fScale;
+    UINT    uLevel  = 0;
+
+    while (uLevel + 1 < _cLevels &&
+           _levels[uLevel + 1]->GetWidth()  >= fWidth &&
+           _levels[uLevel + 1]->GetHeight() >= fHeight)
+    {
+        uLevel++;
+    }
+
+    return uLevel;
+}
+
+Geometry::Matrix MipChain::GetLevelTransform(UINT uLevel) CONST
+{
+    if (uLevel == 0 || uLevel >= _cLevels) {
+        return Geometry::Identity();
+    }
+
+    return Geometry::Scale(
+        Geometry::MakeSize(
+            (FLOAT) _levels[0]->GetWidth()  / _levels[uLevel]->GetWidth(),
+            (FLOAT) _levels[0]->GetHeight() / _levels[uLevel]->GetHeight()),
+        Geometry::MakePoint(0.0f, 0.0f));
+}
+
+SIZE_T MipChain::GetMemoryUsage() CONST
+{
+    SIZE_T  cbTotal = 0;
+    UINT    i;
+
+    for (i = 0; i < _cLevels; i++) {
+        cbTotal += (SIZE_T) _levels[i]->GetStride() * _levels[i]->GetHeight();
+    }
+
+    return cbTotal;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+HRESULT MipChain::CreateMipChain(
+    UINT            uWidth,
+    UINT            uHeight,
+    UINT            uStride,
+    CONST BYTE*     pbPixels,
+    MipChain**      ppChain)
+{
+    MipChain*               pChain = NULL;
+    SoftwareRenderBitmap*   pPrevious;
+    BYTE*                   pbLevel = NULL;
+    UINT                    uLevelWidth, uLevelHeight;
+    HRESULT                 hResult = S_OK;
+
+    if (ppChain == NULL) {
+        return E_INVALIDARG;
+    }
+
+    pChain = new MipChain();
+
+    if (pChain == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    hResult = SoftwareRenderBitmap::CreateSoftwareRenderBitmap(
+        uWidth,
+        uHeight,
+        uStride,
+        pbPixels,
+        &(pChain->_levels[0]));
+
+    if (FAILED(hResult)) {
+        goto cleanup;
+    }
+
+    pChain->_cLevels = 1;
+
+    while (pChain->_cLevels < MIP_MAX_LEVELS) {
+        pPrevious = pChain->_levels[pChain->_cLevels - 1];
+
+        if (pPrevious->GetWidth() == 1 && pPrevious->GetHeight() == 1) {
+            break;
+        }
+
+        uLevelWidth  = (pPrevious->GetWidth()  > 1) ? pPrevious->GetWidth()  / 2 : 1;
+        uLevelHeight = (pPrevious->GetHeight() > 1) ? pPrevious->GetHeight() / 2 : 1;
+
+        pbLevel = (BYTE*) malloc((SIZE_T) uLevelWidth * uLevelHeight * 4);
+
+        if (pbLevel == NULL) {
+            hResult = E_OUTOFMEMORY;
+            goto cleanup;
+        }
+
+        DownsampleBox(
+            pPrevious->GetPixels(),
+            pPrevious->GetStride(),
+            pbLevel,
+            uLevelWidth,
+            uLevelHeight,
+            pPrevious->GetWidth(),
+            pPrevious->GetHeight());
+
+        hResult = SoftwareRenderBitmap::CreateSoftwareRenderBitmap(
+            uLevelWidth,
+            uLevelHeight,
+            uLevelWidth * 4,
+            pbLevel,
+            &(pChain->_levels[pChain->_cLevels]));
+
+        free(pbLevel);
+
+        if (FAILED(hResult)) {
+            goto cleanup;
+        }
+
+        pChain->_cLevels++;
+    }
+
+cleanup:
+    if (SUCCEEDED(hResult)) {
+        *ppChain = pChain;
+    } else {
+        delete pChain;
+    }
+
+    return hResult;
+}
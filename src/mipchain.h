@@ -0,0 +1,67 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __MIPCHAIN_H
+#define __MIPCHAIN_H
+
+#include "wintypes.h"
+#include "geometry.h"
+#include "softwarerendersink.h"
+
+////////////////////////////////////////////////////////////////////////////
+// MipChain
+//
+// A bitmap and its successively halved, 2x2 box filtered copies, down to
+// 1x1. Drawing a downscaled bitmap from the smallest level that is still
+// at least as large as the result avoids the aliasing of sampling the
+// full resolution image with a 2x2 bilinear footprint.
+////////////////////////////////////////////////////////////////////////////
+
+#define MIP_MAX_LEVELS  16
+
+class MipChain {
+public:
+    // pbPixels is 32bpp premultiplied BGRA, level 0 is a copy of it
+    static HRESULT CreateMipChain(
+        UINT            uWidth,
+        UINT            uHeight,
+        UINT            uStride,
+        CONST BYTE*     pbPixels,
+        MipChain**      ppChain);
+
+    ~MipChain();
+
+    UINT GetLevelCount() CONST;
+    SoftwareRenderBitmap* GetLevel(UINT uLevel) CONST;
+
+    // Smallest level that is not smaller than the base bitmap scaled by
+    // fScale (device pixels per base texel)
+    UINT SelectLevel(FLOAT fScale) CONST;
+
+    // Maps level texels onto base texels; prepend to the base transform
+    Geometry::Matrix GetLevelTransform(UINT uLevel) CONST;
+
+    // Bytes of all levels, level 0 included
+    SIZE_T GetMemoryUsage() CONST;
+
+private:
+    MipChain();
+
+    SoftwareRenderBitmap*   _levels[MIP_MAX_LEVELS];
+    UINT                    _cLevels;
+};
+
+#endif // __MIPCHAIN_H
@@ -0,0 +1,1262 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mixer.h"
+
+#include <string.h>
+
+#include "safemem.h"
+#include "trace.h"
+#include "wavfile.h"
+
+#define MIXER_MAX_SAMPLE_RATE   384000
+
+////////////////////////////////////////////////////////////////////////////
+// Sample conversion
+////////////////////////////////////////////////////////////////////////////
+
+static BOOL IsSupportedFormat(CONST WAVINFO& info)
+{
+    if (info.cChannels < 1 || info.cChannels > MIXER_CHANNELS) {
+        return FALSE;
+    }
+
+    if (info.uSampleRate == 0 || info.uSampleRate > MIXER_MAX_SAMPLE_RATE) {
+        return FALSE;
+    }
+
+    if (info.cbBlockAlign != info.cChannels * info.cBitsPerSample / 8) {
+        return FALSE;
+    }
+
+    switch (info.uFormatTag) {
+        case WAV_FORMAT_PCM:
+            return info.cBitsPerSample == 8 ||
+                   info.cBitsPerSample == 16 ||
+                   info.cBitsPerSample == 24 ||
+                   info.cBitsPerSample == 32;
+
+        case WAV_FORMAT_FLOAT:
+            return info.cBitsPerSample == 32;
+    }
+
+    return FALSE;
+}
+
+// Samples are little endian like every target we build for, so 16-bit
+// PCM can be read in place as long as it is aligned
+static BOOL IsDirectlyPlayable(CONST WAVINFO& info, UINT uSampleRate)
+{
+    return info.uFormatTag == WAV_FORMAT_PCM &&
+           info.cBitsPerSample == 16 &&
+           info.uSampleRate == uSampleRate &&
+           ((SIZE_T) info.pbData & (sizeof(SHORT) - 1)) == 0;
+}
+
+static SHORT ReadSample(CONST WAVINFO& info, CONST BYTE* pb)
+{
+    FLOAT   fSample;
+    UINT    uBits;
+
+    if (info.uFormatTag == WAV_FORMAT_FLOAT) {
+        uBits = (UINT) pb[0] | ((UINT) pb[1] << 8) |
+                ((UINT) pb[2] << 16) | ((UINT) pb[3] << 24);
+        memcpy(&fSample, &uBits, sizeof(FLOAT));
+
+        // NaN fails both comparisons and ends up as silence
+        if (fSample >= 1.0f) {
+            return 32767;
+        } else if (fSample <= -1.0f) {
+            return -32768;
+        } else if (fSample == fSample) {
+            return (SHORT) (fSample * 32767.0f);
+        }
+
+        return 0;
+    }
+
+    // Integer PCM: keep the top 16 bits, 8-bit samples are unsigned
+    switch (info.cBitsPerSample) {
+        case 8:
+            return (SHORT) (((INT) pb[0] - 128) << 8);
+        case 16:
+            return (SHORT) (pb[0] | (pb[1] << 8));
+        case 24:
+            return (SHORT) (pb[1] | (pb[2] << 8));
+        default:
+            return (SHORT) (pb[2] | (pb[3] << 8));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+// SamplePool
+////////////////////////////////////////////////////////////////////////////
+
+SamplePool::SamplePool()
+    : _pBlocks(NULL),
+      _cbTotal(0)
+{
+}
+
+SamplePool::~SamplePool()
+{
+    SAMPLEBLOCK* pNext;
+
+    while (_pBlocks != NULL) {
+        pNext = _pBlocks->pNext;
+        delete[] (BYTE*) _pBlocks;
+        _pBlocks = pNext;
+    }
+}
+
+SHORT* SamplePool::Allocate(SIZE_T cSamples)
+{
+    SAMPLEBLOCK*    pBlock = _pBlocks;
+    SHORT*          psSamples;
+    SIZE_T          cBlockSamples;
+
+    if (cSamples == 0) {
+        return NULL;
+    }
+
+    if (pBlock == NULL || pBlock->cSamples - pBlock->cUsed < cSamples) {
+        cBlockSamples = (cSamples > SAMPLE_POOL_BLOCK_SIZE)
+            ? cSamples
+            : SAMPLE_POOL_BLOCK_SIZE;
+
+        pBlock = (SAMPLEBLOCK*) new BYTE[
+            sizeof(SAMPLEBLOCK) + cBlockSamples * sizeof(SHORT)];
+
+        if (pBlock == NULL) {
+            return NULL;
+        }
+
+        pBlock->pNext = _pBlocks;
+        pBlock->cSamples = cBlockSamples;
+        pBlock->cUsed = 0;
+
+        _pBlocks = pBlock;
+        _cbTotal += sizeof(SAMPLEBLOCK) + cBlockSamples * sizeof(SHORT);
+    }
+
+    psSamples = (SHORT*) (pBlock + 1) + pBlock->cUsed;
+    pBlock->cUsed += cSamples;
+
+    return psSamples;
+}
+
+SIZE_T SamplePool::GetMemoryUsage() CONST
+{
+    return _cbTotal;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// AudioClip
+////////////////////////////////////////////////////////////////////////////
+
+AudioClip::AudioClip()
+    : _uSampleRate(0),
+      _cChannels(0),
+      _cFrames(0),
+      _psSamples(NULL),
+      _psPeaks(NULL),
+      _bConverted(FALSE)
+{
+}
+
+AudioClip::~AudioClip()
+{
+    delete[] _psPeaks;
+}
+
+UINT AudioClip::GetSampleRate() CONST
+{
+    return _uSampleRate;
+}
+
+UINT AudioClip::GetChannels() CONST
+{
+    return _cChannels;
+}
+
+UINT AudioClip::GetFrameCount() CONST
+{
+    return _cFrames;
+}
+
+CONST SHORT* AudioClip::GetSamples() CONST
+{
+    return _psSamples;
+}
+
+BOOL AudioClip::IsConverted() CONST
+{
+    return _bConverted;
+}
+
+UINT AudioClip::GetPeak(UINT uFrame) CONST
+{
+    if (uFrame >= _cFrames) {
+        return 0;
+    }
+
+    return (UINT) _psPeaks[uFrame / CLIP_PEAK_FRAMES];
+}
+
+HRESULT AudioClip::ComputePeaks()
+{
+    UINT    cWindows = (_cFrames + CLIP_PEAK_FRAMES - 1) / CLIP_PEAK_FRAMES;
+    SIZE_T  i, cSamples = (SIZE_T) _cFrames * _cChannels;
+    INT     iSample;
+    SHORT*  psPeak;
+
+    if (cWindows == 0) {
+        return S_OK;
+    }
+
+    _psPeaks = new SHORT[cWindows];
+
+    if (_psPeaks == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    memset(_psPeaks, 0, cWindows * sizeof(SHORT));
+
+    for (i = 0; i < cSamples; i++) {
+        psPeak = &_psPeaks[i / _cChannels / CLIP_PEAK_FRAMES];
+        iSample = _psSamples[i];
+
+        if (iSample < 0) {
+            iSample = (iSample == -32768) ? 32767 : -iSample;
+        }
+
+        if (iSample > *psPeak) {
+            *psPeak = (SHORT) iSample;
+        }
+    }
+
+    return S_OK;
+}
+
+HRESULT AudioClip::CreateAudioClipFromWav(
+    CONST BYTE*     pbData,
+    SIZE_T          cbData,
+    UINT            uSampleRate,
+    SamplePool*     pPool,
+    AudioClip**     ppClip)
+{
+    AudioClip*      pClip = NULL;
+    WAVINFO         info;
+    SHORT*          psSamples = NULL;
+    CONST BYTE*     pbFrame;
+    UINT            cFrames, uFrame, uChannel, cbSample;
+    UINT            uIndex, uFraction;
+    ULONGLONG       ullPosition;
+    INT             iFirst, iSecond;
+    HRESULT         hResult;
+
+    FP_TRACE_SCOPE("AudioClip::CreateAudioClipFromWav");
+
+    if (pbData == NULL || pPool == NULL || ppClip == NULL ||
+        uSampleRate == 0 || uSampleRate > MIXER_MAX_SAMPLE_RATE)
+    {
+        return E_INVALIDARG;
+    }
+
+    hResult = ParseWav(pbData, cbData, &info);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    if (IsSupportedFormat(info) == FALSE) {
+        return E_NOTIMPL;
+    }
+
+    pClip = new AudioClip();
+
+    if (pClip == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    pClip->_uSampleRate = uSampleRate;
+    pClip->_cChannels = info.cChannels;
+
+    if (IsDirectlyPlayable(info, uSampleRate) == TRUE) {
+        pClip->_cFrames = info.cFrames;
+        pClip->_psSamples = (CONST SHORT*) info.pbData;
+
+        goto done;
+    }
+
+    cFrames = (UINT) (((ULONGLONG) info.cFrames * uSampleRate) /
+                      info.uSampleRate);
+
+    if (cFrames > 0) {
+        psSamples = pPool->Allocate((SIZE_T) cFrames * info.cChannels);
+
+        if (psSamples == NULL) {
+            delete pClip;
+            return E_OUTOFMEMORY;
+        }
+    }
+
+    cbSample = info.cBitsPerSample / 8;
+
+    // Linear interpolation in exact integer steps of
+    // source rate / target rate; a plain conversion when the rates match
+    for (uFrame = 0; uFrame < cFrames; uFrame++) {
+        ullPosition = (ULONGLONG) uFrame * info.uSampleRate;
+        uIndex = (UINT) (ullPosition / uSampleRate);
+        uFraction = (UINT) (ullPosition % uSampleRate);
+
+        pbFrame = info.pbData + (SIZE_T) uIndex * info.cbBlockAlign;
+
+        for (uChannel = 0; uChannel < info.cChannels; uChannel++) {
+            iFirst = ReadSample(info, pbFrame + uChannel * cbSample);
+
+            if (uFraction != 0 && uIndex + 1 < info.cFrames) {
+                iSecond = ReadSample(
+                    info,
+                    pbFrame + info.cbBlockAlign + uChannel * cbSample);
+
+                iFirst += (INT) (((LONGLONG) (iSecond - iFirst) * uFraction) /
+                                 (LONGLONG) uSampleRate);
+            }
+
+            psSamples[(SIZE_T) uFrame * info.cChannels + uChannel] =
+                (SHORT) iFirst;
+        }
+    }
+
+    pClip->_cFrames = cFrames;
+    pClip->_psSamples = psSamples;
+    pClip->_bConverted = TRUE;
+
+done:
+    if (FAILED(pClip->ComputePeaks())) {
+        delete pClip;
+        return E_OUTOFMEMORY;
+    }
+
+    *ppClip = pClip;
+    return S_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Mixer
+////////////////////////////////////////////////////////////////////////////
+
+#define MIXER_SERIAL_MASK   0x7FFFFFFF
+
+Mixer::Mixer()
+    : _cVoicesReserved(0),
+      _fRequestedMasterGain(1.0f),
+      _bMasterGainDirty(FALSE),
+      _ullStarts(0),
+      _cVoicesStolen(0),
+      _fMasterGain(1.0f),
+      _pResampleKernels(GetResampleKernels()),
+      _lVoicesInUse(0),
+      _lVoicesStolen(0),
+      _uSampleRate(0),
+      _cFadeFrames(0)
+{
+    memset(_sounds, 0, sizeof(_sounds));
+    memset(_bSlotBusy, 0, sizeof(_bSlotBusy));
+    memset(_bVoiceBusy, 0, sizeof(_bVoiceBusy));
+    memset(_slots, 0, sizeof(_slots));
+    memset(_voices, 0, sizeof(_voices));
+}
+
+Mixer::~Mixer()
+{
+    UINT uSound;
+
+    // Nobody renders any more, so this thread may play both sides
+    ProcessCommands();
+    CollectReleased();
+
+    for (uSound = 0; uSound < MIXER_MAX_SOUNDS; uSound++) {
+        if (_sounds[uSound] != NULL) {
+            _sounds[uSound]->_pMixer = NULL;
+        }
+
+        SafeDelete(&_slots[uSound].pClip);
+        SafeDelete(&_slots[uSound].pStream);
+    }
+}
+
+BOOL Mixer::PostCommand(CONST MIXERCOMMAND& command)
+{
+    return _commands.Push(command);
+}
+
+VOID Mixer::ProcessCommands()
+{
+    MIXERCOMMAND    command;
+    MIXERRELEASE    release;
+    MIXERSLOT*      pSlot;
+    UINT            i;
+
+    while (_commands.Pop(&command) == TRUE) {
+        if (command.type == MC_SET_MASTER_GAIN) {
+            _fMasterGain = command.fValue;
+            continue;
+        }
+
+        pSlot = &_slots[command.uSound];
+
+        switch (command.type) {
+            case MC_ATTACH:
+                pSlot->pClip = command.pClip;
+                pSlot->pStream = command.pStream;
+                pSlot->uFirstVoice = command.uFirstVoice;
+                pSlot->cVoices = command.cVoices;
+                pSlot->steal = command.steal;
+                pSlot->fStepScale = command.fValue;
+                pSlot->ullStep = (ULONGLONG) (
+                    pSlot->fStepScale * (DOUBLE) RESAMPLE_ONE);
+                pSlot->fGain = 1.0f;
+                pSlot->fRampGain = 1.0f;
+                pSlot->bLoop = FALSE;
+                pSlot->uSerial = 0;
+
+                memset(&_voices[pSlot->uFirstVoice], 0,
+                       pSlot->cVoices * sizeof(MIXERVOICE));
+                break;
+
+            case MC_RELEASE:
+                release.uSound = command.uSound;
+                release.uFirstVoice = pSlot->uFirstVoice;
+                release.cVoices = pSlot->cVoices;
+                release.pClip = pSlot->pClip;
+                release.pStream = pSlot->pStream;
+
+                // Never full, it has room for every sound
+                _released.Push(release);
+
+                memset(&_voices[pSlot->uFirstVoice], 0,
+                       pSlot->cVoices * sizeof(MIXERVOICE));
+
+                pSlot->pClip = NULL;
+                pSlot->pStream = NULL;
+                pSlot->cVoices = 0;
+                break;
+
+            case MC_PLAY:
+                StartVoice(pSlot);
+                pSlot->uSerial = command.uSerial;
+                break;
+
+            case MC_STOP:
+                for (i = 0; i < pSlot->cVoices; i++) {
+                    FadeVoice(pSlot, i);
+                }
+
+                pSlot->uSerial = command.uSerial;
+                break;
+
+            case MC_SET_LOOP:
+                pSlot->bLoop = command.bValue;
+
+                if (pSlot->pStream != NULL) {
+                    pSlot->pStream->SetLoop(command.bValue);
+                }
+                break;
+
+            case MC_SET_GAIN:
+                pSlot->fGain = command.fValue;
+                break;
+
+            case MC_SET_RATE:
+                pSlot->ullStep = (ULONGLONG) (
+                    (DOUBLE) command.fValue * pSlot->fStepScale *
+                    (DOUBLE) RESAMPLE_ONE);
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+VOID Mixer::CollectReleased()
+{
+    MIXERRELEASE    release;
+    UINT            i;
+
+    while (_released.Pop(&release) == TRUE) {
+        delete release.pClip;
+        delete release.pStream;
+
+        for (i = 0; i < release.cVoices; i++) {
+            _bVoiceBusy[release.uFirstVoice + i] = FALSE;
+        }
+
+        _cVoicesReserved -= release.cVoices;
+        _bSlotBusy[release.uSound] = FALSE;
+    }
+}
+
+// Prefers a voice that is not playing, and of those one with nothing
+// left to fade. With all playing, one voice keeps going (a sound with
+// one voice just plays on) and more give one up to the steal policy.
+VOID Mixer::StartVoice(MIXERSLOT* pSlot)
+{
+    MIXERVOICE* pFree = NULL;
+    MIXERVOICE* pVictim = NULL;
+    MIXERVOICE* pVoice;
+    BOOL        bAnyPlaying = FALSE;
+    UINT        uPeak, uVictimPeak = 0;
+    UINT        uFree = 0, uVictim = 0;
+    UINT        i;
+
+    for (i = 0; i < pSlot->cVoices; i++) {
+        pVoice = &_voices[pSlot->uFirstVoice + i];
+
+        if (pVoice->bPlaying == FALSE) {
+            if (pFree == NULL ||
+                (pFree->cFadeFrames != 0 && pVoice->cFadeFrames == 0))
+            {
+                pFree = pVoice;
+                uFree = i;
+            }
+
+            continue;
+        }
+
+        bAnyPlaying = TRUE;
+
+        // Streams have no peaks to go by, they steal the oldest
+        if (pSlot->steal == VOICE_STEAL_QUIETEST && pSlot->pClip != NULL) {
+            uPeak = pSlot->pClip->GetPeak((UINT) (pVoice->ullPosition >> 32));
+
+            // Ties go to the oldest
+            if (pVictim == NULL || uPeak < uVictimPeak ||
+                (uPeak == uVictimPeak &&
+                 pVoice->ullStarted < pVictim->ullStarted))
+            {
+                pVictim = pVoice;
+                uVictim = i;
+                uVictimPeak = uPeak;
+            }
+        } else if (pVictim == NULL ||
+                   pVoice->ullStarted < pVictim->ullStarted)
+        {
+            pVictim = pVoice;
+            uVictim = i;
+        }
+    }
+
+    if (pFree == NULL) {
+        if (pSlot->cVoices < 2) {
+            return;
+        }
+
+        FadeVoice(pSlot, uVictim);
+        _cVoicesStolen++;
+
+        pFree = pVictim;
+        uFree = uVictim;
+    }
+
+    // A sound starting from silence takes its gain as it is, without
+    // ramping from wherever the last one left off
+    if (bAnyPlaying == FALSE) {
+        pSlot->fRampGain = pSlot->fGain;
+    }
+
+    pFree->ullPosition = 0;
+    pFree->ullStarted = ++_ullStarts;
+    pFree->bPlaying = TRUE;
+
+    if (pSlot->pStream != NULL) {
+        pSlot->pStream->StartVoice(uFree);
+    }
+}
+
+// Whatever fades already is cut; only happens when a voice is cut off
+// twice within MIXER_FADE_TIME
+VOID Mixer::FadeVoice(MIXERSLOT* pSlot, UINT uVoice)
+{
+    MIXERVOICE* pVoice = &_voices[pSlot->uFirstVoice + uVoice];
+
+    if (pVoice->bPlaying == FALSE) {
+        return;
+    }
+
+    if (pSlot->pStream != NULL) {
+        pSlot->pStream->FadeVoice(uVoice);
+    }
+
+    pVoice->ullFadePosition = pVoice->ullPosition;
+    pVoice->cFadeFrames = _cFadeFrames;
+    pVoice->ullPosition = 0;
+    pVoice->bPlaying = FALSE;
+}
+
+HRESULT Mixer::CreateSound(
+    AudioClip*      pClip,
+    UINT            cVoices,
+    VOICESTEAL      steal,
+    MixerSound**    ppSound)
+{
+    MIXERCOMMAND command;
+
+    if (pClip == NULL || ppSound == NULL) {
+        return E_INVALIDARG;
+    }
+
+    if (cVoices == 0 || cVoices > MIXER_MAX_VOICES) {
+        return E_INVALIDARG;
+    }
+
+    if (steal != VOICE_STEAL_OLDEST && steal != VOICE_STEAL_QUIETEST) {
+        return E_INVALIDARG;
+    }
+
+    if (pClip->GetSampleRate() != _uSampleRate) {
+        return E_INVALIDARG;
+    }
+
+    memset(&command, 0, sizeof(command));
+    command.type = MC_ATTACH;
+    command.pClip = pClip;
+    command.cVoices = cVoices;
+    command.steal = steal;
+    command.fValue = 1.0f;
+
+    return AttachSound(&command, ppSound);
+}
+
+HRESULT Mixer::CreateStreamSound(
+    AudioStream*    pStream,
+    VOICESTEAL      steal,
+    MixerSound**    ppSound)
+{
+    MIXERCOMMAND    command;
+    FLOAT           fStepScale;
+
+    if (pStream == NULL || ppSound == NULL) {
+        return E_INVALIDARG;
+    }
+
+    if (steal != VOICE_STEAL_OLDEST && steal != VOICE_STEAL_QUIETEST) {
+        return E_INVALIDARG;
+    }
+
+    fStepScale = (FLOAT) pStream->GetSampleRate() / (FLOAT) _uSampleRate;
+
+    if (fStepScale < 0.25f || fStepScale > 4.0f) {
+        return E_INVALIDARG;
+    }
+
+    memset(&command, 0, sizeof(command));
+    command.type = MC_ATTACH;
+    command.pStream = pStream;
+    command.cVoices = pStream->GetVoiceCount();
+    command.steal = steal;
+    command.fValue = fStepScale;
+
+    return AttachSound(&command, ppSound);
+}
+
+HRESULT Mixer::AttachSound(MIXERCOMMAND* pCommand, MixerSound** ppSound)
+{
+    MixerSound* pSound = NULL;
+    UINT        cVoices = pCommand->cVoices;
+    UINT        uSound, uFirstVoice, cFree, i;
+
+    CollectReleased();
+
+    for (uSound = 0; uSound < MIXER_MAX_SOUNDS; uSound++) {
+        if (_bSlotBusy[uSound] == FALSE) {
+            break;
+        }
+    }
+
+    if (uSound == MIXER_MAX_SOUNDS) {
+        return E_OUTOFMEMORY;
+    }
+
+    // First run of cVoices free voices
+    uFirstVoice = 0;
+    cFree = 0;
+
+    for (i = 0; i < MIXER_MAX_VOICES && cFree < cVoices; i++) {
+        if (_bVoiceBusy[i] == TRUE) {
+            uFirstVoice = i + 1;
+            cFree = 0;
+        } else {
+            cFree++;
+        }
+    }
+
+    if (cFree < cVoices) {
+        return E_OUTOFMEMORY;
+    }
+
+    pSound = new MixerSound(this, uSound, cVoices);
+
+    if (pSound == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    pCommand->uSound = uSound;
+    pCommand->uFirstVoice = uFirstVoice;
+
+    if (PostCommand(*pCommand) == FALSE) {
+        pSound->_pMixer = NULL;
+        delete pSound;
+        return E_FAIL;
+    }
+
+    for (i = 0; i < cVoices; i++) {
+        _bVoiceBusy[uFirstVoice + i] = TRUE;
+    }
+
+    _cVoicesReserved += cVoices;
+    _sounds[uSound] = pSound;
+    _bSlotBusy[uSound] = TRUE;
+
+    *ppSound = pSound;
+    return S_OK;
+}
+
+UINT Mixer::GetSampleRate() CONST
+{
+    return _uSampleRate;
+}
+
+SamplePool* Mixer::GetSamplePool()
+{
+    return &_pool;
+}
+
+UINT Mixer::GetPlayingCount() CONST
+{
+    UINT uSound, cPlaying = 0;
+
+    for (uSound = 0; uSound < MIXER_MAX_SOUNDS; uSound++) {
+        if (_sounds[uSound] != NULL &&
+            (AtomicLoadAcquire(&_slots[uSound].lState) & 1) != 0)
+        {
+            cPlaying++;
+        }
+    }
+
+    return cPlaying;
+}
+
+VOID Mixer::GetStats(MIXERSTATS* pStats) CONST
+{
+    if (pStats == NULL) {
+        return;
+    }
+
+    pStats->cVoices         = MIXER_MAX_VOICES;
+    pStats->cVoicesReserved = _cVoicesReserved;
+    pStats->cVoicesInUse    = (UINT) AtomicLoadAcquire(&_lVoicesInUse);
+    pStats->cVoicesStolen   = (ULONG) AtomicLoadAcquire(&_lVoicesStolen);
+}
+
+VOID Mixer::SetMasterGain(FLOAT fGain)
+{
+    _fRequestedMasterGain = (fGain > 0.0f) ? fGain : 0.0f;
+    _bMasterGainDirty = TRUE;
+
+    Flush();
+}
+
+VOID Mixer::Flush()
+{
+    MIXERCOMMAND    command;
+    UINT            uSound;
+
+    if (_bMasterGainDirty == TRUE) {
+        memset(&command, 0, sizeof(command));
+        command.type = MC_SET_MASTER_GAIN;
+        command.fValue = _fRequestedMasterGain;
+
+        if (PostCommand(command) == TRUE) {
+            _bMasterGainDirty = FALSE;
+        }
+    }
+
+    for (uSound = 0; uSound < MIXER_MAX_SOUNDS; uSound++) {
+        if (_sounds[uSound] != NULL) {
+            _sounds[uSound]->Flush();
+        }
+    }
+}
+
+// Renders up to cFrames of one playhead and returns how many it got;
+// fewer means the clip ended
+UINT Mixer::MixPlayhead(
+    MIXERSLOT*  pSlot,
+    UINT        uVoice,
+    BOOL        bFade,
+    FLOAT*      pfOutput,
+    UINT        cFrames,
+    FLOAT       fGain,
+    FLOAT       fGainStep)
+{
+    MIXERVOICE*     pVoice = &_voices[pSlot->uFirstVoice + uVoice];
+    ULONGLONG*      pullPosition;
+    CONST SHORT*    psSamples;
+    UINT            cChannels, cClipFrames;
+    UINT            uFrame = 0, uEnd, cRun, uPosition;
+    FLOAT           fLeft, fRight;
+    CONST SHORT*    psFrame;
+
+    if (pSlot->pStream != NULL) {
+        return pSlot->pStream->MixVoice(
+            uVoice,
+            bFade,
+            _pResampleKernels,
+            pfOutput,
+            cFrames,
+            pSlot->ullStep,
+            fGain,
+            fGainStep);
+    }
+
+    pullPosition = bFade ? &pVoice->ullFadePosition : &pVoice->ullPosition;
+    psSamples = pSlot->pClip->GetSamples();
+    cChannels = pSlot->pClip->GetChannels();
+    cClipFrames = pSlot->pClip->GetFrameCount();
+
+    if (pSlot->ullStep != RESAMPLE_ONE ||
+        (*pullPosition & (RESAMPLE_ONE - 1)) != 0)
+    {
+        return ResampleClip(
+            _pResampleKernels,
+            pfOutput,
+            psSamples,
+            cChannels,
+            cClipFrames,
+            pSlot->bLoop,
+            pullPosition,
+            pSlot->ullStep,
+            cFrames,
+            fGain,
+            fGainStep);
+    }
+
+    // Natural rate on a whole frame: straight copy, no interpolation
+    uPosition = (UINT) (*pullPosition >> 32);
+
+    while (uFrame < cFrames) {
+        if (uPosition >= cClipFrames) {
+            if (pSlot->bLoop == FALSE || cClipFrames == 0) {
+                break;
+            }
+
+            uPosition = 0;
+        }
+
+        cRun = cClipFrames - uPosition;
+
+        if (cRun > cFrames - uFrame) {
+            cRun = cFrames - uFrame;
+        }
+
+        psFrame = psSamples + (SIZE_T) uPosition * cChannels;
+        uEnd = uFrame + cRun;
+
+        for (; uFrame < uEnd; uFrame++) {
+            fLeft = (FLOAT) psFrame[0];
+            fRight = (cChannels == 2) ? (FLOAT) psFrame[1] : fLeft;
+
+            pfOutput[uFrame * 2 + 0] += fLeft * fGain;
+            pfOutput[uFrame * 2 + 1] += fRight * fGain;
+
+            fGain += fGainStep;
+            psFrame += cChannels;
+        }
+
+        uPosition += cRun;
+    }
+
+    *pullPosition = (ULONGLONG) uPosition << 32;
+    return uFrame;
+}
+
+// Mixes every voice of a sound and returns how many still play
+UINT Mixer::MixSlot(MIXERSLOT* pSlot, FLOAT* pfOutput, UINT cFrames)
+{
+    MIXERVOICE* pVoice;
+    FLOAT       fGain, fStep, fFade, fFadeEnd;
+    UINT        cRun, cPlaying = 0;
+    UINT        i;
+
+    // Gain changes are spread over the block so they do not click
+    fGain = pSlot->fRampGain * _fMasterGain * (1.0f / 32768.0f);
+    fStep = (pSlot->fGain - pSlot->fRampGain) * _fMasterGain *
+            (1.0f / 32768.0f) / (FLOAT) cFrames;
+
+    pSlot->fRampGain = pSlot->fGain;
+
+    for (i = 0; i < pSlot->cVoices; i++) {
+        pVoice = &_voices[pSlot->uFirstVoice + i];
+
+        // The fade is a straight line from the gain it has left to
+        // the one it ends the run with, near enough to the product
+        // of the two ramps over a few milliseconds
+        if (pVoice->cFadeFrames != 0) {
+            cRun = (pVoice->cFadeFrames < cFrames)
+                ? pVoice->cFadeFrames
+                : cFrames;
+
+            fFade = fGain * (FLOAT) pVoice->cFadeFrames /
+                    (FLOAT) _cFadeFrames;
+            fFadeEnd = (fGain + fStep * (FLOAT) cRun) *
+                       (FLOAT) (pVoice->cFadeFrames - cRun) /
+                       (FLOAT) _cFadeFrames;
+
+            if (MixPlayhead(
+                    pSlot,
+                    i,
+                    TRUE,
+                    pfOutput,
+                    cRun,
+                    fFade,
+                    (fFadeEnd - fFade) / (FLOAT) cRun) < cRun)
+            {
+                pVoice->cFadeFrames = 0;
+            } else {
+                pVoice->cFadeFrames -= cRun;
+            }
+
+            if (pVoice->cFadeFrames == 0 && pSlot->pStream != NULL) {
+                pSlot->pStream->EndFade(i);
+            }
+        }
+
+        if (pVoice->bPlaying == TRUE) {
+            if (MixPlayhead(
+                    pSlot,
+                    i,
+                    FALSE,
+                    pfOutput,
+                    cFrames,
+                    fGain,
+                    fStep) < cFrames)
+            {
+                pVoice->bPlaying = FALSE;
+                pVoice->ullPosition = 0;
+            } else {
+                cPlaying++;
+            }
+        }
+    }
+
+    return cPlaying;
+}
+
+VOID Mixer::Render(FLOAT* pfOutput, UINT cFrames)
+{
+    MIXERSLOT*  pSlot;
+    UINT        uSound, cPlaying, cVoicesInUse = 0;
+
+    FP_TRACE_SCOPE("Mixer::Render");
+
+    if (pfOutput == NULL || cFrames == 0) {
+        return;
+    }
+
+    ProcessCommands();
+
+    memset(pfOutput, 0, (SIZE_T) cFrames * MIXER_CHANNELS * sizeof(FLOAT));
+
+    for (uSound = 0; uSound < MIXER_MAX_SOUNDS; uSound++) {
+        pSlot = &_slots[uSound];
+        cPlaying = 0;
+
+        if (pSlot->pClip != NULL || pSlot->pStream != NULL) {
+            cPlaying = MixSlot(pSlot, pfOutput, cFrames);
+            cVoicesInUse += cPlaying;
+        }
+
+        AtomicStoreRelease(
+            &pSlot->lState,
+            (LONG) ((pSlot->uSerial << 1) | (cPlaying != 0 ? 1 : 0)));
+    }
+
+    AtomicStoreRelease(&_lVoicesInUse, (LONG) cVoicesInUse);
+    AtomicStoreRelease(&_lVoicesStolen, (LONG) _cVoicesStolen);
+}
+
+VOID Mixer::SetResampleKernels(CONST RESAMPLEKERNELS* pKernels)
+{
+    _pResampleKernels = (pKernels != NULL) ? pKernels : GetResampleKernels();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+HRESULT Mixer::CreateMixer(UINT uSampleRate, Mixer** ppMixer)
+{
+    Mixer* pMixer = NULL;
+
+    if (ppMixer == NULL ||
+        uSampleRate == 0 || uSampleRate > MIXER_MAX_SAMPLE_RATE)
+    {
+        return E_INVALIDARG;
+    }
+
+    pMixer = new Mixer();
+
+    if (pMixer == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    pMixer->_uSampleRate = uSampleRate;
+    pMixer->_cFadeFrames = (UINT) (uSampleRate * MIXER_FADE_TIME);
+
+    *ppMixer = pMixer;
+    return S_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// MixerSound
+////////////////////////////////////////////////////////////////////////////
+
+MixerSound::MixerSound(Mixer* pMixer, UINT uSound, UINT cVoices)
+    : _pMixer(pMixer),
+      _uSound(uSound),
+      _cVoices(cVoices),
+      _uSerial(0),
+      _fDirty(0),
+      _cPendingPlays(0),
+      _bPlayRequested(FALSE),
+      _bLoop(FALSE),
+      _fGain(1.0f),
+      _fRate(1.0f)
+{
+}
+
+MixerSound::~MixerSound()
+{
+    Mixer::MIXERCOMMAND command;
+
+    if (_pMixer == NULL) {
+        return;
+    }
+
+    _pMixer->_sounds[_uSound] = NULL;
+
+    // The clip comes back through CollectReleased(); if the queue is
+    // full the slot stays taken until the mixer goes
+    memset(&command, 0, sizeof(command));
+    command.type = Mixer::MC_RELEASE;
+    command.uSound = _uSound;
+
+    _pMixer->PostCommand(command);
+}
+
+VOID MixerSound::Flush()
+{
+    Mixer::MIXERCOMMAND command;
+
+    if (_fDirty == 0 && _cPendingPlays == 0) {
+        return;
+    }
+
+    memset(&command, 0, sizeof(command));
+    command.uSound = _uSound;
+
+    // The stop goes first, plays asked for after it must not be cut
+    if (_fDirty & DIRTY_STOP) {
+        command.type = Mixer::MC_STOP;
+        command.uSerial = (_uSerial + 1) & MIXER_SERIAL_MASK;
+
+        if (_pMixer->PostCommand(command) == FALSE) {
+            return;
+        }
+
+        _uSerial = command.uSerial;
+        _fDirty &= ~DIRTY_STOP;
+    }
+
+    while (_cPendingPlays > 0) {
+        command.type = Mixer::MC_PLAY;
+        command.uSerial = (_uSerial + 1) & MIXER_SERIAL_MASK;
+
+        if (_pMixer->PostCommand(command) == FALSE) {
+            return;
+        }
+
+        _uSerial = command.uSerial;
+        _cPendingPlays--;
+    }
+
+    if (_fDirty & DIRTY_LOOP) {
+        command.type = Mixer::MC_SET_LOOP;
+        command.bValue = _bLoop;
+
+        if (_pMixer->PostCommand(command) == FALSE) {
+            return;
+        }
+
+        _fDirty &= ~DIRTY_LOOP;
+    }
+
+    if (_fDirty & DIRTY_GAIN) {
+        command.type = Mixer::MC_SET_GAIN;
+        command.fValue = _fGain;
+
+        if (_pMixer->PostCommand(command) == FALSE) {
+            return;
+        }
+
+        _fDirty &= ~DIRTY_GAIN;
+    }
+
+    if (_fDirty & DIRTY_RATE) {
+        command.type = Mixer::MC_SET_RATE;
+        command.fValue = _fRate;
+
+        if (_pMixer->PostCommand(command) == FALSE) {
+            return;
+        }
+
+        _fDirty &= ~DIRTY_RATE;
+    }
+}
+
+VOID MixerSound::Play()
+{
+    FP_TRACE_SCOPE("MixerSound::Play");
+
+    if (_pMixer == NULL) {
+        return;
+    }
+
+    // Cheap to call every frame on a sound with one voice, only the
+    // first call reaches the queue
+    if (_cVoices == 1 && IsPlaying() == TRUE) {
+        return;
+    }
+
+    // More plays than voices would only steal from each other
+    if (_cPendingPlays < _cVoices) {
+        _cPendingPlays++;
+    }
+
+    _bPlayRequested = TRUE;
+
+    Flush();
+}
+
+VOID MixerSound::Stop()
+{
+    if (_pMixer == NULL || IsPlaying() == FALSE) {
+        return;
+    }
+
+    // Plays that are still waiting to be posted are simply dropped
+    _cPendingPlays = 0;
+    _bPlayRequested = FALSE;
+    _fDirty |= DIRTY_STOP;
+
+    Flush();
+}
+
+VOID MixerSound::SetLoop(BOOL bLoop)
+{
+    if (_pMixer == NULL || bLoop == _bLoop) {
+        return;
+    }
+
+    _bLoop = bLoop;
+    _fDirty |= DIRTY_LOOP;
+
+    Flush();
+}
+
+BOOL MixerSound::GetLoop() CONST
+{
+    return _bLoop;
+}
+
+BOOL MixerSound::IsPlaying() CONST
+{
+    UINT uState;
+
+    if (_pMixer == NULL) {
+        return FALSE;
+    }
+
+    if (_cPendingPlays > 0) {
+        return TRUE;
+    }
+
+    if (_fDirty & DIRTY_STOP) {
+        return FALSE;
+    }
+
+    uState = (UINT) AtomicLoadAcquire(&_pMixer->_slots[_uSound].lState);
+
+    if ((uState >> 1) != _uSerial) {
+        return _bPlayRequested;
+    }
+
+    return (uState & 1) != 0;
+}
+
+VOID MixerSound::SetGain(FLOAT fGain)
+{
+    fGain = (fGain > 0.0f) ? fGain : 0.0f;
+
+    if (_pMixer == NULL || fGain == _fGain) {
+        return;
+    }
+
+    _fGain = fGain;
+    _fDirty |= DIRTY_GAIN;
+
+    Flush();
+}
+
+FLOAT MixerSound::GetGain() CONST
+{
+    return _fGain;
+}
+
+VOID MixerSound::SetRate(FLOAT fRate)
+{
+    // Written so that NaN ends up at the minimum
+    if (!(fRate >= RESAMPLE_MIN_RATE)) {
+        fRate = RESAMPLE_MIN_RATE;
+    } else if (fRate > RESAMPLE_MAX_RATE) {
+        fRate = RESAMPLE_MAX_RATE;
+    }
+
+    if (_pMixer == NULL || fRate == _fRate) {
+        return;
+    }
+
+    _fRate = fRate;
+    _fDirty |= DIRTY_RATE;
+
+    Flush();
+}
+
+FLOAT MixerSound::GetRate() CONST
+{
+    return _fRate;
+}
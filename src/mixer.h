@@ -0,0 +1,371 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __MIXER_H
+#define __MIXER_H
+
+#include "wintypes.h"
+#include "platform.h"
+#include "audiostream.h"
+#include "resample.h"
+#include "spscqueue.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Mixer
+//
+// Sums every playing sound into one interleaved stereo float stream.
+// Clips hold 16-bit PCM at the mixer rate, so a voice at its natural
+// rate is a multiply-add per sample and a loop wraps on the exact sample
+// it ends on. Voices playing faster or slower go through the resampler
+// (resample.h). The host pulls frames with Render(), either from an
+// audio device callback or into a plain buffer. Compressed files play
+// through an AudioStream (audiostream.h) instead of a clip.
+//
+// Voices come from one fixed pool; every sound reserves its own run of
+// them when it is created, so playing never allocates. A voice that is
+// cut off, by Stop() or by being stolen, fades out over MIXER_FADE_TIME
+// alongside whatever starts in its place instead of stopping mid-wave.
+////////////////////////////////////////////////////////////////////////////
+
+#define MIXER_CHANNELS          2
+#define MIXER_MAX_SOUNDS        32
+#define MIXER_MAX_VOICES        32
+#define MIXER_FADE_TIME         0.005f  // Seconds
+
+#define CLIP_PEAK_FRAMES        1024
+
+#define SAMPLE_POOL_BLOCK_SIZE  (64 * 1024)     // Samples
+
+////////////////////////////////////////////////////////////////////////////
+// SamplePool - bump allocator for converted clips. Memory is only given
+// back when the pool is deleted, which is when the clips go too.
+////////////////////////////////////////////////////////////////////////////
+
+class SamplePool {
+public:
+    SamplePool();
+    ~SamplePool();
+
+    SHORT* Allocate(SIZE_T cSamples);
+
+    // Bytes of all blocks, free space included
+    SIZE_T GetMemoryUsage() CONST;
+
+private:
+    typedef struct _SAMPLEBLOCK {
+        struct _SAMPLEBLOCK*    pNext;
+        SIZE_T                  cSamples;
+        SIZE_T                  cUsed;
+    } SAMPLEBLOCK;
+
+    SamplePool(CONST SamplePool&);
+    SamplePool& operator=(CONST SamplePool&);
+
+    SAMPLEBLOCK*    _pBlocks;
+    SIZE_T          _cbTotal;
+};
+
+class AudioClip {
+public:
+    // RIFF/WAVE with 8, 16, 24 or 32-bit integer or 32-bit float PCM,
+    // mono or stereo. 16-bit PCM at uSampleRate is played straight from
+    // pbData, which then has to outlive the clip (resource memory does).
+    // Anything else is converted, and resampled if the rate differs,
+    // into pPool.
+    static HRESULT CreateAudioClipFromWav(
+        CONST BYTE*     pbData,
+        SIZE_T          cbData,
+        UINT            uSampleRate,
+        SamplePool*     pPool,
+        AudioClip**     ppClip);
+
+    ~AudioClip();
+
+    UINT GetSampleRate() CONST;
+    UINT GetChannels() CONST;
+    UINT GetFrameCount() CONST;
+
+    // Interleaved, GetChannels() samples per frame
+    CONST SHORT* GetSamples() CONST;
+
+    // FALSE when the samples live in the caller's buffer
+    BOOL IsConverted() CONST;
+
+    // Largest magnitude in the CLIP_PEAK_FRAMES window holding uFrame,
+    // 0 past the end
+    UINT GetPeak(UINT uFrame) CONST;
+
+private:
+    AudioClip();
+
+    HRESULT ComputePeaks();
+
+    UINT            _uSampleRate;
+    UINT            _cChannels;
+    UINT            _cFrames;
+    CONST SHORT*    _psSamples;
+    SHORT*          _psPeaks;
+    BOOL            _bConverted;
+};
+
+// Which voice a sound gives up when all of its voices play
+typedef enum _VOICESTEAL {
+    VOICE_STEAL_OLDEST,
+    VOICE_STEAL_QUIETEST    // By the clip's peak level where it plays now
+} VOICESTEAL;
+
+typedef struct _MIXERSTATS {
+    UINT    cVoices;            // In the pool
+    UINT    cVoicesReserved;    // By sounds
+    UINT    cVoicesInUse;       // As of the last rendered block
+    ULONG   cVoicesStolen;      // Since the mixer was created
+} MIXERSTATS;
+
+class MixerSound;
+
+////////////////////////////////////////////////////////////////////////////
+// Mixer threading
+//
+// CreateSound() and everything on MixerSound belong to one thread (the
+// UI), Render() to another (the audio device). The first only posts
+// commands into a wait-free queue, the second applies them at the start
+// of the next block and publishes back whether each voice still plays,
+// so neither ever waits for the other. Commands only carry state, so
+// when the queue is full a sound keeps what it could not post and tries
+// again on its next call or on Flush().
+////////////////////////////////////////////////////////////////////////////
+
+#define MIXER_QUEUE_SIZE    1024
+
+class Mixer {
+    friend class MixerSound;
+
+public:
+    static HRESULT CreateMixer(UINT uSampleRate, Mixer** ppMixer);
+
+    // Render() must have returned for good. Sounds may outlive the
+    // mixer, they go silent when it is deleted.
+    ~Mixer();
+
+    // Takes ownership of the clip on success. The sound reserves cVoices
+    // voices, so up to that many of its Play()s overlap; E_OUTOFMEMORY
+    // once the pool or MIXER_MAX_SOUNDS runs out.
+    HRESULT CreateSound(
+        AudioClip*      pClip,
+        UINT            cVoices,
+        VOICESTEAL      steal,
+        MixerSound**    ppSound);
+
+    // Takes ownership of the stream on success. The sound gets one voice
+    // for each the stream was created with. The stream rate is
+    // resampled to the mixer rate and may be up to four times either
+    // way off.
+    HRESULT CreateStreamSound(
+        AudioStream*    pStream,
+        VOICESTEAL      steal,
+        MixerSound**    ppSound);
+
+    UINT GetSampleRate() CONST;
+
+    // Where clips for this mixer convert into
+    SamplePool* GetSamplePool();
+
+    // Sounds with a voice playing, as of the last rendered block
+    UINT GetPlayingCount() CONST;
+
+    VOID GetStats(MIXERSTATS* pStats) CONST;
+
+    VOID SetMasterGain(FLOAT fGain);
+
+    // Posts whatever the sounds could not post before; call once a frame
+    VOID Flush();
+
+    // Overwrites cFrames * MIXER_CHANNELS samples
+    VOID Render(FLOAT* pfOutput, UINT cFrames);
+
+    // Defaults to the best kernels for this CPU; all of them produce the
+    // same samples. Only while nothing renders.
+    VOID SetResampleKernels(CONST RESAMPLEKERNELS* pKernels);
+
+private:
+    typedef enum _MIXERCOMMANDTYPE {
+        MC_ATTACH,              // pClip or pStream, uFirstVoice, cVoices,
+                                // steal, fValue (source rate / ours)
+        MC_RELEASE,
+        MC_PLAY,                // uSerial
+        MC_STOP,                // uSerial
+        MC_SET_LOOP,            // bValue
+        MC_SET_GAIN,            // fValue
+        MC_SET_RATE,            // fValue
+        MC_SET_MASTER_GAIN      // fValue
+    } MIXERCOMMANDTYPE;
+
+    typedef struct _MIXERCOMMAND {
+        MIXERCOMMANDTYPE    type;
+        UINT                uSound;
+        UINT                uSerial;
+        AudioClip*          pClip;
+        AudioStream*        pStream;
+        UINT                uFirstVoice;
+        UINT                cVoices;
+        VOICESTEAL          steal;
+        FLOAT               fValue;
+        BOOL                bValue;
+    } MIXERCOMMAND;
+
+    // One playhead, plus the one it replaced while that fades out.
+    // Owned by the audio thread. A stream keeps the playheads of its
+    // voices itself.
+    typedef struct _MIXERVOICE {
+        ULONGLONG       ullPosition;        // Next frame, 32.32
+        ULONGLONG       ullStarted;         // Start order
+        BOOL            bPlaying;
+        ULONGLONG       ullFadePosition;
+        UINT            cFadeFrames;        // 0 when nothing fades
+    } MIXERVOICE;
+
+    // Owned by the audio thread, except lState
+    typedef struct _MIXERSLOT {
+        AudioClip*      pClip;      // Both NULL when the slot is free
+        AudioStream*    pStream;
+        UINT            uFirstVoice;
+        UINT            cVoices;
+        VOICESTEAL      steal;
+        DOUBLE          fStepScale; // Source rate / mixer rate
+        ULONGLONG       ullStep;    // Source frames per frame, 32.32
+        FLOAT           fGain;
+        FLOAT           fRampGain;  // Gain reached by the last Render()
+        BOOL            bLoop;
+        UINT            uSerial;    // Of the last play or stop applied
+        volatile LONG   lState;     // Published (uSerial << 1) | playing
+    } MIXERSLOT;
+
+    // A released sound on its way back to the UI thread
+    typedef struct _MIXERRELEASE {
+        UINT            uSound;
+        UINT            uFirstVoice;
+        UINT            cVoices;
+        AudioClip*      pClip;
+        AudioStream*    pStream;
+    } MIXERRELEASE;
+
+    Mixer();
+
+    // Finds a slot and voices for an MC_ATTACH and posts it
+    HRESULT AttachSound(MIXERCOMMAND* pCommand, MixerSound** ppSound);
+
+    BOOL PostCommand(CONST MIXERCOMMAND& command);
+    VOID ProcessCommands();
+    VOID CollectReleased();
+
+    // uVoice counts from the slot's first voice
+    VOID StartVoice(MIXERSLOT* pSlot);
+    VOID FadeVoice(MIXERSLOT* pSlot, UINT uVoice);
+
+    UINT MixPlayhead(
+        MIXERSLOT*  pSlot,
+        UINT        uVoice,
+        BOOL        bFade,
+        FLOAT*      pfOutput,
+        UINT        cFrames,
+        FLOAT       fGain,
+        FLOAT       fGainStep);
+
+    UINT MixSlot(MIXERSLOT* pSlot, FLOAT* pfOutput, UINT cFrames);
+
+    SpscQueue<MIXERCOMMAND, MIXER_QUEUE_SIZE>   _commands;
+    SpscQueue<MIXERRELEASE, MIXER_MAX_SOUNDS>   _released;
+
+    // UI thread
+    SamplePool      _pool;
+    MixerSound*     _sounds[MIXER_MAX_SOUNDS];
+    BOOL            _bSlotBusy[MIXER_MAX_SOUNDS];
+    BOOL            _bVoiceBusy[MIXER_MAX_VOICES];
+    UINT            _cVoicesReserved;
+    FLOAT           _fRequestedMasterGain;
+    BOOL            _bMasterGainDirty;
+
+    // Audio thread
+    MIXERSLOT               _slots[MIXER_MAX_SOUNDS];
+    MIXERVOICE              _voices[MIXER_MAX_VOICES];
+    ULONGLONG               _ullStarts;
+    ULONG                   _cVoicesStolen;
+    FLOAT                   _fMasterGain;
+    CONST RESAMPLEKERNELS*  _pResampleKernels;
+
+    // Published by Render()
+    volatile LONG   _lVoicesInUse;
+    volatile LONG   _lVoicesStolen;
+
+    UINT            _uSampleRate;
+    UINT            _cFadeFrames;
+};
+
+class MixerSound : public Sound {
+    friend class Mixer;
+
+public:
+    ~MixerSound();
+
+    // Starts another voice from the beginning. When all are playing a
+    // sound with one voice leaves it alone; with more it steals one.
+    VOID Play();
+
+    // Fades out every voice
+    VOID Stop();
+
+    VOID SetLoop(BOOL bLoop);
+    BOOL GetLoop() CONST;
+
+    // What the last Play()/Stop() asked for until the audio thread has
+    // seen it, then whether any voice is actually playing
+    BOOL IsPlaying() CONST;
+
+    // Linear, applied with a ramp over the next rendered block
+    VOID SetGain(FLOAT fGain);
+    FLOAT GetGain() CONST;
+
+    // Playback speed, which also shifts the pitch. Clamped to
+    // RESAMPLE_MIN_RATE..RESAMPLE_MAX_RATE.
+    VOID SetRate(FLOAT fRate);
+    FLOAT GetRate() CONST;
+
+private:
+    // What changed but is not in the queue yet
+    enum {
+        DIRTY_STOP = 1,
+        DIRTY_LOOP = 2,
+        DIRTY_GAIN = 4,
+        DIRTY_RATE = 8
+    };
+
+    MixerSound(Mixer* pMixer, UINT uSound, UINT cVoices);
+
+    VOID Flush();
+
+    Mixer*  _pMixer;
+    UINT    _uSound;
+    UINT    _cVoices;
+    UINT    _uSerial;
+    UINT    _fDirty;
+    UINT    _cPendingPlays;     // Plays not in the queue yet
+    BOOL    _bPlayRequested;
+    BOOL    _bLoop;
+    FLOAT   _fGain;
+    FLOAT   _fRate;
+};
+
+#endif // __MIXER_H
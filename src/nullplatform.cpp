@@ -0,0 +1,231 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "nullplatform.h"
+
+////////////////////////////////////////////////////////////////////////////
+// NullInputSource
+////////////////////////////////////////////////////////////////////////////
+
+NullInputSource::NullInputSource()
+    : _uHead(0),
+      _uCount(0)
+{
+}
+
+BOOL NullInputSource::Push(CONST INPUTEVENT& event)
+{
+    if (_uCount == NULL_INPUT_QUEUE_SIZE) {
+        return FALSE;
+    }
+
+    _events[(_uHead + _uCount) % NULL_INPUT_QUEUE_SIZE] = event;
+    _uCount++;
+
+    return TRUE;
+}
+
+BOOL NullInputSource::PollInput(INPUTEVENT* pEvent)
+{
+    if (_uCount == 0 || pEvent == NULL) {
+        return FALSE;
+    }
+
+    *pEvent = _events[_uHead];
+
+    _uHead = (_uHead + 1) % NULL_INPUT_QUEUE_SIZE;
+    _uCount--;
+
+    return TRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// NullRenderBitmap
+////////////////////////////////////////////////////////////////////////////
+
+NullRenderBitmap::NullRenderBitmap(UINT uWidth, UINT uHeight)
+    : _uWidth(uWidth),
+      _uHeight(uHeight)
+{
+}
+
+UINT NullRenderBitmap::GetWidth() CONST
+{
+    return _uWidth;
+}
+
+UINT NullRenderBitmap::GetHeight() CONST
+{
+    return _uHeight;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// NullRenderSink
+////////////////////////////////////////////////////////////////////////////
+
+NullRenderSink::NullRenderSink(FLOAT fWidth, FLOAT fHeight)
+    : _size(Geometry::MakeSize(fWidth, fHeight)),
+      _lastTransform(Geometry::Identity()),
+      _cFrames(0),
+      _cBitmapDraws(0),
+      _cEllipseDraws(0)
+{
+}
+
+HRESULT NullRenderSink::CreateBitmap(
+    UINT            uWidth,
+    UINT            uHeight,
+    UINT            uStride,
+    CONST BYTE*     pbPixels,
+    RenderBitmap**  ppBitmap)
+{
+    if (ppBitmap == NULL || pbPixels == NULL || uStride < uWidth * 4) {
+        return E_INVALIDARG;
+    }
+
+    *ppBitmap = new NullRenderBitmap(uWidth, uHeight);
+
+    return (*ppBitmap != NULL) ? S_OK : E_OUTOFMEMORY;
+}
+
+Geometry::Size NullRenderSink::GetSize() CONST
+{
+    return _size;
+}
+
+VOID NullRenderSink::BeginDraw()
+{
+}
+
+HRESULT NullRenderSink::EndDraw()
+{
+    _cFrames++;
+    return S_OK;
+}
+
+VOID NullRenderSink::PushClip(CONST Geometry::Rect& rect)
+{
+}
+
+VOID NullRenderSink::PopClip()
+{
+}
+
+VOID NullRenderSink::Clear()
+{
+}
+
+VOID NullRenderSink::DrawBitmap(
+    RenderBitmap*           pBitmap,
+    CONST Geometry::Matrix& transform,
+    FLOAT                   fOpacity)
+{
+    _lastTransform = transform;
+    _cBitmapDraws++;
+}
+
+VOID NullRenderSink::FillEllipse(
+    CONST Geometry::Point&  center,
+    FLOAT                   fRadiusX,
+    FLOAT                   fRadiusY,
+    CONST RENDERCOLOR&      color)
+{
+    _cEllipseDraws++;
+}
+
+ULONG NullRenderSink::GetFrameCount() CONST
+{
+    return _cFrames;
+}
+
+ULONG NullRenderSink::GetBitmapDrawCount() CONST
+{
+    return _cBitmapDraws;
+}
+
+ULONG NullRenderSink::GetEllipseDrawCount() CONST
+{
+    return _cEllipseDraws;
+}
+
+Geometry::Matrix NullRenderSink::GetLastTransform() CONST
+{
+    return _lastTransform;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// NullSound
+////////////////////////////////////////////////////////////////////////////
+
+NullSound::NullSound()
+    : _bLoop(FALSE),
+      _bPlaying(FALSE),
+      _fGain(1.0f),
+      _fRate(1.0f),
+      _cPlays(0)
+{
+}
+
+VOID NullSound::Play()
+{
+    _bPlaying = TRUE;
+    _cPlays++;
+}
+
+VOID NullSound::Stop()
+{
+    _bPlaying = FALSE;
+}
+
+VOID NullSound::SetLoop(BOOL bLoop)
+{
+    _bLoop = bLoop;
+}
+
+BOOL NullSound::GetLoop() CONST
+{
+    return _bLoop;
+}
+
+BOOL NullSound::IsPlaying() CONST
+{
+    return _bPlaying;
+}
+
+VOID NullSound::SetGain(FLOAT fGain)
+{
+    _fGain = fGain;
+}
+
+FLOAT NullSound::GetGain() CONST
+{
+    return _fGain;
+}
+
+VOID NullSound::SetRate(FLOAT fRate)
+{
+    _fRate = fRate;
+}
+
+FLOAT NullSound::GetRate() CONST
+{
+    return _fRate;
+}
+
+ULONG NullSound::GetPlayCount() CONST
+{
+    return _cPlays;
+}
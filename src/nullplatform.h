@@ -0,0 +1,134 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NULLPLATFORM_H
+#define __NULLPLATFORM_H
+
+#include "wintypes.h"
+#include "platform.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Headless backend: input comes from a queue, drawing and sounds are
+// only counted. Pair with ManualClock to run the engine without a window.
+////////////////////////////////////////////////////////////////////////////
+
+#define NULL_INPUT_QUEUE_SIZE   256
+
+class NullInputSource : public InputSource {
+public:
+    NullInputSource();
+
+    BOOL Push(CONST INPUTEVENT& event);
+
+    BOOL PollInput(INPUTEVENT* pEvent);
+
+private:
+    INPUTEVENT  _events[NULL_INPUT_QUEUE_SIZE];
+    UINT        _uHead;
+    UINT        _uCount;
+};
+
+////////////////////////////////////////////////////////////////////////////
+
+class NullRenderBitmap : public RenderBitmap {
+public:
+    NullRenderBitmap(UINT uWidth, UINT uHeight);
+
+    UINT GetWidth() CONST;
+    UINT GetHeight() CONST;
+
+private:
+    UINT _uWidth;
+    UINT _uHeight;
+};
+
+class NullRenderSink : public RenderSink {
+public:
+    NullRenderSink(FLOAT fWidth, FLOAT fHeight);
+
+    HRESULT CreateBitmap(
+        UINT            uWidth,
+        UINT            uHeight,
+        UINT            uStride,
+        CONST BYTE*     pbPixels,
+        RenderBitmap**  ppBitmap);
+
+    Geometry::Size GetSize() CONST;
+
+    VOID BeginDraw();
+    HRESULT EndDraw();
+
+    VOID PushClip(CONST Geometry::Rect& rect);
+    VOID PopClip();
+
+    VOID Clear();
+
+    VOID DrawBitmap(
+        RenderBitmap*           pBitmap,
+        CONST Geometry::Matrix& transform,
+        FLOAT                   fOpacity);
+
+    VOID FillEllipse(
+        CONST Geometry::Point&  center,
+        FLOAT                   fRadiusX,
+        FLOAT                   fRadiusY,
+        CONST RENDERCOLOR&      color);
+
+    ULONG GetFrameCount() CONST;
+    ULONG GetBitmapDrawCount() CONST;
+    ULONG GetEllipseDrawCount() CONST;
+
+    Geometry::Matrix GetLastTransform() CONST;
+
+private:
+    Geometry::Size      _size;
+    Geometry::Matrix    _lastTransform;
+    ULONG               _cFrames;
+    ULONG               _cBitmapDraws;
+    ULONG               _cEllipseDraws;
+};
+
+////////////////////////////////////////////////////////////////////////////
+
+class NullSound : public Sound {
+public:
+    NullSound();
+
+    VOID Play();
+    VOID Stop();
+
+    VOID SetLoop(BOOL bLoop);
+    BOOL GetLoop() CONST;
+
+    BOOL IsPlaying() CONST;
+
+    VOID SetGain(FLOAT fGain);
+    FLOAT GetGain() CONST;
+
+    VOID SetRate(FLOAT fRate);
+    FLOAT GetRate() CONST;
+
+    ULONG GetPlayCount() CONST;
+
+private:
+    BOOL    _bLoop;
+    BOOL    _bPlaying;
+    FLOAT   _fGain;
+    FLOAT   _fRate;
+    ULONG   _cPlays;
+};
+
+#endif // __NULLPLATFORM_H
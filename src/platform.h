@@ -0,0 +1,131 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __PLATFORM_H
+#define __PLATFORM_H
+
+#include "wintypes.h"
+#include "clock.h"
+#include "geometry.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Platform interface
+//
+// The engine only sees the outside world through these: a Clock for time,
+// INPUTEVENTs for input, a RenderSink to draw into and Sounds to play.
+// The Win32 build backs them with QPC, window messages, Direct2D and
+// a Mixer on WASAPI; nullplatform.h has headless stand-ins and
+// softwarerendersink.h draws on the CPU.
+////////////////////////////////////////////////////////////////////////////
+
+typedef enum _INPUTEVENTTYPE {
+    IE_MOVE,            // fDeltaX, fDeltaY
+    IE_PRESS,
+    IE_RELEASE,
+    IE_WHEEL,           // iWheelDelta, WHEEL_DELTA units
+    IE_TOGGLE_MARKER
+} INPUTEVENTTYPE;
+
+typedef struct _INPUTEVENT {
+    INPUTEVENTTYPE  type;
+    LONGLONG        llTime;
+    FLOAT           fDeltaX;
+    FLOAT           fDeltaY;
+    INT             iWheelDelta;
+} INPUTEVENT;
+
+class InputSource {
+public:
+    virtual ~InputSource() {}
+
+    virtual BOOL PollInput(INPUTEVENT* pEvent) = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////
+
+// Straight (not premultiplied) alpha, same as D2D1_COLOR_F
+typedef struct _RENDERCOLOR {
+    FLOAT r;
+    FLOAT g;
+    FLOAT b;
+    FLOAT a;
+} RENDERCOLOR;
+
+class RenderBitmap {
+public:
+    virtual ~RenderBitmap() {}
+
+    virtual UINT GetWidth() CONST = 0;
+    virtual UINT GetHeight() CONST = 0;
+};
+
+class RenderSink {
+public:
+    virtual ~RenderSink() {}
+
+    // Pixels are 32bpp premultiplied BGRA
+    virtual HRESULT CreateBitmap(
+        UINT            uWidth,
+        UINT            uHeight,
+        UINT            uStride,
+        CONST BYTE*     pbPixels,
+        RenderBitmap**  ppBitmap) = 0;
+
+    virtual Geometry::Size GetSize() CONST = 0;
+
+    virtual VOID BeginDraw() = 0;
+    virtual HRESULT EndDraw() = 0;
+
+    virtual VOID PushClip(CONST Geometry::Rect& rect) = 0;
+    virtual VOID PopClip() = 0;
+
+    // Clears the current clip to transparent
+    virtual VOID Clear() = 0;
+
+    virtual VOID DrawBitmap(
+        RenderBitmap*           pBitmap,
+        CONST Geometry::Matrix& transform,
+        FLOAT                   fOpacity) = 0;
+
+    virtual VOID FillEllipse(
+        CONST Geometry::Point&  center,
+        FLOAT                   fRadiusX,
+        FLOAT                   fRadiusY,
+        CONST RENDERCOLOR&      color) = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////
+
+class Sound {
+public:
+    virtual ~Sound() {}
+
+    virtual VOID Play() = 0;
+    virtual VOID Stop() = 0;
+
+    virtual VOID SetLoop(BOOL bLoop) = 0;
+    virtual BOOL GetLoop() CONST = 0;
+
+    virtual BOOL IsPlaying() CONST = 0;
+
+    // Linear gain, 1 is the clip as recorded
+    virtual VOID SetGain(FLOAT fGain) = 0;
+
+    // Playback speed, 1 is the recorded speed and pitch
+    virtual VOID SetRate(FLOAT fRate) = 0;
+};
+
+#endif // __PLATFORM_H
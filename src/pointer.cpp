@@ -16,21 +16,69 @@
 
 #include "pointer.h"
 
+#include <math.h>
+
+#include "portablemath.h"
 #include "safemem.h"
 
-#include "resource.h"
+#define MARKER_SIZE     2.5f
+
+// A press tilts and shrinks the pointer on springs, which settle about
+// as fast as the old 0.25 s tween did and turn around smoothly when the
+// button is released half way. PRESS_SCALE is on the frame cache's scale
+// grid, so the held pose is cached; the way there is drawn directly.
+#define PRESS_FREQUENCY 30.0f           // Radians per second
+#define PRESS_ANGLE     -45.0f
+#define PRESS_SCALE     0.92f
+
+#define ANGLE_PRECISION 0.01f           // Degrees
+#define SCALE_PRECISION 0.0005f
+#define FOLLOW_PRECISION 0.05f          // Pixels
 
-#define MARKER_SIZE 2.5f
+// The drag sound speeds up and gets louder with the pointer, reaching
+// the FAST values at DRAG_SPEED_FAST DIPs per second
+#define DRAG_SPEED_SMOOTHING    0.06f   // Seconds
+#define DRAG_SPEED_FAST         2500.0f
+#define DRAG_RATE_SLOW          0.8f
+#define DRAG_RATE_FAST          1.4f
+#define DRAG_GAIN_SLOW          0.5f
+#define DRAG_GAIN_FAST          1.0f
+
+static CONST RENDERCOLOR MARKER_COLOR = { 1.0f, 0.0f, 0.0f, 1.0f };
 
 Pointer::Pointer()
-    : _tweener(0.25f, -45.0f, 0.0f, Easing::EaseOutCirc),
-      _markerColor(D2D1::ColorF::Red),
+    : _pSprite(NULL),
+      _pEffect(NULL),
+      _pEffectMove(NULL),
+      _angle(0.0f, PRESS_FREQUENCY, ANGLE_PRECISION),
+      _fAngle(0.0f),
+      _fPreviousAngle(0.0f),
+      _pressScale(1.0f, PRESS_FREQUENCY, SCALE_PRECISION),
+      _fPressScale(1.0f),
+      _fPreviousPressScale(1.0f),
+      _fDrawnPressScale(1.0f),
+      _followX(0.0f, 0.0f, FOLLOW_PRECISION),
+      _followY(0.0f, 0.0f, FOLLOW_PRECISION),
+      _follow(Geometry::MakePoint(0.0f, 0.0f)),
+      _previousFollow(Geometry::MakePoint(0.0f, 0.0f)),
+      _drawnFollow(Geometry::MakePoint(0.0f, 0.0f)),
+      _bFollow(FALSE),
+      _spritePosition(Geometry::MakePoint(0.0f, 0.0f)),
+      _rotationCenter(Geometry::MakePoint(0.0f, 0.0f)),
+      _fRotation(0.0f),
+      _fSpriteScale(1.0f),
+      _markerColor(MARKER_COLOR),
+      _position(Geometry::MakePoint(0.0f, 0.0f)),
+      _lastPosition(Geometry::MakePoint(0.0f, 0.0f)),
+      _drawOffset(Geometry::MakePoint(0.0f, 0.0f)),
+      _markerPosition(Geometry::MakePoint(0.0f, 0.0f)),
       _fScale(0.9f),
+      _fDpiScale(1.0f),
+      _fDragSpeed(0.0f),
       _bPressed(FALSE),
       _bShowMarker(TRUE),
-      _pEffect(NULL),
-      _pEffectMove(NULL),
-      _pSprite(NULL)
+      _bDirty(TRUE),
+      _bMoving(FALSE)
 {
 }
 
@@ -41,71 +89,102 @@ Pointer::~Pointer()
     SafeDelete(&_pEffectMove);
 }
 
-HRESULT Pointer::InitializeResources(
-    ID2D1HwndRenderTarget* pRenderTarget,
-    HINSTANCE              hInstance)
+HRESULT Pointer::Initialize(
+    Sprite* pSprite,
+    Sound*  pEffect,
+    Sound*  pEffectMove)
 {
-    HRESULT hResult;
+    if (pSprite == NULL || pEffect == NULL || pEffectMove == NULL) {
+        return E_INVALIDARG;
+    }
 
-    hResult = Sprite::CreateSpriteFromResource(
-        pRenderTarget,
-        MAKEINTRESOURCE(IDR_POINTER_PNG),
-        RT_RCDATA,
-        &_pSprite);
+    SafeDelete(&_pSprite);
+    SafeDelete(&_pEffect);
+    SafeDelete(&_pEffectMove);
 
-    if (FAILED(hResult)) {
-        goto failed;
-    }
+    _pSprite = pSprite;
+    _pEffect = pEffect;
+    _pEffectMove = pEffectMove;
+
+    _pEffectMove->SetLoop(TRUE);
+    
+    SetScale(_fScale);
 
-    hResult = Audio::CreateAudioFromResource(
-        hInstance,
-        MAKEINTRESOURCE(IDR_EFFECT_WAV),
-        TEXT("WAVE"),
-        &_pEffect);
+    return S_OK;
+}
 
-    if (FAILED(hResult)) {
-        goto failed;
+HRESULT Pointer::EnableFrameCache(RenderSink* pSink, SIZE_T cbBudget)
+{
+    POINTERFRAME    frame;
+    HRESULT         hResult;
+
+    if (_pSprite == NULL) {
+        return E_UNEXPECTED;
     }
 
-    hResult = Audio::CreateAudioFromResource(
-        hInstance,
-        MAKEINTRESOURCE(IDR_EFFECT_MOVE_WAV),
-        TEXT("WAVE"),
-        &_pEffectMove);
+    hResult = _pSprite->EnableFrameCache(pSink, cbBudget);
 
     if (FAILED(hResult)) {
-        goto failed;
+        return hResult;
     }
 
-    hResult = pRenderTarget->CreateSolidColorBrush(
-        _markerColor,
-        &_markerBrush);
-    
-    if (FAILED(hResult)) {
-        goto failed;
-    }
+    // The press is the only rotation the sprite ever gets, at its own
+    // scale; springs that turn around may go a little past either end
+    GetFrame(&frame);
+    PoseSprite(_pSprite, frame);
+    _pSprite->WarmFrameCache(PRESS_ANGLE, 0.0f);
 
-    _pEffectMove->SetLoop(TRUE);
-    
-    SetScale(_fScale);
+    _fDrawnPressScale = PRESS_SCALE;
+    UpdateSpriteScale();
+    GetFrame(&frame);
+    PoseSprite(_pSprite, frame);
+    _pSprite->WarmFrameCache(PRESS_ANGLE, 0.0f);
 
-failed:
-    if (FAILED(hResult)) {
-        SafeDelete(&_pSprite);
-        SafeDelete(&_pEffect);
-        SafeDelete(&_pEffectMove);
-    }
+    _fDrawnPressScale = _fPressScale;
+    UpdateSpriteScale();
+    _bDirty = TRUE;
 
-    return hResult;
+    return S_OK;
 }
 
-VOID Pointer::Update(FLOAT fDelta)
+VOID Pointer::Step(FLOAT fStep)
 {
-    BOOL bHasMoved = FALSE;
+    _fPreviousAngle = _fAngle;
+    _fPreviousPressScale = _fPressScale;
+    _previousFollow = _follow;
+
+    _angle.Update(fStep);
+    _fAngle = _angle.GetValue();
+
+    _pressScale.Update(fStep);
+    _fPressScale = _pressScale.GetValue();
+
+    if (_bFollow == TRUE) {
+        _followX.SetTarget(_position.x);
+        _followY.SetTarget(_position.y);
+
+        _followX.Update(fStep);
+        _followY.Update(fStep);
 
-    if (_bPressed == TRUE) {
+        _follow.x = _followX.GetValue();
+        _follow.y = _followY.GetValue();
+    }
+}
+
+BOOL Pointer::Update(FLOAT fDelta, FLOAT fAlpha)
+{
+    Geometry::Point follow;
+    BOOL            bHasMoved = FALSE;
+    BOOL            bRedraw = FALSE;
+    BOOL            bReposition = FALSE;
+    FLOAT           fAngle, fPressScale;
+
+    // Frames that fall between two steps leave the drag to the next one
+    if (_bPressed == TRUE && fDelta > 0.0f) {
         bHasMoved = _lastPosition.x != _position.x ||
                     _lastPosition.y != _position.y;
+
+        UpdateDragSound(fDelta);
         
         if (bHasMoved == TRUE) {
             _pEffectMove->Play();
@@ -113,43 +192,142 @@ VOID Pointer::Update(FLOAT fDelta)
             _pEffectMove->Stop();
         }
 
+        _bMoving = bHasMoved;
         _lastPosition = _position;
     }
 
-    if (_tweener.Update(fDelta)) {
-        _pSprite->SetRotation(_tweener.GetValue());
+    fAngle = _fPreviousAngle + (_fAngle - _fPreviousAngle) * fAlpha;
+
+    if (fAngle != _fRotation) {
+        _fRotation = fAngle;
+        _bDirty = TRUE;
+    }
+
+    fPressScale = _fPreviousPressScale +
+                  (_fPressScale - _fPreviousPressScale) * fAlpha;
+
+    if (fPressScale != _fDrawnPressScale) {
+        _fDrawnPressScale = fPressScale;
+        UpdateSpriteScale();
+        bReposition = TRUE;
     }
+
+    if (_bFollow == TRUE) {
+        follow.x = _previousFollow.x + (_follow.x - _previousFollow.x) * fAlpha;
+        follow.y = _previousFollow.y + (_follow.y - _previousFollow.y) * fAlpha;
+
+        if (follow.x != _drawnFollow.x || follow.y != _drawnFollow.y) {
+            _drawnFollow = follow;
+            bReposition = TRUE;
+        }
+    }
+
+    if (bReposition == TRUE) {
+        UpdateDrawPosition();
+        _bDirty = TRUE;
+    }
+
+    bRedraw = _bDirty;
+    _bDirty = FALSE;
+
+    return bRedraw;
 }
 
-VOID Pointer::Draw(ID2D1RenderTarget *pRenderTarget)
+VOID Pointer::GetFrame(POINTERFRAME* pFrame) CONST
 {
-    if (_bShowMarker == TRUE) {
-        pRenderTarget->FillEllipse(
-            D2D1::Ellipse(_markerPosition, MARKER_SIZE, MARKER_SIZE),
-            _markerBrush);
+    pFrame->spritePosition = _spritePosition;
+    pFrame->rotationCenter = _rotationCenter;
+    pFrame->fRotation = _fRotation;
+    pFrame->fSpriteScale = _fSpriteScale;
+    pFrame->fDisplayScale = GetDisplayScale();
+    pFrame->markerPosition = _markerPosition;
+    pFrame->fMarkerRadius = MARKER_SIZE * _fDpiScale;
+    pFrame->markerColor = _markerColor;
+    pFrame->bShowMarker = _bShowMarker;
+}
+
+VOID Pointer::PoseSprite(Sprite* pSprite, CONST POINTERFRAME& frame)
+{
+    pSprite->SetPosition(frame.spritePosition);
+    pSprite->SetRotation(frame.fRotation);
+    pSprite->SetRotationCenter(frame.rotationCenter);
+    pSprite->SetScale(
+        Geometry::MakeSize(frame.fSpriteScale, frame.fSpriteScale));
+    pSprite->SetFrameCacheScale(frame.fDisplayScale);
+}
+
+BOOL Pointer::IsIdle() CONST
+{
+    // A pressed pointer that just moved needs one more update to stop
+    // the move effect, and the last step of a spring one more to be
+    // blended in
+    if (_bDirty == TRUE || _bMoving == TRUE) {
+        return FALSE;
     }
-    
-    _pSprite->Draw(pRenderTarget);
+
+    if (_angle.IsAtRest() == FALSE || _fPreviousAngle != _fAngle ||
+        _fRotation != _fAngle)
+    {
+        return FALSE;
+    }
+
+    if (_pressScale.IsAtRest() == FALSE ||
+        _fPreviousPressScale != _fPressScale ||
+        _fDrawnPressScale != _fPressScale)
+    {
+        return FALSE;
+    }
+
+    if (_bFollow == TRUE) {
+        return _followX.IsAtRest() == TRUE && _followY.IsAtRest() == TRUE &&
+               _followX.GetTarget() == _position.x &&
+               _followY.GetTarget() == _position.y &&
+               _previousFollow.x == _follow.x &&
+               _previousFollow.y == _follow.y &&
+               _drawnFollow.x == _follow.x &&
+               _drawnFollow.y == _follow.y;
+    }
+
+    return TRUE;
+}
+
+VOID Pointer::Invalidate()
+{
+    _bDirty = TRUE;
 }
 
-D2D1_POINT_2F Pointer::GetPosition()
+Geometry::Point Pointer::GetPosition() CONST
 {
     return _position;
 }
 
-VOID Pointer::SetPosition(CONST D2D1_POINT_2F &position)
+VOID Pointer::SetPosition(CONST Geometry::Point& position)
 {
-    D2D1_POINT_2F markerPosition;
+    if (position.x == _position.x && position.y == _position.y) {
+        return;
+    }
 
     _position = position;
-    _pSprite->SetPosition(position);
 
-    // The values 45.0f and 35.0f were chosen empirically  
-    // TODO: They need to be somehow linked to the sprite size  
-    markerPosition.x = position.x - 45.0f * _fScale;
-    markerPosition.y = position.y + 35.0f * _fScale;
+    UpdateDrawPosition();
+    _bDirty = TRUE;
+}
 
-    _markerPosition = markerPosition;
+Geometry::Point Pointer::GetDrawOffset() CONST
+{
+    return _drawOffset;
+}
+
+VOID Pointer::SetDrawOffset(CONST Geometry::Point& offset)
+{
+    if (offset.x == _drawOffset.x && offset.y == _drawOffset.y) {
+        return;
+    }
+
+    _drawOffset = offset;
+
+    UpdateDrawPosition();
+    _bDirty = TRUE;
 }
 
 FLOAT Pointer::GetScale() CONST
@@ -159,49 +337,170 @@ FLOAT Pointer::GetScale() CONST
 
 VOID Pointer::SetScale(FLOAT fScale)
 {
-    D2D1_SIZE_U   bitmapSize;
-    D2D1_POINT_2F center;
-
     _fScale = fmaxf(0.0f, fminf(fScale, 1.0f));
 
-    bitmapSize = _pSprite->GetBitmapSize();
+    UpdateSpriteScale();
+    UpdateDrawPosition();
+    _bDirty = TRUE;
+}
+
+VOID Pointer::SetFollowFrequency(FLOAT fFrequency)
+{
+    if (fFrequency <= 0.0f) {
+        _bFollow = FALSE;
+        UpdateDrawPosition();
+        _bDirty = TRUE;
+        return;
+    }
 
-    center.x = ((FLOAT) bitmapSize.width  * _fScale) / 2.0f;
-    center.y =  (FLOAT) bitmapSize.height * _fScale;
+    _followX.SetFrequency(fFrequency);
+    _followY.SetFrequency(fFrequency);
 
-    _pSprite->SetRotationCenter(center);
-    _pSprite->SetScale(D2D1::SizeF(_fScale, _fScale));
+    if (_bFollow == FALSE) {
+        _bFollow = TRUE;
+        SnapToPosition();
+    }
+}
+
+FLOAT Pointer::GetFollowFrequency() CONST
+{
+    return (_bFollow == TRUE) ? _followX.GetFrequency() : 0.0f;
+}
+
+VOID Pointer::SnapToPosition()
+{
+    _followX.Reset(_position.x);
+    _followY.Reset(_position.y);
+
+    _follow = _position;
+    _previousFollow = _position;
+    _drawnFollow = _position;
+
+    UpdateDrawPosition();
+    _bDirty = TRUE;
 }
 
-D2D1_SIZE_F Pointer::GetSize() CONST
+FLOAT Pointer::GetDpiScale() CONST
 {
-    D2D1_SIZE_U bitmapSize;
-    D2D1_SIZE_F size;
+    return _fDpiScale;
+}
+
+VOID Pointer::SetDpiScale(FLOAT fDpiScale)
+{
+    if (fDpiScale <= 0.0f || fDpiScale == _fDpiScale) {
+        return;
+    }
+
+    _fDpiScale = fDpiScale;
+
+    if (_pSprite != NULL) {
+        SetScale(_fScale);
+    }
+}
+
+Geometry::Size Pointer::GetSize() CONST
+{
+    Geometry::Size bitmapSize;
+    Geometry::Size size;
 
     bitmapSize = _pSprite->GetBitmapSize();
 
-    size.width  = (FLOAT) bitmapSize.width  * _fScale;
-    size.height = (FLOAT) bitmapSize.height * _fScale;
+    size.width  = bitmapSize.width  * GetDisplayScale();
+    size.height = bitmapSize.height * GetDisplayScale();
 
     return size;
 }
 
+Sprite* Pointer::GetSprite()
+{
+    return _pSprite;
+}
+
 VOID Pointer::OnPress()
 {
+    _fDragSpeed = 0.0f;
     _bPressed = TRUE;
-    _tweener.Invert(TRUE);
+    _angle.SetTarget(PRESS_ANGLE);
+    _pressScale.SetTarget(PRESS_SCALE);
     _pEffect->Play();
 }
 
 VOID Pointer::OnRelease()
 {
     _bPressed = FALSE;
-    _tweener.Invert(FALSE);
-    _pEffect->Stop();
+    _bMoving = FALSE;
+    _angle.SetTarget(0.0f);
+    _pressScale.SetTarget(1.0f);
     _pEffectMove->Stop();
 }
 
+// Follows _position - _lastPosition, so call before _lastPosition moves
+VOID Pointer::UpdateDragSound(FLOAT fDelta)
+{
+    FLOAT fDeltaX = _position.x - _lastPosition.x;
+    FLOAT fDeltaY = _position.y - _lastPosition.y;
+    FLOAT fSpeed;
+    FLOAT t;
+
+    if (fDelta <= 0.0f) {
+        return;
+    }
+
+    fSpeed = sqrtf(fDeltaX * fDeltaX + fDeltaY * fDeltaY) / _fDpiScale;
+    fSpeed /= fDelta;
+
+    // Exponential smoothing, independent of the frame rate
+    _fDragSpeed += (fSpeed - _fDragSpeed) *
+                   (1.0f - PortableExpf(-fDelta / DRAG_SPEED_SMOOTHING));
+
+    t = _fDragSpeed / DRAG_SPEED_FAST;
+
+    if (t > 1.0f) {
+        t = 1.0f;
+    }
+
+    _pEffectMove->SetRate(
+        DRAG_RATE_SLOW + (DRAG_RATE_FAST - DRAG_RATE_SLOW) * t);
+    _pEffectMove->SetGain(
+        DRAG_GAIN_SLOW + (DRAG_GAIN_FAST - DRAG_GAIN_SLOW) * t);
+}
+
 VOID Pointer::ToggleMarker()
 {
     _bShowMarker = !_bShowMarker;
+    _bDirty = TRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+FLOAT Pointer::GetDisplayScale() CONST
+{
+    return _fScale * _fDpiScale;
+}
+
+// The press scale shrinks the sprite towards its position and leaves
+// the marker where it is
+VOID Pointer::UpdateSpriteScale()
+{
+    Geometry::Size bitmapSize = _pSprite->GetBitmapSize();
+
+    _fSpriteScale = GetDisplayScale() * _fDrawnPressScale;
+
+    _rotationCenter.x = (bitmapSize.width * _fSpriteScale) / 2.0f;
+    _rotationCenter.y =  bitmapSize.height * _fSpriteScale;
+}
+
+VOID Pointer::UpdateDrawPosition()
+{
+    Geometry::Point position = (_bFollow == TRUE) ? _drawnFollow : _position;
+
+    position.x += _drawOffset.x;
+    position.y += _drawOffset.y;
+
+    _spritePosition = position;
+
+    // The values 45.0f and 35.0f were chosen empirically  
+    // TODO: They need to be somehow linked to the sprite size  
+    _markerPosition.x = position.x - 45.0f * GetDisplayScale();
+    _markerPosition.y = position.y + 35.0f * GetDisplayScale();
 }
\ No newline at end of file
@@ -17,32 +17,87 @@
 #ifndef __POINTER_H
 #define __POINTER_H
 
-#include <Windows.h>
-#include <d2d1.h>
-
+#include "wintypes.h"
+#include "geometry.h"
+#include "platform.h"
 #include "sprite.h"
-#include "Audio.h"
-#include "tweener.h"
+#include "spring.h"
+
+// Everything a frame of the pointer shows, in surface pixels; what the
+// render side needs to draw it without touching the Pointer (see
+// Renderer)
+typedef struct _POINTERFRAME {
+    Geometry::Point spritePosition;
+    Geometry::Point rotationCenter;
+    FLOAT           fRotation;          // Degrees
+    FLOAT           fSpriteScale;
+    FLOAT           fDisplayScale;      // fSpriteScale without the press
+    Geometry::Point markerPosition;
+    FLOAT           fMarkerRadius;
+    RENDERCOLOR     markerColor;
+    BOOL            bShowMarker;
+} POINTERFRAME;
 
 class Pointer {
 public:
     Pointer();
     ~Pointer();
 
-    HRESULT InitializeResources(
-        ID2D1HwndRenderTarget* pRenderTarget,
-        HINSTANCE              hInstance);
+    // Takes ownership of the sprite and both sounds on success
+    HRESULT Initialize(
+        Sprite* pSprite,
+        Sound*  pEffect,
+        Sound*  pEffectMove);
+
+    // Draws the sprite from pre-rendered frames, see Sprite
+    HRESULT EnableFrameCache(RenderSink* pSink, SIZE_T cbBudget);
+
+    // Advances the springs by one fixed simulation step
+    VOID Step(FLOAT fStep);
+
+    // Once per frame, fDelta seconds of simulation after the last one
+    // and fAlpha of the way into the next step (see Simulation); TRUE
+    // when the pointer has to be redrawn
+    BOOL Update(FLOAT fDelta, FLOAT fAlpha);
+
+    // What the last Update() left on screen
+    VOID GetFrame(POINTERFRAME* pFrame) CONST;
+
+    // Moves, turns and scales the sprite the way the frame shows it, and
+    // lets its frame cache quantize relative to the display scale
+    static VOID PoseSprite(Sprite* pSprite, CONST POINTERFRAME& frame);
+
+    BOOL IsIdle() CONST;
+    VOID Invalidate();
 
-    VOID Update(FLOAT fDelta);
-    VOID Draw(ID2D1RenderTarget* pRenderTarget);
+    Geometry::Point GetPosition() CONST;
+    VOID SetPosition(CONST Geometry::Point& position);
 
-    D2D1_POINT_2F GetPosition();
-    VOID SetPosition(CONST D2D1_POINT_2F& position);
+    // Draws the pointer this far from its position without moving it,
+    // see PointerPredictor
+    Geometry::Point GetDrawOffset() CONST;
+    VOID SetDrawOffset(CONST Geometry::Point& offset);
 
     FLOAT GetScale() CONST;
     VOID SetScale(FLOAT fScale);
 
-    D2D1_SIZE_F GetSize() CONST;
+    // With a frequency above 0 the sprite follows the position on a
+    // spring (see Spring) instead of being drawn right on it; off by
+    // default, since it trails the hand
+    VOID SetFollowFrequency(FLOAT fFrequency);
+    FLOAT GetFollowFrequency() CONST;
+
+    // Draws the pointer at its position from the next update on, however
+    // far behind the follow spring is
+    VOID SnapToPosition();
+
+    // Monitor DPI / 96; multiplies the scale the sprite is drawn at
+    FLOAT GetDpiScale() CONST;
+    VOID SetDpiScale(FLOAT fDpiScale);
+
+    Geometry::Size GetSize() CONST;
+
+    Sprite* GetSprite();
 
     VOID OnPress();
     VOID OnRelease();
@@ -50,21 +105,52 @@ public:
     VOID ToggleMarker();
 
 private:
-    Sprite*                 _pSprite;
-    Audio*                  _pEffect;
-    Audio*                  _pEffectMove;
-    Tweener                 _tweener;
-
-    ID2D1SolidColorBrush*   _markerBrush;
+    FLOAT GetDisplayScale() CONST;
+    VOID UpdateSpriteScale();
+    VOID UpdateDrawPosition();
+    VOID UpdateDragSound(FLOAT fDelta);
 
-    D2D1::ColorF            _markerColor;
-    D2D1_POINT_2F           _position;
-    D2D1_POINT_2F           _lastPosition;
-    D2D1_POINT_2F           _markerPosition;
+    Sprite*                 _pSprite;
+    Sound*                  _pEffect;
+    Sound*                  _pEffectMove;
+
+    // Each spring's value after the last step and before it, which
+    // Update() blends, and what was drawn
+    Spring                  _angle;
+    FLOAT                   _fAngle;
+    FLOAT                   _fPreviousAngle;
+
+    Spring                  _pressScale;    // Times the display scale
+    FLOAT                   _fPressScale;
+    FLOAT                   _fPreviousPressScale;
+    FLOAT                   _fDrawnPressScale;
+
+    Spring                  _followX;
+    Spring                  _followY;
+    Geometry::Point         _follow;
+    Geometry::Point         _previousFollow;
+    Geometry::Point         _drawnFollow;
+    BOOL                    _bFollow;
+
+    // The sprite as drawn
+    Geometry::Point         _spritePosition;
+    Geometry::Point         _rotationCenter;
+    FLOAT                   _fRotation;
+    FLOAT                   _fSpriteScale;
+
+    RENDERCOLOR             _markerColor;
+    Geometry::Point         _position;
+    Geometry::Point         _lastPosition;
+    Geometry::Point         _drawOffset;
+    Geometry::Point         _markerPosition;
 
     FLOAT                   _fScale;
+    FLOAT                   _fDpiScale;
+    FLOAT                   _fDragSpeed;    // Smoothed, DIPs per second
     BOOL                    _bPressed;
     BOOL                    _bShowMarker;
+    BOOL                    _bDirty;
+    BOOL                    _bMoving;
 };
 
 #endif // __POINTER_H
\ No newline at end of file
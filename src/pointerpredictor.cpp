@@ -0,0 +1,322 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pointerpredictor.h"
+
+#include <math.h>
+
+#define PI                      3.14159265f
+
+// Starting points tuned with fp_predict on synthetic gestures
+#define DEFAULT_MIN_CUTOFF      4.0f
+#define DEFAULT_BETA            0.002f
+#define DEFAULT_D_CUTOFF        20.0f
+#define DEFAULT_MIN_SPEED       100.0f
+#define DEFAULT_MAX_LEAD        0.05f
+#define DEFAULT_MAX_DISTANCE    160.0f
+#define DEFAULT_MAX_GROWTH      1.25f
+
+// Samples closer together than this are merged; a gap longer than that
+// starts the estimate over
+#define MIN_SAMPLE_INTERVAL     (1.0f / 8000.0f)    // Seconds
+#define MAX_SAMPLE_INTERVAL     0.1f
+
+// Devices go quiet when the hand stops. The guess fades out between
+// QUIET_START and QUIET_END sample intervals without input, never
+// sooner than MIN_QUIET.
+#define QUIET_START             2.0f
+#define QUIET_END               4.0f
+#define MIN_QUIET               0.004f              // Seconds
+
+#define INTERVAL_SMOOTHING      0.1f
+
+// Fast devices move a pixel or two per report, so velocity is measured
+// over at least this long
+#define MIN_VELOCITY_SPAN       0.008f              // Seconds
+
+// Exponential smoothing factor for a first order low-pass
+static FLOAT Alpha(FLOAT fCutoff, FLOAT fInterval)
+{
+    FLOAT fTau = 1.0f / (2.0f * PI * fCutoff);
+
+    return 1.0f / (1.0f + fTau / fInterval);
+}
+
+static FLOAT Length(CONST Geometry::Point& point)
+{
+    return sqrtf(point.x * point.x + point.y * point.y);
+}
+
+// Distance along one axis, stopping where deceleration would reverse it
+static FLOAT Extrapolate(FLOAT fVelocity, FLOAT fAcceleration, FLOAT fLead)
+{
+    FLOAT fBoost;
+
+    if (fVelocity * fAcceleration < 0.0f &&
+        fabsf(fVelocity) < fabsf(fAcceleration) * fLead)
+    {
+        return -fVelocity * fVelocity / (2.0f * fAcceleration);
+    }
+
+    // Speeding up may at most double the distance
+    fBoost = 0.5f * fAcceleration * fLead * fLead;
+    fBoost = fmaxf(-fabsf(fVelocity * fLead),
+                   fminf(fBoost, fabsf(fVelocity * fLead)));
+
+    return fVelocity * fLead + fBoost;
+}
+
+PointerPredictor::PointerPredictor(Clock* pClock)
+    : _pClock(pClock)
+{
+    _parameters.fMinCutoff = DEFAULT_MIN_CUTOFF;
+    _parameters.fBeta = DEFAULT_BETA;
+    _parameters.fDCutoff = DEFAULT_D_CUTOFF;
+    _parameters.fMinSpeed = DEFAULT_MIN_SPEED;
+    _parameters.fMaxLead = DEFAULT_MAX_LEAD;
+    _parameters.fMaxDistance = DEFAULT_MAX_DISTANCE;
+    _parameters.fMaxGrowth = DEFAULT_MAX_GROWTH;
+
+    Reset();
+}
+
+VOID PointerPredictor::SetParameters(CONST PREDICTORPARAMETERS& parameters)
+{
+    _parameters = parameters;
+
+    _parameters.fMinCutoff = fmaxf(0.01f, _parameters.fMinCutoff);
+    _parameters.fDCutoff = fmaxf(0.01f, _parameters.fDCutoff);
+    _parameters.fBeta = fmaxf(0.0f, _parameters.fBeta);
+    _parameters.fMaxLead = fmaxf(0.0f, _parameters.fMaxLead);
+    _parameters.fMaxDistance = fmaxf(0.0f, _parameters.fMaxDistance);
+    _parameters.fMaxGrowth = fmaxf(0.0f, _parameters.fMaxGrowth);
+}
+
+VOID PointerPredictor::GetParameters(PREDICTORPARAMETERS* pParameters) CONST
+{
+    if (pParameters != NULL) {
+        *pParameters = _parameters;
+    }
+}
+
+VOID PointerPredictor::AddSample(
+    LONGLONG                llTime,
+    CONST Geometry::Point&  position)
+{
+    SAMPLE*         pNewest = &_history[_uNewest];
+    CONST SAMPLE*   pBase;
+    Geometry::Point velocity, acceleration;
+    FLOAT           fInterval, fSpan, fCutoff, fAlpha;
+
+    fInterval = (_cSamples > 0) ? GetSeconds(llTime - pNewest->llTime) : 0.0f;
+
+    if (_cSamples == 0 || fInterval > MAX_SAMPLE_INTERVAL ||
+        fInterval < 0.0f)
+    {
+        Reset();
+
+        _history[0].llTime = llTime;
+        _history[0].position = position;
+        _cSamples = 1;
+        return;
+    }
+
+    // Several events stamped together carry one sample's worth of motion
+    if (fInterval < MIN_SAMPLE_INTERVAL) {
+        pNewest->position = position;
+        return;
+    }
+
+    pBase = GetSampleBefore(llTime, MIN_VELOCITY_SPAN);
+    fSpan = GetSeconds(llTime - pBase->llTime);
+
+    velocity.x = (position.x - pBase->position.x) / fSpan;
+    velocity.y = (position.y - pBase->position.y) / fSpan;
+
+    if (_cSamples == 1) {
+        _velocity = velocity;
+        _fInterval = fInterval;
+    } else {
+        // 1-euro: smooth the derivative at a fixed cutoff, then let it
+        // open up the cutoff for the value itself
+        acceleration.x = (velocity.x - _velocity.x) / fInterval;
+        acceleration.y = (velocity.y - _velocity.y) / fInterval;
+
+        fAlpha = Alpha(_parameters.fDCutoff, fInterval);
+
+        _acceleration.x += (acceleration.x - _acceleration.x) * fAlpha;
+        _acceleration.y += (acceleration.y - _acceleration.y) * fAlpha;
+
+        fCutoff = _parameters.fMinCutoff +
+                  _parameters.fBeta * Length(_acceleration);
+        fAlpha = Alpha(fCutoff, fInterval);
+
+        _velocity.x += (velocity.x - _velocity.x) * fAlpha;
+        _velocity.y += (velocity.y - _velocity.y) * fAlpha;
+
+        _fInterval += (fInterval - _fInterval) * INTERVAL_SMOOTHING;
+    }
+
+    _uNewest = (_uNewest + 1) % HISTORY_SIZE;
+    _history[_uNewest].llTime = llTime;
+    _history[_uNewest].position = position;
+
+    if (_cSamples < HISTORY_SIZE) {
+        _cSamples++;
+    }
+}
+
+Geometry::Point PointerPredictor::Predict(LONGLONG llTime) CONST
+{
+    Geometry::Point offset = Geometry::MakePoint(0.0f, 0.0f);
+    FLOAT           fLead, fSpeed, fDistance, fLimit, fConfidence;
+
+    fSpeed = Length(_velocity);
+
+    if (_cSamples < 2 || fSpeed <= _parameters.fMinSpeed) {
+        return offset;
+    }
+
+    // Ramps in over another fMinSpeed, so the pointer does not jump
+    // when it starts moving
+    fConfidence = GetConfidence() *
+        fminf(1.0f, fSpeed / fmaxf(1.0f, _parameters.fMinSpeed) - 1.0f);
+
+    if (fConfidence <= 0.0f) {
+        return offset;
+    }
+
+    fLead = GetSeconds(llTime - _history[_uNewest].llTime);
+    fLead = fmaxf(0.0f, fminf(fLead, _parameters.fMaxLead));
+
+    offset.x = Extrapolate(_velocity.x, _acceleration.x, fLead);
+    offset.y = Extrapolate(_velocity.y, _acceleration.y, fLead);
+
+    fDistance = Length(offset);
+
+    fLimit = fminf(_parameters.fMaxDistance,
+                   _parameters.fMaxGrowth * GetRecentDistance(fLead));
+    fLimit *= fConfidence;
+
+    if (fDistance > fLimit) {
+        offset.x *= fLimit / fDistance;
+        offset.y *= fLimit / fDistance;
+    }
+
+    return offset;
+}
+
+VOID PointerPredictor::Reset()
+{
+    _uNewest = 0;
+    _cSamples = 0;
+    _velocity = Geometry::MakePoint(0.0f, 0.0f);
+    _acceleration = Geometry::MakePoint(0.0f, 0.0f);
+    _fInterval = 0.0f;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+FLOAT PointerPredictor::GetSeconds(LONGLONG llTicks) CONST
+{
+    return (FLOAT) ((DOUBLE) llTicks / (DOUBLE) _pClock->GetFrequency());
+}
+
+// The newest sample at least fSpan seconds older than llTime, or the
+// oldest there is
+CONST PointerPredictor::SAMPLE* PointerPredictor::GetSampleBefore(
+    LONGLONG    llTime,
+    FLOAT       fSpan) CONST
+{
+    CONST SAMPLE*   pSample = &_history[_uNewest];
+    UINT            i;
+
+    for (i = 1; i < _cSamples; i++) {
+        if (GetSeconds(llTime - pSample->llTime) >= fSpan) {
+            break;
+        }
+
+        pSample = &_history[(_uNewest + HISTORY_SIZE - i) % HISTORY_SIZE];
+    }
+
+    return pSample;
+}
+
+// 1 while input keeps coming, down to 0 once it has been quiet for a
+// few of the usual intervals
+FLOAT PointerPredictor::GetConfidence() CONST
+{
+    FLOAT fQuiet, fStart, fEnd;
+
+    fQuiet = GetSeconds(_pClock->GetTicks() - _history[_uNewest].llTime);
+
+    fStart = fmaxf(MIN_QUIET, _fInterval * QUIET_START);
+    fEnd = fmaxf(fStart * (QUIET_END / QUIET_START), _fInterval * QUIET_END);
+
+    if (fQuiet <= fStart) {
+        return 1.0f;
+    }
+
+    return fmaxf(0.0f, 1.0f - (fQuiet - fStart) / (fEnd - fStart));
+}
+
+// Straight-line distance the pointer covered over the last fSpan
+// seconds, scaled up from what the history holds if it is shorter
+FLOAT PointerPredictor::GetRecentDistance(FLOAT fSpan) CONST
+{
+    CONST SAMPLE*   pNewest = &_history[_uNewest];
+    CONST SAMPLE*   pSample = pNewest;
+    CONST SAMPLE*   pLater = pNewest;
+    Geometry::Point start;
+    FLOAT           fAge = 0.0f;
+    FLOAT           fLaterAge = 0.0f;
+    FLOAT           t;
+    UINT            i;
+
+    for (i = 1; i < _cSamples; i++) {
+        pLater = pSample;
+        fLaterAge = fAge;
+
+        pSample = &_history[(_uNewest + HISTORY_SIZE - i) % HISTORY_SIZE];
+        fAge = GetSeconds(pNewest->llTime - pSample->llTime);
+
+        if (fAge >= fSpan) {
+            break;
+        }
+    }
+
+    if (fAge <= 0.0f) {
+        return 0.0f;
+    }
+
+    if (fAge >= fSpan) {
+        // Between pSample and pLater
+        t = (fSpan - fLaterAge) / (fAge - fLaterAge);
+
+        start.x = pLater->position.x +
+                  (pSample->position.x - pLater->position.x) * t;
+        start.y = pLater->position.y +
+                  (pSample->position.y - pLater->position.y) * t;
+
+        return Length(Geometry::MakePoint(
+            pNewest->position.x - start.x,
+            pNewest->position.y - start.y));
+    }
+
+    return Length(Geometry::MakePoint(
+        pNewest->position.x - pSample->position.x,
+        pNewest->position.y - pSample->position.y)) * (fSpan / fAge);
+}
@@ -0,0 +1,87 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __POINTERPREDICTOR_H
+#define __POINTERPREDICTOR_H
+
+#include "wintypes.h"
+#include "clock.h"
+#include "geometry.h"
+
+////////////////////////////////////////////////////////////////////////////
+// PointerPredictor
+//
+// Guesses where the pointer will be when the frame being drawn reaches
+// the screen. Velocity goes through a 1-euro filter: a low-pass whose
+// cutoff rises with the acceleration that filter also estimates, so a
+// slow hand is smoothed and a flick is followed without lag. The
+// extrapolation is then held back rather than allowed to overshoot: it
+// never looks further ahead than MaxLead, stops where a decelerating
+// pointer would stop, never covers more ground than the pointer did in
+// the same time just before, and drops to nothing once input stops.
+////////////////////////////////////////////////////////////////////////////
+
+typedef struct _PREDICTORPARAMETERS {
+    FLOAT   fMinCutoff;     // Hz, velocity smoothing at rest
+    FLOAT   fBeta;          // Hz of cutoff per pixel/s^2 of acceleration
+    FLOAT   fDCutoff;       // Hz, acceleration smoothing
+    FLOAT   fMinSpeed;      // Pixels per second below which nothing moves
+    FLOAT   fMaxLead;       // Seconds, furthest look ahead
+    FLOAT   fMaxDistance;   // Pixels, furthest the guess may move
+    FLOAT   fMaxGrowth;     // Of the distance just covered in as long
+} PREDICTORPARAMETERS;
+
+class PointerPredictor {
+public:
+    PointerPredictor(Clock* pClock);
+
+    VOID SetParameters(CONST PREDICTORPARAMETERS& parameters);
+    VOID GetParameters(PREDICTORPARAMETERS* pParameters) CONST;
+
+    // Where the pointer was at llTime (clock ticks); times must not go
+    // backwards
+    VOID AddSample(LONGLONG llTime, CONST Geometry::Point& position);
+
+    // Offset from the last sample to the guess for llTime; zero when
+    // there is nothing to go on
+    Geometry::Point Predict(LONGLONG llTime) CONST;
+
+    VOID Reset();
+
+private:
+    enum { HISTORY_SIZE = 16 };
+
+    typedef struct _SAMPLE {
+        LONGLONG        llTime;
+        Geometry::Point position;
+    } SAMPLE;
+
+    FLOAT GetSeconds(LONGLONG llTicks) CONST;
+    CONST SAMPLE* GetSampleBefore(LONGLONG llTime, FLOAT fSpan) CONST;
+    FLOAT GetConfidence() CONST;
+    FLOAT GetRecentDistance(FLOAT fSpan) CONST;
+
+    Clock*              _pClock;
+    PREDICTORPARAMETERS _parameters;
+    SAMPLE              _history[HISTORY_SIZE];
+    UINT                _uNewest;
+    UINT                _cSamples;
+    Geometry::Point     _velocity;      // Filtered, pixels per second
+    Geometry::Point     _acceleration;  // Filtered, pixels per second^2
+    FLOAT               _fInterval;     // Smoothed seconds between samples
+};
+
+#endif // __POINTERPREDICTOR_H
@@ -0,0 +1,48 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __PORTABLEMATH_H
+#define __PORTABLEMATH_H
+
+#include "wintypes.h"
+#include <math.h>
+
+////////////////////////////////////////////////////////////////////////////
+// Math that gives the same bits on every compiler and C runtime. Only
+// IEEE basic operations, floorf and ldexpf are used, which are exact
+// everywhere; libm's expf and powf are not. Anything that feeds pointer
+// state goes through these, so a replayed input trace ends up in the
+// same place on Windows and Linux.
+////////////////////////////////////////////////////////////////////////////
+
+// e^x, within a few ulps of expf
+static inline FLOAT PortableExpf(FLOAT x)
+{
+    FLOAT fK, r, p;
+
+    x = fmaxf(-87.0f, fminf(x, 88.0f));
+
+    // x = k ln2 + r, |r| <= ln2 / 2, ln2 split in two (Cody-Waite)
+    fK = floorf(x * 1.44269504f + 0.5f);
+    r = (x - fK * 0.693359375f) - fK * -2.12194440e-4f;
+
+    p = 1.0f + r * (1.0f + r * (1.0f / 2.0f + r * (1.0f / 6.0f +
+        r * (1.0f / 24.0f + r * (1.0f / 120.0f + r * (1.0f / 720.0f))))));
+
+    return ldexpf(p, (int) fK);
+}
+
+#endif // __PORTABLEMATH_H
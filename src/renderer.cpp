@@ -0,0 +1,222 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "renderer.h"
+
+#include <string.h>
+
+#include "trace.h"
+
+#define DAMAGE_SLOT_SPRITE  0
+#define DAMAGE_SLOT_MARKER  1
+
+// Taken on top of the last draw, for the wake-up to be late and the
+// draw to be slower than the one before
+#define LATCH_MARGIN        0.003f      // Seconds
+
+Renderer::Renderer(Clock* pClock, LatencyMonitor* pLatency)
+    : _pClock(pClock),
+      _pLatency(pLatency),
+      _pSink(NULL),
+      _pSprite(NULL),
+      _pFrameEvent(NULL),
+      _viewport(Geometry::MakeSize(0.0f, 0.0f)),
+      _ulInvalidation(0),
+      _llPresentedInput(0),
+      _llPeriod(0),
+      _llLastPresent(0),
+      _llLastDraw(0)
+{
+    ResetStats();
+}
+
+VOID Renderer::Initialize(RenderSink* pSink, Sprite* pSprite)
+{
+    _pSink = pSink;
+    _pSprite = pSprite;
+
+    // Whatever the first frame is, it is drawn in full
+    _viewport = Geometry::MakeSize(0.0f, 0.0f);
+}
+
+VOID Renderer::Publish(CONST FRAMESTATE& frame)
+{
+    _frames.Publish(frame);
+
+    if (_pFrameEvent != NULL) {
+        _pFrameEvent->Set();
+    }
+}
+
+VOID Renderer::SetFrameEvent(ThreadEvent* pEvent)
+{
+    _pFrameEvent = pEvent;
+}
+
+VOID Renderer::SetRefreshRate(FLOAT fRefreshRate)
+{
+    _llPeriod = (fRefreshRate > 0.0f)
+              ? (LONGLONG) (_pClock->GetFrequency() / fRefreshRate)
+              : 0;
+}
+
+DWORD Renderer::GetLatchTimeout() CONST
+{
+    LONGLONG llLatch, llNow;
+
+    if (_llPeriod == 0 || _llLastPresent == 0) {
+        return 0;
+    }
+
+    llLatch = _llLastPresent + _llPeriod - _llLastDraw -
+              (LONGLONG) (LATCH_MARGIN * _pClock->GetFrequency());
+
+    llNow = _pClock->GetTicks();
+
+    if (llLatch <= llNow) {
+        return 0;
+    }
+
+    // Rounded down, the last millisecond is spent polling
+    return (DWORD) ((llLatch - llNow) * 1000 / _pClock->GetFrequency());
+}
+
+BOOL Renderer::Acquire()
+{
+    return _frames.Acquire();
+}
+
+CONST FRAMESTATE& Renderer::GetFrame() CONST
+{
+    return _frames.GetFront();
+}
+
+HRESULT Renderer::Render(CONST FRAMESTATE& frame)
+{
+    CONST POINTERFRAME&     pointer = frame.pointer;
+    CONST Geometry::Rect*   pRects = NULL;
+    Geometry::Rect          marker;
+    LONGLONG                llDraw, llPresent;
+    UINT                    i, cRects;
+    HRESULT                 hResult;
+
+    FP_TRACE_SCOPE("Renderer::Render");
+
+    if (_pSink == NULL || _pSprite == NULL) {
+        return E_UNEXPECTED;
+    }
+
+    if (frame.viewport.width != _viewport.width ||
+        frame.viewport.height != _viewport.height)
+    {
+        _viewport = frame.viewport;
+        _damage.SetSurfaceSize(_viewport.width, _viewport.height);
+        _damage.InvalidateAll();
+    }
+
+    if (frame.ulInvalidation != _ulInvalidation) {
+        _ulInvalidation = frame.ulInvalidation;
+        _damage.InvalidateAll();
+    }
+
+    Pointer::PoseSprite(_pSprite, pointer);
+
+    if (pointer.bShowMarker == TRUE) {
+        marker = Geometry::MakeRect(
+            pointer.markerPosition.x - pointer.fMarkerRadius,
+            pointer.markerPosition.y - pointer.fMarkerRadius,
+            pointer.markerPosition.x + pointer.fMarkerRadius,
+            pointer.markerPosition.y + pointer.fMarkerRadius);
+    } else {
+        marker = Geometry::MakeRect(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    _damage.Track(DAMAGE_SLOT_SPRITE, _pSprite->GetBounds());
+    _damage.Track(DAMAGE_SLOT_MARKER, marker);
+
+    cRects = _damage.GetRectCount();
+    pRects = _damage.GetRects();
+
+    llDraw = _pLatency->Stamp();
+
+    _pSink->BeginDraw();
+
+    // Only the damaged rectangles are cleared and redrawn, the rest of
+    // the (retained) target is left alone
+    for (i = 0; i < cRects; i++) {
+        _pSink->PushClip(pRects[i]);
+        _pSink->Clear();
+
+        if (pointer.bShowMarker == TRUE) {
+            _pSink->FillEllipse(
+                pointer.markerPosition,
+                pointer.fMarkerRadius,
+                pointer.fMarkerRadius,
+                pointer.markerColor);
+        }
+
+        _pSprite->Draw(_pSink);
+        _pSink->PopClip();
+    }
+
+    _damage.Reset();
+
+    llPresent = _pLatency->Stamp();
+    _llLastDraw = llPresent - llDraw;
+
+    if (_llPeriod != 0 && _llLastDraw > _llPeriod) {
+        _llLastDraw = _llPeriod;
+    }
+
+    hResult = _pSink->EndDraw();
+
+    // EndDraw() waits for the refresh, so this is about when it was
+    _llLastPresent = _pLatency->Stamp();
+
+    _pLatency->Record(LATENCY_DRAW, llDraw, llPresent);
+    _pLatency->Record(LATENCY_PRESENT, llPresent, _llLastPresent);
+
+    // Whatever was lost has to be redrawn in full next time
+    if (FAILED(hResult)) {
+        _stats.ullFailed++;
+        _damage.InvalidateAll();
+        return hResult;
+    }
+
+    _stats.ullFrames++;
+
+    // Counted once, on the first frame that shows it
+    if (frame.llInputTime > _llPresentedInput) {
+        _pLatency->Record(
+            LATENCY_INPUT_TO_PRESENT,
+            frame.llInputTime,
+            _llLastPresent);
+
+        _llPresentedInput = frame.llInputTime;
+    }
+
+    return S_OK;
+}
+
+VOID Renderer::GetStats(RENDERSTATS* pStats) CONST
+{
+    *pStats = _stats;
+}
+
+VOID Renderer::ResetStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
@@ -0,0 +1,113 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __RENDERER_H
+#define __RENDERER_H
+
+#include "wintypes.h"
+#include "clock.h"
+#include "platform.h"
+#include "damage.h"
+#include "latencymonitor.h"
+#include "pointer.h"
+#include "thread.h"
+#include "triplebuffer.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Renderer
+//
+// The drawing half of the engine. The Engine describes each frame in a
+// FRAMESTATE and either hands it to Render() right away or publishes it,
+// and a render thread of the host's takes the newest one with Acquire()
+// whenever it is ready to draw. Publishing goes through a TripleBuffer,
+// so a slow EndDraw never holds up input and a burst of input never
+// holds up a frame: frames the render thread had no time for are skipped.
+//
+// The render thread draws as late as it can: GetLatchTimeout() says how
+// long to sleep after a present so the next frame is taken just in time
+// for the next refresh, with the newest input the Engine published.
+// With nothing new to take it waits on the frame event, which Publish()
+// sets.
+//
+// Once Initialize() returned, the sink and the sprite belong to the
+// thread that renders.
+////////////////////////////////////////////////////////////////////////////
+
+typedef struct _FRAMESTATE {
+    POINTERFRAME    pointer;
+    Geometry::Size  viewport;
+    ULONG           ulInvalidation;     // Changes when all is redrawn
+    LONGLONG        llInputTime;        // Newest input it shows, ticks
+} FRAMESTATE;
+
+typedef struct _RENDERSTATS {
+    ULONGLONG   ullFrames;              // Presented
+    ULONGLONG   ullFailed;              // EndDraw() failed
+} RENDERSTATS;
+
+class Renderer {
+public:
+    // Draw, present and input-to-present times go to pLatency, which
+    // has to stamp with pClock
+    Renderer(Clock* pClock, LatencyMonitor* pLatency);
+
+    // Neither is owned
+    VOID Initialize(RenderSink* pSink, Sprite* pSprite);
+
+    // Input thread; never waits
+    VOID Publish(CONST FRAMESTATE& frame);
+
+    // Input thread; set after every Publish(), NULL for none. Not owned.
+    VOID SetFrameEvent(ThreadEvent* pEvent);
+
+    // Display refresh rate; 0 (the default) takes frames as they come
+    VOID SetRefreshRate(FLOAT fRefreshRate);
+
+    // Render thread; milliseconds until the next frame should be taken,
+    // counting back from the refresh after the last present by the last
+    // draw and a margin
+    DWORD GetLatchTimeout() CONST;
+
+    // Render thread; TRUE when GetFrame() is a frame not drawn yet
+    BOOL Acquire();
+    CONST FRAMESTATE& GetFrame() CONST;
+
+    // Redraws what changed since the last frame and presents it
+    HRESULT Render(CONST FRAMESTATE& frame);
+
+    // Kept by the thread that renders; read them from there or once it
+    // stopped
+    VOID GetStats(RENDERSTATS* pStats) CONST;
+    VOID ResetStats();
+
+private:
+    Clock*                      _pClock;
+    LatencyMonitor*             _pLatency;
+    RenderSink*                 _pSink;
+    Sprite*                     _pSprite;
+    DamageTracker               _damage;
+    TripleBuffer<FRAMESTATE>    _frames;
+    ThreadEvent*                _pFrameEvent;
+    Geometry::Size              _viewport;
+    ULONG                       _ulInvalidation;
+    LONGLONG                    _llPresentedInput;
+    LONGLONG                    _llPeriod;          // Refresh, ticks
+    LONGLONG                    _llLastPresent;     // EndDraw() returned
+    LONGLONG                    _llLastDraw;        // BeginDraw() to then
+    RENDERSTATS                 _stats;
+};
+
+#endif // __RENDERER_H
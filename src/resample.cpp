@@ -0,0 +1,284 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "resample.h"
+#include "cpu.h"
+
+#define FRACTION_SCALE  (1.0f / 16777216.0f)
+
+////////////////////////////////////////////////////////////////////////////
+// Scalar kernels
+//
+// The SSE2 kernels in resample_sse2.cpp do exactly these operations,
+// lane for lane; keep the two in step.
+////////////////////////////////////////////////////////////////////////////
+
+// Top 24 bits of the fraction, exact in a float
+static inline FLOAT Fraction(ULONGLONG ullPosition)
+{
+    return (FLOAT) (INT) (((UINT) ullPosition) >> 8) * FRACTION_SCALE;
+}
+
+static inline FLOAT CatmullRom(
+    FLOAT   p0,
+    FLOAT   p1,
+    FLOAT   p2,
+    FLOAT   p3,
+    FLOAT   t)
+{
+    FLOAT a = ((p0 * -0.5f + p1 * 1.5f) + p2 * -1.5f) + p3 * 0.5f;
+    FLOAT b = ((p0 + p1 * -2.5f) + p2 * 2.0f) + p3 * -0.5f;
+    FLOAT c = p0 * -0.5f + p2 * 0.5f;
+
+    return ((a * t + b) * t + c) * t + p1;
+}
+
+static VOID ResampleMonoScalar(
+    FLOAT*          pfOutput,
+    CONST SHORT*    psSamples,
+    UINT            cFrames,
+    ULONGLONG       ullPosition,
+    ULONGLONG       ullStep,
+    FLOAT           fGain,
+    FLOAT           fGainStep)
+{
+    CONST SHORT*    ps;
+    FLOAT           fValue;
+    UINT            k;
+
+    for (k = 0; k < cFrames; k++) {
+        ps = psSamples + (SIZE_T) (ullPosition >> 32) - 1;
+
+        fValue = CatmullRom(ps[0], ps[1], ps[2], ps[3], Fraction(ullPosition));
+        fValue = fValue * (fGain + (FLOAT) (INT) k * fGainStep);
+
+        pfOutput[k * 2 + 0] += fValue;
+        pfOutput[k * 2 + 1] += fValue;
+
+        ullPosition += ullStep;
+    }
+}
+
+static VOID ResampleStereoScalar(
+    FLOAT*          pfOutput,
+    CONST SHORT*    psSamples,
+    UINT            cFrames,
+    ULONGLONG       ullPosition,
+    ULONGLONG       ullStep,
+    FLOAT           fGain,
+    FLOAT           fGainStep)
+{
+    CONST SHORT*    ps;
+    FLOAT           t, g;
+    UINT            k;
+
+    for (k = 0; k < cFrames; k++) {
+        ps = psSamples + ((SIZE_T) (ullPosition >> 32) - 1) * 2;
+        t = Fraction(ullPosition);
+        g = fGain + (FLOAT) (INT) k * fGainStep;
+
+        pfOutput[k * 2 + 0] += CatmullRom(ps[0], ps[2], ps[4], ps[6], t) * g;
+        pfOutput[k * 2 + 1] += CatmullRom(ps[1], ps[3], ps[5], ps[7], t) * g;
+
+        ullPosition += ullStep;
+    }
+}
+
+static CONST RESAMPLEKERNELS SCALAR_RESAMPLE_KERNELS = {
+    RESAMPLE_LEVEL_SCALAR,
+    "scalar",
+    ResampleMonoScalar,
+    ResampleStereoScalar
+};
+
+////////////////////////////////////////////////////////////////////////////
+// Clip edges
+////////////////////////////////////////////////////////////////////////////
+
+// Looping clips wrap around, one-shots hold the first sample before the
+// start and are silent past the end
+static FLOAT FetchSample(
+    CONST SHORT*    psSamples,
+    UINT            cChannels,
+    UINT            cClipFrames,
+    BOOL            bLoop,
+    LONGLONG        llIndex,
+    UINT            uChannel)
+{
+    if (bLoop == TRUE) {
+        llIndex %= (LONGLONG) cClipFrames;
+
+        if (llIndex < 0) {
+            llIndex += cClipFrames;
+        }
+    } else if (llIndex < 0) {
+        llIndex = 0;
+    } else if (llIndex >= (LONGLONG) cClipFrames) {
+        return 0.0f;
+    }
+
+    return psSamples[(SIZE_T) llIndex * cChannels + uChannel];
+}
+
+static VOID ResampleFrameBounded(
+    FLOAT*          pfOutput,
+    CONST SHORT*    psSamples,
+    UINT            cChannels,
+    UINT            cClipFrames,
+    BOOL            bLoop,
+    ULONGLONG       ullPosition,
+    FLOAT           fGain)
+{
+    LONGLONG    llIndex = (LONGLONG) (ullPosition >> 32);
+    FLOAT       t = Fraction(ullPosition);
+    FLOAT       p[4];
+    FLOAT       fValue;
+    UINT        uChannel, i;
+
+    for (uChannel = 0; uChannel < cChannels; uChannel++) {
+        for (i = 0; i < 4; i++) {
+            p[i] = FetchSample(
+                psSamples,
+                cChannels,
+                cClipFrames,
+                bLoop,
+                llIndex - 1 + i,
+                uChannel);
+        }
+
+        fValue = CatmullRom(p[0], p[1], p[2], p[3], t) * fGain;
+
+        if (cChannels == 1) {
+            pfOutput[0] += fValue;
+            pfOutput[1] += fValue;
+        } else {
+            pfOutput[uChannel] += fValue;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+CONST RESAMPLEKERNELS* GetResampleKernelsForLevel(RESAMPLELEVEL level)
+{
+    switch (level) {
+        case RESAMPLE_LEVEL_SCALAR:
+            return &SCALAR_RESAMPLE_KERNELS;
+#ifdef FP_ARCH_X86
+        case RESAMPLE_LEVEL_SSE2:
+            if (GetCpuFeatures() & CPU_FEATURE_SSE2) {
+                return &SSE2_RESAMPLE_KERNELS;
+            }
+            break;
+#endif // FP_ARCH_X86
+        default:
+            break;
+    }
+
+    return NULL;
+}
+
+CONST RESAMPLEKERNELS* GetResampleKernels()
+{
+    CONST RESAMPLEKERNELS* pKernels;
+
+    pKernels = GetResampleKernelsForLevel(RESAMPLE_LEVEL_SSE2);
+
+    if (pKernels == NULL) {
+        pKernels = GetResampleKernelsForLevel(RESAMPLE_LEVEL_SCALAR);
+    }
+
+    return pKernels;
+}
+
+UINT ResampleClip(
+    CONST RESAMPLEKERNELS*  pKernels,
+    FLOAT*                  pfOutput,
+    CONST SHORT*            psSamples,
+    UINT                    cChannels,
+    UINT                    cClipFrames,
+    BOOL                    bLoop,
+    ULONGLONG*              pullPosition,
+    ULONGLONG               ullStep,
+    UINT                    cFrames,
+    FLOAT                   fGain,
+    FLOAT                   fGainStep)
+{
+    RESAMPLEPROC    pfnResample;
+    ULONGLONG       ullPosition = *pullPosition;
+    ULONGLONG       ullEnd, ullLimit, ullRun;
+    ULONGLONG       ullIndex;
+    UINT            uFrame = 0;
+
+    if (cClipFrames == 0 || ullStep == 0) {
+        return 0;
+    }
+
+    pfnResample = (cChannels == 2) ? pKernels->pfnStereo : pKernels->pfnMono;
+
+    ullEnd = (ULONGLONG) cClipFrames << 32;
+
+    // Interior frames keep all four taps inside: 1 <= index <= end - 3
+    ullLimit = (cClipFrames > 3) ? ((ULONGLONG) (cClipFrames - 2) << 32) : 0;
+
+    while (uFrame < cFrames) {
+        if (ullPosition >= ullEnd) {
+            if (bLoop == FALSE) {
+                break;
+            }
+
+            ullPosition %= ullEnd;
+            continue;
+        }
+
+        ullIndex = ullPosition >> 32;
+
+        if (ullIndex >= 1 && ullPosition < ullLimit) {
+            ullRun = (ullLimit - ullPosition + ullStep - 1) / ullStep;
+
+            if (ullRun > cFrames - uFrame) {
+                ullRun = cFrames - uFrame;
+            }
+
+            pfnResample(
+                pfOutput + (SIZE_T) uFrame * 2,
+                psSamples,
+                (UINT) ullRun,
+                ullPosition,
+                ullStep,
+                fGain + (FLOAT) (INT) uFrame * fGainStep,
+                fGainStep);
+
+            ullPosition += ullRun * ullStep;
+            uFrame += (UINT) ullRun;
+        } else {
+            ResampleFrameBounded(
+                pfOutput + (SIZE_T) uFrame * 2,
+                psSamples,
+                cChannels,
+                cClipFrames,
+                bLoop,
+                ullPosition,
+                fGain + (FLOAT) (INT) uFrame * fGainStep);
+
+            ullPosition += ullStep;
+            uFrame++;
+        }
+    }
+
+    *pullPosition = ullPosition;
+    return uFrame;
+}
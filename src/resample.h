@@ -0,0 +1,90 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __RESAMPLE_H
+#define __RESAMPLE_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Resampler
+//
+// Plays 16-bit PCM at a variable rate with 4-point Catmull-Rom
+// interpolation and adds the result into a stereo float buffer. There is
+// a scalar and an SSE2 kernel; both run the same float operations in the
+// same order, so they produce identical samples. Kernels only see runs
+// where all four taps are inside the clip; ResampleClip() handles loop
+// wrap and clip ends itself, like BlitRow() does for bitmap edges.
+//
+// Positions are 32.32 fixed point frames. Gain for output frame k of a
+// call is fGain + k * fGainStep.
+////////////////////////////////////////////////////////////////////////////
+
+#define RESAMPLE_ONE        0x100000000ULL
+#define RESAMPLE_MIN_RATE   0.25f
+#define RESAMPLE_MAX_RATE   4.0f
+
+typedef enum _RESAMPLELEVEL {
+    RESAMPLE_LEVEL_SCALAR,
+    RESAMPLE_LEVEL_SSE2
+} RESAMPLELEVEL;
+
+// Taps psSamples[i - 1 .. i + 2] of every output frame must be valid
+typedef VOID (*RESAMPLEPROC)(
+    FLOAT*          pfOutput,
+    CONST SHORT*    psSamples,
+    UINT            cFrames,
+    ULONGLONG       ullPosition,
+    ULONGLONG       ullStep,
+    FLOAT           fGain,
+    FLOAT           fGainStep);
+
+typedef struct _RESAMPLEKERNELS {
+    RESAMPLELEVEL   level;
+    LPCSTR          pszName;
+    RESAMPLEPROC    pfnMono;
+    RESAMPLEPROC    pfnStereo;
+} RESAMPLEKERNELS;
+
+// Best kernels for this CPU
+CONST RESAMPLEKERNELS* GetResampleKernels();
+
+// NULL when the level is not built in or not supported by the CPU
+CONST RESAMPLEKERNELS* GetResampleKernelsForLevel(RESAMPLELEVEL level);
+
+// Renders up to cFrames from a clip of cClipFrames frames and cChannels
+// (1 or 2) channels starting at *pullPosition, which is advanced. Returns
+// how many frames were rendered; fewer than cFrames means the clip ended
+// (never when bLoop is set).
+UINT ResampleClip(
+    CONST RESAMPLEKERNELS*  pKernels,
+    FLOAT*                  pfOutput,
+    CONST SHORT*            psSamples,
+    UINT                    cChannels,
+    UINT                    cClipFrames,
+    BOOL                    bLoop,
+    ULONGLONG*              pullPosition,
+    ULONGLONG               ullStep,
+    UINT                    cFrames,
+    FLOAT                   fGain,
+    FLOAT                   fGainStep);
+
+////////////////////////////////////////////////////////////////////////////
+// Per level tables, defined in resample_sse2.cpp
+
+extern CONST RESAMPLEKERNELS SSE2_RESAMPLE_KERNELS;
+
+#endif // __RESAMPLE_H
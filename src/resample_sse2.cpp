@@ -0,0 +1,223 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "resample.h"
+#include "cpu.h"
+
+#ifdef FP_ARCH_X86
+
+#include <emmintrin.h>
+
+#define FRACTION_SCALE  (1.0f / 16777216.0f)
+
+////////////////////////////////////////////////////////////////////////////
+// SSE2 kernels
+//
+// The taps of each output frame are one unaligned load; a couple of
+// unpacks turn the loads of neighbouring frames into one register per
+// tap. The float math is the scalar kernels' from resample.cpp, lane for
+// lane.
+////////////////////////////////////////////////////////////////////////////
+
+// Sign-extends the low or high four 16-bit lanes to floats
+static inline __m128 LowToFloat(__m128i v)
+{
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+}
+
+static inline __m128 HighToFloat(__m128i v)
+{
+    return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16));
+}
+
+static inline __m128 CatmullRom(
+    __m128  p0,
+    __m128  p1,
+    __m128  p2,
+    __m128  p3,
+    __m128  t)
+{
+    __m128 a, b, c, y;
+
+    a = _mm_add_ps(
+        _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(p0, _mm_set1_ps(-0.5f)),
+                       _mm_mul_ps(p1, _mm_set1_ps(1.5f))),
+            _mm_mul_ps(p2, _mm_set1_ps(-1.5f))),
+        _mm_mul_ps(p3, _mm_set1_ps(0.5f)));
+
+    b = _mm_add_ps(
+        _mm_add_ps(
+            _mm_add_ps(p0, _mm_mul_ps(p1, _mm_set1_ps(-2.5f))),
+            _mm_mul_ps(p2, _mm_set1_ps(2.0f))),
+        _mm_mul_ps(p3, _mm_set1_ps(-0.5f)));
+
+    c = _mm_add_ps(_mm_mul_ps(p0, _mm_set1_ps(-0.5f)),
+                   _mm_mul_ps(p2, _mm_set1_ps(0.5f)));
+
+    y = _mm_add_ps(_mm_mul_ps(a, t), b);
+    y = _mm_add_ps(_mm_mul_ps(y, t), c);
+
+    return _mm_add_ps(_mm_mul_ps(y, t), p1);
+}
+
+static inline INT FractionBits(ULONGLONG ullPosition)
+{
+    return (INT) (((UINT) ullPosition) >> 8);
+}
+
+// fGain + k * fGainStep for the four lanes
+static inline __m128 Gain(__m128 k, FLOAT fGain, FLOAT fGainStep)
+{
+    return _mm_add_ps(_mm_set1_ps(fGain),
+                      _mm_mul_ps(k, _mm_set1_ps(fGainStep)));
+}
+
+static VOID ResampleMonoSse2(
+    FLOAT*          pfOutput,
+    CONST SHORT*    psSamples,
+    UINT            cFrames,
+    ULONGLONG       ullPosition,
+    ULONGLONG       ullStep,
+    FLOAT           fGain,
+    FLOAT           fGainStep)
+{
+    __m128i     a, b, c, d, ab, cd, lo, hi;
+    __m128      t, g, y, out;
+    ULONGLONG   pos[4];
+    UINT        k, i, cLanes;
+
+    for (k = 0; k < cFrames; k += cLanes) {
+        cLanes = (cFrames - k < 4) ? (cFrames - k) : 4;
+
+        // A short tail repeats its last frame in the unused lanes
+        for (i = 0; i < 4; i++) {
+            pos[i] = ullPosition + ((i < cLanes) ? i : cLanes - 1) * ullStep;
+        }
+
+        a = _mm_loadl_epi64((CONST __m128i*) (psSamples + (pos[0] >> 32) - 1));
+        b = _mm_loadl_epi64((CONST __m128i*) (psSamples + (pos[1] >> 32) - 1));
+        c = _mm_loadl_epi64((CONST __m128i*) (psSamples + (pos[2] >> 32) - 1));
+        d = _mm_loadl_epi64((CONST __m128i*) (psSamples + (pos[3] >> 32) - 1));
+
+        ab = _mm_unpacklo_epi16(a, b);
+        cd = _mm_unpacklo_epi16(c, d);
+        lo = _mm_unpacklo_epi32(ab, cd);
+        hi = _mm_unpackhi_epi32(ab, cd);
+
+        t = _mm_mul_ps(
+            _mm_cvtepi32_ps(_mm_set_epi32(
+                FractionBits(pos[3]), FractionBits(pos[2]),
+                FractionBits(pos[1]), FractionBits(pos[0]))),
+            _mm_set1_ps(FRACTION_SCALE));
+
+        g = Gain(_mm_cvtepi32_ps(_mm_set_epi32(k + 3, k + 2, k + 1, k)),
+                 fGain, fGainStep);
+
+        y = _mm_mul_ps(
+            CatmullRom(LowToFloat(lo), HighToFloat(lo),
+                       LowToFloat(hi), HighToFloat(hi), t),
+            g);
+
+        if (cLanes == 4) {
+            out = _mm_loadu_ps(pfOutput + k * 2);
+            _mm_storeu_ps(pfOutput + k * 2,
+                          _mm_add_ps(out, _mm_unpacklo_ps(y, y)));
+
+            out = _mm_loadu_ps(pfOutput + k * 2 + 4);
+            _mm_storeu_ps(pfOutput + k * 2 + 4,
+                          _mm_add_ps(out, _mm_unpackhi_ps(y, y)));
+        } else {
+            FLOAT values[4];
+
+            _mm_storeu_ps(values, y);
+
+            for (i = 0; i < cLanes; i++) {
+                pfOutput[(k + i) * 2 + 0] += values[i];
+                pfOutput[(k + i) * 2 + 1] += values[i];
+            }
+        }
+
+        ullPosition += cLanes * ullStep;
+    }
+}
+
+static VOID ResampleStereoSse2(
+    FLOAT*          pfOutput,
+    CONST SHORT*    psSamples,
+    UINT            cFrames,
+    ULONGLONG       ullPosition,
+    ULONGLONG       ullStep,
+    FLOAT           fGain,
+    FLOAT           fGainStep)
+{
+    __m128i     a, b, lo, hi;
+    __m128      t, g, y, out;
+    ULONGLONG   pos0, pos1;
+    UINT        k, k1;
+
+    // Two frames per register: L0 R0 L1 R1
+    for (k = 0; k < cFrames; k += 2) {
+        k1 = (k + 1 < cFrames) ? k + 1 : k;
+
+        pos0 = ullPosition;
+        pos1 = ullPosition + (k1 - k) * ullStep;
+
+        a = _mm_loadu_si128(
+            (CONST __m128i*) (psSamples + ((pos0 >> 32) - 1) * 2));
+        b = _mm_loadu_si128(
+            (CONST __m128i*) (psSamples + ((pos1 >> 32) - 1) * 2));
+
+        lo = _mm_unpacklo_epi32(a, b);
+        hi = _mm_unpackhi_epi32(a, b);
+
+        t = _mm_mul_ps(
+            _mm_cvtepi32_ps(_mm_set_epi32(
+                FractionBits(pos1), FractionBits(pos1),
+                FractionBits(pos0), FractionBits(pos0))),
+            _mm_set1_ps(FRACTION_SCALE));
+
+        g = Gain(_mm_cvtepi32_ps(_mm_set_epi32(k1, k1, k, k)),
+                 fGain, fGainStep);
+
+        y = _mm_mul_ps(
+            CatmullRom(LowToFloat(lo), HighToFloat(lo),
+                       LowToFloat(hi), HighToFloat(hi), t),
+            g);
+
+        if (k1 != k) {
+            out = _mm_loadu_ps(pfOutput + k * 2);
+            _mm_storeu_ps(pfOutput + k * 2, _mm_add_ps(out, y));
+        } else {
+            out = _mm_castsi128_ps(
+                _mm_loadl_epi64((CONST __m128i*) (pfOutput + k * 2)));
+            _mm_storel_epi64(
+                (__m128i*) (pfOutput + k * 2),
+                _mm_castps_si128(_mm_add_ps(out, y)));
+        }
+
+        ullPosition += 2 * ullStep;
+    }
+}
+
+CONST RESAMPLEKERNELS SSE2_RESAMPLE_KERNELS = {
+    RESAMPLE_LEVEL_SSE2,
+    "sse2",
+    ResampleMonoSse2,
+    ResampleStereoSse2
+};
+
+#endif // FP_ARCH_X86
@@ -36,6 +36,8 @@
 #define IDM_ITEM_TIKTOK         502
 #define IDM_ITEM_TELEGRAM       503
 #define IDM_ITEM_EXIT           504
+#define IDM_ITEM_LATENCY        505
+#define IDM_ITEM_TIMELINE       506
 
 ////////////////////////////////////////////////////////////////////////////
 
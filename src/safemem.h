@@ -17,7 +17,7 @@
 #ifndef __SAFEMEM_H
 #define __SAFEMEM_H
 
-#include <Windows.h>
+#include "wintypes.h"
 
 template<class Interface>
 inline VOID SafeRelease(Interface** ppInterfaceToRelease)
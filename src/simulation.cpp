@@ -0,0 +1,90 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "simulation.h"
+
+Simulation::Simulation(Clock* pClock, UINT uStepRate)
+    : _pClock(pClock),
+      _uStepRate(1),
+      _ullSteps(0),
+      _ullDroppedSteps(0)
+{
+    SetStepRate(uStepRate);
+    Reset();
+}
+
+VOID Simulation::SetStepRate(UINT uStepRate)
+{
+    _uStepRate = (uStepRate > 0) ? uStepRate : 1;
+    _llAccumulator = 0;
+}
+
+UINT Simulation::GetStepRate() CONST
+{
+    return _uStepRate;
+}
+
+FLOAT Simulation::GetStepTime() CONST
+{
+    return 1.0f / (FLOAT) _uStepRate;
+}
+
+UINT Simulation::Advance()
+{
+    LONGLONG    llTicks = _pClock->GetTicks();
+    LONGLONG    llFrequency = _pClock->GetFrequency();
+    LONGLONG    llSteps;
+
+    if (llTicks > _llLastTicks) {
+        _llAccumulator += (llTicks - _llLastTicks) * (LONGLONG) _uStepRate;
+    }
+
+    _llLastTicks = llTicks;
+
+    // One step is llFrequency in the accumulator
+    llSteps = _llAccumulator / llFrequency;
+    _llAccumulator -= llSteps * llFrequency;
+
+    if (llSteps > SIMULATION_MAX_STEPS) {
+        _ullDroppedSteps += (ULONGLONG) (llSteps - SIMULATION_MAX_STEPS);
+        llSteps = SIMULATION_MAX_STEPS;
+    }
+
+    _ullSteps += (ULONGLONG) llSteps;
+    return (UINT) llSteps;
+}
+
+FLOAT Simulation::GetAlpha() CONST
+{
+    return (FLOAT) ((DOUBLE) _llAccumulator /
+                    (DOUBLE) _pClock->GetFrequency());
+}
+
+ULONGLONG Simulation::GetStepCount() CONST
+{
+    return _ullSteps;
+}
+
+ULONGLONG Simulation::GetDroppedStepCount() CONST
+{
+    return _ullDroppedSteps;
+}
+
+VOID Simulation::Reset()
+{
+    _llLastTicks = _pClock->GetTicks();
+    _llAccumulator = 0;
+}
@@ -0,0 +1,74 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SIMULATION_H
+#define __SIMULATION_H
+
+#include "wintypes.h"
+#include "clock.h"
+
+#define SIMULATION_RATE_DEFAULT 240
+
+// Steps one Advance() may ask for; anything older is dropped, so a long
+// stall does not turn into a long catch-up
+#define SIMULATION_MAX_STEPS    32
+
+////////////////////////////////////////////////////////////////////////////
+// Simulation
+//
+// Turns clock time into a whole number of fixed steps. Elapsed ticks go
+// into an int64 accumulator scaled by the step rate, so no step is ever
+// rounded and nothing drifts however long the session runs. Whatever is
+// left over is GetAlpha(), how far the clock is into the next step:
+// draw the previous state blended with the current one by that much and
+// what is on screen depends only on the time, not on when frames come.
+//
+// The clock is the one Engine is given; a ManualClock runs it as fast as
+// the caller likes.
+////////////////////////////////////////////////////////////////////////////
+
+class Simulation {
+public:
+    Simulation(Clock* pClock, UINT uStepRate = SIMULATION_RATE_DEFAULT);
+
+    VOID SetStepRate(UINT uStepRate);
+    UINT GetStepRate() CONST;
+
+    // Seconds per step
+    FLOAT GetStepTime() CONST;
+
+    // Steps due since the last call
+    UINT Advance();
+
+    // 0 just after a step, approaching 1 just before the next one
+    FLOAT GetAlpha() CONST;
+
+    ULONGLONG GetStepCount() CONST;
+    ULONGLONG GetDroppedStepCount() CONST;
+
+    // Starts counting from now, with nothing due
+    VOID Reset();
+
+private:
+    Clock*      _pClock;
+    UINT        _uStepRate;
+    LONGLONG    _llLastTicks;
+    LONGLONG    _llAccumulator;     // Ticks times the step rate
+    ULONGLONG   _ullSteps;
+    ULONGLONG   _ullDroppedSteps;
+};
+
+#endif // __SIMULATION_H
@@ -0,0 +1,508 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "softwarerendersink.h"
+#include "blit.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define FIXED_SHIFT         16
+#define FIXED_ONE           (1 << FIXED_SHIFT)
+
+// Ellipses are sampled on a 4x4 grid; positions are kept in 1/8 pixel
+// units so every sample sits on an odd coordinate
+#define ELLIPSE_SUBPIXELS   8
+#define ELLIPSE_SAMPLES     4
+
+// Keeps the 64-bit inside test in range
+#define ELLIPSE_MAX_RADIUS  4096.0f
+
+// x / 255, rounded, exact for 0 <= x <= 255 * 255
+static inline UINT Div255(UINT x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+static inline LONGLONG ToFixed(DOUBLE value)
+{
+    return (LONGLONG) floor(value * FIXED_ONE + 0.5);
+}
+
+static inline UINT ToByte(FLOAT value)
+{
+    if (value <= 0.0f) {
+        return 0;
+    }
+
+    if (value >= 1.0f) {
+        return 255;
+    }
+
+    return (UINT) (value * 255.0f + 0.5f);
+}
+
+// Source-over with a premultiplied source
+static inline VOID BlendPixel(BYTE* pbDst, CONST UINT* puSrc)
+{
+    UINT uInvAlpha = 255 - puSrc[3];
+
+    pbDst[0] = (BYTE) (puSrc[0] + Div255(pbDst[0] * uInvAlpha));
+    pbDst[1] = (BYTE) (puSrc[1] + Div255(pbDst[1] * uInvAlpha));
+    pbDst[2] = (BYTE) (puSrc[2] + Div255(pbDst[2] * uInvAlpha));
+    pbDst[3] = (BYTE) (puSrc[3] + Div255(pbDst[3] * uInvAlpha));
+}
+
+////////////////////////////////////////////////////////////////////////////
+// SoftwareRenderBitmap
+////////////////////////////////////////////////////////////////////////////
+
+SoftwareRenderBitmap::SoftwareRenderBitmap()
+    : _uWidth(0),
+      _uHeight(0),
+      _pbPixels(NULL)
+{
+}
+
+SoftwareRenderBitmap::~SoftwareRenderBitmap()
+{
+    free(_pbPixels);
+}
+
+UINT SoftwareRenderBitmap::GetWidth() CONST
+{
+    return _uWidth;
+}
+
+UINT SoftwareRenderBitmap::GetHeight() CONST
+{
+    return _uHeight;
+}
+
+UINT SoftwareRenderBitmap::GetStride() CONST
+{
+    return _uWidth * 4;
+}
+
+CONST BYTE* SoftwareRenderBitmap::GetPixels() CONST
+{
+    return _pbPixels;
+}
+
+HRESULT SoftwareRenderBitmap::CreateSoftwareRenderBitmap(
+    UINT                    uWidth,
+    UINT                    uHeight,
+    UINT                    uStride,
+    CONST BYTE*             pbPixels,
+    SoftwareRenderBitmap**  ppBitmap)
+{
+    SoftwareRenderBitmap*   pBitmap = NULL;
+    UINT                    y;
+
+    if (ppBitmap == NULL || pbPixels == NULL || uStride < uWidth * 4) {
+        return E_INVALIDARG;
+    }
+
+    if (uWidth > SOFTWARE_MAX_SURFACE_SIZE ||
+        uHeight > SOFTWARE_MAX_SURFACE_SIZE)
+    {
+        return E_INVALIDARG;
+    }
+
+    pBitmap = new SoftwareRenderBitmap();
+
+    if (pBitmap == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    pBitmap->_uWidth   = uWidth;
+    pBitmap->_uHeight  = uHeight;
+    pBitmap->_pbPixels = (BYTE*) malloc((SIZE_T) uWidth * uHeight * 4);
+
+    if (pBitmap->_pbPixels == NULL) {
+        delete pBitmap;
+        return E_OUTOFMEMORY;
+    }
+
+    for (y = 0; y < uHeight; y++) {
+        memcpy(pBitmap->_pbPixels + (SIZE_T) y * uWidth * 4,
+               pbPixels + (SIZE_T) y * uStride,
+               uWidth * 4);
+    }
+
+    *ppBitmap = pBitmap;
+
+    return S_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// SoftwareRenderSink
+////////////////////////////////////////////////////////////////////////////
+
+SoftwareRenderSink::SoftwareRenderSink()
+    : _uWidth(0),
+      _uHeight(0),
+      _pbPixels(NULL),
+      _cClips(0),
+      _cOverflow(0),
+      _pBlitKernels(GetBlitKernels())
+{
+}
+
+SoftwareRenderSink::~SoftwareRenderSink()
+{
+    free(_pbPixels);
+}
+
+HRESULT SoftwareRenderSink::CreateBitmap(
+    UINT            uWidth,
+    UINT            uHeight,
+    UINT            uStride,
+    CONST BYTE*     pbPixels,
+    RenderBitmap**  ppBitmap)
+{
+    SoftwareRenderBitmap*   pBitmap = NULL;
+    HRESULT                 hResult;
+
+    if (ppBitmap == NULL) {
+        return E_INVALIDARG;
+    }
+
+    hResult = SoftwareRenderBitmap::CreateSoftwareRenderBitmap(
+        uWidth,
+        uHeight,
+        uStride,
+        pbPixels,
+        &pBitmap);
+
+    if (SUCCEEDED(hResult)) {
+        *ppBitmap = pBitmap;
+    }
+
+    return hResult;
+}
+
+Geometry::Size SoftwareRenderSink::GetSize() CONST
+{
+    return Geometry::MakeSize((FLOAT) _uWidth, (FLOAT) _uHeight);
+}
+
+VOID SoftwareRenderSink::BeginDraw()
+{
+    _cClips    = 0;
+    _cOverflow = 0;
+}
+
+HRESULT SoftwareRenderSink::EndDraw()
+{
+    // Direct2D fails unbalanced clips the same way
+    return (_cClips == 0 && _cOverflow == 0) ? S_OK : E_FAIL;
+}
+
+VOID SoftwareRenderSink::PushClip(CONST Geometry::Rect& rect)
+{
+    PIXELRECT clip, current;
+
+    if (_cClips == SOFTWARE_MAX_CLIP_DEPTH) {
+        _cOverflow++;
+        return;
+    }
+
+    if (_cClips > 0) {
+        current = _clips[_cClips - 1];
+    } else {
+        current.left   = 0;
+        current.top    = 0;
+        current.right  = (LONG) _uWidth;
+        current.bottom = (LONG) _uHeight;
+    }
+
+    // Aliased clipping: a pixel is inside when its center is
+    clip.left   = (LONG) ceilf(fmaxf(rect.left,   (FLOAT) current.left)   - 0.5f);
+    clip.top    = (LONG) ceilf(fmaxf(rect.top,    (FLOAT) current.top)    - 0.5f);
+    clip.right  = (LONG) ceilf(fminf(rect.right,  (FLOAT) current.right)  - 0.5f);
+    clip.bottom = (LONG) ceilf(fminf(rect.bottom, (FLOAT) current.bottom) - 0.5f);
+
+    if (clip.left < current.left) clip.left = current.left;
+    if (clip.top  < current.top)  clip.top  = current.top;
+
+    _clips[_cClips++] = clip;
+}
+
+VOID SoftwareRenderSink::PopClip()
+{
+    if (_cOverflow > 0) {
+        _cOverflow--;
+    } else if (_cClips > 0) {
+        _cClips--;
+    }
+}
+
+VOID SoftwareRenderSink::Clear()
+{
+    PIXELRECT   rect;
+    LONG        y;
+
+    if (GetDrawRect(Geometry::MakeRect(
+            0.0f, 0.0f, (FLOAT) _uWidth, (FLOAT) _uHeight), &rect) == FALSE)
+    {
+        return;
+    }
+
+    for (y = rect.top; y < rect.bottom; y++) {
+        memset(_pbPixels + (SIZE_T) y * GetStride() + rect.left * 4,
+               0,
+               (rect.right - rect.left) * 4);
+    }
+}
+
+VOID SoftwareRenderSink::DrawBitmap(
+    RenderBitmap*           pBitmap,
+    CONST Geometry::Matrix& transform,
+    FLOAT                   fOpacity)
+{
+    SoftwareRenderBitmap*   pSource = (SoftwareRenderBitmap*) pBitmap;
+    Geometry::Matrix        inverse;
+    Geometry::Rect          bounds;
+    PIXELRECT               rect;
+    BLITSOURCE              source;
+    BLITCLASS               blitClass;
+    LONGLONG                u0, v0, dux, dvx, duy, dvy;
+    UINT                    uAlpha;
+    LONG                    y;
+
+    if (pSource == NULL) {
+        return;
+    }
+
+    uAlpha = (UINT) (ToByte(fOpacity) * 256 + 127) / 255;
+
+    if (uAlpha == 0 || Geometry::Invert(transform, &inverse) == FALSE) {
+        return;
+    }
+
+    // Bilinear filtering bleeds half a texel past the edges
+    bounds = Geometry::TransformBounds(transform, Geometry::MakeRect(
+        -0.5f,
+        -0.5f,
+        (FLOAT) pSource->GetWidth()  + 0.5f,
+        (FLOAT) pSource->GetHeight() + 0.5f));
+
+    if (GetDrawRect(bounds, &rect) == FALSE) {
+        return;
+    }
+
+    // Source position of the center of pixel (0, 0), moved back by half
+    // a texel so that integer coordinates land between texels
+    u0  = ToFixed(0.5 * inverse._11 + 0.5 * inverse._21 + inverse._31 - 0.5);
+    v0  = ToFixed(0.5 * inverse._12 + 0.5 * inverse._22 + inverse._32 - 0.5);
+    dux = ToFixed(inverse._11);
+    dvx = ToFixed(inverse._12);
+    duy = ToFixed(inverse._21);
+    dvy = ToFixed(inverse._22);
+
+    source.pbPixels = pSource->GetPixels();
+    source.uWidth   = pSource->GetWidth();
+    source.uHeight  = pSource->GetHeight();
+    source.uStride  = pSource->GetStride();
+
+    blitClass = ClassifyBlit(u0, v0, dux, dvx, duy, dvy);
+
+    for (y = rect.top; y < rect.bottom; y++) {
+        BlitRow(
+            _pBlitKernels,
+            blitClass,
+            _pbPixels + (SIZE_T) y * GetStride() + rect.left * 4,
+            &source,
+            (UINT) (rect.right - rect.left),
+            u0 + dux * rect.left + duy * y,
+            v0 + dvx * rect.left + dvy * y,
+            dux,
+            dvx,
+            uAlpha);
+    }
+}
+
+VOID SoftwareRenderSink::FillEllipse(
+    CONST Geometry::Point&  center,
+    FLOAT                   fRadiusX,
+    FLOAT                   fRadiusY,
+    CONST RENDERCOLOR&      color)
+{
+    PIXELRECT   rect;
+    UINT        premultiplied[4], pixel[4];
+    UINT        uAlpha, cCovered, c;
+    LONGLONG    cx, cy, rx2, ry2, limit, dx, dy, dy2;
+    LONG        x, y, sx, sy;
+
+    if (fRadiusX <= 0.0f || fRadiusY <= 0.0f) {
+        return;
+    }
+
+    fRadiusX = fminf(fRadiusX, ELLIPSE_MAX_RADIUS);
+    fRadiusY = fminf(fRadiusY, ELLIPSE_MAX_RADIUS);
+
+    if (GetDrawRect(Geometry::MakeRect(
+            center.x - fRadiusX,
+            center.y - fRadiusY,
+            center.x + fRadiusX,
+            center.y + fRadiusY), &rect) == FALSE)
+    {
+        return;
+    }
+
+    uAlpha = ToByte(color.a);
+
+    premultiplied[0] = Div255(ToByte(color.b) * uAlpha);
+    premultiplied[1] = Div255(ToByte(color.g) * uAlpha);
+    premultiplied[2] = Div255(ToByte(color.r) * uAlpha);
+    premultiplied[3] = uAlpha;
+
+    // Everything below is in 1/8 pixel units:
+    // (dx / rx)^2 + (dy / ry)^2 <= 1  <=>  dx^2 ry^2 + dy^2 rx^2 <= rx^2 ry^2
+    cx  = (LONGLONG) floorf(center.x * ELLIPSE_SUBPIXELS + 0.5f);
+    cy  = (LONGLONG) floorf(center.y * ELLIPSE_SUBPIXELS + 0.5f);
+    rx2 = (LONGLONG) floorf(fRadiusX * ELLIPSE_SUBPIXELS + 0.5f);
+    ry2 = (LONGLONG) floorf(fRadiusY * ELLIPSE_SUBPIXELS + 0.5f);
+
+    rx2 *= rx2;
+    ry2 *= ry2;
+    limit = rx2 * ry2;
+
+    for (y = rect.top; y < rect.bottom; y++) {
+        BYTE* pbDst = _pbPixels + (SIZE_T) y * GetStride() + rect.left * 4;
+
+        for (x = rect.left; x < rect.right; x++, pbDst += 4) {
+            cCovered = 0;
+
+            for (sy = 0; sy < ELLIPSE_SAMPLES; sy++) {
+                dy  = (LONGLONG) y * ELLIPSE_SUBPIXELS + sy * 2 + 1 - cy;
+                dy2 = dy * dy * rx2;
+
+                for (sx = 0; sx < ELLIPSE_SAMPLES; sx++) {
+                    dx = (LONGLONG) x * ELLIPSE_SUBPIXELS + sx * 2 + 1 - cx;
+
+                    if (dx * dx * ry2 + dy2 <= limit) {
+                        cCovered++;
+                    }
+                }
+            }
+
+            if (cCovered == 0) {
+                continue;
+            }
+
+            for (c = 0; c < 4; c++) {
+                pixel[c] = (premultiplied[c] * cCovered + 8) >> 4;
+            }
+
+            BlendPixel(pbDst, pixel);
+        }
+    }
+}
+
+UINT SoftwareRenderSink::GetWidth() CONST
+{
+    return _uWidth;
+}
+
+UINT SoftwareRenderSink::GetHeight() CONST
+{
+    return _uHeight;
+}
+
+UINT SoftwareRenderSink::GetStride() CONST
+{
+    return _uWidth * 4;
+}
+
+CONST BYTE* SoftwareRenderSink::GetPixels() CONST
+{
+    return _pbPixels;
+}
+
+VOID SoftwareRenderSink::SetBlitKernels(CONST BLITKERNELS* pKernels)
+{
+    _pBlitKernels = (pKernels != NULL) ? pKernels : GetBlitKernels();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+BOOL SoftwareRenderSink::GetDrawRect(
+    CONST Geometry::Rect&   bounds,
+    PIXELRECT*              pRect) CONST
+{
+    PIXELRECT clip;
+
+    if (_cClips > 0) {
+        clip = _clips[_cClips - 1];
+    } else {
+        clip.left   = 0;
+        clip.top    = 0;
+        clip.right  = (LONG) _uWidth;
+        clip.bottom = (LONG) _uHeight;
+    }
+
+    // Clamp in float first, the bounds of a wild transform may not fit
+    // in a LONG
+    pRect->left   = (LONG) floorf(fmaxf(bounds.left,   (FLOAT) clip.left));
+    pRect->top    = (LONG) floorf(fmaxf(bounds.top,    (FLOAT) clip.top));
+    pRect->right  = (LONG) ceilf(fminf(bounds.right,   (FLOAT) clip.right));
+    pRect->bottom = (LONG) ceilf(fminf(bounds.bottom,  (FLOAT) clip.bottom));
+
+    return (pRect->left < pRect->right && pRect->top < pRect->bottom);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+HRESULT SoftwareRenderSink::CreateSoftwareRenderSink(
+    UINT                    uWidth,
+    UINT                    uHeight,
+    SoftwareRenderSink**    ppSink)
+{
+    SoftwareRenderSink* pSink = NULL;
+
+    if (ppSink == NULL || uWidth == 0 || uHeight == 0) {
+        return E_INVALIDARG;
+    }
+
+    if (uWidth > SOFTWARE_MAX_SURFACE_SIZE ||
+        uHeight > SOFTWARE_MAX_SURFACE_SIZE)
+    {
+        return E_INVALIDARG;
+    }
+
+    pSink = new SoftwareRenderSink();
+
+    if (pSink == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    pSink->_uWidth   = uWidth;
+    pSink->_uHeight  = uHeight;
+    pSink->_pbPixels = (BYTE*) calloc((SIZE_T) uWidth * uHeight, 4);
+
+    if (pSink->_pbPixels == NULL) {
+        delete pSink;
+        return E_OUTOFMEMORY;
+    }
+
+    *ppSink = pSink;
+
+    return S_OK;
+}
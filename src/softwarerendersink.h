@@ -0,0 +1,134 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SOFTWARERENDERSINK_H
+#define __SOFTWARERENDERSINK_H
+
+#include "wintypes.h"
+#include "platform.h"
+#include "blit.h"
+
+////////////////////////////////////////////////////////////////////////////
+// CPU rasterizer
+//
+// Renders into a 32bpp premultiplied BGRA buffer. Bitmaps are sampled
+// bilinearly like D2D1_BITMAP_INTERPOLATION_MODE_LINEAR (see blit.h),
+// ellipses are anti-aliased with 4x4 supersampling. All per-pixel math is integer
+// (transforms are converted to 16.16 fixed point up front), so the same
+// frame produces the same bytes on every machine.
+////////////////////////////////////////////////////////////////////////////
+
+#define SOFTWARE_MAX_SURFACE_SIZE   16384
+#define SOFTWARE_MAX_CLIP_DEPTH     16
+
+class SoftwareRenderBitmap : public RenderBitmap {
+public:
+    // Copies the pixels, 32bpp premultiplied BGRA
+    static HRESULT CreateSoftwareRenderBitmap(
+        UINT                    uWidth,
+        UINT                    uHeight,
+        UINT                    uStride,
+        CONST BYTE*             pbPixels,
+        SoftwareRenderBitmap**  ppBitmap);
+
+    ~SoftwareRenderBitmap();
+
+    UINT GetWidth() CONST;
+    UINT GetHeight() CONST;
+
+    UINT GetStride() CONST;
+    CONST BYTE* GetPixels() CONST;
+
+private:
+    SoftwareRenderBitmap();
+
+    UINT    _uWidth;
+    UINT    _uHeight;
+    BYTE*   _pbPixels;
+};
+
+class SoftwareRenderSink : public RenderSink {
+public:
+    static HRESULT CreateSoftwareRenderSink(
+        UINT                    uWidth,
+        UINT                    uHeight,
+        SoftwareRenderSink**    ppSink);
+
+    ~SoftwareRenderSink();
+
+    HRESULT CreateBitmap(
+        UINT            uWidth,
+        UINT            uHeight,
+        UINT            uStride,
+        CONST BYTE*     pbPixels,
+        RenderBitmap**  ppBitmap);
+
+    Geometry::Size GetSize() CONST;
+
+    VOID BeginDraw();
+    HRESULT EndDraw();
+
+    VOID PushClip(CONST Geometry::Rect& rect);
+    VOID PopClip();
+
+    VOID Clear();
+
+    VOID DrawBitmap(
+        RenderBitmap*           pBitmap,
+        CONST Geometry::Matrix& transform,
+        FLOAT                   fOpacity);
+
+    VOID FillEllipse(
+        CONST Geometry::Point&  center,
+        FLOAT                   fRadiusX,
+        FLOAT                   fRadiusY,
+        CONST RENDERCOLOR&      color);
+
+    UINT GetWidth() CONST;
+    UINT GetHeight() CONST;
+
+    UINT GetStride() CONST;
+    CONST BYTE* GetPixels() CONST;
+
+    // Defaults to the best kernels for this CPU; all of them produce the
+    // same frames
+    VOID SetBlitKernels(CONST BLITKERNELS* pKernels);
+
+private:
+    // Half-open pixel range [left, right) x [top, bottom)
+    typedef struct _PIXELRECT {
+        LONG left;
+        LONG top;
+        LONG right;
+        LONG bottom;
+    } PIXELRECT;
+
+    SoftwareRenderSink();
+
+    BOOL GetDrawRect(CONST Geometry::Rect& bounds, PIXELRECT* pRect) CONST;
+
+    UINT        _uWidth;
+    UINT        _uHeight;
+    BYTE*       _pbPixels;
+
+    PIXELRECT   _clips[SOFTWARE_MAX_CLIP_DEPTH];
+    UINT        _cClips;
+    UINT        _cOverflow;
+
+    CONST BLITKERNELS*  _pBlitKernels;
+};
+
+#endif // __SOFTWARERENDERSINK_H
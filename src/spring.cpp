@@ -0,0 +1,113 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "spring.h"
+
+#include <math.h>
+
+#include "portablemath.h"
+
+// Below this the spring barely moves and would never come to rest
+#define SPRING_MIN_FREQUENCY    0.01f
+
+Spring::Spring(FLOAT fValue, FLOAT fFrequency, FLOAT fPrecision)
+    : _fValue(fValue),
+      _fVelocity(0.0f),
+      _fTarget(fValue),
+      _fFrequency(SPRING_MIN_FREQUENCY),
+      _fPrecision(fabsf(fPrecision)),
+      _bAtRest(TRUE)
+{
+    SetFrequency(fFrequency);
+}
+
+VOID Spring::SetFrequency(FLOAT fFrequency)
+{
+    _fFrequency = fmaxf(fFrequency, SPRING_MIN_FREQUENCY);
+}
+
+FLOAT Spring::GetFrequency() CONST
+{
+    return _fFrequency;
+}
+
+VOID Spring::SetTarget(FLOAT fTarget)
+{
+    if (fTarget == _fTarget) {
+        return;
+    }
+
+    _fTarget = fTarget;
+    _bAtRest = FALSE;
+}
+
+FLOAT Spring::GetTarget() CONST
+{
+    return _fTarget;
+}
+
+VOID Spring::Reset(FLOAT fValue)
+{
+    _fValue = fValue;
+    _fVelocity = 0.0f;
+    _fTarget = fValue;
+    _bAtRest = TRUE;
+}
+
+BOOL Spring::Update(FLOAT fDelta)
+{
+    FLOAT a, b, e;
+
+    if (_bAtRest == TRUE) {
+        return FALSE;
+    }
+
+    if (fDelta <= 0.0f) {
+        return TRUE;
+    }
+
+    a = _fValue - _fTarget;
+    b = _fVelocity + _fFrequency * a;
+    e = PortableExpf(-_fFrequency * fDelta);
+
+    _fValue = _fTarget + (a + b * fDelta) * e;
+    _fVelocity = (b - _fFrequency * (a + b * fDelta)) * e;
+
+    if (fabsf(_fValue - _fTarget) <= _fPrecision &&
+        fabsf(_fVelocity) <= _fPrecision * _fFrequency)
+    {
+        _fValue = _fTarget;
+        _fVelocity = 0.0f;
+        _bAtRest = TRUE;
+    }
+
+    return !_bAtRest;
+}
+
+FLOAT Spring::GetValue() CONST
+{
+    return _fValue;
+}
+
+FLOAT Spring::GetVelocity() CONST
+{
+    return _fVelocity;
+}
+
+BOOL Spring::IsAtRest() CONST
+{
+    return _bAtRest;
+}
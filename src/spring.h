@@ -0,0 +1,74 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SPRING_H
+#define __SPRING_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Spring
+//
+// A critically damped spring: the value closes in on its target as fast
+// as it can without overshooting on its own. Update() evaluates the
+// closed form
+//
+//     x(t) = target + (a + b t) e^(-w t),   a = x - target, b = v + w a
+//
+// rather than integrating, so it is exact and stable for any delta and
+// two half steps land where one whole step does, up to rounding. Moving
+// the target keeps the value and the velocity: a spring turned around
+// half way slows down and comes back instead of jumping onto a new
+// curve. Once the distance and the speed are both within the precision
+// it snaps onto the target and rests.
+//
+// e^x is PortableExpf, so a spring moves the same on every build.
+////////////////////////////////////////////////////////////////////////////
+
+class Spring {
+public:
+    // fFrequency is w, in radians per second; from rest, 99% of the way
+    // is covered after 6.6 / w seconds. fPrecision is in the value's
+    // units, and w times it in theirs per second for the velocity.
+    Spring(FLOAT fValue, FLOAT fFrequency, FLOAT fPrecision);
+
+    VOID SetFrequency(FLOAT fFrequency);
+    FLOAT GetFrequency() CONST;
+
+    VOID SetTarget(FLOAT fTarget);
+    FLOAT GetTarget() CONST;
+
+    // Puts the value and the target there, at rest
+    VOID Reset(FLOAT fValue);
+
+    // FALSE once at rest
+    BOOL Update(FLOAT fDelta);
+
+    FLOAT GetValue() CONST;
+    FLOAT GetVelocity() CONST;
+
+    BOOL IsAtRest() CONST;
+
+private:
+    FLOAT   _fValue;
+    FLOAT   _fVelocity;     // Units per second
+    FLOAT   _fTarget;
+    FLOAT   _fFrequency;
+    FLOAT   _fPrecision;
+    BOOL    _bAtRest;
+};
+
+#endif // __SPRING_H
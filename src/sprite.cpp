@@ -16,36 +16,58 @@
 
 #include "sprite.h"
 
-#include <windowsx.h>
-#include <d2d1helper.h>
+#include <stdlib.h>
+#include <math.h>
 
 #include "safemem.h"
+#include "trace.h"
+
+#ifdef _WIN32
 #include "resource.h"
+#endif
+
+// How far, relative to the scale, the frame cache's scale may be off for
+// a cached frame to stand in for the real one
+#define FRAME_SCALE_TOLERANCE   1e-5f
 
 Sprite::Sprite()
-    : _pBitmap(NULL),
-      _bitmapSize(D2D1::SizeU()),
-      _position(D2D1::Point2F()),
-      _scale(D2D1::SizeF(1.0f, 1.0f)),
-      _scaleCenter(D2D1::Point2F()),
+    : _pMips(NULL),
+      _pCache(NULL),
+      _bitmapSize(Geometry::MakeSize(0.0f, 0.0f)),
+      _position(Geometry::MakePoint(0.0f, 0.0f)),
+      _scale(Geometry::MakeSize(1.0f, 1.0f)),
+      _scaleCenter(Geometry::MakePoint(0.0f, 0.0f)),
       _fRotation(0.0f),
-      _rotationCenter(D2D1::Point2F())
+      _rotationCenter(Geometry::MakePoint(0.0f, 0.0f))
 {
+    UINT i;
+
+    for (i = 0; i < MIP_MAX_LEVELS; i++) {
+        _levels[i] = NULL;
+    }
 }
 
 Sprite::~Sprite()
 {
-    SafeRelease(&_pBitmap);
+    UINT i;
+
+    SafeDelete(&_pCache);
+
+    for (i = 0; i < MIP_MAX_LEVELS; i++) {
+        SafeDelete(&_levels[i]);
+    }
+
+    SafeDelete(&_pMips);
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
-VOID Sprite::SetPosition(CONST D2D1_POINT_2F& position)
+VOID Sprite::SetPosition(CONST Geometry::Point& position)
 {
     _position = position;
 }
 
-D2D1_POINT_2F Sprite::GetPosition() CONST
+Geometry::Point Sprite::GetPosition() CONST
 {
     return _position;
 }
@@ -60,85 +82,328 @@ FLOAT Sprite::GetRotation() CONST
     return _fRotation;
 }
 
-VOID Sprite::SetRotationCenter(CONST D2D1_POINT_2F& center)
+VOID Sprite::SetRotationCenter(CONST Geometry::Point& center)
 {
     _rotationCenter = center;
 }
 
-D2D1_POINT_2F Sprite::GetRotationCenter() CONST
+Geometry::Point Sprite::GetRotationCenter() CONST
 {
     return _rotationCenter;
 }
 
-VOID Sprite::SetScale(CONST D2D1_SIZE_F& scale)
+VOID Sprite::SetScale(CONST Geometry::Size& scale)
 {
     _scale = scale;
 }
 
-D2D1_SIZE_F Sprite::GetScale() CONST
+Geometry::Size Sprite::GetScale() CONST
 {
     return _scale;
 }
 
-VOID Sprite::SetScaleCenter(CONST D2D1_POINT_2F& center)
+VOID Sprite::SetScaleCenter(CONST Geometry::Point& center)
 {
     _scaleCenter = center;
 }
 
-D2D1_POINT_2F Sprite::GetScaleCenter() CONST
+Geometry::Point Sprite::GetScaleCenter() CONST
 {
     return _scaleCenter;
 }
 
-D2D1_SIZE_U Sprite::GetBitmapSize() CONST
+Geometry::Size Sprite::GetBitmapSize() CONST
 {
     return _bitmapSize;
 }
 
+Geometry::Matrix Sprite::GetTransform() CONST
+{
+    Geometry::Matrix rotate, translate, scale;
+
+    translate = Geometry::Translation(_position.x, _position.y);
+    rotate = Geometry::Rotation(_fRotation, _rotationCenter);
+    scale = Geometry::Scale(_scale, _scaleCenter);
+
+    return Geometry::Multiply(Geometry::Multiply(scale, rotate), translate);
+}
+
+Geometry::Rect Sprite::GetBounds() CONST
+{
+    Geometry::Rect  rect;
+    SPRITEFRAMEKEY  key;
+    LONG            x, y;
+
+    if (GetFrameKey(&key, &x, &y) == TRUE) {
+        rect = _pCache->GetFrameRect(key);
+
+        return Geometry::MakeRect(
+            rect.left + x, rect.top + y, rect.right + x, rect.bottom + y);
+    }
+
+    return Geometry::TransformBounds(
+        GetTransform(),
+        Geometry::MakeRect(0.0f, 0.0f, _bitmapSize.width, _bitmapSize.height));
+}
+
 ////////////////////////////////////////////////////////////////////////////
 
-HRESULT Sprite::Draw(ID2D1RenderTarget* pRenderTarget)
+HRESULT Sprite::Draw(RenderSink* pSink)
 {
-    D2D1::Matrix3x2F rotate, translate, scale;
-    D2D1::Matrix3x2F oldTransform, transform;
+    SPRITEFRAMEKEY  key;
+    SPRITEFRAME     frame;
+    LONG            x, y;
+    UINT            uLevel;
+    HRESULT         hResult;
+
+    FP_TRACE_SCOPE("Sprite::Draw");
 
-    if (pRenderTarget == NULL) {
+    if (pSink == NULL) {
         return E_INVALIDARG;
     }
 
-    if (_pBitmap == NULL) {
+    if (_pMips == NULL) {
         return E_FAIL;
     }
 
-    pRenderTarget->GetTransform(&oldTransform);
+    if (GetFrameKey(&key, &x, &y) == FALSE) {
+        uLevel = SelectLevel();
 
-    translate = D2D1::Matrix3x2F::Translation(_position.x, _position.y);
-    rotate = D2D1::Matrix3x2F::Rotation(_fRotation, _rotationCenter);
-    scale = D2D1::Matrix3x2F::Scale(_scale, _scaleCenter);
+        pSink->DrawBitmap(
+            _levels[uLevel],
+            Geometry::Multiply(
+                _pMips->GetLevelTransform(uLevel),
+                GetTransform()),
+            1.0f);
 
-    transform = scale * rotate * translate;
+        return S_OK;
+    }
 
-    pRenderTarget->SetTransform(&transform);
+    hResult = _pCache->GetFrame(key, &frame);
+
+    if (hResult == S_OK) {
+        pSink->DrawBitmap(
+            frame.pBitmap,
+            Geometry::Translation(
+                (FLOAT) (x + frame.lOffsetX),
+                (FLOAT) (y + frame.lOffsetY)),
+            1.0f);
+    } else if (FAILED(hResult)) {
+        // Too big for the budget: draw the same quantized transform
+        // directly, so it still matches GetBounds()
+        uLevel = SelectLevel();
+
+        pSink->DrawBitmap(
+            _levels[uLevel],
+            Geometry::Multiply(
+                Geometry::Multiply(
+                    _pMips->GetLevelTransform(uLevel),
+                    _pCache->GetKeyTransform(key)),
+                Geometry::Translation((FLOAT) x, (FLOAT) y)),
+            1.0f);
+    }
 
-    pRenderTarget->DrawBitmap(
-        _pBitmap,
-        NULL,
-        1.0f,
-        D2D1_BITMAP_INTERPOLATION_MODE_LINEAR,
-        NULL);
-    
-    pRenderTarget->SetTransform(&oldTransform);
+    return S_OK;
+}
+
+HRESULT Sprite::EnableFrameCache(RenderSink* pSink, SIZE_T cbBudget)
+{
+    SpriteCache*    pCache = NULL;
+    HRESULT         hResult;
+
+    hResult = SpriteCache::CreateSpriteCache(
+        _pMips,
+        pSink,
+        cbBudget,
+        &pCache);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    SafeDelete(&_pCache);
+    _pCache = pCache;
 
     return S_OK;
 }
 
+VOID Sprite::DisableFrameCache()
+{
+    SafeDelete(&_pCache);
+}
+
+VOID Sprite::SetFrameCacheScale(FLOAT fScale)
+{
+    if (_pCache != NULL) {
+        _pCache->SetUnitScale(fScale);
+    }
+}
+
+VOID Sprite::WarmFrameCache(FLOAT fFromAngle, FLOAT fToAngle)
+{
+    SPRITEFRAMEKEY  key, last;
+    SPRITEFRAME     frame;
+
+    if (_pCache == NULL) {
+        return;
+    }
+
+    key  = _pCache->Quantize(fminf(fFromAngle, fToAngle), _scale);
+    last = _pCache->Quantize(fmaxf(fFromAngle, fToAngle), _scale);
+
+    for (; key.iAngle <= last.iAngle; key.iAngle++) {
+        if (FAILED(_pCache->GetFrame(key, &frame))) {
+            break;
+        }
+    }
+}
+
+SpriteCache* Sprite::GetFrameCache()
+{
+    return _pCache;
+}
+
+SIZE_T Sprite::GetMipMemoryUsage() CONST
+{
+    SIZE_T  cbTotal;
+    UINT    i;
+
+    if (_pMips == NULL) {
+        return 0;
+    }
+
+    cbTotal = _pMips->GetMemoryUsage();
+
+    for (i = 1; i < _pMips->GetLevelCount(); i++) {
+        cbTotal += (SIZE_T) _levels[i]->GetWidth() * _levels[i]->GetHeight() * 4;
+    }
+
+    return cbTotal;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+// A scale off the cache's grid is one in motion (the grid holds every
+// scale the sprite rests at); snapping it would make the animation jump
+// from step to step, so it is drawn directly until it settles
+BOOL Sprite::GetFrameKey(SPRITEFRAMEKEY* pKey, LONG* plX, LONG* plY) CONST
+{
+    Geometry::Matrix    transform;
+    Geometry::Size      scale;
+    SPRITEFRAMEKEY      key;
+
+    if (_pCache == NULL) {
+        return FALSE;
+    }
+
+    key   = _pCache->Quantize(_fRotation, _scale);
+    scale = _pCache->GetKeyScale(key);
+
+    if (fabsf(scale.width - _scale.width) >
+            FRAME_SCALE_TOLERANCE * fabsf(_scale.width) ||
+        fabsf(scale.height - _scale.height) >
+            FRAME_SCALE_TOLERANCE * fabsf(_scale.height))
+    {
+        return FALSE;
+    }
+
+    // Same composition as GetTransform(), with the quantized values; the
+    // translation it ends up with is where the frame's origin goes
+    transform = Geometry::Multiply(
+        Geometry::Multiply(
+            Geometry::Scale(scale, _scaleCenter),
+            Geometry::Rotation(
+                key.iAngle * SPRITECACHE_ANGLE_STEP, _rotationCenter)),
+        Geometry::Translation(_position.x, _position.y));
+
+    *plX = (LONG) floorf(transform._31 + 0.5f);
+    *plY = (LONG) floorf(transform._32 + 0.5f);
+    *pKey = key;
+
+    return TRUE;
+}
+
+UINT Sprite::SelectLevel() CONST
+{
+    return _pMips->SelectLevel(
+        fmaxf(fabsf(_scale.width), fabsf(_scale.height)));
+}
+
 ////////////////////////////////////////////////////////////////////////////
 
+HRESULT Sprite::CreateSpriteFromPixels(
+    RenderSink*         pSink,
+    UINT                uWidth,
+    UINT                uHeight,
+    UINT                uStride,
+    CONST BYTE*         pbPixels,
+    Sprite**            ppSprite)
+{
+    Sprite*                 pSprite;
+    SoftwareRenderBitmap*   pLevel;
+    UINT                    i;
+    HRESULT                 hResult = S_OK;
+
+    if (ppSprite == NULL) {
+        return E_INVALIDARG;
+    }
+
+    if (pSink == NULL || pbPixels == NULL || uWidth == 0 || uHeight == 0) {
+        return E_INVALIDARG;
+    }
+
+    pSprite = new Sprite();
+
+    if (pSprite == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    hResult = MipChain::CreateMipChain(
+        uWidth,
+        uHeight,
+        uStride,
+        pbPixels,
+        &(pSprite->_pMips));
+
+    if (FAILED(hResult)) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < pSprite->_pMips->GetLevelCount(); i++) {
+        pLevel = pSprite->_pMips->GetLevel(i);
+
+        hResult = pSink->CreateBitmap(
+            pLevel->GetWidth(),
+            pLevel->GetHeight(),
+            pLevel->GetStride(),
+            pLevel->GetPixels(),
+            &(pSprite->_levels[i]));
+
+        if (FAILED(hResult)) {
+            goto cleanup;
+        }
+    }
+
+    pSprite->_bitmapSize = Geometry::MakeSize((FLOAT) uWidth, (FLOAT) uHeight);
+
+cleanup:
+    if (SUCCEEDED(hResult)) {
+        *ppSprite = pSprite;
+    } else if (pSprite != NULL){
+        delete pSprite;
+    }
+
+    return hResult;
+}
+
+#ifdef _WIN32
+
 HRESULT Sprite::CreateSpriteFromResource(
-    ID2D1HwndRenderTarget*  pHwndRenderTarget,
-    LPCTSTR                 lpszName,
-    LPCTSTR                 lpszType,
-    Sprite**                ppSprite)
+    RenderSink*         pSink,
+    HINSTANCE           hInstance,
+    LPCTSTR             lpszName,
+    LPCTSTR             lpszType,
+    Sprite**            ppSprite)
 {
     IStream*                pIStream = NULL;
     IWICImagingFactory*     pFactory = NULL;
@@ -147,14 +412,13 @@ HRESULT Sprite::CreateSpriteFromResource(
     IWICFormatConverter*    pConverter = NULL;
     HRESULT                 hResult = S_OK;
 
-    if (pHwndRenderTarget == NULL || ppSprite == NULL) {
+    FP_TRACE_SCOPE("Sprite::CreateSpriteFromResource");
+
+    if (pSink == NULL || ppSprite == NULL) {
         return E_INVALIDARG;
     }
 
-    pIStream = CreateIStreamFromResource(
-        GetWindowInstance(pHwndRenderTarget->GetHwnd()),
-        lpszName,
-        lpszType);
+    pIStream = CreateIStreamFromResource(hInstance, lpszName, lpszType);
     
     if (pIStream == NULL) {
         return E_INVALIDARG;
@@ -204,10 +468,7 @@ HRESULT Sprite::CreateSpriteFromResource(
         goto cleanup;
     }
 
-    hResult = CreateSpriteFromIWICBitmapSource(
-        pHwndRenderTarget,
-        pConverter,
-        ppSprite);
+    hResult = CreateSpriteFromIWICBitmapSource(pSink, pConverter, ppSprite);
 
 cleanup:
     SafeRelease(&pConverter);
@@ -220,45 +481,69 @@ cleanup:
 }
 
 HRESULT Sprite::CreateSpriteFromIWICBitmapSource(
-    ID2D1RenderTarget*  pRenderTarget,
+    RenderSink*         pSink,
     IWICBitmapSource*   pBitmapSource,
     Sprite**            ppSprite)
 {
-    Sprite* pSprite;
-    HRESULT hResult = S_OK;
+    WICPixelFormatGUID  pixelFormat;
+    BYTE*               pbPixels = NULL;
+    UINT                uWidth, uHeight, uStride;
+    HRESULT             hResult = S_OK;
 
     if (ppSprite == NULL) {
         return E_INVALIDARG;
     }
 
-    if (pRenderTarget == NULL || pBitmapSource == NULL) {
+    if (pSink == NULL || pBitmapSource == NULL) {
         return E_INVALIDARG;
     }
-    
-    pSprite = new Sprite();
 
-    if (pSprite == NULL) {
+    hResult = pBitmapSource->GetPixelFormat(&pixelFormat);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    if (!IsEqualGUID(pixelFormat, GUID_WICPixelFormat32bppPBGRA)) {
+        return WINCODEC_ERR_UNSUPPORTEDPIXELFORMAT;
+    }
+
+    hResult = pBitmapSource->GetSize(&uWidth, &uHeight);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    uStride = uWidth * 4;
+
+    pbPixels = (BYTE*) malloc(uStride * uHeight);
+
+    if (pbPixels == NULL) {
         return E_OUTOFMEMORY;
     }
 
-    hResult = pRenderTarget->CreateBitmapFromWicBitmap(
-        pBitmapSource,
-        &(pSprite->_pBitmap));
-    
+    hResult = pBitmapSource->CopyPixels(
+        NULL,
+        uStride,
+        uStride * uHeight,
+        pbPixels);
+
     if (FAILED(hResult)) {
         goto cleanup;
     }
 
-    hResult = pBitmapSource->GetSize(
-        &(pSprite->_bitmapSize.width),
-        &(pSprite->_bitmapSize.height));
+    hResult = CreateSpriteFromPixels(
+        pSink,
+        uWidth,
+        uHeight,
+        uStride,
+        pbPixels,
+        ppSprite);
 
 cleanup:
-    if (SUCCEEDED(hResult)) {
-        *ppSprite = pSprite;
-    } else if (pSprite != NULL){
-        delete pSprite;
-    }
+    free(pbPixels);
 
     return hResult;
-}
\ No newline at end of file
+}
+
+#endif // _WIN32
\ No newline at end of file
@@ -17,55 +17,105 @@
 #ifndef __SPRITE_H
 #define __SPRITE_H
 
-#include <Windows.h>
+#include "wintypes.h"
+#include "geometry.h"
+#include "platform.h"
+#include "mipchain.h"
+#include "spritecache.h"
+
+#ifdef _WIN32
 #include <wincodec.h>
-#include <d2d1.h>
+#endif
 
 class Sprite
 {
 public:
+    // Pixels are 32bpp premultiplied BGRA
+    static HRESULT CreateSpriteFromPixels(
+        RenderSink*         pSink,
+        UINT                uWidth,
+        UINT                uHeight,
+        UINT                uStride,
+        CONST BYTE*         pbPixels,
+        Sprite**            ppSprite);
+
+#ifdef _WIN32
     static HRESULT CreateSpriteFromResource(
-        ID2D1HwndRenderTarget*  pHwndRenderTarget,
-        LPCTSTR                 lpszName,
-        LPCTSTR                 lpszType,
-        Sprite**                ppSprite);
+        RenderSink*         pSink,
+        HINSTANCE           hInstance,
+        LPCTSTR             lpszName,
+        LPCTSTR             lpszType,
+        Sprite**            ppSprite);
 
     static HRESULT CreateSpriteFromIWICBitmapSource(
-        ID2D1RenderTarget*  pRenderTarget,
+        RenderSink*         pSink,
         IWICBitmapSource*   pBitmapSource,
         Sprite**            ppSprite);
+#endif // _WIN32
 
     ~Sprite();
 
-    VOID SetPosition(CONST D2D1_POINT_2F& position);
-    D2D1_POINT_2F GetPosition() CONST;
+    VOID SetPosition(CONST Geometry::Point& position);
+    Geometry::Point GetPosition() CONST;
 
     VOID SetRotation(FLOAT fAngle);
     FLOAT GetRotation() CONST;
 
-    VOID SetRotationCenter(CONST D2D1_POINT_2F& center);
-    D2D1_POINT_2F GetRotationCenter() CONST;
+    VOID SetRotationCenter(CONST Geometry::Point& center);
+    Geometry::Point GetRotationCenter() CONST;
+
+    VOID SetScale(CONST Geometry::Size& scale);
+    Geometry::Size GetScale() CONST;
+
+    VOID SetScaleCenter(CONST Geometry::Point& center);
+    Geometry::Point GetScaleCenter() CONST;
 
-    VOID SetScale(CONST D2D1_SIZE_F& scale);
-    D2D1_SIZE_F GetScale() CONST;
+    Geometry::Size GetBitmapSize() CONST;
 
-    VOID SetScaleCenter(CONST D2D1_POINT_2F& center);
-    D2D1_POINT_2F GetScaleCenter() CONST;
+    Geometry::Matrix GetTransform() CONST;
+    Geometry::Rect GetBounds() CONST;
 
-    D2D1_SIZE_U GetBitmapSize() CONST;
+    // Downscaled draws sample the matching level of a mip chain that is
+    // built when the sprite is created
+    HRESULT Draw(RenderSink* pSink);
 
-    HRESULT Draw(ID2D1RenderTarget* pRenderTarget);
+    // Bytes held by the mip chain: the CPU copies of every level plus
+    // the bitmaps of levels 1 and up on the sink
+    SIZE_T GetMipMemoryUsage() CONST;
+
+    // With the frame cache on, rotation is quantized (see spritecache.h)
+    // and the position is snapped to whole pixels. Scales off the
+    // cache's grid, such as one that is still animating, bypass it.
+    HRESULT EnableFrameCache(RenderSink* pSink, SIZE_T cbBudget);
+    VOID DisableFrameCache();
+
+    // The scale the frame cache quantizes relative to, see
+    // SpriteCache::SetUnitScale
+    VOID SetFrameCacheScale(FLOAT fScale);
+
+    // Pre-renders every cached angle between the two at the current scale
+    VOID WarmFrameCache(FLOAT fFromAngle, FLOAT fToAngle);
+
+    SpriteCache* GetFrameCache();
     
 private:
     Sprite();
 
-    ID2D1Bitmap*    _pBitmap;
-    D2D1_SIZE_U     _bitmapSize;
-    D2D1_POINT_2F   _position;
-    D2D1_SIZE_F     _scale;
-    D2D1_POINT_2F   _scaleCenter;
-    FLOAT           _fRotation;
-    D2D1_POINT_2F   _rotationCenter;
+    // FALSE when the sprite is drawn without the frame cache
+    BOOL GetFrameKey(SPRITEFRAMEKEY* pKey, LONG* plX, LONG* plY) CONST;
+
+    UINT SelectLevel() CONST;
+
+    RenderBitmap*           _pBitmap;
+    RenderBitmap*           _levels[MIP_MAX_LEVELS];
+    MipChain*               _pMips;
+    SpriteCache*            _pCache;
+    Geometry::Size          _bitmapSize;
+    Geometry::Point         _position;
+    Geometry::Size          _scale;
+    Geometry::Point         _scaleCenter;
+    FLOAT                   _fRotation;
+    Geometry::Point         _rotationCenter;
 };
 
 #endif // __SPRITE_H
\ No newline at end of file
@@ -0,0 +1,333 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "spritecache.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "safemem.h"
+
+SpriteCache::SpriteCache()
+    : _pMips(NULL),
+      _pSink(NULL),
+      _cEntries(0),
+      _fUnitScale(1.0f),
+      _cbBudget(0),
+      _cbUsed(0),
+      _ullUseCounter(0),
+      _cHits(0),
+      _cMisses(0),
+      _cEvictions(0)
+{
+}
+
+SpriteCache::~SpriteCache()
+{
+    Clear();
+}
+
+VOID SpriteCache::SetUnitScale(FLOAT fUnitScale)
+{
+    if (fUnitScale <= 0.0f || fUnitScale == _fUnitScale) {
+        return;
+    }
+
+    // Every key means a different scale now
+    Clear();
+
+    _fUnitScale = fUnitScale;
+}
+
+FLOAT SpriteCache::GetUnitScale() CONST
+{
+    return _fUnitScale;
+}
+
+SPRITEFRAMEKEY SpriteCache::Quantize(
+    FLOAT                   fAngle,
+    CONST Geometry::Size&   scale) CONST
+{
+    FLOAT           fStep = SPRITECACHE_SCALE_STEP * _fUnitScale;
+    SPRITEFRAMEKEY  key;
+
+    key.iAngle  = (INT) floorf(fAngle / SPRITECACHE_ANGLE_STEP + 0.5f);
+    key.iScaleX = (INT) floorf(scale.width / fStep + 0.5f);
+    key.iScaleY = (INT) floorf(scale.height / fStep + 0.5f);
+
+    return key;
+}
+
+Geometry::Size SpriteCache::GetKeyScale(CONST SPRITEFRAMEKEY& key) CONST
+{
+    return Geometry::MakeSize(
+        key.iScaleX * SPRITECACHE_SCALE_STEP * _fUnitScale,
+        key.iScaleY * SPRITECACHE_SCALE_STEP * _fUnitScale);
+}
+
+Geometry::Matrix SpriteCache::GetKeyTransform(CONST SPRITEFRAMEKEY& key) CONST
+{
+    Geometry::Point origin = Geometry::MakePoint(0.0f, 0.0f);
+
+    return Geometry::Multiply(
+        Geometry::Scale(GetKeyScale(key), origin),
+        Geometry::Rotation(key.iAngle * SPRITECACHE_ANGLE_STEP, origin));
+}
+
+Geometry::Rect SpriteCache::GetFrameRect(CONST SPRITEFRAMEKEY& key) CONST
+{
+    SoftwareRenderBitmap*   pLevel;
+    Geometry::Matrix        transform;
+
+    if (key.iScaleX == 0 || key.iScaleY == 0) {
+        return Geometry::MakeRect(0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    pLevel = _pMips->GetLevel(SelectLevel(key, &transform));
+
+    // Half a texel of bilinear bleed around the bitmap
+    return Geometry::RoundOut(Geometry::TransformBounds(
+        transform,
+        Geometry::MakeRect(
+            -0.5f,
+            -0.5f,
+            (FLOAT) pLevel->GetWidth()  + 0.5f,
+            (FLOAT) pLevel->GetHeight() + 0.5f)));
+}
+
+HRESULT SpriteCache::GetFrame(
+    CONST SPRITEFRAMEKEY&   key,
+    SPRITEFRAME*            pFrame)
+{
+    SPRITECACHEENTRY*   pEntry;
+    Geometry::Rect      rect;
+    SIZE_T              cbSize;
+    UINT                i, uOldest;
+    HRESULT             hResult;
+
+    if (pFrame == NULL) {
+        return E_INVALIDARG;
+    }
+
+    _ullUseCounter++;
+
+    for (i = 0; i < _cEntries; i++) {
+        pEntry = &_entries[i];
+
+        if (pEntry->key.iAngle  == key.iAngle &&
+            pEntry->key.iScaleX == key.iScaleX &&
+            pEntry->key.iScaleY == key.iScaleY)
+        {
+            pEntry->ullLastUse = _ullUseCounter;
+            *pFrame = pEntry->frame;
+            _cHits++;
+            return S_OK;
+        }
+    }
+
+    _cMisses++;
+
+    rect = GetFrameRect(key);
+
+    if (Geometry::IsEmpty(rect) == TRUE) {
+        pFrame->pBitmap  = NULL;
+        pFrame->lOffsetX = 0;
+        pFrame->lOffsetY = 0;
+        return S_FALSE;
+    }
+
+    cbSize = (SIZE_T) Geometry::Area(rect) * 4;
+
+    if (cbSize > _cbBudget) {
+        return E_OUTOFMEMORY;
+    }
+
+    // Least recently used first, until the new frame fits
+    while (_cEntries > 0 &&
+           (_cbUsed + cbSize > _cbBudget || _cEntries == SPRITECACHE_MAX_FRAMES))
+    {
+        uOldest = 0;
+
+        for (i = 1; i < _cEntries; i++) {
+            if (_entries[i].ullLastUse < _entries[uOldest].ullLastUse) {
+                uOldest = i;
+            }
+        }
+
+        Evict(uOldest);
+    }
+
+    pEntry = &_entries[_cEntries];
+
+    hResult = RenderFrame(key, &(pEntry->frame), &(pEntry->cbSize));
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    pEntry->key        = key;
+    pEntry->ullLastUse = _ullUseCounter;
+
+    _cbUsed += pEntry->cbSize;
+    _cEntries++;
+
+    *pFrame = pEntry->frame;
+
+    return S_OK;
+}
+
+VOID SpriteCache::Clear()
+{
+    while (_cEntries > 0) {
+        Evict(_cEntries - 1);
+    }
+}
+
+VOID SpriteCache::GetStats(SPRITECACHESTATS* pStats) CONST
+{
+    if (pStats == NULL) {
+        return;
+    }
+
+    pStats->cFrames    = _cEntries;
+    pStats->cbUsed     = _cbUsed;
+    pStats->cbBudget   = _cbBudget;
+    pStats->cHits      = _cHits;
+    pStats->cMisses    = _cMisses;
+    pStats->cEvictions = _cEvictions;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+HRESULT SpriteCache::RenderFrame(
+    CONST SPRITEFRAMEKEY&   key,
+    SPRITEFRAME*            pFrame,
+    SIZE_T*                 pcbSize)
+{
+    SoftwareRenderSink* pCanvas = NULL;
+    Geometry::Matrix    transform;
+    Geometry::Rect      rect;
+    UINT                uLevel, uWidth, uHeight;
+    HRESULT             hResult;
+
+    uLevel  = SelectLevel(key, &transform);
+    rect    = GetFrameRect(key);
+    uWidth  = (UINT) (rect.right - rect.left);
+    uHeight = (UINT) (rect.bottom - rect.top);
+
+    hResult = SoftwareRenderSink::CreateSoftwareRenderSink(
+        uWidth,
+        uHeight,
+        &pCanvas);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    pCanvas->BeginDraw();
+
+    pCanvas->DrawBitmap(
+        _pMips->GetLevel(uLevel),
+        Geometry::Multiply(
+            transform,
+            Geometry::Translation(-rect.left, -rect.top)),
+        1.0f);
+
+    hResult = pCanvas->EndDraw();
+
+    if (FAILED(hResult)) {
+        goto cleanup;
+    }
+
+    hResult = _pSink->CreateBitmap(
+        uWidth,
+        uHeight,
+        pCanvas->GetStride(),
+        pCanvas->GetPixels(),
+        &(pFrame->pBitmap));
+
+    if (FAILED(hResult)) {
+        goto cleanup;
+    }
+
+    pFrame->lOffsetX = (LONG) rect.left;
+    pFrame->lOffsetY = (LONG) rect.top;
+
+    *pcbSize = (SIZE_T) uWidth * uHeight * 4;
+
+cleanup:
+    SafeDelete(&pCanvas);
+
+    return hResult;
+}
+
+UINT SpriteCache::SelectLevel(
+    CONST SPRITEFRAMEKEY&   key,
+    Geometry::Matrix*       pTransform) CONST
+{
+    UINT uLevel;
+
+    uLevel = _pMips->SelectLevel(SPRITECACHE_SCALE_STEP * _fUnitScale *
+        (FLOAT) ((abs(key.iScaleX) > abs(key.iScaleY)) ?
+                  abs(key.iScaleX) : abs(key.iScaleY)));
+
+    *pTransform = Geometry::Multiply(
+        _pMips->GetLevelTransform(uLevel),
+        GetKeyTransform(key));
+
+    return uLevel;
+}
+
+VOID SpriteCache::Evict(UINT uIndex)
+{
+    SafeDelete(&(_entries[uIndex].frame.pBitmap));
+
+    _cbUsed -= _entries[uIndex].cbSize;
+    _cEvictions++;
+
+    // Order does not matter, fill the hole with the last entry
+    _entries[uIndex] = _entries[_cEntries - 1];
+    _cEntries--;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+HRESULT SpriteCache::CreateSpriteCache(
+    MipChain*               pMips,
+    RenderSink*             pSink,
+    SIZE_T                  cbBudget,
+    SpriteCache**           ppCache)
+{
+    SpriteCache* pCache = NULL;
+
+    if (pMips == NULL || pSink == NULL || ppCache == NULL) {
+        return E_INVALIDARG;
+    }
+
+    pCache = new SpriteCache();
+
+    if (pCache == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    pCache->_pMips    = pMips;
+    pCache->_pSink    = pSink;
+    pCache->_cbBudget = cbBudget;
+
+    *ppCache = pCache;
+
+    return S_OK;
+}
@@ -0,0 +1,140 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SPRITECACHE_H
+#define __SPRITECACHE_H
+
+#include "wintypes.h"
+#include "geometry.h"
+#include "platform.h"
+#include "mipchain.h"
+
+////////////////////////////////////////////////////////////////////////////
+// SpriteCache
+//
+// Pre-rendered rotation/scale variants of one bitmap. Angles and scales
+// are quantized, each variant is rendered once on the CPU, uploaded to
+// the target sink and afterwards drawn at a whole pixel offset, which is
+// a plain copy on every backend. Downscaled variants are rendered from
+// the matching mip level. Variants are separate bitmaps (the
+// RenderSink interface has no source rectangles to address an atlas
+// with), kept within a byte budget and evicted least recently used.
+//
+// Scales are counted in steps of SPRITECACHE_SCALE_STEP times the unit
+// scale, which the owner sets to the scale it always draws at (the
+// display scale), so that part is reproduced exactly and only what
+// varies on top of it is snapped to the grid.
+////////////////////////////////////////////////////////////////////////////
+
+#define SPRITECACHE_ANGLE_STEP      3.0f        // degrees
+#define SPRITECACHE_SCALE_STEP      0.02f
+#define SPRITECACHE_MAX_FRAMES      128
+
+typedef struct _SPRITEFRAMEKEY {
+    INT iAngle;
+    INT iScaleX;
+    INT iScaleY;
+} SPRITEFRAMEKEY;
+
+typedef struct _SPRITEFRAME {
+    RenderBitmap*   pBitmap;
+    LONG            lOffsetX;   // top left corner relative to the origin
+    LONG            lOffsetY;   // of the untranslated transform
+} SPRITEFRAME;
+
+typedef struct _SPRITECACHESTATS {
+    UINT    cFrames;
+    SIZE_T  cbUsed;
+    SIZE_T  cbBudget;
+    ULONG   cHits;
+    ULONG   cMisses;
+    ULONG   cEvictions;
+} SPRITECACHESTATS;
+
+class SpriteCache {
+public:
+    // pMips must outlive the cache, bitmaps are created on pSink
+    static HRESULT CreateSpriteCache(
+        MipChain*                   pMips,
+        RenderSink*                 pSink,
+        SIZE_T                      cbBudget,
+        SpriteCache**               ppCache);
+
+    ~SpriteCache();
+
+    // Drops every frame when the unit scale changes; 1 by default
+    VOID SetUnitScale(FLOAT fUnitScale);
+    FLOAT GetUnitScale() CONST;
+
+    SPRITEFRAMEKEY Quantize(FLOAT fAngle, CONST Geometry::Size& scale) CONST;
+
+    // The scale and the linear part (no translation) of the transform a
+    // key stands for
+    Geometry::Size GetKeyScale(CONST SPRITEFRAMEKEY& key) CONST;
+    Geometry::Matrix GetKeyTransform(CONST SPRITEFRAMEKEY& key) CONST;
+
+    // Pixel rectangle a frame covers, relative to the transform origin;
+    // does not render anything
+    Geometry::Rect GetFrameRect(CONST SPRITEFRAMEKEY& key) CONST;
+
+    // Renders the frame on a miss. The bitmap stays valid until the next
+    // call.
+    HRESULT GetFrame(CONST SPRITEFRAMEKEY& key, SPRITEFRAME* pFrame);
+
+    VOID Clear();
+
+    VOID GetStats(SPRITECACHESTATS* pStats) CONST;
+
+private:
+    typedef struct _SPRITECACHEENTRY {
+        SPRITEFRAMEKEY  key;
+        SPRITEFRAME     frame;
+        SIZE_T          cbSize;
+        ULONGLONG       ullLastUse;
+    } SPRITECACHEENTRY;
+
+    SpriteCache();
+
+    // Mip level a frame is rendered from and its texel to frame transform
+    UINT SelectLevel(
+        CONST SPRITEFRAMEKEY&   key,
+        Geometry::Matrix*       pTransform) CONST;
+
+    HRESULT RenderFrame(
+        CONST SPRITEFRAMEKEY&   key,
+        SPRITEFRAME*            pFrame,
+        SIZE_T*                 pcbSize);
+
+    VOID Evict(UINT uIndex);
+
+    MipChain*                   _pMips;
+    RenderSink*                 _pSink;
+
+    SPRITECACHEENTRY            _entries[SPRITECACHE_MAX_FRAMES];
+    UINT                        _cEntries;
+
+    FLOAT                       _fUnitScale;
+
+    SIZE_T                      _cbBudget;
+    SIZE_T                      _cbUsed;
+    ULONGLONG                   _ullUseCounter;
+
+    ULONG                       _cHits;
+    ULONG                       _cMisses;
+    ULONG                       _cEvictions;
+};
+
+#endif // __SPRITECACHE_H
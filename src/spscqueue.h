@@ -0,0 +1,105 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SPSCQUEUE_H
+#define __SPSCQUEUE_H
+
+#include "wintypes.h"
+#include "atomic.h"
+
+////////////////////////////////////////////////////////////////////////////
+// SpscQueue
+//
+// Fixed size ring buffer for exactly one producer and one consumer
+// thread. Push and Pop never wait on the other side: they fail when the
+// ring is full or empty. The indices only grow, so full and empty are
+// told apart by their difference, and each sits on its own cache line
+// so the two threads do not keep stealing it from each other.
+////////////////////////////////////////////////////////////////////////////
+
+#define SPSC_CACHE_LINE     64
+
+template<class Item, UINT uCapacity>
+class SpscQueue {
+public:
+    SpscQueue()
+        : _lTail(0),
+          _uCachedHead(0),
+          _lHead(0),
+          _uCachedTail(0)
+    {
+    }
+
+    // Producer thread only
+    BOOL Push(CONST Item& item)
+    {
+        UINT uTail = (UINT) _lTail;
+
+        if (uTail - _uCachedHead == uCapacity) {
+            _uCachedHead = (UINT) AtomicLoadAcquire(&_lHead);
+
+            if (uTail - _uCachedHead == uCapacity) {
+                return FALSE;
+            }
+        }
+
+        _items[uTail & (uCapacity - 1)] = item;
+        AtomicStoreRelease(&_lTail, (LONG) (uTail + 1));
+
+        return TRUE;
+    }
+
+    // Consumer thread only
+    BOOL Pop(Item* pItem)
+    {
+        UINT uHead = (UINT) _lHead;
+
+        if (uHead == _uCachedTail) {
+            _uCachedTail = (UINT) AtomicLoadAcquire(&_lTail);
+
+            if (uHead == _uCachedTail) {
+                return FALSE;
+            }
+        }
+
+        *pItem = _items[uHead & (uCapacity - 1)];
+        AtomicStoreRelease(&_lHead, (LONG) (uHead + 1));
+
+        return TRUE;
+    }
+
+private:
+    // uCapacity has to be a power of two for the index mask
+    typedef CHAR CAPACITY_IS_POWER_OF_TWO[
+        (uCapacity != 0 && (uCapacity & (uCapacity - 1)) == 0) ? 1 : -1];
+
+    SpscQueue(CONST SpscQueue&);
+    SpscQueue& operator=(CONST SpscQueue&);
+
+    // Written by the producer
+    volatile LONG   _lTail;
+    UINT            _uCachedHead;
+    BYTE            _padding0[SPSC_CACHE_LINE - sizeof(LONG) - sizeof(UINT)];
+
+    // Written by the consumer
+    volatile LONG   _lHead;
+    UINT            _uCachedTail;
+    BYTE            _padding1[SPSC_CACHE_LINE - sizeof(LONG) - sizeof(UINT)];
+
+    Item            _items[uCapacity];
+};
+
+#endif // __SPSCQUEUE_H
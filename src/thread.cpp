@@ -0,0 +1,296 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+#include "trace.h"
+
+////////////////////////////////////////////////////////////////////////////
+// ThreadEvent
+////////////////////////////////////////////////////////////////////////////
+
+ThreadEvent::ThreadEvent()
+{
+#ifdef _WIN32
+    _hEvent = NULL;
+#else
+    _bSet = FALSE;
+    _bCreated = FALSE;
+#endif
+}
+
+ThreadEvent::~ThreadEvent()
+{
+#ifdef _WIN32
+    if (_hEvent != NULL) {
+        CloseHandle(_hEvent);
+    }
+#else
+    if (_bCreated == TRUE) {
+        pthread_cond_destroy(&_cond);
+        pthread_mutex_destroy(&_mutex);
+    }
+#endif
+}
+
+VOID ThreadEvent::Set()
+{
+#ifdef _WIN32
+    SetEvent(_hEvent);
+#else
+    pthread_mutex_lock(&_mutex);
+    _bSet = TRUE;
+    pthread_cond_signal(&_cond);
+    pthread_mutex_unlock(&_mutex);
+#endif
+}
+
+BOOL ThreadEvent::Wait(DWORD dwMilliseconds)
+{
+#ifdef _WIN32
+    return WaitForSingleObject(_hEvent, dwMilliseconds) == WAIT_OBJECT_0;
+#else
+    struct timespec ts;
+    BOOL            bSet;
+    INT             iResult = 0;
+
+    // The condition runs on CLOCK_MONOTONIC, see CreateThreadEvent()
+    if (dwMilliseconds != INFINITE) {
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        ts.tv_sec += dwMilliseconds / 1000;
+        ts.tv_nsec += (long) (dwMilliseconds % 1000) * 1000000L;
+
+        if (ts.tv_nsec >= 1000000000L) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+    }
+
+    pthread_mutex_lock(&_mutex);
+
+    while (_bSet == FALSE && iResult != ETIMEDOUT) {
+        if (dwMilliseconds == INFINITE) {
+            pthread_cond_wait(&_cond, &_mutex);
+        } else {
+            iResult = pthread_cond_timedwait(&_cond, &_mutex, &ts);
+        }
+    }
+
+    bSet = _bSet;
+    _bSet = FALSE;
+
+    pthread_mutex_unlock(&_mutex);
+
+    return bSet;
+#endif
+}
+
+HRESULT ThreadEvent::CreateThreadEvent(ThreadEvent** ppEvent)
+{
+    ThreadEvent*    pEvent = NULL;
+#ifndef _WIN32
+    pthread_condattr_t  attr;
+#endif
+
+    if (ppEvent == NULL) {
+        return E_INVALIDARG;
+    }
+
+    pEvent = new ThreadEvent();
+
+    if (pEvent == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+#ifdef _WIN32
+    pEvent->_hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+    if (pEvent->_hEvent == NULL) {
+        delete pEvent;
+        return E_FAIL;
+    }
+#else
+    if (pthread_condattr_init(&attr) != 0) {
+        delete pEvent;
+        return E_FAIL;
+    }
+
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+
+    if (pthread_mutex_init(&pEvent->_mutex, NULL) != 0) {
+        pthread_condattr_destroy(&attr);
+        delete pEvent;
+        return E_FAIL;
+    }
+
+    if (pthread_cond_init(&pEvent->_cond, &attr) != 0) {
+        pthread_mutex_destroy(&pEvent->_mutex);
+        pthread_condattr_destroy(&attr);
+        delete pEvent;
+        return E_FAIL;
+    }
+
+    pthread_condattr_destroy(&attr);
+    pEvent->_bCreated = TRUE;
+#endif
+
+    *ppEvent = pEvent;
+    return S_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// Thread
+////////////////////////////////////////////////////////////////////////////
+
+Thread::Thread()
+    : _pfnProc(NULL),
+      _pContext(NULL),
+      _bJoined(FALSE)
+{
+#ifdef _WIN32
+    _hThread = NULL;
+#endif
+}
+
+Thread::~Thread()
+{
+    Join();
+
+#ifdef _WIN32
+    if (_hThread != NULL) {
+        CloseHandle(_hThread);
+    }
+#endif
+}
+
+VOID Thread::Join()
+{
+    if (_bJoined == TRUE) {
+        return;
+    }
+
+#ifdef _WIN32
+    WaitForSingleObject(_hThread, INFINITE);
+#else
+    pthread_join(_thread, NULL);
+#endif
+
+    _bJoined = TRUE;
+}
+
+VOID Thread::YieldThread()
+{
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+VOID Thread::SleepThread(DWORD dwMilliseconds)
+{
+#ifdef _WIN32
+    Sleep(dwMilliseconds);
+#else
+    struct timespec ts;
+
+    ts.tv_sec = dwMilliseconds / 1000;
+    ts.tv_nsec = (long) (dwMilliseconds % 1000) * 1000000L;
+
+    nanosleep(&ts, NULL);
+#endif
+}
+
+#ifdef _WIN32
+
+DWORD WINAPI Thread::ThreadProc(LPVOID lpParameter)
+{
+    Thread* pThread = (Thread*) lpParameter;
+
+    pThread->_pfnProc(pThread->_pContext);
+
+    FP_TRACE_END_THREAD();
+    return 0;
+}
+
+#else // _WIN32
+
+VOID* Thread::ThreadProc(VOID* pParameter)
+{
+    Thread* pThread = (Thread*) pParameter;
+
+    pThread->_pfnProc(pThread->_pContext);
+
+    FP_TRACE_END_THREAD();
+    return NULL;
+}
+
+#endif // _WIN32
+
+////////////////////////////////////////////////////////////////////////////
+
+HRESULT Thread::CreateThread(
+    THREADPROC  pfnProc,
+    LPVOID      pContext,
+    Thread**    ppThread)
+{
+    Thread* pThread = NULL;
+
+    if (pfnProc == NULL || ppThread == NULL) {
+        return E_INVALIDARG;
+    }
+
+    pThread = new Thread();
+
+    if (pThread == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    pThread->_pfnProc = pfnProc;
+    pThread->_pContext = pContext;
+
+#ifdef _WIN32
+    pThread->_hThread = ::CreateThread(
+        NULL,
+        0,
+        ThreadProc,
+        pThread,
+        0,
+        NULL);
+
+    if (pThread->_hThread == NULL) {
+        pThread->_bJoined = TRUE;
+        delete pThread;
+        return E_FAIL;
+    }
+#else
+    if (pthread_create(&(pThread->_thread), NULL, ThreadProc, pThread) != 0) {
+        pThread->_bJoined = TRUE;
+        delete pThread;
+        return E_FAIL;
+    }
+#endif
+
+    *ppThread = pThread;
+    return S_OK;
+}
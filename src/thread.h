@@ -0,0 +1,98 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __THREAD_H
+#define __THREAD_H
+
+#include "wintypes.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+// ThreadEvent - an auto-reset event: Set() wakes one Wait(), or the next
+// one if nobody is waiting yet
+////////////////////////////////////////////////////////////////////////////
+
+class ThreadEvent {
+public:
+    static HRESULT CreateThreadEvent(ThreadEvent** ppEvent);
+
+    ~ThreadEvent();
+
+    VOID Set();
+
+    // FALSE when dwMilliseconds ran out first; INFINITE waits for good
+    BOOL Wait(DWORD dwMilliseconds);
+
+private:
+    ThreadEvent();
+
+#ifdef _WIN32
+    HANDLE          _hEvent;
+#else
+    pthread_mutex_t _mutex;
+    pthread_cond_t  _cond;
+    BOOL            _bSet;
+    BOOL            _bCreated;
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////
+// Thread - CreateThread on Windows, pthreads everywhere else. Deleting a
+// Thread waits for it to return.
+////////////////////////////////////////////////////////////////////////////
+
+typedef VOID (*THREADPROC)(LPVOID pContext);
+
+class Thread {
+public:
+    static HRESULT CreateThread(
+        THREADPROC  pfnProc,
+        LPVOID      pContext,
+        Thread**    ppThread);
+
+    ~Thread();
+
+    VOID Join();
+
+    // Gives the rest of the time slice to another thread
+    static VOID YieldThread();
+
+    static VOID SleepThread(DWORD dwMilliseconds);
+
+private:
+    Thread();
+
+#ifdef _WIN32
+    static DWORD WINAPI ThreadProc(LPVOID lpParameter);
+#else
+    static VOID* ThreadProc(VOID* pParameter);
+#endif
+
+    THREADPROC  _pfnProc;
+    LPVOID      _pContext;
+    BOOL        _bJoined;
+
+#ifdef _WIN32
+    HANDLE      _hThread;
+#else
+    pthread_t   _thread;
+#endif
+};
+
+#endif // __THREAD_H
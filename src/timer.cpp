@@ -1,44 +0,0 @@
-/**
- * Copyright 2025 haloperidozz
- * 
- * Licensed under the Apache License, Version 2.0 (the "License");
- * you may not use this file except in compliance with the License.
- * You may obtain a copy of the License at
- * 
- *           http://www.apache.org/licenses/LICENSE-2.0
- * 
- * Unless required by applicable law or agreed to in writing, software
- * distributed under the License is distributed on an "AS IS" BASIS,
- * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- * See the License for the specific language governing permissions and
- * limitations under the License.
- */
-
-#include "timer.h"
-
-Timer::Timer()
-{
-    QueryPerformanceFrequency(&_frequency);
-    Reset();
-}
-
-VOID Timer::Tick()
-{
-    LONGLONG llElapsed;
-
-    QueryPerformanceCounter(&_currentCount);
-    llElapsed = _currentCount.QuadPart - _lastCount.QuadPart;
-    _fDeltaTime = (FLOAT) llElapsed / (FLOAT) _frequency.QuadPart;
-    _lastCount = _currentCount;
-}
-
-FLOAT Timer::GetDeltaTime() CONST
-{
-    return _fDeltaTime;
-}
-
-VOID Timer::Reset()
-{
-    QueryPerformanceCounter(&_lastCount);
-    _fDeltaTime = 0.0f;
-}
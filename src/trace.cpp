@@ -0,0 +1,400 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "atomic.h"
+#include "clock.h"
+
+#if defined(_MSC_VER)
+#define TRACE_THREAD_LOCAL  __declspec(thread)
+#else
+#define TRACE_THREAD_LOCAL  __thread
+#endif
+
+#define TRACE_WRITE_SIZE    4096
+#define TRACE_LINE_MAX      256     // Longest line WriteLine() produces
+
+typedef struct _TRACEEVENT {
+    LPCSTR      pszName;
+    LONGLONG    llStart;
+    LONGLONG    llEnd;
+} TRACEEVENT;
+
+// Who a buffer belongs to
+#define TRACE_SLOT_FREE         0       // Nobody yet
+#define TRACE_SLOT_OWNED        1       // A thread that is running
+#define TRACE_SLOT_RELEASED     2       // A thread that has ended
+
+typedef struct _TRACEBUFFER {
+    volatile LONG   lState;
+    volatile LONG   lNext;              // Events ever recorded, wraps
+    volatile LONG   lFull;              // Every slot has been written
+    LPCSTR volatile pszThreadName;
+    TRACEEVENT      events[TRACE_EVENTS];
+} TRACEBUFFER;
+
+typedef struct _TRACEWRITER {
+#ifdef _WIN32
+    HANDLE      hFile;
+#else
+    INT         fd;
+#endif
+    HRESULT     hResult;
+    SIZE_T      cbBuffered;
+    CHAR        buffer[TRACE_WRITE_SIZE];
+} TRACEWRITER;
+
+static SystemClock      s_clock;
+static TRACEBUFFER      s_buffers[TRACE_THREADS];
+
+// 1 + the buffer of this thread, 0 until it records for the first time
+// and -1 when every buffer was taken then
+static TRACE_THREAD_LOCAL LONG s_lThreadBuffer;
+
+static BOOL TakeBuffer(TRACEBUFFER* pBuffer, LONG lState)
+{
+    return AtomicCompareExchange(
+        &pBuffer->lState, lState, TRACE_SLOT_OWNED) == lState;
+}
+
+// A thread that is started over under the same name, like the render
+// thread on every show, gets its old buffer back and so stays one track.
+// Otherwise an unused buffer is taken before one of an ended thread,
+// whose events then go.
+static LONG ClaimBuffer(LPCSTR pszName)
+{
+    TRACEBUFFER*    pBuffer;
+    LONG            i;
+
+    if (pszName != NULL) {
+        for (i = 0; i < TRACE_THREADS; i++) {
+            pBuffer = &s_buffers[i];
+
+            if (pBuffer->pszThreadName != NULL &&
+                strcmp(pBuffer->pszThreadName, pszName) == 0 &&
+                TakeBuffer(pBuffer, TRACE_SLOT_RELEASED) == TRUE)
+            {
+                return i + 1;
+            }
+        }
+    }
+
+    for (i = 0; i < TRACE_THREADS; i++) {
+        if (TakeBuffer(&s_buffers[i], TRACE_SLOT_FREE) == TRUE) {
+            return i + 1;
+        }
+    }
+
+    for (i = 0; i < TRACE_THREADS; i++) {
+        pBuffer = &s_buffers[i];
+
+        if (TakeBuffer(pBuffer, TRACE_SLOT_RELEASED) == TRUE) {
+            pBuffer->pszThreadName = NULL;
+            AtomicStoreRelease(&pBuffer->lFull, 0);
+            AtomicStoreRelease(&pBuffer->lNext, 0);
+            return i + 1;
+        }
+    }
+
+    return -1;
+}
+
+static TRACEBUFFER* GetThreadBuffer(LPCSTR pszName)
+{
+    if (s_lThreadBuffer == 0) {
+        s_lThreadBuffer = ClaimBuffer(pszName);
+    }
+
+    if (s_lThreadBuffer < 0) {
+        return NULL;
+    }
+
+    return &s_buffers[s_lThreadBuffer - 1];
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+static VOID FlushWriter(TRACEWRITER* pWriter)
+{
+#ifdef _WIN32
+    DWORD   cbWritten;
+#else
+    ssize_t cbWritten;
+#endif
+
+    if (FAILED(pWriter->hResult) || pWriter->cbBuffered == 0) {
+        return;
+    }
+
+#ifdef _WIN32
+    if (WriteFile(
+            pWriter->hFile,
+            pWriter->buffer,
+            (DWORD) pWriter->cbBuffered,
+            &cbWritten,
+            NULL) == FALSE)
+    {
+        pWriter->hResult = HRESULT_FROM_WIN32(GetLastError());
+        return;
+    }
+#else
+    cbWritten = write(pWriter->fd, pWriter->buffer, pWriter->cbBuffered);
+#endif
+
+    if ((SIZE_T) cbWritten != pWriter->cbBuffered) {
+        pWriter->hResult = E_FAIL;
+        return;
+    }
+
+    pWriter->cbBuffered = 0;
+}
+
+static VOID WriteLine(TRACEWRITER* pWriter, LPCSTR pszFormat, ...)
+{
+    va_list args;
+    INT     cch;
+
+    if (pWriter->cbBuffered + TRACE_LINE_MAX > TRACE_WRITE_SIZE) {
+        FlushWriter(pWriter);
+    }
+
+    if (FAILED(pWriter->hResult)) {
+        return;
+    }
+
+    va_start(args, pszFormat);
+
+    cch = vsnprintf(
+        pWriter->buffer + pWriter->cbBuffered,
+        TRACE_LINE_MAX,
+        pszFormat,
+        args);
+
+    va_end(args);
+
+    if (cch < 0 || cch >= TRACE_LINE_MAX) {
+        pWriter->hResult = E_FAIL;
+        return;
+    }
+
+    pWriter->cbBuffered += (SIZE_T) cch;
+}
+
+// Copies what pBuffer holds, oldest first, into pEvents and returns how
+// many are left once those the thread wrote over meanwhile are dropped
+static UINT CopyEvents(TRACEBUFFER* pBuffer, TRACEEVENT* pEvents)
+{
+    ULONG       ulNext, ulLatest, i;
+    UINT        cEvents, iFirst;
+    LONGLONG    llOverwritten;
+
+    ulNext = (ULONG) AtomicLoadAcquire(&pBuffer->lNext);
+
+    cEvents = (AtomicLoadAcquire(&pBuffer->lFull) != 0)
+            ? TRACE_EVENTS
+            : (UINT) ulNext;
+
+    for (i = 0; i < cEvents; i++) {
+        pEvents[i] = pBuffer->events[
+            (ulNext - cEvents + i) & (TRACE_EVENTS - 1)];
+    }
+
+    // Every event recorded since, and the one that may be going in now,
+    // took the slot of one of the oldest
+    AtomicFence();
+    ulLatest = (ULONG) AtomicLoadAcquire(&pBuffer->lNext);
+
+    llOverwritten = (LONGLONG) cEvents + (ULONG) (ulLatest - ulNext) + 1 -
+                    TRACE_EVENTS;
+
+    if (llOverwritten <= 0) {
+        return cEvents;
+    }
+
+    if (llOverwritten >= (LONGLONG) cEvents) {
+        return 0;
+    }
+
+    iFirst = (UINT) llOverwritten;
+    memmove(pEvents, pEvents + iFirst, (cEvents - iFirst) * sizeof(*pEvents));
+
+    return cEvents - iFirst;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+LONGLONG Trace::GetTicks()
+{
+    return s_clock.GetTicks();
+}
+
+VOID Trace::Record(LPCSTR pszName, LONGLONG llStart, LONGLONG llEnd)
+{
+    TRACEBUFFER*    pBuffer = GetThreadBuffer(NULL);
+    TRACEEVENT*     pEvent;
+    ULONG           ulNext;
+
+    if (pBuffer == NULL) {
+        return;
+    }
+
+    // Only this thread ever stores it
+    ulNext = (ULONG) pBuffer->lNext;
+
+    pEvent = &pBuffer->events[ulNext & (TRACE_EVENTS - 1)];
+    pEvent->pszName = pszName;
+    pEvent->llStart = llStart;
+    pEvent->llEnd = llEnd;
+
+    if (ulNext == TRACE_EVENTS - 1) {
+        AtomicStoreRelease(&pBuffer->lFull, 1);
+    }
+
+    AtomicStoreRelease(&pBuffer->lNext, (LONG) (ulNext + 1));
+}
+
+VOID Trace::SetThreadName(LPCSTR pszName)
+{
+    TRACEBUFFER* pBuffer = GetThreadBuffer(pszName);
+
+    if (pBuffer != NULL) {
+        pBuffer->pszThreadName = pszName;
+    }
+}
+
+VOID Trace::EndThread()
+{
+    if (s_lThreadBuffer > 0) {
+        AtomicStoreRelease(
+            &s_buffers[s_lThreadBuffer - 1].lState,
+            TRACE_SLOT_RELEASED);
+    }
+
+    s_lThreadBuffer = 0;
+}
+
+HRESULT Trace::WriteJson(LPCTSTR lpszPath)
+{
+    TRACEWRITER         writer;
+    TRACEEVENT*         pEvents = NULL;
+    TRACEBUFFER*        pBuffer;
+    DOUBLE              fMicrosecondsPerTick;
+    LONG                i;
+    UINT                cEvents, j;
+    BOOL                bFirst = TRUE;
+    HRESULT             hResult;
+
+    if (lpszPath == NULL) {
+        return E_INVALIDARG;
+    }
+
+    pEvents = new TRACEEVENT[TRACE_EVENTS];
+
+    if (pEvents == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    writer.hResult = S_OK;
+    writer.cbBuffered = 0;
+
+#ifdef _WIN32
+    writer.hFile = CreateFile(
+        lpszPath,
+        GENERIC_WRITE,
+        0,
+        NULL,
+        CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL,
+        NULL);
+
+    if (writer.hFile == INVALID_HANDLE_VALUE) {
+        delete[] pEvents;
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+#else // _WIN32
+    writer.fd = open(lpszPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (writer.fd < 0) {
+        delete[] pEvents;
+        return E_FAIL;
+    }
+#endif // _WIN32
+
+    fMicrosecondsPerTick = 1000000.0 / s_clock.GetFrequency();
+
+    WriteLine(&writer, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for (i = 0; i < TRACE_THREADS; i++) {
+        pBuffer = &s_buffers[i];
+
+        if (AtomicLoadAcquire(&pBuffer->lState) == TRACE_SLOT_FREE) {
+            continue;
+        }
+
+        if (pBuffer->pszThreadName != NULL) {
+            WriteLine(
+                &writer,
+                "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                "\"tid\":%ld,\"args\":{\"name\":\"%s\"}}",
+                (bFirst == TRUE) ? "" : ",",
+                (long) i + 1,
+                pBuffer->pszThreadName);
+
+            bFirst = FALSE;
+        }
+
+        cEvents = CopyEvents(pBuffer, pEvents);
+
+        for (j = 0; j < cEvents; j++) {
+            WriteLine(
+                &writer,
+                "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%ld,"
+                "\"ts\":%.3f,\"dur\":%.3f}",
+                (bFirst == TRUE) ? "" : ",",
+                pEvents[j].pszName,
+                (long) i + 1,
+                pEvents[j].llStart * fMicrosecondsPerTick,
+                (pEvents[j].llEnd - pEvents[j].llStart) *
+                    fMicrosecondsPerTick);
+
+            bFirst = FALSE;
+        }
+    }
+
+    WriteLine(&writer, "\n]}\n");
+    FlushWriter(&writer);
+
+    hResult = writer.hResult;
+
+#ifdef _WIN32
+    CloseHandle(writer.hFile);
+#else
+    close(writer.fd);
+#endif
+
+    delete[] pEvents;
+    return hResult;
+}
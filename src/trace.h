@@ -0,0 +1,99 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TRACE_H
+#define __TRACE_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Trace
+//
+// Scoped timers for looking at frame timelines in Perfetto or
+// chrome://tracing. Each thread writes into a ring buffer of its own that
+// was set aside up front, so a scope costs two clock reads and a store,
+// and the last TRACE_EVENTS scopes of every thread are kept. A thread
+// gives its buffer back with EndThread() (Thread does it on return).
+// WriteJson() turns what the buffers hold into trace_event JSON while the
+// threads go on recording.
+//
+// Only built with FP_TRACE defined (the FP_TRACE CMake option); without
+// it the FP_TRACE_ macros expand to nothing and the Trace class does not
+// exist. Names have to be string literals: only the pointer is kept, and
+// they are written out as they are.
+////////////////////////////////////////////////////////////////////////////
+
+#ifdef FP_TRACE
+
+#define TRACE_EVENTS        16384   // Per thread, a power of two
+#define TRACE_THREADS       8       // Threads running past these are not
+                                    // traced
+
+class Trace {
+public:
+    static LONGLONG GetTicks();
+
+    // A scope of this thread that ran from llStart to llEnd
+    static VOID Record(LPCSTR pszName, LONGLONG llStart, LONGLONG llEnd);
+
+    // Shown in place of the thread number. A thread of the same name
+    // that has ended leaves its buffer to this one.
+    static VOID SetThreadName(LPCSTR pszName);
+
+    // This thread is done recording; its events are kept until another
+    // thread takes the buffer
+    static VOID EndThread();
+
+    static HRESULT WriteJson(LPCTSTR lpszPath);
+};
+
+class TraceScope {
+public:
+    TraceScope(LPCSTR pszName)
+        : _pszName(pszName),
+          _llStart(Trace::GetTicks())
+    {
+    }
+
+    ~TraceScope()
+    {
+        Trace::Record(_pszName, _llStart, Trace::GetTicks());
+    }
+
+private:
+    LPCSTR      _pszName;
+    LONGLONG    _llStart;
+};
+
+#define FP_TRACE_JOIN2(a, b)    a##b
+#define FP_TRACE_JOIN(a, b)     FP_TRACE_JOIN2(a, b)
+
+// Times the rest of the enclosing block
+#define FP_TRACE_SCOPE(name)    \
+    TraceScope FP_TRACE_JOIN(traceScope, __LINE__)(name)
+
+#define FP_TRACE_THREAD(name)   Trace::SetThreadName(name)
+#define FP_TRACE_END_THREAD()   Trace::EndThread()
+
+#else // FP_TRACE
+
+#define FP_TRACE_SCOPE(name)    ((VOID) 0)
+#define FP_TRACE_THREAD(name)   ((VOID) 0)
+#define FP_TRACE_END_THREAD()   ((VOID) 0)
+
+#endif // FP_TRACE
+
+#endif // __TRACE_H
@@ -0,0 +1,99 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TRIPLEBUFFER_H
+#define __TRIPLEBUFFER_H
+
+#include "wintypes.h"
+#include "atomic.h"
+
+////////////////////////////////////////////////////////////////////////////
+// TripleBuffer
+//
+// Hands the newest of a stream of values from exactly one writer thread
+// to exactly one reader thread without either ever waiting. The writer
+// fills its back slot and swaps it with the middle one; the reader swaps
+// its front slot with the middle one when that holds something newer.
+// The slots only change hands through that one exchange, so each side
+// owns its own slot outright, and values the reader was too slow for are
+// simply overwritten.
+////////////////////////////////////////////////////////////////////////////
+
+#define TRIPLE_BUFFER_CACHE_LINE    64
+
+#define TRIPLE_BUFFER_INDEX         0x3     // Slot of the middle buffer
+#define TRIPLE_BUFFER_FRESH         0x4     // Published, not acquired yet
+
+template<class Item>
+class TripleBuffer {
+public:
+    TripleBuffer()
+        : _uBack(0),
+          _lMiddle(1),
+          _uFront(2)
+    {
+    }
+
+    // Writer thread only
+    VOID Publish(CONST Item& item)
+    {
+        _items[_uBack] = item;
+
+        _uBack = (UINT) AtomicExchange(
+            &_lMiddle,
+            (LONG) (_uBack | TRIPLE_BUFFER_FRESH)) & TRIPLE_BUFFER_INDEX;
+    }
+
+    // Reader thread only; TRUE when GetFront() changed to a value that
+    // was published since the last call
+    BOOL Acquire()
+    {
+        if ((AtomicLoadAcquire(&_lMiddle) & TRIPLE_BUFFER_FRESH) == 0) {
+            return FALSE;
+        }
+
+        _uFront = (UINT) AtomicExchange(&_lMiddle, (LONG) _uFront) &
+                  TRIPLE_BUFFER_INDEX;
+
+        return TRUE;
+    }
+
+    // Reader thread only
+    CONST Item& GetFront() CONST
+    {
+        return _items[_uFront];
+    }
+
+private:
+    TripleBuffer(CONST TripleBuffer&);
+    TripleBuffer& operator=(CONST TripleBuffer&);
+
+    // Written by the writer
+    UINT            _uBack;
+    BYTE            _padding0[TRIPLE_BUFFER_CACHE_LINE - sizeof(UINT)];
+
+    // Swapped by both
+    volatile LONG   _lMiddle;
+    BYTE            _padding1[TRIPLE_BUFFER_CACHE_LINE - sizeof(LONG)];
+
+    // Written by the reader
+    UINT            _uFront;
+    BYTE            _padding2[TRIPLE_BUFFER_CACHE_LINE - sizeof(UINT)];
+
+    Item            _items[3];
+};
+
+#endif // __TRIPLEBUFFER_H
@@ -50,7 +50,8 @@ BOOL Tweener::Update(FLOAT fDeltaTime)
 
     _fValue = _fStart + (_fTarget - _fStart) * fEasedRatio;
 
-    return _fProgress < _fDuration;
+    return (_bInverted == TRUE) ? (_fProgress > 0.0f)
+                                : (_fProgress < _fDuration);
 }
 
 FLOAT Tweener::GetValue() CONST
@@ -17,7 +17,7 @@
 #ifndef __TWEENER_H
 #define __TWEENER_H
 
-#include <Windows.h>
+#include "wintypes.h"
 
 #include "easing.h"
 
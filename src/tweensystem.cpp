@@ -0,0 +1,624 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tweensystem.h"
+
+#include <float.h>
+#include <string.h>
+
+#include "cpu.h"
+#include "easing.h"
+
+#define HANDLE_SLOT_BITS    20
+#define HANDLE_SLOT_MASK    ((1 << HANDLE_SLOT_BITS) - 1)
+#define HANDLE_SERIAL_MASK  0xFFF
+
+////////////////////////////////////////////////////////////////////////////
+// Scalar kernels
+//
+// The SSE2 kernels in tweensystem_sse2.cpp do exactly these operations,
+// lane for lane; keep the two in step. Each block of TWEEN_BATCH tweens
+// is timed, eased in one batch call and then given its values.
+////////////////////////////////////////////////////////////////////////////
+
+static UINT AdvanceScalar(
+    FLOAT*          pfTime,
+    CONST FLOAT*    pfDuration,
+    CONST FLOAT*    pfStart,
+    CONST FLOAT*    pfChange,
+    FLOAT*          pfValue,
+    UINT            cTweens,
+    FLOAT           fDelta,
+    EASINGPROC      pfnEase)
+{
+    FLOAT   x[TWEEN_BATCH], y[TWEEN_BATCH];
+    FLOAT*  pfY;
+    FLOAT   fX;
+    UINT    uFirst, cBatch, i, cDone = 0;
+
+    for (uFirst = 0; uFirst < cTweens; uFirst += cBatch) {
+        cBatch = cTweens - uFirst;
+        cBatch = (cBatch < TWEEN_BATCH) ? cBatch : TWEEN_BATCH;
+
+        for (i = 0; i < cBatch; i++) {
+            pfTime[uFirst + i] += fDelta;
+
+            fX = pfTime[uFirst + i] / pfDuration[uFirst + i];
+            fX = (fX > 0.0f) ? fX : 0.0f;
+
+            if (fX >= 1.0f) {
+                fX = 1.0f;
+                cDone++;
+            }
+
+            x[i] = fX;
+        }
+
+        pfY = x;
+
+        if (pfnEase != NULL) {
+            pfnEase(x, y, cBatch);
+            pfY = y;
+        }
+
+        for (i = 0; i < cBatch; i++) {
+            pfValue[uFirst + i] = pfStart[uFirst + i] +
+                                  pfChange[uFirst + i] * pfY[i];
+        }
+    }
+
+    return cDone;
+}
+
+static CONST TWEENKERNELS SCALAR_TWEEN_KERNELS = {
+    TWEEN_LEVEL_SCALAR,
+    "scalar",
+    AdvanceScalar,
+    EASING_LEVEL_SCALAR
+};
+
+////////////////////////////////////////////////////////////////////////////
+
+CONST TWEENKERNELS* GetTweenKernelsForLevel(TWEENLEVEL level)
+{
+    switch (level) {
+        case TWEEN_LEVEL_SCALAR:
+            return &SCALAR_TWEEN_KERNELS;
+#ifdef FP_ARCH_X86
+        case TWEEN_LEVEL_SSE2:
+            if (GetCpuFeatures() & CPU_FEATURE_SSE2) {
+                return &SSE2_TWEEN_KERNELS;
+            }
+            break;
+#endif // FP_ARCH_X86
+        default:
+            break;
+    }
+
+    return NULL;
+}
+
+CONST TWEENKERNELS* GetTweenKernels()
+{
+    CONST TWEENKERNELS* pKernels;
+
+    pKernels = GetTweenKernelsForLevel(TWEEN_LEVEL_SSE2);
+
+    if (pKernels == NULL) {
+        pKernels = GetTweenKernelsForLevel(TWEEN_LEVEL_SCALAR);
+    }
+
+    return pKernels;
+}
+
+////////////////////////////////////////////////////////////////////////////
+// TweenSystem
+////////////////////////////////////////////////////////////////////////////
+
+static UINT MakeHandle(UINT uSerial, UINT uSlot)
+{
+    return (uSerial << HANDLE_SLOT_BITS) | uSlot;
+}
+
+static UINT NextSerial(UINT uSerial)
+{
+    return (uSerial % HANDLE_SERIAL_MASK) + 1;
+}
+
+TweenSystem::TweenSystem()
+    : _pKernels(NULL),
+      _pEasing(NULL),
+      _cCapacity(0),
+      _fTime(0.0),
+      _pfTime(NULL),
+      _pfDuration(NULL),
+      _pfStart(NULL),
+      _pfChange(NULL),
+      _pfValue(NULL),
+      _puSlot(NULL),
+      _pTweens(NULL),
+      _puFreeTweens(NULL),
+      _cFreeTweens(0),
+      _pTimelines(NULL),
+      _puFreeTimelines(NULL),
+      _cFreeTimelines(0),
+      _puFinished(NULL),
+      _cFinished(0)
+{
+    memset(_uEnd, 0, sizeof(_uEnd));
+
+    SetKernels(GetTweenKernels());
+}
+
+TweenSystem::~TweenSystem()
+{
+    delete[] _pfTime;
+    delete[] _pfDuration;
+    delete[] _pfStart;
+    delete[] _pfChange;
+    delete[] _pfValue;
+    delete[] _puSlot;
+    delete[] _pTweens;
+    delete[] _puFreeTweens;
+    delete[] _pTimelines;
+    delete[] _puFreeTimelines;
+    delete[] _puFinished;
+}
+
+HRESULT TweenSystem::CreateTweenSystem(
+    UINT            cCapacity,
+    TweenSystem**   ppSystem)
+{
+    TweenSystem*    pSystem;
+    UINT            i;
+
+    if (ppSystem == NULL || cCapacity == 0 ||
+        cCapacity > TWEEN_MAX_CAPACITY)
+    {
+        return E_INVALIDARG;
+    }
+
+    pSystem = new TweenSystem();
+
+    if (pSystem == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    pSystem->_cCapacity = cCapacity;
+
+    pSystem->_pfTime = new FLOAT[cCapacity];
+    pSystem->_pfDuration = new FLOAT[cCapacity];
+    pSystem->_pfStart = new FLOAT[cCapacity];
+    pSystem->_pfChange = new FLOAT[cCapacity];
+    pSystem->_pfValue = new FLOAT[cCapacity];
+    pSystem->_puSlot = new UINT[cCapacity];
+    pSystem->_pTweens = new TWEENSLOT[cCapacity];
+    pSystem->_puFreeTweens = new UINT[cCapacity];
+    pSystem->_pTimelines = new TIMELINESLOT[cCapacity];
+    pSystem->_puFreeTimelines = new UINT[cCapacity];
+    pSystem->_puFinished = new UINT[cCapacity];
+
+    if (pSystem->_pfTime == NULL || pSystem->_pfDuration == NULL ||
+        pSystem->_pfStart == NULL || pSystem->_pfChange == NULL ||
+        pSystem->_pfValue == NULL || pSystem->_puSlot == NULL ||
+        pSystem->_pTweens == NULL || pSystem->_puFreeTweens == NULL ||
+        pSystem->_pTimelines == NULL || pSystem->_puFreeTimelines == NULL ||
+        pSystem->_puFinished == NULL)
+    {
+        delete pSystem;
+        return E_OUTOFMEMORY;
+    }
+
+    memset(pSystem->_pTweens, 0, cCapacity * sizeof(TWEENSLOT));
+    memset(pSystem->_pTimelines, 0, cCapacity * sizeof(TIMELINESLOT));
+
+    // Lowest slots first, for the cache's sake
+    for (i = 0; i < cCapacity; i++) {
+        pSystem->_pTweens[i].uSerial = 1;
+        pSystem->_pTimelines[i].uSerial = 1;
+        pSystem->_puFreeTweens[i] = cCapacity - 1 - i;
+        pSystem->_puFreeTimelines[i] = cCapacity - 1 - i;
+    }
+
+    pSystem->_cFreeTweens = cCapacity;
+    pSystem->_cFreeTimelines = cCapacity;
+
+    *ppSystem = pSystem;
+    return S_OK;
+}
+
+TWEEN TweenSystem::Start(CONST TWEENDESC& desc)
+{
+    return Insert(desc, desc.fDelay, 0);
+}
+
+VOID TweenSystem::Stop(TWEEN tween)
+{
+    TWEENSLOT*      pTween = LookupTween(tween);
+    TIMELINESLOT*   pTimeline;
+
+    // Finished tweens go away in the next Update() on their own
+    if (pTween == NULL || pTween->bFinished == TRUE) {
+        return;
+    }
+
+    pTimeline = LookupTimeline(pTween->uTimeline);
+
+    if (pTimeline != NULL && --pTimeline->cTweens == 0) {
+        ReleaseTimeline(pTween->uTimeline & HANDLE_SLOT_MASK);
+    }
+
+    Remove(tween & HANDLE_SLOT_MASK);
+}
+
+BOOL TweenSystem::IsPlaying(TWEEN tween) CONST
+{
+    TWEENSLOT* pTween = LookupTween(tween);
+
+    return pTween != NULL && pTween->bFinished == FALSE;
+}
+
+FLOAT TweenSystem::GetValue(TWEEN tween) CONST
+{
+    TWEENSLOT* pTween = LookupTween(tween);
+
+    if (pTween == NULL) {
+        return 0.0f;
+    }
+
+    return _pfValue[pTween->uIndex];
+}
+
+TIMELINE TweenSystem::CreateTimeline(PFNTWEENDONE pfnDone, LPVOID pContext)
+{
+    TIMELINESLOT*   pTimeline;
+    UINT            uSlot;
+
+    if (_cFreeTimelines == 0) {
+        return TWEEN_NONE;
+    }
+
+    uSlot = _puFreeTimelines[--_cFreeTimelines];
+    pTimeline = &_pTimelines[uSlot];
+
+    pTimeline->cTweens = 0;
+    pTimeline->fLastStart = _fTime;
+    pTimeline->fEnd = _fTime;
+    pTimeline->pfnDone = pfnDone;
+    pTimeline->pContext = pContext;
+    pTimeline->bInUse = TRUE;
+
+    return MakeHandle(pTimeline->uSerial, uSlot);
+}
+
+TWEEN TweenSystem::Append(TIMELINE timeline, CONST TWEENDESC& desc)
+{
+    return AddToTimeline(timeline, desc, FALSE);
+}
+
+TWEEN TweenSystem::Join(TIMELINE timeline, CONST TWEENDESC& desc)
+{
+    return AddToTimeline(timeline, desc, TRUE);
+}
+
+VOID TweenSystem::StopTimeline(TIMELINE timeline)
+{
+    UINT uSlot;
+
+    if (LookupTimeline(timeline) == NULL) {
+        return;
+    }
+
+    // Rare enough to walk every slot rather than keep a list per timeline
+    for (uSlot = 0; uSlot < _cCapacity; uSlot++) {
+        if (_pTweens[uSlot].bInUse == TRUE &&
+            _pTweens[uSlot].bFinished == FALSE &&
+            _pTweens[uSlot].uTimeline == timeline)
+        {
+            Remove(uSlot);
+        }
+    }
+
+    ReleaseTimeline(timeline & HANDLE_SLOT_MASK);
+}
+
+VOID TweenSystem::Update(FLOAT fDelta)
+{
+    TWEENSLOT*      pTween;
+    TIMELINESLOT*   pTimeline;
+    UINT            uBegin, uEnd, cDone, e, i;
+
+    // Last time's finished tweens have had their final value read
+    for (i = 0; i < _cFinished; i++) {
+        Remove(_puFinished[i]);
+    }
+
+    _cFinished = 0;
+    _fTime += fDelta;
+
+    for (e = 0; e < TWEEN_EASING_COUNT; e++) {
+        uBegin = (e > 0) ? _uEnd[e - 1] : 0;
+        uEnd = _uEnd[e];
+
+        if (uBegin == uEnd) {
+            continue;
+        }
+
+        cDone = _pKernels->pfnAdvance(
+            _pfTime + uBegin,
+            _pfDuration + uBegin,
+            _pfStart + uBegin,
+            _pfChange + uBegin,
+            _pfValue + uBegin,
+            uEnd - uBegin,
+            fDelta,
+            (e == TWEEN_EASING_LINEAR) ? NULL
+                                       : _pEasing->pfnBatch[e - 1]);
+
+        // Same test as the kernels
+        for (i = uBegin; cDone > 0 && i < uEnd; i++) {
+            if (_pfTime[i] / _pfDuration[i] >= 1.0f) {
+                pTween = &_pTweens[_puSlot[i]];
+                pTween->bFinished = TRUE;
+
+                pTimeline = LookupTimeline(pTween->uTimeline);
+
+                if (pTimeline != NULL) {
+                    pTimeline->cTweens--;
+                }
+
+                _puFinished[_cFinished++] = _puSlot[i];
+                cDone--;
+            }
+        }
+    }
+
+    // Finished tweens stay put until the next Update(), so the callbacks
+    // can neither remove nor reuse them. Timelines go last, after all of
+    // their tweens' callbacks had a chance to append more.
+    for (i = 0; i < _cFinished; i++) {
+        pTween = &_pTweens[_puFinished[i]];
+
+        if (pTween->pfnDone != NULL) {
+            pTween->pfnDone(
+                pTween->pContext,
+                MakeHandle(pTween->uSerial, _puFinished[i]));
+        }
+    }
+
+    for (i = 0; i < _cFinished; i++) {
+        pTween = &_pTweens[_puFinished[i]];
+        pTimeline = LookupTimeline(pTween->uTimeline);
+
+        if (pTimeline == NULL || pTimeline->cTweens > 0) {
+            continue;
+        }
+
+        ReleaseTimeline(pTween->uTimeline & HANDLE_SLOT_MASK);
+
+        if (pTimeline->pfnDone != NULL) {
+            pTimeline->pfnDone(pTimeline->pContext, pTween->uTimeline);
+        }
+    }
+}
+
+UINT TweenSystem::GetCount() CONST
+{
+    return _uEnd[TWEEN_EASING_COUNT - 1];
+}
+
+UINT TweenSystem::GetCapacity() CONST
+{
+    return _cCapacity;
+}
+
+VOID TweenSystem::SetKernels(CONST TWEENKERNELS* pKernels)
+{
+    CONST EASINGKERNELS* pEasing;
+
+    if (pKernels == NULL) {
+        return;
+    }
+
+    pEasing = GetEasingKernelsForLevel(pKernels->easingLevel);
+
+    if (pEasing != NULL) {
+        _pKernels = pKernels;
+        _pEasing = pEasing;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+TweenSystem::TWEENSLOT* TweenSystem::LookupTween(TWEEN tween) CONST
+{
+    UINT uSlot = tween & HANDLE_SLOT_MASK;
+
+    if (uSlot >= _cCapacity || _pTweens[uSlot].bInUse == FALSE ||
+        _pTweens[uSlot].uSerial != (tween >> HANDLE_SLOT_BITS))
+    {
+        return NULL;
+    }
+
+    return &_pTweens[uSlot];
+}
+
+TweenSystem::TIMELINESLOT* TweenSystem::LookupTimeline(
+    TIMELINE timeline) CONST
+{
+    UINT uSlot = timeline & HANDLE_SLOT_MASK;
+
+    if (uSlot >= _cCapacity || _pTimelines[uSlot].bInUse == FALSE ||
+        _pTimelines[uSlot].uSerial != (timeline >> HANDLE_SLOT_BITS))
+    {
+        return NULL;
+    }
+
+    return &_pTimelines[uSlot];
+}
+
+TWEEN TweenSystem::Insert(
+    CONST TWEENDESC&    desc,
+    FLOAT               fDelay,
+    UINT                uTimeline)
+{
+    TWEENSLOT*  pTween;
+    TWEENEASING easing = desc.easing;
+    UINT        uSlot, uHole, e;
+
+    if (_cFreeTweens == 0) {
+        return TWEEN_NONE;
+    }
+
+    if ((UINT) easing >= TWEEN_EASING_COUNT) {
+        easing = TWEEN_EASING_LINEAR;
+    }
+
+    uSlot = _puFreeTweens[--_cFreeTweens];
+
+    // Every later group gives its first entry to the free space after
+    // it, which moves the space to the end of this group
+    uHole = _uEnd[TWEEN_EASING_COUNT - 1];
+
+    for (e = TWEEN_EASING_COUNT - 1; e > (UINT) easing; e--) {
+        if (_uEnd[e - 1] != uHole) {
+            MoveEntry(_uEnd[e - 1], uHole);
+        }
+
+        uHole = _uEnd[e - 1];
+        _uEnd[e]++;
+    }
+
+    _uEnd[easing]++;
+
+    // A zero duration ends on the first Update() that moves time
+    _pfTime[uHole] = -((fDelay > 0.0f) ? fDelay : 0.0f);
+    _pfDuration[uHole] = (desc.fDuration > FLT_MIN) ? desc.fDuration
+                                                    : FLT_MIN;
+    _pfStart[uHole] = desc.fStart;
+    _pfChange[uHole] = desc.fTarget - desc.fStart;
+    _pfValue[uHole] = desc.fStart;
+    _puSlot[uHole] = uSlot;
+
+    pTween = &_pTweens[uSlot];
+
+    pTween->uIndex = uHole;
+    pTween->uTimeline = uTimeline;
+    pTween->easing = easing;
+    pTween->pfnDone = desc.pfnDone;
+    pTween->pContext = desc.pContext;
+    pTween->bInUse = TRUE;
+    pTween->bFinished = FALSE;
+
+    return MakeHandle(pTween->uSerial, uSlot);
+}
+
+VOID TweenSystem::Remove(UINT uSlot)
+{
+    TWEENSLOT*  pTween = &_pTweens[uSlot];
+    UINT        uHole = pTween->uIndex;
+    UINT        uLast, e;
+
+    if (pTween->bInUse == FALSE) {
+        return;
+    }
+
+    // The reverse of Insert(): the last entry of this group fills the
+    // gap, the last of every later group the space that leaves
+    for (e = pTween->easing; e < TWEEN_EASING_COUNT; e++) {
+        uLast = _uEnd[e] - 1;
+
+        if (uLast != uHole) {
+            MoveEntry(uLast, uHole);
+        }
+
+        uHole = uLast;
+        _uEnd[e]--;
+    }
+
+    pTween->bInUse = FALSE;
+    pTween->bFinished = FALSE;
+    pTween->uSerial = NextSerial(pTween->uSerial);
+
+    _puFreeTweens[_cFreeTweens++] = uSlot;
+}
+
+VOID TweenSystem::MoveEntry(UINT uFrom, UINT uTo)
+{
+    _pfTime[uTo] = _pfTime[uFrom];
+    _pfDuration[uTo] = _pfDuration[uFrom];
+    _pfStart[uTo] = _pfStart[uFrom];
+    _pfChange[uTo] = _pfChange[uFrom];
+    _pfValue[uTo] = _pfValue[uFrom];
+    _puSlot[uTo] = _puSlot[uFrom];
+
+    _pTweens[_puSlot[uTo]].uIndex = uTo;
+}
+
+VOID TweenSystem::ReleaseTimeline(UINT uTimeline)
+{
+    TIMELINESLOT* pTimeline = &_pTimelines[uTimeline];
+
+    pTimeline->bInUse = FALSE;
+    pTimeline->uSerial = NextSerial(pTimeline->uSerial);
+
+    _puFreeTimelines[_cFreeTimelines++] = uTimeline;
+}
+
+TWEEN TweenSystem::AddToTimeline(
+    TIMELINE            timeline,
+    CONST TWEENDESC&    desc,
+    BOOL                bJoin)
+{
+    TIMELINESLOT*   pTimeline = LookupTimeline(timeline);
+    TWEEN           tween;
+    DOUBLE          fStart, fEnd;
+
+    if (pTimeline == NULL) {
+        return TWEEN_NONE;
+    }
+
+    fStart = (bJoin == TRUE) ? pTimeline->fLastStart : pTimeline->fEnd;
+
+    // Nothing starts in the past
+    if (fStart < _fTime) {
+        fStart = _fTime;
+    }
+
+    if (desc.fDelay > 0.0f) {
+        fStart += desc.fDelay;
+    }
+
+    tween = Insert(desc, (FLOAT) (fStart - _fTime), timeline);
+
+    if (tween == TWEEN_NONE) {
+        return TWEEN_NONE;
+    }
+
+    fEnd = fStart + ((desc.fDuration > 0.0f) ? desc.fDuration : 0.0f);
+
+    if (bJoin == FALSE) {
+        pTimeline->fLastStart = fStart;
+    }
+
+    if (fEnd > pTimeline->fEnd) {
+        pTimeline->fEnd = fEnd;
+    }
+
+    pTimeline->cTweens++;
+
+    return tween;
+}
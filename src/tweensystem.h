@@ -0,0 +1,225 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TWEENSYSTEM_H
+#define __TWEENSYSTEM_H
+
+#include "wintypes.h"
+#include "easing.h"
+
+////////////////////////////////////////////////////////////////////////////
+// TweenSystem
+//
+// Runs any number of tweens in one pass. A tween takes a value from
+// fStart to fTarget over fDuration seconds, after waiting fDelay. All of
+// them live in one structure of arrays, grouped by easing, so Update()
+// is a straight loop per easing over plain float arrays. There is a
+// scalar and an SSE2 kernel; both run the same float operations in the
+// same order and ease a block of tweens at a time with the batch kernels
+// of easing.h, so a tween computes exactly what a Tweener given
+// Easing::FastFunction<> of its easing would.
+//
+// Timelines put tweens one after the other or side by side: Append()
+// starts a tween once everything appended before it has finished, Join()
+// starts it together with the last one appended. Tweens and timelines
+// may each have a callback, run from Update() when they finish.
+//
+// The capacity is fixed when the system is created, so starting a tween
+// never allocates.
+////////////////////////////////////////////////////////////////////////////
+
+// Handles; 0 is never valid, and a handle is not reused for a long time
+// after its tween or timeline is gone
+typedef UINT TWEEN;
+typedef UINT TIMELINE;
+
+#define TWEEN_NONE          0
+#define TWEEN_MAX_CAPACITY  (1 << 20)
+
+// Tweens a kernel eases per batch call; a multiple of 4
+#define TWEEN_BATCH         256
+
+// Linear, then every easing of EASING_LIST: TWEEN_EASING_x is EASING_x
+// plus one
+#define TWEEN_EASING_ENUM_ENTRY(Id, Name)   TWEEN_EASING_##Id,
+
+typedef enum _TWEENEASING {
+    TWEEN_EASING_LINEAR,
+    EASING_LIST(TWEEN_EASING_ENUM_ENTRY)
+    TWEEN_EASING_COUNT
+} TWEENEASING;
+
+#undef TWEEN_EASING_ENUM_ENTRY
+
+// uHandle is the TWEEN or TIMELINE that finished
+typedef VOID (*PFNTWEENDONE)(LPVOID pContext, UINT uHandle);
+
+typedef struct _TWEENDESC {
+    FLOAT           fStart;
+    FLOAT           fTarget;
+    FLOAT           fDuration;      // Seconds
+    FLOAT           fDelay;         // Seconds
+    TWEENEASING     easing;
+    PFNTWEENDONE    pfnDone;        // May be NULL
+    LPVOID          pContext;
+} TWEENDESC;
+
+typedef enum _TWEENLEVEL {
+    TWEEN_LEVEL_SCALAR,
+    TWEEN_LEVEL_SSE2
+} TWEENLEVEL;
+
+// For each of cTweens tweens: pfTime += fDelta, then pfValue is pfStart
+// + pfChange * pfnEase(pfTime / pfDuration clamped to 0..1), with a NULL
+// pfnEase for linear. Returns how many reached the end.
+typedef UINT (*TWEENPROC)(
+    FLOAT*          pfTime,
+    CONST FLOAT*    pfDuration,
+    CONST FLOAT*    pfStart,
+    CONST FLOAT*    pfChange,
+    FLOAT*          pfValue,
+    UINT            cTweens,
+    FLOAT           fDelta,
+    EASINGPROC      pfnEase);
+
+typedef struct _TWEENKERNELS {
+    TWEENLEVEL      level;
+    LPCSTR          pszName;
+    TWEENPROC       pfnAdvance;
+    EASINGLEVEL     easingLevel;    // Batch kernels it eases with
+} TWEENKERNELS;
+
+// Best kernels for this CPU
+CONST TWEENKERNELS* GetTweenKernels();
+
+// NULL when the level is not built in or not supported by the CPU
+CONST TWEENKERNELS* GetTweenKernelsForLevel(TWEENLEVEL level);
+
+class TweenSystem {
+public:
+    // Up to cCapacity tweens and as many timelines at a time
+    static HRESULT CreateTweenSystem(UINT cCapacity, TweenSystem** ppSystem);
+
+    ~TweenSystem();
+
+    // TWEEN_NONE when the system is full
+    TWEEN Start(CONST TWEENDESC& desc);
+
+    // Without running its callback; a timeline whose last tween is
+    // stopped goes away without running its own either
+    VOID Stop(TWEEN tween);
+
+    // FALSE once the tween has finished or was stopped
+    BOOL IsPlaying(TWEEN tween) CONST;
+
+    // As of the last Update(). A tween that finished there still has its
+    // final value until the next one; 0 for anything else not playing.
+    FLOAT GetValue(TWEEN tween) CONST;
+
+    // The timeline runs its callback and goes away when its last tween
+    // finishes, so append everything before that. A timeline that never
+    // gets a tween stays until StopTimeline().
+    TIMELINE CreateTimeline(PFNTWEENDONE pfnDone, LPVOID pContext);
+
+    // TWEEN_NONE when the system is full or the timeline is gone. The
+    // tween's fDelay counts from where the timeline puts it.
+    TWEEN Append(TIMELINE timeline, CONST TWEENDESC& desc);
+    TWEEN Join(TIMELINE timeline, CONST TWEENDESC& desc);
+
+    // Stops every tween of the timeline, running no callbacks
+    VOID StopTimeline(TIMELINE timeline);
+
+    // Advances every tween by fDelta seconds, then runs the callbacks of
+    // whatever finished; callbacks may start and stop tweens
+    VOID Update(FLOAT fDelta);
+
+    // Tweens playing, plus those that finished in the last Update()
+    UINT GetCount() CONST;
+    UINT GetCapacity() CONST;
+
+    // Defaults to the best kernels for this CPU
+    VOID SetKernels(CONST TWEENKERNELS* pKernels);
+
+private:
+    typedef struct _TWEENSLOT {
+        UINT            uSerial;
+        UINT            uIndex;         // Into the arrays, when in use
+        UINT            uTimeline;      // Slot + 1, 0 for none
+        TWEENEASING     easing;
+        PFNTWEENDONE    pfnDone;
+        LPVOID          pContext;
+        BOOL            bInUse;
+        BOOL            bFinished;
+    } TWEENSLOT;
+
+    typedef struct _TIMELINESLOT {
+        UINT            uSerial;
+        UINT            cTweens;        // Not yet finished
+        DOUBLE          fLastStart;     // In system time
+        DOUBLE          fEnd;
+        PFNTWEENDONE    pfnDone;
+        LPVOID          pContext;
+        BOOL            bInUse;
+    } TIMELINESLOT;
+
+    TweenSystem();
+
+    TweenSystem(CONST TweenSystem&);
+    TweenSystem& operator=(CONST TweenSystem&);
+
+    TWEENSLOT* LookupTween(TWEEN tween) CONST;
+    TIMELINESLOT* LookupTimeline(TIMELINE timeline) CONST;
+
+    TWEEN Insert(CONST TWEENDESC& desc, FLOAT fDelay, UINT uTimeline);
+    VOID Remove(UINT uSlot);
+    VOID MoveEntry(UINT uFrom, UINT uTo);
+    VOID ReleaseTimeline(UINT uTimeline);
+    TWEEN AddToTimeline(TIMELINE timeline, CONST TWEENDESC& desc, BOOL bJoin);
+
+    CONST TWEENKERNELS* _pKernels;
+    CONST EASINGKERNELS* _pEasing;      // For _pKernels->easingLevel
+    UINT                _cCapacity;
+    DOUBLE              _fTime;         // Seconds of Update() so far
+
+    // The arrays, easing by easing: the tweens with easing e are
+    // [_uEnd[e - 1], _uEnd[e]), the first group starting at 0
+    FLOAT*              _pfTime;        // Seconds, negative while delayed
+    FLOAT*              _pfDuration;
+    FLOAT*              _pfStart;
+    FLOAT*              _pfChange;      // Target - start
+    FLOAT*              _pfValue;
+    UINT*               _puSlot;
+    UINT                _uEnd[TWEEN_EASING_COUNT];
+
+    TWEENSLOT*          _pTweens;
+    UINT*               _puFreeTweens;  // Stack of unused slots
+    UINT                _cFreeTweens;
+
+    TIMELINESLOT*       _pTimelines;
+    UINT*               _puFreeTimelines;
+    UINT                _cFreeTimelines;
+
+    // Slots that finished in the last Update(), removed by the next
+    UINT*               _puFinished;
+    UINT                _cFinished;
+};
+
+////////////////////////////////////////////////////////////////////////////
+// Per level tables, defined in tweensystem_sse2.cpp
+
+extern CONST TWEENKERNELS SSE2_TWEEN_KERNELS;
+
+#endif // __TWEENSYSTEM_H
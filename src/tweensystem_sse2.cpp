@@ -0,0 +1,178 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tweensystem.h"
+#include "cpu.h"
+
+#ifdef FP_ARCH_X86
+
+#include <emmintrin.h>
+
+////////////////////////////////////////////////////////////////////////////
+// SSE2 kernels
+//
+// Four tweens per register, straight out of the arrays. The float math
+// is the scalar kernels' from tweensystem.cpp, lane for lane, and the
+// easing is the SSE2 batch kernel. A short tail goes through the same
+// code from a padded copy.
+////////////////////////////////////////////////////////////////////////////
+
+// Tweens that reached the end, by movemask
+static CONST BYTE DONE_COUNT[16] = {
+    0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4
+};
+
+// Advances four tweens' time in place and stores where they are in
+// pfX, returning the movemask of those done
+static inline INT TimeLanes(
+    FLOAT*          pfTime,
+    CONST FLOAT*    pfDuration,
+    FLOAT*          pfX,
+    __m128          delta)
+{
+    __m128  time, x, done;
+
+    time = _mm_add_ps(_mm_loadu_ps(pfTime), delta);
+
+    x = _mm_div_ps(time, _mm_loadu_ps(pfDuration));
+    x = _mm_max_ps(x, _mm_setzero_ps());
+
+    done = _mm_cmpge_ps(x, _mm_set1_ps(1.0f));
+    x = _mm_min_ps(x, _mm_set1_ps(1.0f));
+
+    _mm_storeu_ps(pfTime, time);
+    _mm_storeu_ps(pfX, x);
+
+    return _mm_movemask_ps(done);
+}
+
+static inline VOID ValueLanes(
+    CONST FLOAT*    pfStart,
+    CONST FLOAT*    pfChange,
+    CONST FLOAT*    pfY,
+    FLOAT*          pfValue)
+{
+    _mm_storeu_ps(pfValue, _mm_add_ps(
+        _mm_loadu_ps(pfStart),
+        _mm_mul_ps(_mm_loadu_ps(pfChange), _mm_loadu_ps(pfY))));
+}
+
+// One block of at most TWEEN_BATCH tweens
+static UINT AdvanceBatch(
+    FLOAT*          pfTime,
+    CONST FLOAT*    pfDuration,
+    CONST FLOAT*    pfStart,
+    CONST FLOAT*    pfChange,
+    FLOAT*          pfValue,
+    UINT            cTweens,
+    __m128          delta,
+    EASINGPROC      pfnEase)
+{
+    FLOAT   x[TWEEN_BATCH], y[TWEEN_BATCH];
+    FLOAT   time[4], duration[4], start[4], change[4], value[4];
+    FLOAT*  pfY;
+    UINT    i, k, cLanes, cDone = 0;
+    INT     iDone;
+
+    for (i = 0; i + 4 <= cTweens; i += 4) {
+        iDone = TimeLanes(pfTime + i, pfDuration + i, x + i, delta);
+        cDone += DONE_COUNT[iDone];
+    }
+
+    // Padding lanes run a harmless tween whose result is dropped
+    cLanes = cTweens - i;
+
+    if (cLanes > 0) {
+        for (k = 0; k < 4; k++) {
+            time[k]     = (k < cLanes) ? pfTime[i + k] : 0.0f;
+            duration[k] = (k < cLanes) ? pfDuration[i + k] : 1.0f;
+        }
+
+        iDone = TimeLanes(time, duration, x + i, delta);
+        cDone += DONE_COUNT[iDone & ((1 << cLanes) - 1)];
+
+        for (k = 0; k < cLanes; k++) {
+            pfTime[i + k] = time[k];
+        }
+    }
+
+    pfY = x;
+
+    // The padding lanes too, so every lane read below was written
+    if (pfnEase != NULL) {
+        pfnEase(x, y, (cTweens + 3) & ~3U);
+        pfY = y;
+    }
+
+    for (i = 0; i + 4 <= cTweens; i += 4) {
+        ValueLanes(pfStart + i, pfChange + i, pfY + i, pfValue + i);
+    }
+
+    if (cLanes > 0) {
+        for (k = 0; k < 4; k++) {
+            start[k]  = (k < cLanes) ? pfStart[i + k] : 0.0f;
+            change[k] = (k < cLanes) ? pfChange[i + k] : 0.0f;
+        }
+
+        ValueLanes(start, change, pfY + i, value);
+
+        for (k = 0; k < cLanes; k++) {
+            pfValue[i + k] = value[k];
+        }
+    }
+
+    return cDone;
+}
+
+static UINT AdvanceSse2(
+    FLOAT*          pfTime,
+    CONST FLOAT*    pfDuration,
+    CONST FLOAT*    pfStart,
+    CONST FLOAT*    pfChange,
+    FLOAT*          pfValue,
+    UINT            cTweens,
+    FLOAT           fDelta,
+    EASINGPROC      pfnEase)
+{
+    __m128  delta = _mm_set1_ps(fDelta);
+    UINT    uFirst, cBatch, cDone = 0;
+
+    for (uFirst = 0; uFirst < cTweens; uFirst += cBatch) {
+        cBatch = cTweens - uFirst;
+        cBatch = (cBatch < TWEEN_BATCH) ? cBatch : TWEEN_BATCH;
+
+        cDone += AdvanceBatch(
+            pfTime + uFirst,
+            pfDuration + uFirst,
+            pfStart + uFirst,
+            pfChange + uFirst,
+            pfValue + uFirst,
+            cBatch,
+            delta,
+            pfnEase);
+    }
+
+    return cDone;
+}
+
+CONST TWEENKERNELS SSE2_TWEEN_KERNELS = {
+    TWEEN_LEVEL_SSE2,
+    "sse2",
+    AdvanceSse2,
+    EASING_LEVEL_SSE2
+};
+
+#endif // FP_ARCH_X86
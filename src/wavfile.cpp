@@ -0,0 +1,108 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wavfile.h"
+
+#include <string.h>
+
+static UINT ReadLE16(CONST BYTE* pb)
+{
+    return (UINT) pb[0] | ((UINT) pb[1] << 8);
+}
+
+static UINT ReadLE32(CONST BYTE* pb)
+{
+    return (UINT) pb[0] | ((UINT) pb[1] << 8) |
+           ((UINT) pb[2] << 16) | ((UINT) pb[3] << 24);
+}
+
+HRESULT ParseWav(CONST BYTE* pbFile, SIZE_T cbFile, WAVINFO* pInfo)
+{
+    SIZE_T  cbOffset = 12;
+    SIZE_T  cbChunk;
+    BOOL    bFormat = FALSE;
+
+    if (pbFile == NULL || pInfo == NULL) {
+        return E_INVALIDARG;
+    }
+
+    if (cbFile < 12 ||
+        memcmp(pbFile, "RIFF", 4) != 0 ||
+        memcmp(pbFile + 8, "WAVE", 4) != 0)
+    {
+        return E_INVALIDARG;
+    }
+
+    memset(pInfo, 0, sizeof(WAVINFO));
+
+    while (cbFile - cbOffset >= 8) {
+        cbChunk = ReadLE32(pbFile + cbOffset + 4);
+
+        if (memcmp(pbFile + cbOffset, "fmt ", 4) == 0) {
+            if (cbChunk < 16 || cbChunk > cbFile - cbOffset - 8) {
+                return E_INVALIDARG;
+            }
+
+            pInfo->uFormatTag = ReadLE16(pbFile + cbOffset + 8);
+            pInfo->cChannels = ReadLE16(pbFile + cbOffset + 10);
+            pInfo->uSampleRate = ReadLE32(pbFile + cbOffset + 12);
+            pInfo->cbBlockAlign = ReadLE16(pbFile + cbOffset + 20);
+            pInfo->cBitsPerSample = ReadLE16(pbFile + cbOffset + 22);
+
+            // WAVEFORMATEXTENSIBLE keeps the real tag in the first two
+            // bytes of the subformat GUID
+            if (pInfo->uFormatTag == WAV_FORMAT_EXTENSIBLE) {
+                if (cbChunk < 40) {
+                    return E_INVALIDARG;
+                }
+
+                pInfo->uFormatTag = ReadLE16(pbFile + cbOffset + 32);
+            }
+
+            if (pInfo->cbBlockAlign == 0) {
+                return E_INVALIDARG;
+            }
+
+            bFormat = TRUE;
+        } else if (memcmp(pbFile + cbOffset, "data", 4) == 0) {
+            if (bFormat == FALSE) {
+                return E_INVALIDARG;
+            }
+
+            // Writers that stream leave the size at 0 or 0xFFFFFFFF,
+            // take whatever is there
+            if (cbChunk == 0 || cbChunk > cbFile - cbOffset - 8) {
+                cbChunk = cbFile - cbOffset - 8;
+            }
+
+            pInfo->pbData = pbFile + cbOffset + 8;
+            pInfo->cbData = cbChunk;
+            pInfo->cFrames = (UINT) (cbChunk / pInfo->cbBlockAlign);
+
+            return S_OK;
+        }
+
+        // Chunks are padded to an even size; one that runs past the end,
+        // pad included, ends the scan
+        if (cbChunk + (cbChunk & 1) > cbFile - cbOffset - 8) {
+            break;
+        }
+
+        cbOffset += 8 + cbChunk + (cbChunk & 1);
+    }
+
+    return E_INVALIDARG;
+}
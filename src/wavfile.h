@@ -0,0 +1,47 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WAVFILE_H
+#define __WAVFILE_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// RIFF/WAVE parsing
+//
+// Only walks the chunk headers: the result points into the caller's
+// buffer, nothing is copied or decoded.
+////////////////////////////////////////////////////////////////////////////
+
+#define WAV_FORMAT_PCM          0x0001
+#define WAV_FORMAT_FLOAT        0x0003
+#define WAV_FORMAT_EXTENSIBLE   0xFFFE
+
+typedef struct _WAVINFO {
+    UINT            uFormatTag;     // WAV_FORMAT_PCM or _FLOAT, never
+                                    // _EXTENSIBLE
+    UINT            cChannels;
+    UINT            uSampleRate;
+    UINT            cbBlockAlign;
+    UINT            cBitsPerSample;
+    UINT            cFrames;
+    CONST BYTE*     pbData;         // Inside the parsed buffer
+    SIZE_T          cbData;
+} WAVINFO;
+
+HRESULT ParseWav(CONST BYTE* pbFile, SIZE_T cbFile, WAVINFO* pInfo);
+
+#endif // __WAVFILE_H
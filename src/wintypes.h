@@ -0,0 +1,98 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __WINTYPES_H
+#define __WINTYPES_H
+
+////////////////////////////////////////////////////////////////////////////
+// Portable modules are written against the Win32 type names. On Windows
+// they come from <Windows.h>, everywhere else the subset below is enough.
+////////////////////////////////////////////////////////////////////////////
+
+#ifdef _WIN32
+
+#include <Windows.h>
+
+#else // _WIN32
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define VOID            void
+#define CONST           const
+
+#define TRUE            1
+#define FALSE           0
+
+#define INFINITE        0xFFFFFFFF
+
+typedef int             BOOL;
+typedef char            CHAR;
+typedef short           SHORT;
+typedef int             INT;
+typedef int32_t         LONG;
+typedef int64_t         LONGLONG;
+typedef float           FLOAT;
+typedef double          DOUBLE;
+
+typedef unsigned char   BYTE;
+typedef unsigned short  WORD;
+typedef unsigned int    UINT;
+typedef uint32_t        DWORD;
+typedef uint32_t        ULONG;
+typedef uint64_t        ULONGLONG;
+
+typedef int8_t          INT8;
+typedef int16_t         INT16;
+typedef int32_t         INT32;
+typedef int64_t         INT64;
+typedef uint8_t         UINT8;
+typedef uint16_t        UINT16;
+typedef uint32_t        UINT32;
+typedef uint64_t        UINT64;
+
+typedef size_t          SIZE_T;
+
+typedef void*           LPVOID;
+typedef CONST void*     LPCVOID;
+typedef CHAR*           LPSTR;
+typedef CONST CHAR*     LPCSTR;
+typedef CHAR            TCHAR;
+typedef CONST TCHAR*    LPCTSTR;
+typedef BYTE*           LPBYTE;
+typedef DWORD*          LPDWORD;
+
+typedef int32_t         HRESULT;
+
+#define S_OK            ((HRESULT) 0x00000000)
+#define S_FALSE         ((HRESULT) 0x00000001)
+#define E_NOTIMPL       ((HRESULT) 0x80004001)
+#define E_POINTER       ((HRESULT) 0x80004003)
+#define E_FAIL          ((HRESULT) 0x80004005)
+#define E_UNEXPECTED    ((HRESULT) 0x8000FFFF)
+#define E_OUTOFMEMORY   ((HRESULT) 0x8007000E)
+#define E_INVALIDARG    ((HRESULT) 0x80070057)
+
+#define SUCCEEDED(hr)   (((HRESULT) (hr)) >= 0)
+#define FAILED(hr)      (((HRESULT) (hr)) < 0)
+
+#define ARRAYSIZE(a)    (sizeof(a) / sizeof((a)[0]))
+
+#define TEXT(s)         s
+
+#endif // _WIN32
+
+#endif // __WINTYPES_H
@@ -0,0 +1,105 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+
+typedef struct _TESTSUITE {
+    LPCSTR  pszName;
+    VOID    (*pfnRun)();
+} TESTSUITE;
+
+static CONST TESTSUITE SUITES[] = {
+    { "blit",        TestBlit },
+    { "damage",      TestDamage },
+    { "delta",       TestDeltaAccumulator },
+    { "easing",      TestEasing },
+    { "engine",      TestEngine },
+    { "geometry",    TestGeometry },
+    { "inputtrace",  TestInputTrace },
+    { "mipchain",    TestMipChain },
+    { "mixer",       TestMixer },
+    { "pointer",     TestPointer },
+    { "predictor",   TestPredictor },
+    { "queue",       TestQueue },
+    { "render",      TestRender },
+    { "resample",    TestResample },
+    { "scheduler",   TestScheduler },
+    { "simulation",  TestSimulation },
+    { "spritecache", TestSpriteCache },
+    { "stream",      TestStream },
+    { "trace",       TestTrace },
+    { "tween",       TestTween },
+    { "wav",         TestWav }
+};
+
+// Usage: fp_test [suite...]
+int main(int argc, char** argv)
+{
+    UINT    i, cFailures, cChecks;
+    INT     iResult = 0;
+    int     j;
+    BOOL    bSelected, bFound;
+
+    for (j = 1; j < argc; j++) {
+        bFound = FALSE;
+
+        for (i = 0; i < ARRAYSIZE(SUITES); i++) {
+            if (strcmp(argv[j], SUITES[i].pszName) == 0) {
+                bFound = TRUE;
+            }
+        }
+
+        if (bFound == FALSE) {
+            fprintf(stderr, "fp_test: no suite %s\n", argv[j]);
+            return 1;
+        }
+    }
+
+    for (i = 0; i < ARRAYSIZE(SUITES); i++) {
+        bSelected = (argc < 2);
+
+        for (j = 1; j < argc; j++) {
+            if (strcmp(argv[j], SUITES[i].pszName) == 0) {
+                bSelected = TRUE;
+            }
+        }
+
+        if (bSelected == FALSE) {
+            continue;
+        }
+
+        cChecks = TestGetChecks();
+        cFailures = TestGetFailures();
+
+        SUITES[i].pfnRun();
+
+        cChecks = TestGetChecks() - cChecks;
+        cFailures = TestGetFailures() - cFailures;
+
+        printf("%s: %u checks, %u failed\n",
+               SUITES[i].pszName, cChecks, cFailures);
+
+        if (cFailures != 0) {
+            fprintf(stderr, "%s: FAILED\n", SUITES[i].pszName);
+            iResult = 1;
+        }
+    }
+
+    return iResult;
+}
@@ -0,0 +1,81 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static UINT s_cChecks;
+static UINT s_cFailures;
+
+static VOID PutLE(BYTE* pb, UINT uValue, UINT cb)
+{
+    UINT i;
+
+    for (i = 0; i < cb; i++) {
+        pb[i] = (BYTE) (uValue >> (i * 8));
+    }
+}
+
+BOOL TestCheck(BOOL bPassed, LPCSTR pszCondition, LPCSTR pszFile, INT iLine)
+{
+    s_cChecks++;
+
+    if (bPassed == FALSE) {
+        s_cFailures++;
+        printf("%s:%d: check failed: %s\n", pszFile, iLine, pszCondition);
+    }
+
+    return bPassed;
+}
+
+UINT TestGetChecks()
+{
+    return s_cChecks;
+}
+
+UINT TestGetFailures()
+{
+    return s_cFailures;
+}
+
+VOID TestMakeWav(
+    BYTE*   pbFile,
+    UINT    cFrames,
+    UINT    cChannels,
+    UINT    uSampleRate)
+{
+    UINT    cbData = cFrames * cChannels * 2;
+    UINT    i;
+
+    memcpy(pbFile, "RIFF", 4);
+    PutLE(pbFile + 4, TEST_WAV_HEADER - 8 + cbData, 4);
+    memcpy(pbFile + 8, "WAVEfmt ", 8);
+    PutLE(pbFile + 16, 16, 4);
+    PutLE(pbFile + 20, 1, 2);
+    PutLE(pbFile + 22, cChannels, 2);
+    PutLE(pbFile + 24, uSampleRate, 4);
+    PutLE(pbFile + 28, uSampleRate * cChannels * 2, 4);
+    PutLE(pbFile + 32, cChannels * 2, 2);
+    PutLE(pbFile + 34, 16, 2);
+    memcpy(pbFile + 36, "data", 4);
+    PutLE(pbFile + 40, cbData, 4);
+
+    for (i = 0; i < cbData / 2; i++) {
+        PutLE(pbFile + TEST_WAV_HEADER + i * 2, (UINT) (SHORT) (i * 7), 2);
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TEST_H
+#define __TEST_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// Minimal test harness for fp_test
+//
+// A suite is a function that makes its checks with TEST_CHECK; it fails
+// when any of them did. Every suite is its own CTest test.
+////////////////////////////////////////////////////////////////////////////
+
+// Prints the condition and where it is when it does not hold; evaluates
+// to the condition, so a suite can stop when the rest depends on it
+#define TEST_CHECK(condition)   \
+    TestCheck((condition) ? TRUE : FALSE, #condition, __FILE__, __LINE__)
+
+BOOL TestCheck(BOOL bPassed, LPCSTR pszCondition, LPCSTR pszFile, INT iLine);
+
+// Checks made and failed since the start
+UINT TestGetChecks();
+UINT TestGetFailures();
+
+// A 16-bit PCM WAV of cFrames frames in pbFile, which has to hold
+// TEST_WAV_SIZE(cFrames, cChannels) bytes; sample i is (SHORT) (i * 7)
+#define TEST_WAV_HEADER                 44
+#define TEST_WAV_SIZE(cFrames, cChannels)   \
+    (TEST_WAV_HEADER + (cFrames) * (cChannels) * 2)
+
+VOID TestMakeWav(
+    BYTE*   pbFile,
+    UINT    cFrames,
+    UINT    cChannels,
+    UINT    uSampleRate);
+
+////////////////////////////////////////////////////////////////////////////
+// Suites
+
+VOID TestBlit();
+VOID TestDamage();
+VOID TestDeltaAccumulator();
+VOID TestEasing();
+VOID TestEngine();
+VOID TestGeometry();
+VOID TestInputTrace();
+VOID TestMipChain();
+VOID TestMixer();
+VOID TestPointer();
+VOID TestPredictor();
+VOID TestQueue();
+VOID TestRender();
+VOID TestResample();
+VOID TestScheduler();
+VOID TestSimulation();
+VOID TestSpriteCache();
+VOID TestStream();
+VOID TestTrace();
+VOID TestTween();
+VOID TestWav();
+
+#endif // __TEST_H
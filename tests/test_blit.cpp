@@ -0,0 +1,303 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "blit.h"
+#include "softwarerendersink.h"
+
+#define SOURCE_SIZE     256
+#define TARGET_SIZE     1024
+
+#define RANDOM_DRAWS    64
+
+// An ellipse whose right end falls half way into a pixel
+#define ELLIPSE_TARGET  64
+#define ELLIPSE_X       32.0f
+#define ELLIPSE_Y       32.0f
+#define ELLIPSE_RX      20.5f
+#define ELLIPSE_RY      12.0f
+
+static UINT NextRandom(UINT* puState)
+{
+    *puState = *puState * 1664525 + 1013904223;
+    return *puState >> 8;
+}
+
+static FLOAT RandomRange(UINT* puState, FLOAT fMin, FLOAT fMax)
+{
+    return fMin + (fMax - fMin) * (NextRandom(puState) & 0xFFFF) / 65535.0f;
+}
+
+// A premultiplied gradient with holes, so every alpha path is taken
+static VOID FillSource(BYTE* pbPixels)
+{
+    UINT x, y, a;
+    BYTE* pb;
+
+    for (y = 0; y < SOURCE_SIZE; y++) {
+        for (x = 0; x < SOURCE_SIZE; x++) {
+            pb = pbPixels + (y * SOURCE_SIZE + x) * 4;
+            a  = ((x / 16 + y / 16) % 5 == 0) ? 0 : (x ^ y) & 0xFF;
+
+            pb[0] = (BYTE) (x * a / 255);
+            pb[1] = (BYTE) (y * a / 255);
+            pb[2] = (BYTE) ((255 - x) * a / 255);
+            pb[3] = (BYTE) a;
+        }
+    }
+}
+
+static HRESULT CreateTarget(
+    CONST BYTE*             pbSource,
+    SoftwareRenderSink**    ppSink,
+    RenderBitmap**          ppBitmap)
+{
+    HRESULT hResult;
+
+    hResult = SoftwareRenderSink::CreateSoftwareRenderSink(
+        TARGET_SIZE, TARGET_SIZE, ppSink);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    hResult = (*ppSink)->CreateBitmap(
+        SOURCE_SIZE, SOURCE_SIZE, SOURCE_SIZE * 4, pbSource, ppBitmap);
+
+    if (FAILED(hResult)) {
+        delete *ppSink;
+    }
+
+    return hResult;
+}
+
+// Draws the same random scene with the given kernels
+static VOID DrawScene(
+    SoftwareRenderSink* pSink,
+    RenderBitmap*       pBitmap,
+    CONST BLITKERNELS*  pKernels)
+{
+    Geometry::Matrix    transform;
+    Geometry::Point     center = Geometry::MakePoint(
+        SOURCE_SIZE / 2.0f, SOURCE_SIZE / 2.0f);
+    UINT                uState = 1;
+    UINT                i;
+    FLOAT               fScale;
+
+    pSink->SetBlitKernels(pKernels);
+    pSink->BeginDraw();
+
+    for (i = 0; i < RANDOM_DRAWS; i++) {
+        fScale = RandomRange(&uState, 0.3f, 3.0f);
+
+        transform = Geometry::Multiply(
+            Geometry::Scale(Geometry::MakeSize(
+                (i % 7 == 0) ? -fScale : fScale,
+                RandomRange(&uState, 0.3f, 3.0f)), center),
+            Geometry::Rotation(
+                (i % 3 == 0) ? 0.0f : RandomRange(&uState, -180.0f, 180.0f),
+                center));
+
+        transform = Geometry::Multiply(transform, Geometry::Translation(
+            (i % 4 == 0) ? (FLOAT) (NextRandom(&uState) % 900) - 200.0f
+                         : RandomRange(&uState, -200.0f, 900.0f),
+            (i % 4 == 0) ? (FLOAT) (NextRandom(&uState) % 900) - 200.0f
+                         : RandomRange(&uState, -200.0f, 900.0f)));
+
+        pSink->DrawBitmap(pBitmap, transform, RandomRange(&uState, 0.2f, 1.0f));
+    }
+
+    pSink->EndDraw();
+}
+
+// Every level draws the scalar kernels' frame to the byte, so switching
+// levels never changes what is on screen
+static VOID CheckLevel(CONST BYTE* pbSource, CONST BLITKERNELS* pKernels)
+{
+    SoftwareRenderSink* pReference = NULL;
+    SoftwareRenderSink* pSink = NULL;
+    RenderBitmap*       pReferenceBitmap = NULL;
+    RenderBitmap*       pBitmap = NULL;
+
+    if (TEST_CHECK(SUCCEEDED(CreateTarget(
+            pbSource, &pReference, &pReferenceBitmap))) == FALSE)
+    {
+        return;
+    }
+
+    if (TEST_CHECK(SUCCEEDED(
+            CreateTarget(pbSource, &pSink, &pBitmap))) == FALSE)
+    {
+        goto cleanup;
+    }
+
+    DrawScene(pReference, pReferenceBitmap,
+              GetBlitKernelsForLevel(BLIT_LEVEL_SCALAR));
+    DrawScene(pSink, pBitmap, pKernels);
+
+    TEST_CHECK(memcmp(pReference->GetPixels(),
+                      pSink->GetPixels(),
+                      (SIZE_T) pSink->GetStride() * pSink->GetHeight()) == 0);
+
+cleanup:
+    delete pBitmap;
+    delete pSink;
+    delete pReferenceBitmap;
+    delete pReference;
+}
+
+// A whole-pixel offset at full opacity copies the source over a clear
+// target
+static VOID CheckTranslate(CONST BYTE* pbSource, CONST BLITKERNELS* pKernels)
+{
+    SoftwareRenderSink* pSink = NULL;
+    RenderBitmap*       pBitmap = NULL;
+    CONST BYTE*         pbRow;
+    UINT                y, cDiffer = 0;
+
+    if (TEST_CHECK(SUCCEEDED(
+            CreateTarget(pbSource, &pSink, &pBitmap))) == FALSE)
+    {
+        return;
+    }
+
+    pSink->SetBlitKernels(pKernels);
+    pSink->BeginDraw();
+    pSink->Clear();
+    pSink->DrawBitmap(pBitmap, Geometry::Translation(300.0f, 200.0f), 1.0f);
+    pSink->EndDraw();
+
+    for (y = 0; y < SOURCE_SIZE; y++) {
+        pbRow = pSink->GetPixels() + (SIZE_T) (y + 200) * pSink->GetStride();
+
+        if (memcmp(pbRow + 300 * 4,
+                   pbSource + y * SOURCE_SIZE * 4,
+                   SOURCE_SIZE * 4) != 0)
+        {
+            cDiffer++;
+        }
+    }
+
+    TEST_CHECK(cDiffer == 0);
+
+    delete pBitmap;
+    delete pSink;
+}
+
+static HRESULT DrawEllipse(SoftwareRenderSink** ppSink)
+{
+    RENDERCOLOR color = { 1.0f, 0.5f, 0.25f, 1.0f };
+    HRESULT     hResult;
+
+    hResult = SoftwareRenderSink::CreateSoftwareRenderSink(
+        ELLIPSE_TARGET, ELLIPSE_TARGET, ppSink);
+
+    if (FAILED(hResult)) {
+        return hResult;
+    }
+
+    (*ppSink)->BeginDraw();
+    (*ppSink)->Clear();
+    (*ppSink)->FillEllipse(
+        Geometry::MakePoint(ELLIPSE_X, ELLIPSE_Y),
+        ELLIPSE_RX,
+        ELLIPSE_RY,
+        color);
+
+    return (*ppSink)->EndDraw();
+}
+
+static BYTE GetAlpha(CONST SoftwareRenderSink* pSink, UINT x, UINT y)
+{
+    return pSink->GetPixels()[(SIZE_T) y * pSink->GetStride() + x * 4 + 3];
+}
+
+// The same ellipse comes out the same to the byte; inside it is solid,
+// the corners of its box stay clear and its rim is blended
+static VOID CheckEllipse()
+{
+    SoftwareRenderSink* pReference = NULL;
+    SoftwareRenderSink* pSink = NULL;
+    UINT                uLeft, uTop, uRight, uBottom, uAlpha;
+
+    if (TEST_CHECK(SUCCEEDED(DrawEllipse(&pReference))) == FALSE ||
+        TEST_CHECK(SUCCEEDED(DrawEllipse(&pSink))) == FALSE)
+    {
+        goto cleanup;
+    }
+
+    TEST_CHECK(memcmp(pReference->GetPixels(),
+                      pSink->GetPixels(),
+                      (SIZE_T) pSink->GetStride() * pSink->GetHeight()) == 0);
+
+    uLeft   = (UINT) (ELLIPSE_X - ELLIPSE_RX);
+    uTop    = (UINT) (ELLIPSE_Y - ELLIPSE_RY);
+    uRight  = (UINT) (ELLIPSE_X + ELLIPSE_RX);
+    uBottom = (UINT) (ELLIPSE_Y + ELLIPSE_RY) - 1;
+
+    TEST_CHECK(GetAlpha(pSink, (UINT) ELLIPSE_X, (UINT) ELLIPSE_Y) == 255);
+    TEST_CHECK(GetAlpha(pSink, (UINT) ELLIPSE_X - 1,
+                        (UINT) ELLIPSE_Y - 1) == 255);
+
+    TEST_CHECK(GetAlpha(pSink, uLeft, uTop) == 0);
+    TEST_CHECK(GetAlpha(pSink, uRight, uTop) == 0);
+    TEST_CHECK(GetAlpha(pSink, uLeft, uBottom) == 0);
+    TEST_CHECK(GetAlpha(pSink, uRight, uBottom) == 0);
+
+    // The rim pixel on the long axis is about half inside
+    uAlpha = GetAlpha(pSink, uRight, (UINT) ELLIPSE_Y);
+
+    TEST_CHECK(uAlpha > 0 && uAlpha < 255);
+    TEST_CHECK(GetAlpha(pSink, uRight + 1, (UINT) ELLIPSE_Y) == 0);
+
+cleanup:
+    delete pSink;
+    delete pReference;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestBlit()
+{
+    static CONST BLITLEVEL levels[] = {
+        BLIT_LEVEL_SCALAR,
+        BLIT_LEVEL_SSE2,
+        BLIT_LEVEL_AVX2
+    };
+
+    static BYTE         source[SOURCE_SIZE * SOURCE_SIZE * 4];
+    CONST BLITKERNELS*  pKernels;
+    UINT                i;
+
+    FillSource(source);
+    CheckEllipse();
+
+    for (i = 0; i < ARRAYSIZE(levels); i++) {
+        pKernels = GetBlitKernelsForLevel(levels[i]);
+
+        if (pKernels == NULL) {
+            continue;
+        }
+
+        CheckTranslate(source, pKernels);
+
+        if (levels[i] != BLIT_LEVEL_SCALAR) {
+            CheckLevel(source, pKernels);
+        }
+    }
+}
@@ -0,0 +1,198 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test.h"
+#include "damage.h"
+
+#define SURFACE_WIDTH   800.0f
+#define SURFACE_HEIGHT  600.0f
+
+static BOOL IsRect(
+    CONST Geometry::Rect&   rect,
+    FLOAT                   left,
+    FLOAT                   top,
+    FLOAT                   right,
+    FLOAT                   bottom)
+{
+    return rect.left == left && rect.top == top &&
+           rect.right == right && rect.bottom == bottom;
+}
+
+static BOOL Contains(CONST Geometry::Rect& outer, CONST Geometry::Rect& inner)
+{
+    return outer.left <= inner.left && outer.top <= inner.top &&
+           outer.right >= inner.right && outer.bottom >= inner.bottom;
+}
+
+// Whether the damaged rectangles cover all of rect
+static BOOL IsCovered(CONST DamageTracker& tracker, CONST Geometry::Rect& rect)
+{
+    CONST Geometry::Rect*   pRects = tracker.GetRects();
+    UINT                    i;
+
+    for (i = 0; i < tracker.GetRectCount(); i++) {
+        if (Contains(pRects[i], rect)) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+// A tracker that has drawn slot 0 at bounds and presented
+static VOID Start(DamageTracker* pTracker, CONST Geometry::Rect& bounds)
+{
+    pTracker->SetSurfaceSize(SURFACE_WIDTH, SURFACE_HEIGHT);
+    pTracker->Track(0, bounds);
+    pTracker->Reset();
+}
+
+static VOID CheckFullFrame()
+{
+    DamageTracker tracker;
+
+    tracker.SetSurfaceSize(SURFACE_WIDTH, SURFACE_HEIGHT);
+
+    TEST_CHECK(tracker.GetRectCount() == 1);
+    TEST_CHECK(IsRect(
+        tracker.GetRects()[0], 0.0f, 0.0f, SURFACE_WIDTH, SURFACE_HEIGHT));
+
+    // Nothing tracked after a reset is nothing to draw
+    tracker.Reset();
+    TEST_CHECK(tracker.GetRectCount() == 0);
+
+    tracker.InvalidateAll();
+    TEST_CHECK(tracker.GetRectCount() == 1);
+
+    // A slot it does not have redraws everything
+    tracker.Reset();
+    tracker.Track(DAMAGE_MAX_SLOTS, Geometry::MakeRect(0, 0, 1, 1));
+    TEST_CHECK(tracker.GetRectCount() == 1);
+    TEST_CHECK(IsRect(
+        tracker.GetBounds(), 0.0f, 0.0f, SURFACE_WIDTH, SURFACE_HEIGHT));
+}
+
+static VOID CheckTrackReset()
+{
+    DamageTracker   tracker;
+    Geometry::Rect  bounds = Geometry::MakeRect(100, 100, 150, 150);
+
+    Start(&tracker, bounds);
+
+    // Same bounds as last frame, nothing moved
+    tracker.Track(0, bounds);
+    TEST_CHECK(tracker.GetRectCount() == 0);
+
+    tracker.Track(0, Geometry::MakeRect(300, 300, 350, 350));
+    TEST_CHECK(tracker.GetRectCount() == 2);
+
+    // Reset forgets the damage but not where the slot is
+    tracker.Reset();
+    TEST_CHECK(tracker.GetRectCount() == 0);
+
+    tracker.Track(0, Geometry::MakeRect(300, 300, 350, 350));
+    TEST_CHECK(tracker.GetRectCount() == 0);
+}
+
+static VOID CheckMerge()
+{
+    DamageTracker tracker;
+
+    Start(&tracker, Geometry::MakeRect(10, 10, 20, 20));
+
+    // Old and new bounds overlap: one rectangle with a pixel of slack
+    tracker.Track(0, Geometry::MakeRect(15, 15, 25, 25));
+
+    TEST_CHECK(tracker.GetRectCount() == 1);
+    TEST_CHECK(IsRect(tracker.GetRects()[0], 9, 9, 26, 26));
+
+    // Far apart: two
+    tracker.Reset();
+    tracker.Track(0, Geometry::MakeRect(400, 300, 410, 310));
+
+    TEST_CHECK(tracker.GetRectCount() == 2);
+    TEST_CHECK(IsCovered(tracker, Geometry::MakeRect(15, 15, 25, 25)));
+    TEST_CHECK(IsCovered(tracker, Geometry::MakeRect(400, 300, 410, 310)));
+
+    // A third that bridges both swallows them
+    tracker.Track(1, Geometry::MakeRect(20, 20, 405, 305));
+
+    TEST_CHECK(tracker.GetRectCount() == 1);
+    TEST_CHECK(IsRect(tracker.GetRects()[0], 14, 14, 411, 311));
+}
+
+static VOID CheckClip()
+{
+    DamageTracker tracker;
+
+    Start(&tracker, Geometry::MakeRect(-50, -50, 10.5f, 10.5f));
+
+    tracker.Track(0, Geometry::MakeRect(790, 590, 850, 650));
+
+    TEST_CHECK(tracker.GetRectCount() == 2);
+    TEST_CHECK(IsCovered(tracker, Geometry::MakeRect(0, 0, 12, 12)));
+    TEST_CHECK(IsCovered(tracker, Geometry::MakeRect(789, 589, 800, 600)));
+    TEST_CHECK(Contains(
+        Geometry::MakeRect(0, 0, SURFACE_WIDTH, SURFACE_HEIGHT),
+        tracker.GetBounds()));
+
+    // Entirely off the surface is no damage at all
+    tracker.Reset();
+    tracker.Track(1, Geometry::MakeRect(-100, -100, -60, -60));
+    tracker.Track(1, Geometry::MakeRect(900, 700, 950, 750));
+
+    TEST_CHECK(tracker.GetRectCount() == 0);
+}
+
+static VOID CheckRectLimit()
+{
+    DamageTracker   tracker;
+    Geometry::Rect  bounds[DAMAGE_MAX_SLOTS];
+    UINT            i;
+
+    tracker.SetSurfaceSize(SURFACE_WIDTH, SURFACE_HEIGHT);
+
+    for (i = 0; i < DAMAGE_MAX_SLOTS; i++) {
+        tracker.Track(i, Geometry::MakeRect(0, 0, 0, 0));
+    }
+
+    tracker.Reset();
+
+    // More separate pieces than rectangles: merged, but all covered
+    for (i = 0; i < DAMAGE_MAX_SLOTS; i++) {
+        bounds[i] = Geometry::MakeRect(
+            50.0f + i * 90.0f, 50.0f + i * 60.0f,
+            60.0f + i * 90.0f, 60.0f + i * 60.0f);
+        tracker.Track(i, bounds[i]);
+    }
+
+    TEST_CHECK(tracker.GetRectCount() <= DAMAGE_MAX_RECTS);
+
+    for (i = 0; i < DAMAGE_MAX_SLOTS; i++) {
+        TEST_CHECK(IsCovered(tracker, bounds[i]));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestDamage()
+{
+    CheckFullFrame();
+    CheckTrackReset();
+    CheckMerge();
+    CheckClip();
+    CheckRectLimit();
+}
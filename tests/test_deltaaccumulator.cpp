@@ -0,0 +1,156 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+
+#include "test.h"
+#include "deltaaccumulator.h"
+
+#define CLOCK_FREQUENCY     1000000
+
+static VOID SetLinear(DeltaAccumulator* pAccumulator, FLOAT fSensitivity)
+{
+    POINTERACCELERATION acceleration;
+
+    acceleration.fSensitivity = fSensitivity;
+    acceleration.fSlowSpeed = 400.0f;
+    acceleration.fFastSpeed = 4000.0f;
+    acceleration.fMaxGain = 1.0f;
+
+    pAccumulator->SetAcceleration(acceleration);
+}
+
+// Moves at uCounts per packet and uRate packets per second for a second
+static FLOAT MoveForASecond(UINT uCounts, UINT uRate)
+{
+    ManualClock         clock(CLOCK_FREQUENCY);
+    DeltaAccumulator    accumulator(&clock);
+    FLOAT               fDeltaX = 0.0f, fDeltaY = 0.0f;
+    UINT                i;
+
+    for (i = 0; i < uRate; i++) {
+        clock.Advance(CLOCK_FREQUENCY / uRate);
+        accumulator.AddCounts((LONG) uCounts, 0);
+    }
+
+    accumulator.TakeDelta(&fDeltaX, &fDeltaY);
+
+    return fDeltaX;
+}
+
+static VOID CheckLinear()
+{
+    ManualClock         clock(CLOCK_FREQUENCY);
+    DeltaAccumulator    accumulator(&clock);
+    FLOAT               fDeltaX, fDeltaY;
+    UINT                i;
+
+    SetLinear(&accumulator, 1.5f);
+
+    TEST_CHECK(accumulator.TakeDelta(&fDeltaX, &fDeltaY) == FALSE);
+
+    // Zero packets are not motion
+    accumulator.AddCounts(0, 0);
+    TEST_CHECK(accumulator.TakeDelta(&fDeltaX, &fDeltaY) == FALSE);
+
+    for (i = 0; i < 1000; i++) {
+        clock.Advance(CLOCK_FREQUENCY / 1000);
+        accumulator.AddCounts(2, -1);
+    }
+
+    TEST_CHECK(accumulator.GetLastTime() == clock.GetTicks());
+
+    if (TEST_CHECK(accumulator.TakeDelta(&fDeltaX, &fDeltaY)) == TRUE) {
+        TEST_CHECK(fDeltaX == 3000.0f && fDeltaY == -1500.0f);
+    }
+
+    TEST_CHECK(accumulator.TakeDelta(&fDeltaX, &fDeltaY) == FALSE);
+}
+
+static VOID CheckAcceleration()
+{
+    FLOAT fSlow, fFast, fFast500, fFast1000;
+
+    // Below the slow speed the curve leaves counts alone, well above the
+    // fast speed it doubles them
+    fSlow = MoveForASecond(1, 125);
+    fFast = MoveForASecond(20, 1000);
+
+    TEST_CHECK(fSlow == 125.0f);
+    TEST_CHECK(fFast > 1.9f * 20000.0f && fFast <= 2.0f * 20000.0f);
+
+    // The same hand speed comes out the same whatever the polling rate
+    fFast500  = MoveForASecond(6, 500);
+    fFast1000 = MoveForASecond(3, 1000);
+
+    TEST_CHECK(fabsf(fFast500 - fFast1000) < 0.02f * fFast1000);
+}
+
+static VOID CheckRemainder()
+{
+    ManualClock         clock(CLOCK_FREQUENCY);
+    DeltaAccumulator    accumulator(&clock);
+    FLOAT               fDeltaX, fDeltaY;
+
+    // What a FLOAT cannot carry comes out with the next motion
+    accumulator.AddPixels(1e8f, 0.0f);
+    accumulator.AddPixels(0.5f, 0.0f);
+
+    TEST_CHECK(accumulator.TakeDelta(&fDeltaX, &fDeltaY));
+    TEST_CHECK(fDeltaX == 1e8f && fDeltaY == 0.0f);
+    TEST_CHECK(accumulator.TakeDelta(&fDeltaX, &fDeltaY) == FALSE);
+
+    accumulator.AddPixels(0.25f, 0.0f);
+
+    TEST_CHECK(accumulator.TakeDelta(&fDeltaX, &fDeltaY));
+    TEST_CHECK(fDeltaX == 0.75f);
+
+    // Reset drops it
+    accumulator.AddPixels(3.0f, 4.0f);
+    accumulator.Reset();
+
+    TEST_CHECK(accumulator.TakeDelta(&fDeltaX, &fDeltaY) == FALSE);
+    TEST_CHECK(accumulator.GetLastTime() == 0);
+}
+
+static VOID CheckSetAcceleration()
+{
+    ManualClock         clock(CLOCK_FREQUENCY);
+    DeltaAccumulator    accumulator(&clock);
+    POINTERACCELERATION acceleration;
+
+    acceleration.fSensitivity = 1.0f;
+    acceleration.fSlowSpeed = 1000.0f;
+    acceleration.fFastSpeed = 500.0f;
+    acceleration.fMaxGain = 0.5f;
+
+    accumulator.SetAcceleration(acceleration);
+    accumulator.GetAcceleration(&acceleration);
+
+    // Gains below 1 and an inverted range are corrected
+    TEST_CHECK(acceleration.fMaxGain == 1.0f);
+    TEST_CHECK(acceleration.fFastSpeed > acceleration.fSlowSpeed);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestDeltaAccumulator()
+{
+    CheckLinear();
+    CheckAcceleration();
+    CheckRemainder();
+    CheckSetAcceleration();
+}
@@ -0,0 +1,136 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "test.h"
+#include "easing.h"
+
+// Points the errors are measured at, evenly spaced over 0..1
+#define CHECK_POINTS    (1 << 20)
+
+#define BATCH_VALUES    4096
+
+typedef FLOAT (*MEASUREPROC)();
+
+static FLOAT CheckPoint(UINT i)
+{
+    return (FLOAT) i / (FLOAT) CHECK_POINTS;
+}
+
+template<class Ease>
+static FLOAT MeasureTableError()
+{
+    static CONST Easing::EasingTable<Ease, EASING_TABLE_SEGMENTS> table;
+    FLOAT   fError, fMax = 0.0f;
+    UINT    i;
+
+    for (i = 0; i <= CHECK_POINTS; i++) {
+        fError = fabsf(table(CheckPoint(i)) - Ease()(CheckPoint(i)));
+        fMax = (fError > fMax) ? fError : fMax;
+    }
+
+    return fMax;
+}
+
+#define MEASURE_ENTRY(Id, Name)     MeasureTableError<Easing::Name>,
+
+static CONST MEASUREPROC TABLE_ERRORS[EASING_COUNT] = {
+    EASING_LIST(MEASURE_ENTRY)
+};
+
+#undef MEASURE_ENTRY
+
+static FLOAT MeasureFastError(CONST EASINGINFO* pInfo)
+{
+    FLOAT   fError, fMax = 0.0f;
+    UINT    i;
+
+    for (i = 0; i <= CHECK_POINTS; i++) {
+        fError = fabsf(pInfo->pfnFast(CheckPoint(i)) -
+                       pInfo->pfnEase(CheckPoint(i)));
+        fMax = (fError > fMax) ? fError : fMax;
+    }
+
+    return fMax;
+}
+
+// Every batch level has to give Fast()'s bits, uneven tails included
+static BOOL CheckBatch(CONST EASINGINFO* pInfo, EASING easing)
+{
+    static FLOAT            x[BATCH_VALUES], y[BATCH_VALUES];
+    CONST EASINGKERNELS*    pKernels;
+    FLOAT                   fExpected;
+    UINT                    uLevel, uStart, i, cValues;
+
+    for (uLevel = EASING_LEVEL_SCALAR; uLevel <= EASING_LEVEL_SSE2; uLevel++) {
+        pKernels = GetEasingKernelsForLevel((EASINGLEVEL) uLevel);
+
+        if (pKernels == NULL) {
+            continue;
+        }
+
+        for (uStart = 0; uStart <= CHECK_POINTS; uStart += BATCH_VALUES) {
+            cValues = CHECK_POINTS + 1 - uStart;
+            cValues = (cValues < BATCH_VALUES) ? cValues : BATCH_VALUES - 1;
+
+            for (i = 0; i < cValues; i++) {
+                x[i] = CheckPoint(uStart + i);
+            }
+
+            pKernels->pfnBatch[easing](x, y, cValues);
+
+            for (i = 0; i < cValues; i++) {
+                fExpected = pInfo->pfnFast(x[i]);
+
+                if (memcmp(&y[i], &fExpected, sizeof(FLOAT)) != 0) {
+                    return FALSE;
+                }
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+// Fast() and the table stay within the documented errors, and the batch
+// kernels agree with Fast() to the bit
+static VOID CheckEasing(EASING easing)
+{
+    CONST EASINGINFO* pInfo = GetEasingInfo(easing);
+
+    if (TEST_CHECK(pInfo != NULL) == FALSE) {
+        return;
+    }
+
+    TEST_CHECK(MeasureFastError(pInfo) <= pInfo->fFastError);
+    TEST_CHECK(TABLE_ERRORS[easing]() <= pInfo->fTableError);
+    TEST_CHECK(CheckBatch(pInfo, easing));
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestEasing()
+{
+    UINT i;
+
+    for (i = 0; i < EASING_COUNT; i++) {
+        CheckEasing((EASING) i);
+    }
+
+    TEST_CHECK(GetEasingInfo(EASING_COUNT) == NULL);
+}
@@ -0,0 +1,139 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "clock.h"
+#include "engine.h"
+#include "nullplatform.h"
+#include "softwarerendersink.h"
+
+#define SPRITE_SIZE     32
+#define VIEWPORT_SIZE   256
+
+// Long enough for the pointer to come to rest after a move, at 60 Hz
+#define SETTLE_FRAMES   600
+#define IDLE_FRAMES     30
+
+// One frame's time, then a frame
+static BOOL Tick(Engine* pEngine, ManualClock* pClock)
+{
+    pClock->Advance(pEngine->GetScheduler()->GetPeriod());
+    return pEngine->Tick();
+}
+
+static BOOL Settle(Engine* pEngine, ManualClock* pClock)
+{
+    UINT i;
+
+    for (i = 0; i < SETTLE_FRAMES && pEngine->IsIdle() == FALSE; i++) {
+        Tick(pEngine, pClock);
+    }
+
+    return pEngine->IsIdle();
+}
+
+// A pointer at rest draws nothing however often it ticks: the frames
+// are counted as skipped until input moves it, and then it draws again
+static VOID CheckIdle(SoftwareRenderSink* pSink)
+{
+    static BYTE         pixels[SPRITE_SIZE * SPRITE_SIZE * 4];
+    ManualClock         clock;
+    Engine              engine(&clock);
+    FrameScheduler*     pScheduler = engine.GetScheduler();
+    Sprite*             pSprite = NULL;
+    INPUTEVENT          event;
+    ULONGLONG           ullRendered, ullSkipped;
+    UINT                i;
+    BOOL                bRendered = FALSE;
+
+    if (TEST_CHECK(SUCCEEDED(Sprite::CreateSpriteFromPixels(
+            pSink,
+            SPRITE_SIZE,
+            SPRITE_SIZE,
+            SPRITE_SIZE * 4,
+            pixels,
+            &pSprite))) == FALSE)
+    {
+        return;
+    }
+
+    if (TEST_CHECK(SUCCEEDED(engine.Initialize(
+            pSink,
+            pSprite,
+            new NullSound(),
+            new NullSound()))) == FALSE)
+    {
+        delete pSprite;
+        return;
+    }
+
+    engine.SetViewport((FLOAT) VIEWPORT_SIZE, (FLOAT) VIEWPORT_SIZE);
+    engine.CenterPointer();
+
+    if (TEST_CHECK(Settle(&engine, &clock)) == FALSE) {
+        return;
+    }
+
+    ullRendered = pScheduler->GetRenderedFrameCount();
+    ullSkipped = pScheduler->GetSkippedFrameCount();
+
+    for (i = 0; i < IDLE_FRAMES; i++) {
+        bRendered |= Tick(&engine, &clock);
+    }
+
+    TEST_CHECK(bRendered == FALSE);
+    TEST_CHECK(engine.IsIdle());
+    TEST_CHECK(pScheduler->GetRenderedFrameCount() == ullRendered);
+    TEST_CHECK(pScheduler->GetSkippedFrameCount() ==
+               ullSkipped + IDLE_FRAMES);
+
+    memset(&event, 0, sizeof(event));
+    event.type = IE_MOVE;
+    event.llTime = clock.GetTicks();
+    event.fDeltaX = 10.0f;
+    event.fDeltaY = 5.0f;
+
+    engine.HandleInput(event);
+
+    TEST_CHECK(engine.IsIdle() == FALSE);
+    TEST_CHECK(Tick(&engine, &clock));
+    TEST_CHECK(pScheduler->GetRenderedFrameCount() == ullRendered + 1);
+
+    // And it comes to rest again
+    TEST_CHECK(Settle(&engine, &clock));
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestEngine()
+{
+    SoftwareRenderSink* pSink = NULL;
+
+    // The engine owns the sprite, whose bitmap has to go before the sink
+    if (TEST_CHECK(SUCCEEDED(SoftwareRenderSink::CreateSoftwareRenderSink(
+            VIEWPORT_SIZE,
+            VIEWPORT_SIZE,
+            &pSink))) == FALSE)
+    {
+        return;
+    }
+
+    CheckIdle(pSink);
+
+    delete pSink;
+}
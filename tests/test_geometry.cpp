@@ -0,0 +1,155 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+
+#include "test.h"
+#include "geometry.h"
+
+#define EPSILON     1e-4f
+
+static BOOL IsNear(FLOAT a, FLOAT b)
+{
+    return fabsf(a - b) <= EPSILON * (1.0f + fabsf(b));
+}
+
+static BOOL IsRectNear(
+    CONST Geometry::Rect&   rect,
+    FLOAT                   left,
+    FLOAT                   top,
+    FLOAT                   right,
+    FLOAT                   bottom)
+{
+    return IsNear(rect.left, left) && IsNear(rect.top, top) &&
+           IsNear(rect.right, right) && IsNear(rect.bottom, bottom);
+}
+
+static VOID CheckTransformBounds()
+{
+    Geometry::Rect  rect = Geometry::MakeRect(0.0f, 0.0f, 10.0f, 20.0f);
+    Geometry::Rect  square = Geometry::MakeRect(0.0f, 0.0f, 10.0f, 10.0f);
+    Geometry::Point center = Geometry::MakePoint(5.0f, 10.0f);
+    Geometry::Matrix matrix;
+    FLOAT           fHalf = 5.0f * sqrtf(2.0f);
+
+    TEST_CHECK(IsRectNear(
+        Geometry::TransformBounds(Geometry::Identity(), rect),
+        0.0f, 0.0f, 10.0f, 20.0f));
+
+    TEST_CHECK(IsRectNear(
+        Geometry::TransformBounds(Geometry::Translation(3.0f, -4.0f), rect),
+        3.0f, -4.0f, 13.0f, 16.0f));
+
+    // A quarter turn about the middle swaps width and height
+    TEST_CHECK(IsRectNear(
+        Geometry::TransformBounds(Geometry::Rotation(90.0f, center), rect),
+        -5.0f, 5.0f, 15.0f, 15.0f));
+
+    // An eighth turn puts the corners of a square on the axes
+    TEST_CHECK(IsRectNear(
+        Geometry::TransformBounds(
+            Geometry::Rotation(45.0f, Geometry::MakePoint(5.0f, 5.0f)),
+            square),
+        5.0f - fHalf, 5.0f - fHalf, 5.0f + fHalf, 5.0f + fHalf));
+
+    TEST_CHECK(IsRectNear(
+        Geometry::TransformBounds(
+            Geometry::Scale(
+                Geometry::MakeSize(2.0f, 0.5f),
+                Geometry::MakePoint(0.0f, 0.0f)),
+            rect),
+        0.0f, 0.0f, 20.0f, 10.0f));
+
+    // Scaled about its middle, then turned about the same point: the
+    // way Sprite composes its transform
+    matrix = Geometry::Multiply(
+        Geometry::Scale(
+            Geometry::MakeSize(2.0f, 2.0f),
+            Geometry::MakePoint(5.0f, 5.0f)),
+        Geometry::Rotation(45.0f, Geometry::MakePoint(5.0f, 5.0f)));
+
+    TEST_CHECK(IsRectNear(
+        Geometry::TransformBounds(matrix, square),
+        5.0f - 2.0f * fHalf, 5.0f - 2.0f * fHalf,
+        5.0f + 2.0f * fHalf, 5.0f + 2.0f * fHalf));
+
+    // Multiply applies the left matrix first
+    matrix = Geometry::Multiply(
+        Geometry::Scale(
+            Geometry::MakeSize(2.0f, 2.0f),
+            Geometry::MakePoint(0.0f, 0.0f)),
+        Geometry::Translation(10.0f, 0.0f));
+
+    TEST_CHECK(IsRectNear(
+        Geometry::TransformBounds(matrix, square),
+        10.0f, 0.0f, 30.0f, 20.0f));
+}
+
+static VOID CheckInvert()
+{
+    Geometry::Matrix    matrix, inverse;
+    Geometry::Point     point;
+
+    matrix = Geometry::Multiply(
+        Geometry::Rotation(30.0f, Geometry::MakePoint(4.0f, 2.0f)),
+        Geometry::Translation(7.0f, -3.0f));
+
+    if (TEST_CHECK(Geometry::Invert(matrix, &inverse)) == FALSE) {
+        return;
+    }
+
+    point = Geometry::TransformPoint(
+        inverse,
+        Geometry::TransformPoint(matrix, Geometry::MakePoint(11.0f, 13.0f)));
+
+    TEST_CHECK(IsNear(point.x, 11.0f) && IsNear(point.y, 13.0f));
+
+    matrix = Geometry::Scale(
+        Geometry::MakeSize(0.0f, 1.0f),
+        Geometry::MakePoint(0.0f, 0.0f));
+
+    TEST_CHECK(Geometry::Invert(matrix, &inverse) == FALSE);
+}
+
+static VOID CheckRects()
+{
+    Geometry::Rect a = Geometry::MakeRect(0.0f, 0.0f, 10.0f, 10.0f);
+    Geometry::Rect b = Geometry::MakeRect(5.0f, 5.0f, 20.0f, 20.0f);
+    Geometry::Rect c = Geometry::MakeRect(10.0f, 0.0f, 20.0f, 10.0f);
+
+    TEST_CHECK(IsRectNear(Geometry::Union(a, b), 0.0f, 0.0f, 20.0f, 20.0f));
+    TEST_CHECK(IsRectNear(Geometry::Intersect(a, b), 5.0f, 5.0f, 10.0f, 10.0f));
+    TEST_CHECK(Geometry::Intersects(a, b));
+
+    // Sharing an edge is not overlapping
+    TEST_CHECK(Geometry::Intersects(a, c) == FALSE);
+    TEST_CHECK(Geometry::IsEmpty(Geometry::Intersect(a, c)));
+
+    TEST_CHECK(IsRectNear(
+        Geometry::RoundOut(Geometry::MakeRect(0.5f, -0.5f, 9.2f, 9.0f)),
+        0.0f, -1.0f, 10.0f, 9.0f));
+
+    TEST_CHECK(IsNear(Geometry::Area(b), 225.0f));
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestGeometry()
+{
+    CheckTransformBounds();
+    CheckInvert();
+    CheckRects();
+}
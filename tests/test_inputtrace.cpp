@@ -0,0 +1,200 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "test.h"
+#include "inputtrace.h"
+#include "mappedfile.h"
+#include "safemem.h"
+
+#define TRACE_PATH      TEXT("fp_test_trace.fpit")
+#define TRACE_START     1000000000LL
+
+static CONST INPUTRECORD RECORDS[] = {
+    { IR_DISPLAY,       TRACE_START,            0,      0,  1920.0f, 1080.0f },
+    { IR_DPI_SCALE,     TRACE_START,            0,      0,  1.25f,   0.0f },
+    { IR_SHOW,          TRACE_START + 10,       0,      0,  143.98f, 0.0f },
+    { IR_COUNTS,        TRACE_START + 1000,     3,      -2, 0.0f,    0.0f },
+    { IR_COUNTS,        TRACE_START + 2000,     -70000, 1,  0.0f,    0.0f },
+    { IR_PIXELS,        TRACE_START + 2000,     0,      0,  -0.0f,   1e-30f },
+    { IR_PRESS,         TRACE_START + 5000000,  0,      0,  0.0f,    0.0f },
+    { IR_WHEEL,         TRACE_START + 5000001,  -120,   0,  0.0f,    0.0f },
+    { IR_TICK,          TRACE_START + 9000000,  0,      0,  0.0f,    0.0f },
+    { IR_RELEASE,       TRACE_START + 9000000,  0,      0,  0.0f,    0.0f },
+};
+
+#define RECORD_COUNT    (sizeof(RECORDS) / sizeof(RECORDS[0]))
+
+// Floats have to come back bit for bit, -0 and denormals included
+static BOOL IsSameFloat(FLOAT a, FLOAT b)
+{
+    return memcmp(&a, &b, sizeof(FLOAT)) == 0;
+}
+
+static BOOL IsSameRecord(CONST INPUTRECORD& a, CONST INPUTRECORD& b)
+{
+    if (a.type != b.type || a.llTime != b.llTime) {
+        return FALSE;
+    }
+
+    switch (a.type) {
+        case IR_DISPLAY:
+        case IR_PIXELS:
+            return IsSameFloat(a.fX, b.fX) && IsSameFloat(a.fY, b.fY);
+
+        case IR_DPI_SCALE:
+        case IR_SHOW:
+            return IsSameFloat(a.fX, b.fX);
+
+        case IR_COUNTS:
+            return a.lX == b.lX && a.lY == b.lY;
+
+        case IR_WHEEL:
+            return a.lX == b.lX;
+
+        default:
+            return TRUE;
+    }
+}
+
+static BOOL WriteTrace(CONST INPUTTRACEINFO& info)
+{
+    InputTraceWriter*   pWriter = NULL;
+    UINT                i;
+
+    if (TEST_CHECK(SUCCEEDED(InputTraceWriter::CreateInputTraceWriter(
+            TRACE_PATH, info, &pWriter))) == FALSE)
+    {
+        return FALSE;
+    }
+
+    for (i = 0; i < RECORD_COUNT; i++) {
+        pWriter->Write(RECORDS[i]);
+    }
+
+    TEST_CHECK(SUCCEEDED(pWriter->Flush()));
+
+    SafeDelete(&pWriter);
+
+    return TRUE;
+}
+
+// Reads every record of the first cbData bytes; returns how many
+// matched RECORDS in order
+static UINT ReadTrace(
+    CONST BYTE*     pbData,
+    SIZE_T          cbData,
+    BOOL*           pbTruncated)
+{
+    InputTraceReader*   pReader = NULL;
+    INPUTRECORD         record;
+    UINT                cRecords = 0;
+
+    *pbTruncated = TRUE;
+
+    if (FAILED(InputTraceReader::CreateInputTraceReader(
+            pbData, cbData, &pReader)))
+    {
+        return 0;
+    }
+
+    while (pReader->Read(&record) == TRUE) {
+        if (cRecords >= RECORD_COUNT ||
+            IsSameRecord(record, RECORDS[cRecords]) == FALSE)
+        {
+            break;
+        }
+
+        cRecords++;
+    }
+
+    *pbTruncated = pReader->IsTruncated();
+
+    SafeDelete(&pReader);
+
+    return cRecords;
+}
+
+static VOID CheckRoundTrip()
+{
+    MappedFile*         pFile = NULL;
+    InputTraceReader*   pReader = NULL;
+    INPUTTRACEINFO      info, readInfo;
+    INPUTRECORD         record;
+    BOOL                bTruncated;
+
+    info.llFrequency   = 10000000;
+    info.llStart       = TRACE_START;
+    info.uSpriteWidth  = 96;
+    info.uSpriteHeight = 128;
+
+    if (WriteTrace(info) == FALSE) {
+        return;
+    }
+
+    if (TEST_CHECK(SUCCEEDED(MappedFile::CreateMappedFile(
+            TRACE_PATH, &pFile))) == FALSE)
+    {
+        remove(TRACE_PATH);
+        return;
+    }
+
+    TEST_CHECK(ReadTrace(pFile->GetData(), pFile->GetSize(), &bTruncated) ==
+        RECORD_COUNT);
+    TEST_CHECK(bTruncated == FALSE);
+
+    if (TEST_CHECK(SUCCEEDED(InputTraceReader::CreateInputTraceReader(
+            pFile->GetData(), pFile->GetSize(), &pReader))) == TRUE)
+    {
+        pReader->GetInfo(&readInfo);
+
+        TEST_CHECK(readInfo.llFrequency == info.llFrequency);
+        TEST_CHECK(readInfo.llStart == info.llStart);
+        TEST_CHECK(readInfo.uSpriteWidth == info.uSpriteWidth);
+        TEST_CHECK(readInfo.uSpriteHeight == info.uSpriteHeight);
+
+        // Rewind starts over at the first record
+        while (pReader->Read(&record) == TRUE) {
+        }
+
+        pReader->Rewind();
+        TEST_CHECK(pReader->Read(&record) == TRUE);
+        TEST_CHECK(IsSameRecord(record, RECORDS[0]));
+
+        SafeDelete(&pReader);
+    }
+
+    // Cut inside the last record: everything before it, flagged
+    TEST_CHECK(ReadTrace(pFile->GetData(), pFile->GetSize() - 1, &bTruncated) ==
+        RECORD_COUNT - 1);
+    TEST_CHECK(bTruncated == TRUE);
+
+    // Not a trace at all
+    TEST_CHECK(FAILED(InputTraceReader::CreateInputTraceReader(
+        pFile->GetData(), 8, &pReader)));
+
+    SafeDelete(&pFile);
+    remove(TRACE_PATH);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestInputTrace()
+{
+    CheckRoundTrip();
+}
@@ -0,0 +1,143 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "mipchain.h"
+#include "safemem.h"
+
+static BYTE GetTexel(CONST SoftwareRenderBitmap* pLevel, UINT x, UINT y)
+{
+    return pLevel->GetPixels()[y * pLevel->GetStride() + x * 4];
+}
+
+static VOID CheckLevels()
+{
+    BYTE        pixels[8 * 4 * 4];
+    MipChain*   pChain = NULL;
+    UINT        x, y;
+
+    // A checkerboard averages to grey on the first level down
+    for (y = 0; y < 4; y++) {
+        for (x = 0; x < 8; x++) {
+            memset(pixels + (y * 8 + x) * 4, ((x + y) & 1) ? 0xFF : 0, 4);
+        }
+    }
+
+    if (TEST_CHECK(SUCCEEDED(MipChain::CreateMipChain(
+            8, 4, 8 * 4, pixels, &pChain))) == FALSE)
+    {
+        return;
+    }
+
+    if (TEST_CHECK(pChain->GetLevelCount() == 4) == FALSE) {
+        SafeDelete(&pChain);
+        return;
+    }
+
+    TEST_CHECK(pChain->GetLevel(1)->GetWidth() == 4);
+    TEST_CHECK(pChain->GetLevel(1)->GetHeight() == 2);
+    TEST_CHECK(pChain->GetLevel(2)->GetWidth() == 2);
+    TEST_CHECK(pChain->GetLevel(2)->GetHeight() == 1);
+    TEST_CHECK(pChain->GetLevel(3)->GetWidth() == 1);
+    TEST_CHECK(pChain->GetLevel(3)->GetHeight() == 1);
+    TEST_CHECK(pChain->GetLevel(4) == NULL);
+
+    TEST_CHECK(GetTexel(pChain->GetLevel(0), 1, 0) == 0xFF);
+    TEST_CHECK(GetTexel(pChain->GetLevel(1), 0, 0) == 0x80);
+    TEST_CHECK(GetTexel(pChain->GetLevel(3), 0, 0) == 0x80);
+
+    TEST_CHECK(pChain->GetMemoryUsage() == (8 * 4 + 4 * 2 + 2 + 1) * 4);
+
+    SafeDelete(&pChain);
+}
+
+static VOID CheckOddSizes()
+{
+    BYTE        pixels[3 * 3 * 4];
+    BYTE        column[1 * 4 * 4];
+    MipChain*   pChain = NULL;
+    UINT        i;
+
+    // The last row and column of an odd image are dropped
+    for (i = 0; i < 9; i++) {
+        memset(pixels + i * 4, (i % 3 == 2 || i >= 6) ? 0xFF : 0x40, 4);
+    }
+
+    if (TEST_CHECK(SUCCEEDED(MipChain::CreateMipChain(
+            3, 3, 3 * 4, pixels, &pChain))) == TRUE)
+    {
+        TEST_CHECK(pChain->GetLevelCount() == 2);
+        TEST_CHECK(GetTexel(pChain->GetLevel(1), 0, 0) == 0x40);
+        SafeDelete(&pChain);
+    }
+
+    // A single column is averaged down its length only
+    for (i = 0; i < 4; i++) {
+        memset(column + i * 4, (BYTE) (i * 0x40), 4);
+    }
+
+    if (TEST_CHECK(SUCCEEDED(MipChain::CreateMipChain(
+            1, 4, 4, column, &pChain))) == TRUE)
+    {
+        TEST_CHECK(pChain->GetLevelCount() == 3);
+        TEST_CHECK(pChain->GetLevel(1)->GetWidth() == 1);
+        TEST_CHECK(GetTexel(pChain->GetLevel(1), 0, 0) == 0x20);
+        TEST_CHECK(GetTexel(pChain->GetLevel(1), 0, 1) == 0xA0);
+        SafeDelete(&pChain);
+    }
+}
+
+static VOID CheckSelectLevel()
+{
+    static BYTE         pixels[64 * 32 * 4];
+    MipChain*           pChain = NULL;
+    Geometry::Matrix    transform;
+
+    if (TEST_CHECK(SUCCEEDED(MipChain::CreateMipChain(
+            64, 32, 64 * 4, pixels, &pChain))) == FALSE)
+    {
+        return;
+    }
+
+    // The smallest level still at least as large as the result
+    TEST_CHECK(pChain->SelectLevel(2.0f) == 0);
+    TEST_CHECK(pChain->SelectLevel(1.0f) == 0);
+    TEST_CHECK(pChain->SelectLevel(0.75f) == 0);
+    TEST_CHECK(pChain->SelectLevel(0.5f) == 1);
+    TEST_CHECK(pChain->SelectLevel(0.3f) == 1);
+    TEST_CHECK(pChain->SelectLevel(0.25f) == 2);
+    TEST_CHECK(pChain->SelectLevel(0.001f) == pChain->GetLevelCount() - 1);
+
+    transform = pChain->GetLevelTransform(2);
+    TEST_CHECK(transform._11 == 4.0f && transform._22 == 4.0f);
+    TEST_CHECK(transform._31 == 0.0f && transform._32 == 0.0f);
+
+    transform = pChain->GetLevelTransform(0);
+    TEST_CHECK(transform._11 == 1.0f && transform._22 == 1.0f);
+
+    SafeDelete(&pChain);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestMipChain()
+{
+    CheckLevels();
+    CheckOddSizes();
+    CheckSelectLevel();
+}
@@ -0,0 +1,557 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+
+#include "test.h"
+#include "mixer.h"
+
+#define MIXER_RATE          48000
+#define MIXER_BLOCK         256
+#define CLIP_FRAMES         1000
+
+// Three peak windows, the first one quiet
+#define PEAK_CLIP_FRAMES    (CLIP_PEAK_FRAMES * 3)
+
+#define FADE_FRAMES         ((UINT) (MIXER_RATE * MIXER_FADE_TIME))
+
+// What a sample becomes through the mixer at this gain
+static FLOAT Mixed(SHORT sSample, FLOAT fGain)
+{
+    return (FLOAT) sSample * (fGain * (1.0f / 32768.0f));
+}
+
+// A sound over a stereo TestMakeWav() clip; the clip plays from pbFile,
+// where *ppsSamples points
+static MixerSound* CreateClipSound(
+    Mixer*          pMixer,
+    BYTE*           pbFile,
+    UINT            cFrames,
+    UINT            cVoices,
+    VOICESTEAL      steal,
+    CONST SHORT**   ppsSamples)
+{
+    AudioClip*  pClip = NULL;
+    MixerSound* pSound = NULL;
+
+    if (TEST_CHECK(SUCCEEDED(AudioClip::CreateAudioClipFromWav(
+            pbFile,
+            TEST_WAV_SIZE(cFrames, 2),
+            MIXER_RATE,
+            pMixer->GetSamplePool(),
+            &pClip))) == FALSE)
+    {
+        return NULL;
+    }
+
+    *ppsSamples = pClip->GetSamples();
+
+    if (TEST_CHECK(SUCCEEDED(pMixer->CreateSound(
+            pClip, cVoices, steal, &pSound))) == FALSE)
+    {
+        delete pClip;
+        return NULL;
+    }
+
+    return pSound;
+}
+
+// Renders cFrames in MIXER_BLOCK blocks
+static VOID RenderFrames(Mixer* pMixer, FLOAT* pfOutput, UINT cFrames)
+{
+    UINT uFrame, cBlock;
+
+    for (uFrame = 0; uFrame < cFrames; uFrame += cBlock) {
+        cBlock = (cFrames - uFrame < MIXER_BLOCK)
+            ? cFrames - uFrame
+            : MIXER_BLOCK;
+
+        pMixer->Render(pfOutput + uFrame * MIXER_CHANNELS, cBlock);
+    }
+}
+
+// At the mixer rate a clip comes out sample for sample, and ends on its
+// last frame without a tail
+static VOID CheckPlayback()
+{
+    static BYTE     file[TEST_WAV_SIZE(CLIP_FRAMES, 2)];
+    static FLOAT    output[(CLIP_FRAMES + 100) * MIXER_CHANNELS];
+    CONST SHORT*    psSamples = NULL;
+    Mixer*          pMixer = NULL;
+    MixerSound*     pSound = NULL;
+    UINT            i, cDiffer = 0;
+
+    if (TEST_CHECK(SUCCEEDED(
+            Mixer::CreateMixer(MIXER_RATE, &pMixer))) == FALSE)
+    {
+        return;
+    }
+
+    TestMakeWav(file, CLIP_FRAMES, 2, MIXER_RATE);
+    pSound = CreateClipSound(pMixer, file, CLIP_FRAMES, 1,
+                             VOICE_STEAL_OLDEST, &psSamples);
+
+    if (pSound == NULL) {
+        goto cleanup;
+    }
+
+    pSound->Play();
+    TEST_CHECK(pSound->IsPlaying());
+
+    RenderFrames(pMixer, output, CLIP_FRAMES + 100);
+
+    for (i = 0; i < ARRAYSIZE(output); i++) {
+        if (output[i] != ((i < CLIP_FRAMES * 2)
+                ? Mixed(psSamples[i], 1.0f)
+                : 0.0f))
+        {
+            cDiffer++;
+        }
+    }
+
+    TEST_CHECK(cDiffer == 0);
+    TEST_CHECK(pSound->IsPlaying() == FALSE);
+    TEST_CHECK(pMixer->GetPlayingCount() == 0);
+
+cleanup:
+    delete pSound;
+    delete pMixer;
+}
+
+// A loop wraps on the exact frame it ends on, whatever the block size
+static VOID CheckLoop()
+{
+    static BYTE     file[TEST_WAV_SIZE(CLIP_FRAMES, 2)];
+    static FLOAT    output[(CLIP_FRAMES * 3 + 37) * MIXER_CHANNELS];
+    CONST SHORT*    psSamples = NULL;
+    Mixer*          pMixer = NULL;
+    MixerSound*     pSound = NULL;
+    UINT            i, cDiffer = 0;
+
+    if (TEST_CHECK(SUCCEEDED(
+            Mixer::CreateMixer(MIXER_RATE, &pMixer))) == FALSE)
+    {
+        return;
+    }
+
+    TestMakeWav(file, CLIP_FRAMES, 2, MIXER_RATE);
+    pSound = CreateClipSound(pMixer, file, CLIP_FRAMES, 1,
+                             VOICE_STEAL_OLDEST, &psSamples);
+
+    if (pSound == NULL) {
+        goto cleanup;
+    }
+
+    pSound->SetLoop(TRUE);
+    pSound->Play();
+
+    RenderFrames(pMixer, output, CLIP_FRAMES * 3 + 37);
+
+    for (i = 0; i < ARRAYSIZE(output); i++) {
+        if (output[i] != Mixed(psSamples[i % (CLIP_FRAMES * 2)], 1.0f)) {
+            cDiffer++;
+        }
+    }
+
+    TEST_CHECK(cDiffer == 0);
+    TEST_CHECK(pSound->IsPlaying());
+    TEST_CHECK(pMixer->GetPlayingCount() == 1);
+
+cleanup:
+    delete pSound;
+    delete pMixer;
+}
+
+// A gain change ramps over the next block and holds from then on; the
+// master gain applies to every sound at once
+static VOID CheckGain()
+{
+    static BYTE     file[TEST_WAV_SIZE(CLIP_FRAMES, 2)];
+    FLOAT           output[MIXER_BLOCK * MIXER_CHANNELS];
+    CONST SHORT*    psSamples = NULL;
+    CONST SHORT*    psFrame;
+    Mixer*          pMixer = NULL;
+    MixerSound*     pSound = NULL;
+    FLOAT           fLast;
+    UINT            i, cDiffer = 0;
+
+    if (TEST_CHECK(SUCCEEDED(
+            Mixer::CreateMixer(MIXER_RATE, &pMixer))) == FALSE)
+    {
+        return;
+    }
+
+    TestMakeWav(file, CLIP_FRAMES, 2, MIXER_RATE);
+    pSound = CreateClipSound(pMixer, file, CLIP_FRAMES, 1,
+                             VOICE_STEAL_OLDEST, &psSamples);
+
+    if (pSound == NULL) {
+        goto cleanup;
+    }
+
+    pSound->SetLoop(TRUE);
+    pSound->Play();
+    pMixer->Render(output, MIXER_BLOCK);
+
+    // Ramps from 1 down to one step short of 0.5
+    pSound->SetGain(0.5f);
+    pMixer->Render(output, MIXER_BLOCK);
+
+    psFrame = psSamples + MIXER_BLOCK * 2;
+    fLast = Mixed(psFrame[MIXER_BLOCK * 2 - 2], 0.5f + 0.5f / MIXER_BLOCK);
+
+    TEST_CHECK(output[0] == Mixed(psFrame[0], 1.0f));
+    TEST_CHECK(fabsf(output[MIXER_BLOCK * 2 - 2] - fLast) < 1e-6f);
+
+    pMixer->Render(output, MIXER_BLOCK);
+    psFrame += MIXER_BLOCK * 2;
+
+    for (i = 0; i < MIXER_BLOCK * 2; i++) {
+        if (output[i] != Mixed(psFrame[i], 0.5f)) {
+            cDiffer++;
+        }
+    }
+
+    pMixer->SetMasterGain(0.5f);
+    pMixer->Render(output, MIXER_BLOCK);
+
+    // Wraps within this block
+    for (i = 0; i < MIXER_BLOCK * 2; i++) {
+        if (output[i] != Mixed(psSamples[(MIXER_BLOCK * 6 + i) %
+                                         (CLIP_FRAMES * 2)], 0.25f))
+        {
+            cDiffer++;
+        }
+    }
+
+    TEST_CHECK(cDiffer == 0);
+
+cleanup:
+    delete pSound;
+    delete pMixer;
+}
+
+// Sums the two playheads of a stereo clip over cFrames and counts the
+// samples of pfOutput that differ from them
+static UINT CountDiffering(
+    CONST FLOAT*    pfOutput,
+    CONST SHORT*    psSamples,
+    UINT            uFirst,
+    UINT            uSecond,
+    UINT            cFrames)
+{
+    UINT i, cDiffer = 0;
+
+    for (i = 0; i < cFrames * 2; i++) {
+        if (pfOutput[i] != Mixed(psSamples[uFirst * 2 + i], 1.0f) +
+                           Mixed(psSamples[uSecond * 2 + i], 1.0f))
+        {
+            cDiffer++;
+        }
+    }
+
+    return cDiffer;
+}
+
+// Plays on a sound with more than one voice overlap; on a sound with
+// one they leave the playing voice alone
+static VOID CheckOverlap()
+{
+    static BYTE     file[TEST_WAV_SIZE(CLIP_FRAMES, 2)];
+    FLOAT           output[MIXER_BLOCK * MIXER_CHANNELS];
+    CONST SHORT*    psSamples = NULL;
+    Mixer*          pMixer = NULL;
+    MixerSound*     pSound = NULL;
+    MixerSound*     pSingle = NULL;
+    MIXERSTATS      stats;
+    UINT            i, cDiffer = 0;
+
+    if (TEST_CHECK(SUCCEEDED(
+            Mixer::CreateMixer(MIXER_RATE, &pMixer))) == FALSE)
+    {
+        return;
+    }
+
+    TestMakeWav(file, CLIP_FRAMES, 2, MIXER_RATE);
+    pSound = CreateClipSound(pMixer, file, CLIP_FRAMES, 3,
+                             VOICE_STEAL_OLDEST, &psSamples);
+
+    if (pSound == NULL) {
+        goto cleanup;
+    }
+
+    pSound->Play();
+    pMixer->Render(output, 100);
+    pSound->Play();
+    pMixer->Render(output, MIXER_BLOCK);
+
+    TEST_CHECK(CountDiffering(output, psSamples, 100, 0, MIXER_BLOCK) == 0);
+
+    pMixer->GetStats(&stats);
+
+    TEST_CHECK(stats.cVoices == MIXER_MAX_VOICES);
+    TEST_CHECK(stats.cVoicesReserved == 3);
+    TEST_CHECK(stats.cVoicesInUse == 2);
+    TEST_CHECK(stats.cVoicesStolen == 0);
+
+    delete pSound;
+    pSound = NULL;
+
+    pSingle = CreateClipSound(pMixer, file, CLIP_FRAMES, 1,
+                              VOICE_STEAL_OLDEST, &psSamples);
+
+    if (pSingle == NULL) {
+        goto cleanup;
+    }
+
+    pSingle->Play();
+    pMixer->Render(output, 100);
+    pSingle->Play();
+    pMixer->Render(output, MIXER_BLOCK);
+
+    // Carries on from frame 100
+    for (i = 0; i < MIXER_BLOCK * 2; i++) {
+        if (output[i] != Mixed(psSamples[100 * 2 + i], 1.0f)) {
+            cDiffer++;
+        }
+    }
+
+    TEST_CHECK(cDiffer == 0);
+
+    pMixer->GetStats(&stats);
+
+    TEST_CHECK(stats.cVoicesInUse == 1);
+    TEST_CHECK(stats.cVoicesStolen == 0);
+
+cleanup:
+    delete pSingle;
+    delete pSound;
+    delete pMixer;
+}
+
+// With every voice playing, the oldest one or the one playing the
+// quietest part of the clip gives way. The clip's first peak window is
+// quiet, so the two policies pick different voices.
+static VOID CheckSteal(VOICESTEAL steal)
+{
+    static SHORT    file[TEST_WAV_SIZE(PEAK_CLIP_FRAMES, 2) / 2];
+    FLOAT           output[MIXER_BLOCK * MIXER_CHANNELS];
+    CONST SHORT*    psSamples = NULL;
+    Mixer*          pMixer = NULL;
+    MixerSound*     pSound = NULL;
+    SHORT*          psData = file + TEST_WAV_HEADER / 2;
+    MIXERSTATS      stats;
+    UINT            uSurvivor;
+    UINT            i;
+
+    if (TEST_CHECK(SUCCEEDED(
+            Mixer::CreateMixer(MIXER_RATE, &pMixer))) == FALSE)
+    {
+        return;
+    }
+
+    TestMakeWav((BYTE*) file, PEAK_CLIP_FRAMES, 2, MIXER_RATE);
+
+    for (i = 0; i < CLIP_PEAK_FRAMES * 2; i++) {
+        psData[i] = (SHORT) (i % 16);
+    }
+
+    pSound = CreateClipSound(pMixer, (BYTE*) file, PEAK_CLIP_FRAMES, 2,
+                             steal, &psSamples);
+
+    if (pSound == NULL) {
+        goto cleanup;
+    }
+
+    // The first voice is in a loud window, the second one in the quiet
+    // one when the third play comes
+    pSound->Play();
+
+    for (i = 0; i < CLIP_PEAK_FRAMES * 2 / MIXER_BLOCK; i++) {
+        pMixer->Render(output, MIXER_BLOCK);
+    }
+
+    pSound->Play();
+    pMixer->Render(output, 16);
+    pSound->Play();
+
+    // Past the fade of the voice that gave way
+    pMixer->Render(output, FADE_FRAMES);
+    pMixer->Render(output, MIXER_BLOCK);
+
+    uSurvivor = (steal == VOICE_STEAL_QUIETEST)
+        ? CLIP_PEAK_FRAMES * 2 + 16 + FADE_FRAMES
+        : 16 + FADE_FRAMES;
+
+    TEST_CHECK(CountDiffering(output, psSamples, uSurvivor, FADE_FRAMES,
+                              MIXER_BLOCK) == 0);
+
+    pMixer->GetStats(&stats);
+
+    TEST_CHECK(stats.cVoicesInUse == 2);
+    TEST_CHECK(stats.cVoicesStolen == 1);
+
+cleanup:
+    delete pSound;
+    delete pMixer;
+}
+
+// A stopped voice fades out over MIXER_FADE_TIME instead of cutting off
+static VOID CheckStopFade()
+{
+    static BYTE     file[TEST_WAV_SIZE(CLIP_FRAMES, 2)];
+    FLOAT           output[MIXER_BLOCK * 2 * MIXER_CHANNELS];
+    CONST SHORT*    psSamples = NULL;
+    CONST SHORT*    psFrame;
+    Mixer*          pMixer = NULL;
+    MixerSound*     pSound = NULL;
+    UINT            i, cLoud = 0;
+
+    if (TEST_CHECK(SUCCEEDED(
+            Mixer::CreateMixer(MIXER_RATE, &pMixer))) == FALSE)
+    {
+        return;
+    }
+
+    TestMakeWav(file, CLIP_FRAMES, 2, MIXER_RATE);
+    pSound = CreateClipSound(pMixer, file, CLIP_FRAMES, 1,
+                             VOICE_STEAL_OLDEST, &psSamples);
+
+    if (pSound == NULL) {
+        goto cleanup;
+    }
+
+    pSound->SetLoop(TRUE);
+    pSound->Play();
+    pMixer->Render(output, 100);
+    pSound->Stop();
+    pMixer->Render(output, MIXER_BLOCK * 2);
+
+    psFrame = psSamples + 100 * 2;
+
+    TEST_CHECK(output[0] == Mixed(psFrame[0], 1.0f));
+    // Half way down
+    TEST_CHECK(fabsf(output[FADE_FRAMES / 2 * 2] -
+                     Mixed(psFrame[FADE_FRAMES / 2 * 2], 0.5f)) < 1e-6f);
+
+    for (i = FADE_FRAMES * 2; i < ARRAYSIZE(output); i++) {
+        if (output[i] != 0.0f) {
+            cLoud++;
+        }
+    }
+
+    TEST_CHECK(cLoud == 0);
+    TEST_CHECK(pSound->IsPlaying() == FALSE);
+
+cleanup:
+    delete pSound;
+    delete pMixer;
+}
+
+// Sounds reserve their voices up front, and get them back once the
+// audio thread has let go of a deleted sound
+static VOID CheckPool()
+{
+    static BYTE     file[TEST_WAV_SIZE(CLIP_FRAMES, 2)];
+    FLOAT           output[MIXER_BLOCK * MIXER_CHANNELS];
+    Mixer*          pMixer = NULL;
+    AudioClip*      pClip = NULL;
+    MixerSound*     pSound = NULL;
+    MixerSound*     pOther = NULL;
+    MIXERSTATS      stats;
+
+    if (TEST_CHECK(SUCCEEDED(
+            Mixer::CreateMixer(MIXER_RATE, &pMixer))) == FALSE)
+    {
+        return;
+    }
+
+    TestMakeWav(file, CLIP_FRAMES, 2, MIXER_RATE);
+
+    if (TEST_CHECK(SUCCEEDED(AudioClip::CreateAudioClipFromWav(
+            file,
+            sizeof(file),
+            MIXER_RATE,
+            pMixer->GetSamplePool(),
+            &pClip))) == FALSE)
+    {
+        goto cleanup;
+    }
+
+    TEST_CHECK(pMixer->CreateSound(pClip, MIXER_MAX_VOICES + 1,
+                                   VOICE_STEAL_OLDEST, &pSound) ==
+               E_INVALIDARG);
+
+    if (TEST_CHECK(SUCCEEDED(pMixer->CreateSound(
+            pClip, MIXER_MAX_VOICES, VOICE_STEAL_OLDEST, &pSound))) == FALSE)
+    {
+        goto cleanup;
+    }
+
+    pClip = NULL;
+
+    if (TEST_CHECK(SUCCEEDED(AudioClip::CreateAudioClipFromWav(
+            file,
+            sizeof(file),
+            MIXER_RATE,
+            pMixer->GetSamplePool(),
+            &pClip))) == FALSE)
+    {
+        goto cleanup;
+    }
+
+    TEST_CHECK(pMixer->CreateSound(pClip, 1, VOICE_STEAL_OLDEST, &pOther) ==
+               E_OUTOFMEMORY);
+
+    pMixer->GetStats(&stats);
+    TEST_CHECK(stats.cVoicesReserved == MIXER_MAX_VOICES);
+
+    delete pSound;
+    pSound = NULL;
+
+    pMixer->Render(output, MIXER_BLOCK);
+
+    if (TEST_CHECK(SUCCEEDED(pMixer->CreateSound(
+            pClip, 1, VOICE_STEAL_OLDEST, &pOther))) == FALSE)
+    {
+        goto cleanup;
+    }
+
+    pClip = NULL;
+
+    pMixer->GetStats(&stats);
+    TEST_CHECK(stats.cVoicesReserved == 1);
+
+cleanup:
+    delete pClip;
+    delete pOther;
+    delete pSound;
+    delete pMixer;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestMixer()
+{
+    CheckPlayback();
+    CheckLoop();
+    CheckGain();
+    CheckOverlap();
+    CheckSteal(VOICE_STEAL_OLDEST);
+    CheckSteal(VOICE_STEAL_QUIETEST);
+    CheckStopFade();
+    CheckPool();
+}
@@ -0,0 +1,112 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "clock.h"
+#include "engine.h"
+#include "nullplatform.h"
+
+#define SPRITE_SIZE     128
+#define VIEWPORT_WIDTH  1920.0f
+#define VIEWPORT_HEIGHT 1080.0f
+
+// A 1000 Hz mouse on a 1 MHz clock
+#define MOVE_TICKS      1000
+
+static VOID Move(Engine* pEngine, ManualClock* pClock, FLOAT dx, FLOAT dy)
+{
+    INPUTEVENT event;
+
+    memset(&event, 0, sizeof(event));
+
+    pClock->Advance(MOVE_TICKS);
+
+    event.type = IE_MOVE;
+    event.llTime = pClock->GetTicks();
+    event.fDeltaX = dx;
+    event.fDeltaY = dy;
+
+    pEngine->HandleInput(event);
+}
+
+// Moves go where they are told on screen; past an edge the pointer
+// stops its own size beyond it, however far the move
+static VOID CheckClamp()
+{
+    static BYTE     pixels[SPRITE_SIZE * SPRITE_SIZE * 4];
+    NullRenderSink  sink(VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    ManualClock     clock;
+    Engine          engine(&clock);
+    Sprite*         pSprite = NULL;
+    Geometry::Point position, start;
+    Geometry::Size  size;
+    UINT            i;
+
+    if (TEST_CHECK(SUCCEEDED(Sprite::CreateSpriteFromPixels(
+            &sink,
+            SPRITE_SIZE,
+            SPRITE_SIZE,
+            SPRITE_SIZE * 4,
+            pixels,
+            &pSprite))) == FALSE)
+    {
+        return;
+    }
+
+    if (TEST_CHECK(SUCCEEDED(engine.Initialize(
+            &sink,
+            pSprite,
+            new NullSound(),
+            new NullSound()))) == FALSE)
+    {
+        delete pSprite;
+        return;
+    }
+
+    engine.SetViewport(VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    engine.CenterPointer();
+
+    start = engine.GetPointer()->GetPosition();
+    size = engine.GetPointer()->GetSize();
+
+    Move(&engine, &clock, 25.0f, -10.0f);
+    position = engine.GetPointer()->GetPosition();
+
+    TEST_CHECK(position.x == start.x + 25.0f);
+    TEST_CHECK(position.y == start.y - 10.0f);
+
+    for (i = 0; i < 4; i++) {
+        Move(&engine, &clock,
+             (i & 1) ? 1e6f : -1e6f,
+             (i & 2) ? 1e6f : -1e6f);
+
+        position = engine.GetPointer()->GetPosition();
+
+        TEST_CHECK(position.x ==
+                   ((i & 1) ? VIEWPORT_WIDTH + size.width : -size.width));
+        TEST_CHECK(position.y ==
+                   ((i & 2) ? VIEWPORT_HEIGHT + size.height : -size.height));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestPointer()
+{
+    CheckClamp();
+}
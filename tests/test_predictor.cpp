@@ -0,0 +1,219 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+
+#include "test.h"
+#include "pointerpredictor.h"
+
+#define CLOCK_FREQUENCY     1000000
+
+// A frame presented 16 ms after the newest sample
+#define FRAME_LEAD          16000       // Ticks
+
+typedef FLOAT (*MOTIONPROC)(DOUBLE t);
+
+static CONST UINT RATES[] = { 125, 1000 };
+
+static FLOAT Still(DOUBLE)
+{
+    return 200.0f;
+}
+
+static FLOAT Slow(DOUBLE t)
+{
+    return (FLOAT) (50.0 * t);
+}
+
+static FLOAT Steady(DOUBLE t)
+{
+    return (FLOAT) (1000.0 * t);
+}
+
+static FLOAT Flick(DOUBLE t)
+{
+    return (FLOAT) (20000.0 * t);
+}
+
+// 2000 px/s braking to a stop at x = 100 after 100 ms
+static FLOAT Brake(DOUBLE t)
+{
+    t = (t < 0.1) ? t : 0.1;
+
+    return (FLOAT) (2000.0 * t - 10000.0 * t * t);
+}
+
+// Feeds fDuration seconds of motion along x at uRate samples per second,
+// in whole pixels like a real mouse, and leaves the clock on the newest
+// sample. Returns that sample's x.
+static FLOAT Feed(
+    PointerPredictor*   pPredictor,
+    ManualClock*        pClock,
+    MOTIONPROC          pfnMotion,
+    UINT                uRate,
+    DOUBLE              fDuration)
+{
+    UINT        cSamples = (UINT) (fDuration * uRate);
+    LONGLONG    llTime;
+    FLOAT       x = 0.0f;
+    UINT        i;
+
+    for (i = 0; i <= cSamples; i++) {
+        llTime = (LONGLONG) ((DOUBLE) i * CLOCK_FREQUENCY / uRate);
+        x = floorf(pfnMotion((DOUBLE) i / uRate));
+
+        pClock->SetTicks(llTime);
+        pPredictor->AddSample(llTime, Geometry::MakePoint(x, 50.0f));
+    }
+
+    return x;
+}
+
+static BOOL IsZero(CONST Geometry::Point& offset)
+{
+    return offset.x == 0.0f && offset.y == 0.0f;
+}
+
+// No history, a single sample, a hand at rest or one moving slower
+// than fMinSpeed leave the pointer where it is
+static VOID CheckNothing()
+{
+    ManualClock         clock(CLOCK_FREQUENCY);
+    PointerPredictor    predictor(&clock);
+    UINT                i;
+
+    TEST_CHECK(IsZero(predictor.Predict(FRAME_LEAD)));
+
+    predictor.AddSample(0, Geometry::MakePoint(10.0f, 10.0f));
+    TEST_CHECK(IsZero(predictor.Predict(FRAME_LEAD)));
+
+    for (i = 0; i < ARRAYSIZE(RATES); i++) {
+        predictor.Reset();
+        Feed(&predictor, &clock, Still, RATES[i], 0.1);
+        TEST_CHECK(IsZero(predictor.Predict(clock.GetTicks() + FRAME_LEAD)));
+
+        predictor.Reset();
+        Feed(&predictor, &clock, Slow, RATES[i], 0.2);
+        TEST_CHECK(IsZero(predictor.Predict(clock.GetTicks() + FRAME_LEAD)));
+    }
+}
+
+// Steady motion is followed to the presentation time, along the motion
+// only, and never further ahead than fMaxLead
+static VOID CheckSteady()
+{
+    ManualClock         clock(CLOCK_FREQUENCY);
+    PointerPredictor    predictor(&clock);
+    Geometry::Point     offset;
+    UINT                i;
+
+    for (i = 0; i < ARRAYSIZE(RATES); i++) {
+        predictor.Reset();
+        Feed(&predictor, &clock, Steady, RATES[i], 0.1);
+
+        offset = predictor.Predict(clock.GetTicks() + FRAME_LEAD);
+
+        TEST_CHECK(fabsf(offset.x - 16.0f) < 0.5f);
+        TEST_CHECK(offset.y == 0.0f);
+
+        offset = predictor.Predict(clock.GetTicks() + CLOCK_FREQUENCY);
+
+        TEST_CHECK(offset.x <= 50.0f + 0.5f);
+    }
+}
+
+// However fast the flick, the guess stays within fMaxDistance
+static VOID CheckDistance()
+{
+    ManualClock         clock(CLOCK_FREQUENCY);
+    PointerPredictor    predictor(&clock);
+    Geometry::Point     offset;
+    PREDICTORPARAMETERS parameters;
+    UINT                i;
+
+    predictor.GetParameters(&parameters);
+
+    for (i = 0; i < ARRAYSIZE(RATES); i++) {
+        predictor.Reset();
+        Feed(&predictor, &clock, Flick, RATES[i], 0.1);
+
+        offset = predictor.Predict(clock.GetTicks() + FRAME_LEAD);
+
+        TEST_CHECK(offset.x > 0.0f);
+        TEST_CHECK(offset.x <= parameters.fMaxDistance + 1e-3f);
+    }
+
+    // Without any lead there is nothing to predict
+    parameters.fMaxLead = -1.0f;
+    predictor.SetParameters(parameters);
+
+    TEST_CHECK(IsZero(predictor.Predict(clock.GetTicks() + FRAME_LEAD)));
+}
+
+// A braking pointer is not carried past where it stops, and the guess
+// holds there however far ahead the frame is instead of turning back
+static VOID CheckBrake()
+{
+    ManualClock         clock(CLOCK_FREQUENCY);
+    PointerPredictor    predictor(&clock);
+    Geometry::Point     offset, lateOffset;
+    FLOAT               x;
+    UINT                i;
+
+    for (i = 0; i < ARRAYSIZE(RATES); i++) {
+        predictor.Reset();
+        x = Feed(&predictor, &clock, Brake, RATES[i], 0.08);
+
+        offset = predictor.Predict(clock.GetTicks() + FRAME_LEAD);
+        lateOffset = predictor.Predict(clock.GetTicks() + CLOCK_FREQUENCY);
+
+        // Stops at 100, give or take the filter's lag
+        TEST_CHECK(x + offset.x <= 102.0f);
+        TEST_CHECK(offset.x > 0.0f);
+        TEST_CHECK(fabsf(lateOffset.x - offset.x) < 0.5f);
+    }
+}
+
+// Once input stops the guess fades out, and a long gap starts over
+static VOID CheckQuiet()
+{
+    ManualClock         clock(CLOCK_FREQUENCY);
+    PointerPredictor    predictor(&clock);
+    FLOAT               x;
+
+    x = Feed(&predictor, &clock, Steady, 1000, 0.1);
+
+    TEST_CHECK(IsZero(predictor.Predict(clock.GetTicks() + FRAME_LEAD)) ==
+               FALSE);
+
+    clock.Advance(CLOCK_FREQUENCY / 50);
+    TEST_CHECK(IsZero(predictor.Predict(clock.GetTicks() + FRAME_LEAD)));
+
+    clock.Advance(CLOCK_FREQUENCY / 5);
+    predictor.AddSample(clock.GetTicks(), Geometry::MakePoint(x + 1.0f, 50.0f));
+    TEST_CHECK(IsZero(predictor.Predict(clock.GetTicks() + FRAME_LEAD)));
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestPredictor()
+{
+    CheckNothing();
+    CheckSteady();
+    CheckDistance();
+    CheckBrake();
+    CheckQuiet();
+}
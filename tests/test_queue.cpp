@@ -0,0 +1,256 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "atomic.h"
+#include "mixer.h"
+#include "spscqueue.h"
+#include "thread.h"
+
+#define QUEUE_ITEMS         (4 * 1024 * 1024)
+#define QUEUE_SIZE          1024
+
+#define MIXER_ROUNDS        (256 * 1024)
+#define MIXER_BLOCK         64
+#define MIXER_RATE          48000
+#define MIXER_CLIP_FRAMES   256
+#define MIXER_WAIT_YIELDS   (1024 * 1024)
+
+#define EVENT_DELAY         10      // Milliseconds
+
+// Same size as a mixer command
+typedef struct _QUEUEITEM {
+    UINT    uSequence;
+    UINT    uCheck;
+    UINT    uPadding[4];
+} QUEUEITEM;
+
+typedef SpscQueue<QUEUEITEM, QUEUE_SIZE> TESTQUEUE;
+
+typedef struct _RENDERCONTEXT {
+    Mixer*          pMixer;
+    volatile LONG   lStop;
+} RENDERCONTEXT;
+
+static UINT CheckValue(UINT uSequence)
+{
+    return uSequence * 2654435761u;
+}
+
+static VOID Produce(LPVOID pContext)
+{
+    TESTQUEUE*  pQueue = (TESTQUEUE*) pContext;
+    QUEUEITEM   item;
+    UINT        i;
+
+    memset(&item, 0, sizeof(item));
+
+    for (i = 0; i < QUEUE_ITEMS; i++) {
+        item.uSequence = i;
+        item.uCheck = CheckValue(i);
+
+        while (pQueue->Push(item) == FALSE) {
+            Thread::YieldThread();
+        }
+    }
+}
+
+// Every item has to arrive exactly once and in the order it was pushed
+static VOID CheckOrder()
+{
+    static TESTQUEUE    queue;
+    Thread*             pProducer = NULL;
+    QUEUEITEM           item;
+    UINT                uExpected = 0, cErrors = 0;
+
+    if (TEST_CHECK(SUCCEEDED(
+            Thread::CreateThread(Produce, &queue, &pProducer))) == FALSE)
+    {
+        return;
+    }
+
+    while (uExpected < QUEUE_ITEMS) {
+        if (queue.Pop(&item) == FALSE) {
+            Thread::YieldThread();
+            continue;
+        }
+
+        if (item.uSequence != uExpected ||
+            item.uCheck != CheckValue(uExpected))
+        {
+            cErrors++;
+        }
+
+        uExpected = item.uSequence + 1;
+    }
+
+    delete pProducer;
+
+    TEST_CHECK(cErrors == 0);
+    TEST_CHECK(queue.Pop(&item) == FALSE);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+static VOID RenderLoop(LPVOID pContext)
+{
+    RENDERCONTEXT*  pRender = (RENDERCONTEXT*) pContext;
+    FLOAT           output[MIXER_BLOCK * MIXER_CHANNELS];
+
+    while (AtomicLoadAcquire(&pRender->lStop) == 0) {
+        pRender->pMixer->Render(output, MIXER_BLOCK);
+        Thread::YieldThread();
+    }
+}
+
+static BOOL WaitForPlaying(Mixer* pMixer, UINT cExpected)
+{
+    UINT i;
+
+    for (i = 0; i < MIXER_WAIT_YIELDS; i++) {
+        pMixer->Flush();
+
+        if (pMixer->GetPlayingCount() == cExpected) {
+            return TRUE;
+        }
+
+        Thread::YieldThread();
+    }
+
+    return FALSE;
+}
+
+// The UI side hammers a sound while another thread renders; whatever
+// had to wait for room in the queue, the last commands have to win
+static VOID CheckLastCommandWins()
+{
+    static BYTE     file[TEST_WAV_SIZE(MIXER_CLIP_FRAMES, 2)];
+    RENDERCONTEXT   render;
+    Mixer*          pMixer = NULL;
+    AudioClip*      pClip = NULL;
+    MixerSound*     pSound = NULL;
+    Thread*         pRenderer = NULL;
+    UINT            i;
+
+    TestMakeWav(file, MIXER_CLIP_FRAMES, 2, MIXER_RATE);
+
+    if (TEST_CHECK(SUCCEEDED(
+            Mixer::CreateMixer(MIXER_RATE, &pMixer))) == FALSE)
+    {
+        return;
+    }
+
+    if (TEST_CHECK(SUCCEEDED(AudioClip::CreateAudioClipFromWav(
+            file,
+            sizeof(file),
+            MIXER_RATE,
+            pMixer->GetSamplePool(),
+            &pClip))) == FALSE)
+    {
+        goto cleanup;
+    }
+
+    if (TEST_CHECK(SUCCEEDED(pMixer->CreateSound(
+            pClip, 1, VOICE_STEAL_OLDEST, &pSound))) == FALSE)
+    {
+        delete pClip;
+        goto cleanup;
+    }
+
+    render.pMixer = pMixer;
+    render.lStop = 0;
+
+    if (TEST_CHECK(SUCCEEDED(
+            Thread::CreateThread(RenderLoop, &render, &pRenderer))) == FALSE)
+    {
+        goto cleanup;
+    }
+
+    for (i = 0; i < MIXER_ROUNDS; i++) {
+        pSound->SetGain((i & 1) ? 0.5f : 0.25f);
+        pSound->SetLoop((i & 2) ? TRUE : FALSE);
+        pSound->Play();
+        pSound->Stop();
+    }
+
+    pSound->SetLoop(TRUE);
+    pSound->Play();
+
+    TEST_CHECK(WaitForPlaying(pMixer, 1));
+    TEST_CHECK(pSound->IsPlaying());
+
+    pSound->Stop();
+
+    TEST_CHECK(WaitForPlaying(pMixer, 0));
+    TEST_CHECK(pSound->IsPlaying() == FALSE);
+
+    AtomicStoreRelease(&render.lStop, 1);
+    delete pRenderer;
+
+cleanup:
+    delete pMixer;
+    delete pSound;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+static VOID SetLater(LPVOID pContext)
+{
+    Thread::SleepThread(EVENT_DELAY);
+    ((ThreadEvent*) pContext)->Set();
+}
+
+// Auto-reset: one Set() lets exactly one Wait() through, whether it came
+// before the wait or during it
+static VOID CheckThreadEvent()
+{
+    ThreadEvent*    pEvent = NULL;
+    Thread*         pSetter = NULL;
+
+    if (TEST_CHECK(SUCCEEDED(
+            ThreadEvent::CreateThreadEvent(&pEvent))) == FALSE)
+    {
+        return;
+    }
+
+    TEST_CHECK(pEvent->Wait(EVENT_DELAY) == FALSE);
+
+    pEvent->Set();
+    pEvent->Set();
+
+    TEST_CHECK(pEvent->Wait(INFINITE));
+    TEST_CHECK(pEvent->Wait(0) == FALSE);
+
+    if (TEST_CHECK(SUCCEEDED(
+            Thread::CreateThread(SetLater, pEvent, &pSetter))))
+    {
+        TEST_CHECK(pEvent->Wait(INFINITE));
+        delete pSetter;
+    }
+
+    delete pEvent;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestQueue()
+{
+    CheckOrder();
+    CheckLastCommandWins();
+    CheckThreadEvent();
+}
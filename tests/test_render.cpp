@@ -0,0 +1,166 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test.h"
+#include "histogram.h"
+#include "thread.h"
+#include "triplebuffer.h"
+
+#define TRIPLE_ITEMS        (1024 * 1024)
+
+// Percentiles of 1..PERCENTILE_VALUES have to be this close
+#define PERCENTILE_VALUES   100000
+#define PERCENTILE_ERROR    0.125
+
+// Big enough that a torn copy is all but certain to be caught
+typedef struct _TRIPLEITEM {
+    UINT    uSequence;
+    UINT    uCheck[15];
+} TRIPLEITEM;
+
+typedef TripleBuffer<TRIPLEITEM> TESTTRIPLE;
+
+static UINT CheckValue(UINT uSequence, UINT i)
+{
+    return (uSequence + i) * 2654435761u;
+}
+
+static VOID PublishItems(LPVOID pContext)
+{
+    TESTTRIPLE* pBuffer = (TESTTRIPLE*) pContext;
+    TRIPLEITEM  item;
+    UINT        i, j;
+
+    for (i = 1; i <= TRIPLE_ITEMS; i++) {
+        item.uSequence = i;
+
+        for (j = 0; j < ARRAYSIZE(item.uCheck); j++) {
+            item.uCheck[j] = CheckValue(i, j);
+        }
+
+        pBuffer->Publish(item);
+    }
+}
+
+// Every value the reader gets has to be whole and newer than the last;
+// the newest one has to arrive in the end
+static VOID CheckTripleBuffer()
+{
+    static TESTTRIPLE   buffer;
+    Thread*             pWriter = NULL;
+    UINT                uLast = 0, cTorn = 0, cStale = 0;
+    UINT                j;
+
+    if (TEST_CHECK(SUCCEEDED(
+            Thread::CreateThread(PublishItems, &buffer, &pWriter))) == FALSE)
+    {
+        return;
+    }
+
+    while (uLast < TRIPLE_ITEMS) {
+        if (buffer.Acquire() == FALSE) {
+            Thread::YieldThread();
+            continue;
+        }
+
+        CONST TRIPLEITEM& item = buffer.GetFront();
+
+        for (j = 0; j < ARRAYSIZE(item.uCheck); j++) {
+            if (item.uCheck[j] != CheckValue(item.uSequence, j)) {
+                cTorn++;
+                break;
+            }
+        }
+
+        if (item.uSequence <= uLast) {
+            cStale++;
+        }
+
+        uLast = item.uSequence;
+    }
+
+    delete pWriter;
+
+    TEST_CHECK(cTorn == 0);
+    TEST_CHECK(cStale == 0);
+    TEST_CHECK(buffer.Acquire() == FALSE);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+// Every bucket has to start right after the one before it
+static VOID CheckBuckets()
+{
+    ULONG   ulLimit;
+    UINT    i, cErrors = 0;
+
+    for (i = 0; i < HISTOGRAM_BUCKETS; i++) {
+        ulLimit = Histogram::GetBucketLimit(i);
+
+        if (Histogram::GetBucket(ulLimit) != i ||
+            (i + 1 < HISTOGRAM_BUCKETS &&
+             Histogram::GetBucket(ulLimit + 1) != i + 1))
+        {
+            cErrors++;
+        }
+    }
+
+    TEST_CHECK(cErrors == 0);
+    TEST_CHECK(Histogram::GetBucketLimit(HISTOGRAM_BUCKETS - 1) ==
+               0xFFFFFFFFu);
+}
+
+// The percentiles of a known spread have to land within a bucket's width
+static VOID CheckPercentiles()
+{
+    static Histogram    histogram;
+    ULONG               ulExpected, ulValue;
+    DOUBLE              fPercentile;
+    UINT                cErrors = 0;
+
+    histogram.Reset();
+
+    for (ulValue = 1; ulValue <= PERCENTILE_VALUES; ulValue++) {
+        histogram.Record(ulValue);
+    }
+
+    TEST_CHECK(histogram.GetCount() == PERCENTILE_VALUES);
+
+    for (fPercentile = 10.0; fPercentile < 100.0; fPercentile += 10.0) {
+        ulExpected = (ULONG) (fPercentile / 100.0 * PERCENTILE_VALUES);
+        ulValue = histogram.GetPercentile(fPercentile);
+
+        if (ulValue < ulExpected ||
+            ulValue > ulExpected * (1.0 + PERCENTILE_ERROR))
+        {
+            cErrors++;
+        }
+    }
+
+    TEST_CHECK(cErrors == 0);
+
+    histogram.Reset();
+    TEST_CHECK(histogram.GetCount() == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestRender()
+{
+    CheckTripleBuffer();
+    CheckBuckets();
+    CheckPercentiles();
+}
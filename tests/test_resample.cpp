@@ -0,0 +1,176 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "resample.h"
+
+#define CLIP_FRAMES     4096
+#define CHECK_FRAMES    10000
+
+static UINT NextRandom(UINT* puState)
+{
+    *puState = *puState * 1664525 + 1013904223;
+    return *puState >> 8;
+}
+
+// Full scale noise, so clipping and rounding paths are taken
+static VOID FillClip(SHORT* psSamples, UINT cSamples)
+{
+    UINT uState = 1;
+    UINT i;
+
+    for (i = 0; i < cSamples; i++) {
+        psSamples[i] = (SHORT) (NextRandom(&uState) & 0xFFFF);
+    }
+}
+
+static ULONGLONG RateToStep(FLOAT fRate)
+{
+    return (ULONGLONG) ((DOUBLE) fRate * (DOUBLE) RESAMPLE_ONE);
+}
+
+// Renders CHECK_FRAMES in uneven blocks with a gain ramp
+static VOID RenderCheck(
+    CONST RESAMPLEKERNELS*  pKernels,
+    CONST SHORT*            psSamples,
+    UINT                    cChannels,
+    BOOL                    bLoop,
+    ULONGLONG               ullPosition,
+    ULONGLONG               ullStep,
+    FLOAT*                  pfOutput)
+{
+    UINT uFrame = 0;
+    UINT cFrames;
+
+    memset(pfOutput, 0, sizeof(FLOAT) * CHECK_FRAMES * 2);
+
+    while (uFrame < CHECK_FRAMES) {
+        cFrames = 1 + (uFrame * 7) % 301;
+
+        if (cFrames > CHECK_FRAMES - uFrame) {
+            cFrames = CHECK_FRAMES - uFrame;
+        }
+
+        ResampleClip(
+            pKernels,
+            pfOutput + uFrame * 2,
+            psSamples,
+            cChannels,
+            CLIP_FRAMES,
+            bLoop,
+            &ullPosition,
+            ullStep,
+            cFrames,
+            0.25f,
+            0.5f / cFrames);
+
+        uFrame += cFrames;
+    }
+}
+
+// Every level renders the scalar kernels' samples to the bit, at every
+// rate, looped or not
+static VOID CheckLevel(CONST SHORT* psSamples, CONST RESAMPLEKERNELS* pKernels)
+{
+    static CONST FLOAT RATES[] = { 0.25f, 0.5f, 0.8f, 1.0f, 1.37f, 4.0f };
+
+    CONST RESAMPLEKERNELS*  pReference;
+    static FLOAT            reference[CHECK_FRAMES * 2];
+    static FLOAT            output[CHECK_FRAMES * 2];
+    ULONGLONG               ullStart;
+    UINT                    cChannels, i, cDiffer = 0;
+    BOOL                    bLoop;
+
+    pReference = GetResampleKernelsForLevel(RESAMPLE_LEVEL_SCALAR);
+
+    for (cChannels = 1; cChannels <= 2; cChannels++) {
+        for (bLoop = FALSE; bLoop <= TRUE; bLoop++) {
+            for (i = 0; i < ARRAYSIZE(RATES); i++) {
+                // Fractional start, so 1.0 takes the kernels too
+                ullStart = RESAMPLE_ONE / 3;
+
+                RenderCheck(pReference, psSamples, cChannels, bLoop,
+                            ullStart, RateToStep(RATES[i]), reference);
+                RenderCheck(pKernels, psSamples, cChannels, bLoop,
+                            ullStart, RateToStep(RATES[i]), output);
+
+                if (memcmp(reference, output, sizeof(output)) != 0) {
+                    cDiffer++;
+                }
+            }
+        }
+    }
+
+    TEST_CHECK(cDiffer == 0);
+}
+
+// Whole frames at rate 1 are the samples themselves, and a clip that
+// does not loop stops at its end
+static VOID CheckUnity(CONST SHORT* psSamples, CONST RESAMPLEKERNELS* pKernels)
+{
+    static FLOAT    output[CLIP_FRAMES * 2];
+    ULONGLONG       ullPosition = 0;
+    UINT            cRendered, i, cDiffer = 0;
+
+    memset(output, 0, sizeof(output));
+
+    cRendered = ResampleClip(pKernels, output, psSamples, 2, CLIP_FRAMES,
+                             FALSE, &ullPosition, RESAMPLE_ONE,
+                             CLIP_FRAMES + 100, 1.0f, 0.0f);
+
+    TEST_CHECK(cRendered == CLIP_FRAMES);
+    TEST_CHECK(ullPosition == RESAMPLE_ONE * CLIP_FRAMES);
+
+    for (i = 0; i < CLIP_FRAMES * 2; i++) {
+        if (output[i] != (FLOAT) psSamples[i]) {
+            cDiffer++;
+        }
+    }
+
+    TEST_CHECK(cDiffer == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestResample()
+{
+    static CONST RESAMPLELEVEL levels[] = {
+        RESAMPLE_LEVEL_SCALAR,
+        RESAMPLE_LEVEL_SSE2
+    };
+
+    static SHORT            samples[CLIP_FRAMES * 2];
+    CONST RESAMPLEKERNELS*  pKernels;
+    UINT                    i;
+
+    FillClip(samples, ARRAYSIZE(samples));
+
+    for (i = 0; i < ARRAYSIZE(levels); i++) {
+        pKernels = GetResampleKernelsForLevel(levels[i]);
+
+        if (pKernels == NULL) {
+            continue;
+        }
+
+        CheckUnity(samples, pKernels);
+
+        if (levels[i] != RESAMPLE_LEVEL_SCALAR) {
+            CheckLevel(samples, pKernels);
+        }
+    }
+}
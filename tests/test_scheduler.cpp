@@ -0,0 +1,171 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "test.h"
+#include "framescheduler.h"
+
+#define CLOCK_FREQUENCY     1000000
+
+// 10 ms frames, accepted up to 1 ms early
+#define TEST_RATE           100.0f
+#define TEST_PERIOD         10000
+#define TEST_SLACK          1000
+
+// A frame is accepted from its deadline less the slack; one on time
+// keeps the cadence
+static VOID CheckOnTime()
+{
+    ManualClock     clock(CLOCK_FREQUENCY);
+    FrameScheduler  scheduler(&clock, TEST_RATE);
+
+    TEST_CHECK(scheduler.GetPeriod() == TEST_PERIOD);
+
+    TEST_CHECK(scheduler.BeginFrame());
+    TEST_CHECK(scheduler.GetNextDeadline() == TEST_PERIOD);
+
+    clock.SetTicks(TEST_PERIOD / 2);
+    TEST_CHECK(scheduler.BeginFrame() == FALSE);
+    TEST_CHECK(scheduler.GetNextDeadline() == TEST_PERIOD);
+
+    clock.SetTicks(TEST_PERIOD - TEST_SLACK - 1);
+    TEST_CHECK(scheduler.BeginFrame() == FALSE);
+
+    clock.SetTicks(TEST_PERIOD - TEST_SLACK);
+    TEST_CHECK(scheduler.BeginFrame());
+    TEST_CHECK(scheduler.GetNextDeadline() == TEST_PERIOD * 2);
+
+    // Behind, but by less than a period: still on the old cadence
+    clock.SetTicks(TEST_PERIOD * 3 - 1);
+    TEST_CHECK(scheduler.BeginFrame());
+    TEST_CHECK(scheduler.GetNextDeadline() == TEST_PERIOD * 3);
+
+    TEST_CHECK(scheduler.GetFrameCount() == 3);
+    TEST_CHECK(scheduler.GetLateFrameCount() == 0);
+}
+
+// A frame more than a period late restarts the cadence from now, so the
+// frames it missed are not drawn back to back
+static VOID CheckLate()
+{
+    ManualClock     clock(CLOCK_FREQUENCY);
+    FrameScheduler  scheduler(&clock, TEST_RATE);
+    LONGLONG        llLate;
+
+    TEST_CHECK(scheduler.BeginFrame());
+
+    llLate = TEST_PERIOD * 5 + 123;
+    clock.SetTicks(llLate);
+
+    TEST_CHECK(scheduler.BeginFrame());
+    TEST_CHECK(scheduler.GetLateFrameCount() == 1);
+    TEST_CHECK(scheduler.GetNextDeadline() == llLate + TEST_PERIOD);
+
+    TEST_CHECK(scheduler.BeginFrame() == FALSE);
+    TEST_CHECK(scheduler.GetTimeout() == (TEST_PERIOD - TEST_SLACK) / 1000);
+
+    clock.SetTicks(llLate + TEST_PERIOD);
+    TEST_CHECK(scheduler.BeginFrame());
+    TEST_CHECK(scheduler.GetLateFrameCount() == 1);
+    TEST_CHECK(scheduler.GetFrameCount() == 3);
+}
+
+// Whole milliseconds until the frame may start, rounded up, and 0 once
+// it may
+static VOID CheckTimeout()
+{
+    ManualClock     clock(CLOCK_FREQUENCY);
+    FrameScheduler  scheduler(&clock, TEST_RATE);
+
+    TEST_CHECK(scheduler.GetTimeout() == 0);
+    TEST_CHECK(scheduler.BeginFrame());
+
+    TEST_CHECK(scheduler.GetTimeout() == 9);
+
+    clock.SetTicks(5000);
+    TEST_CHECK(scheduler.GetTimeout() == 4);
+
+    clock.SetTicks(5001);
+    TEST_CHECK(scheduler.GetTimeout() == 4);
+
+    clock.SetTicks(TEST_PERIOD - TEST_SLACK - 1);
+    TEST_CHECK(scheduler.GetTimeout() == 1);
+
+    clock.SetTicks(TEST_PERIOD - TEST_SLACK);
+    TEST_CHECK(scheduler.GetTimeout() == 0);
+
+    clock.SetTicks(TEST_PERIOD * 4);
+    TEST_CHECK(scheduler.GetTimeout() == 0);
+}
+
+static VOID CheckTargetRate()
+{
+    ManualClock     clock(CLOCK_FREQUENCY);
+    FrameScheduler  scheduler(&clock);
+
+    TEST_CHECK(scheduler.GetTargetRate() == FRAME_RATE_DEFAULT);
+
+    scheduler.SetTargetRate(0.0f);
+    TEST_CHECK(scheduler.GetTargetRate() == FRAME_RATE_MIN);
+    TEST_CHECK(scheduler.GetPeriod() == CLOCK_FREQUENCY);
+
+    scheduler.SetTargetRate(-60.0f);
+    TEST_CHECK(scheduler.GetTargetRate() == FRAME_RATE_MIN);
+
+    scheduler.SetTargetRate(1e6f);
+    TEST_CHECK(scheduler.GetTargetRate() == FRAME_RATE_MAX);
+    TEST_CHECK(scheduler.GetPeriod() == CLOCK_FREQUENCY / 1000);
+
+    scheduler.SetTargetRate(144.0f);
+    TEST_CHECK(scheduler.GetTargetRate() == 144.0f);
+    TEST_CHECK(scheduler.GetPeriod() == CLOCK_FREQUENCY / 144);
+}
+
+static VOID CheckCounters()
+{
+    ManualClock     clock(CLOCK_FREQUENCY);
+    FrameScheduler  scheduler(&clock, TEST_RATE);
+    UINT            i;
+
+    for (i = 0; i < 5; i++) {
+        clock.SetTicks((LONGLONG) i * TEST_PERIOD);
+
+        if (TEST_CHECK(scheduler.BeginFrame()) == FALSE) {
+            return;
+        }
+
+        scheduler.EndFrame((i < 2) ? TRUE : FALSE);
+    }
+
+    clock.SetTicks(TEST_PERIOD * 20);
+    TEST_CHECK(scheduler.BeginFrame());
+    scheduler.EndFrame(TRUE);
+
+    TEST_CHECK(scheduler.GetFrameCount() == 6);
+    TEST_CHECK(scheduler.GetRenderedFrameCount() == 3);
+    TEST_CHECK(scheduler.GetSkippedFrameCount() == 3);
+    TEST_CHECK(scheduler.GetLateFrameCount() == 1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestScheduler()
+{
+    CheckOnTime();
+    CheckLate();
+    CheckTimeout();
+    CheckTargetRate();
+    CheckCounters();
+}
@@ -0,0 +1,328 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "test.h"
+#include "clock.h"
+#include "nullplatform.h"
+#include "pointer.h"
+#include "simulation.h"
+#include "spring.h"
+
+#define CLOCK_FREQUENCY     10000000
+
+#define SPRITE_SIZE         64
+
+// The pointer is pressed and released on these, and the rotation on
+// screen is compared across cadences there
+#define CHECKPOINT_INTERVAL 0.05
+#define CHECKPOINTS         40
+
+// One long spring update against many short ones
+#define SPRING_SPAN         0.2f
+#define SPRING_SLICES       200
+#define SPRING_TOLERANCE    1e-3f
+
+// Seconds a press or a release may take to come to rest
+#define SETTLE_TIME         0.5
+
+#define LONG_SESSION        3600.0      // Seconds
+#define LONG_SESSION_RATE   144.0       // Frames per second
+
+typedef struct _CADENCE {
+    DOUBLE  fFrameRate;
+    BOOL    bJitter;
+} CADENCE;
+
+// The first one is the reference
+static CONST CADENCE CADENCES[] = {
+    { 30.0,     FALSE },
+    { 60.0,     FALSE },
+    { 144.0,    FALSE },
+    { 1000.0,   FALSE },
+    { 60.0,     TRUE }
+};
+
+typedef struct _SIMCONTEXT {
+    ManualClock*    pClock;
+    Simulation*     pSimulation;
+    Pointer*        pPointer;
+} SIMCONTEXT;
+
+static UINT NextRandom(UINT* puState)
+{
+    *puState = *puState * 1664525u + 1013904223u;
+    return *puState >> 8;
+}
+
+static BOOL CreatePointer(RenderSink* pSink, Pointer* pPointer)
+{
+    static BYTE pixels[SPRITE_SIZE * SPRITE_SIZE * 4];
+    Sprite*     pSprite = NULL;
+
+    if (FAILED(Sprite::CreateSpriteFromPixels(
+            pSink,
+            SPRITE_SIZE,
+            SPRITE_SIZE,
+            SPRITE_SIZE * 4,
+            pixels,
+            &pSprite)))
+    {
+        return FALSE;
+    }
+
+    if (FAILED(pPointer->Initialize(
+            pSprite,
+            new NullSound(),
+            new NullSound())))
+    {
+        delete pSprite;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static FLOAT GetRotation(Pointer* pPointer)
+{
+    POINTERFRAME frame;
+
+    pPointer->GetFrame(&frame);
+    return frame.fRotation;
+}
+
+// What Engine::Tick does with the simulation
+static VOID Frame(SIMCONTEXT* pContext)
+{
+    UINT cSteps, i;
+
+    cSteps = pContext->pSimulation->Advance();
+
+    for (i = 0; i < cSteps; i++) {
+        pContext->pPointer->Step(pContext->pSimulation->GetStepTime());
+    }
+
+    pContext->pPointer->Update(
+        cSteps * pContext->pSimulation->GetStepTime(),
+        pContext->pSimulation->GetAlpha());
+}
+
+// Runs frames at the cadence and collects the rotation on screen at each
+// checkpoint; presses and releases alternate on every fourth one
+static BOOL RunCadence(CONST CADENCE* pCadence, FLOAT* pfAngles)
+{
+    ManualClock     clock(CLOCK_FREQUENCY);
+    NullRenderSink  sink(256.0f, 256.0f);
+    Simulation      simulation(&clock);
+    Pointer         pointer;
+    SIMCONTEXT      context = { &clock, &simulation, &pointer };
+    LONGLONG        llFrame, llCheckpoint, llPeriod;
+    UINT            uRandom = 1;
+    UINT            i;
+
+    if (CreatePointer(&sink, &pointer) == FALSE) {
+        return FALSE;
+    }
+
+    llPeriod = (LONGLONG) (CLOCK_FREQUENCY / pCadence->fFrameRate);
+    llFrame = llPeriod;
+
+    for (i = 0; i < CHECKPOINTS; i++) {
+        llCheckpoint = (LONGLONG) ((i + 1) * CHECKPOINT_INTERVAL *
+                                   CLOCK_FREQUENCY);
+
+        while (llFrame < llCheckpoint) {
+            clock.SetTicks(llFrame);
+            Frame(&context);
+
+            llFrame += llPeriod;
+
+            if (pCadence->bJitter == TRUE) {
+                llFrame += (LONGLONG) (NextRandom(&uRandom) % llPeriod) -
+                           llPeriod / 2;
+            }
+        }
+
+        // Input lands on a frame, as it does in Engine
+        clock.SetTicks(llCheckpoint);
+        Frame(&context);
+
+        pfAngles[i] = GetRotation(&pointer);
+
+        if (i % 8 == 0) {
+            pointer.OnPress();
+        } else if (i % 8 == 4) {
+            pointer.OnRelease();
+        }
+    }
+
+    return TRUE;
+}
+
+// Fixed steps make what is on screen at an input independent of the
+// frame rate and of jitter in it
+static VOID CheckCadences()
+{
+    static FLOAT    reference[CHECKPOINTS];
+    static FLOAT    angles[CHECKPOINTS];
+    UINT            cDiffering = 0;
+    UINT            i, j;
+
+    if (TEST_CHECK(RunCadence(&CADENCES[0], reference)) == FALSE) {
+        return;
+    }
+
+    for (i = 1; i < ARRAYSIZE(CADENCES); i++) {
+        if (TEST_CHECK(RunCadence(&CADENCES[i], angles)) == FALSE) {
+            return;
+        }
+
+        for (j = 0; j < CHECKPOINTS; j++) {
+            if (memcmp(&angles[j], &reference[j], sizeof(FLOAT)) != 0) {
+                cDiffering++;
+            }
+        }
+    }
+
+    TEST_CHECK(cDiffering == 0);
+}
+
+// Nothing may be dropped or lost to rounding in an hour of steps
+static VOID CheckLongSession()
+{
+    ManualClock     clock(CLOCK_FREQUENCY);
+    NullRenderSink  sink(256.0f, 256.0f);
+    Simulation      simulation(&clock);
+    Pointer         pointer;
+    SIMCONTEXT      context = { &clock, &simulation, &pointer };
+    LONGLONG        llPeriod;
+    ULONG           cFrames, i;
+
+    if (TEST_CHECK(CreatePointer(&sink, &pointer)) == FALSE) {
+        return;
+    }
+
+    llPeriod = (LONGLONG) (CLOCK_FREQUENCY / LONG_SESSION_RATE);
+    cFrames = (ULONG) (LONG_SESSION * LONG_SESSION_RATE);
+
+    for (i = 0; i < cFrames; i++) {
+        clock.Advance(llPeriod);
+
+        if (i % 72 == 0) {
+            pointer.OnPress();
+        } else if (i % 72 == 36) {
+            pointer.OnRelease();
+        }
+
+        Frame(&context);
+    }
+
+    TEST_CHECK(simulation.GetDroppedStepCount() == 0);
+    TEST_CHECK(simulation.GetStepCount() ==
+               (ULONGLONG) (cFrames * llPeriod * SIMULATION_RATE_DEFAULT /
+                            CLOCK_FREQUENCY));
+}
+
+// The closed form has to land in the same place however the time is cut
+// up, carry its velocity through a retarget and rest at the target
+static VOID CheckSpring()
+{
+    Spring  whole(0.0f, 30.0f, 0.01f);
+    Spring  sliced(0.0f, 30.0f, 0.01f);
+    FLOAT   fVelocity;
+    UINT    i;
+
+    whole.SetTarget(-45.0f);
+    sliced.SetTarget(-45.0f);
+
+    whole.Update(SPRING_SPAN);
+
+    for (i = 0; i < SPRING_SLICES; i++) {
+        sliced.Update(SPRING_SPAN / SPRING_SLICES);
+    }
+
+    TEST_CHECK(fabsf(whole.GetValue() - sliced.GetValue()) <=
+               SPRING_TOLERANCE);
+
+    fVelocity = sliced.GetVelocity();
+    sliced.SetTarget(0.0f);
+
+    TEST_CHECK(sliced.GetVelocity() == fVelocity);
+
+    // However long the frame, no overshoot and no blow-up
+    sliced.Update(1000.0f);
+
+    TEST_CHECK(sliced.IsAtRest() == TRUE);
+    TEST_CHECK(sliced.GetValue() == 0.0f);
+}
+
+// Mid press the pointer has to keep drawing, and once the springs come
+// to rest it has to go idle so the engine stops rendering
+static VOID CheckSettle()
+{
+    ManualClock     clock(CLOCK_FREQUENCY);
+    NullRenderSink  sink(256.0f, 256.0f);
+    Simulation      simulation(&clock);
+    Pointer         pointer;
+    SIMCONTEXT      context = { &clock, &simulation, &pointer };
+    LONGLONG        llPeriod = CLOCK_FREQUENCY / 60;
+    UINT            i, cFrames = (UINT) (SETTLE_TIME * 60.0);
+
+    if (TEST_CHECK(CreatePointer(&sink, &pointer)) == FALSE) {
+        return;
+    }
+
+    pointer.OnPress();
+
+    // Turned around a few frames in, the way a quick click does
+    for (i = 0; i < 3; i++) {
+        clock.Advance(llPeriod);
+        Frame(&context);
+    }
+
+    TEST_CHECK(pointer.IsIdle() == FALSE);
+
+    pointer.OnRelease();
+
+    for (i = 0; i < cFrames; i++) {
+        clock.Advance(llPeriod);
+        Frame(&context);
+    }
+
+    TEST_CHECK(pointer.IsIdle() == TRUE);
+    TEST_CHECK(GetRotation(&pointer) == 0.0f);
+
+    pointer.OnPress();
+
+    for (i = 0; i < cFrames; i++) {
+        clock.Advance(llPeriod);
+        Frame(&context);
+    }
+
+    TEST_CHECK(pointer.IsIdle() == TRUE);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestSimulation()
+{
+    CheckCadences();
+    CheckLongSession();
+    CheckSpring();
+    CheckSettle();
+}
@@ -0,0 +1,319 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "test.h"
+#include "spritecache.h"
+#include "sprite.h"
+#include "safemem.h"
+
+#define SPRITE_SIZE     32
+
+// Key and size of a frame at scale 1 without rotation: the bitmap plus
+// half a texel of bleed, rounded out
+#define FRAME_SIZE      (SPRITE_SIZE + 2)
+#define FRAME_BYTES     (FRAME_SIZE * FRAME_SIZE * 4)
+
+typedef struct _CACHEFIXTURE {
+    MipChain*           pMips;
+    SoftwareRenderSink* pSink;
+    SpriteCache*        pCache;
+} CACHEFIXTURE;
+
+static VOID DestroyFixture(CACHEFIXTURE* pFixture)
+{
+    SafeDelete(&(pFixture->pCache));
+    SafeDelete(&(pFixture->pSink));
+    SafeDelete(&(pFixture->pMips));
+}
+
+// An opaque white sprite and a cache for it with cbBudget bytes
+static BOOL CreateFixture(SIZE_T cbBudget, CACHEFIXTURE* pFixture)
+{
+    static BYTE pixels[SPRITE_SIZE * SPRITE_SIZE * 4];
+    HRESULT     hResult;
+
+    memset(pFixture, 0, sizeof(CACHEFIXTURE));
+    memset(pixels, 0xFF, sizeof(pixels));
+
+    hResult = MipChain::CreateMipChain(
+        SPRITE_SIZE,
+        SPRITE_SIZE,
+        SPRITE_SIZE * 4,
+        pixels,
+        &(pFixture->pMips));
+
+    if (SUCCEEDED(hResult)) {
+        hResult = SoftwareRenderSink::CreateSoftwareRenderSink(
+            1,
+            1,
+            &(pFixture->pSink));
+    }
+
+    if (SUCCEEDED(hResult)) {
+        hResult = SpriteCache::CreateSpriteCache(
+            pFixture->pMips,
+            pFixture->pSink,
+            cbBudget,
+            &(pFixture->pCache));
+    }
+
+    if (TEST_CHECK(SUCCEEDED(hResult)) == FALSE) {
+        DestroyFixture(pFixture);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static SPRITEFRAMEKEY MakeKey(INT iAngle, INT iScale)
+{
+    SPRITEFRAMEKEY key;
+
+    key.iAngle  = iAngle;
+    key.iScaleX = iScale;
+    key.iScaleY = iScale;
+
+    return key;
+}
+
+static VOID CheckQuantize()
+{
+    CACHEFIXTURE    fixture;
+    SPRITEFRAMEKEY  key;
+    Geometry::Size  scale;
+
+    if (CreateFixture(FRAME_BYTES, &fixture) == FALSE) {
+        return;
+    }
+
+    key = fixture.pCache->Quantize(4.4f, Geometry::MakeSize(1.0f, 0.96f));
+    TEST_CHECK(key.iAngle == 1);
+    TEST_CHECK(key.iScaleX == 50 && key.iScaleY == 48);
+
+    key = fixture.pCache->Quantize(-1.4f, Geometry::MakeSize(0.5f, 0.5f));
+    TEST_CHECK(key.iAngle == 0);
+    TEST_CHECK(key.iScaleX == 25 && key.iScaleY == 25);
+
+    key = fixture.pCache->Quantize(-45.0f, Geometry::MakeSize(1.0f, 1.0f));
+    TEST_CHECK(key.iAngle == -15);
+
+    // 90% at 125% DPI is drawn at 1.125, not at the nearest grid step
+    fixture.pCache->SetUnitScale(0.9f * 1.25f);
+
+    key = fixture.pCache->Quantize(0.0f, Geometry::MakeSize(1.125f, 1.125f));
+    scale = fixture.pCache->GetKeyScale(key);
+
+    TEST_CHECK(key.iScaleX == 50 && key.iScaleY == 50);
+    TEST_CHECK(scale.width == 1.125f && scale.height == 1.125f);
+
+    DestroyFixture(&fixture);
+}
+
+static VOID CheckUnitScale()
+{
+    CACHEFIXTURE        fixture;
+    SPRITEFRAME         frame;
+    SPRITECACHESTATS    stats;
+    Geometry::Rect      rect;
+
+    if (CreateFixture(FRAME_BYTES * 4, &fixture) == FALSE) {
+        return;
+    }
+
+    fixture.pCache->GetFrame(MakeKey(0, 50), &frame);
+
+    // The same key is twice as large at twice the unit, and the frame
+    // rendered for the old unit is gone
+    fixture.pCache->SetUnitScale(2.0f);
+    fixture.pCache->GetStats(&stats);
+    TEST_CHECK(stats.cFrames == 0 && stats.cbUsed == 0);
+
+    rect = fixture.pCache->GetFrameRect(MakeKey(0, 25));
+    TEST_CHECK(rect.left == -1.0f && rect.right == SPRITE_SIZE + 1);
+
+    rect = fixture.pCache->GetFrameRect(MakeKey(0, 50));
+    TEST_CHECK(rect.right - rect.left == 2 * SPRITE_SIZE + 2);
+
+    // Nonsense is ignored
+    fixture.pCache->SetUnitScale(0.0f);
+    TEST_CHECK(fixture.pCache->GetUnitScale() == 2.0f);
+
+    DestroyFixture(&fixture);
+}
+
+static VOID CheckHitMiss()
+{
+    CACHEFIXTURE                fixture;
+    SPRITEFRAME                 frame, again;
+    SPRITECACHESTATS            stats;
+    CONST SoftwareRenderBitmap* pBitmap;
+    Geometry::Rect              rect;
+
+    if (CreateFixture(FRAME_BYTES * 4, &fixture) == FALSE) {
+        return;
+    }
+
+    rect = fixture.pCache->GetFrameRect(MakeKey(0, 50));
+    TEST_CHECK(rect.left == -1.0f && rect.top == -1.0f);
+    TEST_CHECK(rect.right == SPRITE_SIZE + 1 && rect.bottom == SPRITE_SIZE + 1);
+
+    if (TEST_CHECK(fixture.pCache->GetFrame(MakeKey(0, 50), &frame) == S_OK) ==
+        FALSE)
+    {
+        DestroyFixture(&fixture);
+        return;
+    }
+
+    TEST_CHECK(frame.lOffsetX == -1 && frame.lOffsetY == -1);
+
+    pBitmap = (CONST SoftwareRenderBitmap*) frame.pBitmap;
+    TEST_CHECK(pBitmap->GetWidth() == FRAME_SIZE);
+    TEST_CHECK(pBitmap->GetHeight() == FRAME_SIZE);
+
+    // Opaque in the middle, nothing outside the bleed
+    TEST_CHECK(pBitmap->GetPixels()[
+        (FRAME_SIZE / 2) * pBitmap->GetStride() + (FRAME_SIZE / 2) * 4 + 3] ==
+        0xFF);
+    TEST_CHECK(pBitmap->GetPixels()[3] == 0);
+
+    TEST_CHECK(fixture.pCache->GetFrame(MakeKey(0, 50), &again) == S_OK);
+    TEST_CHECK(again.pBitmap == frame.pBitmap);
+
+    fixture.pCache->GetStats(&stats);
+    TEST_CHECK(stats.cFrames == 1);
+    TEST_CHECK(stats.cHits == 1 && stats.cMisses == 1);
+    TEST_CHECK(stats.cbUsed == FRAME_BYTES);
+
+    // Nothing to draw at scale 0
+    TEST_CHECK(fixture.pCache->GetFrame(MakeKey(0, 0), &frame) == S_FALSE);
+    TEST_CHECK(frame.pBitmap == NULL);
+
+    fixture.pCache->Clear();
+    fixture.pCache->GetStats(&stats);
+    TEST_CHECK(stats.cFrames == 0 && stats.cbUsed == 0);
+
+    DestroyFixture(&fixture);
+}
+
+static VOID CheckEviction()
+{
+    CACHEFIXTURE        fixture;
+    SPRITEFRAME         frame;
+    SPRITECACHESTATS    stats;
+
+    // Room for two unrotated frames
+    if (CreateFixture(FRAME_BYTES * 2, &fixture) == FALSE) {
+        return;
+    }
+
+    fixture.pCache->GetFrame(MakeKey(0, 50), &frame);
+    fixture.pCache->GetFrame(MakeKey(0, 49), &frame);
+
+    // Touch the first so the second is the least recently used
+    fixture.pCache->GetFrame(MakeKey(0, 50), &frame);
+    TEST_CHECK(fixture.pCache->GetFrame(MakeKey(0, 48), &frame) == S_OK);
+
+    fixture.pCache->GetStats(&stats);
+    TEST_CHECK(stats.cEvictions == 1);
+    TEST_CHECK(stats.cFrames == 2);
+    TEST_CHECK(stats.cbUsed <= stats.cbBudget);
+
+    fixture.pCache->GetFrame(MakeKey(0, 50), &frame);
+    fixture.pCache->GetStats(&stats);
+    TEST_CHECK(stats.cHits == 2);
+
+    fixture.pCache->GetFrame(MakeKey(0, 49), &frame);
+    fixture.pCache->GetStats(&stats);
+    TEST_CHECK(stats.cMisses == 4);
+
+    // A frame larger than the whole budget is refused, not cached
+    TEST_CHECK(fixture.pCache->GetFrame(MakeKey(0, 150), &frame) ==
+        E_OUTOFMEMORY);
+
+    DestroyFixture(&fixture);
+}
+
+static BOOL IsWhole(CONST Geometry::Rect& rect)
+{
+    return rect.left == floorf(rect.left) && rect.top == floorf(rect.top) &&
+           rect.right == floorf(rect.right) &&
+           rect.bottom == floorf(rect.bottom);
+}
+
+static VOID CheckSpriteScale()
+{
+    static BYTE         pixels[SPRITE_SIZE * SPRITE_SIZE * 4];
+    SoftwareRenderSink* pSink = NULL;
+    Sprite*             pSprite = NULL;
+    Geometry::Rect      bounds;
+    HRESULT             hResult;
+
+    hResult = SoftwareRenderSink::CreateSoftwareRenderSink(64, 64, &pSink);
+
+    if (SUCCEEDED(hResult)) {
+        hResult = Sprite::CreateSpriteFromPixels(
+            pSink,
+            SPRITE_SIZE,
+            SPRITE_SIZE,
+            SPRITE_SIZE * 4,
+            pixels,
+            &pSprite);
+    }
+
+    if (SUCCEEDED(hResult)) {
+        hResult = pSprite->EnableFrameCache(pSink, FRAME_BYTES * 8);
+    }
+
+    if (TEST_CHECK(SUCCEEDED(hResult)) == FALSE) {
+        SafeDelete(&pSprite);
+        SafeDelete(&pSink);
+        return;
+    }
+
+    pSprite->SetPosition(Geometry::MakePoint(10.25f, 10.25f));
+    pSprite->SetFrameCacheScale(0.9f);
+
+    // At rest on the grid: a cached frame at a whole pixel
+    pSprite->SetScale(Geometry::MakeSize(0.9f * 0.92f, 0.9f * 0.92f));
+    bounds = pSprite->GetBounds();
+    TEST_CHECK(IsWhole(bounds));
+    TEST_CHECK(SUCCEEDED(pSprite->Draw(pSink)));
+
+    // On the way there: drawn as it is, not snapped to the next step
+    pSprite->SetScale(Geometry::MakeSize(0.9f * 0.95f, 0.9f * 0.95f));
+    bounds = pSprite->GetBounds();
+    TEST_CHECK(IsWhole(bounds) == FALSE);
+    TEST_CHECK(fabsf(bounds.right - bounds.left - SPRITE_SIZE * 0.9f * 0.95f) <
+        1e-3f);
+    TEST_CHECK(SUCCEEDED(pSprite->Draw(pSink)));
+
+    SafeDelete(&pSprite);
+    SafeDelete(&pSink);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestSpriteCache()
+{
+    CheckQuantize();
+    CheckUnitScale();
+    CheckHitMiss();
+    CheckEviction();
+    CheckSpriteScale();
+}
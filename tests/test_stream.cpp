@@ -0,0 +1,269 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "testflac.h"
+#include "audiostream.h"
+#include "flacfile.h"
+#include "mixer.h"
+#include "thread.h"
+
+#define STREAM_RATE         48000
+#define STREAM_FRAMES       48000   // One second
+#define SHORT_FRAMES        1000    // Fits in the prime
+#define RANGE_FRAMES        64
+
+#define RENDER_BLOCK        256
+#define RENDER_PAUSE        2       // Milliseconds between blocks
+#define RENDER_TAIL         5000    // Frames rendered past the end
+
+static SHORT    s_samples[STREAM_FRAMES * 2];
+static BYTE     s_file[STREAM_FRAMES * 2 * 4];
+
+// Every frame decodes back to exactly what went in, and a damaged one
+// is caught
+static VOID CheckRoundTrip(UINT cChannels)
+{
+    static INT      scratch[TEST_FLAC_BLOCK * 2];
+    static SHORT    block[TEST_FLAC_BLOCK * 2];
+    static BYTE     damaged[sizeof(s_file)];
+    FLACINFO        info;
+    SIZE_T          cbFile, cbOffset, cbFirst;
+    UINT            uFrame = 0, cBlock;
+    HRESULT         hResult;
+    BOOL            bSame = TRUE;
+
+    TestFillSignal(s_samples, cChannels, STREAM_FRAMES);
+
+    cbFile = TestEncodeFlac(s_samples, cChannels, STREAM_FRAMES, STREAM_RATE,
+                            s_file, sizeof(s_file));
+
+    if (TEST_CHECK(cbFile != 0) == FALSE ||
+        TEST_CHECK(SUCCEEDED(ParseFlac(s_file, cbFile, &info))) == FALSE)
+    {
+        return;
+    }
+
+    TEST_CHECK(info.cChannels == cChannels);
+    TEST_CHECK(info.uSampleRate == STREAM_RATE);
+    TEST_CHECK(info.ullFrames == STREAM_FRAMES);
+    TEST_CHECK(info.cMaxBlockFrames == TEST_FLAC_BLOCK);
+
+    cbOffset = info.cbFirstFrame;
+
+    for (;;) {
+        hResult = DecodeFlacFrame(s_file, cbFile, info, &cbOffset,
+                                  scratch, block, &cBlock);
+
+        if (hResult != S_OK) {
+            break;
+        }
+
+        if (uFrame + cBlock > STREAM_FRAMES ||
+            memcmp(block, s_samples + (SIZE_T) uFrame * cChannels,
+                   (SIZE_T) cBlock * cChannels * sizeof(SHORT)) != 0)
+        {
+            bSame = FALSE;
+            break;
+        }
+
+        uFrame += cBlock;
+    }
+
+    TEST_CHECK(bSame);
+    TEST_CHECK(hResult == S_FALSE);
+    TEST_CHECK(uFrame == STREAM_FRAMES);
+
+    // One flipped bit in the middle of the first frame
+    memcpy(damaged, s_file, cbFile);
+
+    cbFirst = info.cbFirstFrame;
+    damaged[cbFirst + 100] ^= 0x10;
+
+    TEST_CHECK(DecodeFlacFrame(damaged, cbFile, info, &cbFirst,
+                               scratch, block, &cBlock) == E_FAIL);
+}
+
+// A predictor that walks past 16 bits fails the frame, for fixed and
+// LPC subframes alike, while the same shape kept in range decodes
+static VOID CheckOutOfRange()
+{
+    static CONST UINT CHOICES[3] = { 1, 3, 4 };
+
+    static INT      scratch[TEST_FLAC_BLOCK * 2];
+    static SHORT    block[TEST_FLAC_BLOCK * 2];
+    INT             plane[RANGE_FRAMES];
+    UINT            uState = 11;
+    FLACINFO        info;
+    SIZE_T          cbFile, cbOffset;
+    UINT            cBlock, uStep, i, j;
+    HRESULT         hResult;
+
+    for (i = 0; i < 3; i++) {
+        for (uStep = 100; uStep <= 1000; uStep += 900) {
+            for (j = 0; j < RANGE_FRAMES; j++) {
+                uState = uState * 1664525 + 1013904223;
+                plane[j] = (INT) (j * uStep) - 16000 +
+                           (INT) (uState >> 28);
+            }
+
+            cbFile = TestEncodeFlacPlane(plane, RANGE_FRAMES, CHOICES[i],
+                                         STREAM_RATE, s_file,
+                                         sizeof(s_file));
+
+            if (TEST_CHECK(cbFile != 0) == FALSE ||
+                TEST_CHECK(SUCCEEDED(ParseFlac(s_file, cbFile,
+                                               &info))) == FALSE)
+            {
+                continue;
+            }
+
+            cbOffset = info.cbFirstFrame;
+            hResult = DecodeFlacFrame(s_file, cbFile, info, &cbOffset,
+                                      scratch, block, &cBlock);
+
+            TEST_CHECK(hResult == ((uStep == 100) ? S_OK : E_FAIL));
+        }
+    }
+}
+
+// Plays the stream through a mixer, paced so the decoder keeps up, and
+// compares with the source; returns the frames that differ
+static UINT PlayStream(
+    AudioStream*    pStream,
+    UINT            cChannels,
+    UINT            cFrames,
+    BOOL            bLoop,
+    ULONG*          pcUnderruns)
+{
+    static FLOAT        output[RENDER_BLOCK * MIXER_CHANNELS];
+    Mixer*              pMixer = NULL;
+    MixerSound*         pSound = NULL;
+    AUDIOSTREAMSTATS    stats;
+    CONST SHORT*        ps;
+    UINT                uFrame, cDiffer = 0, i;
+    FLOAT               fLeft, fRight;
+
+    *pcUnderruns = 0;
+
+    if (FAILED(Mixer::CreateMixer(STREAM_RATE, &pMixer))) {
+        delete pStream;
+        return cFrames;
+    }
+
+    if (FAILED(pMixer->CreateStreamSound(pStream, VOICE_STEAL_OLDEST,
+                                         &pSound)))
+    {
+        delete pStream;
+        delete pMixer;
+        return cFrames;
+    }
+
+    pSound->SetLoop(bLoop);
+    pSound->Play();
+
+    // Gives the decoder a moment to fill the buffers after the prime
+    Thread::SleepThread(RENDER_PAUSE * 4);
+
+    for (uFrame = 0; uFrame < cFrames + RENDER_TAIL; uFrame += RENDER_BLOCK) {
+        pMixer->Render(output, RENDER_BLOCK);
+
+        for (i = 0; i < RENDER_BLOCK; i++) {
+            if (bLoop == TRUE || uFrame + i < cFrames) {
+                ps = s_samples + (SIZE_T) ((uFrame + i) % cFrames) * cChannels;
+                fLeft = ps[0] * (1.0f / 32768.0f);
+                fRight = ps[cChannels - 1] * (1.0f / 32768.0f);
+            } else {
+                fLeft = 0.0f;
+                fRight = 0.0f;
+            }
+
+            if (output[i * 2] != fLeft || output[i * 2 + 1] != fRight) {
+                cDiffer++;
+            }
+        }
+
+        Thread::SleepThread(RENDER_PAUSE);
+    }
+
+    pStream->GetStats(&stats);
+    *pcUnderruns = stats.cUnderruns;
+
+    delete pSound;
+    delete pMixer;
+
+    return cDiffer;
+}
+
+static VOID CheckPlayback(UINT cChannels)
+{
+    AudioStream*    pStream = NULL;
+    SIZE_T          cbFile;
+    ULONG           cUnderruns;
+    UINT            cDiffer;
+    BOOL            bLoop;
+
+    TestFillSignal(s_samples, cChannels, STREAM_FRAMES);
+
+    cbFile = TestEncodeFlac(s_samples, cChannels, STREAM_FRAMES, STREAM_RATE,
+                            s_file, sizeof(s_file));
+
+    for (bLoop = FALSE; bLoop <= TRUE; bLoop++) {
+        if (TEST_CHECK(SUCCEEDED(AudioStream::CreateAudioStream(
+                s_file, cbFile, 1, &pStream))) == FALSE)
+        {
+            continue;
+        }
+
+        TEST_CHECK(pStream->IsResident() == FALSE);
+
+        cDiffer = PlayStream(pStream, cChannels, STREAM_FRAMES, bLoop,
+                             &cUnderruns);
+
+        // A starved voice plays silence; only then may output differ
+        TEST_CHECK(cUnderruns != 0 || cDiffer == 0);
+    }
+
+    // Short enough to be held whole and played without the thread
+    cbFile = TestEncodeFlac(s_samples, cChannels, SHORT_FRAMES, STREAM_RATE,
+                            s_file, sizeof(s_file));
+
+    if (TEST_CHECK(SUCCEEDED(AudioStream::CreateAudioStream(
+            s_file, cbFile, 1, &pStream))) == FALSE)
+    {
+        return;
+    }
+
+    TEST_CHECK(pStream->IsResident());
+    TEST_CHECK(PlayStream(pStream, cChannels, SHORT_FRAMES, TRUE,
+                          &cUnderruns) == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestStream()
+{
+    UINT cChannels;
+
+    CheckOutOfRange();
+
+    for (cChannels = 1; cChannels <= 2; cChannels++) {
+        CheckRoundTrip(cChannels);
+        CheckPlayback(cChannels);
+    }
+}
@@ -0,0 +1,398 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "atomic.h"
+#include "clock.h"
+#include "thread.h"
+#include "trace.h"
+
+#define TRACE_FILE          "fp_test_trace.json"
+
+#define TRACE_NAME_MAX      64
+
+#define SHORT_EVENTS        10
+#define WRAP_EVENTS         (TRACE_EVENTS + 100)
+#define REUSE_THREADS       (TRACE_THREADS * 2)
+#define SPIN_WRITES         20
+
+// Threads that each take a buffer and end, more of them than there are
+// buffers
+static CONST LPCSTR ONCE_NAMES[] = {
+    "trace.once0", "trace.once1", "trace.once2", "trace.once3",
+    "trace.once4", "trace.once5", "trace.once6", "trace.once7",
+    "trace.once8", "trace.once9", "trace.onceA", "trace.onceB"
+};
+
+typedef struct _TRACETHREAD {
+    LPCSTR          pszThread;
+    LPCSTR          pszEvent;
+    UINT            uFirst;         // Sequence of the first event
+    UINT            cEvents;        // 0 records until lStop
+    volatile LONG   lStop;
+} TRACETHREAD;
+
+// What ReadTrace() found for one event name and one thread name
+typedef struct _TRACEREAD {
+    LPCSTR  pszEvent;
+    LPCSTR  pszThread;
+    UINT    cEvents;
+    UINT    cThreadNames;
+    LONG    lTid;           // -1 when the events come from several
+    UINT    uFirst;         // Sequence of the first event
+    UINT    uLast;
+    BOOL    bInOrder;       // Every sequence one past the one before
+} TRACEREAD;
+
+// Scopes are numbered by starting them a millisecond apart
+static LONGLONG SequenceToTicks(UINT uSequence)
+{
+    SystemClock clock;
+
+    return (LONGLONG) uSequence * (clock.GetFrequency() / 1000);
+}
+
+static VOID RecordEvents(LPVOID pContext)
+{
+    TRACETHREAD*    pThread = (TRACETHREAD*) pContext;
+    LONGLONG        llStart;
+    UINT            i;
+
+    if (pThread->pszThread != NULL) {
+        Trace::SetThreadName(pThread->pszThread);
+    }
+
+    for (i = 0; pThread->cEvents == 0 || i < pThread->cEvents; i++) {
+        if (pThread->cEvents == 0 &&
+            AtomicLoadAcquire(&pThread->lStop) != 0)
+        {
+            break;
+        }
+
+        llStart = SequenceToTicks(pThread->uFirst + i);
+        Trace::Record(pThread->pszEvent, llStart, llStart + 1);
+    }
+
+    Trace::EndThread();
+}
+
+static BOOL RunThread(LPCSTR pszThread, LPCSTR pszEvent, UINT uFirst,
+                      UINT cEvents)
+{
+    TRACETHREAD thread;
+    Thread*     pThread = NULL;
+
+    memset(&thread, 0, sizeof(thread));
+    thread.pszThread = pszThread;
+    thread.pszEvent = pszEvent;
+    thread.uFirst = uFirst;
+    thread.cEvents = cEvents;
+
+    if (FAILED(Thread::CreateThread(RecordEvents, &thread, &pThread))) {
+        return FALSE;
+    }
+
+    delete pThread;
+    return TRUE;
+}
+
+// Checks one line of the traceEvents array and takes what pRead is
+// after from it
+static BOOL ReadLine(LPCSTR pszLine, SIZE_T cchLine, TRACEREAD* pRead)
+{
+    CHAR    szName[TRACE_NAME_MAX];
+    DOUBLE  fTimestamp, fDuration;
+    long    lTid;
+    UINT    uSequence;
+    INT     cchRead = 0;
+
+    if (sscanf(pszLine,
+               "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+               "\"tid\":%ld,\"args\":{\"name\":\"%63[^\"]\"}}%n",
+               &lTid, szName, &cchRead) == 2 &&
+        (SIZE_T) cchRead == cchLine)
+    {
+        if (strcmp(szName, pRead->pszThread) == 0) {
+            pRead->cThreadNames++;
+        }
+
+        return TRUE;
+    }
+
+    if (sscanf(pszLine,
+               "{\"name\":\"%63[^\"]\",\"ph\":\"X\",\"pid\":1,"
+               "\"tid\":%ld,\"ts\":%lf,\"dur\":%lf}%n",
+               szName, &lTid, &fTimestamp, &fDuration, &cchRead) != 4 ||
+        (SIZE_T) cchRead != cchLine || fDuration < 0.0)
+    {
+        return FALSE;
+    }
+
+    if (strcmp(szName, pRead->pszEvent) != 0) {
+        return TRUE;
+    }
+
+    uSequence = (UINT) (fTimestamp / 1000.0 + 0.5);
+
+    if (pRead->cEvents == 0) {
+        pRead->lTid = (LONG) lTid;
+        pRead->uFirst = uSequence;
+    } else {
+        if (pRead->lTid != (LONG) lTid) {
+            pRead->lTid = -1;
+        }
+
+        if (uSequence != pRead->uLast + 1) {
+            pRead->bInOrder = FALSE;
+        }
+    }
+
+    pRead->uLast = uSequence;
+    pRead->cEvents++;
+
+    return TRUE;
+}
+
+// Writes the trace and reads it back; FALSE when it is not the JSON
+// WriteJson() is meant to write
+static BOOL ReadTrace(TRACEREAD* pRead)
+{
+    static CONST CHAR   HEADER[] =
+        "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    static CONST CHAR   FOOTER[] = "\n]}\n";
+
+    FILE*   pFile = NULL;
+    CHAR*   pszText = NULL;
+    CHAR*   pszLine;
+    CHAR*   pszEnd;
+    CHAR*   pszNext;
+    long    cbText;
+    SIZE_T  cchLine;
+    BOOL    bValid = FALSE;
+
+    pRead->cEvents = 0;
+    pRead->cThreadNames = 0;
+    pRead->lTid = -1;
+    pRead->uFirst = 0;
+    pRead->uLast = 0;
+    pRead->bInOrder = TRUE;
+
+    if (FAILED(Trace::WriteJson(TEXT(TRACE_FILE)))) {
+        return FALSE;
+    }
+
+    pFile = fopen(TRACE_FILE, "rb");
+
+    if (pFile == NULL) {
+        goto cleanup;
+    }
+
+    fseek(pFile, 0, SEEK_END);
+    cbText = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+
+    if (cbText < (long) (sizeof(HEADER) + sizeof(FOOTER) - 3)) {
+        goto cleanup;
+    }
+
+    pszText = (CHAR*) malloc((SIZE_T) cbText + 1);
+
+    if (pszText == NULL ||
+        fread(pszText, 1, (SIZE_T) cbText, pFile) != (SIZE_T) cbText)
+    {
+        goto cleanup;
+    }
+
+    pszText[cbText] = '\0';
+    pszEnd = pszText + cbText - (sizeof(FOOTER) - 1);
+
+    if (memcmp(pszText, HEADER, sizeof(HEADER) - 1) != 0 ||
+        strcmp(pszEnd, FOOTER) != 0)
+    {
+        goto cleanup;
+    }
+
+    // One object a line, every one but the last followed by a comma
+    pszLine = pszText + sizeof(HEADER) - 1;
+
+    while (pszLine < pszEnd) {
+        pszNext = strchr(pszLine, '\n');
+
+        if (pszNext == NULL || pszNext > pszEnd) {
+            goto cleanup;
+        }
+
+        cchLine = (SIZE_T) (pszNext - pszLine);
+
+        if (pszNext < pszEnd) {
+            if (cchLine == 0 || pszLine[cchLine - 1] != ',') {
+                goto cleanup;
+            }
+
+            cchLine--;
+        }
+
+        pszLine[cchLine] = '\0';
+
+        if (ReadLine(pszLine, cchLine, pRead) == FALSE) {
+            goto cleanup;
+        }
+
+        pszLine = pszNext + 1;
+    }
+
+    bValid = TRUE;
+
+cleanup:
+    if (pFile != NULL) {
+        fclose(pFile);
+    }
+
+    free(pszText);
+    remove(TRACE_FILE);
+
+    return bValid;
+}
+
+// A buffer that has not wrapped holds all of its events; one that has
+// keeps the newest, oldest first, less the one slot CopyEvents() leaves
+// to a write that may be going on
+static VOID CheckWrap()
+{
+    TRACEREAD read;
+
+    if (TEST_CHECK(RunThread("trace.short", "short", 0, SHORT_EVENTS)) ==
+        FALSE ||
+        TEST_CHECK(RunThread("trace.wrap", "wrap", 0, WRAP_EVENTS)) ==
+        FALSE)
+    {
+        return;
+    }
+
+    read.pszEvent = "short";
+    read.pszThread = "trace.short";
+
+    if (TEST_CHECK(ReadTrace(&read)) == TRUE) {
+        TEST_CHECK(read.cEvents == SHORT_EVENTS);
+        TEST_CHECK(read.cThreadNames == 1);
+        TEST_CHECK(read.uFirst == 0);
+        TEST_CHECK(read.bInOrder);
+    }
+
+    read.pszEvent = "wrap";
+    read.pszThread = "trace.wrap";
+
+    if (TEST_CHECK(ReadTrace(&read)) == TRUE) {
+        TEST_CHECK(read.cEvents == TRACE_EVENTS - 1);
+        TEST_CHECK(read.uFirst == WRAP_EVENTS - TRACE_EVENTS + 1);
+        TEST_CHECK(read.uLast == WRAP_EVENTS - 1);
+        TEST_CHECK(read.bInOrder);
+    }
+}
+
+// A thread started over under the same name goes on in the buffer it
+// had, and buffers of ended threads go to new ones
+static VOID CheckReuse()
+{
+    TRACEREAD   read;
+    UINT        i;
+
+    for (i = 0; i < REUSE_THREADS; i++) {
+        if (TEST_CHECK(RunThread("trace.reuse", "reuse", i, 1)) == FALSE) {
+            return;
+        }
+    }
+
+    for (i = 0; i < ARRAYSIZE(ONCE_NAMES); i++) {
+        if (TEST_CHECK(RunThread(ONCE_NAMES[i], ONCE_NAMES[i], i, 1)) ==
+            FALSE)
+        {
+            return;
+        }
+    }
+
+    read.pszEvent = "reuse";
+    read.pszThread = "trace.reuse";
+
+    if (TEST_CHECK(ReadTrace(&read)) == TRUE) {
+        TEST_CHECK(read.cEvents == REUSE_THREADS);
+        TEST_CHECK(read.cThreadNames == 1);
+        TEST_CHECK(read.lTid > 0);
+        TEST_CHECK(read.bInOrder);
+    }
+
+    // The last thread got a buffer although more have run than there are
+    read.pszEvent = ONCE_NAMES[ARRAYSIZE(ONCE_NAMES) - 1];
+    read.pszThread = read.pszEvent;
+
+    if (TEST_CHECK(ReadTrace(&read)) == TRUE) {
+        TEST_CHECK(read.cEvents == 1);
+        TEST_CHECK(read.cThreadNames == 1);
+        TEST_CHECK(read.uFirst == ARRAYSIZE(ONCE_NAMES) - 1);
+    }
+}
+
+// Written while a thread keeps recording: whatever it wrote over during
+// the copy is dropped, so what is left is still one unbroken run
+static VOID CheckOverwrite()
+{
+    TRACETHREAD thread;
+    TRACEREAD   read;
+    Thread*     pThread = NULL;
+    UINT        i, cBroken = 0, cInvalid = 0;
+
+    memset(&thread, 0, sizeof(thread));
+    thread.pszThread = "trace.spin";
+    thread.pszEvent = "spin";
+
+    if (TEST_CHECK(SUCCEEDED(
+            Thread::CreateThread(RecordEvents, &thread, &pThread))) == FALSE)
+    {
+        return;
+    }
+
+    read.pszEvent = "spin";
+    read.pszThread = "trace.spin";
+
+    for (i = 0; i < SPIN_WRITES; i++) {
+        if (ReadTrace(&read) == FALSE) {
+            cInvalid++;
+        } else if (read.bInOrder == FALSE || read.cEvents > TRACE_EVENTS) {
+            cBroken++;
+        }
+
+        Thread::YieldThread();
+    }
+
+    AtomicStoreRelease(&thread.lStop, 1);
+    delete pThread;
+
+    TEST_CHECK(cInvalid == 0);
+    TEST_CHECK(cBroken == 0);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestTrace()
+{
+    CheckWrap();
+    CheckReuse();
+    CheckOverwrite();
+}
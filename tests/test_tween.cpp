@@ -0,0 +1,226 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "easing.h"
+#include "tweener.h"
+#include "tweensystem.h"
+
+#define CHECK_TWEENS    1000
+#define CHECK_UPDATES   400
+
+#define STEP_TIME       (1.0f / 240.0f)
+
+typedef struct _TIMELINELOG {
+    TWEEN       tweens[3];
+    UINT        order[4];
+    UINT        cEvents;
+    TIMELINE    timeline;
+} TIMELINELOG;
+
+static UINT NextRandom(UINT* puState)
+{
+    *puState = *puState * 1664525u + 1013904223u;
+    return *puState >> 8;
+}
+
+static TWEENDESC MakeDesc(UINT i, FLOAT fDuration)
+{
+    TWEENDESC desc;
+
+    memset(&desc, 0, sizeof(desc));
+
+    desc.fStart = (FLOAT) (i % 97) - 45.0f;
+    desc.fTarget = (FLOAT) (i % 13) * 7.5f;
+    desc.fDuration = fDuration;
+    desc.easing = (TWEENEASING) (i % TWEEN_EASING_COUNT);
+
+    return desc;
+}
+
+// What the system eases with: the batch kernels give Fast()'s bits
+static Tweener* CreateTweener(CONST TWEENDESC& desc)
+{
+    PFNEASING pfnEase = Easing::Linear;
+
+    if (desc.easing != TWEEN_EASING_LINEAR) {
+        pfnEase = GetEasingInfo((EASING) (desc.easing - 1))->pfnFast;
+    }
+
+    return new Tweener(desc.fDuration, desc.fStart, desc.fTarget, pfnEase);
+}
+
+// Every tween of the system has to hold exactly what a Tweener fed the
+// same deltas holds, up to and including the update it finishes on
+static VOID CheckLevel(CONST TWEENKERNELS* pKernels)
+{
+    static Tweener* tweeners[CHECK_TWEENS];
+    static TWEEN    tweens[CHECK_TWEENS];
+    static BOOL     bPlaying[CHECK_TWEENS];
+    TweenSystem*    pSystem = NULL;
+    TWEENDESC       desc;
+    FLOAT           fDelta;
+    UINT            uRandom = 7;
+    UINT            i, j, cErrors = 0;
+
+    if (TEST_CHECK(SUCCEEDED(TweenSystem::CreateTweenSystem(
+            CHECK_TWEENS, &pSystem))) == FALSE)
+    {
+        return;
+    }
+
+    pSystem->SetKernels(pKernels);
+
+    for (i = 0; i < CHECK_TWEENS; i++) {
+        desc = MakeDesc(i, 0.05f + (NextRandom(&uRandom) % 1000) * 0.001f);
+
+        // One easing runs past a whole batch and into a short tail
+        if (i < TWEEN_BATCH + 3) {
+            desc.easing = TWEEN_EASING_OUT_BOUNCE;
+        }
+
+        tweeners[i] = CreateTweener(desc);
+        tweens[i] = pSystem->Start(desc);
+        bPlaying[i] = TRUE;
+    }
+
+    for (j = 0; j < CHECK_UPDATES; j++) {
+        fDelta = STEP_TIME * (0.5f + (NextRandom(&uRandom) % 100) * 0.01f);
+
+        pSystem->Update(fDelta);
+
+        for (i = 0; i < CHECK_TWEENS; i++) {
+            if (bPlaying[i] == FALSE) {
+                continue;
+            }
+
+            bPlaying[i] = tweeners[i]->Update(fDelta);
+
+            if (pSystem->GetValue(tweens[i]) != tweeners[i]->GetValue() ||
+                pSystem->IsPlaying(tweens[i]) != bPlaying[i])
+            {
+                cErrors++;
+            }
+        }
+    }
+
+    TEST_CHECK(cErrors == 0);
+
+    // One more to drop the tweens that finished last
+    pSystem->Update(STEP_TIME);
+
+    TEST_CHECK(pSystem->GetCount() == 0);
+
+    for (i = 0; i < CHECK_TWEENS; i++) {
+        delete tweeners[i];
+    }
+
+    delete pSystem;
+}
+
+static VOID OnTweenDone(LPVOID pContext, UINT uHandle)
+{
+    TIMELINELOG*    pLog = (TIMELINELOG*) pContext;
+    UINT            i;
+
+    for (i = 0; i < ARRAYSIZE(pLog->tweens); i++) {
+        if (pLog->tweens[i] == uHandle && pLog->cEvents < 4) {
+            pLog->order[pLog->cEvents++] = i;
+        }
+    }
+}
+
+static VOID OnTimelineDone(LPVOID pContext, UINT uHandle)
+{
+    TIMELINELOG* pLog = (TIMELINELOG*) pContext;
+
+    if (uHandle == pLog->timeline && pLog->cEvents < 4) {
+        pLog->order[pLog->cEvents++] = 3;
+    }
+}
+
+// A, then B with C alongside it; C is shorter, so it has to finish
+// between A and B and the timeline after B
+static VOID CheckTimeline()
+{
+    TweenSystem*    pSystem = NULL;
+    TIMELINELOG     log;
+    TWEENDESC       desc;
+    UINT            i;
+
+    if (TEST_CHECK(SUCCEEDED(
+            TweenSystem::CreateTweenSystem(16, &pSystem))) == FALSE)
+    {
+        return;
+    }
+
+    memset(&log, 0, sizeof(log));
+
+    log.timeline = pSystem->CreateTimeline(OnTimelineDone, &log);
+
+    desc = MakeDesc(0, 0.1f);
+    desc.pfnDone = OnTweenDone;
+    desc.pContext = &log;
+
+    log.tweens[0] = pSystem->Append(log.timeline, desc);
+
+    desc.fDuration = 0.2f;
+    log.tweens[1] = pSystem->Append(log.timeline, desc);
+
+    desc.fDuration = 0.05f;
+    log.tweens[2] = pSystem->Join(log.timeline, desc);
+
+    for (i = 0; i < 120; i++) {
+        pSystem->Update(STEP_TIME);
+
+        // C waits for A
+        if (i == 20) {
+            TEST_CHECK(pSystem->GetValue(log.tweens[2]) == desc.fStart);
+        }
+    }
+
+    TEST_CHECK(log.cEvents == 4);
+    TEST_CHECK(log.order[0] == 0 && log.order[1] == 2 &&
+               log.order[2] == 1 && log.order[3] == 3);
+    TEST_CHECK(pSystem->GetCount() == 0);
+
+    delete pSystem;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestTween()
+{
+    static CONST TWEENLEVEL levels[] = {
+        TWEEN_LEVEL_SCALAR,
+        TWEEN_LEVEL_SSE2
+    };
+
+    CONST TWEENKERNELS* pKernels;
+    UINT                i;
+
+    for (i = 0; i < ARRAYSIZE(levels); i++) {
+        pKernels = GetTweenKernelsForLevel(levels[i]);
+
+        if (pKernels != NULL) {
+            CheckLevel(pKernels);
+        }
+    }
+
+    CheckTimeline();
+}
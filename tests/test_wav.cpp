@@ -0,0 +1,146 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "test.h"
+#include "wavfile.h"
+
+#define WAV_FRAMES      64
+#define WAV_CHANNELS    2
+#define WAV_RATE        48000
+
+static VOID PutLE32(BYTE* pb, UINT uValue)
+{
+    pb[0] = (BYTE) uValue;
+    pb[1] = (BYTE) (uValue >> 8);
+    pb[2] = (BYTE) (uValue >> 16);
+    pb[3] = (BYTE) (uValue >> 24);
+}
+
+// Writes a chunk header and returns the offset just past it
+static SIZE_T PutChunk(BYTE* pb, SIZE_T cbOffset, LPCSTR pszId, UINT cb)
+{
+    memcpy(pb + cbOffset, pszId, 4);
+    PutLE32(pb + cbOffset + 4, cb);
+
+    return cbOffset + 8;
+}
+
+static VOID CheckPcm()
+{
+    BYTE    file[TEST_WAV_SIZE(WAV_FRAMES, WAV_CHANNELS)];
+    WAVINFO info;
+
+    TestMakeWav(file, WAV_FRAMES, WAV_CHANNELS, WAV_RATE);
+
+    if (TEST_CHECK(SUCCEEDED(ParseWav(file, sizeof(file), &info))) == FALSE) {
+        return;
+    }
+
+    TEST_CHECK(info.uFormatTag == WAV_FORMAT_PCM);
+    TEST_CHECK(info.cChannels == WAV_CHANNELS);
+    TEST_CHECK(info.uSampleRate == WAV_RATE);
+    TEST_CHECK(info.cbBlockAlign == WAV_CHANNELS * 2);
+    TEST_CHECK(info.cBitsPerSample == 16);
+    TEST_CHECK(info.cFrames == WAV_FRAMES);
+    TEST_CHECK(info.pbData == file + TEST_WAV_HEADER);
+
+    // Cut short: whatever frames are there
+    TEST_CHECK(SUCCEEDED(ParseWav(file, sizeof(file) - 10, &info)));
+    TEST_CHECK(info.cFrames == (sizeof(file) - 10 - TEST_WAV_HEADER) / 4);
+}
+
+static VOID CheckRejected()
+{
+    BYTE    file[TEST_WAV_SIZE(WAV_FRAMES, WAV_CHANNELS)];
+    WAVINFO info;
+
+    TestMakeWav(file, WAV_FRAMES, WAV_CHANNELS, WAV_RATE);
+
+    TEST_CHECK(ParseWav(NULL, sizeof(file), &info) == E_INVALIDARG);
+    TEST_CHECK(ParseWav(file, 11, &info) == E_INVALIDARG);
+
+    // No data chunk at all
+    TEST_CHECK(ParseWav(file, 36, &info) == E_INVALIDARG);
+
+    // Data before the format
+    memcpy(file + 12, "data", 4);
+    TEST_CHECK(ParseWav(file, sizeof(file), &info) == E_INVALIDARG);
+
+    memcpy(file + 12, "fmt ", 4);
+    file[32] = 0;
+    file[33] = 0;
+    TEST_CHECK(ParseWav(file, sizeof(file), &info) == E_INVALIDARG);
+}
+
+static VOID CheckPadding()
+{
+    BYTE    file[TEST_WAV_SIZE(WAV_FRAMES, WAV_CHANNELS) + 16];
+    BYTE    header[36];
+    SIZE_T  cbOffset;
+    WAVINFO info;
+
+    TestMakeWav(header, 0, WAV_CHANNELS, WAV_RATE);
+    memcpy(file, header, sizeof(header));
+
+    // An odd-sized chunk ahead of the data, with its pad byte
+    cbOffset = PutChunk(file, sizeof(header), "LIST", 3);
+    memset(file + cbOffset, 0, 4);
+    cbOffset = PutChunk(file, cbOffset + 4, "data", 8);
+    memset(file + cbOffset, 0, 8);
+
+    TEST_CHECK(SUCCEEDED(ParseWav(file, cbOffset + 8, &info)));
+    TEST_CHECK(info.pbData == file + cbOffset);
+    TEST_CHECK(info.cFrames == 2);
+}
+
+static VOID CheckOddFinalChunk()
+{
+    BYTE    file[64];
+    BYTE    header[36];
+    SIZE_T  cbOffset;
+    SIZE_T  cbFile;
+    WAVINFO info;
+
+    TestMakeWav(header, 0, WAV_CHANNELS, WAV_RATE);
+    memset(file, 0, sizeof(file));
+    memcpy(file, header, sizeof(header));
+
+    // The file ends on an odd-sized chunk without its pad byte. Stepping
+    // over the missing pad would land one byte past the end and take the
+    // stray chunk header parked there as data.
+    cbOffset = PutChunk(file, sizeof(header), "LIST", 3);
+    cbFile = cbOffset + 3;
+    PutChunk(file, cbFile + 1, "data", 8);
+
+    TEST_CHECK(ParseWav(file, cbFile, &info) == E_INVALIDARG);
+    TEST_CHECK(info.pbData == NULL);
+
+    // Same with a chunk that claims more than is left
+    PutLE32(file + sizeof(header) + 4, 0xFFFFFFFF);
+    TEST_CHECK(ParseWav(file, cbFile, &info) == E_INVALIDARG);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+VOID TestWav()
+{
+    CheckPcm();
+    CheckRejected();
+    CheckPadding();
+    CheckOddFinalChunk();
+}
@@ -0,0 +1,637 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testflac.h"
+
+#include <math.h>
+#include <string.h>
+
+#define LPC_ORDER           8
+#define LPC_PRECISION       12
+
+#define SIGNAL_SILENCE      6000    // Frames, for constant subframes
+
+typedef struct _BITWRITER {
+    BYTE*       pb;
+    SIZE_T      cb;
+    SIZE_T      cbUsed;
+    ULONGLONG   ullCache;       // Right aligned, cBits < 8 between calls
+    UINT        cBits;
+} BITWRITER;
+
+static UINT NextRandom(UINT* puState)
+{
+    *puState = *puState * 1664525 + 1013904223;
+    return *puState >> 8;
+}
+
+// cBits <= 32
+static VOID WriteBits(BITWRITER* pWriter, UINT uValue, UINT cBits)
+{
+    if (cBits == 0) {
+        return;
+    }
+
+    if (cBits < 32) {
+        uValue &= (1U << cBits) - 1;
+    }
+
+    pWriter->ullCache = (pWriter->ullCache << cBits) | uValue;
+    pWriter->cBits += cBits;
+
+    while (pWriter->cBits >= 8) {
+        pWriter->cBits -= 8;
+
+        if (pWriter->cbUsed < pWriter->cb) {
+            pWriter->pb[pWriter->cbUsed] =
+                (BYTE) (pWriter->ullCache >> pWriter->cBits);
+        }
+
+        pWriter->cbUsed++;
+    }
+}
+
+static VOID WriteUnary(BITWRITER* pWriter, UINT uValue)
+{
+    for (; uValue >= 32; uValue -= 32) {
+        WriteBits(pWriter, 0, 32);
+    }
+
+    WriteBits(pWriter, 1, uValue + 1);
+}
+
+static VOID AlignWriter(BITWRITER* pWriter)
+{
+    if (pWriter->cBits != 0) {
+        WriteBits(pWriter, 0, 8 - pWriter->cBits);
+    }
+}
+
+static BYTE Crc8(CONST BYTE* pb, SIZE_T cb)
+{
+    UINT    uCrc = 0;
+    SIZE_T  i;
+    UINT    j;
+
+    for (i = 0; i < cb; i++) {
+        uCrc ^= pb[i];
+
+        for (j = 0; j < 8; j++) {
+            uCrc = (uCrc & 0x80) ? ((uCrc << 1) ^ 0x07) : (uCrc << 1);
+        }
+    }
+
+    return (BYTE) uCrc;
+}
+
+static WORD Crc16(CONST BYTE* pb, SIZE_T cb)
+{
+    UINT    uCrc = 0;
+    SIZE_T  i;
+    UINT    j;
+
+    for (i = 0; i < cb; i++) {
+        uCrc ^= (UINT) pb[i] << 8;
+
+        for (j = 0; j < 8; j++) {
+            uCrc = (uCrc & 0x8000) ? ((uCrc << 1) ^ 0x8005) : (uCrc << 1);
+        }
+    }
+
+    return (WORD) uCrc;
+}
+
+// Bits a two's complement field needs to hold iValue
+static UINT SignedBits(INT iValue)
+{
+    UINT cBits = 1;
+
+    while (iValue < -(1 << (cBits - 1)) || iValue >= (1 << (cBits - 1))) {
+        cBits++;
+    }
+
+    return cBits;
+}
+
+// Rice partitions, the first one escaped to raw bits when bEscape
+static VOID WriteResidual(
+    BITWRITER*  pWriter,
+    CONST INT*  piResidual,
+    UINT        cFrames,
+    UINT        uOrder,
+    BOOL        bEscape)
+{
+    UINT        uPartitionOrder = 3;
+    UINT        cPartitionFrames, uPartition, uStart, uEnd;
+    UINT        uParam, uValue, cRawBits, i;
+    ULONGLONG   ullSum;
+
+    while (uPartitionOrder > 0 &&
+           ((cFrames & ((1U << uPartitionOrder) - 1)) != 0 ||
+            (cFrames >> uPartitionOrder) < uOrder))
+    {
+        uPartitionOrder--;
+    }
+
+    cPartitionFrames = cFrames >> uPartitionOrder;
+
+    WriteBits(pWriter, 0, 2);
+    WriteBits(pWriter, uPartitionOrder, 4);
+
+    for (uPartition = 0; uPartition < (1U << uPartitionOrder); uPartition++) {
+        uStart = (uPartition == 0) ? uOrder : uPartition * cPartitionFrames;
+        uEnd = (uPartition + 1) * cPartitionFrames;
+
+        if (bEscape == TRUE && uPartition == 0) {
+            cRawBits = 0;
+
+            for (i = uStart; i < uEnd; i++) {
+                if (SignedBits(piResidual[i]) > cRawBits) {
+                    cRawBits = SignedBits(piResidual[i]);
+                }
+            }
+
+            // All zeros takes no bits at all
+            if (uStart == uEnd || cRawBits == 1) {
+                cRawBits = 0;
+
+                for (i = uStart; i < uEnd; i++) {
+                    if (piResidual[i] != 0) {
+                        cRawBits = 1;
+                    }
+                }
+            }
+
+            WriteBits(pWriter, 15, 4);
+            WriteBits(pWriter, cRawBits, 5);
+
+            for (i = uStart; i < uEnd; i++) {
+                WriteBits(pWriter, (UINT) piResidual[i], cRawBits);
+            }
+
+            continue;
+        }
+
+        ullSum = 0;
+
+        for (i = uStart; i < uEnd; i++) {
+            ullSum += ((UINT) piResidual[i] << 1) ^
+                      (UINT) (piResidual[i] >> 31);
+        }
+
+        uParam = 0;
+
+        while (uParam < 14 &&
+               ((ULONGLONG) (uEnd - uStart) << (uParam + 1)) < ullSum)
+        {
+            uParam++;
+        }
+
+        WriteBits(pWriter, uParam, 4);
+
+        for (i = uStart; i < uEnd; i++) {
+            uValue = ((UINT) piResidual[i] << 1) ^
+                     (UINT) (piResidual[i] >> 31);
+
+            WriteUnary(pWriter, uValue >> uParam);
+            WriteBits(pWriter, uValue, uParam);
+        }
+    }
+}
+
+// Levinson-Durbin on the autocorrelation, quantized the way the
+// format stores it. FALSE for a signal it cannot predict.
+static BOOL ComputeLpc(
+    CONST INT*  piSamples,
+    UINT        cFrames,
+    INT*        piCoefficients,
+    UINT*       puShift)
+{
+    DOUBLE  r[LPC_ORDER + 1];
+    DOUBLE  a[LPC_ORDER + 1], previous[LPC_ORDER + 1];
+    DOUBLE  fError, fReflection, fMax = 0.0;
+    INT     iExponent, iShift, iLimit = (1 << (LPC_PRECISION - 1)) - 1;
+    UINT    i, j;
+
+    for (i = 0; i <= LPC_ORDER; i++) {
+        r[i] = 0.0;
+
+        for (j = i; j < cFrames; j++) {
+            r[i] += (DOUBLE) piSamples[j] * piSamples[j - i];
+        }
+    }
+
+    if (r[0] == 0.0) {
+        return FALSE;
+    }
+
+    memset(a, 0, sizeof(a));
+    fError = r[0];
+
+    for (i = 1; i <= LPC_ORDER; i++) {
+        fReflection = r[i];
+
+        for (j = 1; j < i; j++) {
+            fReflection -= a[j] * r[i - j];
+        }
+
+        fReflection /= fError;
+
+        memcpy(previous, a, sizeof(a));
+        a[i] = fReflection;
+
+        for (j = 1; j < i; j++) {
+            a[j] = previous[j] - fReflection * previous[i - j];
+        }
+
+        fError *= 1.0 - fReflection * fReflection;
+
+        if (fError <= 0.0) {
+            return FALSE;
+        }
+    }
+
+    for (i = 1; i <= LPC_ORDER; i++) {
+        fMax = (fabs(a[i]) > fMax) ? fabs(a[i]) : fMax;
+    }
+
+    frexp(fMax, &iExponent);
+    iShift = (LPC_PRECISION - 1) - iExponent;
+    iShift = (iShift < 0) ? 0 : (iShift > 15) ? 15 : iShift;
+
+    for (i = 0; i < LPC_ORDER; i++) {
+        piCoefficients[i] = (INT) floor(a[i + 1] * (1 << iShift) + 0.5);
+
+        if (piCoefficients[i] > iLimit) {
+            piCoefficients[i] = iLimit;
+        } else if (piCoefficients[i] < -iLimit) {
+            piCoefficients[i] = -iLimit;
+        }
+    }
+
+    *puShift = (UINT) iShift;
+    return TRUE;
+}
+
+// uChoice picks the subframe type: fixed of some order, LPC, verbatim
+static VOID WriteSubframe(
+    BITWRITER*  pWriter,
+    CONST INT*  piSamples,
+    UINT        cFrames,
+    UINT        cBits,
+    UINT        uChoice)
+{
+    static INT  residual[TEST_FLAC_BLOCK];
+    INT         coefficients[LPC_ORDER];
+    LONGLONG    llSum;
+    UINT        uOrder, uShift, i, j;
+    BOOL        bConstant = TRUE;
+
+    for (i = 1; i < cFrames; i++) {
+        if (piSamples[i] != piSamples[0]) {
+            bConstant = FALSE;
+        }
+    }
+
+    WriteBits(pWriter, 0, 1);
+
+    if (bConstant == TRUE) {
+        WriteBits(pWriter, 0, 6);
+        WriteBits(pWriter, 0, 1);
+        WriteBits(pWriter, (UINT) piSamples[0], cBits);
+        return;
+    }
+
+    if (uChoice % 4 == 1 && cFrames > LPC_ORDER &&
+        ComputeLpc(piSamples, cFrames, coefficients, &uShift) == TRUE)
+    {
+        WriteBits(pWriter, 32 + LPC_ORDER - 1, 6);
+        WriteBits(pWriter, 0, 1);
+
+        for (i = 0; i < LPC_ORDER; i++) {
+            WriteBits(pWriter, (UINT) piSamples[i], cBits);
+        }
+
+        WriteBits(pWriter, LPC_PRECISION - 1, 4);
+        WriteBits(pWriter, uShift, 5);
+
+        for (i = 0; i < LPC_ORDER; i++) {
+            WriteBits(pWriter, (UINT) coefficients[i], LPC_PRECISION);
+        }
+
+        for (i = LPC_ORDER; i < cFrames; i++) {
+            llSum = 0;
+
+            for (j = 0; j < LPC_ORDER; j++) {
+                llSum += (LONGLONG) coefficients[j] * piSamples[i - 1 - j];
+            }
+
+            residual[i] = piSamples[i] - (INT) (llSum >> uShift);
+        }
+
+        WriteResidual(pWriter, residual, cFrames, LPC_ORDER, uChoice % 7 == 3);
+        return;
+    }
+
+    if (uChoice % 4 == 2) {
+        WriteBits(pWriter, 1, 6);
+        WriteBits(pWriter, 0, 1);
+
+        for (i = 0; i < cFrames; i++) {
+            WriteBits(pWriter, (UINT) piSamples[i], cBits);
+        }
+
+        return;
+    }
+
+    uOrder = (uChoice % 4 == 3) ? 2 : uChoice % 5;
+
+    if (uOrder > cFrames) {
+        uOrder = 0;
+    }
+
+    for (i = uOrder; i < cFrames; i++) {
+        switch (uOrder) {
+            case 0:
+                residual[i] = piSamples[i];
+                break;
+            case 1:
+                residual[i] = piSamples[i] - piSamples[i - 1];
+                break;
+            case 2:
+                residual[i] = piSamples[i] - 2 * piSamples[i - 1] +
+                              piSamples[i - 2];
+                break;
+            case 3:
+                residual[i] = piSamples[i] - 3 * piSamples[i - 1] +
+                              3 * piSamples[i - 2] - piSamples[i - 3];
+                break;
+            default:
+                residual[i] = piSamples[i] - 4 * piSamples[i - 1] +
+                              6 * piSamples[i - 2] - 4 * piSamples[i - 3] +
+                              piSamples[i - 4];
+                break;
+        }
+    }
+
+    WriteBits(pWriter, 8 + uOrder, 6);
+    WriteBits(pWriter, 0, 1);
+
+    for (i = 0; i < uOrder; i++) {
+        WriteBits(pWriter, (UINT) piSamples[i], cBits);
+    }
+
+    WriteResidual(pWriter, residual, cFrames, uOrder, uChoice % 7 == 3);
+}
+
+static VOID WriteFrameNumber(BITWRITER* pWriter, UINT uNumber)
+{
+    UINT cBytes, i;
+
+    if (uNumber < 0x80) {
+        WriteBits(pWriter, uNumber, 8);
+        return;
+    }
+
+    for (cBytes = 2; uNumber >= (1U << (5 * cBytes + 1)); cBytes++) {
+    }
+
+    WriteBits(pWriter, (1U << cBytes) - 1, cBytes);
+    WriteBits(pWriter, 0, 1);
+    WriteBits(pWriter, uNumber >> (6 * (cBytes - 1)), 7 - cBytes);
+
+    for (i = cBytes - 1; i > 0; i--) {
+        WriteBits(pWriter, 2, 2);
+        WriteBits(pWriter, uNumber >> (6 * (i - 1)), 6);
+    }
+}
+
+// Frame header, one subframe per plane, CRC; uNumber also picks the
+// subframe types
+static VOID WritePlanes(
+    BITWRITER*  pWriter,
+    INT         planes[2][TEST_FLAC_BLOCK],
+    CONST UINT* pcBits,
+    UINT        cChannels,
+    UINT        uAssignment,
+    UINT        cFrames,
+    UINT        uNumber)
+{
+    SIZE_T  cbStart = pWriter->cbUsed;
+    UINT    i;
+
+    WriteBits(pWriter, 0xFFF8, 16);
+    WriteBits(pWriter, (cFrames == TEST_FLAC_BLOCK) ? 12 : 7, 4);
+    WriteBits(pWriter, 0, 4);
+    WriteBits(pWriter, uAssignment, 4);
+    WriteBits(pWriter, 4, 3);
+    WriteBits(pWriter, 0, 1);
+    WriteFrameNumber(pWriter, uNumber);
+
+    if (cFrames != TEST_FLAC_BLOCK) {
+        WriteBits(pWriter, cFrames - 1, 16);
+    }
+
+    WriteBits(pWriter,
+              Crc8(pWriter->pb + cbStart, pWriter->cbUsed - cbStart), 8);
+
+    for (i = 0; i < cChannels; i++) {
+        WriteSubframe(pWriter, planes[i], cFrames, pcBits[i], uNumber + i);
+    }
+
+    AlignWriter(pWriter);
+
+    WriteBits(pWriter,
+              Crc16(pWriter->pb + cbStart, pWriter->cbUsed - cbStart), 16);
+}
+
+// Stereo frames go through independent, left/side, side/right and
+// mid/side in turn
+static VOID WriteFrame(
+    BITWRITER*      pWriter,
+    CONST SHORT*    psSamples,
+    UINT            cChannels,
+    UINT            cFrames,
+    UINT            uNumber)
+{
+    static CONST UINT ASSIGNMENTS[4] = { 1, 8, 9, 10 };
+
+    static INT  planes[2][TEST_FLAC_BLOCK];
+    UINT        uAssignment, cBits[2] = { 16, 16 };
+    INT         iLeft, iRight;
+    UINT        i;
+
+    uAssignment = (cChannels == 1) ? 0 : ASSIGNMENTS[uNumber % 4];
+
+    for (i = 0; i < cFrames; i++) {
+        iLeft = psSamples[i * cChannels];
+        iRight = (cChannels == 2) ? psSamples[i * cChannels + 1] : 0;
+
+        switch (uAssignment) {
+            case 8:
+                planes[0][i] = iLeft;
+                planes[1][i] = iLeft - iRight;
+                break;
+            case 9:
+                planes[0][i] = iLeft - iRight;
+                planes[1][i] = iRight;
+                break;
+            case 10:
+                planes[0][i] = (iLeft + iRight) >> 1;
+                planes[1][i] = iLeft - iRight;
+                break;
+            default:
+                planes[0][i] = iLeft;
+                planes[1][i] = iRight;
+                break;
+        }
+    }
+
+    if (uAssignment == 8 || uAssignment == 10) {
+        cBits[1] = 17;
+    } else if (uAssignment == 9) {
+        cBits[0] = 17;
+    }
+
+    WritePlanes(pWriter, planes, cBits, cChannels, uAssignment, cFrames,
+                uNumber);
+}
+
+static VOID WriteStreamHeader(
+    BITWRITER*  pWriter,
+    UINT        cChannels,
+    UINT        cFrames,
+    UINT        uSampleRate)
+{
+    UINT i;
+
+    for (i = 0; i < 4; i++) {
+        WriteBits(pWriter, "fLaC"[i], 8);
+    }
+
+    // STREAMINFO, then a PADDING block the decoder has to skip
+    WriteBits(pWriter, 0, 8);
+    WriteBits(pWriter, 34, 24);
+    WriteBits(pWriter, TEST_FLAC_BLOCK, 16);
+    WriteBits(pWriter, TEST_FLAC_BLOCK, 16);
+    WriteBits(pWriter, 0, 24);
+    WriteBits(pWriter, 0, 24);
+    WriteBits(pWriter, uSampleRate, 20);
+    WriteBits(pWriter, cChannels - 1, 3);
+    WriteBits(pWriter, 15, 5);
+    WriteBits(pWriter, 0, 4);
+    WriteBits(pWriter, cFrames, 32);
+
+    for (i = 0; i < 16; i++) {
+        WriteBits(pWriter, 0, 8);
+    }
+
+    WriteBits(pWriter, 0x81, 8);
+    WriteBits(pWriter, 16, 24);
+
+    for (i = 0; i < 16; i++) {
+        WriteBits(pWriter, 0, 8);
+    }
+}
+
+SIZE_T TestEncodeFlac(
+    CONST SHORT*    psSamples,
+    UINT            cChannels,
+    UINT            cFrames,
+    UINT            uSampleRate,
+    BYTE*           pbFile,
+    SIZE_T          cbFile)
+{
+    BITWRITER   writer;
+    UINT        uFrame, uNumber, cBlock;
+
+    memset(&writer, 0, sizeof(writer));
+    writer.pb = pbFile;
+    writer.cb = cbFile;
+
+    WriteStreamHeader(&writer, cChannels, cFrames, uSampleRate);
+
+    for (uFrame = 0, uNumber = 0; uFrame < cFrames; uNumber++) {
+        cBlock = cFrames - uFrame;
+        cBlock = (cBlock > TEST_FLAC_BLOCK) ? TEST_FLAC_BLOCK : cBlock;
+
+        WriteFrame(&writer, psSamples + (SIZE_T) uFrame * cChannels,
+                   cChannels, cBlock, uNumber);
+
+        uFrame += cBlock;
+    }
+
+    return (writer.cbUsed <= writer.cb) ? writer.cbUsed : 0;
+}
+
+SIZE_T TestEncodeFlacPlane(
+    CONST INT*  piSamples,
+    UINT        cFrames,
+    UINT        uChoice,
+    UINT        uSampleRate,
+    BYTE*       pbFile,
+    SIZE_T      cbFile)
+{
+    static INT  planes[2][TEST_FLAC_BLOCK];
+    BITWRITER   writer;
+    UINT        cBits[2] = { 16, 16 };
+
+    if (cFrames > TEST_FLAC_BLOCK) {
+        return 0;
+    }
+
+    memset(&writer, 0, sizeof(writer));
+    writer.pb = pbFile;
+    writer.cb = cbFile;
+
+    memcpy(planes[0], piSamples, cFrames * sizeof(INT));
+
+    WriteStreamHeader(&writer, 1, cFrames, uSampleRate);
+    WritePlanes(&writer, planes, cBits, 1, 0, cFrames, uChoice);
+
+    return (writer.cbUsed <= writer.cb) ? writer.cbUsed : 0;
+}
+
+VOID TestFillSignal(SHORT* psSamples, UINT cChannels, UINT cFrames)
+{
+    UINT    uState = 7;
+    FLOAT   fValue;
+    UINT    i;
+
+    for (i = 0; i < cFrames; i++) {
+        fValue = 12000.0f * sinf((FLOAT) i * 0.031f) +
+                 5000.0f * sinf((FLOAT) i * 0.0037f * (1.0f + i / 20000.0f)) +
+                 (FLOAT) (INT) (NextRandom(&uState) % 2001) - 1000.0f;
+
+        if (i >= cFrames / 2 && i < cFrames / 2 + SIGNAL_SILENCE) {
+            fValue = 0.0f;
+        }
+
+        psSamples[i * cChannels] = (SHORT) fValue;
+
+        if (cChannels == 2) {
+            psSamples[i * 2 + 1] = (SHORT) (fValue * -0.7f +
+                                            12000.0f * sinf(i * 0.011f));
+        }
+    }
+
+    // Full scale on both ends, so side channels need their 17th bit
+    psSamples[100 * cChannels] = 32767;
+
+    if (cChannels == 2) {
+        psSamples[100 * 2 + 1] = -32768;
+    }
+}
@@ -0,0 +1,56 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __TESTFLAC_H
+#define __TESTFLAC_H
+
+#include "wintypes.h"
+
+////////////////////////////////////////////////////////////////////////////
+// A small FLAC encoder
+//
+// Just enough to give the decoder every subframe type, stereo mode and
+// residual coding it knows, frame after frame, for fp_test and fp_bench.
+// Nothing here tries to compress well.
+////////////////////////////////////////////////////////////////////////////
+
+#define TEST_FLAC_BLOCK     4096    // Frames per FLAC frame
+
+// Returns the file size, 0 when it does not fit in cbFile
+SIZE_T TestEncodeFlac(
+    CONST SHORT*    psSamples,
+    UINT            cChannels,
+    UINT            cFrames,
+    UINT            uSampleRate,
+    BYTE*           pbFile,
+    SIZE_T          cbFile);
+
+// One mono 16-bit frame straight from piSamples, which may run past
+// 16 bits, with the subframe type uChoice picks: 1 for LPC, 3 for fixed
+// order 2 with escaped residuals, 4 for fixed order 4
+SIZE_T TestEncodeFlacPlane(
+    CONST INT*  piSamples,
+    UINT        cFrames,
+    UINT        uChoice,
+    UINT        uSampleRate,
+    BYTE*       pbFile,
+    SIZE_T      cbFile);
+
+// Tones, a little noise, the right channel lagging the left, a stretch
+// of digital silence and full scale samples on both ends
+VOID TestFillSignal(SHORT* psSamples, UINT cChannels, UINT cFrames);
+
+#endif // __TESTFLAC_H
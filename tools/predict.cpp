@@ -0,0 +1,442 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "clock.h"
+#include "pointerpredictor.h"
+
+////////////////////////////////////////////////////////////////////////////
+// fp_predict - scores PointerPredictor against pointer traces
+//
+// Every trace is played into the predictor sample by sample while frames
+// are drawn at a fixed rate and presented one period later, the way
+// Engine does it. Each frame compares what would be on screen when it is
+// presented, with and without prediction, against where the pointer
+// really is at that moment.
+//
+// Usage: fp_predict [-r rate] [trace...]
+//
+// A trace is a text file with one "seconds x y" sample per line. Without
+// any, a set of synthetic gestures is scored at 125 and 1000 Hz.
+////////////////////////////////////////////////////////////////////////////
+
+#define CLOCK_FREQUENCY     1000000
+
+#define MAX_SAMPLES         (1024 * 1024)
+#define MAX_FRAMES          (64 * 1024)
+
+// Synthetic samples land up to this far from the device clock, and
+// positions are whole pixels, like counts from a real mouse
+#define SAMPLE_JITTER       0.0005      // Seconds
+
+typedef struct _TRACESAMPLE {
+    DOUBLE  fTime;
+    FLOAT   x;
+    FLOAT   y;
+} TRACESAMPLE;
+
+typedef VOID (*GESTUREPROC)(DOUBLE t, FLOAT* px, FLOAT* py);
+
+typedef struct _GESTURE {
+    LPCSTR      pszName;
+    GESTUREPROC pfnPosition;
+    DOUBLE      fDuration;
+} GESTURE;
+
+typedef struct _SCORE {
+    DOUBLE  fMean;
+    FLOAT   fPercentile;    // 95th
+    FLOAT   fMax;
+} SCORE;
+
+typedef struct _RESULT {
+    SCORE   held;
+    SCORE   predicted;
+    FLOAT   fOvershoot;     // Furthest past the truth, along the motion
+    UINT    cWorse;         // Frames prediction made worse
+    UINT    cFrames;
+} RESULT;
+
+static TRACESAMPLE  g_samples[MAX_SAMPLES];
+static FLOAT        g_heldErrors[MAX_FRAMES];
+static FLOAT        g_predictedErrors[MAX_FRAMES];
+
+////////////////////////////////////////////////////////////////////////////
+// Gestures, pixels over seconds
+
+// Steady 1500 px/s, then an abrupt stop
+static VOID Line(DOUBLE t, FLOAT* px, FLOAT* py)
+{
+    DOUBLE fMoving = (t < 0.5) ? t : 0.5;
+
+    *px = (FLOAT) (100.0 + 1500.0 * fMoving);
+    *py = (FLOAT) (300.0 + 300.0 * fMoving);
+}
+
+// A fast start that eases into a stop
+static VOID Flick(DOUBLE t, FLOAT* px, FLOAT* py)
+{
+    DOUBLE u = (t < 0.3) ? t / 0.3 : 1.0;
+
+    u = 1.0 - (1.0 - u) * (1.0 - u) * (1.0 - u);
+
+    *px = (FLOAT) (100.0 + 900.0 * u);
+    *py = (FLOAT) (500.0 - 200.0 * u);
+}
+
+static VOID Circle(DOUBLE t, FLOAT* px, FLOAT* py)
+{
+    DOUBLE fAngle = 2.0 * 3.14159265358979 * 1.5 * t;
+
+    *px = (FLOAT) (500.0 + 200.0 * cos(fAngle));
+    *py = (FLOAT) (500.0 + 200.0 * sin(fAngle));
+}
+
+// Sharp reversals, 3 per second each way
+static VOID Zigzag(DOUBLE t, FLOAT* px, FLOAT* py)
+{
+    DOUBLE fPhase = t * 3.0 - floor(t * 3.0);
+
+    *px = (FLOAT) (200.0 + 400.0 * ((fPhase < 0.5) ?
+                                    fPhase * 2.0 : 2.0 - fPhase * 2.0));
+    *py = (FLOAT) (300.0 + 100.0 * t);
+}
+
+// A slow, wobbly drag
+static VOID Drag(DOUBLE t, FLOAT* px, FLOAT* py)
+{
+    *px = (FLOAT) (300.0 + 200.0 * t);
+    *py = (FLOAT) (300.0 + 20.0 * sin(2.0 * 3.14159265358979 * 2.0 * t));
+}
+
+// A hand resting on the mouse
+static VOID Rest(DOUBLE t, FLOAT* px, FLOAT* py)
+{
+    *px = (FLOAT) (400.0 + 0.6 * sin(t * 37.0));
+    *py = (FLOAT) (400.0 + 0.6 * cos(t * 23.0));
+}
+
+static CONST GESTURE GESTURES[] = {
+    { "line",       Line,   0.8 },
+    { "flick",      Flick,  0.6 },
+    { "circle",     Circle, 1.0 },
+    { "zigzag",     Zigzag, 1.0 },
+    { "drag",       Drag,   1.0 },
+    { "rest",       Rest,   1.0 }
+};
+
+static CONST DOUBLE DEVICE_RATES[] = { 125.0, 1000.0 };
+
+////////////////////////////////////////////////////////////////////////////
+
+static UINT g_uRandom = 1;
+
+static DOUBLE Random()
+{
+    g_uRandom = g_uRandom * 1664525u + 1013904223u;
+
+    return (DOUBLE) (g_uRandom >> 8) / (DOUBLE) (1u << 24);
+}
+
+static UINT SampleGesture(CONST GESTURE* pGesture, DOUBLE fDeviceRate)
+{
+    UINT    cSamples = 0;
+    DOUBLE  t;
+    FLOAT   x, y;
+
+    for (t = 0.0; t < pGesture->fDuration && cSamples < MAX_SAMPLES;
+         t += 1.0 / fDeviceRate)
+    {
+        pGesture->pfnPosition(t, &x, &y);
+
+        g_samples[cSamples].fTime = t + Random() * SAMPLE_JITTER;
+        g_samples[cSamples].x = floorf(x + 0.5f);
+        g_samples[cSamples].y = floorf(y + 0.5f);
+        cSamples++;
+    }
+
+    return cSamples;
+}
+
+// Returns the number of samples read, 0 on failure
+static UINT ReadTrace(LPCSTR pszPath)
+{
+    FILE*   pFile;
+    CHAR    szLine[256];
+    UINT    cSamples = 0;
+    DOUBLE  fTime;
+    FLOAT   x, y;
+
+    pFile = fopen(pszPath, "r");
+
+    if (pFile == NULL) {
+        fprintf(stderr, "fp_predict: cannot open %s\n", pszPath);
+        return 0;
+    }
+
+    while (fgets(szLine, sizeof(szLine), pFile) != NULL) {
+        if (sscanf(szLine, "%lf %f %f", &fTime, &x, &y) != 3) {
+            continue;
+        }
+
+        if (cSamples == MAX_SAMPLES) {
+            fprintf(stderr, "fp_predict: %s truncated\n", pszPath);
+            break;
+        }
+
+        if (cSamples > 0 && fTime < g_samples[cSamples - 1].fTime) {
+            fprintf(stderr, "fp_predict: %s goes back in time\n", pszPath);
+            cSamples = 0;
+            break;
+        }
+
+        g_samples[cSamples].fTime = fTime;
+        g_samples[cSamples].x = x;
+        g_samples[cSamples].y = y;
+        cSamples++;
+    }
+
+    fclose(pFile);
+    return cSamples;
+}
+
+// Where the pointer is at fTime, between the samples around it
+static VOID TraceAt(UINT cSamples, DOUBLE fTime, FLOAT* px, FLOAT* py)
+{
+    UINT    uLow = 0, uHigh = cSamples - 1, uMiddle;
+    FLOAT   t;
+
+    if (fTime <= g_samples[0].fTime || cSamples == 1) {
+        *px = g_samples[0].x;
+        *py = g_samples[0].y;
+        return;
+    }
+
+    if (fTime >= g_samples[uHigh].fTime) {
+        *px = g_samples[uHigh].x;
+        *py = g_samples[uHigh].y;
+        return;
+    }
+
+    while (uHigh - uLow > 1) {
+        uMiddle = (uLow + uHigh) / 2;
+
+        if (g_samples[uMiddle].fTime <= fTime) {
+            uLow = uMiddle;
+        } else {
+            uHigh = uMiddle;
+        }
+    }
+
+    t = (FLOAT) ((fTime - g_samples[uLow].fTime) /
+                 (g_samples[uHigh].fTime - g_samples[uLow].fTime));
+
+    *px = g_samples[uLow].x + (g_samples[uHigh].x - g_samples[uLow].x) * t;
+    *py = g_samples[uLow].y + (g_samples[uHigh].y - g_samples[uLow].y) * t;
+}
+
+static int CompareFloat(CONST VOID* pA, CONST VOID* pB)
+{
+    FLOAT a = *(CONST FLOAT*) pA;
+    FLOAT b = *(CONST FLOAT*) pB;
+
+    return (a < b) ? -1 : (a > b) ? 1 : 0;
+}
+
+static VOID Score(FLOAT* pfErrors, UINT cFrames, SCORE* pScore)
+{
+    UINT i;
+
+    memset(pScore, 0, sizeof(*pScore));
+
+    if (cFrames == 0) {
+        return;
+    }
+
+    for (i = 0; i < cFrames; i++) {
+        pScore->fMean += pfErrors[i];
+    }
+
+    pScore->fMean /= cFrames;
+
+    qsort(pfErrors, cFrames, sizeof(FLOAT), CompareFloat);
+
+    pScore->fPercentile = pfErrors[(cFrames - 1) * 95 / 100];
+    pScore->fMax = pfErrors[cFrames - 1];
+}
+
+static LONGLONG ToTicks(DOUBLE fSeconds)
+{
+    return (LONGLONG) floor(fSeconds * CLOCK_FREQUENCY + 0.5);
+}
+
+static VOID Evaluate(UINT cSamples, DOUBLE fFrameRate, RESULT* pResult)
+{
+    ManualClock         clock(CLOCK_FREQUENCY);
+    PointerPredictor    predictor(&clock);
+    Geometry::Point     held, offset;
+    DOUBLE              fPeriod = 1.0 / fFrameRate;
+    DOUBLE              fFrame, fPresent;
+    FLOAT               fTrueX, fTrueY;
+    FLOAT               fMotionX, fMotionY, fMotion;
+    FLOAT               fErrorX, fErrorY, fAlong;
+    UINT                uNext = 0, cFrames = 0;
+
+    memset(pResult, 0, sizeof(*pResult));
+
+    held = Geometry::MakePoint(g_samples[0].x, g_samples[0].y);
+
+    for (fFrame = g_samples[0].fTime;
+         fFrame + fPeriod <= g_samples[cSamples - 1].fTime &&
+         cFrames < MAX_FRAMES;
+         fFrame += fPeriod)
+    {
+        while (uNext < cSamples && g_samples[uNext].fTime <= fFrame) {
+            held = Geometry::MakePoint(
+                g_samples[uNext].x,
+                g_samples[uNext].y);
+
+            predictor.AddSample(ToTicks(g_samples[uNext].fTime), held);
+            uNext++;
+        }
+
+        clock.SetTicks(ToTicks(fFrame));
+
+        fPresent = fFrame + fPeriod;
+        offset = predictor.Predict(ToTicks(fPresent));
+
+        TraceAt(cSamples, fPresent, &fTrueX, &fTrueY);
+
+        fMotionX = fTrueX - held.x;
+        fMotionY = fTrueY - held.y;
+
+        g_heldErrors[cFrames] = sqrtf(
+            fMotionX * fMotionX + fMotionY * fMotionY);
+
+        fErrorX = held.x + offset.x - fTrueX;
+        fErrorY = held.y + offset.y - fTrueY;
+
+        g_predictedErrors[cFrames] = sqrtf(
+            fErrorX * fErrorX + fErrorY * fErrorY);
+
+        if (g_predictedErrors[cFrames] > g_heldErrors[cFrames] + 0.5f) {
+            pResult->cWorse++;
+        }
+
+        // Past the truth in the direction the pointer really went, or
+        // anywhere at all when it did not move
+        fMotion = g_heldErrors[cFrames];
+
+        if (fMotion > 0.5f) {
+            fAlong = (fErrorX * fMotionX + fErrorY * fMotionY) / fMotion;
+        } else {
+            fAlong = g_predictedErrors[cFrames];
+        }
+
+        pResult->fOvershoot = (fAlong > pResult->fOvershoot) ?
+                              fAlong : pResult->fOvershoot;
+
+        cFrames++;
+    }
+
+    pResult->cFrames = cFrames;
+
+    Score(g_heldErrors, cFrames, &pResult->held);
+    Score(g_predictedErrors, cFrames, &pResult->predicted);
+}
+
+static VOID PrintResult(LPCSTR pszName, LPCSTR pszRate, CONST RESULT* pResult)
+{
+    printf("predict %-8s %-7s "
+           "held %6.1f %6.1f %6.1f  "
+           "predicted %6.1f %6.1f %6.1f  "
+           "overshoot %5.1f  worse %3u/%u\n",
+           pszName,
+           pszRate,
+           pResult->held.fMean,
+           pResult->held.fPercentile,
+           pResult->held.fMax,
+           pResult->predicted.fMean,
+           pResult->predicted.fPercentile,
+           pResult->predicted.fMax,
+           pResult->fOvershoot,
+           pResult->cWorse,
+           pResult->cFrames);
+}
+
+int main(int argc, char** argv)
+{
+    DOUBLE  fFrameRate = 60.0;
+    RESULT  result;
+    CHAR    szRate[16];
+    UINT    cSamples, cTraces = 0;
+    UINT    i, j;
+    int     k;
+    INT     iResult = 0;
+
+    for (k = 1; k < argc; k++) {
+        if (strcmp(argv[k], "-r") == 0 && k + 1 < argc) {
+            fFrameRate = atof(argv[++k]);
+
+            if (fFrameRate < 1.0 || fFrameRate > 1000.0) {
+                fprintf(stderr, "fp_predict: bad frame rate\n");
+                return 1;
+            }
+        }
+    }
+
+    printf("predict %.0f Hz frames, errors in px as mean, p95, max\n",
+           fFrameRate);
+
+    for (k = 1; k < argc; k++) {
+        if (strcmp(argv[k], "-r") == 0) {
+            k++;
+            continue;
+        }
+
+        cTraces++;
+        cSamples = ReadTrace(argv[k]);
+
+        if (cSamples < 2) {
+            iResult = 1;
+            continue;
+        }
+
+        Evaluate(cSamples, fFrameRate, &result);
+        PrintResult(argv[k], "trace", &result);
+    }
+
+    if (cTraces > 0) {
+        return iResult;
+    }
+
+    for (i = 0; i < ARRAYSIZE(GESTURES); i++) {
+        for (j = 0; j < ARRAYSIZE(DEVICE_RATES); j++) {
+            cSamples = SampleGesture(&GESTURES[i], DEVICE_RATES[j]);
+
+            sprintf(szRate, "%.0fHz", DEVICE_RATES[j]);
+
+            Evaluate(cSamples, fFrameRate, &result);
+            PrintResult(GESTURES[i].pszName, szRate, &result);
+        }
+    }
+
+    return iResult;
+}
@@ -0,0 +1,399 @@
+/**
+ * Copyright 2025 haloperidozz
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ * 
+ *           http://www.apache.org/licenses/LICENSE-2.0
+ * 
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "clock.h"
+#include "engine.h"
+#include "inputsession.h"
+#include "inputtrace.h"
+#include "nullplatform.h"
+#include "safemem.h"
+#include "thread.h"
+#include "trace.h"
+
+////////////////////////////////////////////////////////////////////////////
+// fp_replay - plays an input trace through InputSession and Engine
+//
+// The engine runs headless on a ManualClock that is set to each record's
+// time, so the result depends on nothing but the trace: the state hash
+// printed at the end is the same on every machine, and the time spent in
+// Engine::Tick is a performance number for that exact input.
+//
+// Usage: fp_replay [-s speed] [-p positions.txt] [-t timeline.json] trace
+//
+//   -s  0 replays as fast as possible (the default), 1 at the recorded
+//       pace, 2 twice as fast and so on
+//   -p  writes "seconds x y" after every move, the text trace fp_predict
+//       reads
+//   -t  writes the frame timeline as trace_event JSON, in builds with
+//       the FP_TRACE option
+//
+// Record a trace with "FingerPointer.exe /record <file>".
+////////////////////////////////////////////////////////////////////////////
+
+#define FNV_OFFSET      2166136261u
+#define FNV_PRIME       16777619u
+
+// Same size as the pointer can get on screen, the trace sets the rest
+#define SINK_WIDTH      1920.0f
+#define SINK_HEIGHT     1080.0f
+
+static UINT HashBytes(UINT uHash, CONST VOID* pvData, SIZE_T cbData)
+{
+    CONST BYTE* pb = (CONST BYTE*) pvData;
+    SIZE_T      i;
+
+    for (i = 0; i < cbData; i++) {
+        uHash = (uHash ^ pb[i]) * FNV_PRIME;
+    }
+
+    return uHash;
+}
+
+// Everything about the pointer a frame could show
+static UINT HashPointer(UINT uHash, Pointer* pPointer)
+{
+    Geometry::Point     position = pPointer->GetPosition();
+    Geometry::Point     offset = pPointer->GetDrawOffset();
+    Geometry::Matrix    transform;
+    FLOAT               fScale = pPointer->GetScale();
+    FLOAT               fDpiScale = pPointer->GetDpiScale();
+    BOOL                bIdle = pPointer->IsIdle();
+    POINTERFRAME        frame;
+
+    pPointer->GetFrame(&frame);
+    Pointer::PoseSprite(pPointer->GetSprite(), frame);
+
+    transform = pPointer->GetSprite()->GetTransform();
+
+    uHash = HashBytes(uHash, &position, sizeof(position));
+    uHash = HashBytes(uHash, &offset, sizeof(offset));
+    uHash = HashBytes(uHash, &transform, sizeof(transform));
+    uHash = HashBytes(uHash, &fScale, sizeof(fScale));
+    uHash = HashBytes(uHash, &fDpiScale, sizeof(fDpiScale));
+    uHash = HashBytes(uHash, &bIdle, sizeof(bIdle));
+
+    return uHash;
+}
+
+// The whole file, in a buffer the caller deletes; stdio, so the path can
+// stay a plain char string on every platform
+static BYTE* ReadTraceFile(LPCSTR pszPath, SIZE_T* pcbData)
+{
+    FILE*   pFile;
+    BYTE*   pbData = NULL;
+    long    lSize;
+
+    pFile = fopen(pszPath, "rb");
+
+    if (pFile == NULL) {
+        return NULL;
+    }
+
+    if (fseek(pFile, 0, SEEK_END) != 0 || (lSize = ftell(pFile)) <= 0 ||
+        fseek(pFile, 0, SEEK_SET) != 0)
+    {
+        goto done;
+    }
+
+    pbData = new BYTE[lSize];
+
+    if (pbData != NULL &&
+        fread(pbData, 1, (SIZE_T) lSize, pFile) != (SIZE_T) lSize)
+    {
+        delete[] pbData;
+        pbData = NULL;
+    }
+
+    *pcbData = (SIZE_T) lSize;
+
+done:
+    fclose(pFile);
+    return pbData;
+}
+
+static HRESULT CreateBlankSprite(
+    RenderSink*     pSink,
+    UINT            uWidth,
+    UINT            uHeight,
+    Sprite**        ppSprite)
+{
+    BYTE*   pbPixels;
+    HRESULT hResult;
+
+    if (uWidth == 0 || uHeight == 0 || uWidth > 4096 || uHeight > 4096) {
+        return E_INVALIDARG;
+    }
+
+    pbPixels = new BYTE[(SIZE_T) uWidth * uHeight * 4];
+
+    if (pbPixels == NULL) {
+        return E_OUTOFMEMORY;
+    }
+
+    memset(pbPixels, 0, (SIZE_T) uWidth * uHeight * 4);
+
+    hResult = Sprite::CreateSpriteFromPixels(
+        pSink,
+        uWidth,
+        uHeight,
+        uWidth * 4,
+        pbPixels,
+        ppSprite);
+
+    delete[] pbPixels;
+    return hResult;
+}
+
+// Sleeps until the recorded time, scaled, has passed on the wall clock
+static VOID Pace(
+    Clock*      pWallClock,
+    LONGLONG    llWallStart,
+    LONGLONG    llElapsed,
+    LONGLONG    llFrequency,
+    DOUBLE      fSpeed)
+{
+    DOUBLE  fDue, fNow;
+
+    fDue = (DOUBLE) llElapsed / llFrequency / fSpeed;
+
+    for (;;) {
+        fNow = (DOUBLE) (pWallClock->GetTicks() - llWallStart) /
+               pWallClock->GetFrequency();
+
+        if (fNow >= fDue) {
+            break;
+        }
+
+        if (fDue - fNow > 0.002) {
+            Thread::SleepThread((DWORD) ((fDue - fNow) * 1000.0) - 1);
+        } else {
+            Thread::YieldThread();
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    SystemClock         wallClock;
+    ManualClock*        pClock = NULL;
+    NullRenderSink      sink(SINK_WIDTH, SINK_HEIGHT);
+    Engine*             pEngine = NULL;
+    InputSession*       pSession = NULL;
+    BYTE*               pbTrace = NULL;
+    SIZE_T              cbTrace = 0;
+    InputTraceReader*   pReader = NULL;
+    Sprite*             pSprite = NULL;
+    FILE*               pPositions = NULL;
+    LPCSTR              pszTrace = NULL;
+    LPCSTR              pszPositions = NULL;
+    LPCSTR              pszTimeline = NULL;
+    INPUTTRACEINFO      info;
+    INPUTRECORD         record;
+    FrameScheduler*     pScheduler;
+    Geometry::Point     position;
+    DOUBLE              fSpeed = 0.0;
+    DOUBLE              fTickSeconds = 0.0, fMaxTickSeconds = 0.0, f;
+    LONGLONG            llWallStart, llBefore, llLast;
+    ULONGLONG           cRecords = 0, cTicks = 0;
+    UINT                uHash = FNV_OFFSET;
+    INT                 iResult = 1;
+    int                 i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            fSpeed = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            pszPositions = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            pszTimeline = argv[++i];
+        } else {
+            pszTrace = argv[i];
+        }
+    }
+
+    if (pszTrace == NULL || fSpeed < 0.0) {
+        fprintf(stderr,
+                "usage: fp_replay [-s speed] [-p positions.txt] "
+                "[-t timeline.json] trace\n");
+        return 1;
+    }
+
+#ifndef FP_TRACE
+    if (pszTimeline != NULL) {
+        fprintf(stderr, "fp_replay: built without FP_TRACE, no timeline\n");
+        return 1;
+    }
+#endif
+
+    pbTrace = ReadTraceFile(pszTrace, &cbTrace);
+
+    if (pbTrace == NULL) {
+        fprintf(stderr, "fp_replay: cannot read %s\n", pszTrace);
+        goto cleanup;
+    }
+
+    if (FAILED(InputTraceReader::CreateInputTraceReader(
+            pbTrace,
+            cbTrace,
+            &pReader)))
+    {
+        fprintf(stderr, "fp_replay: %s is not an input trace\n", pszTrace);
+        goto cleanup;
+    }
+
+    pReader->GetInfo(&info);
+    llLast = info.llStart;
+
+    if (FAILED(CreateBlankSprite(
+            &sink,
+            info.uSpriteWidth,
+            info.uSpriteHeight,
+            &pSprite)))
+    {
+        fprintf(stderr, "fp_replay: bad sprite size in %s\n", pszTrace);
+        goto cleanup;
+    }
+
+    if (pszPositions != NULL) {
+        pPositions = fopen(pszPositions, "w");
+
+        if (pPositions == NULL) {
+            fprintf(stderr, "fp_replay: cannot write %s\n", pszPositions);
+            goto cleanup;
+        }
+    }
+
+    pClock = new ManualClock(info.llFrequency);
+    pClock->SetTicks(info.llStart);
+
+    pEngine = new Engine(pClock);
+
+    if (FAILED(pEngine->Initialize(
+            &sink,
+            pSprite,
+            new NullSound(),
+            new NullSound())))
+    {
+        fprintf(stderr, "fp_replay: cannot start the engine\n");
+        goto cleanup;
+    }
+
+    // The engine owns it now
+    pSprite = NULL;
+
+    pSession = new InputSession(pClock, pEngine);
+
+    FP_TRACE_THREAD("replay");
+
+    llWallStart = wallClock.GetTicks();
+
+    while (pReader->Read(&record)) {
+        if (fSpeed > 0.0) {
+            Pace(
+                &wallClock,
+                llWallStart,
+                record.llTime - info.llStart,
+                info.llFrequency,
+                fSpeed);
+        }
+
+        pClock->SetTicks(record.llTime);
+        llLast = record.llTime;
+
+        llBefore = wallClock.GetTicks();
+        pSession->Apply(record);
+
+        if (record.type == IR_TICK) {
+            f = (DOUBLE) (wallClock.GetTicks() - llBefore) /
+                wallClock.GetFrequency();
+
+            fTickSeconds += f;
+            fMaxTickSeconds = (f > fMaxTickSeconds) ? f : fMaxTickSeconds;
+            cTicks++;
+
+            uHash = HashPointer(uHash, pEngine->GetPointer());
+        }
+
+        if (record.type == IR_FLUSH && pPositions != NULL) {
+            position = pEngine->GetPointer()->GetPosition();
+
+            fprintf(pPositions, "%.6f %.3f %.3f\n",
+                    (DOUBLE) (record.llTime - info.llStart) /
+                    info.llFrequency,
+                    position.x,
+                    position.y);
+        }
+
+        cRecords++;
+    }
+
+    uHash = HashPointer(uHash, pEngine->GetPointer());
+    pScheduler = pEngine->GetScheduler();
+    position = pEngine->GetPointer()->GetPosition();
+
+    if (pReader->IsTruncated() == TRUE) {
+        fprintf(stderr, "fp_replay: %s is cut short, replayed what was "
+                "whole\n", pszTrace);
+    }
+
+    printf("replay %lu records, %.1f s of input, %lu KiB\n",
+           (unsigned long) cRecords,
+           (DOUBLE) (llLast - info.llStart) / info.llFrequency,
+           (unsigned long) (cbTrace / 1024));
+
+    printf("replay %lu frames (%lu rendered, %lu skipped), %lu late\n",
+           (unsigned long) pScheduler->GetFrameCount(),
+           (unsigned long) pScheduler->GetRenderedFrameCount(),
+           (unsigned long) pScheduler->GetSkippedFrameCount(),
+           (unsigned long) pScheduler->GetLateFrameCount());
+
+    printf("replay tick %.2f us mean, %.2f us max\n",
+           (cTicks > 0) ? fTickSeconds / cTicks * 1e6 : 0.0,
+           fMaxTickSeconds * 1e6);
+
+    printf("replay pointer at %.3f, %.3f, state %08x\n",
+           position.x,
+           position.y,
+           uHash);
+
+#ifdef FP_TRACE
+    if (pszTimeline != NULL && FAILED(Trace::WriteJson(pszTimeline))) {
+        fprintf(stderr, "fp_replay: cannot write %s\n", pszTimeline);
+        goto cleanup;
+    }
+#endif
+
+    iResult = 0;
+
+cleanup:
+    if (pPositions != NULL) {
+        fclose(pPositions);
+    }
+
+    SafeDelete(&pSession);
+    SafeDelete(&pEngine);
+    SafeDelete(&pClock);
+    SafeDelete(&pSprite);
+    SafeDelete(&pReader);
+
+    delete[] pbTrace;
+
+    return iResult;
+}